@@ -0,0 +1,89 @@
+include(CMakeParseArguments)
+
+# SITL ("software in the loop") builds the firmware as a regular host
+# executable. The hardware specific drivers are replaced by the stand-ins
+# in target/SITL, while everything else (scheduler, PID, mixer, navigation,
+# etc...) is compiled from the same sources used by the real targets.
+
+set(SITL_DIR "${MAIN_SRC_DIR}/target/SITL")
+
+# Sources from COMMON_SRC which talk to the MCU directly. Their
+# functionality is provided by the files in target/SITL instead.
+main_sources(SITL_EXCLUDED_SRC
+    main.c
+
+    drivers/exti.c
+    drivers/io.c
+    drivers/persistent.c
+    drivers/pwm_mapping.c
+    drivers/pwm_output.c
+    drivers/rcc.c
+    drivers/serial_softserial.c
+    drivers/stack_check.c
+    drivers/system.c
+    drivers/time.c
+    drivers/timer.c
+    drivers/usb_msc.c
+
+    fc/fc_hardfaults.c
+    fc/firmware_update.c
+)
+
+main_sources(SITL_SRC
+    config/config_streamer_ram.c
+)
+
+set(SITL_DEFINITIONS
+    SITL_BUILD
+    SIMULATOR_BUILD
+    MCU_FLASH_SIZE=1024
+    CONFIG_IN_RAM
+)
+
+set(SITL_COMPILE_OPTIONS
+    -ffunction-sections
+    -fdata-sections
+    -fno-common
+    -funsigned-char
+    -Wno-unused-parameter
+)
+
+set(SITL_LINK_LIBRARIES
+    -lm
+    -lpthread
+)
+
+set(SITL_LINK_OPTIONS
+    -Wl,-gc-sections
+)
+
+function(target_sitl name)
+    if(NOT TOOLCHAIN STREQUAL none)
+        return()
+    endif()
+
+    set(exe ${name})
+    set(sources ${COMMON_SRC})
+    list(REMOVE_ITEM sources ${SITL_EXCLUDED_SRC})
+    file(GLOB target_c_sources "${CMAKE_CURRENT_SOURCE_DIR}/*.c")
+    file(GLOB target_h_sources "${CMAKE_CURRENT_SOURCE_DIR}/*.h")
+    list(APPEND sources ${SITL_SRC} ${target_c_sources} ${target_h_sources} ${ARGN})
+
+    add_executable(${exe} ${sources})
+    target_include_directories(${exe} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR} "${MAIN_SRC_DIR}/target")
+    target_compile_definitions(${exe} PRIVATE ${SITL_DEFINITIONS} ${COMMON_COMPILE_DEFINITIONS})
+    target_compile_options(${exe} PRIVATE ${SITL_COMPILE_OPTIONS})
+    if(WARNINGS_AS_ERRORS)
+        target_compile_options(${exe} PRIVATE -Werror)
+    endif()
+    target_link_libraries(${exe} PRIVATE ${SITL_LINK_LIBRARIES})
+    target_link_options(${exe} PRIVATE ${SITL_LINK_OPTIONS})
+
+    setup_executable(${exe} ${name})
+    enable_settings(${exe} ${name} SETTINGS_CXX g++)
+
+    get_property(targets GLOBAL PROPERTY VALID_TARGETS)
+    list(APPEND targets ${name})
+    set_property(GLOBAL PROPERTY VALID_TARGETS "${targets}")
+    set_target_properties(${exe} PROPERTIES SKIP_RELEASES ON)
+endfunction()
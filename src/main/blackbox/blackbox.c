@@ -263,6 +263,8 @@ static const blackboxDeltaFieldDefinition_t blackboxMainFields[] = {
     {"rcCommand",   2, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_4S16), FLIGHT_LOG_FIELD_CONDITION_RC_COMMAND},
     /* Throttle is always in the range [minthrottle..maxthrottle]: */
     {"rcCommand",   3, UNSIGNED, .Ipredict = PREDICT(MINTHROTTLE), .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),  .Pencode = ENCODING(TAG8_4S16), FLIGHT_LOG_FIELD_CONDITION_RC_COMMAND},
+    /* Time from the end of the RX frame to the motor update using it, in us: */
+    {"rxLatency",  -1, UNSIGNED, .Ipredict = PREDICT(0),       .Iencode = ENCODING(UNSIGNED_VB), .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(SIGNED_VB), FLIGHT_LOG_FIELD_CONDITION_RC_COMMAND},
 
     {"vbat",       -1, UNSIGNED, .Ipredict = PREDICT(VBATREF), .Iencode = ENCODING(NEG_14BIT),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_VBAT},
     {"amperage",   -1, SIGNED,   .Ipredict = PREDICT(0),       .Iencode = ENCODING(SIGNED_VB),   .Ppredict = PREDICT(PREVIOUS),      .Pencode = ENCODING(TAG8_8SVB), FLIGHT_LOG_FIELD_CONDITION_AMPERAGE},
@@ -457,6 +459,7 @@ typedef struct blackboxMainState_s {
 
     int16_t rcData[4];
     int16_t rcCommand[4];
+    uint32_t rxLatency;
     int16_t gyroADC[XYZ_AXIS_COUNT];
     int16_t accADC[XYZ_AXIS_COUNT];
     int16_t attitude[XYZ_AXIS_COUNT];
@@ -575,6 +578,31 @@ static EXTENDED_FASTRAM blackboxMainState_t blackboxHistoryRing[3];
 // These point into blackboxHistoryRing, use them to know where to store history of a given age (0, 1 or 2 generations old)
 static EXTENDED_FASTRAM blackboxMainState_t* blackboxHistory[3];
 
+/*
+ * The PID loop only copies the state of the logged iterations into this ring, the frames are encoded and written to
+ * the device later by TASK_BLACKBOX.
+ */
+#define BLACKBOX_SNAPSHOT_COUNT 4
+
+typedef struct blackboxSnapshot_s {
+    blackboxMainState_t state;
+    uint32_t iteration;
+    bool intraframe;
+    bool resume;        // Iterations were skipped before this one, log a resume event before it
+} blackboxSnapshot_t;
+
+STATIC_ASSERT((BLACKBOX_SNAPSHOT_COUNT & (BLACKBOX_SNAPSHOT_COUNT - 1)) == 0, blackbox_snapshot_count_not_power_of_2);
+
+static blackboxSnapshot_t blackboxSnapshots[BLACKBOX_SNAPSHOT_COUNT];
+STATIC_UNIT_TESTED uint8_t blackboxSnapshotHead;
+STATIC_UNIT_TESTED uint8_t blackboxSnapshotTail;
+// Set when iterations have been skipped, no more snapshots are taken until the next I-frame
+static bool blackboxSnapshotResync;
+static uint32_t blackboxDroppedFrameCount;
+#ifdef USE_GPS
+static bool blackboxGpsHomeFrameDue;
+#endif
+
 static bool blackboxModeActivationConditionPresent = false;
 
 /**
@@ -746,13 +774,13 @@ static void blackboxSetState(BlackboxState newState)
     blackboxState = newState;
 }
 
-static void writeIntraframe(void)
+static void writeIntraframe(uint32_t iteration)
 {
     blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
     blackboxWrite('I');
 
-    blackboxWriteUnsignedVB(blackboxIteration);
+    blackboxWriteUnsignedVB(iteration);
     blackboxWriteUnsignedVB(blackboxCurrent->time);
 
     blackboxWriteSignedVBArray(blackboxCurrent->axisPID_Setpoint, XYZ_AXIS_COUNT);
@@ -802,6 +830,8 @@ static void writeIntraframe(void)
         * Throttle lies in range [minthrottle..maxthrottle]:
         */
         blackboxWriteUnsignedVB(blackboxCurrent->rcCommand[THROTTLE] - getThrottleIdleValue());
+
+        blackboxWriteUnsignedVB(blackboxCurrent->rxLatency);
     }
 
     if (testBlackboxCondition(FLIGHT_LOG_FIELD_CONDITION_VBAT)) {
@@ -1049,6 +1079,8 @@ static void writeInterframe(void)
         }
 
         blackboxWriteTag8_4S16(deltas);
+
+        blackboxWriteSignedVB((int32_t)(blackboxCurrent->rxLatency - blackboxLast->rxLatency));
     }
 
     //Check for sensors that are updated periodically (so deltas are normally zero)
@@ -1359,6 +1391,11 @@ void blackboxStart(void)
     blackboxHistory[1] = &blackboxHistoryRing[1];
     blackboxHistory[2] = &blackboxHistoryRing[2];
 
+    blackboxSnapshotHead = 0;
+    blackboxSnapshotTail = 0;
+    blackboxSnapshotResync = false;
+    blackboxDroppedFrameCount = 0;
+
     vbatReference = getBatteryRawVoltage();
 
     //No need to clear the content of blackboxHistoryRing since our first frame will be an intra which overwrites it
@@ -1384,6 +1421,46 @@ void blackboxStart(void)
     blackboxSetState(BLACKBOX_STATE_PREPARE_LOG_FILE);
 }
 
+/**
+ * Encode the main frames for the snapshots taken since the last call.
+ */
+STATIC_UNIT_TESTED void blackboxLogSnapshots(void)
+{
+    while (blackboxSnapshotTail != blackboxSnapshotHead) {
+        const blackboxSnapshot_t *snapshot = &blackboxSnapshots[blackboxSnapshotTail % BLACKBOX_SNAPSHOT_COUNT];
+
+        if (snapshot->resume) {
+            // Write a log entry so the decoder is aware that our large time/iteration skip is intended
+            flightLogEvent_loggingResume_t resume;
+
+            resume.logIteration = snapshot->iteration;
+            resume.currentTimeUs = snapshot->state.time;
+
+            blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RESUME, (flightLogEventData_t *) &resume);
+        }
+
+        memcpy(blackboxHistory[0], &snapshot->state, sizeof(blackboxMainState_t));
+
+        if (snapshot->intraframe) {
+            /*
+             * Don't log a slow frame if the slow data didn't change ("I" frames are already large enough without adding
+             * an additional item to write at the same time). Unless we're *only* logging "I" frames, then we have no choice.
+             */
+            writeSlowFrameIfNeeded(blackboxIsOnlyLoggingIntraframes());
+            writeIntraframe(snapshot->iteration);
+        } else {
+            /*
+             * We assume that slow frames are only interesting in that they aid the interpretation of the main data stream.
+             * So only log slow frames during loop iterations where we log a main frame.
+             */
+            writeSlowFrameIfNeeded(true);
+            writeInterframe();
+        }
+
+        blackboxSnapshotTail++;
+    }
+}
+
 /**
  * Begin Blackbox shutdown.
  */
@@ -1398,6 +1475,8 @@ void blackboxFinish(void)
 
     case BLACKBOX_STATE_RUNNING:
     case BLACKBOX_STATE_PAUSED:
+        // The end of log must come after the frames still waiting for TASK_BLACKBOX
+        blackboxLogSnapshots();
         blackboxLogEvent(FLIGHT_LOG_EVENT_LOG_END, NULL);
         FALLTHROUGH;
 
@@ -1455,9 +1534,8 @@ static void writeGPSFrame(timeUs_t currentTimeUs)
 /**
  * Fill the current state of the blackbox using values read from the flight controller
  */
-static void loadMainState(timeUs_t currentTimeUs)
+static void loadMainState(blackboxMainState_t *blackboxCurrent, timeUs_t currentTimeUs)
 {
-    blackboxMainState_t *blackboxCurrent = blackboxHistory[0];
 
     blackboxCurrent->time = currentTimeUs;
 
@@ -1512,6 +1590,7 @@ static void loadMainState(timeUs_t currentTimeUs)
         blackboxCurrent->rcData[i] = rxGetChannelValue(i);
         blackboxCurrent->rcCommand[i] = rcCommand[i];
     }
+    blackboxCurrent->rxLatency = MAX(rxGetLatencyUs(RX_LATENCY_MOTOR), 0);
 
     blackboxCurrent->attitude[0] = attitude.values.roll;
     blackboxCurrent->attitude[1] = attitude.values.pitch;
@@ -1924,7 +2003,7 @@ static bool blackboxShouldLogIFrame(void)
 }
 
 // Called once every FC loop in order to keep track of how many FC loop iterations have passed
-static void blackboxAdvanceIterationTimers(void)
+STATIC_UNIT_TESTED void blackboxAdvanceIterationTimers(void)
 {
     blackboxSlowFrameIterationTimer++;
     blackboxIteration++;
@@ -1936,62 +2015,125 @@ static void blackboxAdvanceIterationTimers(void)
     }
 }
 
-// Called once every FC loop in order to log the current state
+/*
+ * Called in the PID loop for every iteration that is logged. Only copies the current state into the snapshot ring,
+ * so the cost doesn't depend on the number of logged fields or on the device.
+ */
+STATIC_UNIT_TESTED void blackboxSnapshotIteration(timeUs_t currentTimeUs)
+{
+    const bool intraframe = blackboxShouldLogIFrame();
+
+#ifdef USE_GPS
+    /*
+     * Every 128 intraframes (~10 seconds) write the GPS home position. We write it periodically so that if one Home
+     * Frame goes missing, the GPS coordinates can still be interpreted correctly.
+     */
+    if (blackboxPFrameIndex == (blackboxIFrameInterval / 2) && blackboxIFrameIndex % 128 == 0) {
+        blackboxGpsHomeFrameDue = true;
+    }
+#endif
+
+    if (!intraframe) {
+        if (!blackboxShouldLogPFrame(blackboxPFrameIndex)) {
+            return;
+        }
+        if (blackboxSnapshotResync) {
+            blackboxDroppedFrameCount++;
+            return;
+        }
+    }
+
+    if ((uint8_t)(blackboxSnapshotHead - blackboxSnapshotTail) == BLACKBOX_SNAPSHOT_COUNT) {
+        // TASK_BLACKBOX fell behind, skip frames until the next I-frame to keep the log decodable
+        blackboxDroppedFrameCount++;
+        blackboxSnapshotResync = true;
+        return;
+    }
+
+    blackboxSnapshot_t *snapshot = &blackboxSnapshots[blackboxSnapshotHead % BLACKBOX_SNAPSHOT_COUNT];
+
+    loadMainState(&snapshot->state, currentTimeUs);
+    snapshot->iteration = blackboxIteration;
+    snapshot->intraframe = intraframe;
+    snapshot->resume = blackboxSnapshotResync;
+
+    blackboxSnapshotResync = false;
+    blackboxSnapshotHead++;
+}
+
+// Called by TASK_BLACKBOX in order to log the snapshots taken by the PID loop
 static void blackboxLogIteration(timeUs_t currentTimeUs)
 {
-    // Write a keyframe every BLACKBOX_I_INTERVAL frames so we can resynchronise upon missing frames
-    if (blackboxShouldLogIFrame()) {
-        /*
-         * Don't log a slow frame if the slow data didn't change ("I" frames are already large enough without adding
-         * an additional item to write at the same time). Unless we're *only* logging "I" frames, then we have no choice.
-         */
-        writeSlowFrameIfNeeded(blackboxIsOnlyLoggingIntraframes());
+    blackboxReserveFrame();
 
-        loadMainState(currentTimeUs);
-        writeIntraframe();
-    } else {
+    if (blackboxState == BLACKBOX_STATE_RUNNING && blackboxLoggedAnyFrames) {
         blackboxCheckAndLogArmingBeep();
         blackboxCheckAndLogFlightMode();
+    }
 
-        if (blackboxShouldLogPFrame(blackboxPFrameIndex)) {
-            /*
-             * We assume that slow frames are only interesting in that they aid the interpretation of the main data stream.
-             * So only log slow frames during loop iterations where we log a main frame.
-             */
-            writeSlowFrameIfNeeded(true);
+    blackboxLogSnapshots();
 
-            loadMainState(currentTimeUs);
-            writeInterframe();
-        }
 #ifdef USE_GPS
-        if (feature(FEATURE_GPS)) {
-            /*
-             * If the GPS home point has been updated, or every 128 intraframes (~10 seconds), write the
-             * GPS home position.
-             *
-             * We write it periodically so that if one Home Frame goes missing, the GPS coordinates can
-             * still be interpreted correctly.
-             */
-            if (GPS_home.lat != gpsHistory.GPS_home[0] || GPS_home.lon != gpsHistory.GPS_home[1]
-                || (blackboxPFrameIndex == (blackboxIFrameInterval / 2) && blackboxIFrameIndex % 128 == 0)) {
-
-                writeGPSHomeFrame();
-                writeGPSFrame(currentTimeUs);
-            } else if (gpsSol.numSat != gpsHistory.GPS_numSat || gpsSol.llh.lat != gpsHistory.GPS_coord[0]
-                    || gpsSol.llh.lon != gpsHistory.GPS_coord[1]) {
-                //We could check for velocity changes as well but I doubt it changes independent of position
-                writeGPSFrame(currentTimeUs);
-            }
+    // GPS frames are predicted from the last main frame, so they can only be logged after one.
+    // Nothing new is logged while paused, only the pending snapshots are drained
+    if (feature(FEATURE_GPS) && blackboxState == BLACKBOX_STATE_RUNNING && blackboxLoggedAnyFrames) {
+        if (GPS_home.lat != gpsHistory.GPS_home[0] || GPS_home.lon != gpsHistory.GPS_home[1] || blackboxGpsHomeFrameDue) {
+            writeGPSHomeFrame();
+            writeGPSFrame(currentTimeUs);
+            blackboxGpsHomeFrameDue = false;
+        } else if (gpsSol.numSat != gpsHistory.GPS_numSat || gpsSol.llh.lat != gpsHistory.GPS_coord[0]
+                || gpsSol.llh.lon != gpsHistory.GPS_coord[1]) {
+            //We could check for velocity changes as well but I doubt it changes independent of position
+            writeGPSFrame(currentTimeUs);
         }
-#endif
     }
+#else
+    UNUSED(currentTimeUs);
+#endif
+
+    blackboxCommitFrame();
 
     //Flush every iteration so that our runtime variance is minimized
     blackboxDeviceFlush();
 }
 
 /**
- * Call each flight loop iteration to perform blackbox logging.
+ * Call each flight loop iteration to take the snapshots of the logged iterations.
+ */
+void blackboxCaptureIteration(timeUs_t currentTimeUs)
+{
+    switch (blackboxState) {
+    case BLACKBOX_STATE_PAUSED:
+        // Only allow resume to occur during an I-frame iteration, so that we have an "I" base to work from
+        if (IS_RC_MODE_ACTIVE(BOXBLACKBOX) && blackboxShouldLogIFrame()) {
+            blackboxSnapshotResync = true;
+            blackboxSetState(BLACKBOX_STATE_RUNNING);
+            blackboxSnapshotIteration(currentTimeUs);
+        }
+        // Keep the logging timers ticking so our log iteration continues to advance
+        blackboxAdvanceIterationTimers();
+        break;
+    case BLACKBOX_STATE_RUNNING:
+        // On entry to this state, blackboxIteration, blackboxPFrameIndex and blackboxIFrameIndex are reset to 0
+        if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX)) {
+            blackboxSetState(BLACKBOX_STATE_PAUSED);
+        } else {
+            blackboxSnapshotIteration(currentTimeUs);
+        }
+        blackboxAdvanceIterationTimers();
+        break;
+    default:
+        break;
+    }
+}
+
+uint32_t blackboxGetDroppedFrameCount(void)
+{
+    return blackboxDroppedFrameCount;
+}
+
+/**
+ * Called by TASK_BLACKBOX to send the headers and write the logged frames to the device.
  */
 void blackboxUpdate(timeUs_t currentTimeUs)
 {
@@ -2077,30 +2219,8 @@ void blackboxUpdate(timeUs_t currentTimeUs)
         }
         break;
     case BLACKBOX_STATE_PAUSED:
-        // Only allow resume to occur during an I-frame iteration, so that we have an "I" base to work from
-        if (IS_RC_MODE_ACTIVE(BOXBLACKBOX) && blackboxShouldLogIFrame()) {
-            // Write a log entry so the decoder is aware that our large time/iteration skip is intended
-            flightLogEvent_loggingResume_t resume;
-
-            resume.logIteration = blackboxIteration;
-            resume.currentTimeUs = currentTimeUs;
-
-            blackboxLogEvent(FLIGHT_LOG_EVENT_LOGGING_RESUME, (flightLogEventData_t *) &resume);
-            blackboxSetState(BLACKBOX_STATE_RUNNING);
-
-            blackboxLogIteration(currentTimeUs);
-        }
-        // Keep the logging timers ticking so our log iteration continues to advance
-        blackboxAdvanceIterationTimers();
-        break;
     case BLACKBOX_STATE_RUNNING:
-        // On entry to this state, blackboxIteration, blackboxPFrameIndex and blackboxIFrameIndex are reset to 0
-        if (blackboxModeActivationConditionPresent && !IS_RC_MODE_ACTIVE(BOXBLACKBOX)) {
-            blackboxSetState(BLACKBOX_STATE_PAUSED);
-        } else {
-            blackboxLogIteration(currentTimeUs);
-        }
-        blackboxAdvanceIterationTimers();
+        blackboxLogIteration(currentTimeUs);
         break;
     case BLACKBOX_STATE_SHUTTING_DOWN:
         //On entry of this state, startTime is set
@@ -48,6 +48,8 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data);
 
 void blackboxInit(void);
 void blackboxUpdate(timeUs_t currentTimeUs);
+void blackboxCaptureIteration(timeUs_t currentTimeUs);
+uint32_t blackboxGetDroppedFrameCount(void);
 void blackboxStart(void);
 void blackboxFinish(void);
 bool blackboxMayEditConfig(void);
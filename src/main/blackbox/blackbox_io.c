@@ -87,7 +87,9 @@ void blackboxOpen(void)
 }
 #endif // UNIT_TEST
 
-void blackboxWrite(uint8_t value)
+blackboxFrameBuffer_t blackboxFrameBuffer;
+
+static void blackboxDeviceWrite(uint8_t value)
 {
     switch (blackboxConfig()->device) {
 #ifdef USE_FLASHFS
@@ -107,6 +109,82 @@ void blackboxWrite(uint8_t value)
     }
 }
 
+static void blackboxDeviceWriteBuf(const uint8_t *data, int length)
+{
+    switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        flashfsWrite(data, length, false); // Write asynchronously
+        break;
+#endif
+#ifdef USE_SDCARD
+    case BLACKBOX_DEVICE_SDCARD:
+        afatfs_fwrite(blackboxSDCard.logFile, data, length); // Ignore failures due to buffers filling up
+        break;
+#endif
+    case BLACKBOX_DEVICE_SERIAL:
+    default:
+        serialWriteBuf(blackboxPort, data, length);
+        break;
+    }
+}
+
+/**
+ * Called by blackboxWrite() when the byte can't be stored in the frame buffer, either because no frame has been
+ * reserved or because the buffer is full.
+ */
+void blackboxWriteSlow(uint8_t value)
+{
+    if (blackboxFrameBuffer.end) {
+        blackboxDeviceWriteBuf(blackboxFrameBuffer.data, blackboxFrameBuffer.pos - blackboxFrameBuffer.data);
+        blackboxFrameBuffer.pos = blackboxFrameBuffer.data;
+        *blackboxFrameBuffer.pos++ = value;
+    } else {
+        blackboxDeviceWrite(value);
+    }
+}
+
+/**
+ * Start encoding frames into the frame buffer. Nothing reaches the device until blackboxCommitFrame() is called.
+ */
+void blackboxReserveFrame(void)
+{
+    int size;
+
+    switch (blackboxConfig()->device) {
+#ifdef USE_FLASHFS
+    case BLACKBOX_DEVICE_FLASH:
+        /*
+         * flashfsWrite() drops writes which don't fit in its buffer while the flash is busy, so don't hand it more
+         * than what it would have buffered before flushing when written byte by byte.
+         */
+        size = FLASHFS_WRITE_BUFFER_AUTO_FLUSH_LEN;
+        break;
+#endif
+    default:
+        size = BLACKBOX_FRAME_BUFFER_SIZE;
+        break;
+    }
+
+    blackboxFrameBuffer.pos = blackboxFrameBuffer.data;
+    blackboxFrameBuffer.end = blackboxFrameBuffer.data + size;
+}
+
+/**
+ * Write the frames encoded since blackboxReserveFrame() to the device.
+ */
+void blackboxCommitFrame(void)
+{
+    const int length = blackboxFrameBuffer.pos - blackboxFrameBuffer.data;
+
+    blackboxFrameBuffer.pos = NULL;
+    blackboxFrameBuffer.end = NULL;
+
+    if (length > 0) {
+        blackboxDeviceWriteBuf(blackboxFrameBuffer.data, length);
+    }
+}
+
 // Print the null-terminated string 's' to the blackbox device and return the number of bytes written
 int blackboxPrint(const char *s)
 {
@@ -558,10 +636,9 @@ blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes)
     switch (blackboxConfig()->device) {
     case BLACKBOX_DEVICE_SERIAL:
         /*
-         * One byte of the tx buffer isn't available for user data (due to its circular list implementation),
-         * hence the -1. Note that the USB VCP implementation doesn't use a buffer and has txBufferSize set to zero.
+         * Note that the USB VCP implementation doesn't use a buffer and its TX buffer size is zero.
          */
-        if (blackboxPort->txBufferSize && bytes > (int32_t) blackboxPort->txBufferSize - 1) {
+        if (ringBufferSize(&blackboxPort->txBuffer) && bytes > (int32_t) ringBufferSize(&blackboxPort->txBuffer)) {
             return BLACKBOX_RESERVE_PERMANENT_FAILURE;
         }
 
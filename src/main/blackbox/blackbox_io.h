@@ -53,10 +53,36 @@ typedef enum {
  */
 #define BLACKBOX_TARGET_HEADER_BUDGET_PER_ITERATION 64
 
+/*
+ * Frames logged in a loop iteration are encoded into this buffer and handed to the device with a single write when
+ * they are committed, instead of going through the device switch for every byte. If the frames don't fit, the buffer
+ * is passed on to the device every time it fills up.
+ */
+#define BLACKBOX_FRAME_BUFFER_SIZE 256
+
+typedef struct blackboxFrameBuffer_s {
+    uint8_t *pos;
+    uint8_t *end;   // NULL when no frame has been reserved
+    uint8_t data[BLACKBOX_FRAME_BUFFER_SIZE];
+} blackboxFrameBuffer_t;
+
 extern int32_t blackboxHeaderBudget;
+extern blackboxFrameBuffer_t blackboxFrameBuffer;
 
 void blackboxOpen(void);
-void blackboxWrite(uint8_t value);
+void blackboxWriteSlow(uint8_t value);
+
+static inline void blackboxWrite(uint8_t value)
+{
+    if (blackboxFrameBuffer.pos < blackboxFrameBuffer.end) {
+        *blackboxFrameBuffer.pos++ = value;
+    } else {
+        blackboxWriteSlow(value);
+    }
+}
+
+void blackboxReserveFrame(void);
+void blackboxCommitFrame(void);
 
 void blackboxDeviceFlush(void);
 bool blackboxDeviceFlushForce(void);
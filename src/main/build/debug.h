@@ -86,5 +86,9 @@ typedef enum {
     DEBUG_AUTOTRIM,
     DEBUG_AUTOTUNE,
     DEBUG_RATE_DYNAMICS,
+    DEBUG_FFT_TIME,
+    DEBUG_RX_LATENCY,
+    DEBUG_MSP_DISPLAYPORT,
+    DEBUG_SERIAL_RX_DMA,
     DEBUG_COUNT
 } debugType_e;
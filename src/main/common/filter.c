@@ -43,6 +43,12 @@ float nullFilterApply4(void *filter, float input, float f_cut, float dt)
     return input;
 }
 
+void nullFilterBank3Apply(void *bank, float *data)
+{
+    UNUSED(bank);
+    UNUSED(data);
+}
+
 // PT1 Low Pass filter
 
 static float pt1ComputeRC(const float f_cut)
@@ -317,6 +323,99 @@ FAST_CODE void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint
     filter->y2 = y2;
 }
 
+// PT1 filter bank, data[] holds one sample per axis and is filtered in place
+
+void pt1FilterBank3Init(pt1FilterBank3_t *bank, float f_cut, float dT)
+{
+    for (int i = 0; i < FILTER_BANK3_SIZE; i++) {
+        bank->state[i] = 0.0f;
+    }
+    bank->RC = pt1ComputeRC(f_cut);
+    bank->dT = dT;
+    bank->alpha = bank->dT / (bank->RC + bank->dT);
+}
+
+void pt1FilterBank3UpdateCutoff(pt1FilterBank3_t *bank, float f_cut)
+{
+    bank->RC = pt1ComputeRC(f_cut);
+    bank->alpha = bank->dT / (bank->RC + bank->dT);
+}
+
+FAST_CODE void pt1FilterBank3Apply(pt1FilterBank3_t *bank, float *data)
+{
+    const float alpha = bank->alpha;
+
+    for (int i = 0; i < FILTER_BANK3_SIZE; i++) {
+        bank->state[i] = bank->state[i] + alpha * (data[i] - bank->state[i]);
+        data[i] = bank->state[i];
+    }
+}
+
+// Biquad filter bank
+
+static void biquadFilterBank3SetCoefficients(biquadFilterBank3_t *bank, float filterFreq, uint32_t samplingIntervalUs, float Q, biquadFilterType_e filterType)
+{
+    // Coefficients are computed once for all the axes
+    biquadFilter_t filter;
+    biquadFilterInit(&filter, filterFreq, samplingIntervalUs, Q, filterType);
+
+    bank->b0 = filter.b0;
+    bank->b1 = filter.b1;
+    bank->b2 = filter.b2;
+    bank->a1 = filter.a1;
+    bank->a2 = filter.a2;
+}
+
+void biquadFilterBank3Init(biquadFilterBank3_t *bank, uint16_t filterFreq, uint32_t samplingIntervalUs, float Q, biquadFilterType_e filterType)
+{
+    biquadFilterBank3SetCoefficients(bank, filterFreq, samplingIntervalUs, Q, filterType);
+
+    // zero initial samples
+    for (int i = 0; i < FILTER_BANK3_SIZE; i++) {
+        bank->x1[i] = bank->x2[i] = 0;
+        bank->y1[i] = bank->y2[i] = 0;
+    }
+}
+
+FAST_CODE void biquadFilterBank3Update(biquadFilterBank3_t *bank, float filterFreq, uint32_t samplingIntervalUs, float Q, biquadFilterType_e filterType)
+{
+    // State is kept
+    biquadFilterBank3SetCoefficients(bank, filterFreq, samplingIntervalUs, Q, filterType);
+}
+
+// Transposed direct form II, for filters with fixed coefficients
+FAST_CODE void biquadFilterBank3Apply(biquadFilterBank3_t *bank, float *data)
+{
+    const float b0 = bank->b0, b1 = bank->b1, b2 = bank->b2, a1 = bank->a1, a2 = bank->a2;
+
+    for (int i = 0; i < FILTER_BANK3_SIZE; i++) {
+        const float input = data[i];
+        const float result = b0 * input + bank->x1[i];
+        bank->x1[i] = b1 * input - a1 * result + bank->x2[i];
+        bank->x2[i] = b2 * input - a2 * result;
+        data[i] = result;
+    }
+}
+
+// Direct form I, better behaved when the coefficients change at runtime
+FAST_CODE void biquadFilterBank3ApplyDF1(biquadFilterBank3_t *bank, float *data)
+{
+    const float b0 = bank->b0, b1 = bank->b1, b2 = bank->b2, a1 = bank->a1, a2 = bank->a2;
+
+    for (int i = 0; i < FILTER_BANK3_SIZE; i++) {
+        const float input = data[i];
+        const float result = b0 * input + b1 * bank->x1[i] + b2 * bank->x2[i] - a1 * bank->y1[i] - a2 * bank->y2[i];
+
+        bank->x2[i] = bank->x1[i];
+        bank->x1[i] = input;
+
+        bank->y2[i] = bank->y1[i];
+        bank->y1[i] = result;
+
+        data[i] = result;
+    }
+}
+
 FUNCTION_COMPILE_FOR_SIZE
 void initFilter(const uint8_t filterType, filter_t *filter, const float cutoffFrequency, const uint32_t refreshRate) {
     const float dT = refreshRate * 1e-6f;
@@ -52,6 +52,31 @@ typedef union {
     pt3Filter_t pt3;
 } filter_t;
 
+/*
+ * Filter banks for the three gyro axes. All axes share the coefficients,
+ * the state is kept as arrays so the compiler can unroll or vectorize
+ * the loops, and there is one call per sample instead of one per axis.
+ */
+#define FILTER_BANK3_SIZE 3
+
+typedef struct pt1FilterBank3_s {
+    float state[FILTER_BANK3_SIZE];
+    float RC;
+    float dT;
+    float alpha;
+} pt1FilterBank3_t;
+
+typedef struct biquadFilterBank3_s {
+    float b0, b1, b2, a1, a2;
+    float x1[FILTER_BANK3_SIZE], x2[FILTER_BANK3_SIZE];
+    float y1[FILTER_BANK3_SIZE], y2[FILTER_BANK3_SIZE];
+} biquadFilterBank3_t;
+
+typedef union {
+    biquadFilterBank3_t biquad;
+    pt1FilterBank3_t pt1;
+} filterBank3_t;
+
 typedef enum {
     FILTER_PT1 = 0,
     FILTER_BIQUAD,
@@ -84,6 +109,7 @@ typedef struct alphaBetaGammaFilter_s {
 } alphaBetaGammaFilter_t;
 
 typedef float (*filterApplyFnPtr)(void *filter, float input);
+typedef void (*filterBank3ApplyFnPtr)(void *bank, float *data);
 typedef float (*filterApply4FnPtr)(void *filter, float input, float f_cut, float dt);
 
 #define BIQUAD_BANDWIDTH 1.9f     /* bandwidth in octaves */
@@ -91,6 +117,7 @@ typedef float (*filterApply4FnPtr)(void *filter, float input, float f_cut, float
 
 float nullFilterApply(void *filter, float input);
 float nullFilterApply4(void *filter, float input, float f_cut, float dt);
+void nullFilterBank3Apply(void *bank, float *data);
 
 void pt1FilterInit(pt1Filter_t *filter, float f_cut, float dT);
 void pt1FilterInitRC(pt1Filter_t *filter, float tau, float dT);
@@ -130,6 +157,15 @@ float biquadFilterApplyDF1(biquadFilter_t *filter, float input);
 float filterGetNotchQ(float centerFrequencyHz, float cutoffFrequencyHz);
 void biquadFilterUpdate(biquadFilter_t *filter, float filterFreq, uint32_t refreshRate, float Q, biquadFilterType_e filterType);
 
+void pt1FilterBank3Init(pt1FilterBank3_t *bank, float f_cut, float dT);
+void pt1FilterBank3UpdateCutoff(pt1FilterBank3_t *bank, float f_cut);
+void pt1FilterBank3Apply(pt1FilterBank3_t *bank, float *data);
+
+void biquadFilterBank3Init(biquadFilterBank3_t *bank, uint16_t filterFreq, uint32_t samplingIntervalUs, float Q, biquadFilterType_e filterType);
+void biquadFilterBank3Update(biquadFilterBank3_t *bank, float filterFreq, uint32_t samplingIntervalUs, float Q, biquadFilterType_e filterType);
+void biquadFilterBank3Apply(biquadFilterBank3_t *bank, float *data);
+void biquadFilterBank3ApplyDF1(biquadFilterBank3_t *bank, float *data);
+
 void alphaBetaGammaFilterInit(alphaBetaGammaFilter_t *filter, float alpha, float boostGain, float halfLife, float dT);
 float alphaBetaGammaFilterApply(alphaBetaGammaFilter_t *filter, float input);
 
@@ -110,7 +110,7 @@ int tfp_nformat(void *putp, int size, void (*putf) (void *, char), const char *f
     int written = 0;
     char ch;
 
-    const void *end = size < 0 ? (void*)UINT32_MAX : ((char *)putp + size - 1);
+    const void *end = size < 0 ? (void*)UINTPTR_MAX : ((char *)putp + size - 1);
 
     while ((ch = *(fmt++))) {
         if (ch != '%') {
@@ -0,0 +1,127 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <string.h>
+
+#include "platform.h"
+
+#include "build/assert.h"
+
+#include "common/ring_buffer.h"
+#include "common/maths.h"
+
+void ringBufferInit(ringBuffer_t *rb, uint8_t *buffer, uint32_t size)
+{
+    ASSERT(size != 0 && (size & (size - 1)) == 0);
+
+    // Without the assert, only use the largest power of two that fits
+    while (size & (size - 1)) {
+        size &= size - 1;
+    }
+
+    rb->buffer = buffer;
+    rb->mask = size ? size - 1 : 0;
+    rb->head = 0;
+    rb->tail = 0;
+}
+
+void ringBufferReset(ringBuffer_t *rb)
+{
+    ringBufferStoreIndex(&rb->tail, 0);
+    ringBufferStoreIndex(&rb->head, 0);
+}
+
+/*
+ * Contiguous free space at the head, e.g. for a DMA transfer or a driver
+ * which fills the buffer in place. Only valid until ringBufferCommitWrite().
+ */
+uint32_t ringBufferGetWriteSpan(ringBuffer_t *rb, uint8_t **ptr)
+{
+    const uint32_t head = rb->head;
+    const uint32_t offset = head & rb->mask;
+    const uint32_t free = rb->mask + 1 - (head - ringBufferLoadIndex(&rb->tail));
+
+    *ptr = &rb->buffer[offset];
+    return MIN(free, rb->mask + 1 - offset);
+}
+
+void ringBufferCommitWrite(ringBuffer_t *rb, uint32_t len)
+{
+    ringBufferStoreIndex(&rb->head, rb->head + len);
+}
+
+// Contiguous data at the tail, so it can be parsed or sent without a copy
+uint32_t ringBufferGetReadSpan(ringBuffer_t *rb, const uint8_t **ptr)
+{
+    const uint32_t tail = rb->tail;
+    const uint32_t offset = tail & rb->mask;
+    const uint32_t count = ringBufferLoadIndex(&rb->head) - tail;
+
+    *ptr = &rb->buffer[offset];
+    return MIN(count, rb->mask + 1 - offset);
+}
+
+void ringBufferCommitRead(ringBuffer_t *rb, uint32_t len)
+{
+    ringBufferStoreIndex(&rb->tail, rb->tail + len);
+}
+
+// Returns the number of bytes written, less than len when the buffer fills up
+uint32_t ringBufferWrite(ringBuffer_t *rb, const uint8_t *data, uint32_t len)
+{
+    uint32_t written = 0;
+
+    // At most two spans, before and after the wrap
+    while (written < len) {
+        uint8_t *ptr;
+        const uint32_t span = MIN(ringBufferGetWriteSpan(rb, &ptr), len - written);
+        if (span == 0) {
+            break;
+        }
+        memcpy(ptr, data + written, span);
+        ringBufferCommitWrite(rb, span);
+        written += span;
+    }
+
+    return written;
+}
+
+// Returns the number of bytes read, less than len when the buffer runs empty
+uint32_t ringBufferRead(ringBuffer_t *rb, uint8_t *data, uint32_t len)
+{
+    uint32_t read = 0;
+
+    while (read < len) {
+        const uint8_t *ptr;
+        const uint32_t span = MIN(ringBufferGetReadSpan(rb, &ptr), len - read);
+        if (span == 0) {
+            break;
+        }
+        memcpy(data + read, ptr, span);
+        ringBufferCommitRead(rb, span);
+        read += span;
+    }
+
+    return read;
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Lock-free byte FIFO for exactly one producer and one consumer, e.g. an
+ * ISR on one side and the main loop on the other. The size must be a power
+ * of two. head and tail run freely and are masked on access, so the whole
+ * buffer is usable and the byte count is just head - tail.
+ *
+ * Each index is only written by its owner, with release semantics after
+ * the data it covers, and loaded by the other side with acquire semantics.
+ * On the single core MCUs this boils down to plain loads and stores plus a
+ * DMB, on the host it makes the buffer safe between two threads.
+ */
+typedef struct ringBuffer_s {
+    uint8_t *buffer;
+    uint32_t mask;
+    uint32_t head;      // Written by the producer only
+    uint32_t tail;      // Written by the consumer only
+} ringBuffer_t;
+
+// size must be a non-zero power of two
+void ringBufferInit(ringBuffer_t *rb, uint8_t *buffer, uint32_t size);
+// Drops the contents. Neither side may be using the buffer.
+void ringBufferReset(ringBuffer_t *rb);
+
+// Producer side
+uint32_t ringBufferWrite(ringBuffer_t *rb, const uint8_t *data, uint32_t len);
+uint32_t ringBufferGetWriteSpan(ringBuffer_t *rb, uint8_t **ptr);
+void ringBufferCommitWrite(ringBuffer_t *rb, uint32_t len);
+
+// Consumer side
+uint32_t ringBufferRead(ringBuffer_t *rb, uint8_t *data, uint32_t len);
+uint32_t ringBufferGetReadSpan(ringBuffer_t *rb, const uint8_t **ptr);
+void ringBufferCommitRead(ringBuffer_t *rb, uint32_t len);
+
+static inline uint32_t ringBufferLoadIndex(const uint32_t *index)
+{
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+static inline void ringBufferStoreIndex(uint32_t *index, uint32_t value)
+{
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+// 0 for a buffer which has not been initialised
+static inline uint32_t ringBufferSize(const ringBuffer_t *rb)
+{
+    return rb->buffer ? rb->mask + 1 : 0;
+}
+
+static inline uint32_t ringBufferCount(const ringBuffer_t *rb)
+{
+    return ringBufferLoadIndex(&rb->head) - ringBufferLoadIndex(&rb->tail);
+}
+
+static inline uint32_t ringBufferFree(const ringBuffer_t *rb)
+{
+    return ringBufferSize(rb) - ringBufferCount(rb);
+}
+
+static inline bool ringBufferIsEmpty(const ringBuffer_t *rb)
+{
+    return ringBufferCount(rb) == 0;
+}
+
+static inline bool ringBufferPut(ringBuffer_t *rb, uint8_t c)
+{
+    const uint32_t head = rb->head;
+
+    if (head - ringBufferLoadIndex(&rb->tail) > rb->mask) {
+        return false;
+    }
+
+    rb->buffer[head & rb->mask] = c;
+    ringBufferStoreIndex(&rb->head, head + 1);
+    return true;
+}
+
+static inline bool ringBufferGet(ringBuffer_t *rb, uint8_t *c)
+{
+    const uint32_t tail = rb->tail;
+
+    if (ringBufferLoadIndex(&rb->head) == tail) {
+        return false;
+    }
+
+    *c = rb->buffer[tail & rb->mask];
+    ringBufferStoreIndex(&rb->tail, tail + 1);
+    return true;
+}
@@ -0,0 +1,175 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "platform.h"
+
+FILE_COMPILE_FOR_SPEED
+
+#include "common/maths.h"
+#include "common/sdft.h"
+#include "common/utils.h"
+
+/*
+ * Every update multiplies the bins by r < 1, otherwise the rounding errors
+ * of the twiddle factors accumulate forever. The sample leaving the window
+ * has to be scaled by r^N to be cancelled out exactly.
+ */
+#define SDFT_DAMPING_FACTOR 0.9999f
+
+static float rPowerN;
+static float twiddleRe[SDFT_BIN_COUNT + 1];
+static float twiddleIm[SDFT_BIN_COUNT + 1];
+static bool twiddleInitialized = false;
+
+void sdftInit(sdft_t *sdft, uint8_t startBin, uint8_t endBin)
+{
+    if (!twiddleInitialized) {
+        rPowerN = powf(SDFT_DAMPING_FACTOR, SDFT_SAMPLE_SIZE);
+        for (int k = 0; k <= SDFT_BIN_COUNT; k++) {
+            const float phi = 2.0f * M_PIf * k / SDFT_SAMPLE_SIZE;
+            twiddleRe[k] = cos_approx(phi);
+            twiddleIm[k] = sin_approx(phi);
+        }
+        twiddleInitialized = true;
+    }
+
+    // One extra bin on each side is computed for the window
+    sdft->startBin = constrain(startBin, 1, SDFT_BIN_COUNT - 2);
+    sdft->endBin = constrain(endBin, sdft->startBin, MIN(SDFT_BIN_COUNT - 2, sdft->startBin + SDFT_MAX_BINS - 1));
+    sdft->idx = 0;
+
+    memset(sdft->samples, 0, sizeof(sdft->samples));
+    memset(sdft->re, 0, sizeof(sdft->re));
+    memset(sdft->im, 0, sizeof(sdft->im));
+}
+
+void sdftPush(sdft_t *sdft, float sample)
+{
+    const float delta = sample - rPowerN * sdft->samples[sdft->idx];
+
+    sdft->samples[sdft->idx] = sample;
+    sdft->idx = (sdft->idx + 1) % SDFT_SAMPLE_SIZE;
+
+    // X[k] = e^(j2pi k/N) * (r * X[k] + x[n] - r^N * x[n - N])
+    const int firstBin = sdft->startBin - 1;
+    const int count = sdft->endBin - sdft->startBin + 3;
+    for (int i = 0; i < count; i++) {
+        const float re = SDFT_DAMPING_FACTOR * sdft->re[i] + delta;
+        const float im = SDFT_DAMPING_FACTOR * sdft->im[i];
+        sdft->re[i] = twiddleRe[firstBin + i] * re - twiddleIm[firstBin + i] * im;
+        sdft->im[i] = twiddleRe[firstBin + i] * im + twiddleIm[firstBin + i] * re;
+    }
+}
+
+/*
+ * Squared magnitude of bins startBin to endBin with a Hann window applied.
+ * In the frequency domain the window is a convolution with [-1/4, 1/2, -1/4],
+ * which saves keeping a windowed copy of the samples.
+ */
+void sdftWindowedMagnitudeSq(const sdft_t *sdft, float *output)
+{
+    const int count = sdft->endBin - sdft->startBin + 1;
+
+    for (int i = 0; i < count; i++) {
+        const float re = 0.5f * sdft->re[i + 1] - 0.25f * (sdft->re[i] + sdft->re[i + 2]);
+        const float im = 0.5f * sdft->im[i + 1] - 0.25f * (sdft->im[i] + sdft->im[i + 2]);
+        output[i] = re * re + im * im;
+    }
+}
+
+// Vertex of the parabola through the peak and its two neighbours, as offset from the peak
+static float sdftParabolaOffset(float y0, float y1, float y2)
+{
+    const float denom = 2.0f * (y0 - 2.0f * y1 + y2);
+
+    if (denom == 0.0f) {
+        return 0.0f;
+    }
+
+    return constrainf((y0 - y2) / denom, -0.5f, 0.5f);
+}
+
+/*
+ * Finds the peakCount biggest local maxima in the output of
+ * sdftWindowedMagnitudeSq(), sorted by ascending frequency. Returns the
+ * number of peaks found, the rest of the array is zeroed.
+ */
+uint8_t sdftFindPeaks(const sdft_t *sdft, const float *magnitudeSq, sdftPeak_t *peaks, uint8_t peakCount)
+{
+    const int count = sdft->endBin - sdft->startBin + 1;
+    uint8_t found = 0;
+
+    memset(peaks, 0, sizeof(sdftPeak_t) * peakCount);
+
+    for (int i = 1; i < count - 1; i++) {
+        if (magnitudeSq[i] > magnitudeSq[i - 1] && magnitudeSq[i] > magnitudeSq[i + 1]) {
+            // Keep the peakCount biggest ones, in descending order
+            for (int p = 0; p < peakCount; p++) {
+                if (magnitudeSq[i] > peaks[p].value) {
+                    for (int k = peakCount - 1; k > p; k--) {
+                        peaks[k] = peaks[k - 1];
+                    }
+                    peaks[p].bin = i;
+                    peaks[p].value = magnitudeSq[i];
+                    found = MIN(found + 1, peakCount);
+                    break;
+                }
+            }
+            i++; // Next bin can't be a peak
+        }
+    }
+
+    /*
+     * The main lobe of the Hann window is close to a gaussian, so its log
+     * is close to a parabola. Interpolating on the log magnitude is good
+     * to ~0.02 bins, against ~0.1 bins on the squared magnitude.
+     */
+    for (int p = 0; p < found; p++) {
+        const int i = peaks[p].bin;
+        const float offset = sdftParabolaOffset(
+            logf(MAX(magnitudeSq[i - 1], FLT_MIN)),
+            logf(magnitudeSq[i]),
+            logf(MAX(magnitudeSq[i + 1], FLT_MIN)));
+        peaks[p].bin = sdft->startBin + i + offset;
+    }
+
+    // Sort by bin, insertion sort is fine for a handful of peaks
+    for (int p = 1; p < found; p++) {
+        const sdftPeak_t peak = peaks[p];
+        int k = p - 1;
+        while (k >= 0 && peaks[k].bin > peak.bin) {
+            peaks[k + 1] = peaks[k];
+            k--;
+        }
+        peaks[k + 1] = peak;
+    }
+
+    return found;
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Sliding DFT. Only the bins in [startBin, endBin] are computed, each new
+ * sample updates all of them with a constant amount of work, so there is
+ * always a spectrum of the last SDFT_SAMPLE_SIZE samples available.
+ */
+#define SDFT_SAMPLE_SIZE    256
+#define SDFT_BIN_COUNT      (SDFT_SAMPLE_SIZE / 2)
+#define SDFT_MAX_BINS       64
+
+typedef struct sdftPeak_s {
+    float bin;          // Interpolated, sub-bin accurate
+    float value;
+} sdftPeak_t;
+
+typedef struct sdft_s {
+    uint16_t idx;
+    uint8_t startBin;
+    uint8_t endBin;
+
+    float samples[SDFT_SAMPLE_SIZE];
+
+    // Real and imaginary parts of bins startBin - 1 to endBin + 1, the
+    // neighbours are needed to apply the window
+    float re[SDFT_MAX_BINS + 2];
+    float im[SDFT_MAX_BINS + 2];
+} sdft_t;
+
+void sdftInit(sdft_t *sdft, uint8_t startBin, uint8_t endBin);
+void sdftPush(sdft_t *sdft, float sample);
+void sdftWindowedMagnitudeSq(const sdft_t *sdft, float *output);
+uint8_t sdftFindPeaks(const sdft_t *sdft, const float *magnitudeSq, sdftPeak_t *peaks, uint8_t peakCount);
@@ -36,8 +36,31 @@
 
 #include "fc/config.h"
 
+/*
+ * The config area holds a log of images. The first one is written by a full
+ * save and contains every PG, later saves append an image with just the PG
+ * instances which changed, until the area is full and the log is compacted
+ * by a full save. All images have the same layout (header, records, footer,
+ * checksum) and start at a streamer write unit boundary, so appending never
+ * touches data which has already been programmed. The checksum of every
+ * appended image is seeded with the one of the image before it, so stale
+ * data left after the log by older saves is never taken as a valid image.
+ * An image is only appended when it fits in the erase unit the log ends in,
+ * which was erased when the log entered it. Starting a new unit would erase
+ * it, so that's left to the compaction.
+ */
+
 static uint16_t eepromConfigSize;
 
+// Records are indexed by 16 bit offsets, so the log stops at 64K in bigger config areas
+#define EEPROM_LOG_MAX_SIZE     UINT16_MAX
+
+// End of the last valid image, new images are appended there
+static const uint8_t *eepromLogEnd;
+static uint16_t eepromLogCrc;
+// False when the data after the log can't be overwritten without an erase
+static bool eepromLogAppendable;
+
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
     CR_CLASSICATION_PROFILE1 = 1,
@@ -134,48 +157,95 @@ static uint16_t updateCRC(uint16_t crc, const void *data, uint32_t length)
     return crc;
 }
 
-// Scan the EEPROM config. Returns true if the config is valid.
-bool isEEPROMContentValid(void)
+static const uint8_t *logLimit(void)
+{
+    return &__config_end - &__config_start > EEPROM_LOG_MAX_SIZE ? &__config_start + EEPROM_LOG_MAX_SIZE : &__config_end;
+}
+
+// Points to the first write unit boundary at or after p
+static const uint8_t *alignToWriteUnit(const uint8_t *p)
+{
+    const uintptr_t offset = p - &__config_start;
+    return &__config_start + (offset + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE;
+}
+
+// Check the image at p, with its checksum seeded from crc. Returns the end of
+// the image and updates crc if the image is valid, NULL otherwise.
+static const uint8_t *checkImage(const uint8_t *p, uint16_t *crc)
 {
-    const uint8_t *p = &__config_start;
     const configHeader_t *header = (const configHeader_t *)p;
 
-    if (header->format != EEPROM_CONF_VERSION) {
-        return false;
+    if (p + sizeof(*header) >= &__config_end || header->format != EEPROM_CONF_VERSION) {
+        return NULL;
     }
-    uint16_t crc = updateCRC(0, header, sizeof(*header));
+    uint16_t imageCrc = updateCRC(*crc, header, sizeof(*header));
     p += sizeof(*header);
 
     for (;;) {
         const configRecord_t *record = (const configRecord_t *)p;
 
+        if (p + sizeof(*record) >= &__config_end) {
+            // Too big. Further checking for size doesn't make sense
+            return NULL;
+        }
+
         if (record->size == 0) {
             // Found the end.  Stop scanning.
             break;
         }
 
-        if (p + sizeof(*record) >= &__config_end) {
-            // Too big. Further checking for size doesn't make sense
-            return false;
-        }
-
         if (p + record->size >= &__config_end || record->size < sizeof(*record)) {
             // Too big or too small.
-            return false;
+            return NULL;
         }
 
-        crc = updateCRC(crc, p, record->size);
+        imageCrc = updateCRC(imageCrc, p, record->size);
 
         p += record->size;
     }
 
     const configFooter_t *footer = (const configFooter_t *)p;
-    crc = updateCRC(crc, footer, sizeof(*footer));
+    imageCrc = updateCRC(imageCrc, footer, sizeof(*footer));
     p += sizeof(*footer);
     const uint16_t checkSum = *(uint16_t *)p;
     p += sizeof(checkSum);
+
+    if (imageCrc != checkSum) {
+        return NULL;
+    }
+    *crc = imageCrc;
+    return p;
+}
+
+// Scan the EEPROM config. Returns true if the config is valid.
+bool isEEPROMContentValid(void)
+{
+    uint16_t crc = 0;
+    const uint8_t *p = checkImage(&__config_start, &crc);
+
+    eepromLogEnd = NULL;
+    if (!p || p > logLimit()) {
+        return false;
+    }
+
+    for (;;) {
+        const uint8_t *next = alignToWriteUnit(p);
+        uint16_t nextCrc = crc;
+        const uint8_t *end = next < logLimit() ? checkImage(next, &nextCrc) : NULL;
+        if (!end || end > logLimit()) {
+            // A header without a valid image after it is either an interrupted save or stale data which
+            // happens to chain. Either way the log can't grow over it.
+            eepromLogAppendable = next >= logLimit() || ((const configHeader_t *)next)->format != EEPROM_CONF_VERSION;
+            break;
+        }
+        p = end;
+        crc = nextCrc;
+    }
+
+    eepromLogEnd = p;
+    eepromLogCrc = crc;
     eepromConfigSize = p - &__config_start;
-    return crc == checkSum;
+    return true;
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -183,53 +253,86 @@ uint16_t getEEPROMConfigSize(void)
     return eepromConfigSize;
 }
 
-// find config record for reg + classification (profile info) in EEPROM
-// return NULL when record is not found
+static uint8_t recordCount(const pgRegistry_t *reg)
+{
+    return pgIsSystem(reg) ? 1 : MAX_PROFILE_COUNT;
+}
+
+static configRecordFlags_e recordClassification(const pgRegistry_t *reg, uint8_t profileIndex)
+{
+    return pgIsSystem(reg) ? CR_CLASSICATION_SYSTEM : ((profileIndex + 1) & CR_CLASSIFICATION_MASK);
+}
+
+static const pgRegistry_t *findRegistryEntry(const pgRegistry_t *hint, pgn_t pgn)
+{
+    // Images are written in registry order, so this is usually the hint or the entry right after it
+    for (const pgRegistry_t *reg = hint; reg < __pg_registry_end; reg++) {
+        if (pgN(reg) == pgn) {
+            return reg;
+        }
+    }
+    for (const pgRegistry_t *reg = __pg_registry_start; reg < hint; reg++) {
+        if (pgN(reg) == pgn) {
+            return reg;
+        }
+    }
+    return NULL;
+}
+
+// Offsets from __config_start of the newest record of each PG instance, 0 when there's none
+typedef uint16_t eepromRecordIndex_t[MAX_PROFILE_COUNT];
+
+// Walk the log once, indexing the records by registry position and profile
 // this function assumes that EEPROM content is valid
-static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
+static void indexEEPROM(eepromRecordIndex_t *index)
 {
+    memset(index, 0, sizeof(*index) * PG_REGISTRY_SIZE);
+
+    const pgRegistry_t *reg = __pg_registry_start;
     const uint8_t *p = &__config_start;
-    p += sizeof(configHeader_t);             // skip header
-    while (true) {
-        const configRecord_t *record = (const configRecord_t *)p;
-        // Ensure that the record header fits into config memory, otherwise accessing size and flags may cause a hardfault.
-        if (p + sizeof(*record) >= &__config_end) {
-            break;
-        }
 
-        // Check that record header makes sense
-        if (record->size == 0 || p + record->size >= &__config_end || record->size < sizeof(*record)) {
-            break;
-        }
+    while (p < eepromLogEnd) {
+        p += sizeof(configHeader_t);             // skip header
+        for (;;) {
+            const configRecord_t *record = (const configRecord_t *)p;
+            if (record->size == 0) {
+                break;
+            }
 
-        // Check if this is the record we're looking for (check for size)
-        if (pgN(reg) == record->pgn && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
-            return record;
+            const pgRegistry_t *found = findRegistryEntry(reg, record->pgn);
+            if (found) {
+                // Records of PGs which are no longer registered are skipped
+                reg = found;
+                for (uint8_t profileIndex = 0; profileIndex < recordCount(reg); profileIndex++) {
+                    if ((record->flags & CR_CLASSIFICATION_MASK) == recordClassification(reg, profileIndex)) {
+                        // Later images override this record
+                        index[reg - __pg_registry_start][profileIndex] = p - &__config_start;
+                    }
+                }
+            }
+            p += record->size;
         }
-
-        p += record->size;
+        p = alignToWriteUnit(p + sizeof(configFooter_t) + sizeof(uint16_t));
     }
-    // record not found
-    return NULL;
+}
+
+static const configRecord_t *indexedRecord(const eepromRecordIndex_t *index, const pgRegistry_t *reg, uint8_t profileIndex)
+{
+    const uint16_t offset = index[reg - __pg_registry_start][profileIndex];
+    return offset ? (const configRecord_t *)(&__config_start + offset) : NULL;
 }
 
 // Initialize all PG records from EEPROM.
-// This functions processes all PGs sequentially, scanning EEPROM for each one. This is suboptimal,
-//   but each PG is loaded/initialized exactly once and in defined order.
+// The log is scanned once to find the newest record of every PG instance, then each PG is
+//   loaded/initialized exactly once and in registry order.
 bool loadEEPROM(void)
 {
+    eepromRecordIndex_t index[PG_REGISTRY_SIZE];
+    indexEEPROM(index);
+
     PG_FOREACH(reg) {
-        configRecordFlags_e cls_start, cls_end;
-        if (pgIsSystem(reg)) {
-            cls_start = CR_CLASSICATION_SYSTEM;
-            cls_end = CR_CLASSICATION_SYSTEM;
-        } else {
-            cls_start = CR_CLASSICATION_PROFILE1;
-            cls_end = CR_CLASSICATION_PROFILE_LAST;
-        }
-        for (configRecordFlags_e cls = cls_start; cls <= cls_end; cls++) {
-            int profileIndex = cls - cls_start;
-            const configRecord_t *rec = findEEPROM(reg, cls);
+        for (uint8_t profileIndex = 0; profileIndex < recordCount(reg); profileIndex++) {
+            const configRecord_t *rec = indexedRecord(index, reg, profileIndex);
             if (rec) {
                 // config from EEPROM is available, use it to initialize PG. pgLoad will handle version mismatch
                 pgLoad(reg, profileIndex, rec->pg, rec->size - offsetof(configRecord_t, pg), rec->version);
@@ -241,12 +344,23 @@ bool loadEEPROM(void)
     return true;
 }
 
-static bool writeSettingsToEEPROM(void)
+// True when the PG instance differs from its newest record in the log
+static bool isRecordDirty(const eepromRecordIndex_t *index, const pgRegistry_t *reg, uint8_t profileIndex)
+{
+    const configRecord_t *rec = indexedRecord(index, reg, profileIndex);
+    const uint16_t regSize = pgSize(reg);
+
+    return !rec || rec->version != pgVersion(reg) || rec->size != sizeof(configRecord_t) + regSize ||
+        memcmp(rec->pg, reg->address + (regSize * profileIndex), regSize) != 0;
+}
+
+// Write an image at base, containing all the PG instances or just the dirty ones when an index is given
+static bool writeImage(uintptr_t base, uint16_t crc, const eepromRecordIndex_t *dirtyIndex)
 {
     config_streamer_t streamer;
     config_streamer_init(&streamer);
 
-    config_streamer_start(&streamer, (uintptr_t)&__config_start, &__config_end - &__config_start);
+    config_streamer_start(&streamer, base, &__config_end - (const uint8_t *)base);
 
     configHeader_t header = {
         .format = EEPROM_CONF_VERSION,
@@ -255,7 +369,7 @@ static bool writeSettingsToEEPROM(void)
     if (config_streamer_write(&streamer, (uint8_t *)&header, sizeof(header)) < 0) {
         return false;
     }
-    uint16_t crc = updateCRC(0, (uint8_t *)&header, sizeof(header));
+    crc = updateCRC(crc, (uint8_t *)&header, sizeof(header));
     PG_FOREACH(reg) {
         const uint16_t regSize = pgSize(reg);
         configRecord_t record = {
@@ -265,33 +379,22 @@ static bool writeSettingsToEEPROM(void)
             .flags = 0
         };
 
-        if (pgIsSystem(reg)) {
-            // write the only instance
-            record.flags |= CR_CLASSICATION_SYSTEM;
+        // write one instance for each profile, or the only instance for system PGs
+        for (uint8_t profileIndex = 0; profileIndex < recordCount(reg); profileIndex++) {
+            if (dirtyIndex && !isRecordDirty(dirtyIndex, reg, profileIndex)) {
+                continue;
+            }
+
+            record.flags = recordClassification(reg, profileIndex);
             if (config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record)) < 0) {
                 return false;
             }
             crc = updateCRC(crc, (uint8_t *)&record, sizeof(record));
-            if (config_streamer_write(&streamer, reg->address, regSize) < 0) {
+            const uint8_t *address = reg->address + (regSize * profileIndex);
+            if (config_streamer_write(&streamer, address, regSize) < 0) {
                 return false;
             }
-            crc = updateCRC(crc, reg->address, regSize);
-        } else {
-            // write one instance for each profile
-            for (uint8_t profileIndex = 0; profileIndex < MAX_PROFILE_COUNT; profileIndex++) {
-                record.flags = 0;
-
-                record.flags |= ((profileIndex + 1) & CR_CLASSIFICATION_MASK);
-                if (config_streamer_write(&streamer, (uint8_t *)&record, sizeof(record)) < 0) {
-                    return false;
-                }
-                crc = updateCRC(crc, (uint8_t *)&record, sizeof(record));
-                const uint8_t *address = reg->address + (regSize * profileIndex);
-                if (config_streamer_write(&streamer, address, regSize) < 0) {
-                    return false;
-                }
-                crc = updateCRC(crc, address, regSize);
-            }
+            crc = updateCRC(crc, address, regSize);
         }
     }
 
@@ -318,12 +421,56 @@ static bool writeSettingsToEEPROM(void)
     return success;
 }
 
+// Size of an image with the dirty PG instances, 0 if nothing changed
+static uint32_t dirtyImageSize(const eepromRecordIndex_t *index)
+{
+    uint32_t size = 0;
+
+    PG_FOREACH(reg) {
+        for (uint8_t profileIndex = 0; profileIndex < recordCount(reg); profileIndex++) {
+            if (isRecordDirty(index, reg, profileIndex)) {
+                size += sizeof(configRecord_t) + pgSize(reg);
+            }
+        }
+    }
+    return size ? sizeof(configHeader_t) + size + sizeof(configFooter_t) + sizeof(uint16_t) : 0;
+}
+
+// End of the erase unit holding the last byte of the log
+static const uint8_t *eraseUnitEnd(const uint8_t *logEnd)
+{
+    const uintptr_t lastOffset = logEnd - 1 - &__config_start;
+    const uint32_t eraseSize = config_streamer_erase_size((uintptr_t)(logEnd - 1));
+    return &__config_start + (lastOffset / eraseSize + 1) * eraseSize;
+}
+
+static bool writeSettingsToEEPROM(bool append)
+{
+    if (append && eepromLogEnd && eepromLogAppendable) {
+        eepromRecordIndex_t index[PG_REGISTRY_SIZE];
+        indexEEPROM(index);
+
+        const uint8_t *base = alignToWriteUnit(eepromLogEnd);
+        const uint32_t size = dirtyImageSize(index);
+
+        if (size == 0) {
+            // Nothing changed since the last save
+            return true;
+        }
+        if (base + size <= eraseUnitEnd(eepromLogEnd) && base + size <= logLimit()) {
+            return writeImage((uintptr_t)base, eepromLogCrc, index);
+        }
+        // The erase unit is full, compact the log
+    }
+    return writeImage((uintptr_t)&__config_start, 0, NULL);
+}
+
 void writeConfigToEEPROM(void)
 {
     bool success = false;
-    // write it
+    // write it, retrying with a full save which doesn't depend on the current contents
     for (int attempt = 0; attempt < 3 && !success; attempt++) {
-        if (writeSettingsToEEPROM()) {
+        if (writeSettingsToEEPROM(attempt == 0)) {
             success = true;
 #ifdef CONFIG_IN_EXTERNAL_FLASH
             // copy it back from flash to the in-memory buffer.
@@ -57,3 +57,6 @@ int config_streamer_flush(config_streamer_t *c);
 
 int config_streamer_finish(config_streamer_t *c);
 int config_streamer_status(config_streamer_t *c);
+
+// Size of the erase unit holding address. Writing the first word of a unit erases all of it.
+uint32_t config_streamer_erase_size(uintptr_t address);
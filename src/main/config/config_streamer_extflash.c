@@ -17,6 +17,7 @@
 
 #include <string.h>
 #include "platform.h"
+#include "common/utils.h"
 #include "drivers/system.h"
 #include "drivers/flash.h"
 #include "config/config_streamer.h"
@@ -39,6 +40,13 @@ void config_streamer_impl_lock(void)
     streamerLocked = true;
 }
 
+// The partition starts on a sector, so eepromData is aligned like the flash
+uint32_t config_streamer_impl_erase_size(uintptr_t address)
+{
+    UNUSED(address);
+    return flashGetGeometry()->sectorSize;
+}
+
 int config_streamer_impl_write_word(config_streamer_t *c, config_streamer_buffer_align_type_t *buffer)
 {
     if (streamerLocked) {
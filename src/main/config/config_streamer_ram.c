@@ -17,11 +17,18 @@
 
 #include <string.h>
 #include "platform.h"
+#include "common/maths.h"
+#include "common/utils.h"
 #include "drivers/system.h"
 #include "config/config_streamer.h"
 
 #if defined(CONFIG_IN_RAM)
 
+// Erased all at once, unless a test emulates the sectors of a flash
+#ifndef CONFIG_STREAMER_RAM_ERASE_SIZE
+#define CONFIG_STREAMER_RAM_ERASE_SIZE  EEPROM_SIZE
+#endif
+
 static bool streamerLocked = true;
 
 void config_streamer_impl_unlock(void)
@@ -34,14 +41,21 @@ void config_streamer_impl_lock(void)
     streamerLocked = true;
 }
 
+uint32_t config_streamer_impl_erase_size(uintptr_t address)
+{
+    UNUSED(address);
+    return CONFIG_STREAMER_RAM_ERASE_SIZE;
+}
+
 int config_streamer_impl_write_word(config_streamer_t *c, config_streamer_buffer_align_type_t *buffer)
 {
     if (streamerLocked) {
         return -1;
     }
 
-    if (c->address == (uintptr_t)&eepromData[0]) {
-        memset(eepromData, 0, sizeof(eepromData));
+    const size_t offset = c->address - (uintptr_t)&eepromData[0];
+    if (offset % CONFIG_STREAMER_RAM_ERASE_SIZE == 0) {
+        memset(&eepromData[offset], 0, MIN((size_t)CONFIG_STREAMER_RAM_ERASE_SIZE, sizeof(eepromData) - offset));
     }
 
     config_streamer_buffer_align_type_t *destAddr = (config_streamer_buffer_align_type_t *)c->address;
@@ -36,7 +36,6 @@ Sector 9    0x080A0000 - 0x080BFFFF 128 Kbytes
 Sector 10   0x080C0000 - 0x080DFFFF 128 Kbytes
 Sector 11   0x080E0000 - 0x080FFFFF 128 Kbytes
 */
-#define FLASH_PAGE_SIZE     ((uint32_t)0x4000)
 static uint32_t getFLASHSectorForEEPROM(uint32_t address)
 {
     if (address <= 0x08003FFF)
@@ -57,9 +56,9 @@ static uint32_t getFLASHSectorForEEPROM(uint32_t address)
         return FLASH_Sector_7;
     if (address <= 0x0809FFFF)
         return FLASH_Sector_8;
-    if (address <= 0x080DFFFF)
-        return FLASH_Sector_9;
     if (address <= 0x080BFFFF)
+        return FLASH_Sector_9;
+    if (address <= 0x080DFFFF)
         return FLASH_Sector_10;
     if (address <= 0x080FFFFF)
         return FLASH_Sector_11;
@@ -81,13 +80,23 @@ void config_streamer_impl_lock(void)
     FLASH_Lock();
 }
 
+// Every sector starts at a multiple of its size
+uint32_t config_streamer_impl_erase_size(uintptr_t address)
+{
+    if (address <= 0x0800FFFF)
+        return 0x4000;
+    if (address <= 0x0801FFFF)
+        return 0x10000;
+    return 0x20000;
+}
+
 int config_streamer_impl_write_word(config_streamer_t *c, config_streamer_buffer_align_type_t *buffer)
 {
     if (c->err != 0) {
         return c->err;
     }
 
-    if (c->address % FLASH_PAGE_SIZE == 0) {
+    if (c->address % config_streamer_impl_erase_size(c->address) == 0) {
         const FLASH_Status status = FLASH_EraseSector(getFLASHSectorForEEPROM(c->address), VoltageRange_3);
         if (status != FLASH_COMPLETE) {
             return -1;
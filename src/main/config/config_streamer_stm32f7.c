@@ -33,7 +33,6 @@ Sector 5    0x08040000 - 0x0807FFFF 256 Kbytes
 Sector 6    0x08080000 - 0x080BFFFF 256 Kbytes
 Sector 7    0x080C0000 - 0x080FFFFF 256 Kbytes
 */
-#define FLASH_PAGE_SIZE ((uint32_t)0x8000)
 static uint32_t getFLASHSectorForEEPROM(uint32_t address)
 {
     if (address <= 0x08007FFF)
@@ -58,6 +57,16 @@ static uint32_t getFLASHSectorForEEPROM(uint32_t address)
         failureMode(FAILURE_FLASH_WRITE_FAILED);
     }
 }
+
+// Every sector starts at a multiple of its size
+uint32_t config_streamer_impl_erase_size(uintptr_t address)
+{
+    if (address <= 0x0801FFFF)
+        return 0x8000;
+    if (address <= 0x0803FFFF)
+        return 0x20000;
+    return 0x40000;
+}
 #elif defined(STM32F722xx)
 /*
 Sector 0    0x08000000 - 0x08003FFF 16 Kbytes
@@ -69,7 +78,6 @@ Sector 5    0x08020000 - 0x0803FFFF 128 Kbytes
 Sector 6    0x08040000 - 0x0805FFFF 128 Kbytes
 Sector 7    0x08060000 - 0x0807FFFF 128 Kbytes
 */
-#define FLASH_PAGE_SIZE ((uint32_t)0x4000)
 static uint32_t getFLASHSectorForEEPROM(uint32_t address)
 {
     if (address <= 0x08003FFF)
@@ -94,6 +102,16 @@ static uint32_t getFLASHSectorForEEPROM(uint32_t address)
         failureMode(FAILURE_FLASH_WRITE_FAILED);
     }
 }
+
+// Every sector starts at a multiple of its size
+uint32_t config_streamer_impl_erase_size(uintptr_t address)
+{
+    if (address <= 0x0800FFFF)
+        return 0x4000;
+    if (address <= 0x0801FFFF)
+        return 0x10000;
+    return 0x20000;
+}
 #else
 #  error "Unsupported CPU!"
 #endif
@@ -114,7 +132,7 @@ int config_streamer_impl_write_word(config_streamer_t *c, config_streamer_buffer
         return c->err;
     }
 
-    if (c->address % FLASH_PAGE_SIZE == 0) {
+    if (c->address % config_streamer_impl_erase_size(c->address) == 0) {
         FLASH_EraseInitTypeDef EraseInitStruct = {
             .TypeErase     = FLASH_TYPEERASE_SECTORS,
             .VoltageRange  = FLASH_VOLTAGE_RANGE_3, // 2.7-3.6V
@@ -17,6 +17,7 @@
 
 #include <string.h>
 #include "platform.h"
+#include "common/utils.h"
 #include "drivers/system.h"
 #include "config/config_streamer.h"
 
@@ -64,6 +65,12 @@ void config_streamer_impl_lock(void)
     HAL_FLASH_Lock();
 }
 
+uint32_t config_streamer_impl_erase_size(uintptr_t address)
+{
+    UNUSED(address);
+    return FLASH_PAGE_SIZE;
+}
+
 int config_streamer_impl_write_word(config_streamer_t *c, config_streamer_buffer_align_type_t *buffer)
 {
     if (c->err != 0) {
@@ -31,6 +31,9 @@
 #define GYRO_LPF_5HZ        6
 #define GYRO_LPF_NONE       7
 
+// Maximum number of samples drained from the sensor FIFO in one burst
+#define GYRO_FIFO_SAMPLE_COUNT_MAX  16
+
 typedef struct {
     uint8_t gyroLpf;
     uint16_t gyroRateHz;
@@ -41,6 +44,7 @@ typedef struct gyroDev_s {
     busDevice_t * busDev;
     sensorGyroInitFuncPtr initFn;                       // initialize function
     sensorGyroReadFuncPtr readFn;                       // read 3 axis data function
+    sensorGyroReadFifoFuncPtr readFifoFn;               // drain pending samples into gyroFifo, returns the sample count. NULL when the FIFO is not used
     sensorGyroReadDataFuncPtr temperatureFn;            // read temperature if available
     sensorGyroInterruptStatusFuncPtr intStatusFn;
     sensorGyroUpdateFuncPtr updateFn;
@@ -48,6 +52,7 @@ typedef struct gyroDev_s {
     float scale;                                        // scalefactor
     int16_t gyroADCRaw[XYZ_AXIS_COUNT];
     int16_t gyroZero[XYZ_AXIS_COUNT];
+    int16_t gyroFifo[GYRO_FIFO_SAMPLE_COUNT_MAX][XYZ_AXIS_COUNT];  // samples drained by readFifoFn, oldest first
     uint8_t imuSensorToUse;
     uint8_t lpf;                                        // Configuration value: Hardware LPF setting
     uint32_t requestedSampleIntervalUs;                 // Requested sample interval
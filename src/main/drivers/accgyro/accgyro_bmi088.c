@@ -83,6 +83,15 @@
 #define REGG_FIFO_CONFIG_1 0x3E
 #define REGG_FIFO_DATA     0x3F
 
+#define GYRO_FIFO_STATUS_OVERRUN        0x80
+#define GYRO_FIFO_STATUS_FRAME_COUNT    0x7F
+#define GYRO_FIFO_MODE_STREAM           0x80
+#define GYRO_FIFO_FRAME_SIZE            6
+
+#ifdef USE_GYRO_FIFO
+static uint8_t gyroFifoBuffer[GYRO_FIFO_SAMPLE_COUNT_MAX * GYRO_FIFO_FRAME_SIZE];
+#endif
+
 
 static void bmi088GyroInit(gyroDev_t *gyro)
 {
@@ -102,6 +111,15 @@ static void bmi088GyroInit(gyroDev_t *gyro)
     busWrite(gyro->busDev, REGG_INT_CTRL, 0x80);
     delay(1);
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->readFifoFn) {
+        // Stream mode, X/Y/Z frames. Samples are drained at 2kHz ODR
+        busWrite(gyro->busDev, REGG_FIFO_CONFIG_1, GYRO_FIFO_MODE_STREAM);
+        delay(1);
+        gyro->sampleRateIntervalUs = 500;
+    }
+#endif
+
     busSetSpeed(gyro->busDev, BUS_SPEED_FAST);
 }
 
@@ -148,6 +166,47 @@ static bool bmi088GyroRead(gyroDev_t *gyro)
     return false;
 }
 
+#ifdef USE_GYRO_FIFO
+static uint8_t bmi088GyroReadFifo(gyroDev_t *gyro)
+{
+    uint8_t fifoStatus;
+
+    if (!busRead(gyro->busDev, REGG_FIFO_STATUS, &fifoStatus)) {
+        return 0;
+    }
+
+    const uint8_t frameCount = fifoStatus & GYRO_FIFO_STATUS_FRAME_COUNT;
+
+    if ((fifoStatus & GYRO_FIFO_STATUS_OVERRUN) || frameCount > GYRO_FIFO_SAMPLE_COUNT_MAX) {
+        // We fell behind. Writing the FIFO configuration clears the FIFO,
+        // use the current sample instead
+        busWrite(gyro->busDev, REGG_FIFO_CONFIG_1, GYRO_FIFO_MODE_STREAM);
+
+        if (!bmi088GyroRead(gyro)) {
+            return 0;
+        }
+
+        gyro->gyroFifo[0][X] = gyro->gyroADCRaw[X];
+        gyro->gyroFifo[0][Y] = gyro->gyroADCRaw[Y];
+        gyro->gyroFifo[0][Z] = gyro->gyroADCRaw[Z];
+        return 1;
+    }
+
+    if (frameCount == 0 || !busReadBuf(gyro->busDev, REGG_FIFO_DATA, gyroFifoBuffer, frameCount * GYRO_FIFO_FRAME_SIZE)) {
+        return 0;
+    }
+
+    for (int i = 0; i < frameCount; i++) {
+        const uint8_t * frame = &gyroFifoBuffer[i * GYRO_FIFO_FRAME_SIZE];
+        gyro->gyroFifo[i][X] = (int16_t)((frame[1] << 8) | frame[0]);
+        gyro->gyroFifo[i][Y] = (int16_t)((frame[3] << 8) | frame[2]);
+        gyro->gyroFifo[i][Z] = (int16_t)((frame[5] << 8) | frame[4]);
+    }
+
+    return frameCount;
+}
+#endif
+
 static bool bmi088AccRead(accDev_t *acc)
 {
     uint8_t buffer[7];
@@ -235,6 +294,9 @@ bool bmi088GyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = bmi088GyroInit;
     gyro->readFn = bmi088GyroRead;
+#ifdef USE_GYRO_FIFO
+    gyro->readFifoFn = (gyro->busDev->busType == BUSTYPE_SPI) ? bmi088GyroReadFifo : NULL;
+#endif
     gyro->scale = 1.0f / 16.4f; // 16.4 dps/lsb
     gyro->intStatusFn = gyroCheckDataReady;
     gyro->gyroAlign = gyro->busDev->param;
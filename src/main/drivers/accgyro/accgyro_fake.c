@@ -17,6 +17,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -31,9 +32,22 @@
 
 static int16_t fakeGyroADC[XYZ_AXIS_COUNT];
 
+#ifdef USE_GYRO_FIFO
+#define FAKE_GYRO_FIFO_SIZE     (GYRO_FIFO_SAMPLE_COUNT_MAX * 2)
+
+static bool fakeGyroFifoEnabled;
+static int16_t fakeGyroFifo[FAKE_GYRO_FIFO_SIZE][XYZ_AXIS_COUNT];
+static uint8_t fakeGyroFifoCount;
+#endif
+
 static void fakeGyroInit(gyroDev_t *gyro)
 {
+#ifdef USE_GYRO_FIFO
+    fakeGyroFifoEnabled = (gyro->readFifoFn != NULL);
+    fakeGyroFifoCount = 0;
+#else
     UNUSED(gyro);
+#endif
 }
 
 void fakeGyroSet(int16_t x, int16_t y, int16_t z)
@@ -41,6 +55,16 @@ void fakeGyroSet(int16_t x, int16_t y, int16_t z)
     fakeGyroADC[X] = x;
     fakeGyroADC[Y] = y;
     fakeGyroADC[Z] = z;
+
+#ifdef USE_GYRO_FIFO
+    // Every sample is also queued in the FIFO, new ones are dropped when it's full
+    if (fakeGyroFifoEnabled && fakeGyroFifoCount < FAKE_GYRO_FIFO_SIZE) {
+        fakeGyroFifo[fakeGyroFifoCount][X] = x;
+        fakeGyroFifo[fakeGyroFifoCount][Y] = y;
+        fakeGyroFifo[fakeGyroFifoCount][Z] = z;
+        fakeGyroFifoCount++;
+    }
+#endif
 }
 
 static bool fakeGyroRead(gyroDev_t *gyro)
@@ -51,6 +75,27 @@ static bool fakeGyroRead(gyroDev_t *gyro)
     return true;
 }
 
+#ifdef USE_GYRO_FIFO
+static uint8_t fakeGyroReadFifo(gyroDev_t *gyro)
+{
+    if (fakeGyroFifoCount > GYRO_FIFO_SAMPLE_COUNT_MAX) {
+        // Same as the real drivers, flush the FIFO and use the current sample
+        fakeGyroFifoCount = 0;
+        fakeGyroRead(gyro);
+        gyro->gyroFifo[0][X] = gyro->gyroADCRaw[X];
+        gyro->gyroFifo[0][Y] = gyro->gyroADCRaw[Y];
+        gyro->gyroFifo[0][Z] = gyro->gyroADCRaw[Z];
+        return 1;
+    }
+
+    const uint8_t sampleCount = fakeGyroFifoCount;
+    memcpy(gyro->gyroFifo, fakeGyroFifo, sampleCount * sizeof(fakeGyroFifo[0]));
+    fakeGyroFifoCount = 0;
+
+    return sampleCount;
+}
+#endif
+
 static bool fakeGyroReadTemperature(gyroDev_t *gyro, int16_t *temperatureData)
 {
     UNUSED(gyro);
@@ -69,15 +114,18 @@ bool fakeGyroDetect(gyroDev_t *gyro)
     gyro->initFn = fakeGyroInit;
     gyro->intStatusFn = fakeGyroInitStatus;
     gyro->readFn = fakeGyroRead;
+#ifdef USE_GYRO_FIFO
+    gyro->readFifoFn = fakeGyroReadFifo;
+#endif
     gyro->temperatureFn = fakeGyroReadTemperature;
     gyro->scale = 1.0f / 16.4f;
     gyro->gyroAlign = 0;
     return true;
 }
-#endif // USE_FAKE_GYRO
+#endif // USE_IMU_FAKE
 
 
-#ifdef USE_FAKE_ACC
+#ifdef USE_IMU_FAKE
 
 static int16_t fakeAccData[XYZ_AXIS_COUNT];
 
@@ -108,5 +156,5 @@ bool fakeAccDetect(accDev_t *acc)
     acc->accAlign = 0;
     return true;
 }
-#endif // USE_FAKE_ACC
+#endif // USE_IMU_FAKE
 
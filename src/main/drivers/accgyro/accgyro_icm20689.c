@@ -121,6 +121,12 @@ static void icm20689AccAndGyroInit(gyroDev_t *gyro)
     busWrite(busDev, MPU_RA_INT_ENABLE, 0x01); // RAW_RDY_EN interrupt enable
 #endif
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->readFifoFn) {
+        mpuGyroFifoInit(gyro);
+    }
+#endif
+
     // Switch SPI to fast speed
     busSetSpeed(busDev, BUS_SPEED_FAST);
 }
@@ -143,6 +149,9 @@ bool icm20689GyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = icm20689AccAndGyroInit;
     gyro->readFn = mpuGyroReadScratchpad;
+#ifdef USE_GYRO_FIFO
+    gyro->readFifoFn = (gyro->busDev->busType == BUSTYPE_SPI) ? mpuGyroReadFifo : NULL;
+#endif
     gyro->intStatusFn = gyroCheckDataReady;
     gyro->temperatureFn = mpuTemperatureReadScratchpad;
     gyro->scale = 1.0f / 16.4f;     // 16.4 dps/lsb scalefactor
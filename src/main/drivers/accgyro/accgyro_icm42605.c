@@ -84,6 +84,26 @@
 #define ICM42605_UI_DRDY_INT1_EN_DISABLED           (0 << 3)
 #define ICM42605_UI_DRDY_INT1_EN_ENABLED            (1 << 3)
 
+#define ICM42605_RA_SIGNAL_PATH_RESET               0x4B
+#define ICM42605_FIFO_FLUSH                         (1 << 1)
+
+#define ICM42605_RA_FIFO_CONFIG                     0x16
+#define ICM42605_FIFO_MODE_STREAM                   (1 << 6)
+
+#define ICM42605_RA_FIFO_CONFIG1                    0x5F
+#define ICM42605_FIFO_GYRO_EN                       (1 << 1)
+
+#define ICM42605_RA_FIFO_COUNTH                     0x2E
+#define ICM42605_RA_FIFO_DATA                       0x30
+
+// Gyro only FIFO packet: header, gyro X/Y/Z, temperature
+#define ICM42605_FIFO_PACKET_SIZE                   8
+#define ICM42605_FIFO_HEADER_EMPTY                  (1 << 7)
+
+#ifdef USE_GYRO_FIFO
+static uint8_t icm42605FifoBuffer[GYRO_FIFO_SAMPLE_COUNT_MAX * ICM42605_FIFO_PACKET_SIZE];
+#endif
+
 
 static void icm42605AccInit(accDev_t *acc)
 {
@@ -195,6 +215,19 @@ static void icm42605AccAndGyroInit(gyroDev_t *gyro)
     delay(15);
 #endif
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->readFifoFn) {
+        busWrite(dev, ICM42605_RA_FIFO_CONFIG1, ICM42605_FIFO_GYRO_EN);
+        delay(15);
+
+        busWrite(dev, ICM42605_RA_FIFO_CONFIG, ICM42605_FIFO_MODE_STREAM);
+        delay(15);
+
+        busWrite(dev, ICM42605_RA_SIGNAL_PATH_RESET, ICM42605_FIFO_FLUSH);
+        delay(15);
+    }
+#endif
+
     busSetSpeed(dev, BUS_SPEED_FAST);
 }
 
@@ -243,6 +276,53 @@ static bool icm42605GyroRead(gyroDev_t *gyro)
     return true;
 }
 
+#ifdef USE_GYRO_FIFO
+static uint8_t icm42605GyroReadFifo(gyroDev_t *gyro)
+{
+    uint8_t data[2];
+
+    if (!busReadBuf(gyro->busDev, ICM42605_RA_FIFO_COUNTH, data, 2)) {
+        return 0;
+    }
+
+    const uint16_t packetCount = ((data[0] << 8) | data[1]) / ICM42605_FIFO_PACKET_SIZE;
+
+    if (packetCount > GYRO_FIFO_SAMPLE_COUNT_MAX) {
+        // We fell behind, flush the FIFO and use the current sample instead
+        busWrite(gyro->busDev, ICM42605_RA_SIGNAL_PATH_RESET, ICM42605_FIFO_FLUSH);
+
+        if (!icm42605GyroRead(gyro)) {
+            return 0;
+        }
+
+        gyro->gyroFifo[0][X] = gyro->gyroADCRaw[X];
+        gyro->gyroFifo[0][Y] = gyro->gyroADCRaw[Y];
+        gyro->gyroFifo[0][Z] = gyro->gyroADCRaw[Z];
+        return 1;
+    }
+
+    if (packetCount == 0 || !busReadBuf(gyro->busDev, ICM42605_RA_FIFO_DATA, icm42605FifoBuffer, packetCount * ICM42605_FIFO_PACKET_SIZE)) {
+        return 0;
+    }
+
+    uint8_t sampleCount = 0;
+    for (int i = 0; i < packetCount; i++) {
+        const uint8_t * packet = &icm42605FifoBuffer[i * ICM42605_FIFO_PACKET_SIZE];
+
+        if (packet[0] & ICM42605_FIFO_HEADER_EMPTY) {
+            break;
+        }
+
+        gyro->gyroFifo[sampleCount][X] = (int16_t)((packet[1] << 8) | packet[2]);
+        gyro->gyroFifo[sampleCount][Y] = (int16_t)((packet[3] << 8) | packet[4]);
+        gyro->gyroFifo[sampleCount][Z] = (int16_t)((packet[5] << 8) | packet[6]);
+        sampleCount++;
+    }
+
+    return sampleCount;
+}
+#endif
+
 bool icm42605GyroDetect(gyroDev_t *gyro)
 {
     gyro->busDev = busDeviceInit(BUSTYPE_ANY, DEVHW_ICM42605, gyro->imuSensorToUse, OWNER_MPU);
@@ -261,6 +341,9 @@ bool icm42605GyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = icm42605AccAndGyroInit;
     gyro->readFn = icm42605GyroRead;
+#ifdef USE_GYRO_FIFO
+    gyro->readFifoFn = (gyro->busDev->busType == BUSTYPE_SPI) ? icm42605GyroReadFifo : NULL;
+#endif
     gyro->intStatusFn = gyroCheckDataReady;
     gyro->temperatureFn = NULL;
     gyro->scale = 1.0f / 16.4f;     // 16.4 dps/lsb scalefactor
@@ -111,6 +111,75 @@ bool mpuGyroReadScratchpad(gyroDev_t *gyro)
     return false;
 }
 
+#ifdef USE_GYRO_FIFO
+static uint8_t mpuFifoBuffer[GYRO_FIFO_SAMPLE_COUNT_MAX * MPU_FIFO_FRAME_SIZE];
+
+static void mpuGyroFifoReset(busDevice_t * busDev)
+{
+    uint8_t userCtrl;
+
+    busRead(busDev, MPU_RA_USER_CTRL, &userCtrl);
+    busWrite(busDev, MPU_RA_USER_CTRL, userCtrl | MPU_USER_CTRL_FIFO_EN | MPU_USER_CTRL_FIFO_RST);
+}
+
+void mpuGyroFifoInit(gyroDev_t *gyro)
+{
+    busWrite(gyro->busDev, MPU_RA_FIFO_EN, MPU_FIFO_EN_TEMP | MPU_FIFO_EN_GYRO | MPU_FIFO_EN_ACCEL);
+    delayMicroseconds(15);
+
+    mpuGyroFifoReset(gyro->busDev);
+    delayMicroseconds(15);
+}
+
+uint8_t mpuGyroReadFifo(gyroDev_t *gyro)
+{
+    busDevice_t * busDev = gyro->busDev;
+    mpuContextData_t * ctx = busDeviceGetScratchpadMemory(busDev);
+    uint8_t data[2];
+
+    if (!busReadBuf(busDev, MPU_RA_FIFO_COUNTH, data, 2)) {
+        return 0;
+    }
+
+    const uint16_t frameCount = ((data[0] << 8) | data[1]) / MPU_FIFO_FRAME_SIZE;
+
+    if (frameCount > GYRO_FIFO_SAMPLE_COUNT_MAX) {
+        // We fell behind and the FIFO might have overflown. Restart it
+        // and use the current sample from the data registers.
+        mpuGyroFifoReset(busDev);
+
+        if (!mpuGyroReadScratchpad(gyro)) {
+            return 0;
+        }
+
+        gyro->gyroFifo[0][X] = gyro->gyroADCRaw[X];
+        gyro->gyroFifo[0][Y] = gyro->gyroADCRaw[Y];
+        gyro->gyroFifo[0][Z] = gyro->gyroADCRaw[Z];
+        return 1;
+    }
+
+    if (frameCount == 0 || !busReadBuf(busDev, MPU_RA_FIFO_R_W, mpuFifoBuffer, frameCount * MPU_FIFO_FRAME_SIZE)) {
+        return 0;
+    }
+
+    for (int i = 0; i < frameCount; i++) {
+        const uint8_t * gyroRaw = &mpuFifoBuffer[i * MPU_FIFO_FRAME_SIZE + 8];
+        gyro->gyroFifo[i][X] = (int16_t)((gyroRaw[0] << 8) | gyroRaw[1]);
+        gyro->gyroFifo[i][Y] = (int16_t)((gyroRaw[2] << 8) | gyroRaw[3]);
+        gyro->gyroFifo[i][Z] = (int16_t)((gyroRaw[4] << 8) | gyroRaw[5]);
+    }
+
+    // Accelerometer and temperature are read from the newest frame
+    const uint8_t * lastFrame = &mpuFifoBuffer[(frameCount - 1) * MPU_FIFO_FRAME_SIZE];
+    memcpy(ctx->accRaw, &lastFrame[0], sizeof(ctx->accRaw));
+    memcpy(ctx->tempRaw, &lastFrame[6], sizeof(ctx->tempRaw));
+    memcpy(ctx->gyroRaw, &lastFrame[8], sizeof(ctx->gyroRaw));
+    ctx->lastReadStatus = true;
+
+    return frameCount;
+}
+#endif
+
 bool mpuAccReadScratchpad(accDev_t *acc)
 {
     mpuContextData_t * ctx = busDeviceGetScratchpadMemory(acc->busDev);
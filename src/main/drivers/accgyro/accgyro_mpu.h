@@ -133,6 +133,16 @@
 // RF = Register Flag
 #define MPU_RF_DATA_RDY_EN (1 << 0)
 
+#define MPU_FIFO_EN_TEMP        (1 << 7)
+#define MPU_FIFO_EN_GYRO        (7 << 4)
+#define MPU_FIFO_EN_ACCEL       (1 << 3)
+
+#define MPU_USER_CTRL_FIFO_EN   (1 << 6)
+#define MPU_USER_CTRL_FIFO_RST  (1 << 2)
+
+// FIFO frame with accel, temperature and gyro, same layout as the data registers
+#define MPU_FIFO_FRAME_SIZE     14
+
 #define MPU_DLPF_10HZ           0x05
 #define MPU_DLPF_20HZ           0x04
 #define MPU_DLPF_42HZ           0x03
@@ -189,3 +199,5 @@ bool mpuGyroRead(struct gyroDev_s *gyro);
 bool mpuGyroReadScratchpad(struct gyroDev_s *gyro);
 bool mpuAccReadScratchpad(struct accDev_s *acc);
 bool mpuTemperatureReadScratchpad(struct gyroDev_s *gyro, int16_t * data);
+void mpuGyroFifoInit(struct gyroDev_s *gyro);
+uint8_t mpuGyroReadFifo(struct gyroDev_s *gyro);
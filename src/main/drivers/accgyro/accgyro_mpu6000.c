@@ -122,6 +122,12 @@ static void mpu6000AccAndGyroInit(gyroDev_t *gyro)
     busWrite(busDev, MPU_RA_CONFIG, config->gyroConfigValues[0]);
     delayMicroseconds(1);
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->readFifoFn) {
+        mpuGyroFifoInit(gyro);
+    }
+#endif
+
     busSetSpeed(busDev, BUS_SPEED_FAST);
 
     mpuGyroRead(gyro);
@@ -216,6 +222,9 @@ bool mpu6000GyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = mpu6000AccAndGyroInit;
     gyro->readFn = mpuGyroReadScratchpad;
+#ifdef USE_GYRO_FIFO
+    gyro->readFifoFn = (gyro->busDev->busType == BUSTYPE_SPI) ? mpuGyroReadFifo : NULL;
+#endif
     gyro->intStatusFn = gyroCheckDataReady;
     gyro->temperatureFn = mpuTemperatureReadScratchpad;
     gyro->scale = 1.0f / 16.4f;     // 16.4 dps/lsb scalefactor
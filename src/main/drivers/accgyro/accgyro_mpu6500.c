@@ -108,6 +108,12 @@ static void mpu6500AccAndGyroInit(gyroDev_t *gyro)
     delay(15);
 #endif
 
+#ifdef USE_GYRO_FIFO
+    if (gyro->readFifoFn) {
+        mpuGyroFifoInit(gyro);
+    }
+#endif
+
     busSetSpeed(dev, BUS_SPEED_FAST);
 }
 
@@ -161,6 +167,9 @@ bool mpu6500GyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = mpu6500AccAndGyroInit;
     gyro->readFn = mpuGyroReadScratchpad;
+#ifdef USE_GYRO_FIFO
+    gyro->readFifoFn = (gyro->busDev->busType == BUSTYPE_SPI) ? mpuGyroReadFifo : NULL;
+#endif
     gyro->intStatusFn = gyroCheckDataReady;
     gyro->temperatureFn = mpuTemperatureReadScratchpad;
     gyro->scale = 1.0f / 16.4f;     // 16.4 dps/lsb scalefactor
@@ -210,6 +210,11 @@ typedef struct busDevice_s {
 extern const busDeviceDescriptor_t __busdev_registry_start[] __asm("section$start$__DATA$__busdev_registry");
 extern const busDeviceDescriptor_t __busdev_registry_end[] __asm("section$end$__DATA$__busdev_registry");
 #define BUSDEV_REGISTER_ATTRIBUTES __attribute__ ((section("__DATA,__busdev_registry"), used, aligned(4)))
+#elif defined(SITL_BUILD)
+// Weak, since the registry is empty when no bus devices are compiled in
+extern const busDeviceDescriptor_t __busdev_registry_start[] __asm("__start_busdev_registry") __attribute__((weak));
+extern const busDeviceDescriptor_t __busdev_registry_end[] __asm("__stop_busdev_registry") __attribute__((weak));
+#define BUSDEV_REGISTER_ATTRIBUTES __attribute__ ((section("busdev_registry"), used, aligned(4)))
 #else
 extern const busDeviceDescriptor_t __busdev_registry_start[];
 extern const busDeviceDescriptor_t __busdev_registry_end[];
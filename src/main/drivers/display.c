@@ -47,7 +47,7 @@ PG_RESET_TEMPLATE(displayConfig_t, displayConfig,
     .force_sw_blink = SETTING_DISPLAY_FORCE_SW_BLINK_DEFAULT
 );
 
-static bool displayAttributesRequireEmulation(displayPort_t *instance, textAttributes_t attr)
+bool displayAttributesRequireEmulation(const displayPort_t *instance, textAttributes_t attr)
 {
     if (attr & ~instance->cachedSupportedTextAttributes) {
         // We only emulate blink for now
@@ -93,6 +93,7 @@ void displayClearScreen(displayPort_t *instance)
     instance->vTable->clearScreen(instance);
     instance->cleared = true;
     instance->cursorRow = -1;
+    ++instance->clearCount;
 }
 
 void displayDrawScreen(displayPort_t *instance)
@@ -113,6 +114,7 @@ void displayGrab(displayPort_t *instance)
 {
     instance->vTable->grab(instance);
     instance->vTable->clearScreen(instance);
+    ++instance->clearCount;
     ++instance->grabCount;
 }
 
@@ -122,6 +124,7 @@ void displayRelease(displayPort_t *instance)
     // displayPort_t is changing owner. Clear it, since
     // the new owner might expect a clear canvas.
     instance->vTable->clearScreen(instance);
+    ++instance->clearCount;
     --instance->grabCount;
 }
 
@@ -306,6 +309,7 @@ void displayInit(displayPort_t *instance, const displayPortVTable_t *vTable)
     instance->useFullscreen = false;
     instance->cleared = true;
     instance->grabCount = 0;
+    instance->clearCount = 0;
     instance->cursorRow = -1;
     instance->cachedSupportedTextAttributes = TEXT_ATTRIBUTES_NONE;
     if (vTable->supportedTextAttributes) {
@@ -79,6 +79,7 @@ typedef struct displayPort_s {
     bool cleared;
     int8_t cursorRow;
     int8_t grabCount;
+    uint16_t clearCount; // Incremented every time the screen is cleared
     textAttributes_t cachedSupportedTextAttributes;
     uint16_t maxChar;
 } displayPort_t;
@@ -123,6 +124,7 @@ int displayScreenSize(const displayPort_t *instance);
 void displaySetXY(displayPort_t *instance, uint8_t x, uint8_t y);
 int displayWrite(displayPort_t *instance, uint8_t x, uint8_t y, const char *s);
 int displayWriteWithAttr(displayPort_t *instance, uint8_t x, uint8_t y, const char *s, textAttributes_t attr);
+bool displayAttributesRequireEmulation(const displayPort_t *instance, textAttributes_t attr);
 int displayWriteChar(displayPort_t *instance, uint8_t x, uint8_t y, uint16_t c);
 int displayWriteCharWithAttr(displayPort_t *instance, uint8_t x, uint8_t y, uint16_t c, textAttributes_t attr);
 bool displayReadCharWithAttr(displayPort_t *instance, uint8_t x, uint8_t y, uint16_t *c, textAttributes_t *attr);
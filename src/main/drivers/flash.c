@@ -37,6 +37,8 @@
 #include "drivers/io.h"
 #include "drivers/time.h"
 
+#include "navigation/navigation_wp_store.h"
+
 static flashPartitionTable_t flashPartitionTable;
 static int flashPartitions = 0;
 
@@ -207,6 +209,10 @@ static void flashConfigurePartitions(void)
     createPartition(FLASH_PARTITION_TYPE_CONFIG, configSize, &endSector);
 #endif
 
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    createPartition(FLASH_PARTITION_TYPE_WAYPOINTS, NAV_WP_STORE_SIZE, &endSector);
+#endif
+
 #ifdef USE_FLASHFS
     flashPartitionSet(FLASH_PARTITION_TYPE_FLASHFS, startSector, endSector);
 #endif
@@ -258,6 +264,9 @@ static const char *flashPartitionNames[] = {
     "FIRMWARE ",
     "CONFIG   ",
     "FW UPDT  ",
+    "FW META  ",
+    "FW IMAGE ",
+    "WAYPOINTS",
 };
 
 const char *flashPartitionGetTypeName(flashPartitionType_e type)
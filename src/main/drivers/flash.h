@@ -76,6 +76,7 @@ typedef enum {
     FLASH_PARTITION_TYPE_FULL_BACKUP,
     FLASH_PARTITION_TYPE_FIRMWARE_UPDATE_META,
     FLASH_PARTITION_TYPE_UPDATE_FIRMWARE,
+    FLASH_PARTITION_TYPE_WAYPOINTS,
     FLASH_MAX_PARTITIONS
 } flashPartitionType_e;
 
@@ -192,9 +192,17 @@ FILE_COMPILE_FOR_SPEED
 // is faster than redrawing the whole screen on each frame.
 static BITARRAY_DECLARE(screenIsDirty, MAX7456_BUFFER_CHARS_PAL);
 
-//max chars to update in one idle
+// The SPI buffer for one idle fits at least this many chars
 #define MAX_CHARS2UPDATE        10
 #define BYTES_PER_CHAR2UPDATE   (7 * 2) // SPI regs + values for them
+// Bytes needed to update a single char, plus a DMM write
+#define BYTES_PER_CHAR          (4 * 2)
+#define BYTES_PER_EXT_CHAR      (7 * 2)
+// Runs of dirty chars with the same attributes are streamed using
+// auto-increment: DMAH + DMAL + DMM, then one byte per char and
+// END_STRING to leave auto-increment mode.
+#define BYTES_PER_RUN           (3 * 2 + 1)
+#define MIN_RUN_LENGTH          2
 
 typedef struct max7456Registers_s {
     uint8_t vm0;
@@ -485,18 +493,43 @@ void max7456Write(uint8_t x, uint8_t y, const char *buff, uint8_t mode)
     }
 }
 
+// Returns the number of consecutive dirty chars starting at pos that
+// can be streamed with auto-increment, up to maxLength. They must all
+// be non-extended and share the same attributes. END_STRING can't
+// be sent as data, so it also ends a run.
+static unsigned max7456DirtyRunLength(size_t pos, unsigned maxLength)
+{
+    const uint8_t charMode = MODE_BYTE(osdCharacterGridBuffer[pos]);
+    unsigned length = 0;
+
+    if (CHAR_MODE_IS_EXT(charMode)) {
+        return 0;
+    }
+
+    while (length < maxLength && pos < ARRAYLEN(osdCharacterGridBuffer) &&
+        bitArrayGet(screenIsDirty, pos) &&
+        MODE_BYTE(osdCharacterGridBuffer[pos]) == charMode &&
+        CHAR_BYTE(osdCharacterGridBuffer[pos]) != END_STRING) {
+
+        length++;
+        pos++;
+    }
+    return length;
+}
+
 // Must be called with the lock held. Returns whether any new characters
-// were drawn.
+// were drawn. The number of chars sent in a call is bounded by the size
+// of the SPI buffer, which is enough for MAX_CHARS2UPDATE chars in the
+// worst case.
 static bool max7456DrawScreenPartial(void)
 {
     uint8_t spiBuff[MAX_CHARS2UPDATE * BYTES_PER_CHAR2UPDATE];
     int bufPtr = 0;
     size_t pos;
-    uint_fast16_t updatedCharCount;
     uint8_t charMode;
     int next;
 
-    for (pos = 0, updatedCharCount = 0; pos < ARRAYLEN(osdCharacterGridBuffer);) {
+    for (pos = 0; pos < ARRAYLEN(osdCharacterGridBuffer);) {
         next = BITARRAY_FIND_FIRST_SET(screenIsDirty, pos);
         if (next < 0) {
             // No more dirty chars.
@@ -513,6 +546,35 @@ static bool max7456DrawScreenPartial(void)
 
         charMode = MODE_BYTE(osdCharacterGridBuffer[pos]);
         uint8_t chr = CHAR_BYTE(osdCharacterGridBuffer[pos]);
+
+        size_t available = sizeof(spiBuff) - bufPtr;
+        unsigned runLength = 0;
+        if (available > BYTES_PER_RUN) {
+            runLength = max7456DirtyRunLength(pos, available - BYTES_PER_RUN);
+        }
+
+        if (runLength >= MIN_RUN_LENGTH) {
+            state.registers.dmm = (state.registers.dmm & ~(DMM_8BIT_MODE | DMM_CHAR_MODE_MASK)) | charMode;
+
+            bufPtr = max7456PrepareBuffer(spiBuff, sizeof(spiBuff), bufPtr, MAX7456ADD_DMAH, ph);
+            bufPtr = max7456PrepareBuffer(spiBuff, sizeof(spiBuff), bufPtr, MAX7456ADD_DMAL, pl);
+            // Writing DMM also sets the attributes for the whole run
+            bufPtr = max7456PrepareBuffer(spiBuff, sizeof(spiBuff), bufPtr, MAX7456ADD_DMM, state.registers.dmm | DMM_AUTOINCREMENT);
+            // In auto-increment mode the chip takes data bytes only,
+            // until END_STRING clears DMM_AUTOINCREMENT.
+            for (unsigned ii = 0; ii < runLength; ii++, pos++) {
+                spiBuff[bufPtr++] = CHAR_BYTE(osdCharacterGridBuffer[pos]);
+                bitArrayClr(screenIsDirty, pos);
+            }
+            spiBuff[bufPtr++] = END_STRING;
+            continue;
+        }
+
+        if (available < (CHAR_MODE_IS_EXT(charMode) ? BYTES_PER_EXT_CHAR : BYTES_PER_CHAR)) {
+            // No room left, continue on the next call
+            break;
+        }
+
         if (CHAR_MODE_IS_EXT(charMode)) {
             if (!DMM_IS_8BIT_MODE(state.registers.dmm)) {
                 state.registers.dmm |= DMM_8BIT_MODE;
@@ -548,9 +610,6 @@ static bool max7456DrawScreenPartial(void)
         }
 
         bitArrayClr(screenIsDirty, pos);
-        if (++updatedCharCount == MAX_CHARS2UPDATE) {
-            break;
-        }
         // Start next search at next bit
         pos++;
     }
@@ -17,9 +17,14 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "platform.h"
 
+#include "build/debug.h"
+
+#include "common/maths.h"
+
 #include "serial.h"
 
 void serialPrint(serialPort_t *instance, const char *str)
@@ -119,3 +124,68 @@ bool serialIsIdle(serialPort_t *instance)
     else
         return false;
 }
+
+/*
+ * Switches the port to one callback per burst of bytes instead of one per
+ * byte. Returns false if the driver can't do it, the byte callback passed
+ * to openSerialPort() stays in use then.
+ */
+bool serialSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    if (instance->vTable->setRxFrameCallback) {
+        return instance->vTable->setRxFrameCallback(instance, callback);
+    }
+
+    return false;
+}
+
+// Bytes of wrapped bursts which didn't fit after the DMA area, and the
+// number of such bursts, for DEBUG_SERIAL_RX_DMA
+static uint32_t rxFrameDmaDroppedBytes;
+static uint32_t rxFrameDmaDroppedBursts;
+
+/*
+ * Passes what the DMA wrote since lastPos up to dmaPos, the position it
+ * writes next, on to the frame callback. Returns the new lastPos. Called
+ * from the idle line interrupt, so there's a single burst in between.
+ */
+uint32_t serialRxFrameDmaFlush(serialPort_t *instance, uint32_t lastPos, uint32_t dmaPos)
+{
+    const uint32_t dmaSize = serialRxFrameDmaSize(instance);
+    uint8_t *buffer = instance->rxBuffer.buffer;
+    uint32_t len;
+
+    if (dmaPos >= dmaSize) {
+        // NDTR reloads right after the last byte of the lap
+        dmaPos = 0;
+    }
+
+    if (dmaPos == lastPos) {
+        return dmaPos;
+    }
+
+    if (dmaPos > lastPos) {
+        len = dmaPos - lastPos;
+    } else {
+        // Wrapped around, move the start of the storage after its end. The
+        // DMA writes further ahead, so it doesn't touch what's copied.
+        const uint32_t wrapped = MIN(dmaPos, (uint32_t)SERIAL_RX_FRAME_SIZE_MAX);
+        memcpy(buffer + dmaSize, buffer, wrapped);
+
+        if (dmaPos > wrapped) {
+            // Longer than any frame, the line didn't go idle in between.
+            // The callback gets the start of the burst only.
+            rxFrameDmaDroppedBytes += dmaPos - wrapped;
+            rxFrameDmaDroppedBursts++;
+            DEBUG_SET(DEBUG_SERIAL_RX_DMA, 0, rxFrameDmaDroppedBytes);
+            DEBUG_SET(DEBUG_SERIAL_RX_DMA, 1, rxFrameDmaDroppedBursts);
+        }
+        len = dmaSize - lastPos + wrapped;
+    }
+
+    if (instance->rxFrameCallback) {
+        instance->rxFrameCallback(buffer + lastPos, len, instance->rxCallbackData);
+    }
+
+    return dmaPos;
+}
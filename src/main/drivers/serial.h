@@ -16,6 +16,9 @@
  */
 
 #pragma once
+
+#include "common/ring_buffer.h"
+
 #include "drivers/io.h"
 
 typedef struct {
@@ -53,6 +56,12 @@ typedef enum portOptions_t {
 } portOptions_t;
 
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
+// Bytes which arrived back to back until the line went idle, i.e. whole
+// frames for the RX protocols. Gets the same rxCallbackData.
+typedef void (*serialReceiveFrameCallbackPtr)(const uint8_t *data, uint16_t len, void *rxCallbackData);
+
+// Longest frame of the RX protocols which can take their input frame by frame
+#define SERIAL_RX_FRAME_SIZE_MAX 64
 
 typedef struct serialPort_s {
 
@@ -64,16 +73,13 @@ typedef struct serialPort_s {
 
     uint32_t baudRate;
 
-    uint32_t rxBufferSize;
-    uint32_t txBufferSize;
-    volatile uint8_t *rxBuffer;
-    volatile uint8_t *txBuffer;
-    uint32_t rxBufferHead;
-    uint32_t rxBufferTail;
-    uint32_t txBufferHead;
-    uint32_t txBufferTail;
+    // RX is filled by the driver and drained by serialRead(), TX the other
+    // way around. Ports which don't buffer (USB VCP) leave them unset.
+    ringBuffer_t rxBuffer;
+    ringBuffer_t txBuffer;
 
     serialReceiveCallbackPtr rxCallback;
+    serialReceiveFrameCallbackPtr rxFrameCallback;
     void *rxCallbackData;
 } serialPort_t;
 
@@ -101,6 +107,9 @@ struct serialPortVTable {
     // Optional functions used to buffer large writes.
     void (*beginWrite)(serialPort_t *instance);
     void (*endWrite)(serialPort_t *instance);
+
+    // Optional, see serialSetRxFrameCallback()
+    bool (*setRxFrameCallback)(serialPort_t *instance, serialReceiveFrameCallbackPtr callback);
 };
 
 void serialWrite(serialPort_t *instance, uint8_t ch);
@@ -115,8 +124,22 @@ void serialPrint(serialPort_t *instance, const char *str);
 uint32_t serialGetBaudRate(serialPort_t *instance);
 bool serialIsConnected(const serialPort_t *instance);
 bool serialIsIdle(serialPort_t *instance);
+bool serialSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback);
 
 // A shim that adapts the bufWriter API to the serialWriteBuf() API.
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
 void serialBeginWrite(serialPort_t *instance);
 void serialEndWrite(serialPort_t *instance);
+
+/*
+ * For drivers which receive frames with a circular DMA into the storage of
+ * the RX buffer and flush them when the line goes idle. The DMA only runs
+ * over the start of the storage, a frame which wraps around its end is
+ * completed in the SERIAL_RX_FRAME_SIZE_MAX bytes after it.
+ */
+static inline uint32_t serialRxFrameDmaSize(const serialPort_t *instance)
+{
+    return ringBufferSize(&instance->rxBuffer) - SERIAL_RX_FRAME_SIZE_MAX;
+}
+
+uint32_t serialRxFrameDmaFlush(serialPort_t *instance, uint32_t lastPos, uint32_t dmaPos);
@@ -73,8 +73,8 @@ typedef struct softSerial_s {
     timerCallbacks_t  tchCallbacks;
     timerCallbacks_t  exTchCallbacks;
 
-    volatile uint8_t rxBuffer[SOFTSERIAL_BUFFER_SIZE];
-    volatile uint8_t txBuffer[SOFTSERIAL_BUFFER_SIZE];
+    uint8_t rxBuffer[SOFTSERIAL_BUFFER_SIZE];
+    uint8_t txBuffer[SOFTSERIAL_BUFFER_SIZE];
 
     uint8_t          isSearchingForStartBit;
     uint8_t          rxBitIndex;
@@ -190,15 +190,8 @@ static void serialTimerConfigureTimebase(TCH_t * tch, uint32_t baud)
 
 static void resetBuffers(softSerial_t *softSerial)
 {
-    softSerial->port.rxBufferSize = SOFTSERIAL_BUFFER_SIZE;
-    softSerial->port.rxBuffer = softSerial->rxBuffer;
-    softSerial->port.rxBufferTail = 0;
-    softSerial->port.rxBufferHead = 0;
-
-    softSerial->port.txBuffer = softSerial->txBuffer;
-    softSerial->port.txBufferSize = SOFTSERIAL_BUFFER_SIZE;
-    softSerial->port.txBufferTail = 0;
-    softSerial->port.txBufferHead = 0;
+    ringBufferInit(&softSerial->port.rxBuffer, softSerial->rxBuffer, SOFTSERIAL_BUFFER_SIZE);
+    ringBufferInit(&softSerial->port.txBuffer, softSerial->txBuffer, SOFTSERIAL_BUFFER_SIZE);
 }
 
 serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baud, portMode_t mode, portOptions_t options)
@@ -354,7 +347,8 @@ void processTxState(softSerial_t *softSerial)
     uint8_t mask;
 
     if (!softSerial->isTransmittingData) {
-        if (isSoftSerialTransmitBufferEmpty((serialPort_t *)softSerial)) {
+        uint8_t byteToSend;
+        if (!ringBufferGet(&softSerial->port.txBuffer, &byteToSend)) {
             // Transmit buffer empty.
             // Start listening if not already in if half-duplex
             if (!softSerial->rxActive && softSerial->port.options & SERIAL_BIDIR) {
@@ -364,12 +358,6 @@ void processTxState(softSerial_t *softSerial)
             return;
         }
 
-        // data to send
-        uint8_t byteToSend = softSerial->port.txBuffer[softSerial->port.txBufferTail++];
-        if (softSerial->port.txBufferTail >= softSerial->port.txBufferSize) {
-            softSerial->port.txBufferTail = 0;
-        }
-
         // build internal buffer, MSB = Stop Bit (1) + data bits (MSB to LSB) + start bit(0) LSB
         softSerial->internalTxBuffer = (1 << (TX_TOTAL_BITS - 1)) | (byteToSend << 1);
         softSerial->bitsLeftToTransmit = TX_TOTAL_BITS;
@@ -445,8 +433,7 @@ void extractAndStoreRxByte(softSerial_t *softSerial)
     if (softSerial->port.rxCallback) {
         softSerial->port.rxCallback(rxByte, softSerial->port.rxCallbackData);
     } else {
-        softSerial->port.rxBuffer[softSerial->port.rxBufferHead] = rxByte;
-        softSerial->port.rxBufferHead = (softSerial->port.rxBufferHead + 1) % softSerial->port.rxBufferSize;
+        ringBufferPut(&softSerial->port.rxBuffer, rxByte);
     }
 }
 
@@ -559,9 +546,7 @@ uint32_t softSerialRxBytesWaiting(const serialPort_t *instance)
         return 0;
     }
 
-    softSerial_t *s = (softSerial_t *)instance;
-
-    return (s->port.rxBufferHead - s->port.rxBufferTail) & (s->port.rxBufferSize - 1);
+    return ringBufferCount(&instance->rxBuffer);
 }
 
 uint32_t softSerialTxBytesFree(const serialPort_t *instance)
@@ -570,27 +555,18 @@ uint32_t softSerialTxBytesFree(const serialPort_t *instance)
         return 0;
     }
 
-    softSerial_t *s = (softSerial_t *)instance;
-
-    uint32_t bytesUsed = (s->port.txBufferHead - s->port.txBufferTail) & (s->port.txBufferSize - 1);
-
-    return (s->port.txBufferSize - 1) - bytesUsed;
+    return ringBufferFree(&instance->txBuffer);
 }
 
 uint8_t softSerialReadByte(serialPort_t *instance)
 {
-    uint8_t ch;
+    uint8_t ch = 0;
 
     if ((instance->mode & MODE_RX) == 0) {
         return 0;
     }
 
-    if (softSerialRxBytesWaiting(instance) == 0) {
-        return 0;
-    }
-
-    ch = instance->rxBuffer[instance->rxBufferTail];
-    instance->rxBufferTail = (instance->rxBufferTail + 1) % instance->rxBufferSize;
+    ringBufferGet(&instance->rxBuffer, &ch);
     return ch;
 }
 
@@ -600,8 +576,7 @@ void softSerialWriteByte(serialPort_t *s, uint8_t ch)
         return;
     }
 
-    s->txBuffer[s->txBufferHead] = ch;
-    s->txBufferHead = (s->txBufferHead + 1) % s->txBufferSize;
+    ringBufferPut(&s->txBuffer, ch);
 }
 
 void softSerialSetBaudRate(serialPort_t *s, uint32_t baudRate)
@@ -620,7 +595,7 @@ void softSerialSetMode(serialPort_t *instance, portMode_t mode)
 
 bool isSoftSerialTransmitBufferEmpty(const serialPort_t *instance)
 {
-    return instance->txBufferHead == instance->txBufferTail;
+    return ringBufferIsEmpty(&instance->txBuffer);
 }
 
 static const struct serialPortVTable softSerialVTable = {
@@ -636,6 +611,7 @@ static const struct serialPortVTable softSerialVTable = {
     .beginWrite = NULL,
     .endWrite = NULL,
     .isIdle = NULL,
+    .setRxFrameCallback = NULL,
 };
 
 #endif
@@ -148,11 +148,18 @@ serialPort_t *uartOpen(USART_TypeDef *USARTx, serialReceiveCallbackPtr rxCallbac
     }
 
     // common serial initialisation code should move to serialPort::init()
-    s->port.rxBufferHead = s->port.rxBufferTail = 0;
-    s->port.txBufferHead = s->port.txBufferTail = 0;
+    ringBufferReset(&s->port.rxBuffer);
+    ringBufferReset(&s->port.txBuffer);
     // callback works for IRQ-based RX ONLY
     s->port.rxCallback = rxCallback;
     s->port.rxCallbackData = rxCallbackData;
+    s->port.rxFrameCallback = NULL;
+#ifdef USE_UART_RX_DMA
+    // Back to RXNE until the new user asks for frames again
+    if (s->rxDma) {
+        uartStopRxDMA(s);
+    }
+#endif
     s->port.mode = mode;
     s->port.baudRate = baudRate;
     s->port.options = options;
@@ -189,60 +196,30 @@ void uartSetMode(serialPort_t *instance, portMode_t mode)
 
 uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
 {
-    const uartPort_t *s = (const uartPort_t*)instance;
-
-    if (s->port.rxBufferHead >= s->port.rxBufferTail) {
-        return s->port.rxBufferHead - s->port.rxBufferTail;
-    } else {
-        return s->port.rxBufferSize + s->port.rxBufferHead - s->port.rxBufferTail;
-    }
+    return ringBufferCount(&instance->rxBuffer);
 }
 
 uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
 {
-    const uartPort_t *s = (const uartPort_t*)instance;
-
-    uint32_t bytesUsed;
-
-    if (s->port.txBufferHead >= s->port.txBufferTail) {
-        bytesUsed = s->port.txBufferHead - s->port.txBufferTail;
-    } else {
-        bytesUsed = s->port.txBufferSize + s->port.txBufferHead - s->port.txBufferTail;
-    }
-
-    return (s->port.txBufferSize - 1) - bytesUsed;
+    return ringBufferFree(&instance->txBuffer);
 }
 
 bool isUartTransmitBufferEmpty(const serialPort_t *instance)
 {
-    const uartPort_t *s = (const uartPort_t *)instance;
-    return s->port.txBufferTail == s->port.txBufferHead;
+    return ringBufferIsEmpty(&instance->txBuffer);
 }
 
 uint8_t uartRead(serialPort_t *instance)
 {
-    uint8_t ch;
-    uartPort_t *s = (uartPort_t *)instance;
-
-    ch = s->port.rxBuffer[s->port.rxBufferTail];
-    if (s->port.rxBufferTail + 1 >= s->port.rxBufferSize) {
-        s->port.rxBufferTail = 0;
-    } else {
-        s->port.rxBufferTail++;
-    }
-
+    uint8_t ch = 0;
+    ringBufferGet(&instance->rxBuffer, &ch);
     return ch;
 }
 
 void uartWrite(serialPort_t *instance, uint8_t ch)
 {
     uartPort_t *s = (uartPort_t *)instance;
-    s->port.txBuffer[s->port.txBufferHead] = ch;
-    if (s->port.txBufferHead + 1 >= s->port.txBufferSize) {
-        s->port.txBufferHead = 0;
-    } else {
-        s->port.txBufferHead++;
-    }
+    ringBufferPut(&s->port.txBuffer, ch);
 
     USART_ITConfig(s->USARTx, USART_IT_TXE, ENABLE);
 }
@@ -258,6 +235,25 @@ bool isUartIdle(serialPort_t *instance)
     }
 }
 
+#ifdef USE_UART_RX_DMA
+static bool uartSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+
+    if (!(s->port.mode & MODE_RX)) {
+        return false;
+    }
+
+    s->port.rxFrameCallback = callback;
+    if (!uartStartRxDMA(s)) {
+        s->port.rxFrameCallback = NULL;
+        return false;
+    }
+
+    return true;
+}
+#endif
+
 const struct serialPortVTable uartVTable[] = {
     {
         .serialWrite = uartWrite,
@@ -272,5 +268,8 @@ const struct serialPortVTable uartVTable[] = {
         .beginWrite = NULL,
         .endWrite = NULL,
         .isIdle = isUartIdle,
+#ifdef USE_UART_RX_DMA
+        .setRxFrameCallback = uartSetRxFrameCallback,
+#endif
     }
 };
@@ -17,6 +17,10 @@
 
 #pragma once
 
+#ifdef USE_UART_RX_DMA
+#include "drivers/dma.h"
+#endif
+
 #define UART_AF(uart, af) CONCAT3(GPIO_AF, af, _ ## uart)
 
 // Since serial ports can be used for any function these buffer sizes should be equal
@@ -61,6 +65,12 @@ typedef struct {
 #endif
 
     USART_TypeDef *USARTx;
+
+#ifdef USE_UART_RX_DMA
+    dmaTag_t rxDmaTag;
+    DMA_t rxDma;            // Claimed on the first switch to frame RX
+    uint32_t rxDmaPos;
+#endif
 } uartPort_t;
 
 void uartGetPortPins(UARTDevice_e device, serialPortPins_t * pins);
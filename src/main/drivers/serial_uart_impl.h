@@ -23,6 +23,12 @@ extern const struct serialPortVTable uartVTable[];
 
 void uartStartTxDMA(uartPort_t *s);
 
+#ifdef USE_UART_RX_DMA
+// Circular RX DMA with the idle line interrupt, for serialSetRxFrameCallback()
+bool uartStartRxDMA(uartPort_t *s);
+void uartStopRxDMA(uartPort_t *s);
+#endif
+
 uartPort_t *serialUART1(uint32_t baudRate, portMode_t mode, portOptions_t options);
 uartPort_t *serialUART2(uint32_t baudRate, portMode_t mode, portOptions_t options);
 uartPort_t *serialUART3(uint32_t baudRate, portMode_t mode, portOptions_t options);
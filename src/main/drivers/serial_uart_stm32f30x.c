@@ -171,18 +171,16 @@ uartPort_t *serialUART1(uint32_t baudRate, portMode_t mode, portOptions_t option
 {
     uartPort_t *s;
 
-    static volatile uint8_t rx1Buffer[UART1_RX_BUFFER_SIZE];
-    static volatile uint8_t tx1Buffer[UART1_TX_BUFFER_SIZE];
+    static uint8_t rx1Buffer[UART1_RX_BUFFER_SIZE];
+    static uint8_t tx1Buffer[UART1_TX_BUFFER_SIZE];
 
     s = &uartPort1;
     s->port.vTable = uartVTable;
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBuffer = rx1Buffer;
-    s->port.txBuffer = tx1Buffer;
-    s->port.rxBufferSize = UART1_RX_BUFFER_SIZE;
-    s->port.txBufferSize = UART1_TX_BUFFER_SIZE;
+    ringBufferInit(&s->port.rxBuffer, rx1Buffer, UART1_RX_BUFFER_SIZE);
+    ringBufferInit(&s->port.txBuffer, tx1Buffer, UART1_TX_BUFFER_SIZE);
 
     s->USARTx = USART1;
 
@@ -202,18 +200,16 @@ uartPort_t *serialUART2(uint32_t baudRate, portMode_t mode, portOptions_t option
 {
     uartPort_t *s;
 
-    static volatile uint8_t rx2Buffer[UART2_RX_BUFFER_SIZE];
-    static volatile uint8_t tx2Buffer[UART2_TX_BUFFER_SIZE];
+    static uint8_t rx2Buffer[UART2_RX_BUFFER_SIZE];
+    static uint8_t tx2Buffer[UART2_TX_BUFFER_SIZE];
 
     s = &uartPort2;
     s->port.vTable = uartVTable;
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBufferSize = UART2_RX_BUFFER_SIZE;
-    s->port.txBufferSize = UART2_TX_BUFFER_SIZE;
-    s->port.rxBuffer = rx2Buffer;
-    s->port.txBuffer = tx2Buffer;
+    ringBufferInit(&s->port.rxBuffer, rx2Buffer, UART2_RX_BUFFER_SIZE);
+    ringBufferInit(&s->port.txBuffer, tx2Buffer, UART2_TX_BUFFER_SIZE);
 
     s->USARTx = USART2;
 
@@ -233,18 +229,16 @@ uartPort_t *serialUART3(uint32_t baudRate, portMode_t mode, portOptions_t option
 {
     uartPort_t *s;
 
-    static volatile uint8_t rx3Buffer[UART3_RX_BUFFER_SIZE];
-    static volatile uint8_t tx3Buffer[UART3_TX_BUFFER_SIZE];
+    static uint8_t rx3Buffer[UART3_RX_BUFFER_SIZE];
+    static uint8_t tx3Buffer[UART3_TX_BUFFER_SIZE];
 
     s = &uartPort3;
     s->port.vTable = uartVTable;
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBufferSize = UART3_RX_BUFFER_SIZE;
-    s->port.txBufferSize = UART3_TX_BUFFER_SIZE;
-    s->port.rxBuffer = rx3Buffer;
-    s->port.txBuffer = tx3Buffer;
+    ringBufferInit(&s->port.rxBuffer, rx3Buffer, UART3_RX_BUFFER_SIZE);
+    ringBufferInit(&s->port.txBuffer, tx3Buffer, UART3_TX_BUFFER_SIZE);
 
     s->USARTx = USART3;
 
@@ -263,18 +257,16 @@ uartPort_t *serialUART3(uint32_t baudRate, portMode_t mode, portOptions_t option
 uartPort_t *serialUART4(uint32_t baudRate, portMode_t mode, portOptions_t options)
 {
     uartPort_t *s;
-    static volatile uint8_t rx4Buffer[UART4_RX_BUFFER_SIZE];
-    static volatile uint8_t tx4Buffer[UART4_TX_BUFFER_SIZE];
+    static uint8_t rx4Buffer[UART4_RX_BUFFER_SIZE];
+    static uint8_t tx4Buffer[UART4_TX_BUFFER_SIZE];
 
     s = &uartPort4;
     s->port.vTable = uartVTable;
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBufferSize = UART4_RX_BUFFER_SIZE;
-    s->port.txBufferSize = UART4_TX_BUFFER_SIZE;
-    s->port.rxBuffer = rx4Buffer;
-    s->port.txBuffer = tx4Buffer;
+    ringBufferInit(&s->port.rxBuffer, rx4Buffer, UART4_RX_BUFFER_SIZE);
+    ringBufferInit(&s->port.txBuffer, tx4Buffer, UART4_TX_BUFFER_SIZE);
 
     s->USARTx = UART4;
 
@@ -293,18 +285,16 @@ uartPort_t *serialUART4(uint32_t baudRate, portMode_t mode, portOptions_t option
 uartPort_t *serialUART5(uint32_t baudRate, portMode_t mode, portOptions_t options)
 {
     uartPort_t *s;
-    static volatile uint8_t rx5Buffer[UART5_RX_BUFFER_SIZE];
-    static volatile uint8_t tx5Buffer[UART5_TX_BUFFER_SIZE];
+    static uint8_t rx5Buffer[UART5_RX_BUFFER_SIZE];
+    static uint8_t tx5Buffer[UART5_TX_BUFFER_SIZE];
 
     s = &uartPort5;
     s->port.vTable = uartVTable;
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBufferSize = UART5_RX_BUFFER_SIZE;
-    s->port.txBufferSize = UART5_TX_BUFFER_SIZE;
-    s->port.rxBuffer = rx5Buffer;
-    s->port.txBuffer = tx5Buffer;
+    ringBufferInit(&s->port.rxBuffer, rx5Buffer, UART5_RX_BUFFER_SIZE);
+    ringBufferInit(&s->port.txBuffer, tx5Buffer, UART5_TX_BUFFER_SIZE);
 
     s->USARTx = UART5;
 
@@ -327,19 +317,14 @@ void usartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->RDR, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead++] = s->USARTx->RDR;
-            if (s->port.rxBufferHead >= s->port.rxBufferSize) {
-                s->port.rxBufferHead = 0;
-            }
+            ringBufferPut(&s->port.rxBuffer, s->USARTx->RDR);
         }
     }
 
     if (ISR & USART_FLAG_TXE) {
-        if (s->port.txBufferTail != s->port.txBufferHead) {
-            USART_SendData(s->USARTx, s->port.txBuffer[s->port.txBufferTail++]);
-            if (s->port.txBufferTail >= s->port.txBufferSize) {
-                s->port.txBufferTail = 0;
-            }
+        uint8_t ch;
+        if (ringBufferGet(&s->port.txBuffer, &ch)) {
+            USART_SendData(s->USARTx, ch);
         } else {
             USART_ITConfig(s->USARTx, USART_IT_TXE, DISABLE);
         }
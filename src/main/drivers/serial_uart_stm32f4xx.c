@@ -22,6 +22,7 @@
 
 #include "drivers/time.h"
 #include "drivers/io.h"
+#include "drivers/dma.h"
 #include "rcc.h"
 #include "drivers/nvic.h"
 
@@ -37,14 +38,17 @@ typedef struct uartDevice_s {
     uartPort_t port;
     ioTag_t rx;
     ioTag_t tx;
-    volatile uint8_t rxBuffer[UART_RX_BUFFER_SIZE];
-    volatile uint8_t txBuffer[UART_TX_BUFFER_SIZE];
+    uint8_t rxBuffer[UART_RX_BUFFER_SIZE];
+    uint8_t txBuffer[UART_TX_BUFFER_SIZE];
     uint32_t rcc_ahb1;
     rccPeriphTag_t rcc_apb2;
     rccPeriphTag_t rcc_apb1;
     uint8_t af;
     uint8_t irq;
     uint32_t irqPriority;
+#ifdef USE_UART_RX_DMA
+    dmaTag_t rxDma;
+#endif
 } uartDevice_t;
 
 //static uartPort_t uartPort[MAX_UARTS];
@@ -60,7 +64,10 @@ static uartDevice_t uart1 =
 #endif
     .rcc_apb2 = RCC_APB2(USART1),
     .irq = USART1_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART1_RX_DMA)
+    .rxDma = UART1_RX_DMA,
+#endif
 };
 #endif
 
@@ -76,7 +83,10 @@ static uartDevice_t uart2 =
 #endif
     .rcc_apb1 = RCC_APB1(USART2),
     .irq = USART2_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART2_RX_DMA)
+    .rxDma = UART2_RX_DMA,
+#endif
 };
 #endif
 
@@ -92,7 +102,10 @@ static uartDevice_t uart3 =
 #endif
     .rcc_apb1 = RCC_APB1(USART3),
     .irq = USART3_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART3_RX_DMA)
+    .rxDma = UART3_RX_DMA,
+#endif
 };
 #endif
 
@@ -108,7 +121,10 @@ static uartDevice_t uart4 =
 #endif
     .rcc_apb1 = RCC_APB1(UART4),
     .irq = UART4_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART4_RX_DMA)
+    .rxDma = UART4_RX_DMA,
+#endif
 };
 #endif
 
@@ -124,7 +140,10 @@ static uartDevice_t uart5 =
 #endif
     .rcc_apb1 = RCC_APB1(UART5),
     .irq = UART5_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART5_RX_DMA)
+    .rxDma = UART5_RX_DMA,
+#endif
 };
 #endif
 
@@ -140,7 +159,10 @@ static uartDevice_t uart6 =
 #endif
     .rcc_apb2 = RCC_APB2(USART6),
     .irq = USART6_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART6_RX_DMA)
+    .rxDma = UART6_RX_DMA,
+#endif
 };
 #endif
 
@@ -153,7 +175,10 @@ static uartDevice_t uart7 =
     .af = GPIO_AF_UART7,
     .rcc_apb1 = RCC_APB1(UART7),
     .irq = UART7_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART7_RX_DMA)
+    .rxDma = UART7_RX_DMA,
+#endif
 };
 #endif
 
@@ -166,7 +191,10 @@ static uartDevice_t uart8 =
     .af = GPIO_AF_UART8,
     .rcc_apb1 = RCC_APB1(UART8),
     .irq = UART8_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART8_RX_DMA)
+    .rxDma = UART8_RX_DMA,
+#endif
 };
 #endif
 
@@ -219,26 +247,87 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(s->USARTx->DR, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead] = s->USARTx->DR;
-            s->port.rxBufferHead = (s->port.rxBufferHead + 1) % s->port.rxBufferSize;
+            // Dropped when the buffer is full, DR still has to be read
+            ringBufferPut(&s->port.rxBuffer, s->USARTx->DR);
         }
     }
 
     if (USART_GetITStatus(s->USARTx, USART_IT_TXE) == SET) {
-        if (s->port.txBufferTail != s->port.txBufferHead) {
-            USART_SendData(s->USARTx, s->port.txBuffer[s->port.txBufferTail]);
-            s->port.txBufferTail = (s->port.txBufferTail + 1) % s->port.txBufferSize;
+        uint8_t ch;
+        if (ringBufferGet(&s->port.txBuffer, &ch)) {
+            USART_SendData(s->USARTx, ch);
         } else {
             USART_ITConfig(s->USARTx, USART_IT_TXE, DISABLE);
         }
     }
 
+#ifdef USE_UART_RX_DMA
+    // Only enabled while the DMA receives, the frame ended here
+    if (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET) {
+        uartClearIdleFlag(s);
+        s->rxDmaPos = serialRxFrameDmaFlush(&s->port, s->rxDmaPos, serialRxFrameDmaSize(&s->port) - DMA_GetCurrDataCounter(s->rxDma->ref));
+    }
+#endif
+
     if (USART_GetITStatus(s->USARTx, USART_FLAG_ORE) == SET)
     {
         USART_ClearITPendingBit (s->USARTx, USART_IT_ORE);
     }
 }
 
+#ifdef USE_UART_RX_DMA
+bool uartStartRxDMA(uartPort_t *s)
+{
+    DMA_t dma = dmaGetByTag(s->rxDmaTag);
+
+    // The stream can be shared with a timer or SPI on the target
+    if (!dma || (dma != s->rxDma && dmaGetOwner(dma) != OWNER_FREE)) {
+        return false;
+    }
+
+    dmaInit(dma, OWNER_SERIAL, 0);
+    s->rxDma = dma;
+    s->rxDmaPos = 0;
+
+    USART_ITConfig(s->USARTx, USART_IT_RXNE, DISABLE);
+
+    DMA_Cmd(dma->ref, DISABLE);
+    DMA_DeInit(dma->ref);
+
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_StructInit(&DMA_InitStructure);
+
+    DMA_InitStructure.DMA_Channel = dmaGetChannelByTag(s->rxDmaTag);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&s->USARTx->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)s->port.rxBuffer.buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = serialRxFrameDmaSize(&s->port);
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+
+    DMA_Init(dma->ref, &DMA_InitStructure);
+
+    USART_DMACmd(s->USARTx, USART_DMAReq_Rx, ENABLE);
+    DMA_Cmd(dma->ref, ENABLE);
+
+    uartClearIdleFlag(s);
+    USART_ITConfig(s->USARTx, USART_IT_IDLE, ENABLE);
+
+    return true;
+}
+
+void uartStopRxDMA(uartPort_t *s)
+{
+    USART_ITConfig(s->USARTx, USART_IT_IDLE, DISABLE);
+    USART_DMACmd(s->USARTx, USART_DMAReq_Rx, DISABLE);
+    DMA_Cmd(s->rxDma->ref, DISABLE);
+}
+#endif
+
 void uartGetPortPins(UARTDevice_e device, serialPortPins_t * pins)
 {
     uartDevice_t *uart = uartHardwareMap[device];
@@ -271,12 +360,13 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_t mode,
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBuffer = uart->rxBuffer;
-    s->port.txBuffer = uart->txBuffer;
-    s->port.rxBufferSize = sizeof(uart->rxBuffer);
-    s->port.txBufferSize = sizeof(uart->txBuffer);
+    ringBufferInit(&s->port.rxBuffer, uart->rxBuffer, sizeof(uart->rxBuffer));
+    ringBufferInit(&s->port.txBuffer, uart->txBuffer, sizeof(uart->txBuffer));
 
     s->USARTx = uart->dev;
+#ifdef USE_UART_RX_DMA
+    s->rxDmaTag = uart->rxDma;
+#endif
 
     IO_t tx = IOGetByTag(uart->tx);
     IO_t rx = IOGetByTag(uart->rx);
@@ -22,6 +22,7 @@
 
 #include "drivers/time.h"
 #include "drivers/io.h"
+#include "drivers/dma.h"
 #include "rcc.h"
 #include "drivers/nvic.h"
 
@@ -37,14 +38,17 @@ typedef struct uartDevice_s {
     uartPort_t port;
     ioTag_t rx;
     ioTag_t tx;
-    volatile uint8_t rxBuffer[UART_RX_BUFFER_SIZE];
-    volatile uint8_t txBuffer[UART_TX_BUFFER_SIZE];
+    uint8_t rxBuffer[UART_RX_BUFFER_SIZE];
+    uint8_t txBuffer[UART_TX_BUFFER_SIZE];
     uint32_t rcc_ahb1;
     rccPeriphTag_t rcc_apb2;
     rccPeriphTag_t rcc_apb1;
     uint8_t af;
     uint8_t irq;
     uint32_t irqPriority;
+#ifdef USE_UART_RX_DMA
+    dmaTag_t rxDma;
+#endif
 } uartDevice_t;
 
 #ifdef USE_UART1
@@ -63,7 +67,10 @@ static uartDevice_t uart1 =
 #endif
     .rcc_apb2 = RCC_APB2(USART1),
     .irq = USART1_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART1_RX_DMA)
+    .rxDma = UART1_RX_DMA,
+#endif
 };
 #endif
 
@@ -83,7 +90,10 @@ static uartDevice_t uart2 =
 #endif
     .rcc_apb1 = RCC_APB1(USART2),
     .irq = USART2_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART2_RX_DMA)
+    .rxDma = UART2_RX_DMA,
+#endif
 };
 #endif
 
@@ -103,7 +113,10 @@ static uartDevice_t uart3 =
 #endif
     .rcc_apb1 = RCC_APB1(USART3),
     .irq = USART3_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART3_RX_DMA)
+    .rxDma = UART3_RX_DMA,
+#endif
 };
 #endif
 
@@ -123,7 +136,10 @@ static uartDevice_t uart4 =
 #endif
     .rcc_apb1 = RCC_APB1(UART4),
     .irq = UART4_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART4_RX_DMA)
+    .rxDma = UART4_RX_DMA,
+#endif
 };
 #endif
 
@@ -143,7 +159,10 @@ static uartDevice_t uart5 =
 #endif
     .rcc_apb1 = RCC_APB1(UART5),
     .irq = UART5_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART5_RX_DMA)
+    .rxDma = UART5_RX_DMA,
+#endif
 };
 #endif
 
@@ -163,7 +182,10 @@ static uartDevice_t uart6 =
 #endif
     .rcc_apb2 = RCC_APB2(USART6),
     .irq = USART6_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART6_RX_DMA)
+    .rxDma = UART6_RX_DMA,
+#endif
 };
 #endif
 
@@ -183,7 +205,10 @@ static uartDevice_t uart7 =
 #endif
     .rcc_apb1 = RCC_APB1(UART7),
     .irq = UART7_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART7_RX_DMA)
+    .rxDma = UART7_RX_DMA,
+#endif
 };
 #endif
 #ifdef USE_UART8
@@ -202,7 +227,10 @@ static uartDevice_t uart8 =
 #endif
     .rcc_apb1 = RCC_APB1(UART8),
     .irq = UART8_IRQn,
-    .irqPriority = NVIC_PRIO_SERIALUART
+    .irqPriority = NVIC_PRIO_SERIALUART,
+#if defined(USE_UART_RX_DMA) && defined(UART8_RX_DMA)
+    .rxDma = UART8_RX_DMA,
+#endif
 };
 #endif
 
@@ -261,8 +289,7 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(rbyte, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead] = rbyte;
-            s->port.rxBufferHead = (s->port.rxBufferHead + 1) % s->port.rxBufferSize;
+            ringBufferPut(&s->port.rxBuffer, rbyte);
         }
         CLEAR_BIT(huart->Instance->CR1, (USART_CR1_PEIE));
 
@@ -296,27 +323,95 @@ void uartIrqHandler(uartPort_t *s)
     if (__HAL_UART_GET_IT(huart, UART_IT_TXE) != RESET) {
         /* Check that a Tx process is ongoing */
         if (huart->gState != HAL_UART_STATE_BUSY_TX) {
-            if (s->port.txBufferTail == s->port.txBufferHead) {
+            uint8_t ch;
+            if (!ringBufferGet(&s->port.txBuffer, &ch)) {
                 huart->TxXferCount = 0;
                 /* Disable the UART Transmit Data Register Empty Interrupt */
                 CLEAR_BIT(huart->Instance->CR1, USART_CR1_TXEIE);
             } else {
                 if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE)) {
-                    huart->Instance->TDR = (((uint16_t) s->port.txBuffer[s->port.txBufferTail]) & (uint16_t) 0x01FFU);
+                    huart->Instance->TDR = (((uint16_t) ch) & (uint16_t) 0x01FFU);
                 } else {
-                    huart->Instance->TDR = (uint8_t)(s->port.txBuffer[s->port.txBufferTail]);
+                    huart->Instance->TDR = ch;
                 }
-                s->port.txBufferTail = (s->port.txBufferTail + 1) % s->port.txBufferSize;
             }
         }
     }
 
+#ifdef USE_UART_RX_DMA
+    // The flag is also polled by isUartIdle(), only take it while the DMA receives
+    if (READ_BIT(huart->Instance->CR1, USART_CR1_IDLEIE) && (__HAL_UART_GET_IT(huart, UART_IT_IDLE) != RESET)) {
+        __HAL_UART_CLEAR_IDLEFLAG(huart);
+        s->rxDmaPos = serialRxFrameDmaFlush(&s->port, s->rxDmaPos, serialRxFrameDmaSize(&s->port) - s->rxDma->ref->NDTR);
+    }
+#endif
+
     /* UART in mode Transmitter (transmission end) -----------------------------*/
     if ((__HAL_UART_GET_IT(huart, UART_IT_TC) != RESET)) {
         HAL_UART_IRQHandler(huart);
     }
 }
 
+#ifdef USE_UART_RX_DMA
+static const uint32_t lookupDMALLStreamTable[] = { LL_DMA_STREAM_0, LL_DMA_STREAM_1, LL_DMA_STREAM_2, LL_DMA_STREAM_3, LL_DMA_STREAM_4, LL_DMA_STREAM_5, LL_DMA_STREAM_6, LL_DMA_STREAM_7 };
+static const uint32_t lookupDMALLChannelTable[] = { LL_DMA_CHANNEL_0, LL_DMA_CHANNEL_1, LL_DMA_CHANNEL_2, LL_DMA_CHANNEL_3, LL_DMA_CHANNEL_4, LL_DMA_CHANNEL_5, LL_DMA_CHANNEL_6, LL_DMA_CHANNEL_7 };
+
+bool uartStartRxDMA(uartPort_t *s)
+{
+    DMA_t dma = dmaGetByTag(s->rxDmaTag);
+
+    // The stream can be shared with a timer or SPI on the target
+    if (!dma || (dma != s->rxDma && dmaGetOwner(dma) != OWNER_FREE)) {
+        return false;
+    }
+
+    dmaInit(dma, OWNER_SERIAL, 0);
+    s->rxDma = dma;
+    s->rxDmaPos = 0;
+
+    CLEAR_BIT(s->USARTx->CR1, USART_CR1_RXNEIE);
+
+    const uint32_t streamLL = lookupDMALLStreamTable[DMATAG_GET_STREAM(s->rxDmaTag)];
+
+    LL_DMA_DisableStream(dma->dma, streamLL);
+    LL_DMA_DeInit(dma->dma, streamLL);
+
+    LL_DMA_InitTypeDef init;
+    LL_DMA_StructInit(&init);
+
+    init.Channel = lookupDMALLChannelTable[DMATAG_GET_CHANNEL(s->rxDmaTag)];
+    init.PeriphOrM2MSrcAddress = (uint32_t)&s->USARTx->RDR;
+    init.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    init.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+    init.MemoryOrM2MDstAddress = (uint32_t)s->port.rxBuffer.buffer;
+    init.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    init.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+    init.NbData = serialRxFrameDmaSize(&s->port);
+    init.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    init.Mode = LL_DMA_MODE_CIRCULAR;
+    init.Priority = LL_DMA_PRIORITY_MEDIUM;
+    // Direct mode, with the FIFO the last bytes would still be in flight at the idle interrupt
+    init.FIFOMode = LL_DMA_FIFOMODE_DISABLE;
+
+    LL_DMA_Init(dma->dma, streamLL, &init);
+
+    SET_BIT(s->USARTx->CR3, USART_CR3_DMAR);
+    LL_DMA_EnableStream(dma->dma, streamLL);
+
+    __HAL_UART_CLEAR_IDLEFLAG(&s->Handle);
+    SET_BIT(s->USARTx->CR1, USART_CR1_IDLEIE);
+
+    return true;
+}
+
+void uartStopRxDMA(uartPort_t *s)
+{
+    CLEAR_BIT(s->USARTx->CR1, USART_CR1_IDLEIE);
+    CLEAR_BIT(s->USARTx->CR3, USART_CR3_DMAR);
+    LL_DMA_DisableStream(s->rxDma->dma, lookupDMALLStreamTable[DMATAG_GET_STREAM(s->rxDmaTag)]);
+}
+#endif
+
 void uartGetPortPins(UARTDevice_e device, serialPortPins_t * pins)
 {
     uartDevice_t *uart = uartHardwareMap[device];
@@ -343,12 +438,13 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_t mode,
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBuffer = uart->rxBuffer;
-    s->port.txBuffer = uart->txBuffer;
-    s->port.rxBufferSize = sizeof(uart->rxBuffer);
-    s->port.txBufferSize = sizeof(uart->txBuffer);
+    ringBufferInit(&s->port.rxBuffer, uart->rxBuffer, sizeof(uart->rxBuffer));
+    ringBufferInit(&s->port.txBuffer, uart->txBuffer, sizeof(uart->txBuffer));
 
     s->USARTx = uart->dev;
+#ifdef USE_UART_RX_DMA
+    s->rxDmaTag = uart->rxDma;
+#endif
 
     s->Handle.Instance = uart->dev;
 
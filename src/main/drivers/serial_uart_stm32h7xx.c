@@ -37,8 +37,8 @@ typedef struct uartDevice_s {
     uartPort_t port;
     ioTag_t rx;
     ioTag_t tx;
-    volatile uint8_t rxBuffer[UART_RX_BUFFER_SIZE];
-    volatile uint8_t txBuffer[UART_TX_BUFFER_SIZE];
+    uint8_t rxBuffer[UART_RX_BUFFER_SIZE];
+    uint8_t txBuffer[UART_TX_BUFFER_SIZE];
     rccPeriphTag_t rcc;
     uint8_t af_rx;
     uint8_t af_tx;
@@ -258,8 +258,7 @@ void uartIrqHandler(uartPort_t *s)
         if (s->port.rxCallback) {
             s->port.rxCallback(rbyte, s->port.rxCallbackData);
         } else {
-            s->port.rxBuffer[s->port.rxBufferHead] = rbyte;
-            s->port.rxBufferHead = (s->port.rxBufferHead + 1) % s->port.rxBufferSize;
+            ringBufferPut(&s->port.rxBuffer, rbyte);
         }
         CLEAR_BIT(huart->Instance->CR1, (USART_CR1_PEIE));
 
@@ -293,17 +292,17 @@ void uartIrqHandler(uartPort_t *s)
     if (__HAL_UART_GET_IT(huart, UART_IT_TXE) != RESET) {
         /* Check that a Tx process is ongoing */
         if (huart->gState != HAL_UART_STATE_BUSY_TX) {
-            if (s->port.txBufferTail == s->port.txBufferHead) {
+            uint8_t ch;
+            if (!ringBufferGet(&s->port.txBuffer, &ch)) {
                 huart->TxXferCount = 0;
                 /* Disable the UART Transmit Data Register Empty Interrupt */
                 CLEAR_BIT(huart->Instance->CR1, USART_CR1_TXEIE);
             } else {
                 if ((huart->Init.WordLength == UART_WORDLENGTH_9B) && (huart->Init.Parity == UART_PARITY_NONE)) {
-                    huart->Instance->TDR = (((uint16_t) s->port.txBuffer[s->port.txBufferTail]) & (uint16_t) 0x01FFU);
+                    huart->Instance->TDR = (((uint16_t) ch) & (uint16_t) 0x01FFU);
                 } else {
-                    huart->Instance->TDR = (uint8_t)(s->port.txBuffer[s->port.txBufferTail]);
+                    huart->Instance->TDR = ch;
                 }
-                s->port.txBufferTail = (s->port.txBufferTail + 1) % s->port.txBufferSize;
             }
         }
     }
@@ -326,10 +325,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_t mode,
 
     s->port.baudRate = baudRate;
 
-    s->port.rxBuffer = uart->rxBuffer;
-    s->port.txBuffer = uart->txBuffer;
-    s->port.rxBufferSize = sizeof(uart->rxBuffer);
-    s->port.txBufferSize = sizeof(uart->txBuffer);
+    ringBufferInit(&s->port.rxBuffer, uart->rxBuffer, sizeof(uart->rxBuffer));
+    ringBufferInit(&s->port.txBuffer, uart->txBuffer, sizeof(uart->txBuffer));
 
     s->USARTx = uart->dev;
 
@@ -84,6 +84,8 @@
     #include "timer_def_stm32f7xx.h"
 #elif defined(STM32H7)
     #include "timer_def_stm32h7xx.h"
+#elif defined(SITL_BUILD)
+    // No hardware timers, outputs are handled by target/SITL
 #else
     #error "Unknown CPU defined"
 #endif
@@ -88,6 +88,7 @@ bool cliMode = false;
 
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
+#include "io/displayport_msp.h"
 #include "io/flashfs.h"
 #include "io/gps.h"
 #include "io/ledstrip.h"
@@ -137,6 +138,7 @@ static serialPort_t *cliPort;
 
 static bufWriter_t *cliWriter;
 static uint8_t cliWriteBuffer[sizeof(*cliWriter) + 128];
+static uint32_t cliWriteCount;
 
 static char cliBuffer[64];
 static uint32_t bufferIndex = 0;
@@ -161,10 +163,14 @@ static const char * const featureNames[] = {
     "OSD", "FW_LAUNCH", "FW_AUTOTRIM", NULL
 };
 
+#define FEATURE_NAME_COUNT (ARRAYLEN(featureNames) - 1)
+
 #ifdef USE_BLACKBOX
 static const char * const blackboxIncludeFlagNames[] = {
     "NAV_ACC", "NAV_POS", "NAV_PID", "MAG", "ACC", "ATTI", "RC_DATA", "RC_COMMAND", "MOTORS", NULL
 };
+
+#define BLACKBOX_INCLUDE_FLAG_NAME_COUNT (ARRAYLEN(blackboxIncludeFlagNames) - 1)
 #endif
 
 /* Sensor names (used in lookup tables for *_hardware settings and in status command output) */
@@ -278,6 +284,13 @@ typedef enum {
     HIDE_UNUSED = (1 << 7)
 } dumpFlags_e;
 
+static void cliWriteBuf(void *instance, void *data, int count)
+{
+    // Counted to pace the config dumps
+    cliWriteCount += count;
+    serialWriteBuf(instance, data, count);
+}
+
 static void cliPrintfva(const char *format, va_list va)
 {
     tfp_format(cliWriter, cliPutp, format, va);
@@ -464,18 +477,11 @@ static bool valuePtrEqualsDefault(const setting_t *value, const void *ptr, const
     return result;
 }
 
-static void dumpPgValue(const setting_t *value, uint8_t dumpMask)
+static void dumpPgValue(const setting_t *value, const void *valuePointer, const void *defaultValuePointer, uint8_t dumpMask)
 {
     char name[SETTING_MAX_NAME_LENGTH];
     const char *format = "set %s = ";
     const char *defaultFormat = "#set %s = ";
-    // During a dump, the PGs have been backed up to their "copy"
-    // regions and the actual values have been reset to its
-    // defaults. This means that settingGetValuePointer() will
-    // return the default value while settingGetCopyValuePointer()
-    // will return the actual value.
-    const void *valuePointer = settingGetCopyValuePointer(value);
-    const void *defaultValuePointer = settingGetValuePointer(value);
     const bool equalsDefault = valuePtrEqualsDefault(value, valuePointer, defaultValuePointer);
     if (((dumpMask & DO_DIFF) == 0) || !equalsDefault) {
         settingGetName(value, name);
@@ -495,17 +501,6 @@ static void dumpPgValue(const setting_t *value, uint8_t dumpMask)
     }
 }
 
-static void dumpAllValues(uint16_t valueSection, uint8_t dumpMask)
-{
-    for (unsigned i = 0; i < SETTINGS_TABLE_COUNT; i++) {
-        const setting_t *value = settingGet(i);
-        bufWriterFlush(cliWriter);
-        if (SETTING_SECTION(value) == valueSection) {
-            dumpPgValue(value, dumpMask);
-        }
-    }
-}
-
 static void cliPrintVar(const setting_t *var, uint32_t full)
 {
     const void *ptr = settingGetValuePointer(var);
@@ -650,37 +645,42 @@ static void cliAssert(char *cmdline)
 }
 #endif
 
-static void printAux(uint8_t dumpMask, const modeActivationCondition_t *modeActivationConditions, const modeActivationCondition_t *defaultModeActivationConditions)
+static void printAuxItem(uint8_t dumpMask, const modeActivationCondition_t *modeActivationConditions, const modeActivationCondition_t *defaultModeActivationConditions, uint32_t i)
 {
     const char *format = "aux %u %u %u %u %u";
-    // print out aux channel settings
-    for (uint32_t i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
-        const modeActivationCondition_t *mac = &modeActivationConditions[i];
-        bool equalsDefault = false;
-        if (defaultModeActivationConditions) {
-            const modeActivationCondition_t *macDefault = &defaultModeActivationConditions[i];
-            equalsDefault = mac->modeId == macDefault->modeId
-                && mac->auxChannelIndex == macDefault->auxChannelIndex
-                && mac->range.startStep == macDefault->range.startStep
-                && mac->range.endStep == macDefault->range.endStep;
-            const box_t *box = findBoxByActiveBoxId(macDefault->modeId);
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                box->permanentId,
-                macDefault->auxChannelIndex,
-                MODE_STEP_TO_CHANNEL_VALUE(macDefault->range.startStep),
-                MODE_STEP_TO_CHANNEL_VALUE(macDefault->range.endStep)
-            );
-        }
-        const box_t *box = findBoxByActiveBoxId(mac->modeId);
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    const modeActivationCondition_t *mac = &modeActivationConditions[i];
+    bool equalsDefault = false;
+    if (defaultModeActivationConditions) {
+        const modeActivationCondition_t *macDefault = &defaultModeActivationConditions[i];
+        equalsDefault = mac->modeId == macDefault->modeId
+            && mac->auxChannelIndex == macDefault->auxChannelIndex
+            && mac->range.startStep == macDefault->range.startStep
+            && mac->range.endStep == macDefault->range.endStep;
+        const box_t *box = findBoxByActiveBoxId(macDefault->modeId);
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
             box->permanentId,
-            mac->auxChannelIndex,
-            MODE_STEP_TO_CHANNEL_VALUE(mac->range.startStep),
-            MODE_STEP_TO_CHANNEL_VALUE(mac->range.endStep)
+            macDefault->auxChannelIndex,
+            MODE_STEP_TO_CHANNEL_VALUE(macDefault->range.startStep),
+            MODE_STEP_TO_CHANNEL_VALUE(macDefault->range.endStep)
         );
     }
+    const box_t *box = findBoxByActiveBoxId(mac->modeId);
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        box->permanentId,
+        mac->auxChannelIndex,
+        MODE_STEP_TO_CHANNEL_VALUE(mac->range.startStep),
+        MODE_STEP_TO_CHANNEL_VALUE(mac->range.endStep)
+    );
+}
+
+static void printAux(uint8_t dumpMask, const modeActivationCondition_t *modeActivationConditions, const modeActivationCondition_t *defaultModeActivationConditions)
+{
+    // print out aux channel settings
+    for (uint32_t i = 0; i < MAX_MODE_ACTIVATION_CONDITION_COUNT; i++) {
+        printAuxItem(dumpMask, modeActivationConditions, defaultModeActivationConditions, i);
+    }
 }
 
 static void cliAux(char *cmdline)
@@ -726,38 +726,43 @@ static void cliAux(char *cmdline)
     }
 }
 
-static void printSerial(uint8_t dumpMask, const serialConfig_t *serialConfig, const serialConfig_t *serialConfigDefault)
+static void printSerialItem(uint8_t dumpMask, const serialConfig_t *serialConfig, const serialConfig_t *serialConfigDefault, uint32_t i)
 {
     const char *format = "serial %d %d %ld %ld %ld %ld";
+    if (!serialIsPortAvailable(serialConfig->portConfigs[i].identifier)) {
+        return;
+    };
+    bool equalsDefault = false;
+    if (serialConfigDefault) {
+        equalsDefault = serialConfig->portConfigs[i].identifier == serialConfigDefault->portConfigs[i].identifier
+            && serialConfig->portConfigs[i].functionMask == serialConfigDefault->portConfigs[i].functionMask
+            && serialConfig->portConfigs[i].msp_baudrateIndex == serialConfigDefault->portConfigs[i].msp_baudrateIndex
+            && serialConfig->portConfigs[i].gps_baudrateIndex == serialConfigDefault->portConfigs[i].gps_baudrateIndex
+            && serialConfig->portConfigs[i].telemetry_baudrateIndex == serialConfigDefault->portConfigs[i].telemetry_baudrateIndex
+            && serialConfig->portConfigs[i].peripheral_baudrateIndex == serialConfigDefault->portConfigs[i].peripheral_baudrateIndex;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
+            serialConfigDefault->portConfigs[i].identifier,
+            serialConfigDefault->portConfigs[i].functionMask,
+            baudRates[serialConfigDefault->portConfigs[i].msp_baudrateIndex],
+            baudRates[serialConfigDefault->portConfigs[i].gps_baudrateIndex],
+            baudRates[serialConfigDefault->portConfigs[i].telemetry_baudrateIndex],
+            baudRates[serialConfigDefault->portConfigs[i].peripheral_baudrateIndex]
+        );
+    }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        serialConfig->portConfigs[i].identifier,
+        serialConfig->portConfigs[i].functionMask,
+        baudRates[serialConfig->portConfigs[i].msp_baudrateIndex],
+        baudRates[serialConfig->portConfigs[i].gps_baudrateIndex],
+        baudRates[serialConfig->portConfigs[i].telemetry_baudrateIndex],
+        baudRates[serialConfig->portConfigs[i].peripheral_baudrateIndex]
+        );
+}
+
+static void printSerial(uint8_t dumpMask, const serialConfig_t *serialConfig, const serialConfig_t *serialConfigDefault)
+{
     for (uint32_t i = 0; i < SERIAL_PORT_COUNT; i++) {
-        if (!serialIsPortAvailable(serialConfig->portConfigs[i].identifier)) {
-            continue;
-        };
-        bool equalsDefault = false;
-        if (serialConfigDefault) {
-            equalsDefault = serialConfig->portConfigs[i].identifier == serialConfigDefault->portConfigs[i].identifier
-                && serialConfig->portConfigs[i].functionMask == serialConfigDefault->portConfigs[i].functionMask
-                && serialConfig->portConfigs[i].msp_baudrateIndex == serialConfigDefault->portConfigs[i].msp_baudrateIndex
-                && serialConfig->portConfigs[i].gps_baudrateIndex == serialConfigDefault->portConfigs[i].gps_baudrateIndex
-                && serialConfig->portConfigs[i].telemetry_baudrateIndex == serialConfigDefault->portConfigs[i].telemetry_baudrateIndex
-                && serialConfig->portConfigs[i].peripheral_baudrateIndex == serialConfigDefault->portConfigs[i].peripheral_baudrateIndex;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                serialConfigDefault->portConfigs[i].identifier,
-                serialConfigDefault->portConfigs[i].functionMask,
-                baudRates[serialConfigDefault->portConfigs[i].msp_baudrateIndex],
-                baudRates[serialConfigDefault->portConfigs[i].gps_baudrateIndex],
-                baudRates[serialConfigDefault->portConfigs[i].telemetry_baudrateIndex],
-                baudRates[serialConfigDefault->portConfigs[i].peripheral_baudrateIndex]
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
-            serialConfig->portConfigs[i].identifier,
-            serialConfig->portConfigs[i].functionMask,
-            baudRates[serialConfig->portConfigs[i].msp_baudrateIndex],
-            baudRates[serialConfig->portConfigs[i].gps_baudrateIndex],
-            baudRates[serialConfig->portConfigs[i].telemetry_baudrateIndex],
-            baudRates[serialConfig->portConfigs[i].peripheral_baudrateIndex]
-            );
+        printSerialItem(dumpMask, serialConfig, serialConfigDefault, i);
     }
 }
 
@@ -929,41 +934,46 @@ static void cliSerialPassthrough(char *cmdline)
 }
 #endif
 
-static void printAdjustmentRange(uint8_t dumpMask, const adjustmentRange_t *adjustmentRanges, const adjustmentRange_t *defaultAdjustmentRanges)
+static void printAdjustmentRangeItem(uint8_t dumpMask, const adjustmentRange_t *adjustmentRanges, const adjustmentRange_t *defaultAdjustmentRanges, uint32_t i)
 {
     const char *format = "adjrange %u %u %u %u %u %u %u";
-    // print out adjustment ranges channel settings
-    for (uint32_t i = 0; i < MAX_ADJUSTMENT_RANGE_COUNT; i++) {
-        const adjustmentRange_t *ar = &adjustmentRanges[i];
-        bool equalsDefault = false;
-        if (defaultAdjustmentRanges) {
-            const adjustmentRange_t *arDefault = &defaultAdjustmentRanges[i];
-            equalsDefault = ar->auxChannelIndex == arDefault->auxChannelIndex
-                && ar->range.startStep == arDefault->range.startStep
-                && ar->range.endStep == arDefault->range.endStep
-                && ar->adjustmentFunction == arDefault->adjustmentFunction
-                && ar->auxSwitchChannelIndex == arDefault->auxSwitchChannelIndex
-                && ar->adjustmentIndex == arDefault->adjustmentIndex;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                arDefault->adjustmentIndex,
-                arDefault->auxChannelIndex,
-                MODE_STEP_TO_CHANNEL_VALUE(arDefault->range.startStep),
-                MODE_STEP_TO_CHANNEL_VALUE(arDefault->range.endStep),
-                arDefault->adjustmentFunction,
-                arDefault->auxSwitchChannelIndex
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    const adjustmentRange_t *ar = &adjustmentRanges[i];
+    bool equalsDefault = false;
+    if (defaultAdjustmentRanges) {
+        const adjustmentRange_t *arDefault = &defaultAdjustmentRanges[i];
+        equalsDefault = ar->auxChannelIndex == arDefault->auxChannelIndex
+            && ar->range.startStep == arDefault->range.startStep
+            && ar->range.endStep == arDefault->range.endStep
+            && ar->adjustmentFunction == arDefault->adjustmentFunction
+            && ar->auxSwitchChannelIndex == arDefault->auxSwitchChannelIndex
+            && ar->adjustmentIndex == arDefault->adjustmentIndex;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
-            ar->adjustmentIndex,
-            ar->auxChannelIndex,
-            MODE_STEP_TO_CHANNEL_VALUE(ar->range.startStep),
-            MODE_STEP_TO_CHANNEL_VALUE(ar->range.endStep),
-            ar->adjustmentFunction,
-            ar->auxSwitchChannelIndex
+            arDefault->adjustmentIndex,
+            arDefault->auxChannelIndex,
+            MODE_STEP_TO_CHANNEL_VALUE(arDefault->range.startStep),
+            MODE_STEP_TO_CHANNEL_VALUE(arDefault->range.endStep),
+            arDefault->adjustmentFunction,
+            arDefault->auxSwitchChannelIndex
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        ar->adjustmentIndex,
+        ar->auxChannelIndex,
+        MODE_STEP_TO_CHANNEL_VALUE(ar->range.startStep),
+        MODE_STEP_TO_CHANNEL_VALUE(ar->range.endStep),
+        ar->adjustmentFunction,
+        ar->auxSwitchChannelIndex
+    );
+}
+
+static void printAdjustmentRange(uint8_t dumpMask, const adjustmentRange_t *adjustmentRanges, const adjustmentRange_t *defaultAdjustmentRanges)
+{
+    // print out adjustment ranges channel settings
+    for (uint32_t i = 0; i < MAX_ADJUSTMENT_RANGE_COUNT; i++) {
+        printAdjustmentRangeItem(dumpMask, adjustmentRanges, defaultAdjustmentRanges, i);
+    }
 }
 
 static void cliAdjustmentRange(char *cmdline)
@@ -1026,41 +1036,46 @@ static void cliAdjustmentRange(char *cmdline)
     }
 }
 
-static void printMotorMix(uint8_t dumpMask, const motorMixer_t *primaryMotorMixer, const motorMixer_t *defaultprimaryMotorMixer)
+static void printMotorMixItem(uint8_t dumpMask, const motorMixer_t *primaryMotorMixer, const motorMixer_t *defaultprimaryMotorMixer, uint32_t i)
 {
     const char *format = "mmix %d %s %s %s %s";
     char buf0[FTOA_BUFFER_SIZE];
     char buf1[FTOA_BUFFER_SIZE];
     char buf2[FTOA_BUFFER_SIZE];
     char buf3[FTOA_BUFFER_SIZE];
+    const float thr = primaryMotorMixer[i].throttle;
+    const float roll = primaryMotorMixer[i].roll;
+    const float pitch = primaryMotorMixer[i].pitch;
+    const float yaw = primaryMotorMixer[i].yaw;
+    bool equalsDefault = false;
+    if (defaultprimaryMotorMixer) {
+        const float thrDefault = defaultprimaryMotorMixer[i].throttle;
+        const float rollDefault = defaultprimaryMotorMixer[i].roll;
+        const float pitchDefault = defaultprimaryMotorMixer[i].pitch;
+        const float yawDefault = defaultprimaryMotorMixer[i].yaw;
+        const bool equalsDefault = thr == thrDefault && roll == rollDefault && pitch == pitchDefault && yaw == yawDefault;
+
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
+            i,
+            ftoa(thrDefault, buf0),
+            ftoa(rollDefault, buf1),
+            ftoa(pitchDefault, buf2),
+            ftoa(yawDefault, buf3));
+    }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        ftoa(thr, buf0),
+        ftoa(roll, buf1),
+        ftoa(pitch, buf2),
+        ftoa(yaw, buf3));
+}
+
+static void printMotorMix(uint8_t dumpMask, const motorMixer_t *primaryMotorMixer, const motorMixer_t *defaultprimaryMotorMixer)
+{
     for (uint32_t i = 0; i < MAX_SUPPORTED_MOTORS; i++) {
         if (primaryMotorMixer[i].throttle == 0.0f)
             break;
-        const float thr = primaryMotorMixer[i].throttle;
-        const float roll = primaryMotorMixer[i].roll;
-        const float pitch = primaryMotorMixer[i].pitch;
-        const float yaw = primaryMotorMixer[i].yaw;
-        bool equalsDefault = false;
-        if (defaultprimaryMotorMixer) {
-            const float thrDefault = defaultprimaryMotorMixer[i].throttle;
-            const float rollDefault = defaultprimaryMotorMixer[i].roll;
-            const float pitchDefault = defaultprimaryMotorMixer[i].pitch;
-            const float yawDefault = defaultprimaryMotorMixer[i].yaw;
-            const bool equalsDefault = thr == thrDefault && roll == rollDefault && pitch == pitchDefault && yaw == yawDefault;
-
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                ftoa(thrDefault, buf0),
-                ftoa(rollDefault, buf1),
-                ftoa(pitchDefault, buf2),
-                ftoa(yawDefault, buf3));
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
-            i,
-            ftoa(thr, buf0),
-            ftoa(roll, buf1),
-            ftoa(pitch, buf2),
-            ftoa(yaw, buf3));
+        printMotorMixItem(dumpMask, primaryMotorMixer, defaultprimaryMotorMixer, i);
     }
 }
 
@@ -1111,26 +1126,31 @@ static void cliMotorMix(char *cmdline)
     }
 }
 
-static void printRxRange(uint8_t dumpMask, const rxChannelRangeConfig_t *channelRangeConfigs, const rxChannelRangeConfig_t *defaultChannelRangeConfigs)
+static void printRxRangeItem(uint8_t dumpMask, const rxChannelRangeConfig_t *channelRangeConfigs, const rxChannelRangeConfig_t *defaultChannelRangeConfigs, uint32_t i)
 {
     const char *format = "rxrange %u %u %u";
-    for (uint32_t i = 0; i < NON_AUX_CHANNEL_COUNT; i++) {
-        bool equalsDefault = false;
-        if (defaultChannelRangeConfigs) {
-            equalsDefault = channelRangeConfigs[i].min == defaultChannelRangeConfigs[i].min
-                && channelRangeConfigs[i].max == defaultChannelRangeConfigs[i].max;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                defaultChannelRangeConfigs[i].min,
-                defaultChannelRangeConfigs[i].max
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    bool equalsDefault = false;
+    if (defaultChannelRangeConfigs) {
+        equalsDefault = channelRangeConfigs[i].min == defaultChannelRangeConfigs[i].min
+            && channelRangeConfigs[i].max == defaultChannelRangeConfigs[i].max;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
-            channelRangeConfigs[i].min,
-            channelRangeConfigs[i].max
+            defaultChannelRangeConfigs[i].min,
+            defaultChannelRangeConfigs[i].max
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        channelRangeConfigs[i].min,
+        channelRangeConfigs[i].max
+    );
+}
+
+static void printRxRange(uint8_t dumpMask, const rxChannelRangeConfig_t *channelRangeConfigs, const rxChannelRangeConfig_t *defaultChannelRangeConfigs)
+{
+    for (uint32_t i = 0; i < NON_AUX_CHANNEL_COUNT; i++) {
+        printRxRangeItem(dumpMask, channelRangeConfigs, defaultChannelRangeConfigs, i);
+    }
 }
 
 static void cliRxRange(char *cmdline)
@@ -1176,42 +1196,47 @@ static void cliRxRange(char *cmdline)
 }
 
 #ifdef USE_TEMPERATURE_SENSOR
-static void printTempSensor(uint8_t dumpMask, const tempSensorConfig_t *tempSensorConfigs, const tempSensorConfig_t *defaultTempSensorConfigs)
+static void printTempSensorItem(uint8_t dumpMask, const tempSensorConfig_t *tempSensorConfigs, const tempSensorConfig_t *defaultTempSensorConfigs, uint8_t i)
 {
     const char *format = "temp_sensor %u %u %s %d %d %u %s";
-    for (uint8_t i = 0; i < MAX_TEMP_SENSORS; i++) {
-        bool equalsDefault = false;
-        char label[5], hex_address[17];
-        strncpy(label, tempSensorConfigs[i].label, TEMPERATURE_LABEL_LEN);
-        label[4] = '\0';
-        tempSensorAddressToString(tempSensorConfigs[i].address, hex_address);
-        if (defaultTempSensorConfigs) {
-            equalsDefault = tempSensorConfigs[i].type == defaultTempSensorConfigs[i].type
-                && tempSensorConfigs[i].address == defaultTempSensorConfigs[i].address
-                && tempSensorConfigs[i].osdSymbol == defaultTempSensorConfigs[i].osdSymbol
-                && !memcmp(tempSensorConfigs[i].label, defaultTempSensorConfigs[i].label, TEMPERATURE_LABEL_LEN)
-                && tempSensorConfigs[i].alarm_min == defaultTempSensorConfigs[i].alarm_min
-                && tempSensorConfigs[i].alarm_max == defaultTempSensorConfigs[i].alarm_max;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                defaultTempSensorConfigs[i].type,
-                "0",
-                defaultTempSensorConfigs[i].alarm_min,
-                defaultTempSensorConfigs[i].alarm_max,
-                0,
-                ""
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    bool equalsDefault = false;
+    char label[5], hex_address[17];
+    strncpy(label, tempSensorConfigs[i].label, TEMPERATURE_LABEL_LEN);
+    label[4] = '\0';
+    tempSensorAddressToString(tempSensorConfigs[i].address, hex_address);
+    if (defaultTempSensorConfigs) {
+        equalsDefault = tempSensorConfigs[i].type == defaultTempSensorConfigs[i].type
+            && tempSensorConfigs[i].address == defaultTempSensorConfigs[i].address
+            && tempSensorConfigs[i].osdSymbol == defaultTempSensorConfigs[i].osdSymbol
+            && !memcmp(tempSensorConfigs[i].label, defaultTempSensorConfigs[i].label, TEMPERATURE_LABEL_LEN)
+            && tempSensorConfigs[i].alarm_min == defaultTempSensorConfigs[i].alarm_min
+            && tempSensorConfigs[i].alarm_max == defaultTempSensorConfigs[i].alarm_max;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
-            tempSensorConfigs[i].type,
-            hex_address,
-            tempSensorConfigs[i].alarm_min,
-            tempSensorConfigs[i].alarm_max,
-            tempSensorConfigs[i].osdSymbol,
-            label
+            defaultTempSensorConfigs[i].type,
+            "0",
+            defaultTempSensorConfigs[i].alarm_min,
+            defaultTempSensorConfigs[i].alarm_max,
+            0,
+            ""
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        tempSensorConfigs[i].type,
+        hex_address,
+        tempSensorConfigs[i].alarm_min,
+        tempSensorConfigs[i].alarm_max,
+        tempSensorConfigs[i].osdSymbol,
+        label
+    );
+}
+
+static void printTempSensor(uint8_t dumpMask, const tempSensorConfig_t *tempSensorConfigs, const tempSensorConfig_t *defaultTempSensorConfigs)
+{
+    for (uint8_t i = 0; i < MAX_TEMP_SENSORS; i++) {
+        printTempSensorItem(dumpMask, tempSensorConfigs, defaultTempSensorConfigs, i);
+    }
 }
 
 static void cliTempSensor(char *cmdline)
@@ -1291,20 +1316,25 @@ static void cliTempSensor(char *cmdline)
 #endif
 
 #if defined(USE_SAFE_HOME)
-static void printSafeHomes(uint8_t dumpMask, const navSafeHome_t *navSafeHome, const navSafeHome_t *defaultSafeHome)
+static void printSafeHomeItem(uint8_t dumpMask, const navSafeHome_t *navSafeHome, const navSafeHome_t *defaultSafeHome, uint8_t i)
 {
     const char *format = "safehome %u %u %d %d"; // uint8_t enabled, int32_t lat; int32_t lon
+    bool equalsDefault = false;
+    if (defaultSafeHome) {
+        equalsDefault = navSafeHome[i].enabled == defaultSafeHome[i].enabled
+           && navSafeHome[i].lat == defaultSafeHome[i].lat
+           && navSafeHome[i].lon == defaultSafeHome[i].lon;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format, i,
+            defaultSafeHome[i].enabled, defaultSafeHome[i].lat, defaultSafeHome[i].lon);
+    }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format, i,
+        navSafeHome[i].enabled, navSafeHome[i].lat, navSafeHome[i].lon);
+}
+
+static void printSafeHomes(uint8_t dumpMask, const navSafeHome_t *navSafeHome, const navSafeHome_t *defaultSafeHome)
+{
     for (uint8_t i = 0; i < MAX_SAFE_HOMES; i++) {
-        bool equalsDefault = false;
-        if (defaultSafeHome) {
-            equalsDefault = navSafeHome[i].enabled == defaultSafeHome[i].enabled
-               && navSafeHome[i].lat == defaultSafeHome[i].lat
-               && navSafeHome[i].lon == defaultSafeHome[i].lon;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format, i,
-                defaultSafeHome[i].enabled, defaultSafeHome[i].lat, defaultSafeHome[i].lon);
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format, i,
-            navSafeHome[i].enabled, navSafeHome[i].lat, navSafeHome[i].lon);
+        printSafeHomeItem(dumpMask, navSafeHome, defaultSafeHome, i);
     }
 }
 
@@ -1352,45 +1382,50 @@ static void cliSafeHomes(char *cmdline)
 
 #endif
 #if defined(NAV_NON_VOLATILE_WAYPOINT_STORAGE) && defined(NAV_NON_VOLATILE_WAYPOINT_CLI)
-static void printWaypoints(uint8_t dumpMask, const navWaypoint_t *navWaypoint, const navWaypoint_t *defaultNavWaypoint)
+static void printWaypointItem(uint8_t dumpMask, const navWaypoint_t *navWaypoint, const navWaypoint_t *defaultNavWaypoint, uint8_t i)
 {
-    cliPrintLinef("#wp %d %svalid", posControl.waypointCount, posControl.waypointListValid ? "" : "in"); //int8_t bool
     const char *format = "wp %u %u %d %d %d %d %d %d %u"; //uint8_t action; int32_t lat; int32_t lon; int32_t alt; int16_t p1 int16_t p2 int16_t p3; uint8_t flag
-    for (uint8_t i = 0; i < NAV_MAX_WAYPOINTS; i++) {
-        bool equalsDefault = false;
-        if (defaultNavWaypoint) {
-            equalsDefault = navWaypoint[i].action == defaultNavWaypoint[i].action
-                && navWaypoint[i].lat == defaultNavWaypoint[i].lat
-                && navWaypoint[i].lon == defaultNavWaypoint[i].lon
-                && navWaypoint[i].alt == defaultNavWaypoint[i].alt
-                && navWaypoint[i].p1 == defaultNavWaypoint[i].p1
-                && navWaypoint[i].p2 == defaultNavWaypoint[i].p2
-                && navWaypoint[i].p3 == defaultNavWaypoint[i].p3
-                && navWaypoint[i].flag == defaultNavWaypoint[i].flag;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                defaultNavWaypoint[i].action,
-                defaultNavWaypoint[i].lat,
-                defaultNavWaypoint[i].lon,
-                defaultNavWaypoint[i].alt,
-                defaultNavWaypoint[i].p1,
-                defaultNavWaypoint[i].p2,
-                defaultNavWaypoint[i].p3,
-                defaultNavWaypoint[i].flag
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    bool equalsDefault = false;
+    if (defaultNavWaypoint) {
+        equalsDefault = navWaypoint[i].action == defaultNavWaypoint[i].action
+            && navWaypoint[i].lat == defaultNavWaypoint[i].lat
+            && navWaypoint[i].lon == defaultNavWaypoint[i].lon
+            && navWaypoint[i].alt == defaultNavWaypoint[i].alt
+            && navWaypoint[i].p1 == defaultNavWaypoint[i].p1
+            && navWaypoint[i].p2 == defaultNavWaypoint[i].p2
+            && navWaypoint[i].p3 == defaultNavWaypoint[i].p3
+            && navWaypoint[i].flag == defaultNavWaypoint[i].flag;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
-            navWaypoint[i].action,
-            navWaypoint[i].lat,
-            navWaypoint[i].lon,
-            navWaypoint[i].alt,
-            navWaypoint[i].p1,
-            navWaypoint[i].p2,
-            navWaypoint[i].p3,
-            navWaypoint[i].flag
+            defaultNavWaypoint[i].action,
+            defaultNavWaypoint[i].lat,
+            defaultNavWaypoint[i].lon,
+            defaultNavWaypoint[i].alt,
+            defaultNavWaypoint[i].p1,
+            defaultNavWaypoint[i].p2,
+            defaultNavWaypoint[i].p3,
+            defaultNavWaypoint[i].flag
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        navWaypoint[i].action,
+        navWaypoint[i].lat,
+        navWaypoint[i].lon,
+        navWaypoint[i].alt,
+        navWaypoint[i].p1,
+        navWaypoint[i].p2,
+        navWaypoint[i].p3,
+        navWaypoint[i].flag
+    );
+}
+
+static void printWaypoints(uint8_t dumpMask, const navWaypoint_t *navWaypoint, const navWaypoint_t *defaultNavWaypoint)
+{
+    cliPrintLinef("#wp %d %svalid", posControl.waypointCount, posControl.waypointListValid ? "" : "in"); //int8_t bool
+    for (uint8_t i = 0; i < NAV_MAX_WAYPOINTS; i++) {
+        printWaypointItem(dumpMask, navWaypoint, defaultNavWaypoint, i);
+    }
 }
 
 static void cliWaypoints(char *cmdline)
@@ -1426,6 +1461,7 @@ static void cliWaypoints(char *cmdline)
 #endif
             }
         }
+        invalidateWaypointCache();
         if (posControl.waypointListValid) {
             saveNonVolatileWaypointList();
         } else {
@@ -1525,6 +1561,7 @@ static void cliWaypoints(char *cmdline)
                 posControl.waypointList[i].p3 = p3;
                 posControl.waypointList[i].flag = flag;
 #endif
+                invalidateWaypointCache();
             }
         } else {
             cliShowArgumentRangeError("wp index", 0, NAV_MAX_WAYPOINTS - 1);
@@ -1535,22 +1572,27 @@ static void cliWaypoints(char *cmdline)
 #endif
 
 #ifdef USE_LED_STRIP
-static void printLed(uint8_t dumpMask, const ledConfig_t *ledConfigs, const ledConfig_t *defaultLedConfigs)
+static void printLedItem(uint8_t dumpMask, const ledConfig_t *ledConfigs, const ledConfig_t *defaultLedConfigs, uint32_t i)
 {
     const char *format = "led %u %s";
     char ledConfigBuffer[20];
     char ledConfigDefaultBuffer[20];
+    ledConfig_t ledConfig = ledConfigs[i];
+    generateLedConfig(&ledConfig, ledConfigBuffer, sizeof(ledConfigBuffer));
+    bool equalsDefault = false;
+    if (defaultLedConfigs) {
+        ledConfig_t ledConfigDefault = defaultLedConfigs[i];
+        equalsDefault = ledConfig == ledConfigDefault;
+        generateLedConfig(&ledConfigDefault, ledConfigDefaultBuffer, sizeof(ledConfigDefaultBuffer));
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format, i, ledConfigDefaultBuffer);
+    }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format, i, ledConfigBuffer);
+}
+
+static void printLed(uint8_t dumpMask, const ledConfig_t *ledConfigs, const ledConfig_t *defaultLedConfigs)
+{
     for (uint32_t i = 0; i < LED_MAX_STRIP_LENGTH; i++) {
-        ledConfig_t ledConfig = ledConfigs[i];
-        generateLedConfig(&ledConfig, ledConfigBuffer, sizeof(ledConfigBuffer));
-        bool equalsDefault = false;
-        if (defaultLedConfigs) {
-            ledConfig_t ledConfigDefault = defaultLedConfigs[i];
-            equalsDefault = ledConfig == ledConfigDefault;
-            generateLedConfig(&ledConfigDefault, ledConfigDefaultBuffer, sizeof(ledConfigDefaultBuffer));
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format, i, ledConfigDefaultBuffer);
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format, i, ledConfigBuffer);
+        printLedItem(dumpMask, ledConfigs, defaultLedConfigs, i);
     }
 }
 
@@ -1575,20 +1617,25 @@ static void cliLed(char *cmdline)
     }
 }
 
-static void printColor(uint8_t dumpMask, const hsvColor_t *colors, const hsvColor_t *defaultColors)
+static void printColorItem(uint8_t dumpMask, const hsvColor_t *colors, const hsvColor_t *defaultColors, uint32_t i)
 {
     const char *format = "color %u %d,%u,%u";
+    const hsvColor_t *color = &colors[i];
+    bool equalsDefault = false;
+    if (defaultColors) {
+        const hsvColor_t *colorDefault = &defaultColors[i];
+        equalsDefault = color->h == colorDefault->h
+            && color->s == colorDefault->s
+            && color->v == colorDefault->v;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format, i,colorDefault->h, colorDefault->s, colorDefault->v);
+    }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format, i, color->h, color->s, color->v);
+}
+
+static void printColor(uint8_t dumpMask, const hsvColor_t *colors, const hsvColor_t *defaultColors)
+{
     for (uint32_t i = 0; i < LED_CONFIGURABLE_COLOR_COUNT; i++) {
-        const hsvColor_t *color = &colors[i];
-        bool equalsDefault = false;
-        if (defaultColors) {
-            const hsvColor_t *colorDefault = &defaultColors[i];
-            equalsDefault = color->h == colorDefault->h
-                && color->s == colorDefault->s
-                && color->v == colorDefault->v;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format, i,colorDefault->h, colorDefault->s, colorDefault->v);
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format, i, color->h, color->s, color->v);
+        printColorItem(dumpMask, colors, defaultColors, i);
     }
 }
 
@@ -1610,31 +1657,29 @@ static void cliColor(char *cmdline)
     }
 }
 
-static void printModeColor(uint8_t dumpMask, const ledStripConfig_t *ledStripConfig, const ledStripConfig_t *defaultLedStripConfig)
+static void printModeColorItem(uint8_t dumpMask, const ledStripConfig_t *ledStripConfig, const ledStripConfig_t *defaultLedStripConfig, uint32_t mode, uint32_t j)
 {
     const char *format = "mode_color %u %u %u";
+    const int colorIndex = mode == LED_SPECIAL ? ledStripConfig->specialColors.color[j] : ledStripConfig->modeColors[mode].color[j];
+    bool equalsDefault = false;
+    if (defaultLedStripConfig) {
+        const int colorIndexDefault = mode == LED_SPECIAL ? defaultLedStripConfig->specialColors.color[j] : defaultLedStripConfig->modeColors[mode].color[j];
+        equalsDefault = colorIndex == colorIndexDefault;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format, mode, j, colorIndexDefault);
+    }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format, mode, j, colorIndex);
+}
+
+static void printModeColor(uint8_t dumpMask, const ledStripConfig_t *ledStripConfig, const ledStripConfig_t *defaultLedStripConfig)
+{
     for (uint32_t i = 0; i < LED_MODE_COUNT; i++) {
         for (uint32_t j = 0; j < LED_DIRECTION_COUNT; j++) {
-            int colorIndex = ledStripConfig->modeColors[i].color[j];
-            bool equalsDefault = false;
-            if (defaultLedStripConfig) {
-                int colorIndexDefault = defaultLedStripConfig->modeColors[i].color[j];
-                equalsDefault = colorIndex == colorIndexDefault;
-                cliDefaultPrintLinef(dumpMask, equalsDefault, format, i, j, colorIndexDefault);
-            }
-            cliDumpPrintLinef(dumpMask, equalsDefault, format, i, j, colorIndex);
+            printModeColorItem(dumpMask, ledStripConfig, defaultLedStripConfig, i, j);
         }
     }
 
     for (uint32_t j = 0; j < LED_SPECIAL_COLOR_COUNT; j++) {
-        const int colorIndex = ledStripConfig->specialColors.color[j];
-        bool equalsDefault = false;
-        if (defaultLedStripConfig) {
-            const int colorIndexDefault = defaultLedStripConfig->specialColors.color[j];
-            equalsDefault = colorIndex == colorIndexDefault;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format, LED_SPECIAL, j, colorIndexDefault);
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format, LED_SPECIAL, j, colorIndex);
+        printModeColorItem(dumpMask, ledStripConfig, defaultLedStripConfig, LED_SPECIAL, j);
     }
 }
 
@@ -1672,35 +1717,40 @@ static void cliModeColor(char *cmdline)
 }
 #endif
 
-static void printServo(uint8_t dumpMask, const servoParam_t *servoParam, const servoParam_t *defaultServoParam)
+static void printServoItem(uint8_t dumpMask, const servoParam_t *servoParam, const servoParam_t *defaultServoParam, uint32_t i)
 {
-    // print out servo settings
     const char *format = "servo %u %d %d %d %d";
-    for (uint32_t i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
-        const servoParam_t *servoConf = &servoParam[i];
-        bool equalsDefault = false;
-        if (defaultServoParam) {
-            const servoParam_t *servoConfDefault = &defaultServoParam[i];
-            equalsDefault = servoConf->min == servoConfDefault->min
-                && servoConf->max == servoConfDefault->max
-                && servoConf->middle == servoConfDefault->middle
-                && servoConf->rate == servoConfDefault->rate;
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                servoConfDefault->min,
-                servoConfDefault->max,
-                servoConfDefault->middle,
-                servoConfDefault->rate
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    const servoParam_t *servoConf = &servoParam[i];
+    bool equalsDefault = false;
+    if (defaultServoParam) {
+        const servoParam_t *servoConfDefault = &defaultServoParam[i];
+        equalsDefault = servoConf->min == servoConfDefault->min
+            && servoConf->max == servoConfDefault->max
+            && servoConf->middle == servoConfDefault->middle
+            && servoConf->rate == servoConfDefault->rate;
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
-            servoConf->min,
-            servoConf->max,
-            servoConf->middle,
-            servoConf->rate
+            servoConfDefault->min,
+            servoConfDefault->max,
+            servoConfDefault->middle,
+            servoConfDefault->rate
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        servoConf->min,
+        servoConf->max,
+        servoConf->middle,
+        servoConf->rate
+    );
+}
+
+static void printServo(uint8_t dumpMask, const servoParam_t *servoParam, const servoParam_t *defaultServoParam)
+{
+    // print out servo settings
+    for (uint32_t i = 0; i < MAX_SUPPORTED_SERVOS; i++) {
+        printServoItem(dumpMask, servoParam, defaultServoParam, i);
+    }
 }
 
 static void cliServo(char *cmdline)
@@ -1773,46 +1823,28 @@ static void cliServo(char *cmdline)
     }
 }
 
-static void printServoMix(uint8_t dumpMask, const servoMixer_t *customServoMixers, const servoMixer_t *defaultCustomServoMixers)
+static void printServoMixItem(uint8_t dumpMask, const servoMixer_t *customServoMixers, const servoMixer_t *defaultCustomServoMixers, uint32_t i)
 {
     const char *format = "smix %d %d %d %d %d %d";
-    for (uint32_t i = 0; i < MAX_SERVO_RULES; i++) {
-        const servoMixer_t customServoMixer = customServoMixers[i];
-        if (customServoMixer.rate == 0) {
-            break;
-        }
+    const servoMixer_t customServoMixer = customServoMixers[i];
+    bool equalsDefault = false;
+    if (defaultCustomServoMixers) {
+        servoMixer_t customServoMixerDefault = defaultCustomServoMixers[i];
+        equalsDefault = customServoMixer.targetChannel == customServoMixerDefault.targetChannel
+            && customServoMixer.inputSource == customServoMixerDefault.inputSource
+            && customServoMixer.rate == customServoMixerDefault.rate
+            && customServoMixer.speed == customServoMixerDefault.speed
+        #ifdef USE_PROGRAMMING_FRAMEWORK
+            && customServoMixer.conditionId == customServoMixerDefault.conditionId
+        #endif
+        ;
 
-        bool equalsDefault = false;
-        if (defaultCustomServoMixers) {
-            servoMixer_t customServoMixerDefault = defaultCustomServoMixers[i];
-            equalsDefault = customServoMixer.targetChannel == customServoMixerDefault.targetChannel
-                && customServoMixer.inputSource == customServoMixerDefault.inputSource
-                && customServoMixer.rate == customServoMixerDefault.rate
-                && customServoMixer.speed == customServoMixerDefault.speed
-            #ifdef USE_PROGRAMMING_FRAMEWORK
-                && customServoMixer.conditionId == customServoMixerDefault.conditionId
-            #endif
-            ;
-
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                customServoMixerDefault.targetChannel,
-                customServoMixerDefault.inputSource,
-                customServoMixerDefault.rate,
-                customServoMixerDefault.speed,
-            #ifdef USE_PROGRAMMING_FRAMEWORK
-                customServoMixer.conditionId
-            #else
-                0
-            #endif
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
-            customServoMixer.targetChannel,
-            customServoMixer.inputSource,
-            customServoMixer.rate,
-            customServoMixer.speed,
+            customServoMixerDefault.targetChannel,
+            customServoMixerDefault.inputSource,
+            customServoMixerDefault.rate,
+            customServoMixerDefault.speed,
         #ifdef USE_PROGRAMMING_FRAMEWORK
             customServoMixer.conditionId
         #else
@@ -1820,6 +1852,28 @@ static void printServoMix(uint8_t dumpMask, const servoMixer_t *customServoMixer
         #endif
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        customServoMixer.targetChannel,
+        customServoMixer.inputSource,
+        customServoMixer.rate,
+        customServoMixer.speed,
+    #ifdef USE_PROGRAMMING_FRAMEWORK
+        customServoMixer.conditionId
+    #else
+        0
+    #endif
+    );
+}
+
+static void printServoMix(uint8_t dumpMask, const servoMixer_t *customServoMixers, const servoMixer_t *defaultCustomServoMixers)
+{
+    for (uint32_t i = 0; i < MAX_SERVO_RULES; i++) {
+        if (customServoMixers[i].rate == 0) {
+            break;
+        }
+        printServoMixItem(dumpMask, customServoMixers, defaultCustomServoMixers, i);
+    }
 }
 
 static void cliServoMix(char *cmdline)
@@ -1872,38 +1926,25 @@ static void cliServoMix(char *cmdline)
 
 #ifdef USE_PROGRAMMING_FRAMEWORK
 
-static void printLogic(uint8_t dumpMask, const logicCondition_t *logicConditions, const logicCondition_t *defaultLogicConditions)
+static void printLogicItem(uint8_t dumpMask, const logicCondition_t *logicConditions, const logicCondition_t *defaultLogicConditions, uint32_t i)
 {
     const char *format = "logic %d %d %d %d %d %d %d %d %d";
-    for (uint32_t i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
-        const logicCondition_t logic = logicConditions[i];
-
-        bool equalsDefault = false;
-        if (defaultLogicConditions) {
-            logicCondition_t defaultValue = defaultLogicConditions[i];
-            equalsDefault =
-                logic.enabled == defaultValue.enabled &&
-                logic.activatorId == defaultValue.activatorId &&
-                logic.operation == defaultValue.operation &&
-                logic.operandA.type == defaultValue.operandA.type &&
-                logic.operandA.value == defaultValue.operandA.value &&
-                logic.operandB.type == defaultValue.operandB.type &&
-                logic.operandB.value == defaultValue.operandB.value &&
-                logic.flags == defaultValue.flags;
-
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                logic.enabled,
-                logic.activatorId,
-                logic.operation,
-                logic.operandA.type,
-                logic.operandA.value,
-                logic.operandB.type,
-                logic.operandB.value,
-                logic.flags
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    const logicCondition_t logic = logicConditions[i];
+
+    bool equalsDefault = false;
+    if (defaultLogicConditions) {
+        logicCondition_t defaultValue = defaultLogicConditions[i];
+        equalsDefault =
+            logic.enabled == defaultValue.enabled &&
+            logic.activatorId == defaultValue.activatorId &&
+            logic.operation == defaultValue.operation &&
+            logic.operandA.type == defaultValue.operandA.type &&
+            logic.operandA.value == defaultValue.operandA.value &&
+            logic.operandB.type == defaultValue.operandB.type &&
+            logic.operandB.value == defaultValue.operandB.value &&
+            logic.flags == defaultValue.flags;
+
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
             logic.enabled,
             logic.activatorId,
@@ -1915,6 +1956,24 @@ static void printLogic(uint8_t dumpMask, const logicCondition_t *logicConditions
             logic.flags
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        logic.enabled,
+        logic.activatorId,
+        logic.operation,
+        logic.operandA.type,
+        logic.operandA.value,
+        logic.operandB.type,
+        logic.operandB.value,
+        logic.flags
+    );
+}
+
+static void printLogic(uint8_t dumpMask, const logicCondition_t *logicConditions, const logicCondition_t *defaultLogicConditions)
+{
+    for (uint32_t i = 0; i < MAX_LOGIC_CONDITIONS; i++) {
+        printLogicItem(dumpMask, logicConditions, defaultLogicConditions, i);
+    }
 }
 
 static void cliLogic(char *cmdline) {
@@ -1979,34 +2038,39 @@ static void cliLogic(char *cmdline) {
     }
 }
 
-static void printGvar(uint8_t dumpMask, const globalVariableConfig_t *gvars, const globalVariableConfig_t *defaultGvars)
+static void printGvarItem(uint8_t dumpMask, const globalVariableConfig_t *gvars, const globalVariableConfig_t *defaultGvars, uint32_t i)
 {
     const char *format = "gvar %d %d %d %d";
-    for (uint32_t i = 0; i < MAX_GLOBAL_VARIABLES; i++) {
-        const globalVariableConfig_t gvar = gvars[i];
-
-        bool equalsDefault = false;
-        if (defaultGvars) {
-            globalVariableConfig_t defaultValue = defaultGvars[i];
-            equalsDefault =
-                gvar.defaultValue == defaultValue.defaultValue &&
-                gvar.min == defaultValue.min &&
-                gvar.max == defaultValue.max;
-
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                gvar.defaultValue,
-                gvar.min,
-                gvar.max
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    const globalVariableConfig_t gvar = gvars[i];
+
+    bool equalsDefault = false;
+    if (defaultGvars) {
+        globalVariableConfig_t defaultValue = defaultGvars[i];
+        equalsDefault =
+            gvar.defaultValue == defaultValue.defaultValue &&
+            gvar.min == defaultValue.min &&
+            gvar.max == defaultValue.max;
+
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
             gvar.defaultValue,
             gvar.min,
             gvar.max
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        gvar.defaultValue,
+        gvar.min,
+        gvar.max
+    );
+}
+
+static void printGvar(uint8_t dumpMask, const globalVariableConfig_t *gvars, const globalVariableConfig_t *defaultGvars)
+{
+    for (uint32_t i = 0; i < MAX_GLOBAL_VARIABLES; i++) {
+        printGvarItem(dumpMask, gvars, defaultGvars, i);
+    }
 }
 
 static void cliGvar(char *cmdline) {
@@ -2055,40 +2119,26 @@ static void cliGvar(char *cmdline) {
     }
 }
 
-static void printPid(uint8_t dumpMask, const programmingPid_t *programmingPids, const programmingPid_t *defaultProgrammingPids)
+static void printPidItem(uint8_t dumpMask, const programmingPid_t *programmingPids, const programmingPid_t *defaultProgrammingPids, uint32_t i)
 {
     const char *format = "pid %d %d %d %d %d %d %d %d %d %d";
-    for (uint32_t i = 0; i < MAX_PROGRAMMING_PID_COUNT; i++) {
-        const programmingPid_t pid = programmingPids[i];
-
-        bool equalsDefault = false;
-        if (defaultProgrammingPids) {
-            programmingPid_t defaultValue = defaultProgrammingPids[i];
-            equalsDefault =
-                pid.enabled == defaultValue.enabled &&
-                pid.setpoint.type == defaultValue.setpoint.type &&
-                pid.setpoint.value == defaultValue.setpoint.value &&
-                pid.measurement.type == defaultValue.measurement.type &&
-                pid.measurement.value == defaultValue.measurement.value &&
-                pid.gains.P == defaultValue.gains.P &&
-                pid.gains.I == defaultValue.gains.I &&
-                pid.gains.D == defaultValue.gains.D &&
-                pid.gains.FF == defaultValue.gains.FF;
-
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                i,
-                pid.enabled,
-                pid.setpoint.type,
-                pid.setpoint.value,
-                pid.measurement.type,
-                pid.measurement.value,
-                pid.gains.P,
-                pid.gains.I,
-                pid.gains.D,
-                pid.gains.FF
-            );
-        }
-        cliDumpPrintLinef(dumpMask, equalsDefault, format,
+    const programmingPid_t pid = programmingPids[i];
+
+    bool equalsDefault = false;
+    if (defaultProgrammingPids) {
+        programmingPid_t defaultValue = defaultProgrammingPids[i];
+        equalsDefault =
+            pid.enabled == defaultValue.enabled &&
+            pid.setpoint.type == defaultValue.setpoint.type &&
+            pid.setpoint.value == defaultValue.setpoint.value &&
+            pid.measurement.type == defaultValue.measurement.type &&
+            pid.measurement.value == defaultValue.measurement.value &&
+            pid.gains.P == defaultValue.gains.P &&
+            pid.gains.I == defaultValue.gains.I &&
+            pid.gains.D == defaultValue.gains.D &&
+            pid.gains.FF == defaultValue.gains.FF;
+
+        cliDefaultPrintLinef(dumpMask, equalsDefault, format,
             i,
             pid.enabled,
             pid.setpoint.type,
@@ -2101,6 +2151,25 @@ static void printPid(uint8_t dumpMask, const programmingPid_t *programmingPids,
             pid.gains.FF
         );
     }
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        i,
+        pid.enabled,
+        pid.setpoint.type,
+        pid.setpoint.value,
+        pid.measurement.type,
+        pid.measurement.value,
+        pid.gains.P,
+        pid.gains.I,
+        pid.gains.D,
+        pid.gains.FF
+    );
+}
+
+static void printPid(uint8_t dumpMask, const programmingPid_t *programmingPids, const programmingPid_t *defaultProgrammingPids)
+{
+    for (uint32_t i = 0; i < MAX_PROGRAMMING_PID_COUNT; i++) {
+        printPidItem(dumpMask, programmingPids, defaultProgrammingPids, i);
+    }
 }
 
 static void cliPid(char *cmdline) {
@@ -2354,32 +2423,37 @@ static void cliFlashRead(char *cmdline)
 #endif
 
 #ifdef USE_OSD
-static void printOsdLayout(uint8_t dumpMask, const osdLayoutsConfig_t *config, const osdLayoutsConfig_t *configDefault, int layout, int item)
+static void printOsdLayoutItem(uint8_t dumpMask, const osdLayoutsConfig_t *config, const osdLayoutsConfig_t *configDefault, int layout, int item)
 {
     // "<layout> <item> <col> <row> <visible>"
     const char *format = "osd_layout %d %d %d %d %c";
+    const uint16_t itemPos = config->item_pos[layout][item];
+    const uint16_t defaultItemPos = configDefault->item_pos[layout][item];
+    bool equalsDefault = itemPos == defaultItemPos;
+    cliDefaultPrintLinef(dumpMask, equalsDefault, format,
+        layout, item,
+        OSD_X(defaultItemPos),
+        OSD_Y(defaultItemPos),
+        OSD_VISIBLE(defaultItemPos) ? 'V' : 'H');
+
+    cliDumpPrintLinef(dumpMask, equalsDefault, format,
+        layout, item,
+        OSD_X(itemPos),
+        OSD_Y(itemPos),
+        OSD_VISIBLE(itemPos) ? 'V' : 'H');
+}
+
+static void printOsdLayout(uint8_t dumpMask, const osdLayoutsConfig_t *config, const osdLayoutsConfig_t *configDefault, int layout, int item)
+{
     for (int ii = 0; ii < OSD_LAYOUT_COUNT; ii++) {
         if (layout >= 0 && layout != ii) {
             continue;
         }
-        const uint16_t *layoutItems = config->item_pos[ii];
-        const uint16_t *defaultLayoutItems = configDefault->item_pos[ii];
         for (int jj = 0; jj < OSD_ITEM_COUNT; jj++) {
             if (item >= 0 && item != jj) {
                 continue;
             }
-            bool equalsDefault = layoutItems[jj] == defaultLayoutItems[jj];
-            cliDefaultPrintLinef(dumpMask, equalsDefault, format,
-                ii, jj,
-                OSD_X(defaultLayoutItems[jj]),
-                OSD_Y(defaultLayoutItems[jj]),
-                OSD_VISIBLE(defaultLayoutItems[jj]) ? 'V' : 'H');
-
-            cliDumpPrintLinef(dumpMask, equalsDefault, format,
-                ii, jj,
-                OSD_X(layoutItems[jj]),
-                OSD_Y(layoutItems[jj]),
-                OSD_VISIBLE(layoutItems[jj]) ? 'V' : 'H');
+            printOsdLayoutItem(dumpMask, config, configDefault, ii, jj);
         }
     }
 }
@@ -2474,24 +2548,18 @@ static void cliOsdLayout(char *cmdline)
 
 #endif
 
-static void printFeature(uint8_t dumpMask, const featureConfig_t *featureConfig, const featureConfig_t *featureConfigDefault)
+static void printFeatureItem(uint8_t dumpMask, const featureConfig_t *featureConfig, const featureConfig_t *featureConfigDefault, uint32_t i, bool enable)
 {
-    uint32_t mask = featureConfig->enabledFeatures;
-    uint32_t defaultMask = featureConfigDefault->enabledFeatures;
-    for (uint32_t i = 0; ; i++) { // disable all feature first
-        if (featureNames[i] == NULL)
-            break;
-        if (featureNames[i][0] == '\0')
-            continue;
+    const uint32_t mask = featureConfig->enabledFeatures;
+    const uint32_t defaultMask = featureConfigDefault->enabledFeatures;
+    if (featureNames[i][0] == '\0') {
+        return;
+    }
+    if (!enable) {
         const char *format = "feature -%s";
         cliDefaultPrintLinef(dumpMask, (defaultMask | ~mask) & (1 << i), format, featureNames[i]);
         cliDumpPrintLinef(dumpMask, (~defaultMask | mask) & (1 << i), format, featureNames[i]);
-    }
-    for (uint32_t i = 0; ; i++) {  // reenable what we want.
-        if (featureNames[i] == NULL)
-            break;
-        if (featureNames[i][0] == '\0')
-            continue;
+    } else {
         const char *format = "feature %s";
         if (defaultMask & (1 << i)) {
             cliDefaultPrintLinef(dumpMask, (~defaultMask | mask) & (1 << i), format, featureNames[i]);
@@ -2568,30 +2636,19 @@ static void cliFeature(char *cmdline)
 }
 
 #ifdef USE_BLACKBOX
-static void printBlackbox(uint8_t dumpMask, const blackboxConfig_t *config, const blackboxConfig_t *configDefault)
+static void printBlackboxItem(uint8_t dumpMask, const blackboxConfig_t *config, uint8_t i)
 {
+    const uint32_t mask = config->includeFlags;
+    const char *formatOn = "blackbox %s";
+    const char *formatOff = "blackbox -%s";
 
-    UNUSED(configDefault);
-
-    uint32_t mask = config->includeFlags;
-
-    for (uint8_t i = 0; ; i++) {  // reenable what we want.
-        if (blackboxIncludeFlagNames[i] == NULL) {
-            break;
-        }
-
-        const char *formatOn = "blackbox %s";
-        const char *formatOff = "blackbox -%s";
-
-        if (mask & (1 << i)) {
-            cliDumpPrintLinef(dumpMask, false, formatOn, blackboxIncludeFlagNames[i]);
-            cliDefaultPrintLinef(dumpMask, false, formatOn, blackboxIncludeFlagNames[i]);
-        } else {
-            cliDumpPrintLinef(dumpMask, false, formatOff, blackboxIncludeFlagNames[i]);
-            cliDefaultPrintLinef(dumpMask, false, formatOff, blackboxIncludeFlagNames[i]);
-        }
+    if (mask & (1 << i)) {
+        cliDumpPrintLinef(dumpMask, false, formatOn, blackboxIncludeFlagNames[i]);
+        cliDefaultPrintLinef(dumpMask, false, formatOn, blackboxIncludeFlagNames[i]);
+    } else {
+        cliDumpPrintLinef(dumpMask, false, formatOff, blackboxIncludeFlagNames[i]);
+        cliDefaultPrintLinef(dumpMask, false, formatOff, blackboxIncludeFlagNames[i]);
     }
-
 }
 
 static void cliBlackbox(char *cmdline)
@@ -2656,17 +2713,14 @@ static void cliBlackbox(char *cmdline)
 #endif
 
 #if defined(BEEPER) || defined(USE_DSHOT)
-static void printBeeper(uint8_t dumpMask, const beeperConfig_t *beeperConfig, const beeperConfig_t *beeperConfigDefault)
+static void printBeeperItem(uint8_t dumpMask, const beeperConfig_t *beeperConfig, const beeperConfig_t *beeperConfigDefault, int i)
 {
-    const uint8_t beeperCount = beeperTableEntryCount();
     const uint32_t mask = beeperConfig->beeper_off_flags;
     const uint32_t defaultMask = beeperConfigDefault->beeper_off_flags;
-    for (int i = 0; i < beeperCount - 2; i++) {
-        const char *formatOff = "beeper -%s";
-        const char *formatOn = "beeper %s";
-        cliDefaultPrintLinef(dumpMask, ~(mask ^ defaultMask) & (1 << i), mask & (1 << i) ? formatOn : formatOff, beeperNameForTableIndex(i));
-        cliDumpPrintLinef(dumpMask, ~(mask ^ defaultMask) & (1 << i), mask & (1 << i) ? formatOff : formatOn, beeperNameForTableIndex(i));
-    }
+    const char *formatOff = "beeper -%s";
+    const char *formatOn = "beeper %s";
+    cliDefaultPrintLinef(dumpMask, ~(mask ^ defaultMask) & (1 << i), mask & (1 << i) ? formatOn : formatOff, beeperNameForTableIndex(i));
+    cliDumpPrintLinef(dumpMask, ~(mask ^ defaultMask) & (1 << i), mask & (1 << i) ? formatOff : formatOn, beeperNameForTableIndex(i));
 }
 
 static void cliBeeper(char *cmdline)
@@ -2997,19 +3051,6 @@ static void cliProfile(char *cmdline)
     }
 }
 
-static void cliDumpProfile(uint8_t profileIndex, uint8_t dumpMask)
-{
-    if (profileIndex >= MAX_PROFILE_COUNT) {
-        // Faulty values
-        return;
-    }
-    setConfigProfile(profileIndex);
-    cliPrintHashLine("profile");
-    cliPrintLinef("profile %d\r\n", getConfigProfile() + 1);
-    dumpAllValues(PROFILE_VALUE, dumpMask);
-    dumpAllValues(CONTROL_RATE_VALUE, dumpMask);
-}
-
 static void cliBatteryProfile(char *cmdline)
 {
     // CLI profile index is 1-based
@@ -3025,18 +3066,6 @@ static void cliBatteryProfile(char *cmdline)
     }
 }
 
-static void cliDumpBatteryProfile(uint8_t profileIndex, uint8_t dumpMask)
-{
-    if (profileIndex >= MAX_BATTERY_PROFILE_COUNT) {
-        // Faulty values
-        return;
-    }
-    setConfigBatteryProfile(profileIndex);
-    cliPrintHashLine("battery_profile");
-    cliPrintLinef("battery_profile %d\r\n", getConfigBatteryProfile() + 1);
-    dumpAllValues(BATTERY_CONFIG_VALUE, dumpMask);
-}
-
 #ifdef USE_CLI_BATCH
 static void cliPrintCommandBatchWarning(const char *warning)
 {
@@ -3225,70 +3254,76 @@ static void cliSet(char *cmdline)
             eqptr++;
         }
 
-        for (uint32_t i = 0; i < SETTINGS_TABLE_COUNT; i++) {
-            val = settingGet(i);
-            // ensure exact match when setting to prevent setting variables with shorter names
-            if (settingNameIsExactMatch(val, name, cmdline, variableNameLength)) {
-                const setting_type_e type = SETTING_TYPE(val);
-                if (type == VAR_STRING) {
-                    // if setting the craftname, remove any quotes around the name.  This allows leading spaces in the name
-                    if (strcmp(name, "name") == 0 && eqptr[0] == '"' && eqptr[strlen(eqptr)-1] == '"') {
-                        settingSetString(val, eqptr + 1, strlen(eqptr)-2);
-                    } else {
-                        settingSetString(val, eqptr, strlen(eqptr));
-                    }
-                    return;
+        // Setting names are lowercase, but allow any case in the CLI
+        val = NULL;
+        if (variableNameLength < SETTING_MAX_NAME_LENGTH) {
+            for (unsigned i = 0; i < variableNameLength; i++) {
+                name[i] = sl_tolower(cmdline[i]);
+            }
+            name[variableNameLength] = '\0';
+            val = settingFind(name);
+        }
+
+        if (val) {
+            const setting_type_e type = SETTING_TYPE(val);
+            if (type == VAR_STRING) {
+                // if setting the craftname, remove any quotes around the name.  This allows leading spaces in the name
+                if (strcmp(name, "name") == 0 && eqptr[0] == '"' && eqptr[strlen(eqptr)-1] == '"') {
+                    settingSetString(val, eqptr + 1, strlen(eqptr)-2);
+                } else {
+                    settingSetString(val, eqptr, strlen(eqptr));
                 }
-                const setting_mode_e mode = SETTING_MODE(val);
-                bool changeValue = false;
-                int_float_value_t tmp = {0};
-                switch (mode) {
-                case MODE_DIRECT: {
-                        if (*eqptr != 0 && strspn(eqptr, "0123456789.+-") == strlen(eqptr)) {
-                            float valuef = fastA2F(eqptr);
-                            // note: compare float values
-                            if (valuef >= (float)settingGetMin(val) && valuef <= (float)settingGetMax(val)) {
-
-                                if (type == VAR_FLOAT)
-                                    tmp.float_value = valuef;
-                                else if (type == VAR_UINT32)
-                                    tmp.uint_value = fastA2UL(eqptr);
-                                else
-                                    tmp.int_value = fastA2I(eqptr);
-
-                                changeValue = true;
-                            }
+                return;
+            }
+            const setting_mode_e mode = SETTING_MODE(val);
+            bool changeValue = false;
+            int_float_value_t tmp = {0};
+            switch (mode) {
+            case MODE_DIRECT: {
+                    if (*eqptr != 0 && strspn(eqptr, "0123456789.+-") == strlen(eqptr)) {
+                        float valuef = fastA2F(eqptr);
+                        // note: compare float values
+                        if (valuef >= (float)settingGetMin(val) && valuef <= (float)settingGetMax(val)) {
+
+                            if (type == VAR_FLOAT)
+                                tmp.float_value = valuef;
+                            else if (type == VAR_UINT32)
+                                tmp.uint_value = fastA2UL(eqptr);
+                            else
+                                tmp.int_value = fastA2I(eqptr);
+
+                            changeValue = true;
                         }
                     }
-                    break;
-                case MODE_LOOKUP: {
-                        const lookupTableEntry_t *tableEntry = settingLookupTable(val);
-                        bool matched = false;
-                        for (uint32_t tableValueIndex = 0; tableValueIndex < tableEntry->valueCount && !matched; tableValueIndex++) {
-                            matched = sl_strcasecmp(tableEntry->values[tableValueIndex], eqptr) == 0;
-
-                            if (matched) {
-                                tmp.int_value = tableValueIndex;
-                                changeValue = true;
-                            }
+                }
+                break;
+            case MODE_LOOKUP: {
+                    const lookupTableEntry_t *tableEntry = settingLookupTable(val);
+                    bool matched = false;
+                    for (uint32_t tableValueIndex = 0; tableValueIndex < tableEntry->valueCount && !matched; tableValueIndex++) {
+                        matched = sl_strcasecmp(tableEntry->values[tableValueIndex], eqptr) == 0;
+
+                        if (matched) {
+                            tmp.int_value = tableValueIndex;
+                            changeValue = true;
                         }
                     }
-                    break;
                 }
+                break;
+            }
 
-                if (changeValue) {
-                    cliSetIntFloatVar(val, tmp);
-
-                    cliPrintf("%s set to ", name);
-                    cliPrintVar(val, 0);
-                } else {
-                    cliPrintError("Invalid value. ");
-                    cliPrintVarRange(val);
-                    cliPrintLinefeed();
-                }
+            if (changeValue) {
+                cliSetIntFloatVar(val, tmp);
 
-                return;
+                cliPrintf("%s set to ", name);
+                cliPrintVar(val, 0);
+            } else {
+                cliPrintError("Invalid value. ");
+                cliPrintVarRange(val);
+                cliPrintLinefeed();
             }
+
+            return;
         }
         cliPrintErrorLine("Invalid name");
     } else {
@@ -3333,6 +3368,9 @@ static void cliStatus(char *cmdline)
     }
     cliPrintLinefeed();
 
+#if defined(SITL_BUILD)
+    cliPrintLine("SITL build, no STM32 system clocks");
+#else
     cliPrintLine("STM32 system clocks:");
 #if defined(USE_HAL_DRIVER)
     cliPrintLinef("  SYSCLK = %d MHz", HAL_RCC_GetSysClockFreq() / 1000000);
@@ -3346,6 +3384,7 @@ static void cliStatus(char *cmdline)
     cliPrintLinef("  HCLK   = %d MHz", clocks.HCLK_Frequency / 1000000);
     cliPrintLinef("  PCLK1  = %d MHz", clocks.PCLK1_Frequency / 1000000);
     cliPrintLinef("  PCLK2  = %d MHz", clocks.PCLK2_Frequency / 1000000);
+#endif
 #endif
 
     cliPrintLinef("Sensor status: GYRO=%s, ACC=%s, MAG=%s, BARO=%s, RANGEFINDER=%s, OPFLOW=%s, GPS=%s, IMU2=%s",
@@ -3421,6 +3460,9 @@ static void cliStatus(char *cmdline)
     const int rxRate = getTaskDeltaTime(TASK_RX) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTime(TASK_RX)));
     const int systemRate = getTaskDeltaTime(TASK_SYSTEM) == 0 ? 0 : (int)(1000000.0f / ((float)getTaskDeltaTime(TASK_SYSTEM)));
     cliPrintLinef(", cycle time: %d, PID rate: %d, RX rate: %d, System rate: %d",  (uint16_t)cycleTime, pidRate, rxRate, systemRate);
+#ifdef USE_BLACKBOX
+    cliPrintLinef("Blackbox dropped frames: %u", (unsigned)blackboxGetDroppedFrameCount());
+#endif
 #if !defined(CLI_MINIMAL_VERBOSITY)
     cliPrint("Arming disabled flags:");
     uint32_t flags = armingFlags & ARMING_DISABLED_ALL_FLAGS;
@@ -3464,6 +3506,14 @@ static void cliStatus(char *cmdline)
     cliPrintLinefeed();
 #endif
 
+#if defined(USE_MSP_DISPLAYPORT) && !defined(CLI_MINIMAL_VERBOSITY)
+    mspDisplayportStats_t displayportStats;
+    if (displayPortMspGetStats(&displayportStats)) {
+        cliPrintLinef("MSP displayport: %u frames/s, %u bytes/s",
+            (unsigned)displayportStats.framesPerSecond, (unsigned)displayportStats.bytesPerSecond);
+    }
+#endif
+
     // If we are blocked by PWM init - provide more information
     if (getPwmInitError() != PWM_INIT_ERROR_NONE) {
         cliPrintLinef("PWM output init error: %s", getPwmInitErrorMessage());
@@ -3471,14 +3521,55 @@ static void cliStatus(char *cmdline)
 }
 
 #ifndef SKIP_TASK_STATISTICS
+static void cliTasksHistogram(void)
+{
+    cliPrintf("Task histograms     ");
+    for (int bucket = 0; bucket < TASK_HISTOGRAM_BUCKET_COUNT; bucket++) {
+        cliPrintf(bucket == TASK_HISTOGRAM_BUCKET_COUNT - 1 ? " >=%5d" : " <=%5d", (uint32_t)taskHistogramBucketLimit(bucket));
+    }
+    cliPrintLinefeed();
+
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        cfTaskHistogramInfo_t histogramInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (taskInfo.isEnabled) {
+            getTaskHistogramInfo(taskId, &histogramInfo);
+            cliPrintf("%2d - %12s exec ", taskId, taskInfo.taskName);
+            for (int bucket = 0; bucket < TASK_HISTOGRAM_BUCKET_COUNT; bucket++) {
+                cliPrintf(" %7d", histogramInfo.executionTime.count[bucket]);
+            }
+            cliPrintLinefeed();
+            cliPrintf("                  jitter");
+            for (int bucket = 0; bucket < TASK_HISTOGRAM_BUCKET_COUNT; bucket++) {
+                cliPrintf(" %7d", histogramInfo.periodJitter.count[bucket]);
+            }
+            cliPrintLinefeed();
+        }
+    }
+}
+
 static void cliTasks(char *cmdline)
 {
-    UNUSED(cmdline);
     int maxLoadSum = 0;
     int averageLoadSum = 0;
     cfCheckFuncInfo_t checkFuncInfo;
 
-    cliPrintLinef("Task list         rate/hz  max/us  avg/us maxload avgload     total/ms");
+    if (sl_strcasecmp(cmdline, "reset") == 0) {
+        for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+            schedulerResetTaskStatistics(taskId);
+        }
+        return;
+    } else if (sl_strcasecmp(cmdline, "histogram") == 0) {
+        cliTasksHistogram();
+        return;
+    } else if (!isEmpty(cmdline)) {
+        cliShowParseError();
+        return;
+    }
+
+    cliPrintLinef("Scheduler mode: %s", schedulerGetMode() == SCHEDULER_MODE_EDF ? "EDF" : "PRIORITY");
+    cliPrintLinef("Task list         rate/hz  max/us  avg/us maxload avgload     total/ms maxlate/us avglate/us");
     for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
         cfTaskInfo_t taskInfo;
         getTaskInfo(taskId, &taskInfo);
@@ -3490,14 +3581,32 @@ static void cliTasks(char *cmdline)
                 maxLoadSum += maxLoad;
                 averageLoadSum += averageLoad;
             }
-            cliPrintLinef("%2d - %12s  %6d   %5d   %5d %4d.%1d%% %4d.%1d%%  %8d",
+            cliPrintLinef("%2d - %12s  %6d   %5d   %5d %4d.%1d%% %4d.%1d%%  %8d %10d %10d",
                     taskId, taskInfo.taskName, taskFrequency, (uint32_t)taskInfo.maxExecutionTime, (uint32_t)taskInfo.averageExecutionTime,
-                    maxLoad/10, maxLoad%10, averageLoad/10, averageLoad%10, (uint32_t)taskInfo.totalExecutionTime / 1000);
+                    maxLoad/10, maxLoad%10, averageLoad/10, averageLoad%10, (uint32_t)taskInfo.totalExecutionTime / 1000,
+                    (int)taskInfo.maxLateness, (int)taskInfo.averageLateness);
         }
     }
     getCheckFuncInfo(&checkFuncInfo);
     cliPrintLinef("Task check function %13d %7d %25d", (uint32_t)checkFuncInfo.maxExecutionTime, (uint32_t)checkFuncInfo.averageExecutionTime, (uint32_t)checkFuncInfo.totalExecutionTime / 1000);
     cliPrintLinef("Total (excluding SERIAL) %21d.%1d%% %4d.%1d%%", maxLoadSum/10, maxLoadSum%10, averageLoadSum/10, averageLoadSum%10);
+
+    cliPrintLinef("Task percentiles   exec p50/us p90/us p99/us  jitter p50/us p90/us p99/us");
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        cfTaskHistogramInfo_t histogramInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (taskInfo.isEnabled) {
+            getTaskHistogramInfo(taskId, &histogramInfo);
+            cliPrintLinef("%2d - %12s   %11d %6d %6d  %13d %6d %6d", taskId, taskInfo.taskName,
+                    (uint32_t)taskHistogramPercentile(&histogramInfo.executionTime, 50),
+                    (uint32_t)taskHistogramPercentile(&histogramInfo.executionTime, 90),
+                    (uint32_t)taskHistogramPercentile(&histogramInfo.executionTime, 99),
+                    (uint32_t)taskHistogramPercentile(&histogramInfo.periodJitter, 50),
+                    (uint32_t)taskHistogramPercentile(&histogramInfo.periodJitter, 90),
+                    (uint32_t)taskHistogramPercentile(&histogramInfo.periodJitter, 99));
+        }
+    }
 }
 #endif
 
@@ -3565,62 +3674,162 @@ static void backupConfigs(void)
     }
 }
 
-static void restoreConfigs(void)
+// Leaves the defaults in the PG copies and the actual config in place,
+// so the rest of the firmware keeps running with the actual values
+// while a dump is spread over several TASK_SERIAL runs.
+static void cacheDefaultConfigs(void)
 {
+    const int currentProfileIndexSave = getConfigProfile();
+    const int currentBatteryProfileIndexSave = getConfigBatteryProfile();
+
+    backupConfigs();
+    resetConfigs();
+
     PG_FOREACH(pg) {
-        if (pgIsProfile(pg)) {
-            memcpy(pg->address, pg->copy, pgSize(pg) * MAX_PROFILE_COUNT);
-        } else {
-            memcpy(pg->address, pg->copy, pgSize(pg));
+        const int size = pgIsProfile(pg) ? pgSize(pg) * MAX_PROFILE_COUNT : pgSize(pg);
+        for (int ii = 0; ii < size; ii++) {
+            const uint8_t value = pg->copy[ii];
+            pg->copy[ii] = pg->address[ii];
+            pg->address[ii] = value;
         }
     }
+
+    // resetConfigs() activated the default profiles
+    setConfigProfile(currentProfileIndexSave);
+    setConfigBatteryProfile(currentBatteryProfileIndexSave);
 }
 
-static void printConfig(const char *cmdline, bool doDiff)
+// Steps of a dump, in output order. Each one emits one section, the
+// tables and settings are emitted a few entries at a time.
+typedef enum {
+    CLI_DUMP_IDLE = 0,
+    CLI_DUMP_VERSION,
+    CLI_DUMP_MIXER,
+    CLI_DUMP_SERVO_MIX,
+    CLI_DUMP_SERVO,
+    CLI_DUMP_SAFEHOME,
+    CLI_DUMP_LOGIC,
+    CLI_DUMP_GVAR,
+    CLI_DUMP_PROGRAMMING_PID,
+    CLI_DUMP_FEATURE,
+    CLI_DUMP_BEEPER,
+    CLI_DUMP_BLACKBOX,
+    CLI_DUMP_MAP,
+    CLI_DUMP_SERIAL,
+    CLI_DUMP_LED,
+    CLI_DUMP_COLOR,
+    CLI_DUMP_MODE_COLOR,
+    CLI_DUMP_AUX,
+    CLI_DUMP_ADJRANGE,
+    CLI_DUMP_RXRANGE,
+    CLI_DUMP_TEMP_SENSOR,
+    CLI_DUMP_WAYPOINTS,
+    CLI_DUMP_OSD_LAYOUT,
+    CLI_DUMP_MASTER,
+    CLI_DUMP_MASTER_VALUES,
+    CLI_DUMP_PROFILE,
+    CLI_DUMP_PROFILE_VALUES,
+    CLI_DUMP_CONTROL_RATE_VALUES,
+    CLI_DUMP_BATTERY_PROFILE,
+    CLI_DUMP_BATTERY_PROFILE_VALUES,
+    CLI_DUMP_END,
+} cliDumpStep_e;
+
+// Output budget of a single cliProcess() call while dumping, in bytes
+#define CLI_DUMP_CHUNK_SIZE 256U
+// A dump is given up when the port takes no output for this long, e.g. a disconnected VCP
+#define CLI_DUMP_STALL_TIMEOUT_MS 2000
+
+typedef struct cliDumpState_s {
+    uint8_t step;
+    uint8_t dumpMask;
+    uint8_t index;                  // profile, battery profile or OSD layout being dumped
+    uint8_t lastIndex;
+    bool batchModeEnabled;
+    uint16_t settingIndex;          // setting cursor
+    uint16_t pgSettingsEnd;         // last setting of the cursor's PG
+    const pgRegistry_t *pg;         // PG of the setting cursor
+    uint16_t item;                  // table entry cursor
+    bool headerDone;                // section header of the step printed
+    uint32_t budget;
+    timeMs_t lastOutputMs;
+} cliDumpState_t;
+
+static cliDumpState_t cliDumpState;
+
+static bool cliDumpHasBudget(void)
 {
-    uint8_t dumpMask = DUMP_MASTER;
-    const char *options;
-    if ((options = checkCommand(cmdline, "master"))) {
-        dumpMask = DUMP_MASTER; // only
-    } else if ((options = checkCommand(cmdline, "profile"))) {
-        dumpMask = DUMP_PROFILE; // only
-    } else if ((options = checkCommand(cmdline, "battery_profile"))) {
-        dumpMask = DUMP_BATTERY_PROFILE; // only
-    } else if ((options = checkCommand(cmdline, "all"))) {
-        dumpMask = DUMP_ALL;   // all profiles and rates
-    } else {
-        options = cmdline;
-    }
+    bufWriterFlush(cliWriter);
+    return cliWriteCount < cliDumpState.budget;
+}
 
-    if (doDiff) {
-        dumpMask = dumpMask | DO_DIFF;
+// Prints the section header of the current step once, even when the step
+// is resumed. Returns true if it was printed by this call.
+static bool cliDumpHeader(const char *name)
+{
+    if (cliDumpState.headerDone) {
+        return false;
     }
+    cliPrintHashLine(name);
+    cliDumpState.headerDone = true;
+    return true;
+}
 
-    const int currentProfileIndexSave = getConfigProfile();
-    const int currentBatteryProfileIndexSave = getConfigBatteryProfile();
-    backupConfigs();
-    // reset all configs to defaults to do differencing
-    resetConfigs();
-    // restore the profile indices, since they should not be reset for proper comparison
-    setConfigProfile(currentProfileIndexSave);
-    setConfigBatteryProfile(currentBatteryProfileIndexSave);
+// Table steps print one entry per iteration, starting at the entry cursor.
+// Returns true while the table has entries left and there is budget for one.
+static bool cliDumpHasItem(uint16_t itemCount)
+{
+    return cliDumpState.item < itemCount && cliDumpHasBudget();
+}
 
-    if (checkCommand(options, "showdefaults")) {
-        dumpMask = dumpMask | SHOW_DEFAULTS;   // add default values as comments for changed values
+// Emits the settings of the given section for the given profile,
+// starting at the setting cursor. Returns false when the output budget
+// runs out, the next call resumes from the same setting. The PG is
+// resolved once per group of settings rather than once per setting.
+static bool cliDumpValues(uint16_t valueSection, uint8_t profileIndex)
+{
+    cliDumpState_t *state = &cliDumpState;
+
+    while (state->settingIndex < SETTINGS_TABLE_COUNT) {
+        if (!cliDumpHasBudget()) {
+            return false;
+        }
+        const setting_t *value = settingGet(state->settingIndex);
+        if (!state->pg || state->settingIndex > state->pgSettingsEnd) {
+            const pgn_t pgn = settingGetPgn(value);
+            settingsGetParameterGroupIndexes(pgn, NULL, &state->pgSettingsEnd);
+            state->pg = pgFind(pgn);
+        }
+        if (SETTING_SECTION(value) != valueSection) {
+            // Sections are assigned per PG, skip the whole group
+            state->settingIndex = state->pgSettingsEnd + 1;
+            continue;
+        }
+        const uint16_t offset = settingGetValueOffset(value, profileIndex);
+        dumpPgValue(value, state->pg->address + offset, state->pg->copy + offset, state->dumpMask);
+        state->settingIndex++;
     }
 
-#ifdef USE_CLI_BATCH
-    bool batchModeEnabled = false;
-#endif
+    state->settingIndex = 0;
+    state->pg = NULL;
+    return true;
+}
 
-    if ((dumpMask & DUMP_MASTER) || (dumpMask & DUMP_ALL)) {
+// Runs the current step. Returns false if it has to be resumed.
+static bool cliDumpStep(void)
+{
+    cliDumpState_t *state = &cliDumpState;
+    const uint8_t dumpMask = state->dumpMask;
+
+    switch (state->step) {
+    case CLI_DUMP_VERSION:
         cliPrintHashLine("version");
         cliVersion(NULL);
 
 #ifdef USE_CLI_BATCH
         cliPrintHashLine("start the command batch");
         cliPrintLine("batch start");
-        batchModeEnabled = true;
+        state->batchModeEnabled = true;
 #endif
 
         if ((dumpMask & (DUMP_ALL | DO_DIFF)) == (DUMP_ALL | DO_DIFF)) {
@@ -3633,138 +3842,414 @@ static void printConfig(const char *cmdline, bool doDiff)
 
         cliPrintHashLine("resources");
         //printResource(dumpMask, &defaultConfig);
+        break;
 
-        cliPrintHashLine("mixer");
-        cliDumpPrintLinef(dumpMask, primaryMotorMixer_CopyArray[0].throttle == 0.0f, "\r\nmmix reset\r\n");
-
-        printMotorMix(dumpMask, primaryMotorMixer_CopyArray, primaryMotorMixer(0));
+    case CLI_DUMP_MIXER:
+        if (cliDumpHeader("mixer")) {
+            cliDumpPrintLinef(dumpMask, primaryMotorMixer(0)->throttle == 0.0f, "\r\nmmix reset\r\n");
+        }
+        while (cliDumpHasItem(MAX_SUPPORTED_MOTORS)) {
+            if (primaryMotorMixer(state->item)->throttle == 0.0f) {
+                // The first unused rule ends the mixer
+                state->item = MAX_SUPPORTED_MOTORS;
+                break;
+            }
+            printMotorMixItem(dumpMask, primaryMotorMixer(0), primaryMotorMixer_CopyArray, state->item++);
+        }
+        return state->item == MAX_SUPPORTED_MOTORS;
 
+    case CLI_DUMP_SERVO_MIX:
         // print custom servo mixer if exists
-        cliPrintHashLine("servo mix");
-        cliDumpPrintLinef(dumpMask, customServoMixers_CopyArray[0].rate == 0, "smix reset\r\n");
-        printServoMix(dumpMask, customServoMixers_CopyArray, customServoMixers(0));
+        if (cliDumpHeader("servo mix")) {
+            cliDumpPrintLinef(dumpMask, customServoMixers(0)->rate == 0, "smix reset\r\n");
+        }
+        while (cliDumpHasItem(MAX_SERVO_RULES)) {
+            if (customServoMixers(state->item)->rate == 0) {
+                state->item = MAX_SERVO_RULES;
+                break;
+            }
+            printServoMixItem(dumpMask, customServoMixers(0), customServoMixers_CopyArray, state->item++);
+        }
+        return state->item == MAX_SERVO_RULES;
 
+    case CLI_DUMP_SERVO:
         // print servo parameters
-        cliPrintHashLine("servo");
-        printServo(dumpMask, servoParams_CopyArray, servoParams(0));
+        cliDumpHeader("servo");
+        while (cliDumpHasItem(MAX_SUPPORTED_SERVOS)) {
+            printServoItem(dumpMask, servoParams(0), servoParams_CopyArray, state->item++);
+        }
+        return state->item == MAX_SUPPORTED_SERVOS;
 
+    case CLI_DUMP_SAFEHOME:
 #if defined(USE_SAFE_HOME)
-        cliPrintHashLine("safehome");
-        printSafeHomes(dumpMask, safeHomeConfig_CopyArray, safeHomeConfig(0));
+        cliDumpHeader("safehome");
+        while (cliDumpHasItem(MAX_SAFE_HOMES)) {
+            printSafeHomeItem(dumpMask, safeHomeConfig(0), safeHomeConfig_CopyArray, state->item++);
+        }
+        return state->item == MAX_SAFE_HOMES;
+#else
+        break;
 #endif
+
+    case CLI_DUMP_LOGIC:
 #ifdef USE_PROGRAMMING_FRAMEWORK
-        cliPrintHashLine("logic");
-        printLogic(dumpMask, logicConditions_CopyArray, logicConditions(0));
+        cliDumpHeader("logic");
+        while (cliDumpHasItem(MAX_LOGIC_CONDITIONS)) {
+            printLogicItem(dumpMask, logicConditions(0), logicConditions_CopyArray, state->item++);
+        }
+        return state->item == MAX_LOGIC_CONDITIONS;
+#else
+        break;
+#endif
 
-        cliPrintHashLine("gvar");
-        printGvar(dumpMask, globalVariableConfigs_CopyArray, globalVariableConfigs(0));
+    case CLI_DUMP_GVAR:
+#ifdef USE_PROGRAMMING_FRAMEWORK
+        cliDumpHeader("gvar");
+        while (cliDumpHasItem(MAX_GLOBAL_VARIABLES)) {
+            printGvarItem(dumpMask, globalVariableConfigs(0), globalVariableConfigs_CopyArray, state->item++);
+        }
+        return state->item == MAX_GLOBAL_VARIABLES;
+#else
+        break;
+#endif
 
-        cliPrintHashLine("pid");
-        printPid(dumpMask, programmingPids_CopyArray, programmingPids(0));
+    case CLI_DUMP_PROGRAMMING_PID:
+#ifdef USE_PROGRAMMING_FRAMEWORK
+        cliDumpHeader("pid");
+        while (cliDumpHasItem(MAX_PROGRAMMING_PID_COUNT)) {
+            printPidItem(dumpMask, programmingPids(0), programmingPids_CopyArray, state->item++);
+        }
+        return state->item == MAX_PROGRAMMING_PID_COUNT;
+#else
+        break;
 #endif
 
-        cliPrintHashLine("feature");
-        printFeature(dumpMask, &featureConfig_Copy, featureConfig());
+    case CLI_DUMP_FEATURE:
+        // All of the features are disabled first, then the enabled ones are turned back on
+        cliDumpHeader("feature");
+        while (cliDumpHasItem(2 * FEATURE_NAME_COUNT)) {
+            const uint16_t feature = state->item % FEATURE_NAME_COUNT;
+            printFeatureItem(dumpMask, featureConfig(), &featureConfig_Copy, feature, state->item >= FEATURE_NAME_COUNT);
+            state->item++;
+        }
+        return state->item == 2 * FEATURE_NAME_COUNT;
 
+    case CLI_DUMP_BEEPER:
 #if defined(BEEPER) || defined(USE_DSHOT)
-        cliPrintHashLine("beeper");
-        printBeeper(dumpMask, &beeperConfig_Copy, beeperConfig());
+        cliDumpHeader("beeper");
+        while (cliDumpHasItem(beeperTableEntryCount() - 2)) {
+            printBeeperItem(dumpMask, beeperConfig(), &beeperConfig_Copy, state->item++);
+        }
+        return state->item == beeperTableEntryCount() - 2;
+#else
+        break;
 #endif
 
+    case CLI_DUMP_BLACKBOX:
 #ifdef USE_BLACKBOX
-        cliPrintHashLine("blackbox");
-        printBlackbox(dumpMask, &blackboxConfig_Copy, blackboxConfig());
+        cliDumpHeader("blackbox");
+        while (cliDumpHasItem(BLACKBOX_INCLUDE_FLAG_NAME_COUNT)) {
+            printBlackboxItem(dumpMask, blackboxConfig(), state->item++);
+        }
+        return state->item == BLACKBOX_INCLUDE_FLAG_NAME_COUNT;
+#else
+        break;
 #endif
 
+    case CLI_DUMP_MAP:
         cliPrintHashLine("map");
-        printMap(dumpMask, &rxConfig_Copy, rxConfig());
+        printMap(dumpMask, rxConfig(), &rxConfig_Copy);
+        break;
 
-        cliPrintHashLine("serial");
-        printSerial(dumpMask, &serialConfig_Copy, serialConfig());
+    case CLI_DUMP_SERIAL:
+        cliDumpHeader("serial");
+        while (cliDumpHasItem(SERIAL_PORT_COUNT)) {
+            printSerialItem(dumpMask, serialConfig(), &serialConfig_Copy, state->item++);
+        }
+        return state->item == SERIAL_PORT_COUNT;
 
+    case CLI_DUMP_LED:
 #ifdef USE_LED_STRIP
-        cliPrintHashLine("led");
-        printLed(dumpMask, ledStripConfig_Copy.ledConfigs, ledStripConfig()->ledConfigs);
+        cliDumpHeader("led");
+        while (cliDumpHasItem(LED_MAX_STRIP_LENGTH)) {
+            printLedItem(dumpMask, ledStripConfig()->ledConfigs, ledStripConfig_Copy.ledConfigs, state->item++);
+        }
+        return state->item == LED_MAX_STRIP_LENGTH;
+#else
+        break;
+#endif
 
-        cliPrintHashLine("color");
-        printColor(dumpMask, ledStripConfig_Copy.colors, ledStripConfig()->colors);
+    case CLI_DUMP_COLOR:
+#ifdef USE_LED_STRIP
+        cliDumpHeader("color");
+        while (cliDumpHasItem(LED_CONFIGURABLE_COLOR_COUNT)) {
+            printColorItem(dumpMask, ledStripConfig()->colors, ledStripConfig_Copy.colors, state->item++);
+        }
+        return state->item == LED_CONFIGURABLE_COLOR_COUNT;
+#else
+        break;
+#endif
 
-        cliPrintHashLine("mode_color");
-        printModeColor(dumpMask, &ledStripConfig_Copy, ledStripConfig());
+    case CLI_DUMP_MODE_COLOR:
+#ifdef USE_LED_STRIP
+        // The colors of every mode and direction, then the special colors
+        cliDumpHeader("mode_color");
+        while (cliDumpHasItem(LED_MODE_COUNT * LED_DIRECTION_COUNT + LED_SPECIAL_COLOR_COUNT)) {
+            if (state->item < LED_MODE_COUNT * LED_DIRECTION_COUNT) {
+                printModeColorItem(dumpMask, ledStripConfig(), &ledStripConfig_Copy, state->item / LED_DIRECTION_COUNT, state->item % LED_DIRECTION_COUNT);
+            } else {
+                printModeColorItem(dumpMask, ledStripConfig(), &ledStripConfig_Copy, LED_SPECIAL, state->item - LED_MODE_COUNT * LED_DIRECTION_COUNT);
+            }
+            state->item++;
+        }
+        return state->item == LED_MODE_COUNT * LED_DIRECTION_COUNT + LED_SPECIAL_COLOR_COUNT;
+#else
+        break;
 #endif
 
-        cliPrintHashLine("aux");
-        printAux(dumpMask, modeActivationConditions_CopyArray, modeActivationConditions(0));
+    case CLI_DUMP_AUX:
+        cliDumpHeader("aux");
+        while (cliDumpHasItem(MAX_MODE_ACTIVATION_CONDITION_COUNT)) {
+            printAuxItem(dumpMask, modeActivationConditions(0), modeActivationConditions_CopyArray, state->item++);
+        }
+        return state->item == MAX_MODE_ACTIVATION_CONDITION_COUNT;
 
-        cliPrintHashLine("adjrange");
-        printAdjustmentRange(dumpMask, adjustmentRanges_CopyArray, adjustmentRanges(0));
+    case CLI_DUMP_ADJRANGE:
+        cliDumpHeader("adjrange");
+        while (cliDumpHasItem(MAX_ADJUSTMENT_RANGE_COUNT)) {
+            printAdjustmentRangeItem(dumpMask, adjustmentRanges(0), adjustmentRanges_CopyArray, state->item++);
+        }
+        return state->item == MAX_ADJUSTMENT_RANGE_COUNT;
 
-        cliPrintHashLine("rxrange");
-        printRxRange(dumpMask, rxChannelRangeConfigs_CopyArray, rxChannelRangeConfigs(0));
+    case CLI_DUMP_RXRANGE:
+        cliDumpHeader("rxrange");
+        while (cliDumpHasItem(NON_AUX_CHANNEL_COUNT)) {
+            printRxRangeItem(dumpMask, rxChannelRangeConfigs(0), rxChannelRangeConfigs_CopyArray, state->item++);
+        }
+        return state->item == NON_AUX_CHANNEL_COUNT;
 
+    case CLI_DUMP_TEMP_SENSOR:
 #ifdef USE_TEMPERATURE_SENSOR
-        cliPrintHashLine("temp_sensor");
-        printTempSensor(dumpMask, tempSensorConfig_CopyArray, tempSensorConfig(0));
+        cliDumpHeader("temp_sensor");
+        while (cliDumpHasItem(MAX_TEMP_SENSORS)) {
+            printTempSensorItem(dumpMask, tempSensorConfig(0), tempSensorConfig_CopyArray, state->item++);
+        }
+        return state->item == MAX_TEMP_SENSORS;
+#else
+        break;
 #endif
 
+    case CLI_DUMP_WAYPOINTS:
 #if defined(NAV_NON_VOLATILE_WAYPOINT_STORAGE) && defined(NAV_NON_VOLATILE_WAYPOINT_CLI)
-        cliPrintHashLine("wp");
-        printWaypoints(dumpMask, posControl.waypointList, nonVolatileWaypointList(0));
+        if (cliDumpHeader("wp")) {
+            cliPrintLinef("#wp %d %svalid", posControl.waypointCount, posControl.waypointListValid ? "" : "in"); //int8_t bool
+        }
+        while (cliDumpHasItem(NAV_MAX_WAYPOINTS)) {
+            printWaypointItem(dumpMask, posControl.waypointList, nonVolatileWaypointList_CopyArray, state->item++);
+        }
+        return state->item == NAV_MAX_WAYPOINTS;
+#else
+        break;
 #endif
 
+    case CLI_DUMP_OSD_LAYOUT:
 #ifdef USE_OSD
-        cliPrintHashLine("osd_layout");
-        printOsdLayout(dumpMask, &osdLayoutsConfig_Copy, osdLayoutsConfig(), -1, -1);
+        // A full dump prints every item of every layout, resumed item by item
+        cliDumpHeader("osd_layout");
+        while (state->index < OSD_LAYOUT_COUNT) {
+            if (!cliDumpHasBudget()) {
+                return false;
+            }
+            printOsdLayoutItem(dumpMask, osdLayoutsConfig(), &osdLayoutsConfig_Copy, state->index, state->item);
+            if (++state->item == OSD_ITEM_COUNT) {
+                state->item = 0;
+                state->index++;
+            }
+        }
+        state->index = 0;
 #endif
+        break;
 
+    case CLI_DUMP_MASTER:
         cliPrintHashLine("master");
-        dumpAllValues(MASTER_VALUE, dumpMask);
+        break;
 
-        if (dumpMask & DUMP_ALL) {
-            // dump all profiles
-            const int currentProfileIndexSave = getConfigProfile();
-            const int currentBatteryProfileIndexSave = getConfigBatteryProfile();
-            for (int ii = 0; ii < MAX_PROFILE_COUNT; ++ii) {
-                cliDumpProfile(ii, dumpMask);
-            }
-            for (int ii = 0; ii < MAX_BATTERY_PROFILE_COUNT; ++ii) {
-                cliDumpBatteryProfile(ii, dumpMask);
-            }
-            setConfigProfile(currentProfileIndexSave);
-            setConfigBatteryProfile(currentBatteryProfileIndexSave);
+    case CLI_DUMP_MASTER_VALUES:
+        return cliDumpValues(MASTER_VALUE, 0);
 
+    case CLI_DUMP_PROFILE:
+        cliPrintHashLine("profile");
+        cliPrintLinef("profile %d\r\n", state->index + 1);
+        break;
+
+    case CLI_DUMP_PROFILE_VALUES:
+        return cliDumpValues(PROFILE_VALUE, state->index);
+
+    case CLI_DUMP_CONTROL_RATE_VALUES:
+        return cliDumpValues(CONTROL_RATE_VALUE, state->index);
+
+    case CLI_DUMP_BATTERY_PROFILE:
+        cliPrintHashLine("battery_profile");
+        cliPrintLinef("battery_profile %d\r\n", state->index + 1);
+        break;
+
+    case CLI_DUMP_BATTERY_PROFILE_VALUES:
+        return cliDumpValues(BATTERY_CONFIG_VALUE, state->index);
+
+    case CLI_DUMP_END:
+        if (dumpMask & DUMP_ALL) {
             cliPrintHashLine("restore original profile selection");
-            cliPrintLinef("profile %d", currentProfileIndexSave + 1);
-            cliPrintLinef("battery_profile %d", currentBatteryProfileIndexSave + 1);
+            cliPrintLinef("profile %d", getConfigProfile() + 1);
+            cliPrintLinef("battery_profile %d", getConfigBatteryProfile() + 1);
 
             cliPrintHashLine("save configuration\r\nsave");
+            state->batchModeEnabled = false;
+        }
+
 #ifdef USE_CLI_BATCH
-            batchModeEnabled = false;
+        if (state->batchModeEnabled) {
+            cliPrintHashLine("end the command batch");
+            cliPrintLine("batch end");
+        }
 #endif
+        break;
+    }
+
+    return true;
+}
+
+// Picks the step following a completed one
+static void cliDumpNextStep(void)
+{
+    cliDumpState_t *state = &cliDumpState;
+
+    state->item = 0;
+    state->headerDone = false;
+
+    switch (state->step) {
+    case CLI_DUMP_MASTER_VALUES:
+        state->step = CLI_DUMP_PROFILE;
+        if (state->dumpMask & DUMP_ALL) {
+            state->index = 0;
+            state->lastIndex = MAX_PROFILE_COUNT - 1;
+        } else {
+            state->index = state->lastIndex = getConfigProfile();
+        }
+        break;
+
+    case CLI_DUMP_CONTROL_RATE_VALUES:
+        if (state->index < state->lastIndex) {
+            state->index++;
+            state->step = CLI_DUMP_PROFILE;
+        } else if (state->dumpMask & DUMP_PROFILE) {
+            state->step = CLI_DUMP_END;
+        } else {
+            state->step = CLI_DUMP_BATTERY_PROFILE;
+            if (state->dumpMask & DUMP_ALL) {
+                state->index = 0;
+                state->lastIndex = MAX_BATTERY_PROFILE_COUNT - 1;
+            } else {
+                state->index = state->lastIndex = getConfigBatteryProfile();
+            }
+        }
+        break;
+
+    case CLI_DUMP_BATTERY_PROFILE_VALUES:
+        if (state->index < state->lastIndex) {
+            state->index++;
+            state->step = CLI_DUMP_BATTERY_PROFILE;
         } else {
-            // dump just the current profiles
-            cliDumpProfile(getConfigProfile(), dumpMask);
-            cliDumpBatteryProfile(getConfigBatteryProfile(), dumpMask);
+            state->step = CLI_DUMP_END;
         }
+        break;
+
+    case CLI_DUMP_END:
+        state->step = CLI_DUMP_IDLE;
+        break;
+
+    default:
+        state->step++;
+        break;
     }
+}
 
-    if (dumpMask & DUMP_PROFILE) {
-        cliDumpProfile(getConfigProfile(), dumpMask);
+STATIC_UNIT_TESTED bool cliDumpInProgress(void)
+{
+    return cliDumpState.step != CLI_DUMP_IDLE;
+}
+
+// Called from cliProcess() on every TASK_SERIAL run until the dump is
+// complete. Emits at most a chunk worth of output (plus the tail of
+// the last section) and never more than the port can buffer, so the
+// rest of the tasks are not held up by a slow link.
+static void cliDumpProcess(void)
+{
+    cliDumpState_t *state = &cliDumpState;
+
+    bufWriterFlush(cliWriter);
+    cliWriteCount = 0;
+    state->budget = MIN(serialTxBytesFree(cliPort), CLI_DUMP_CHUNK_SIZE);
+
+    if (state->budget == 0) {
+        // Nothing is draining the port, stop so the CLI takes input again
+        if (millis() - state->lastOutputMs > CLI_DUMP_STALL_TIMEOUT_MS) {
+            state->step = CLI_DUMP_IDLE;
+        }
+        return;
     }
+    state->lastOutputMs = millis();
 
-    if (dumpMask & DUMP_BATTERY_PROFILE) {
-        cliDumpBatteryProfile(getConfigBatteryProfile(), dumpMask);
+    while (state->step != CLI_DUMP_IDLE && cliDumpHasBudget()) {
+        if (cliDumpStep()) {
+            cliDumpNextStep();
+        }
     }
 
-#ifdef USE_CLI_BATCH
-    if (batchModeEnabled) {
-        cliPrintHashLine("end the command batch");
-        cliPrintLine("batch end");
+    if (state->step == CLI_DUMP_IDLE) {
+        cliPrompt();
+    }
+}
+
+static void printConfig(const char *cmdline, bool doDiff)
+{
+    uint8_t dumpMask = DUMP_MASTER;
+    const char *options;
+    if ((options = checkCommand(cmdline, "master"))) {
+        dumpMask = DUMP_MASTER; // only
+    } else if ((options = checkCommand(cmdline, "profile"))) {
+        dumpMask = DUMP_PROFILE; // only
+    } else if ((options = checkCommand(cmdline, "battery_profile"))) {
+        dumpMask = DUMP_BATTERY_PROFILE; // only
+    } else if ((options = checkCommand(cmdline, "all"))) {
+        dumpMask = DUMP_ALL;   // all profiles and rates
+    } else {
+        options = cmdline;
     }
-#endif
 
-    // restore configs from copies
-    restoreConfigs();
+    if (doDiff) {
+        dumpMask = dumpMask | DO_DIFF;
+    }
+
+    if (checkCommand(options, "showdefaults")) {
+        dumpMask = dumpMask | SHOW_DEFAULTS;   // add default values as comments for changed values
+    }
+
+    // The defaults are computed once per dump and compared against
+    // the actual values as the dump progresses
+    cacheDefaultConfigs();
+
+    memset(&cliDumpState, 0, sizeof(cliDumpState));
+    cliDumpState.dumpMask = dumpMask;
+    cliDumpState.lastOutputMs = millis();
+    if (dumpMask & (DUMP_MASTER | DUMP_ALL)) {
+        cliDumpState.step = CLI_DUMP_VERSION;
+    } else if (dumpMask & DUMP_PROFILE) {
+        cliDumpState.step = CLI_DUMP_PROFILE;
+        cliDumpState.index = cliDumpState.lastIndex = getConfigProfile();
+    } else {
+        cliDumpState.step = CLI_DUMP_BATTERY_PROFILE;
+        cliDumpState.index = cliDumpState.lastIndex = getConfigBatteryProfile();
+    }
 }
 
 static void cliDump(char *cmdline)
@@ -3942,7 +4427,7 @@ const clicmd_t cmdTable[] = {
 #endif
     CLI_COMMAND_DEF("status", "show status", NULL, cliStatus),
 #ifndef SKIP_TASK_STATISTICS
-    CLI_COMMAND_DEF("tasks", "show task stats", NULL, cliTasks),
+    CLI_COMMAND_DEF("tasks", "show task stats", "[histogram|reset]", cliTasks),
 #endif
 #ifdef USE_TEMPERATURE_SENSOR
     CLI_COMMAND_DEF("temp_sensor", "change temp sensor settings", NULL, cliTempSensor),
@@ -3983,6 +4468,12 @@ void cliProcess(void)
     // Be a little bit tricky.  Flush the last inputs buffer, if any.
     bufWriterFlush(cliWriter);
 
+    // Input is left in the port until a dump in progress is complete
+    if (cliDumpInProgress()) {
+        cliDumpProcess();
+        return;
+    }
+
     while (serialRxBytesWaiting(cliPort)) {
         uint8_t c = serialRead(cliPort);
         if (c == '\t' || c == '?') {
@@ -4067,6 +4558,11 @@ void cliProcess(void)
             if (!cliMode)
                 return;
 
+            // A dump prints the prompt once it's complete
+            if (cliDumpInProgress()) {
+                return;
+            }
+
             cliPrompt();
         } else if (c == 127) {
             // backspace
@@ -4092,7 +4588,7 @@ void cliEnter(serialPort_t *serialPort)
     cliMode = true;
     cliPort = serialPort;
     setPrintfSerialPort(cliPort);
-    cliWriter = bufWriterInit(cliWriteBuffer, sizeof(cliWriteBuffer), (bufWrite_t)serialWriteBufShim, serialPort);
+    cliWriter = bufWriterInit(cliWriteBuffer, sizeof(cliWriteBuffer), cliWriteBuf, serialPort);
 
 #ifndef CLI_MINIMAL_VERBOSITY
     cliPrintLine("\r\nEntering CLI Mode, type 'exit' to return, or 'help'");
@@ -77,6 +77,7 @@ typedef struct systemConfig_s {
     uint8_t cpuUnderclock;
 #endif
     uint8_t throttle_tilt_compensation_strength;    // the correction that will be applied at throttle_correction_angle.
+    uint8_t schedulerMode;                          // schedulerMode_e
     char name[MAX_NAME_LENGTH + 1];
 } systemConfig_t;
 
@@ -874,6 +874,7 @@ void taskMainPidLoop(timeUs_t currentTimeUs)
     if (rxConfig()->rcFilterFrequency) {
         rcInterpolationApply(isRXDataNew);
     }
+    rxLatencyMark(RX_LATENCY_RC_COMMAND);
 
     if (isRXDataNew) {
         updateWaypointsAndNavigationMode();
@@ -934,11 +935,12 @@ void taskMainPidLoop(timeUs_t currentTimeUs)
 
     if (motorControlEnable) {
         writeMotors();
+        rxLatencyMark(RX_LATENCY_MOTOR);
     }
 
 #ifdef USE_BLACKBOX
     if (!cliMode && feature(FEATURE_BLACKBOX)) {
-        blackboxUpdate(micros());
+        blackboxCaptureIteration(micros());
     }
 #endif
 }
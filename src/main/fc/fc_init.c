@@ -641,6 +641,14 @@ void init(void)
     blackboxInit();
 #endif
 
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    // The flash isn't up yet when navigationInit() loads the mission. Saving
+    // a mission to EEPROM drops the stored one, so this is the newer of the two.
+    if (navConfig()->general.waypoint_load_on_boot) {
+        loadStoredWaypointMission();
+    }
+#endif
+
     gyroStartCalibration();
 
 #ifdef USE_BARO
@@ -339,7 +339,7 @@ static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, uint16_t
  * Returns true if the command was processd, false otherwise.
  * May set mspPostProcessFunc to a function to be called once the command has been processed
  */
-static bool mspFcProcessOutCommand(uint16_t cmdMSP, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
+STATIC_UNIT_TESTED bool mspFcProcessOutCommand(uint16_t cmdMSP, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn)
 {
     switch (cmdMSP) {
     case MSP_API_VERSION:
@@ -850,6 +850,18 @@ static bool mspFcProcessOutCommand(uint16_t cmdMSP, sbuf_t *dst, mspPostProcessF
 
         break;
 
+    case MSP2_INAV_RX_LATENCY:
+        sbufWriteU8(dst, rxConfig()->receiverType);
+        sbufWriteU8(dst, rxConfig()->serialrx_provider);
+        sbufWriteU8(dst, rxConfig()->rcFilterFrequency);
+        sbufWriteU8(dst, RX_LATENCY_COUNT);
+        // Last and average for each stage, in us
+        for (int stage = 0; stage < RX_LATENCY_COUNT; stage++) {
+            sbufWriteU16(dst, constrain(rxGetLatencyUs(stage), 0, UINT16_MAX));
+            sbufWriteU16(dst, constrain(rxGetAverageLatencyUs(stage), 0, UINT16_MAX));
+        }
+        break;
+
     case MSP2_INAV_BATTERY_CONFIG:
 #ifdef USE_ADC
         sbufWriteU16(dst, batteryMetersConfig()->voltage.scale);
@@ -910,6 +922,7 @@ static bool mspFcProcessOutCommand(uint16_t cmdMSP, sbuf_t *dst, mspPostProcessF
         sbufWriteU8(dst, NAV_Status.error);
         //sbufWriteU16(dst,  (int16_t)(target_bearing/100));
         sbufWriteU16(dst, getHeadingHoldTarget());
+        sbufWriteU32(dst, distanceToMissionEnd());      // [cm], 0 unless flying a mission
         break;
 
 
@@ -1546,21 +1559,114 @@ static mspResult_e mspFcSafeHomeOutCommand(sbuf_t *dst, sbuf_t *src)
     }
 }
 
+#ifndef SKIP_TASK_STATISTICS
+/*
+ * Request: taskId (U8), optional flags (U8, bit 0 resets the task statistics after reading)
+ * Reply: taskId (U8), bucket count (U8), desired period (U32),
+ *        execution time buckets (U16 each), period jitter buckets (U16 each)
+ */
+static mspResult_e mspFcTaskHistogramCommand(sbuf_t *dst, sbuf_t *src)
+{
+    if (sbufBytesRemaining(src) < 1) {
+        return MSP_RESULT_ERROR;
+    }
+
+    const uint8_t taskId = sbufReadU8(src);
+    const uint8_t flags = sbufBytesRemaining(src) > 0 ? sbufReadU8(src) : 0;
+
+    if (taskId >= TASK_COUNT) {
+        return MSP_RESULT_ERROR;
+    }
+
+    cfTaskInfo_t taskInfo;
+    cfTaskHistogramInfo_t histogramInfo;
+    getTaskInfo(taskId, &taskInfo);
+    getTaskHistogramInfo(taskId, &histogramInfo);
+
+    sbufWriteU8(dst, taskId);
+    sbufWriteU8(dst, TASK_HISTOGRAM_BUCKET_COUNT);
+    sbufWriteU32(dst, taskInfo.desiredPeriod);
+    for (int bucket = 0; bucket < TASK_HISTOGRAM_BUCKET_COUNT; bucket++) {
+        sbufWriteU16(dst, histogramInfo.executionTime.count[bucket]);
+    }
+    for (int bucket = 0; bucket < TASK_HISTOGRAM_BUCKET_COUNT; bucket++) {
+        sbufWriteU16(dst, histogramInfo.periodJitter.count[bucket]);
+    }
+
+    if (flags & 0x01) {
+        schedulerResetTaskStatistics(taskId);
+    }
+
+    return MSP_RESULT_ACK;
+}
+#endif
+
+#define MSP_WP_SIZE     20  // Waypoint fields of MSP_WP and MSP_SET_WP, without the number
+
+static void mspWriteWaypoint(sbuf_t *dst, const navWaypoint_t *wp)
+{
+    sbufWriteU8(dst, wp->action);   // action (WAYPOINT)
+    sbufWriteU32(dst, wp->lat);     // lat
+    sbufWriteU32(dst, wp->lon);     // lon
+    sbufWriteU32(dst, wp->alt);     // altitude (cm)
+    sbufWriteU16(dst, wp->p1);      // P1
+    sbufWriteU16(dst, wp->p2);      // P2
+    sbufWriteU16(dst, wp->p3);      // P3
+    sbufWriteU8(dst, wp->flag);     // flags
+}
+
+static void mspReadWaypoint(sbuf_t *src, navWaypoint_t *wp)
+{
+    wp->action = sbufReadU8(src);   // action
+    wp->lat = sbufReadU32(src);     // lat
+    wp->lon = sbufReadU32(src);     // lon
+    wp->alt = sbufReadU32(src);     // to set altitude (cm)
+    wp->p1 = sbufReadU16(src);      // P1
+    wp->p2 = sbufReadU16(src);      // P2
+    wp->p3 = sbufReadU16(src);      // P3
+    wp->flag = sbufReadU8(src);     // future: to set nav flag
+}
+
 static void mspFcWaypointOutCommand(sbuf_t *dst, sbuf_t *src)
 {
     const uint8_t msp_wp_no = sbufReadU8(src);    // get the wp number
     navWaypoint_t msp_wp;
     getWaypoint(msp_wp_no, &msp_wp);
     sbufWriteU8(dst, msp_wp_no);   // wp_no
-    sbufWriteU8(dst, msp_wp.action);  // action (WAYPOINT)
-    sbufWriteU32(dst, msp_wp.lat);    // lat
-    sbufWriteU32(dst, msp_wp.lon);    // lon
-    sbufWriteU32(dst, msp_wp.alt);    // altitude (cm)
-    sbufWriteU16(dst, msp_wp.p1);     // P1
-    sbufWriteU16(dst, msp_wp.p2);     // P2
-    sbufWriteU16(dst, msp_wp.p3);     // P3
-    sbufWriteU8(dst, msp_wp.flag);    // flags
+    mspWriteWaypoint(dst, &msp_wp);
+}
+
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+/*
+ * Reads a mission stored in flash, as many waypoints per reply as fit.
+ * Request: first waypoint index (U16), waypoint count (U8)
+ * Reply: stored mission length (U16), first waypoint index (U16),
+ *        waypoints in the MSP_WP format without the number
+ */
+static mspResult_e mspFcWaypointBatchOutCommand(sbuf_t *dst, sbuf_t *src)
+{
+    uint16_t index;
+    uint8_t count;
+
+    if (!sbufReadU16Safe(&index, src) || !sbufReadU8Safe(&count, src)) {
+        return MSP_RESULT_ERROR;
+    }
+
+    const uint16_t storedCount = getStoredWaypointCount();
+    sbufWriteU16(dst, storedCount);
+    sbufWriteU16(dst, index);
+
+    for (; count > 0 && index < storedCount && sbufBytesRemaining(dst) >= MSP_WP_SIZE; count--, index++) {
+        navWaypoint_t wp;
+        if (!getStoredWaypoint(index, &wp)) {
+            return MSP_RESULT_ERROR;
+        }
+        mspWriteWaypoint(dst, &wp);
+    }
+
+    return MSP_RESULT_ACK;
 }
+#endif
 
 #ifdef USE_FLASHFS
 static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
@@ -1584,7 +1690,7 @@ static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
 }
 #endif
 
-static mspResult_e mspFcProcessInCommand(uint16_t cmdMSP, sbuf_t *src)
+STATIC_UNIT_TESTED mspResult_e mspFcProcessInCommand(uint16_t cmdMSP, sbuf_t *src)
 {
     uint8_t tmp_u8;
     uint16_t tmp_u16;
@@ -2477,14 +2583,7 @@ static mspResult_e mspFcProcessInCommand(uint16_t cmdMSP, sbuf_t *src)
         if (dataSize >= 21) {
             const uint8_t msp_wp_no = sbufReadU8(src);     // get the waypoint number
             navWaypoint_t msp_wp;
-            msp_wp.action = sbufReadU8(src);    // action
-            msp_wp.lat = sbufReadU32(src);      // lat
-            msp_wp.lon = sbufReadU32(src);      // lon
-            msp_wp.alt = sbufReadU32(src);      // to set altitude (cm)
-            msp_wp.p1 = sbufReadU16(src);       // P1
-            msp_wp.p2 = sbufReadU16(src);       // P2
-            msp_wp.p3 = sbufReadU16(src);       // P3
-            msp_wp.flag = sbufReadU8(src);      // future: to set nav flag
+            mspReadWaypoint(src, &msp_wp);
             setWaypoint(msp_wp_no, &msp_wp);
         } else
             return MSP_RESULT_ERROR;
@@ -2906,6 +3005,25 @@ static mspResult_e mspFcProcessInCommand(uint16_t cmdMSP, sbuf_t *src)
         return MSP_RESULT_ERROR; // will only be reached if the rollback is not ready
         break;
 #endif
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    case MSP2_INAV_SET_WP_BATCH:
+        // First waypoint index (U16), then waypoints in the MSP_SET_WP format without the number.
+        // Index 0 starts a new mission and NAV_WP_FLAG_LAST completes and loads it.
+        if (dataSize >= 2 + MSP_WP_SIZE && (dataSize - 2) % MSP_WP_SIZE == 0) {
+            uint16_t index = sbufReadU16(src);
+            while (sbufBytesRemaining(src) >= MSP_WP_SIZE) {
+                navWaypoint_t wp;
+                mspReadWaypoint(src, &wp);
+                if (!setStoredWaypoint(index++, &wp)) {
+                    return MSP_RESULT_ERROR;
+                }
+            }
+        } else {
+            return MSP_RESULT_ERROR;
+        }
+        break;
+#endif
+
     case MSP2_INAV_SET_SAFEHOME:
         if (dataSize == 10) {
              uint8_t i;
@@ -2921,7 +3039,7 @@ static mspResult_e mspFcProcessInCommand(uint16_t cmdMSP, sbuf_t *src)
         break;
 
     default:
-        return MSP_RESULT_ERROR;
+        return MSP_RESULT_CMD_UNKNOWN;
     }
     return MSP_RESULT_ACK;
 }
@@ -3157,6 +3275,321 @@ static bool mspParameterGroupsCommand(sbuf_t *dst, sbuf_t *src)
     return true;
 }
 
+// Which of the command processors above handles each command. Looking
+// up the command in these tables replaces trying each switch in turn,
+// so the cost of dispatching doesn't depend on the command. Every
+// case of mspFcProcessOutCommand(), mspFcProcessInCommand() and
+// mspFCProcessInOutCommand() must have its entry here, with the same
+// guards. msp_fc_unittest checks that they agree.
+
+// Commands are looked up in pages of 256 codes
+#define MSP_HANDLER_PAGE(cmd)   ((cmd) & 0xFF00)
+#define MSP_HANDLER_INDEX(cmd)  ((cmd) & 0x00FF)
+
+static const uint8_t mspV1Handlers[256] = {
+    [MSP_API_VERSION]                    = MSP_HANDLER_OUT,
+    [MSP_FC_VARIANT]                     = MSP_HANDLER_OUT,
+    [MSP_FC_VERSION]                     = MSP_HANDLER_OUT,
+    [MSP_BOARD_INFO]                     = MSP_HANDLER_OUT,
+    [MSP_BUILD_INFO]                     = MSP_HANDLER_OUT,
+#ifdef HIL
+    [MSP_HIL_STATE]                      = MSP_HANDLER_OUT,
+#endif
+    [MSP_SENSOR_STATUS]                  = MSP_HANDLER_OUT,
+    [MSP_ACTIVEBOXES]                    = MSP_HANDLER_OUT,
+    [MSP_STATUS_EX]                      = MSP_HANDLER_OUT,
+    [MSP_STATUS]                         = MSP_HANDLER_OUT,
+    [MSP_RAW_IMU]                        = MSP_HANDLER_OUT,
+    [MSP_SERVO]                          = MSP_HANDLER_OUT,
+    [MSP_SERVO_CONFIGURATIONS]           = MSP_HANDLER_OUT,
+    [MSP_SERVO_MIX_RULES]                = MSP_HANDLER_OUT,
+    [MSP_MOTOR]                          = MSP_HANDLER_OUT,
+    [MSP_RC]                             = MSP_HANDLER_OUT,
+    [MSP_ATTITUDE]                       = MSP_HANDLER_OUT,
+    [MSP_ALTITUDE]                       = MSP_HANDLER_OUT,
+    [MSP_SONAR_ALTITUDE]                 = MSP_HANDLER_OUT,
+    [MSP_ANALOG]                         = MSP_HANDLER_OUT,
+    [MSP_ARMING_CONFIG]                  = MSP_HANDLER_OUT,
+    [MSP_LOOP_TIME]                      = MSP_HANDLER_OUT,
+    [MSP_RC_TUNING]                      = MSP_HANDLER_OUT,
+    [MSP_PIDNAMES]                       = MSP_HANDLER_OUT,
+    [MSP_MODE_RANGES]                    = MSP_HANDLER_OUT,
+    [MSP_ADJUSTMENT_RANGES]              = MSP_HANDLER_OUT,
+    [MSP_BOXNAMES]                       = MSP_HANDLER_OUT,
+    [MSP_BOXIDS]                         = MSP_HANDLER_OUT,
+    [MSP_MISC]                           = MSP_HANDLER_OUT,
+    [MSP_MOTOR_PINS]                     = MSP_HANDLER_OUT,
+#ifdef USE_GPS
+    [MSP_RAW_GPS]                        = MSP_HANDLER_OUT,
+    [MSP_COMP_GPS]                       = MSP_HANDLER_OUT,
+    [MSP_NAV_STATUS]                     = MSP_HANDLER_OUT,
+    [MSP_GPSSVINFO]                      = MSP_HANDLER_OUT,
+    [MSP_GPSSTATISTICS]                  = MSP_HANDLER_OUT,
+#endif
+    [MSP_DEBUG]                          = MSP_HANDLER_OUT,
+    [MSP_UID]                            = MSP_HANDLER_OUT,
+    [MSP_FEATURE]                        = MSP_HANDLER_OUT,
+    [MSP_BOARD_ALIGNMENT]                = MSP_HANDLER_OUT,
+    [MSP_VOLTAGE_METER_CONFIG]           = MSP_HANDLER_OUT,
+    [MSP_CURRENT_METER_CONFIG]           = MSP_HANDLER_OUT,
+    [MSP_MIXER]                          = MSP_HANDLER_OUT,
+    [MSP_RX_CONFIG]                      = MSP_HANDLER_OUT,
+    [MSP_FAILSAFE_CONFIG]                = MSP_HANDLER_OUT,
+    [MSP_RSSI_CONFIG]                    = MSP_HANDLER_OUT,
+    [MSP_RX_MAP]                         = MSP_HANDLER_OUT,
+#ifdef USE_LED_STRIP
+    [MSP_LED_COLORS]                     = MSP_HANDLER_OUT,
+    [MSP_LED_STRIP_CONFIG]               = MSP_HANDLER_OUT,
+    [MSP_LED_STRIP_MODECOLOR]            = MSP_HANDLER_OUT,
+#endif
+    [MSP_DATAFLASH_SUMMARY]              = MSP_HANDLER_OUT,
+    [MSP_BLACKBOX_CONFIG]                = MSP_HANDLER_OUT,
+    [MSP_SDCARD_SUMMARY]                 = MSP_HANDLER_OUT,
+    [MSP_OSD_CONFIG]                     = MSP_HANDLER_OUT,
+    [MSP_3D]                             = MSP_HANDLER_OUT,
+    [MSP_RC_DEADBAND]                    = MSP_HANDLER_OUT,
+    [MSP_SENSOR_ALIGNMENT]               = MSP_HANDLER_OUT,
+    [MSP_ADVANCED_CONFIG]                = MSP_HANDLER_OUT,
+    [MSP_FILTER_CONFIG]                  = MSP_HANDLER_OUT,
+    [MSP_PID_ADVANCED]                   = MSP_HANDLER_OUT,
+    [MSP_INAV_PID]                       = MSP_HANDLER_OUT,
+    [MSP_SENSOR_CONFIG]                  = MSP_HANDLER_OUT,
+    [MSP_NAV_POSHOLD]                    = MSP_HANDLER_OUT,
+    [MSP_RTH_AND_LAND_CONFIG]            = MSP_HANDLER_OUT,
+    [MSP_FW_CONFIG]                      = MSP_HANDLER_OUT,
+    [MSP_CALIBRATION_DATA]               = MSP_HANDLER_OUT,
+    [MSP_POSITION_ESTIMATION_CONFIG]     = MSP_HANDLER_OUT,
+    [MSP_REBOOT]                         = MSP_HANDLER_OUT,
+    [MSP_WP_GETINFO]                     = MSP_HANDLER_OUT,
+    [MSP_TX_INFO]                        = MSP_HANDLER_OUT,
+    [MSP_RTC]                            = MSP_HANDLER_OUT,
+    [MSP_VTX_CONFIG]                     = MSP_HANDLER_OUT,
+    [MSP_NAME]                           = MSP_HANDLER_OUT,
+    [MSP_SELECT_SETTING]                 = MSP_HANDLER_IN,
+    [MSP_SET_HEAD]                       = MSP_HANDLER_IN,
+#ifdef USE_RX_MSP
+    [MSP_SET_RAW_RC]                     = MSP_HANDLER_IN,
+#endif
+    [MSP_SET_ARMING_CONFIG]              = MSP_HANDLER_IN,
+    [MSP_SET_LOOP_TIME]                  = MSP_HANDLER_IN,
+    [MSP_SET_MODE_RANGE]                 = MSP_HANDLER_IN,
+    [MSP_SET_ADJUSTMENT_RANGE]           = MSP_HANDLER_IN,
+    [MSP_SET_RC_TUNING]                  = MSP_HANDLER_IN,
+    [MSP_SET_MISC]                       = MSP_HANDLER_IN,
+    [MSP_SET_MOTOR]                      = MSP_HANDLER_IN,
+    [MSP_SET_SERVO_CONFIGURATION]        = MSP_HANDLER_IN,
+    [MSP_SET_SERVO_MIX_RULE]             = MSP_HANDLER_IN,
+    [MSP_SET_3D]                         = MSP_HANDLER_IN,
+    [MSP_SET_RC_DEADBAND]                = MSP_HANDLER_IN,
+    [MSP_SET_RESET_CURR_PID]             = MSP_HANDLER_IN,
+    [MSP_SET_SENSOR_ALIGNMENT]           = MSP_HANDLER_IN,
+    [MSP_SET_ADVANCED_CONFIG]            = MSP_HANDLER_IN,
+    [MSP_SET_FILTER_CONFIG]              = MSP_HANDLER_IN,
+    [MSP_SET_PID_ADVANCED]               = MSP_HANDLER_IN,
+    [MSP_SET_INAV_PID]                   = MSP_HANDLER_IN,
+    [MSP_SET_SENSOR_CONFIG]              = MSP_HANDLER_IN,
+    [MSP_SET_NAV_POSHOLD]                = MSP_HANDLER_IN,
+    [MSP_SET_RTH_AND_LAND_CONFIG]        = MSP_HANDLER_IN,
+    [MSP_SET_FW_CONFIG]                  = MSP_HANDLER_IN,
+    [MSP_SET_CALIBRATION_DATA]           = MSP_HANDLER_IN,
+    [MSP_SET_POSITION_ESTIMATION_CONFIG] = MSP_HANDLER_IN,
+    [MSP_RESET_CONF]                     = MSP_HANDLER_IN,
+    [MSP_ACC_CALIBRATION]                = MSP_HANDLER_IN,
+    [MSP_MAG_CALIBRATION]                = MSP_HANDLER_IN,
+    [MSP_EEPROM_WRITE]                   = MSP_HANDLER_IN,
+#ifdef USE_OSD
+    [MSP_SET_OSD_CONFIG]                 = MSP_HANDLER_IN,
+    [MSP_OSD_CHAR_WRITE]                 = MSP_HANDLER_IN,
+#endif // USE_OSD
+    [MSP_SET_VTX_CONFIG]                 = MSP_HANDLER_IN,
+#ifdef USE_FLASHFS
+    [MSP_DATAFLASH_ERASE]                = MSP_HANDLER_IN,
+#endif
+#ifdef USE_GPS
+    [MSP_SET_RAW_GPS]                    = MSP_HANDLER_IN,
+#endif
+    [MSP_SET_WP]                         = MSP_HANDLER_IN,
+    [MSP_SET_FEATURE]                    = MSP_HANDLER_IN,
+    [MSP_SET_BOARD_ALIGNMENT]            = MSP_HANDLER_IN,
+    [MSP_SET_VOLTAGE_METER_CONFIG]       = MSP_HANDLER_IN,
+    [MSP_SET_CURRENT_METER_CONFIG]       = MSP_HANDLER_IN,
+    [MSP_SET_MIXER]                      = MSP_HANDLER_IN,
+    [MSP_SET_RX_CONFIG]                  = MSP_HANDLER_IN,
+    [MSP_SET_FAILSAFE_CONFIG]            = MSP_HANDLER_IN,
+    [MSP_SET_RSSI_CONFIG]                = MSP_HANDLER_IN,
+    [MSP_SET_RX_MAP]                     = MSP_HANDLER_IN,
+#ifdef USE_LED_STRIP
+    [MSP_SET_LED_COLORS]                 = MSP_HANDLER_IN,
+    [MSP_SET_LED_STRIP_CONFIG]           = MSP_HANDLER_IN,
+    [MSP_SET_LED_STRIP_MODECOLOR]        = MSP_HANDLER_IN,
+#endif
+#ifdef NAV_NON_VOLATILE_WAYPOINT_STORAGE
+    [MSP_WP_MISSION_LOAD]                = MSP_HANDLER_IN,
+    [MSP_WP_MISSION_SAVE]                = MSP_HANDLER_IN,
+#endif
+    [MSP_SET_RTC]                        = MSP_HANDLER_IN,
+    [MSP_SET_TX_INFO]                    = MSP_HANDLER_IN,
+    [MSP_SET_NAME]                       = MSP_HANDLER_IN,
+    [MSP_WP]                             = MSP_HANDLER_IN_OUT,
+#if defined(USE_FLASHFS)
+    [MSP_DATAFLASH_READ]                 = MSP_HANDLER_IN_OUT,
+#endif
+    [MSP_SET_PASSTHROUGH]                = MSP_HANDLER_PASSTHROUGH,
+};
+
+static const uint8_t mspV2CommonHandlers[] = {
+    [MSP_HANDLER_INDEX(MSP2_COMMON_MOTOR_MIXER)]       = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SERIAL_CONFIG)]     = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_TZ)]                = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SET_MOTOR_MIXER)]   = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SET_RADAR_POS)]     = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SET_SERIAL_CONFIG)] = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SET_TZ)]            = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SETTING)]           = MSP_HANDLER_IN_OUT,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SET_SETTING)]       = MSP_HANDLER_IN_OUT,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SETTING_INFO)]      = MSP_HANDLER_IN_OUT,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_PG_LIST)]           = MSP_HANDLER_IN_OUT,
+    // Listed in MSP2_INAV_COMMAND_LIST, so clients can discover them
+    [MSP_HANDLER_INDEX(MSP2_COMMON_MULTI)]             = MSP_HANDLER_SERIAL,
+    [MSP_HANDLER_INDEX(MSP2_COMMON_SUBSCRIBE)]         = MSP_HANDLER_SERIAL,
+};
+
+static const uint8_t mspV2InavHandlers[] = {
+    [MSP_HANDLER_INDEX(MSP2_INAV_STATUS)]                  = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_SERVO_MIXER)]             = MSP_HANDLER_OUT,
+#ifdef USE_PROGRAMMING_FRAMEWORK
+    [MSP_HANDLER_INDEX(MSP2_INAV_LOGIC_CONDITIONS)]        = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_LOGIC_CONDITIONS_STATUS)] = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_GVAR_STATUS)]             = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_PROGRAMMING_PID)]         = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_PROGRAMMING_PID_STATUS)]  = MSP_HANDLER_OUT,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_INAV_OPTICAL_FLOW)]            = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_ANALOG)]                  = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_RATE_PROFILE)]            = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_PID)]                          = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_MISC)]                    = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_MISC2)]                   = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_RX_LATENCY)]              = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_BATTERY_CONFIG)]          = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_DEBUG)]                   = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_BLACKBOX_CONFIG)]              = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_AIR_SPEED)]               = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_MIXER)]                   = MSP_HANDLER_OUT,
+#if defined(USE_OSD)
+    [MSP_HANDLER_INDEX(MSP2_INAV_OSD_ALARMS)]              = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_OSD_PREFERENCES)]         = MSP_HANDLER_OUT,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_INAV_OUTPUT_MAPPING)]          = MSP_HANDLER_OUT,
+    [MSP_HANDLER_INDEX(MSP2_INAV_MC_BRAKING)]              = MSP_HANDLER_OUT,
+#ifdef USE_TEMPERATURE_SENSOR
+    [MSP_HANDLER_INDEX(MSP2_INAV_TEMP_SENSOR_CONFIG)]      = MSP_HANDLER_OUT,
+#endif
+#ifdef USE_TEMPERATURE_SENSOR
+    [MSP_HANDLER_INDEX(MSP2_INAV_TEMPERATURES)]            = MSP_HANDLER_OUT,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_SET_PID)]                      = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_RATE_PROFILE)]        = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_MISC)]                = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_BATTERY_CONFIG)]      = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_SERVO_MIXER)]         = MSP_HANDLER_IN,
+#ifdef USE_PROGRAMMING_FRAMEWORK
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_LOGIC_CONDITIONS)]    = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_PROGRAMMING_PID)]     = MSP_HANDLER_IN,
+#endif
+#ifdef USE_OPFLOW
+    [MSP_HANDLER_INDEX(MSP2_INAV_OPFLOW_CALIBRATION)]      = MSP_HANDLER_IN,
+#endif
+#ifdef USE_BLACKBOX
+    [MSP_HANDLER_INDEX(MSP2_SET_BLACKBOX_CONFIG)]          = MSP_HANDLER_IN,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_MIXER)]               = MSP_HANDLER_IN,
+#if defined(USE_OSD)
+    [MSP_HANDLER_INDEX(MSP2_INAV_OSD_SET_LAYOUT_ITEM)]     = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_OSD_SET_ALARMS)]          = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_OSD_SET_PREFERENCES)]     = MSP_HANDLER_IN,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_MC_BRAKING)]          = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_SELECT_BATTERY_PROFILE)]  = MSP_HANDLER_IN,
+#ifdef USE_TEMPERATURE_SENSOR
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_TEMP_SENSOR_CONFIG)]  = MSP_HANDLER_IN,
+#endif
+#ifdef MSP_FIRMWARE_UPDATE
+    [MSP_HANDLER_INDEX(MSP2_INAV_FWUPDT_PREPARE)]          = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_FWUPDT_STORE)]            = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_FWUPDT_EXEC)]             = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_FWUPDT_ROLLBACK_PREPARE)] = MSP_HANDLER_IN,
+    [MSP_HANDLER_INDEX(MSP2_INAV_FWUPDT_ROLLBACK_EXEC)]    = MSP_HANDLER_IN,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_SAFEHOME)]            = MSP_HANDLER_IN,
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    [MSP_HANDLER_INDEX(MSP2_INAV_SET_WP_BATCH)]            = MSP_HANDLER_IN,
+#endif
+#if defined(USE_OSD)
+    [MSP_HANDLER_INDEX(MSP2_INAV_OSD_LAYOUTS)]             = MSP_HANDLER_IN_OUT,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_INAV_SAFEHOME)]                = MSP_HANDLER_IN_OUT,
+#ifndef SKIP_TASK_STATISTICS
+    [MSP_HANDLER_INDEX(MSP2_INAV_TASK_HISTOGRAM)]          = MSP_HANDLER_IN_OUT,
+#endif
+    [MSP_HANDLER_INDEX(MSP2_INAV_COMMAND_LIST)]            = MSP_HANDLER_IN_OUT,
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    [MSP_HANDLER_INDEX(MSP2_INAV_WP_BATCH)]                = MSP_HANDLER_IN_OUT,
+#endif
+};
+
+typedef struct mspHandlerPage_s {
+    uint16_t base;
+    uint16_t count;
+    const uint8_t *handlers;
+} mspHandlerPage_t;
+
+static const mspHandlerPage_t mspHandlerPages[] = {
+    { .base = 0x0000, .count = ARRAYLEN(mspV1Handlers), .handlers = mspV1Handlers },
+    { .base = 0x1000, .count = ARRAYLEN(mspV2CommonHandlers), .handlers = mspV2CommonHandlers },     // MSP2_COMMON_*
+    { .base = 0x2000, .count = ARRAYLEN(mspV2InavHandlers), .handlers = mspV2InavHandlers },         // MSP2_INAV_*
+};
+
+STATIC_UNIT_TESTED mspHandler_e mspFcFindHandler(uint16_t cmdMSP)
+{
+    for (unsigned ii = 0; ii < ARRAYLEN(mspHandlerPages); ii++) {
+        const mspHandlerPage_t *page = &mspHandlerPages[ii];
+        if (MSP_HANDLER_PAGE(cmdMSP) == page->base) {
+            const unsigned index = MSP_HANDLER_INDEX(cmdMSP);
+            return index < page->count ? page->handlers[index] : MSP_HANDLER_NONE;
+        }
+    }
+    return MSP_HANDLER_NONE;
+}
+
+// Lists the supported commands in ascending order, starting at the
+// optional command in the payload. If they don't fit in a single
+// reply, the client asks again starting after the last one returned.
+// Sensor messages are not included, MSP2_COMMON_MULTI and
+// MSP2_COMMON_SUBSCRIBE are, although msp_serial.c handles them.
+static void mspCommandListCommand(sbuf_t *dst, sbuf_t *src)
+{
+    uint16_t start;
+
+    if (!sbufReadU16Safe(&start, src)) {
+        start = 0;
+    }
+
+    for (unsigned ii = 0; ii < ARRAYLEN(mspHandlerPages); ii++) {
+        const mspHandlerPage_t *page = &mspHandlerPages[ii];
+        for (unsigned jj = 0; jj < page->count; jj++) {
+            const uint16_t cmd = page->base + jj;
+            if (cmd < start || page->handlers[jj] == MSP_HANDLER_NONE) {
+                continue;
+            }
+            if (sbufBytesRemaining(dst) < 2) {
+                return;
+            }
+            sbufWriteU16(dst, cmd);
+        }
+    }
+}
+
 bool mspFCProcessInOutCommand(uint16_t cmdMSP, sbuf_t *dst, sbuf_t *src, mspResult_e *ret)
 {
     switch (cmdMSP) {
@@ -3224,6 +3657,23 @@ bool mspFCProcessInOutCommand(uint16_t cmdMSP, sbuf_t *dst, sbuf_t *src, mspResu
          *ret = mspFcSafeHomeOutCommand(dst, src);
          break;
 
+#ifndef SKIP_TASK_STATISTICS
+    case MSP2_INAV_TASK_HISTOGRAM:
+        *ret = mspFcTaskHistogramCommand(dst, src);
+        break;
+#endif
+
+    case MSP2_INAV_COMMAND_LIST:
+        mspCommandListCommand(dst, src);
+        *ret = MSP_RESULT_ACK;
+        break;
+
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    case MSP2_INAV_WP_BATCH:
+        *ret = mspFcWaypointBatchOutCommand(dst, src);
+        break;
+#endif
+
     default:
         // Not handled
         return false;
@@ -3288,16 +3738,33 @@ mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostPro
     // initialize reply by default
     reply->cmd = cmd->cmd;
 
-    if (MSP2_IS_SENSOR_MESSAGE(cmdMSP)) {
+    if ((cmd->flags & MSP_FLAG_OUT_ONLY) && (MSP2_IS_SENSOR_MESSAGE(cmdMSP) || mspFcFindHandler(cmdMSP) != MSP_HANDLER_OUT)) {
+        ret = MSP_RESULT_ERROR;
+    } else if (MSP2_IS_SENSOR_MESSAGE(cmdMSP)) {
         ret = mspProcessSensorCommand(cmdMSP, src);
-    } else if (mspFcProcessOutCommand(cmdMSP, dst, mspPostProcessFn)) {
-        ret = MSP_RESULT_ACK;
-    } else if (cmdMSP == MSP_SET_PASSTHROUGH) {
-        mspFcSetPassthroughCommand(dst, src, mspPostProcessFn);
-        ret = MSP_RESULT_ACK;
     } else {
-        if (!mspFCProcessInOutCommand(cmdMSP, dst, src, &ret)) {
+        switch (mspFcFindHandler(cmdMSP)) {
+        case MSP_HANDLER_OUT:
+            ret = mspFcProcessOutCommand(cmdMSP, dst, mspPostProcessFn) ? MSP_RESULT_ACK : MSP_RESULT_ERROR;
+            break;
+        case MSP_HANDLER_IN:
             ret = mspFcProcessInCommand(cmdMSP, src);
+            if (ret == MSP_RESULT_CMD_UNKNOWN) {
+                ret = MSP_RESULT_ERROR;
+            }
+            break;
+        case MSP_HANDLER_IN_OUT:
+            if (!mspFCProcessInOutCommand(cmdMSP, dst, src, &ret)) {
+                ret = MSP_RESULT_ERROR;
+            }
+            break;
+        case MSP_HANDLER_PASSTHROUGH:
+            mspFcSetPassthroughCommand(dst, src, mspPostProcessFn);
+            ret = MSP_RESULT_ACK;
+            break;
+        default:
+            ret = MSP_RESULT_ERROR;
+            break;
         }
     }
 
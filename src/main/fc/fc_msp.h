@@ -19,5 +19,15 @@
 
 #include "msp/msp.h"
 
+// Which of the command processors in fc_msp.c handles a command
+typedef enum {
+    MSP_HANDLER_NONE = 0,       // Unsupported command
+    MSP_HANDLER_OUT,            // mspFcProcessOutCommand()
+    MSP_HANDLER_IN,             // mspFcProcessInCommand()
+    MSP_HANDLER_IN_OUT,         // mspFCProcessInOutCommand()
+    MSP_HANDLER_PASSTHROUGH,    // mspFcSetPassthroughCommand()
+    MSP_HANDLER_SERIAL,         // Handled by msp_serial.c, never reaches mspFcProcessCommand()
+} mspHandler_e;
+
 void mspFcInit(void);
 mspResult_e mspFcProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
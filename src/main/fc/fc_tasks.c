@@ -21,6 +21,8 @@
 
 #include "platform.h"
 
+#include "blackbox/blackbox.h"
+
 #include "cms/cms.h"
 
 #include "common/axis.h"
@@ -259,6 +261,16 @@ void taskDashboardUpdate(timeUs_t currentTimeUs)
 }
 #endif
 
+#ifdef USE_BLACKBOX
+void taskBlackbox(timeUs_t currentTimeUs)
+{
+    // The PID loop takes no snapshots in CLI mode, the ones already queued wait until it's left
+    if (!cliMode) {
+        blackboxUpdate(currentTimeUs);
+    }
+}
+#endif
+
 #ifdef USE_TELEMETRY
 void taskTelemetry(timeUs_t currentTimeUs)
 {
@@ -313,16 +325,20 @@ void taskUpdateAux(timeUs_t currentTimeUs)
     updatePIDCoefficients();
     dynamicLpfGyroTask();
     updateFixedWingLevelTrim(currentTimeUs);
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    updateWaypointWindow();
+#endif
 }
 
 void fcTasksInit(void)
 {
+    schedulerSetMode(systemConfig()->schedulerMode);
     schedulerInit();
 
     rescheduleTask(TASK_PID, getLooptime());
     setTaskEnabled(TASK_PID, true);
 
-    rescheduleTask(TASK_GYRO, getGyroLooptime());
+    rescheduleTask(TASK_GYRO, gyroGetUpdateInterval());
     setTaskEnabled(TASK_GYRO, true);
 
     setTaskEnabled(TASK_AUX, true);
@@ -401,6 +417,11 @@ void fcTasksInit(void)
 #ifdef USE_SECONDARY_IMU
     setTaskEnabled(TASK_SECONDARY_IMU, secondaryImuConfig()->hardwareType != SECONDARY_IMU_NONE && secondaryImuState.active);
 #endif
+#ifdef USE_BLACKBOX
+    // Run as often as the PID loop, so a few snapshots are enough to absorb the delays
+    rescheduleTask(TASK_BLACKBOX, getLooptime());
+    setTaskEnabled(TASK_BLACKBOX, feature(FEATURE_BLACKBOX));
+#endif
 }
 
 cfTask_t cfTasks[TASK_COUNT] = {
@@ -644,6 +665,14 @@ cfTask_t cfTasks[TASK_COUNT] = {
         .desiredPeriod = TASK_PERIOD_HZ(RPM_FILTER_UPDATE_RATE_HZ),          // 300Hz @3,33ms
         .staticPriority = TASK_PRIORITY_LOW,
     },
+#endif
+#ifdef USE_BLACKBOX
+    [TASK_BLACKBOX] = {
+        .taskName = "BLACKBOX",
+        .taskFunc = taskBlackbox,
+        .desiredPeriod = TASK_PERIOD_US(1000),          // Rescheduled to the looptime
+        .staticPriority = TASK_PRIORITY_MEDIUM,
+    },
 #endif
     [TASK_AUX] = {
         .taskName = "AUX",
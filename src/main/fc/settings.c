@@ -3,7 +3,6 @@
 
 #include "platform.h"
 
-#include "common/string_light.h"
 #include "common/utils.h"
 
 #include "settings_generated.h"
@@ -105,23 +104,39 @@ bool settingNameContains(const setting_t *val, char *buf, const char *cmdline)
 	return strstr(buf, cmdline) != NULL;
 }
 
-bool settingNameIsExactMatch(const setting_t *val, char *buf, const char *cmdline, uint8_t var_name_length)
+// FNV-1a, must match NameHasher in utils/settings.rb
+static uint32_t settingNameHash(const char *name)
 {
-	settingGetName(val, buf);
-	return sl_strncasecmp(cmdline, buf, strlen(buf)) == 0 && var_name_length == strlen(buf);
+	uint32_t hash = 2166136261u;
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static unsigned settingNameHashSlot(uint32_t hash, uint8_t displacement)
+{
+	// murmur3 finalizer
+	hash ^= displacement * 0x9e3779b9u;
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+	return hash % SETTINGS_NAME_HASH_SLOT_COUNT;
 }
 
 const setting_t *settingFind(const char *name)
 {
+	// The generated perfect hash gives the only setting which might
+	// have this name, so just one name needs to be decoded
+	const uint32_t hash = settingNameHash(name);
+	const uint8_t displacement = settingNameHashDisplacements[hash % SETTINGS_NAME_HASH_BUCKET_COUNT];
+	const setting_t *setting = &settingsTable[settingNameHashSlots[settingNameHashSlot(hash, displacement)]];
 	char buf[SETTING_MAX_NAME_LENGTH];
-	for (int ii = 0; ii < SETTINGS_TABLE_COUNT; ii++) {
-		const setting_t *setting = &settingsTable[ii];
-		settingGetName(setting, buf);
-		if (strcmp(buf, name) == 0) {
-			return setting;
-		}
-	}
-	return NULL;
+	settingGetName(setting, buf);
+	return strcmp(buf, name) == 0 ? setting : NULL;
 }
 
 const setting_t *settingGet(unsigned index)
@@ -228,31 +243,33 @@ pgn_t settingGetPgn(const setting_t *val)
 	return -1;
 }
 
-static uint16_t getValueOffset(const setting_t *value)
+uint16_t settingGetValueOffset(const setting_t *val, uint8_t profileIndex)
 {
-    switch (SETTING_SECTION(value)) {
+    switch (SETTING_SECTION(val)) {
     case MASTER_VALUE:
-        return value->offset;
+        return val->offset;
     case PROFILE_VALUE:
-        return value->offset + sizeof(pidProfile_t) * getConfigProfile();
+        return val->offset + sizeof(pidProfile_t) * profileIndex;
     case CONTROL_RATE_VALUE:
-        return value->offset + sizeof(controlRateConfig_t) * getConfigProfile();
+        return val->offset + sizeof(controlRateConfig_t) * profileIndex;
     case BATTERY_CONFIG_VALUE:
-        return value->offset + sizeof(batteryProfile_t) * getConfigBatteryProfile();
+        return val->offset + sizeof(batteryProfile_t) * profileIndex;
     }
     return 0;
 }
 
-void *settingGetValuePointer(const setting_t *val)
+static uint16_t getValueOffset(const setting_t *value)
 {
-    const pgRegistry_t *pg = pgFind(settingGetPgn(val));
-    return pg->address + getValueOffset(val);
+    if (SETTING_SECTION(value) == BATTERY_CONFIG_VALUE) {
+        return settingGetValueOffset(value, getConfigBatteryProfile());
+    }
+    return settingGetValueOffset(value, getConfigProfile());
 }
 
-const void * settingGetCopyValuePointer(const setting_t *val)
+void *settingGetValuePointer(const setting_t *val)
 {
     const pgRegistry_t *pg = pgFind(settingGetPgn(val));
-    return pg->copy + getValueOffset(val);
+    return pg->address + getValueOffset(val);
 }
 
 setting_min_t settingGetMin(const setting_t *val)
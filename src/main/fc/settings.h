@@ -73,7 +73,6 @@ static inline setting_mode_e SETTING_MODE(const setting_t *s) { return (setting_
 
 void settingGetName(const setting_t *val, char *buf);
 bool settingNameContains(const setting_t *val, char *buf, const char *cmdline);
-bool settingNameIsExactMatch(const setting_t *val, char *buf, const char *cmdline, uint8_t var_name_length);
 // Returns a setting_t with the exact name (case sensitive), or
 // NULL if no setting with that name exists.
 const setting_t *settingFind(const char *name);
@@ -89,14 +88,14 @@ bool settingsValidate(unsigned *invalidIndex);
 // Returns the size in bytes of the setting value.
 size_t settingGetValueSize(const setting_t *val);
 pgn_t settingGetPgn(const setting_t *val);
+// Returns the offset of the value inside its parameter group storage
+// for the given profile index. The index refers to the battery profile
+// for BATTERY_CONFIG_VALUE settings, to the profile for PROFILE_VALUE
+// and CONTROL_RATE_VALUE ones and it's ignored for MASTER_VALUE.
+uint16_t settingGetValueOffset(const setting_t *val, uint8_t profileIndex);
 // Returns a pointer to the actual value stored by
 // the setting_t. The returned value might be modified.
 void * settingGetValuePointer(const setting_t *val);
-// Returns a pointer to the backed up copy of the value. Note that
-// this will contain random garbage unless a copy of the parameter
-// group for the value has been manually performed. Currently, this
-// is only used by cli.c during config dumps.
-const void * settingGetCopyValuePointer(const setting_t *val);
 // Returns the minimum valid value for the given setting_t. setting_min_t
 // depends on the target and build options, but will always be a signed
 // integer (e.g. intxx_t,)
@@ -36,12 +36,6 @@ FILE_COMPILE_FOR_SPEED
 
 void dynamicGyroNotchFiltersInit(dynamicGyroNotchState_t *state) {
 
-    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
-            state->filtersApplyFn[axis][i] = nullFilterApply;
-        }
-    }
-
     state->dynNotchQ = gyroConfig()->dynamicGyroNotchQ / 100.0f;
     state->enabled = gyroConfig()->dynamicGyroNotchEnabled;
     state->looptime = getLooptime();
@@ -54,7 +48,6 @@ void dynamicGyroNotchFiltersInit(dynamicGyroNotchState_t *state) {
             //Any initial notch Q is valid sice it will be updated immediately after
             for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
                 biquadFilterInit(&state->filters[axis][i], DYNAMIC_NOTCH_DEFAULT_CENTER_HZ, state->looptime, 1.0f, FILTER_NOTCH);
-                state->filtersApplyFn[axis][i] = (filterApplyFnPtr)biquadFilterApplyDF1;
             }
         
         }
@@ -84,11 +77,11 @@ float dynamicGyroNotchFiltersApply(dynamicGyroNotchState_t *state, int axis, flo
     float output = input; 
 
     /*
-     * We always apply all filters. If a filter dimension is disabled, one of
-     * the function pointers will be a null apply function
+     * Only called when the dynamic notch is enabled, so all the filters are
+     * initialized and applied directly, without going through a pointer
      */
     for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
-        output = state->filtersApplyFn[axis][i]((filter_t *)&state->filters[axis][i], output);
+        output = biquadFilterApplyDF1(&state->filters[axis][i], output);
     }
 
     return output;
@@ -46,20 +46,38 @@ FILE_COMPILE_FOR_SPEED
 
 #include "gyroanalyse.h"
 
+#include "arm_common_tables.h"
+
+/*
+ * One step runs on each call and handles at most FFT_STEP_BINS points, so
+ * the work per PID loop stays bounded whatever the window size:
+ * - window one block of samples and run its complex FFT
+ * - radix-2 butterflies joining the blocks into the full complex FFT
+ * - split the complex FFT into the spectrum of the real samples
+ * - magnitude of the bins, searching the peaks among the finished ones
+ * - update the filter frequencies of the axis
+ */
 enum {
-    STEP_ARM_CFFT_F32,
-    STEP_BITREVERSAL_AND_STAGE_RFFT_F32,
-    STEP_MAGNITUDE_AND_FREQUENCY,
-    STEP_UPDATE_FILTERS_AND_HANNING,
+    STEP_WINDOW_AND_CFFT,
+    STEP_COMBINE = STEP_WINDOW_AND_CFFT + FFT_STEP_BLOCKS,
+    STEP_STAGE_RFFT = STEP_COMBINE + FFT_COMBINE_STEP_COUNT,
+    STEP_MAGNITUDE = STEP_STAGE_RFFT + FFT_STEP_BLOCKS,
+    STEP_UPDATE_FILTERS = STEP_MAGNITUDE + FFT_STEP_BLOCKS,
     STEP_COUNT
 };
 
+// Complex FFT of one block, the tables are the ones arm_rfft_fast_init_f32() uses for 64 samples
+static const arm_cfft_instance_f32 fftBlockInstance = {
+    .fftLen = FFT_STEP_BINS,
+    .pTwiddle = twiddleCoef_32,
+    .pBitRevTable = armBitRevIndexTable32,
+    .bitRevLength = ARMBITREVINDEXTABLE_32_TABLE_LENGTH,
+};
+
 // The FFT splits the frequency domain into an number of bins
-// A sampling frequency of 1000 and max frequency of 500 at a window size of 32 gives 16 frequency bins each 31.25Hz wide
-// Eg [0,31), [31,62), [62, 93) etc
-// for gyro loop >= 4KHz, sample rate 2000 defines FFT range to 1000Hz, 16 bins each 62.5 Hz wide
-// NB  FFT_WINDOW_SIZE is set to 32 in gyroanalyse.h
-#define FFT_BIN_COUNT             (FFT_WINDOW_SIZE / 2)
+// A sampling frequency of 1000 and max frequency of 500 at a window size of 64 gives 32 frequency bins each 15.6Hz wide
+// Eg [0,15.6), [15.6,31.2), [31.2, 46.8) etc
+// A window size of 128 gives 64 bins, each 7.8Hz wide, and 256 gives 128 bins, each 3.9Hz wide
 // smoothing frequency for FFT centre frequency
 #define DYN_NOTCH_SMOOTH_FREQ_HZ  25
 
@@ -70,26 +88,55 @@ enum {
  */
 #define FFT_SAMPLING_DENOMINATOR 2
 
+STATIC_ASSERT(FFT_SAMPLING_DENOMINATOR >= FFT_STEP_BLOCKS / 2, fft_window_changes_while_windowing);
+
+static void gyroDataAnalyseSdftInit(gyroAnalyseState_t *state, uint16_t maxFrequency, uint32_t targetLooptimeUs)
+{
+    // Runs at the full PID rate, the resolution is set by the window size
+    state->sdft.resolution = 1e6f / targetLooptimeUs / SDFT_SAMPLE_SIZE;
+    state->maxFrequency = MIN(maxFrequency, lrintf(state->sdft.resolution * (SDFT_BIN_COUNT - 2)));
+
+    const uint8_t startBin = MAX(1, lrintf(state->minFrequency / state->sdft.resolution));
+    const uint8_t endBin = MIN(SDFT_BIN_COUNT - 2, lrintf(state->maxFrequency / state->sdft.resolution));
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sdftInit(&state->sdft.axis[axis], startBin, endBin);
+
+        for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
+            state->centerFrequency[axis][i] = state->maxFrequency;
+            pt1FilterInit(&state->detectedFrequencyFilter[axis][i], DYN_NOTCH_SMOOTH_FREQ_HZ, targetLooptimeUs * 1e-6f);
+        }
+    }
+}
+
 void gyroDataAnalyseStateInit(
     gyroAnalyseState_t *state, 
+    uint8_t mode,
     uint16_t minFrequency,
+    uint16_t maxFrequency,
     uint32_t targetLooptimeUs
 ) {
+    state->mode = mode;
     state->minFrequency = minFrequency;
 
-    state->fftSamplingRateHz = 1e6f / targetLooptimeUs / FFT_SAMPLING_DENOMINATOR;
-    state->maxFrequency = state->fftSamplingRateHz / 2; //max possible frequency is half the sampling rate
-    state->fftResolution = (float)state->maxFrequency / FFT_BIN_COUNT;
+    if (state->mode == DYNAMIC_NOTCH_MODE_SDFT) {
+        gyroDataAnalyseSdftInit(state, maxFrequency, targetLooptimeUs);
+        return;
+    }
 
-    state->fftStartBin = state->minFrequency / lrintf(state->fftResolution);
+    state->fft.samplingRateHz = 1e6f / targetLooptimeUs / FFT_SAMPLING_DENOMINATOR;
+    state->maxFrequency = state->fft.samplingRateHz / 2; //max possible frequency is half the sampling rate
+    state->fft.resolution = (float)state->maxFrequency / FFT_BIN_COUNT;
+
+    state->fft.startBin = lrintf(state->minFrequency / state->fft.resolution);
 
     for (int i = 0; i < FFT_WINDOW_SIZE; i++) {
-        state->hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (FFT_WINDOW_SIZE - 1)));
+        state->fft.hanningWindow[i] = (0.5f - 0.5f * cos_approx(2 * M_PIf * i / (FFT_WINDOW_SIZE - 1)));
     }
 
-    arm_rfft_fast_init_f32(&state->fftInstance, FFT_WINDOW_SIZE);
+    arm_rfft_fast_init_f32(&state->fft.instance, FFT_WINDOW_SIZE);
 
-    // Frequency filter is executed every 12 cycles. 4 steps per cycle, 3 axises
+    // Frequency filter is executed once every STEP_COUNT cycles for each of the 3 axises
     const uint32_t filterUpdateUs = targetLooptimeUs * STEP_COUNT * XYZ_AXIS_COUNT;
 
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
@@ -110,21 +157,46 @@ void gyroDataAnalysePush(gyroAnalyseState_t *state, const int axis, const float
 static void gyroDataAnalyseUpdate(gyroAnalyseState_t *state);
 
 /*
- * Collect gyro data, to be analysed in gyroDataAnalyseUpdate function
+ * Sliding DFT: the spectrum of every axis is updated with each sample, so
+ * the peaks of all the axes are tracked on every call
  */
-void gyroDataAnalyse(gyroAnalyseState_t *state)
+static void gyroDataAnalyseSdft(gyroAnalyseState_t *state)
 {
-    state->filterUpdateExecute = false; //This will be changed to true only if new data is present
+    sdftPeak_t peaks[DYN_NOTCH_PEAK_COUNT];
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sdftPush(&state->sdft.axis[axis], state->currentSample[axis]);
+        sdftWindowedMagnitudeSq(&state->sdft.axis[axis], state->sdft.magnitudeSq);
+        sdftFindPeaks(&state->sdft.axis[axis], state->sdft.magnitudeSq, peaks, DYN_NOTCH_PEAK_COUNT);
 
+        for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
+            if (peaks[i].value > 0.0f) {
+                const float frequency = peaks[i].bin * state->sdft.resolution;
+                state->centerFrequency[axis][i] = pt1FilterApply(&state->detectedFrequencyFilter[axis][i], frequency);
+            } else {
+                state->centerFrequency[axis][i] = 0.0f;
+            }
+        }
+    }
+
+    state->filterUpdateExecute = true;
+    state->filterUpdateAxisMask = BIT(FD_ROLL) | BIT(FD_PITCH) | BIT(FD_YAW);
+}
+
+/*
+ * Downsample the gyro data and run the next FFT step
+ */
+static void gyroDataAnalyseFft(gyroAnalyseState_t *state)
+{
     static uint8_t samplingIndex = 0;
 
     if (samplingIndex == 0) {
         // calculate mean value of accumulated samples
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            state->downsampledGyroData[axis][state->circularBufferIdx] = state->currentSample[axis];
+            state->fft.downsampledGyroData[axis][state->fft.circularBufferIdx] = state->currentSample[axis];
         }
 
-        state->circularBufferIdx = (state->circularBufferIdx + 1) % FFT_WINDOW_SIZE;
+        state->fft.circularBufferIdx = (state->fft.circularBufferIdx + 1) % FFT_WINDOW_SIZE;
     }
 
     samplingIndex = (samplingIndex + 1) % FFT_SAMPLING_DENOMINATOR;
@@ -132,17 +204,44 @@ void gyroDataAnalyse(gyroAnalyseState_t *state)
     gyroDataAnalyseUpdate(state);
 }
 
-void stage_rfft_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut);
-void arm_cfft_radix8by4_f32(arm_cfft_instance_f32 *S, float32_t *p1);
-void arm_bitreversal_32(uint32_t *pSrc, const uint16_t bitRevLen, const uint16_t *pBitRevTable);
+/*
+ * Collect gyro data, to be analysed in gyroDataAnalyseUpdate function
+ */
+void gyroDataAnalyse(gyroAnalyseState_t *state)
+{
+    const timeUs_t startTimeUs = micros();
+    const uint8_t step = state->updateStep;
+
+    state->filterUpdateExecute = false; //This will be changed to true only if new data is present
+
+    if (state->mode == DYNAMIC_NOTCH_MODE_SDFT) {
+        gyroDataAnalyseSdft(state);
+    } else {
+        gyroDataAnalyseFft(state);
+    }
+
+    // Time budget of the analysis, a cycle covers all the steps for one axis
+    state->lastStepTimeUs = micros() - startTimeUs;
+    state->maxStepTimeUs = MAX(state->maxStepTimeUs, state->lastStepTimeUs);
+    state->cycleTimeUs += state->lastStepTimeUs;
+    if (state->updateStep == 0) {
+        state->lastCycleTimeUs = state->cycleTimeUs;
+        state->cycleTimeUs = 0;
+    }
+
+    DEBUG_SET(DEBUG_FFT_TIME, 0, step);
+    DEBUG_SET(DEBUG_FFT_TIME, 1, state->lastStepTimeUs);
+    DEBUG_SET(DEBUG_FFT_TIME, 2, state->maxStepTimeUs);
+    DEBUG_SET(DEBUG_FFT_TIME, 3, state->lastCycleTimeUs);
+}
 
-static float computeParabolaMean(gyroAnalyseState_t *state, uint8_t peakBinIndex) {
+static float computeParabolaMean(gyroAnalyseState_t *state, int peakBinIndex) {
     float preciseBin = peakBinIndex;
 
     // Height of peak bin (y1) and shoulder bins (y0, y2)
-    const float y0 = state->fftData[peakBinIndex - 1];
-    const float y1 = state->fftData[peakBinIndex];
-    const float y2 = state->fftData[peakBinIndex - 1];
+    const float y0 = state->fft.data[peakBinIndex - 1];
+    const float y1 = state->fft.data[peakBinIndex];
+    const float y2 = state->fft.data[peakBinIndex + 1];
 
     // Estimate true peak position aka. preciseBin (fit parabola y(x) over y0, y1 and y2, solve dy/dx=0 for x)
     const float denom = 2.0f * (y0 - 2 * y1 + y2);
@@ -154,112 +253,213 @@ static float computeParabolaMean(gyroAnalyseState_t *state, uint8_t peakBinIndex
 }
 
 /*
- * Analyse last gyro data from the last FFT_WINDOW_SIZE milliseconds
+ * Decimation in time: block b holds the complex samples n = FFT_STEP_BLOCKS * m + r,
+ * with r the bit reversed b, so the radix-2 levels can join neighbouring blocks.
+ *
+ * The window starts at the oldest sample. New samples arriving while the
+ * blocks are windowed replace the oldest ones, at most two with 4 blocks and
+ * FFT_SAMPLING_DENOMINATOR 2. They all belong to complex sample 0, which block
+ * 0 has already read, so every block sees the same window.
  */
-static NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
+static void gyroDataAnalyseWindowAndCfft(gyroAnalyseState_t *state, int block)
 {
+    const int r = FFT_STEP_BLOCKS == 4 ? ((block & 1) << 1) | (block >> 1) : block;
+    const float *gyroData = state->fft.downsampledGyroData[state->updateAxis];
+    float *blockData = &state->fft.data[2 * FFT_STEP_BINS * block];
 
-    arm_cfft_instance_f32 *Sint = &(state->fftInstance.Sint);
+    if (block == 0) {
+        state->fft.windowStartIdx = state->fft.circularBufferIdx;
+    }
 
-    switch (state->updateStep) {
-        case STEP_ARM_CFFT_F32:
-        {
-            // Important this works only with FFT windows size of 64 elements!
-            arm_cfft_radix8by4_f32(Sint, state->fftData);
-            break;
-        }
-        case STEP_BITREVERSAL_AND_STAGE_RFFT_F32:
-        {
-            arm_bitreversal_32((uint32_t*) state->fftData, Sint->bitRevLength, Sint->pBitRevTable);
-            stage_rfft_f32(&state->fftInstance, state->fftData, state->rfftData);
-            break;
+    // hanning starts and ends with 0, could be skipped for minor speed improvement
+    for (int m = 0; m < FFT_STEP_BINS; m++) {
+        const int n = 2 * (FFT_STEP_BLOCKS * m + r);
+        const int idx = (state->fft.windowStartIdx + n) % FFT_WINDOW_SIZE;
+        blockData[2 * m] = gyroData[idx] * state->fft.hanningWindow[n];
+        blockData[2 * m + 1] = gyroData[(idx + 1) % FFT_WINDOW_SIZE] * state->fft.hanningWindow[n + 1];
+    }
+
+    arm_cfft_f32(&fftBlockInstance, blockData, 0, 1);
+}
+
+#if FFT_COMBINE_LEVELS > 0
+/*
+ * FFT_STEP_BINS radix-2 butterflies, X[k] = A[k] + W^k B[k] and
+ * X[k + M/2] = A[k] - W^k B[k] for the transforms A and B of M/2 points
+ */
+static void gyroDataAnalyseCombine(gyroAnalyseState_t *state, int combineStep)
+{
+    const int stepsPerLevel = FFT_BIN_COUNT / 2 / FFT_STEP_BINS;
+    const int level = combineStep / stepsPerLevel;
+    const int half = FFT_STEP_BINS << level;
+    const int twiddleStride = FFT_BIN_COUNT / (2 * half);
+    // cos and sin of 2 * pi * i / FFT_BIN_COUNT
+    const float *twiddle = state->fft.instance.Sint.pTwiddle;
+    float *data = state->fft.data;
+
+    const int first = (combineStep % stepsPerLevel) * FFT_STEP_BINS;
+    for (int i = first; i < first + FFT_STEP_BINS; i++) {
+        const int k = i % half;
+        float *a = &data[2 * (2 * half * (i / half) + k)];
+        float *b = a + 2 * half;
+
+        const float wr = twiddle[2 * k * twiddleStride];
+        const float wi = twiddle[2 * k * twiddleStride + 1];
+        const float tr = b[0] * wr + b[1] * wi;
+        const float ti = b[1] * wr - b[0] * wi;
+
+        b[0] = a[0] - tr;
+        b[1] = a[1] - ti;
+        a[0] += tr;
+        a[1] += ti;
+    }
+}
+#endif
+
+/*
+ * The loop of CMSIS stage_rfft_f32() for the FFT_STEP_BINS bins of the block
+ */
+static void gyroDataAnalyseStageRfft(gyroAnalyseState_t *state, int block)
+{
+    const float *p = state->fft.data;
+    const float *coeff = state->fft.instance.pTwiddleRFFT;
+    float *out = state->fft.rfftData;
+    int k = block * FFT_STEP_BINS;
+
+    if (k == 0) {
+        // Pack first and last sample of the frequency domain together
+        const float t1a = p[0] + p[0];
+        const float t1b = p[1] + p[1];
+        out[0] = 0.5f * (t1a + t1b);
+        out[1] = 0.5f * (t1a - t1b);
+        k++;
+    }
+
+    for (; k < (block + 1) * FFT_STEP_BINS; k++) {
+        const float xAR = p[2 * k];
+        const float xAI = p[2 * k + 1];
+        const float xBR = p[2 * (FFT_BIN_COUNT - k)];
+        const float xBI = p[2 * (FFT_BIN_COUNT - k) + 1];
+        const float twR = coeff[2 * k];
+        const float twI = coeff[2 * k + 1];
+
+        const float t1a = xBR - xAR;
+        const float t1b = xBI + xAI;
+
+        out[2 * k] = 0.5f * (xAR + xBR + twR * t1a + twI * t1b);
+        out[2 * k + 1] = 0.5f * (xAI - xBI + twI * t1a - twR * t1b);
+    }
+}
+
+/*
+ * Magnitude of the block, then look for peaks among the bins whose both
+ * neighbours are known
+ */
+static void gyroDataAnalyseMagnitudeAndFindPeaks(gyroAnalyseState_t *state, int block)
+{
+    const int firstBin = block * FFT_STEP_BINS;
+    arm_cmplx_mag_f32(&state->fft.rfftData[2 * firstBin], &state->fft.data[firstBin], FFT_STEP_BINS);
+
+    if (block == 0) {
+        //Zero the data structure
+        for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
+            state->fft.peaks[i].bin = 0;
+            state->fft.peaks[i].value = 0.0f;
         }
-        case STEP_MAGNITUDE_AND_FREQUENCY:
-        {
-            // 8us
-            arm_cmplx_mag_f32(state->rfftData, state->fftData, FFT_BIN_COUNT);
-
-            //Zero the data structure
-            for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
-                state->peaks[i].bin = 0;
-                state->peaks[i].value = 0.0f;
-            }
+        state->fft.peakSearchBin = state->fft.startBin + 1;
+    }
 
-            // Find peaks
-            for (int bin = (state->fftStartBin + 1); bin < FFT_BIN_COUNT - 1; bin++) {
-                /*
-                 * Peak is defined if the current bin is greater than the previous bin and the next bin
-                 */
-                if (
-                    state->fftData[bin] > state->fftData[bin - 1] && 
-                    state->fftData[bin] > state->fftData[bin + 1]
-                ) {
-                    /*
-                     * We are only interested in N biggest peaks
-                     * Check previously found peaks and update the structure if necessary
-                     */
-                    for (int p = 0; p < DYN_NOTCH_PEAK_COUNT; p++) {
-                        if (state->fftData[bin] > state->peaks[p].value) {
-                            for (int k = DYN_NOTCH_PEAK_COUNT - 1; k > p; k--) {
-                                state->peaks[k] = state->peaks[k - 1];
-                            }
-                            state->peaks[p].bin = bin;
-                            state->peaks[p].value = state->fftData[bin];
-                            break;
-                        }
+    // The last block stops at FFT_BIN_COUNT - 1, the highest bin has no upper neighbour
+    int bin = state->fft.peakSearchBin;
+    for (; bin < firstBin + FFT_STEP_BINS - 1; bin++) {
+        /*
+         * Peak is defined if the current bin is greater than the previous bin and the next bin
+         */
+        if (
+            state->fft.data[bin] > state->fft.data[bin - 1] && 
+            state->fft.data[bin] > state->fft.data[bin + 1]
+        ) {
+            /*
+             * We are only interested in N biggest peaks
+             * Check previously found peaks and update the structure if necessary
+             */
+            for (int p = 0; p < DYN_NOTCH_PEAK_COUNT; p++) {
+                if (state->fft.data[bin] > state->fft.peaks[p].value) {
+                    for (int k = DYN_NOTCH_PEAK_COUNT - 1; k > p; k--) {
+                        state->fft.peaks[k] = state->fft.peaks[k - 1];
                     }
-                    bin++; // If bin is peak, next bin can't be peak => jump it
+                    state->fft.peaks[p].bin = bin;
+                    state->fft.peaks[p].value = state->fft.data[bin];
+                    break;
                 }
             }
+            bin++; // If bin is peak, next bin can't be peak => jump it
+        }
+    }
+    state->fft.peakSearchBin = bin;
+}
 
-            // Sort N biggest peaks in ascending bin order (example: 3, 8, 25, 0, 0, ..., 0)
-            for (int p = DYN_NOTCH_PEAK_COUNT - 1; p > 0; p--) {
-                for (int k = 0; k < p; k++) {
-                    // Swap peaks but ignore swapping void peaks (bin = 0). This leaves
-                    // void peaks at the end of peaks array without moving them
-                    if (state->peaks[k].bin > state->peaks[k + 1].bin && state->peaks[k + 1].bin != 0) {
-                        peak_t temp = state->peaks[k];
-                        state->peaks[k] = state->peaks[k + 1];
-                        state->peaks[k + 1] = temp;
-                    }
-                }
+static void gyroDataAnalyseUpdateFilters(gyroAnalyseState_t *state)
+{
+    // Sort N biggest peaks in ascending bin order (example: 3, 8, 25, 0, 0, ..., 0)
+    for (int p = DYN_NOTCH_PEAK_COUNT - 1; p > 0; p--) {
+        for (int k = 0; k < p; k++) {
+            // Swap peaks but ignore swapping void peaks (bin = 0). This leaves
+            // void peaks at the end of peaks array without moving them
+            if (state->fft.peaks[k].bin > state->fft.peaks[k + 1].bin && state->fft.peaks[k + 1].bin != 0) {
+                peak_t temp = state->fft.peaks[k];
+                state->fft.peaks[k] = state->fft.peaks[k + 1];
+                state->fft.peaks[k + 1] = temp;
             }
-
-            break;
         }
-        case STEP_UPDATE_FILTERS_AND_HANNING:
-        {
-
-            /*
-             * Update frequencies
-             */
-            for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
+    }
 
-                if (state->peaks[i].bin > 0) {
-                    const int bin = constrain(state->peaks[i].bin, state->fftStartBin, FFT_BIN_COUNT - 1);
-                    float frequency = computeParabolaMean(state, bin) * state->fftResolution;
+    /*
+     * Update frequencies
+     */
+    for (int i = 0; i < DYN_NOTCH_PEAK_COUNT; i++) {
 
-                    state->centerFrequency[state->updateAxis][i] = pt1FilterApply(&state->detectedFrequencyFilter[state->updateAxis][i], frequency);
-                } else {
-                    state->centerFrequency[state->updateAxis][i] = 0.0f;
-                }
-            }
+        if (state->fft.peaks[i].bin > 0) {
+            const int bin = constrain(state->fft.peaks[i].bin, state->fft.startBin, FFT_BIN_COUNT - 1);
+            float frequency = computeParabolaMean(state, bin) * state->fft.resolution;
 
-            /*
-             * Filters will be updated inside dynamicGyroNotchFiltersUpdate()
-             */
-            state->filterUpdateExecute = true;
-            state->filterUpdateAxis = state->updateAxis;
-
-            //Switch to the next axis
-            state->updateAxis = (state->updateAxis + 1) % XYZ_AXIS_COUNT;
-            
-            // apply hanning window to gyro samples and store result in fftData
-            // hanning starts and ends with 0, could be skipped for minor speed improvement
-            arm_mult_f32(state->downsampledGyroData[state->updateAxis], state->hanningWindow, state->fftData, FFT_WINDOW_SIZE);
+            state->centerFrequency[state->updateAxis][i] = pt1FilterApply(&state->detectedFrequencyFilter[state->updateAxis][i], frequency);
+        } else {
+            state->centerFrequency[state->updateAxis][i] = 0.0f;
         }
     }
 
+    /*
+     * Filters will be updated inside dynamicGyroNotchFiltersUpdate()
+     */
+    state->filterUpdateExecute = true;
+    state->filterUpdateAxisMask = BIT(state->updateAxis);
+
+    //Switch to the next axis
+    state->updateAxis = (state->updateAxis + 1) % XYZ_AXIS_COUNT;
+}
+
+/*
+ * Analyse last gyro data from the last FFT_WINDOW_SIZE milliseconds
+ */
+static NOINLINE void gyroDataAnalyseUpdate(gyroAnalyseState_t *state)
+{
+    const int step = state->updateStep;
+
+    if (step < STEP_COMBINE) {
+        gyroDataAnalyseWindowAndCfft(state, step - STEP_WINDOW_AND_CFFT);
+#if FFT_COMBINE_LEVELS > 0
+    } else if (step < STEP_STAGE_RFFT) {
+        gyroDataAnalyseCombine(state, step - STEP_COMBINE);
+#endif
+    } else if (step < STEP_MAGNITUDE) {
+        gyroDataAnalyseStageRfft(state, step - STEP_STAGE_RFFT);
+    } else if (step < STEP_UPDATE_FILTERS) {
+        gyroDataAnalyseMagnitudeAndFindPeaks(state, step - STEP_MAGNITUDE);
+    } else {
+        gyroDataAnalyseUpdateFilters(state);
+    }
+
     state->updateStep = (state->updateStep + 1) % STEP_COUNT;
 }
 
@@ -24,12 +24,29 @@
 
 #include "arm_math.h"
 #include "common/filter.h"
+#include "common/sdft.h"
+#include "common/time.h"
 
 /*
- * Current code works only with 64 window size. Changing it do a different size would require
- * adapting the gyroDataAnalyseUpdate in STEP_ARM_CFFT_F32 step
+ * 64, 128 or 256 samples. Bigger windows give a finer resolution, the
+ * extra work is spread over more steps of gyroDataAnalyseUpdate()
  */
+#ifndef FFT_WINDOW_SIZE
 #define FFT_WINDOW_SIZE 64
+#endif
+
+#define FFT_BIN_COUNT             (FFT_WINDOW_SIZE / 2)
+
+/*
+ * The real FFT of FFT_WINDOW_SIZE samples is a complex FFT of FFT_BIN_COUNT
+ * points. Each step works on FFT_STEP_BINS of them, so the cost of a step
+ * doesn't grow with the window: the complex FFT is done in blocks of
+ * FFT_STEP_BINS points, joined by FFT_COMBINE_LEVELS radix-2 levels.
+ */
+#define FFT_STEP_BINS             32
+#define FFT_STEP_BLOCKS           (FFT_BIN_COUNT / FFT_STEP_BINS)
+#define FFT_COMBINE_LEVELS        (FFT_STEP_BLOCKS == 4 ? 2 : FFT_STEP_BLOCKS == 2 ? 1 : 0)
+#define FFT_COMBINE_STEP_COUNT    (FFT_COMBINE_LEVELS * FFT_BIN_COUNT / 2 / FFT_STEP_BINS)
 
 typedef struct peak_s {
     int bin;
@@ -40,42 +57,68 @@ typedef struct gyroAnalyseState_s {
     // accumulator for oversampled data => no aliasing and less noise
     float currentSample[XYZ_AXIS_COUNT];
 
-    // downsampled gyro data circular buffer for frequency analysis
-    uint8_t circularBufferIdx;
-    float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE];
-
     // update state machine step information
     uint8_t updateStep;
     uint8_t updateAxis;
 
-    arm_rfft_fast_instance_f32 fftInstance;
-    float fftData[FFT_WINDOW_SIZE];
-    float rfftData[FFT_WINDOW_SIZE];
-
     pt1Filter_t detectedFrequencyFilter[XYZ_AXIS_COUNT][DYN_NOTCH_PEAK_COUNT];
     float centerFrequency[XYZ_AXIS_COUNT][DYN_NOTCH_PEAK_COUNT];
-    
-    peak_t peaks[DYN_NOTCH_PEAK_COUNT];
 
     bool filterUpdateExecute;
-    uint8_t filterUpdateAxis;
+    uint8_t filterUpdateAxisMask;   // Axes with new centerFrequency values
     uint16_t filterUpdateFrequency;
 
-    uint16_t fftSamplingRateHz;
-    uint8_t fftStartBin;
-    float fftResolution;
+    uint8_t mode;                   // dynamicNotchMode_e
+
     uint16_t minFrequency;
     uint16_t maxFrequency;
 
-    // Hanning window, see https://en.wikipedia.org/wiki/Window_function#Hann_.28Hanning.29_window
-    float hanningWindow[FFT_WINDOW_SIZE];
+    // Only the state of the selected mode is used, it can't change without a reboot
+    union {
+        // DYNAMIC_NOTCH_MODE_FFT, one axis is analysed at a time
+        struct {
+            // downsampled gyro data circular buffer for frequency analysis
+            uint16_t circularBufferIdx;
+            uint16_t windowStartIdx;        // Oldest sample of the window being analysed
+            float downsampledGyroData[XYZ_AXIS_COUNT][FFT_WINDOW_SIZE];
+
+            arm_rfft_fast_instance_f32 instance;
+            float data[FFT_WINDOW_SIZE];
+            float rfftData[FFT_WINDOW_SIZE];
+
+            peak_t peaks[DYN_NOTCH_PEAK_COUNT];
+            uint16_t peakSearchBin;         // Next bin to check, the search follows the magnitude steps
+
+            uint16_t samplingRateHz;
+            uint16_t startBin;
+            float resolution;
+
+            // Hanning window, see https://en.wikipedia.org/wiki/Window_function#Hann_.28Hanning.29_window
+            float hanningWindow[FFT_WINDOW_SIZE];
+        } fft;
+
+        // DYNAMIC_NOTCH_MODE_SDFT, every axis is updated on every sample
+        struct {
+            sdft_t axis[XYZ_AXIS_COUNT];
+            float magnitudeSq[SDFT_MAX_BINS];
+            float resolution;
+        } sdft;
+    };
+
+    // Time spent in gyroDataAnalyse(), for DEBUG_FFT_TIME
+    timeUs_t lastStepTimeUs;
+    timeUs_t maxStepTimeUs;
+    timeUs_t cycleTimeUs;           // All the steps for one axis
+    timeUs_t lastCycleTimeUs;
 } gyroAnalyseState_t;
 
-STATIC_ASSERT(FFT_WINDOW_SIZE <= (uint8_t) -1, window_size_greater_than_underlying_type);
+STATIC_ASSERT(FFT_WINDOW_SIZE == 64 || FFT_WINDOW_SIZE == 128 || FFT_WINDOW_SIZE == 256, unsupported_fft_window_size);
 
 void gyroDataAnalyseStateInit(
     gyroAnalyseState_t *state, 
+    uint8_t mode,
     uint16_t minFrequency,
+    uint16_t maxFrequency,
     uint32_t targetLooptimeUs
 );
 void gyroDataAnalysePush(gyroAnalyseState_t *gyroAnalyse, int axis, float sample);
@@ -425,7 +425,7 @@ static void imuMahonyAHRSupdate(float dt, const fpVector3_t * gyroBF, const fpVe
     const float thetaMagnitudeSq = vectorNormSquared(&vTheta);
 
     // If calculated rotation is zero - don't update quaternion
-    if (thetaMagnitudeSq >= 1e-20) {
+    if (thetaMagnitudeSq >= 1e-20f) {
         // Calculate quaternion delta:
         // Theta is a axis/angle rotation. Direction of a vector is axis, magnitude is angle/2.
         // Proper quaternion from axis/angle involves computing sin/cos, but the formula becomes numerically unstable as Theta approaches zero.
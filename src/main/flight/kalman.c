@@ -23,7 +23,8 @@
 FILE_COMPILE_FOR_SPEED
 
 #include <string.h>
-#include "arm_math.h"
+
+#include "common/maths.h"
 
 #include "kalman.h"
 #include "build/debug.h"
@@ -93,9 +94,7 @@ static void updateAxisVariance(kalman_t *kalmanState, float rate)
     kalmanState->axisMean = kalmanState->axisSumMean * kalmanState->inverseN;
     kalmanState->axisVar = kalmanState->axisSumVar * kalmanState->inverseN;
 
-    float squirt;
-    arm_sqrt_f32(kalmanState->axisVar, &squirt);
-    kalmanState->r = squirt * VARIANCE_SCALE;
+    kalmanState->r = fast_fsqrtf(kalmanState->axisVar) * VARIANCE_SCALE;
 }
 
 float NOINLINE gyroKalmanUpdate(uint8_t axis, float input)
@@ -163,7 +163,7 @@ void powerLimiterApply(int16_t *throttleCommand) {
     int32_t overCurrent = current - activeCurrentLimit;
 
     if (lastCallTimestamp) {
-        currentThrAttnIntegrator = constrainf(currentThrAttnIntegrator + overCurrent * powerLimitsConfig()->piI * callTimeDelta * 2e-7, 0, PWM_RANGE_MAX - PWM_RANGE_MIN);
+        currentThrAttnIntegrator = constrainf(currentThrAttnIntegrator + overCurrent * powerLimitsConfig()->piI * callTimeDelta * 2e-7f, 0, PWM_RANGE_MAX - PWM_RANGE_MIN);
     }
 
     float currentThrAttnProportional = MAX(0, overCurrent) * powerLimitsConfig()->piP * 1e-3;
@@ -245,7 +245,7 @@ bool powerLimiterIsLimitingPower(void) {
 // returns seconds
 float powerLimiterGetRemainingBurstTime(void) {
     uint16_t currentBurstOverContinuous = currentBatteryProfile->powerLimits.burstCurrent - currentBatteryProfile->powerLimits.continuousCurrent;
-    float remainingCurrentBurstTime = burstCurrentReserve / currentBurstOverContinuous / 1e7;
+    float remainingCurrentBurstTime = burstCurrentReserve / currentBurstOverContinuous / 1e7f;
 
 #ifdef USE_ADC
     uint16_t powerBurstOverContinuous = currentBatteryProfile->powerLimits.burstPower - currentBatteryProfile->powerLimits.continuousPower;
@@ -60,46 +60,34 @@ typedef struct
     float minHz;
     float maxHz;
     uint8_t harmonics;
-    biquadFilter_t filters[XYZ_AXIS_COUNT][MAX_SUPPORTED_MOTORS][RPM_FILTER_HARMONICS];
+    // All three axes of a motor harmonic share the same notch frequency
+    biquadFilterBank3_t filters[MAX_SUPPORTED_MOTORS][RPM_FILTER_HARMONICS];
 } rpmFilterBank_t;
 
-typedef float (*rpmFilterApplyFnPtr)(rpmFilterBank_t *filter, uint8_t axis, float input);
 typedef void (*rpmFilterUpdateFnPtr)(rpmFilterBank_t *filterBank, uint8_t motor, float baseFrequency);
 
 static EXTENDED_FASTRAM pt1Filter_t motorFrequencyFilter[MAX_SUPPORTED_MOTORS];
 static EXTENDED_FASTRAM rpmFilterBank_t gyroRpmFilters;
-static EXTENDED_FASTRAM rpmFilterApplyFnPtr rpmGyroApplyFn;
+static EXTENDED_FASTRAM bool rpmGyroFilterEnabled;
 static EXTENDED_FASTRAM rpmFilterUpdateFnPtr rpmGyroUpdateFn;
 
-float nullRpmFilterApply(rpmFilterBank_t *filter, uint8_t axis, float input)
-{
-    UNUSED(filter);
-    UNUSED(axis);
-    return input;
-}
-
 void nullRpmFilterUpdate(rpmFilterBank_t *filterBank, uint8_t motor, float baseFrequency) {
     UNUSED(filterBank);
     UNUSED(motor);
     UNUSED(baseFrequency);
 }
 
-float rpmFilterApply(rpmFilterBank_t *filterBank, uint8_t axis, float input)
+static void rpmFilterApply(rpmFilterBank_t *filterBank, float *data)
 {
-    float output = input;
+    const uint8_t motorCount = getMotorCount();
 
-    for (uint8_t motor = 0; motor < getMotorCount(); motor++)
+    for (uint8_t motor = 0; motor < motorCount; motor++)
     {
         for (int harmonicIndex = 0; harmonicIndex < filterBank->harmonics; harmonicIndex++)
         {
-            output = biquadFilterApplyDF1(
-                &filterBank->filters[axis][motor][harmonicIndex],
-                output
-            );
+            biquadFilterBank3ApplyDF1(&filterBank->filters[motor][harmonicIndex], data);
         }
     }
-
-    return output;
 }
 
 static void rpmFilterInit(rpmFilterBank_t *filter, uint16_t q, uint8_t minHz, uint8_t harmonics)
@@ -112,48 +100,41 @@ static void rpmFilterInit(rpmFilterBank_t *filter, uint16_t q, uint8_t minHz, ui
      */
     filter->maxHz = 0.48f * 1000000.0f / getLooptime();
 
-    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+    for (int motor = 0; motor < getMotorCount(); motor++)
     {
-        for (int motor = 0; motor < getMotorCount(); motor++)
+        /*
+         * Harmonics are indexed from 1 where 1 means base frequency
+         * C indexes arrays from 0, so we need to shift
+         */
+        for (int harmonicIndex = 0; harmonicIndex < harmonics; harmonicIndex++)
         {
-
-            /*
-             * Harmonics are indexed from 1 where 1 means base frequency
-             * C indexes arrays from 0, so we need to shift
-             */
-            for (int harmonicIndex = 0; harmonicIndex < harmonics; harmonicIndex++)
-            {
-                biquadFilterInit(
-                    &filter->filters[axis][motor][harmonicIndex],
-                    filter->minHz * (harmonicIndex + 1),
-                    getLooptime(),
-                    filter->q,
-                    FILTER_NOTCH);
-            }
+            biquadFilterBank3Init(
+                &filter->filters[motor][harmonicIndex],
+                filter->minHz * (harmonicIndex + 1),
+                getLooptime(),
+                filter->q,
+                FILTER_NOTCH);
         }
     }
 }
 
 void disableRpmFilters(void) {
-    rpmGyroApplyFn = (rpmFilterApplyFnPtr)nullRpmFilterApply;
+    rpmGyroFilterEnabled = false;
 }
 
 void rpmFilterUpdate(rpmFilterBank_t *filterBank, uint8_t motor, float baseFrequency)
 {
-    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++)
+    for (int harmonicIndex = 0; harmonicIndex < filterBank->harmonics; harmonicIndex++)
     {
-        for (int harmonicIndex = 0; harmonicIndex < filterBank->harmonics; harmonicIndex++)
-        {
-            float harmonicFrequency = baseFrequency * (harmonicIndex + 1);
-            harmonicFrequency = constrainf(harmonicFrequency, filterBank->minHz, filterBank->maxHz);
-
-            biquadFilterUpdate(
-                &filterBank->filters[axis][motor][harmonicIndex],
-                harmonicFrequency,
-                getLooptime(),
-                filterBank->q,
-                FILTER_NOTCH);
-        }
+        float harmonicFrequency = baseFrequency * (harmonicIndex + 1);
+        harmonicFrequency = constrainf(harmonicFrequency, filterBank->minHz, filterBank->maxHz);
+
+        biquadFilterBank3Update(
+            &filterBank->filters[motor][harmonicIndex],
+            harmonicFrequency,
+            getLooptime(),
+            filterBank->q,
+            FILTER_NOTCH);
     }
 }
 
@@ -173,7 +154,7 @@ void rpmFiltersInit(void)
             rpmFilterConfig()->gyro_q,
             rpmFilterConfig()->gyro_min_hz,
             rpmFilterConfig()->gyro_harmonics);
-        rpmGyroApplyFn = (rpmFilterApplyFnPtr)rpmFilterApply;
+        rpmGyroFilterEnabled = true;
         rpmGyroUpdateFn = (rpmFilterUpdateFnPtr)rpmFilterUpdate;
     }
 }
@@ -199,9 +180,11 @@ void rpmFilterUpdateTask(timeUs_t currentTimeUs)
     }
 }
 
-float rpmFilterGyroApply(uint8_t axis, float input)
+void rpmFilterGyroApply(float *gyroADCf)
 {
-    return rpmGyroApplyFn(&gyroRpmFilters, axis, input);
+    if (rpmGyroFilterEnabled) {
+        rpmFilterApply(&gyroRpmFilters, gyroADCf);
+    }
 }
 
 #endif
@@ -212,7 +212,7 @@ static void printStats(displayPort_t *displayPort, uint32_t updates)
 
 
     tfp_sprintf(lineBuffer, "R:%2d %4ld %5ld(%5ld) U:%2ld(%2ld) B:%3ld(%4ld,%4ld)", resetCount, (millis()-vtxHeartbeat),
-            dataSent, maxDataSent, updates, maxUpdates, bufferUsed, maxBufferUsed, hdZeroMspPort.port->txBufferSize);
+            dataSent, maxDataSent, updates, maxUpdates, bufferUsed, maxBufferUsed, ringBufferSize(&hdZeroMspPort.port->txBuffer));
     writeString(displayPort, 0, 17, lineBuffer, 0);
 }
 #endif
@@ -364,7 +364,7 @@ static const displayPortVTable_t hdzeroOsdVTable = {
 
 bool hdzeroOsdSerialInit(void)
 {
-    static volatile uint8_t txBuffer[TX_BUFFER_SIZE];
+    static uint8_t txBuffer[TX_BUFFER_SIZE];
     memset(&hdZeroMspPort, 0, sizeof(mspPort_t));
 
     serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_HDZERO_OSD);
@@ -374,10 +374,7 @@ bool hdzeroOsdSerialInit(void)
 
         if (port) {
             // Use a bigger TX buffer size to accommodate the configuration menus
-            port->txBuffer = txBuffer;
-            port->txBufferSize = TX_BUFFER_SIZE;
-            port->txBufferTail = 0;
-            port->txBufferHead = 0;
+            ringBufferInit(&port->txBuffer, txBuffer, TX_BUFFER_SIZE);
 
             resetMspPort(&hdZeroMspPort, port);
 
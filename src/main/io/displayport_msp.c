@@ -24,12 +24,17 @@
 
 #ifdef USE_MSP_DISPLAYPORT
 
+#include "build/debug.h"
+
+#include "common/bitarray.h"
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "config/parameter_group.h"
 #include "config/parameter_group_ids.h"
 
 #include "drivers/display.h"
+#include "drivers/time.h"
 
 #include "fc/fc_msp.h"
 
@@ -38,7 +43,47 @@
 #include "msp/msp_protocol.h"
 #include "msp/msp_serial.h"
 
+// MSP_DISPLAYPORT subcommands
+typedef enum {
+    MSP_DP_HEARTBEAT = 0,
+    MSP_DP_RELEASE = 1,
+    MSP_DP_CLEAR_SCREEN = 2,
+    MSP_DP_WRITE_STRING = 3,
+    MSP_DP_DRAW_SCREEN = 4,
+} mspDisplayportCommand_e;
+
+#define MSP_DISPLAYPORT_ROWS            13
+#define MSP_DISPLAYPORT_COLS            30
+#define MSP_DISPLAYPORT_CHARS           (MSP_DISPLAYPORT_ROWS * MSP_DISPLAYPORT_COLS)
+
+// MSPv1 header ($M>, size and cmd) plus checksum
+#define MSP_FRAME_OVERHEAD              6
+// Subcommand, row, col and attributes
+#define MSP_WRITE_STRING_HEADER_SIZE    4
+#define MSP_DRAW_SCREEN_FRAME_SIZE      (MSP_FRAME_OVERHEAD + 1)
+// Resending unchanged chars between two changed ones is cheaper than
+// starting a new frame as long as the gap is shorter than this
+#define MSP_WRITE_STRING_MAX_GAP        (MSP_FRAME_OVERHEAD + MSP_WRITE_STRING_HEADER_SIZE)
+
+#define MSP_DISPLAYPORT_STATS_INTERVAL_MS 1000
+// The remote side doesn't ack anything, so the whole screen is resent this
+// often. Recovers from lost writes and displays which connect late.
+#define MSP_DISPLAYPORT_REFRESH_INTERVAL_MS 1000
+
 static displayPort_t mspDisplayPort;
+static bool mspDisplayPortInitialized;
+
+// Shadow of what the OSD wants on screen. Writes only update it, and
+// drawScreen() sends the runs of chars marked as dirty.
+static uint8_t screen[MSP_DISPLAYPORT_CHARS];
+static BITARRAY_DECLARE(screenIsDirty, MSP_DISPLAYPORT_CHARS);
+static bool clearPending;
+static timeMs_t refreshAtMs;
+
+static uint32_t statsFrames;
+static uint32_t statsBytes;
+static timeMs_t statsStartMs;
+static mspDisplayportStats_t stats;
 
 extern uint8_t cliMode;
 
@@ -50,12 +95,25 @@ static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len
     if (cliMode) {
         return 0;
     }
-    return mspSerialPush(cmd, buf, len);
+    const int written = mspSerialPush(cmd, buf, len);
+    if (written > 0) {
+        statsFrames++;
+        statsBytes += written;
+    }
+    return written;
 }
 
 static int heartbeat(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 0 };
+    uint8_t subcmd[] = { MSP_DP_HEARTBEAT };
+
+    // Resend the whole screen now and then, the following drawScreen()
+    // calls send it as the TX buffer allows
+    const timeMs_t currentTimeMs = millis();
+    if (cmp32(currentTimeMs, refreshAtMs) >= 0) {
+        BITARRAY_SET_ALL(screenIsDirty);
+        refreshAtMs = currentTimeMs + MSP_DISPLAYPORT_REFRESH_INTERVAL_MS;
+    }
 
     // heartbeat is used to:
     // a) ensure display is not released by MW OSD software
@@ -70,22 +128,121 @@ static int grab(displayPort_t *displayPort)
 
 static int release(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 1 };
+    uint8_t subcmd[] = { MSP_DP_RELEASE };
 
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
+static int sendClearScreen(displayPort_t *displayPort)
+{
+    uint8_t subcmd[] = { MSP_DP_CLEAR_SCREEN };
+
+    const int written = output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+    // Retry from drawScreen() if it couldn't be sent
+    clearPending = written <= 0;
+    return written;
+}
+
 static int clearScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 2 };
+    memset(screen, ' ', sizeof(screen));
+    // Nothing is left to send, the remote side clears its own screen
+    BITARRAY_CLR_ALL(screenIsDirty);
+    refreshAtMs = millis() + MSP_DISPLAYPORT_REFRESH_INTERVAL_MS;
+    return sendClearScreen(displayPort);
+}
 
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+// Sends as many runs of dirty chars as fit in bytesFree, leaving room
+// for the draw command. Returns the number of bytes sent.
+static int sendDirtyRuns(displayPort_t *displayPort, uint32_t bytesFree)
+{
+    uint8_t buf[MSP_WRITE_STRING_HEADER_SIZE + MSP_DISPLAYPORT_COLS];
+    int sent = 0;
+
+    for (int next = BITARRAY_FIND_FIRST_SET(screenIsDirty, 0); next >= 0 && next < MSP_DISPLAYPORT_CHARS;
+        next = BITARRAY_FIND_FIRST_SET(screenIsDirty, next)) {
+
+        const unsigned row = next / MSP_DISPLAYPORT_COLS;
+        const unsigned rowEnd = (row + 1) * MSP_DISPLAYPORT_COLS;
+        const unsigned start = next;
+        unsigned end = start + 1;
+
+        // A run can't span rows, but it can include short clean gaps
+        for (unsigned pos = end; pos < rowEnd && pos - end < MSP_WRITE_STRING_MAX_GAP; pos++) {
+            if (bitArrayGet(screenIsDirty, pos)) {
+                end = pos + 1;
+            }
+        }
+
+        const unsigned len = end - start;
+        const uint32_t frameSize = MSP_FRAME_OVERHEAD + MSP_WRITE_STRING_HEADER_SIZE + len;
+        if (frameSize + MSP_DRAW_SCREEN_FRAME_SIZE > bytesFree) {
+            // Continue on the next drawScreen()
+            break;
+        }
+
+        buf[0] = MSP_DP_WRITE_STRING;
+        buf[1] = row;
+        buf[2] = start - row * MSP_DISPLAYPORT_COLS;
+        buf[3] = 0;
+        memcpy(&buf[MSP_WRITE_STRING_HEADER_SIZE], &screen[start], len);
+
+        const int written = output(displayPort, MSP_DISPLAYPORT, buf, MSP_WRITE_STRING_HEADER_SIZE + len);
+        if (written <= 0) {
+            break;
+        }
+        for (unsigned pos = start; pos < end; pos++) {
+            bitArrayClr(screenIsDirty, pos);
+        }
+        bytesFree -= MIN((uint32_t)written, bytesFree);
+        sent += written;
+        next = end;
+    }
+
+    return sent;
+}
+
+static void updateStats(int drawBytes)
+{
+    const timeMs_t currentTimeMs = millis();
+    const timeDelta_t elapsedMs = currentTimeMs - statsStartMs;
+
+    if (elapsedMs >= MSP_DISPLAYPORT_STATS_INTERVAL_MS) {
+        stats.framesPerSecond = statsFrames * 1000 / elapsedMs;
+        stats.bytesPerSecond = statsBytes * 1000 / elapsedMs;
+        statsFrames = 0;
+        statsBytes = 0;
+        statsStartMs = currentTimeMs;
+    }
+
+    DEBUG_SET(DEBUG_MSP_DISPLAYPORT, 0, stats.framesPerSecond);
+    DEBUG_SET(DEBUG_MSP_DISPLAYPORT, 1, stats.bytesPerSecond);
+    DEBUG_SET(DEBUG_MSP_DISPLAYPORT, 2, drawBytes);
 }
 
 static int drawScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 4 };
-    return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+    uint32_t bytesFree = displayPort->vTable->txBytesFree(displayPort);
+    int sent = 0;
+
+    if (clearPending) {
+        sent = sendClearScreen(displayPort);
+        if (clearPending) {
+            updateStats(0);
+            return 0;
+        }
+        bytesFree -= MIN((uint32_t)sent, bytesFree);
+    }
+
+    sent += sendDirtyRuns(displayPort, bytesFree);
+
+    if (sent > 0) {
+        uint8_t subcmd[] = { MSP_DP_DRAW_SCREEN };
+        sent += MAX(output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd)), 0);
+    }
+
+    updateStats(sent);
+    return sent;
 }
 
 static int screenSize(const displayPort_t *displayPort)
@@ -96,21 +253,19 @@ static int screenSize(const displayPort_t *displayPort)
 static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, const char *string, textAttributes_t attr)
 {
     UNUSED(attr);
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
-    uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
 
-    int len = strlen(string);
-    if (len >= MSP_OSD_MAX_STRING_LENGTH) {
-        len = MSP_OSD_MAX_STRING_LENGTH;
+    if (row >= displayPort->rows) {
+        return 0;
     }
 
-    buf[0] = 3;
-    buf[1] = row;
-    buf[2] = col;
-    buf[3] = 0;
-    memcpy(&buf[4], string, len);
-
-    return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
+    unsigned pos = row * MSP_DISPLAYPORT_COLS + col;
+    for (; *string && col < displayPort->cols; string++, col++, pos++) {
+        if (screen[pos] != (uint8_t)*string) {
+            screen[pos] = *string;
+            bitArraySet(screenIsDirty, pos);
+        }
+    }
+    return 0;
 }
 
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint16_t c, textAttributes_t attr)
@@ -130,8 +285,8 @@ static bool isTransferInProgress(const displayPort_t *displayPort)
 
 static void resync(displayPort_t *displayPort)
 {
-    displayPort->rows = 13;
-    displayPort->cols = 30;
+    displayPort->rows = MSP_DISPLAYPORT_ROWS;
+    displayPort->cols = MSP_DISPLAYPORT_COLS;
 }
 
 static uint32_t txBytesFree(const displayPort_t *displayPort)
@@ -156,10 +311,20 @@ static const displayPortVTable_t mspDisplayPortVTable = {
     .supportedTextAttributes = NULL,
 };
 
+bool displayPortMspGetStats(mspDisplayportStats_t *out)
+{
+    if (!mspDisplayPortInitialized) {
+        return false;
+    }
+    *out = stats;
+    return true;
+}
+
 displayPort_t *displayPortMspInit(void)
 {
     displayInit(&mspDisplayPort, &mspDisplayPortVTable);
     resync(&mspDisplayPort);
+    mspDisplayPortInitialized = true;
     return &mspDisplayPort;
 }
 #endif // USE_MSP_DISPLAYPORT
@@ -20,5 +20,12 @@
 #include "config/parameter_group.h"
 #include "drivers/display.h"
 
+typedef struct mspDisplayportStats_s {
+    uint16_t framesPerSecond;
+    uint32_t bytesPerSecond;
+} mspDisplayportStats_t;
+
 struct displayPort_s;
 struct displayPort_s *displayPortMspInit(void);
+// Returns false if the MSP displayport is not in use
+bool displayPortMspGetStats(mspDisplayportStats_t *stats);
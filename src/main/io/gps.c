@@ -292,8 +292,8 @@ static bool gpsFakeGPSUpdate(void)
         int32_t cmDelta = speed * (delta / 1000.0f);
         int32_t latCmDelta = cmDelta * cos_approx(DECIDEGREES_TO_RADIANS(FAKE_GPS_GROUND_COURSE_DECIDEGREES));
         int32_t lonCmDelta = cmDelta * sin_approx(DECIDEGREES_TO_RADIANS(FAKE_GPS_GROUND_COURSE_DECIDEGREES));
-        int32_t latDelta = ceilf((float)latCmDelta / (111 * 1000 * 100 / 1e7));
-        int32_t lonDelta = ceilf((float)lonCmDelta / (111 * 1000 * 100 / 1e7));
+        int32_t latDelta = ceilf((float)latCmDelta / (111 * 1000 * 100 / 1e7f));
+        int32_t lonDelta = ceilf((float)lonCmDelta / (111 * 1000 * 100 / 1e7f));
         if (speed > 0 && latDelta == 0 && lonDelta == 0) {
             return false;
         }
@@ -194,6 +194,20 @@ static bool osdDisplayHasCanvas;
 #define osdDisplayHasCanvas false
 #endif
 
+// Hash of what each element last put on screen, 0 meaning it must be
+// drawn. It's dropped when the screen gets cleared and, to recover from
+// writes lost on the way to remote displays, every
+// OSD_ELEMENT_CACHE_REFRESH_MS.
+#define OSD_ELEMENT_CACHE_REFRESH_MS 1000
+#define OSD_HASH_INIT 2166136261u
+
+static uint32_t osdElementHash[OSD_ITEM_COUNT];
+static uint16_t osdElementCacheClearCount;
+static timeMs_t osdElementCacheRefreshAt;
+#if defined(USE_GPS)
+static uint32_t osdTelemetryHash;
+#endif
+
 #define AH_MAX_PITCH_DEFAULT 20 // Specify default maximum AHI pitch value displayed (degrees)
 
 PG_REGISTER_WITH_RESET_TEMPLATE(osdConfig_t, osdConfig, PG_OSD_CONFIG, 6);
@@ -627,6 +641,9 @@ static uint16_t osdGetCrsfLQ(void)
         case OSD_CRSF_LQ_TYPE3:
             displayedLQ = rxLinkStatistics.rfMode >= 2 ? scaledLQ : statsLQ;
             break;
+        default:
+            displayedLQ = statsLQ;
+            break;
     }
     return displayedLQ;
 }
@@ -703,7 +720,7 @@ static void osdFormatCoordinate(char *buff, char sym, int32_t val)
     // longitude maximum integer width is 4 (-180).
     int integerDigits = tfp_sprintf(buff + 1, (integerPart == 0 && val < 0) ? "-%d" : "%d", (int)integerPart);
     // We can show up to 7 digits in decimalPart.
-    int32_t decimalPart = abs(val % GPS_DEGREES_DIVIDER);
+    int32_t decimalPart = abs((int32_t)(val % GPS_DEGREES_DIVIDER));
     STATIC_ASSERT(GPS_DEGREES_DIVIDER == 1e7, adjust_max_decimal_digits);
     int decimalDigits = tfp_sprintf(buff + 1 + integerDigits, "%07d", (int)decimalPart);
     // Embbed the decimal separator
@@ -734,7 +751,7 @@ static void osdFormatCraftName(char *buff)
 static const char * osdArmingDisabledReasonMessage(void)
 {
     const char *message = NULL;
-    char messageBuf[MAX(SETTING_MAX_NAME_LENGTH, OSD_MESSAGE_LENGTH+1)];
+    static char messageBuf[OSD_MESSAGE_LENGTH + 1];
 
     switch (isArmingDisabledReason()) {
         case ARMING_DISABLED_FAILSAFE_SYSTEM:
@@ -1290,6 +1307,17 @@ static void osdDrawRadar(uint16_t *drawn, uint32_t *usedScale)
     osdDrawMap(reference, 0, SYM_ARROW_UP, GPS_distanceToHome, poiDirection, SYM_HOME, drawn, usedScale);
 }
 
+// FNV-1a
+static uint32_t osdHashUpdate(uint32_t hash, const void *data, size_t length)
+{
+    const uint8_t *p = data;
+    while (length--) {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 static uint16_t crc_accumulate(uint8_t data, uint16_t crcAccum)
 {
     uint8_t tmp;
@@ -1300,7 +1328,7 @@ static uint16_t crc_accumulate(uint8_t data, uint16_t crcAccum)
 }
 
 
-static void osdDisplayTelemetry(void)
+STATIC_UNIT_TESTED void osdDisplayTelemetry(void)
 {
     uint32_t          trk_data;
     uint16_t          trk_crc = 0;
@@ -1316,7 +1344,7 @@ static void osdDisplayTelemetry(void)
           trk_bearing %= 360;
           int32_t alt = CENTIMETERS_TO_METERS(osdGetAltitude());
           float at = atan2(alt, GPS_distanceToHome);
-          trk_elevation = (float)at * 57.2957795; // 57.2957795 = 1 rad
+          trk_elevation = (float)at * 57.2957795f; // 57.2957795 = 1 rad
           trk_elevation += 37; // because elevation in telemetry should be from -37 to 90
           if (trk_elevation < 0) {
             trk_elevation = 0;
@@ -1346,6 +1374,15 @@ static void osdDisplayTelemetry(void)
       }
     }
     trk_buffer[30] = 0;
+
+    // The mode decides whether the test line is written too
+    uint32_t trk_hash = osdHashUpdate(OSD_HASH_INIT, &trk_data, sizeof(trk_data));
+    trk_hash = osdHashUpdate(trk_hash, &osdConfig()->telemetry, sizeof(osdConfig()->telemetry));
+    if (trk_hash == osdTelemetryHash) {
+        return;
+    }
+    osdTelemetryHash = trk_hash;
+
     displayWrite(osdDisplayPort, 0, 0, trk_buffer);
     if (osdConfig()->telemetry>1){
       displayWrite(osdDisplayPort, 0, 3, trk_buffer);               // Test display because normal telemetry line is not visible
@@ -1477,7 +1514,7 @@ static void osdDisplayAdjustableDecimalValue(uint8_t elemPosX, uint8_t elemPosY,
     displayWriteWithAttr(osdDisplayPort, elemPosX + strlen(str) + 1 + valueOffset, elemPosY, buff, elemAttr);
 }
 
-int8_t getGeoWaypointNumber(int8_t waypointIndex)
+int16_t getGeoWaypointNumber(int8_t waypointIndex)
 {
     static int8_t lastWaypointIndex = 1;
     static int8_t geoWaypointIndex;
@@ -1493,15 +1530,79 @@ int8_t getGeoWaypointNumber(int8_t waypointIndex)
         }
     }
 
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    return posControl.waypointWindow.geoStart + geoWaypointIndex + 1;
+#else
     return geoWaypointIndex + 1;
+#endif
 }
 
-static bool osdDrawSingleElement(uint8_t item)
+/**
+ * Returns a hash of everything the given element is rendered from, for
+ * the elements cheap enough to sample that it pays off to skip formatting
+ * them when nothing changed. Returns 0 for the rest, which are compared
+ * by their formatted output instead.
+ */
+static uint32_t osdElementInputHash(uint8_t item, uint16_t pos)
+{
+    int32_t inputs[3] = { 0 };
+
+    switch (item) {
+    case OSD_RSSI_VALUE:
+        inputs[0] = osdConvertRSSI();
+        inputs[1] = osdConfig()->rssi_alarm;
+        break;
+
+#ifdef USE_GPS
+    case OSD_GPS_SATS:
+        inputs[0] = gpsSol.numSat;
+        inputs[1] = STATE(GPS_FIX);
+        inputs[2] = getHwGPSStatus();
+        break;
+#endif
+
+    case OSD_HEADING:
+        inputs[0] = osdIsHeadingValid() ? DECIDEGREES_TO_DEGREES(osdGetHeading()) : INT32_MIN;
+        break;
+
+    case OSD_ONTIME:
+        inputs[0] = micros() / 1000000;
+        break;
+
+    case OSD_FLYTIME:
+    case OSD_ONTIME_FLYTIME:
+        inputs[0] = (item == OSD_ONTIME_FLYTIME && !ARMING_FLAG(ARMED)) ? micros() / 1000000 : (uint32_t)getFlightTime();
+        inputs[1] = osdConfig()->time_alarm;
+        inputs[2] = ARMING_FLAG(ARMED);
+        break;
+
+    case OSD_ATTITUDE_ROLL:
+        inputs[0] = attitude.values.roll;
+        break;
+
+    case OSD_ATTITUDE_PITCH:
+        inputs[0] = attitude.values.pitch;
+        break;
+
+    default:
+        return 0;
+    }
+
+    uint32_t hash = osdHashUpdate(OSD_HASH_INIT, &pos, sizeof(pos));
+    return osdHashUpdate(hash, inputs, sizeof(inputs));
+}
+
+STATIC_UNIT_TESTED bool osdDrawSingleElement(uint8_t item)
 {
     uint16_t pos = osdLayoutsConfig()->item_pos[currentLayout][item];
     if (!OSD_VISIBLE(pos)) {
         return false;
     }
+    const uint32_t inputHash = osdElementInputHash(item, pos);
+    if (inputHash && inputHash == osdElementHash[item]) {
+        // Nothing was drawn, let the caller move on to the next element
+        return false;
+    }
     uint8_t elemPosX = OSD_X(pos);
     uint8_t elemPosY = OSD_Y(pos);
     textAttributes_t elemAttr = TEXT_ATTRIBUTES_NONE;
@@ -1559,7 +1660,7 @@ static bool osdDrawSingleElement(uint8_t item)
         else if (!batteryWasFullWhenPluggedIn())
             tfp_sprintf(buff, "  NF");
         else if (currentBatteryProfile->capacity.unit == BAT_CAPACITY_UNIT_MAH)
-            tfp_sprintf(buff, "%4lu", getBatteryRemainingCapacity());
+            tfp_sprintf(buff, "%4lu", (unsigned long)getBatteryRemainingCapacity());
         else // currentBatteryProfile->capacity.unit == BAT_CAPACITY_UNIT_MWH
             osdFormatCentiNumber(buff + 1, getBatteryRemainingCapacity() / 10, 0, 2, 0, 3);
 
@@ -2144,7 +2245,6 @@ static bool osdDrawSingleElement(uint8_t item)
             // -------- POI : Next waypoints from navigation
 
             if (osdConfig()->hud_wp_disp > 0 && posControl.waypointListValid && posControl.waypointCount > 0) { // Display the next waypoints
-                gpsLocation_t wp2;
                 int j;
 
                 for (int i = osdConfig()->hud_wp_disp - 1; i >= 0 ; i--) { // Display in reverse order so the next WP is always written on top
@@ -2153,15 +2253,11 @@ static bool osdDrawSingleElement(uint8_t item)
                         break;
                     }
                     if (posControl.waypointList[j].lat != 0 && posControl.waypointList[j].lon != 0) {
-                        wp2.lat = posControl.waypointList[j].lat;
-                        wp2.lon = posControl.waypointList[j].lon;
-                        wp2.alt = posControl.waypointList[j].alt;
-                        fpVector3_t poi;
-                        geoConvertGeodeticToLocal(&poi, &posControl.gpsOrigin, &wp2, waypointMissionAltConvMode(posControl.waypointList[j].p3));
+                        const fpVector3_t *poi = &getWaypointCacheEntry(j)->pos;
                         int32_t altConvModeAltitude = waypointMissionAltConvMode(posControl.waypointList[j].p3) == GEO_ALT_ABSOLUTE ? osdGetAltitudeMsl() : osdGetAltitude();
                         j = getGeoWaypointNumber(j);
                         while (j > 9) j -= 10; // Only the last digit displayed if WP>=10, no room for more (48 = ascii 0)
-                        osdHudDrawPoi(calculateDistanceToDestination(&poi) / 100, osdGetHeadingAngle(calculateBearingToDestination(&poi) / 100), (posControl.waypointList[j].alt - altConvModeAltitude)/ 100, 2, SYM_WAYPOINT, 48 + j, i);
+                        osdHudDrawPoi(calculateDistanceToDestination(poi) / 100, osdGetHeadingAngle(calculateBearingToDestination(poi) / 100), (posControl.waypointList[j].alt - altConvModeAltitude)/ 100, 2, SYM_WAYPOINT, 48 + j, i);
                     }
                 }
             }
@@ -2209,8 +2305,14 @@ static bool osdDrawSingleElement(uint8_t item)
             if (osdConfig()->ahi_reverse_roll) {
                 rollAngle = -rollAngle;
             }
-            osdDrawArtificialHorizon(osdDisplayPort, osdGetDisplayPortCanvas(),
-                 OSD_DRAW_POINT_GRID(elemPosX, elemPosY), rollAngle, pitchAngle);
+            uint32_t hash = osdHashUpdate(OSD_HASH_INIT, &pos, sizeof(pos));
+            hash = osdHashUpdate(hash, &rollAngle, sizeof(rollAngle));
+            hash = osdHashUpdate(hash, &pitchAngle, sizeof(pitchAngle));
+            if (hash != osdElementHash[item]) {
+                osdDrawArtificialHorizon(osdDisplayPort, osdGetDisplayPortCanvas(),
+                     OSD_DRAW_POINT_GRID(elemPosX, elemPosY), rollAngle, pitchAngle);
+                osdElementHash[item] = hash;
+            }
             osdDrawSingleElement(OSD_HORIZON_SIDEBARS);
             osdDrawSingleElement(OSD_CROSSHAIRS);
 
@@ -2687,9 +2789,9 @@ static bool osdDrawSingleElement(uint8_t item)
                     buff,
                     "[%u]=%8ld [%u]=%8ld",
                     bufferIndex,
-                    constrain(debug[bufferIndex], -9999999, 99999999),
+                    (long)constrain(debug[bufferIndex], -9999999, 99999999),
                     bufferIndex+1,
-                    constrain(debug[bufferIndex+1], -9999999, 99999999)
+                    (long)constrain(debug[bufferIndex+1], -9999999, 99999999)
                 );
                 displayWrite(osdDisplayPort, elemPosX, elemPosY, buff);
             }
@@ -3046,10 +3148,38 @@ static bool osdDrawSingleElement(uint8_t item)
         return false;
     }
 
+    uint32_t hash = inputHash;
+    if (!hash) {
+        hash = osdHashUpdate(OSD_HASH_INIT, &pos, sizeof(pos));
+        hash = osdHashUpdate(hash, &elemAttr, sizeof(elemAttr));
+        hash = osdHashUpdate(hash, buff, strlen(buff));
+    }
+    if (displayAttributesRequireEmulation(osdDisplayPort, elemAttr)) {
+        // Emulated blinking changes the output on its own
+        hash = 0;
+    } else if (hash == osdElementHash[item]) {
+        return true;
+    }
+    osdElementHash[item] = hash;
+
     displayWriteWithAttr(osdDisplayPort, elemPosX, elemPosY, buff, elemAttr);
     return true;
 }
 
+STATIC_UNIT_TESTED void osdUpdateElementCache(void)
+{
+    const timeMs_t currentTimeMs = millis();
+
+    if (osdDisplayPort->clearCount != osdElementCacheClearCount || currentTimeMs >= osdElementCacheRefreshAt) {
+        memset(osdElementHash, 0, sizeof(osdElementHash));
+#if defined(USE_GPS)
+        osdTelemetryHash = 0;
+#endif
+        osdElementCacheClearCount = osdDisplayPort->clearCount;
+        osdElementCacheRefreshAt = currentTimeMs + OSD_ELEMENT_CACHE_REFRESH_MS;
+    }
+}
+
 static uint8_t osdIncElementIndex(uint8_t elementIndex)
 {
     ++elementIndex;
@@ -3131,7 +3261,10 @@ static uint8_t osdIncElementIndex(uint8_t elementIndex)
 void osdDrawNextElement(void)
 {
     static uint8_t elementIndex = 0;
-    // Prevent infinite loop when no elements are enabled
+
+    osdUpdateElementCache();
+
+    // Prevent infinite loop when no elements are enabled, or none changed
     uint8_t index = elementIndex;
     do {
         elementIndex = osdIncElementIndex(elementIndex);
@@ -3746,7 +3879,7 @@ static void osdShowStatsPage2(void)
                     FALLTHROUGH;
                 case OSD_UNIT_IMPERIAL:
                     if (osdConfig()->stats_energy_unit == OSD_STATS_ENERGY_UNIT_MAH) {
-                        moreThanAh = osdFormatCentiNumber(buff, (int32_t)(getMAhDrawn() * 10000.0f * METERS_PER_MILE / totalDistance), 1000, 0, 2, 3);
+                        moreThanAh = osdFormatCentiNumber(buff, (int32_t)(getMAhDrawn() * 10000.0f * (float)METERS_PER_MILE / totalDistance), 1000, 0, 2, 3);
                         if (!moreThanAh) {
                             tfp_sprintf(buff, "%s%c%c", buff, SYM_MAH_MI_0, SYM_MAH_MI_1);
                         } else {
@@ -3759,7 +3892,7 @@ static void osdShowStatsPage2(void)
                             buff[5] = '\0';
                         }
                     } else {
-                        osdFormatCentiNumber(buff, (int32_t)(getMWhDrawn() * 10.0f * METERS_PER_MILE / totalDistance), 0, 2, 0, 3);
+                        osdFormatCentiNumber(buff, (int32_t)(getMWhDrawn() * 10.0f * (float)METERS_PER_MILE / totalDistance), 0, 2, 0, 3);
                         tfp_sprintf(buff, "%s%c", buff, SYM_WH_MI);
                         if (!efficiencyValid) {
                             buff[0] = buff[1] = buff[2] = '-';
@@ -3768,7 +3901,7 @@ static void osdShowStatsPage2(void)
                     break;
                 case OSD_UNIT_GA:
                     if (osdConfig()->stats_energy_unit == OSD_STATS_ENERGY_UNIT_MAH) {
-                        moreThanAh = osdFormatCentiNumber(buff, (int32_t)(getMAhDrawn() * 10000.0f * METERS_PER_NAUTICALMILE / totalDistance), 1000, 0, 2, 3);
+                        moreThanAh = osdFormatCentiNumber(buff, (int32_t)(getMAhDrawn() * 10000.0f * (float)METERS_PER_NAUTICALMILE / totalDistance), 1000, 0, 2, 3);
                         if (!moreThanAh) {
                             tfp_sprintf(buff, "%s%c%c", buff, SYM_MAH_NM_0, SYM_MAH_NM_1);
                         } else {
@@ -3781,7 +3914,7 @@ static void osdShowStatsPage2(void)
                             buff[5] = '\0';
                         }
                     } else {
-                        osdFormatCentiNumber(buff, (int32_t)(getMWhDrawn() * 10.0f * METERS_PER_NAUTICALMILE / totalDistance), 0, 2, 0, 3);
+                        osdFormatCentiNumber(buff, (int32_t)(getMWhDrawn() * 10.0f * (float)METERS_PER_NAUTICALMILE / totalDistance), 0, 2, 0, 3);
                         tfp_sprintf(buff, "%s%c", buff, SYM_WH_NM);
                         if (!efficiencyValid) {
                             buff[0] = buff[1] = buff[2] = '-';
@@ -4197,12 +4330,18 @@ textAttributes_t osdGetSystemMessage(char *buff, size_t buff_size, bool isCenter
                     messages[messageCount++] = OSD_MESSAGE_STR(OSD_MSG_WP_RTH_CANCEL);
                 }
                 if (navGetCurrentStateFlags() & NAV_AUTO_WP_DONE) {
-                    messages[messageCount++] = OSD_MESSAGE_STR(OSD_MSG_WP_FINISHED);
+                    const char *finishedMessage = OSD_MESSAGE_STR(OSD_MSG_WP_FINISHED);
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+                    if (posControl.waypointWindow.readFailed) {
+                        finishedMessage = OSD_MESSAGE_STR(OSD_MSG_WP_READ_FAILED);
+                    }
+#endif
+                    messages[messageCount++] = finishedMessage;
                 } else if (NAV_Status.state == MW_NAV_STATE_WP_ENROUTE) {
                     // Countdown display for remaining Waypoints
                     char buf[6];
                     osdFormatDistanceSymbol(buf, posControl.wpDistance, 0);
-                    tfp_sprintf(messageBuf, "TO WP %u/%u (%s)", getGeoWaypointNumber(posControl.activeWaypointIndex), posControl.geoWaypointCount, buf);
+                    tfp_sprintf(messageBuf, "TO WP %u/%u (%s)", getGeoWaypointNumber(posControl.activeWaypointIndex), getGeoWaypointCount(), buf);
                     messages[messageCount++] = messageBuf;
                 } else if (NAV_Status.state == MW_NAV_STATE_HOLD_TIMED) {
                     if (navConfig()->general.flags.waypoint_enforce_altitude && !posControl.wpAltitudeReached) {
@@ -279,7 +279,7 @@ static void osdDrawArtificialHorizonShapes(displayCanvas_t *canvas, float pitchA
         itoa(absLevel, buf, 10);
         int pos = level * pixelsPerDegreeLevel;
         int charY = 9 - pos * 2;
-        int cx = (absLevel >= 100 ? -1.5f : -1.0) * canvas->gridElementWidth;
+        int cx = (absLevel >= 100 ? -1.5f : -1.0f) * canvas->gridElementWidth;
         int px = cx + (pitchOffset + pos) * sx * 2;
         int py = -charY - (pitchOffset + pos) * (1 - sy) * 2;
         displayCanvasDrawString(canvas, px, py, buf, 0);
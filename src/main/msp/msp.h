@@ -34,7 +34,8 @@ typedef enum {
 typedef enum {
     MSP_RESULT_ACK = 1,
     MSP_RESULT_ERROR = -1,
-    MSP_RESULT_NO_REPLY = 0
+    MSP_RESULT_NO_REPLY = 0,
+    MSP_RESULT_CMD_UNKNOWN = -2,    // Not handled by this command processor, never sent
 } mspResult_e;
 
 typedef struct mspPacket_s {
@@ -46,6 +47,7 @@ typedef struct mspPacket_s {
 
 typedef enum {
     MSP_FLAG_DONT_REPLY           = (1 << 0),
+    MSP_FLAG_OUT_ONLY             = (1 << 7),   // Set by msp_serial.c on the commands it runs by itself, only the ones which just return data are run
 } mspFlags_e;
 
 struct serialPort_s;
@@ -33,3 +33,6 @@
 #define MSP2_COMMON_SET_RADAR_POS       0x100B //SET radar position information
 #define MSP2_COMMON_SET_RADAR_ITD       0x100C //SET radar information to display
 
+#define MSP2_COMMON_MULTI               0x100D  //in/out message    Runs a list of commands (u16 each) and returns their replies as {cmd(u16), size(u16), data} entries
+#define MSP2_COMMON_SUBSCRIBE           0x100E  //in/out message    Sets the commands pushed on this port ({cmd(u16), rate Hz(u8)} each, empty to stop), returns how many were accepted (u8)
+
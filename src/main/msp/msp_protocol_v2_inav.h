@@ -80,3 +80,11 @@
 #define MSP2_INAV_SET_SAFEHOME                  0x2039
 
 #define MSP2_INAV_MISC2                         0x203A
+
+#define MSP2_INAV_TASK_HISTOGRAM                0x203B
+
+#define MSP2_INAV_COMMAND_LIST                  0x203C
+
+#define MSP2_INAV_RX_LATENCY                    0x203D
+#define MSP2_INAV_WP_BATCH                      0x203E
+#define MSP2_INAV_SET_WP_BATCH                  0x203F
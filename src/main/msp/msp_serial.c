@@ -35,6 +35,7 @@
 #include "fc/cli.h"
 
 #include "msp/msp.h"
+#include "msp/msp_protocol.h"
 #include "msp/msp_serial.h"
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
@@ -389,7 +390,154 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
     return mspSerialSendFrame(msp, hdrBuf, hdrLen, sbufPtr(&packet->buf), dataLen, crcBuf, crcLen);
 }
 
-static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+// Every MSP2_COMMON_MULTI reply entry starts with the command and the size
+// of its data, both u16
+#define MSP_MULTI_ENTRY_HEADER_SIZE     4
+
+/*
+ * Run a command which only returns data on behalf of MSP2_COMMON_MULTI or
+ * MSP2_COMMON_SUBSCRIBE, with an empty payload. The handlers don't bound
+ * check their writes, so buf must be as large as the reply buffer of a
+ * single request. Returns the size of the reply, or -1 if the command
+ * isn't one which just returns data, failed or didn't reply. Reboots and
+ * such are only honoured when requested explicitly, commands which ask
+ * for them are treated as failed.
+ */
+static int mspSerialProcessOutCommand(uint16_t cmdMSP, uint8_t *buf, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    mspPacket_t command = {
+        .buf = { .ptr = NULL, .end = NULL, },
+        .cmd = cmdMSP,
+        .flags = MSP_FLAG_OUT_ONLY,
+        .result = 0,
+    };
+    mspPacket_t reply = {
+        .buf = { .ptr = buf, .end = buf + MSP_PORT_OUTBUF_SIZE, },
+        .cmd = -1,
+        .flags = 0,
+        .result = 0,
+    };
+
+    mspPostProcessFnPtr mspPostProcessFn = NULL;
+    if (mspProcessCommandFn(&command, &reply, &mspPostProcessFn) != MSP_RESULT_ACK || mspPostProcessFn) {
+        return -1;
+    }
+
+    return sbufPtr(&reply.buf) - buf;
+}
+
+/*
+ * MSP2_COMMON_MULTI: run each of the requested commands with an empty
+ * payload and pack their replies back to back in a single frame. Only
+ * commands which just return data are run, the ones which fail, don't
+ * reply or don't fit in a frame on their own are left out. The frame ends
+ * at the first reply which doesn't fit in what's left of it. The client is
+ * expected to request whatever is missing from the reply on its own, which
+ * is also the way to talk to firmwares without MSP2_COMMON_MULTI (they
+ * reply with an error).
+ *
+ * Each command replies into a buffer of its own, which is only copied into
+ * the frame when it fits. Kept out of line, so these buffers don't add up
+ * with the one used for single requests.
+ */
+static __attribute__((noinline)) void mspSerialProcessMultiCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    uint8_t outBuf[MSP_MULTI_REPLY_SIZE];
+    uint8_t subReplyBuf[MSP_PORT_OUTBUF_SIZE];
+
+    sbuf_t src = { .ptr = msp->inBuf, .end = msp->inBuf + msp->dataSize, };
+    mspPacket_t reply = {
+        .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
+        .cmd = MSP2_COMMON_MULTI,
+        .flags = 0,
+        .result = MSP_RESULT_ACK,
+    };
+
+    while (sbufBytesRemaining(&src) >= 2) {
+        const uint16_t subCmd = sbufReadU16(&src);
+        if (subCmd == MSP2_COMMON_MULTI || subCmd == MSP2_COMMON_SUBSCRIBE) {
+            continue;
+        }
+
+        const int size = mspSerialProcessOutCommand(subCmd, subReplyBuf, mspProcessCommandFn);
+        if (size < 0 || MSP_MULTI_ENTRY_HEADER_SIZE + size > MSP_MULTI_REPLY_SIZE) {
+            continue;
+        }
+        if (MSP_MULTI_ENTRY_HEADER_SIZE + size > sbufBytesRemaining(&reply.buf)) {
+            break;
+        }
+
+        sbufWriteU16(&reply.buf, subCmd);
+        sbufWriteU16(&reply.buf, size);
+        sbufWriteData(&reply.buf, subReplyBuf, size);
+    }
+
+    if (!(msp->cmdFlags & MSP_FLAG_DONT_REPLY)) {
+        sbufSwitchToReader(&reply.buf, outBuf);
+        mspSerialEncode(msp, &reply, msp->mspVersion);
+    }
+
+    msp->c_state = MSP_IDLE;
+}
+
+/*
+ * MSP2_COMMON_SUBSCRIBE: replace the commands pushed on this port by the
+ * ones in the request, each with its rate in Hz. Only commands which just
+ * return data are accepted, they are run once to check for it. Entries
+ * with a zero rate or beyond MSP_MAX_SUBSCRIPTIONS are ignored, an empty
+ * list stops the pushes. The reply holds the number of accepted entries,
+ * the pushes are sent with the MSP version of this request. Kept out of
+ * line for the same reason as mspSerialProcessMultiCommand().
+ */
+static __attribute__((noinline)) void mspSerialProcessSubscribeCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    uint8_t outBuf[1];
+    uint8_t checkBuf[MSP_PORT_OUTBUF_SIZE];
+
+    sbuf_t src = { .ptr = msp->inBuf, .end = msp->inBuf + msp->dataSize, };
+    const timeMs_t currentTimeMs = millis();
+
+    msp->subscriptionCount = 0;
+    msp->subscriptionIndex = 0;
+    msp->subscriptionVersion = msp->mspVersion;
+
+    while (sbufBytesRemaining(&src) >= 3) {
+        const uint16_t subCmd = sbufReadU16(&src);
+        const uint8_t rateHz = sbufReadU8(&src);
+
+        // Both need a payload to do anything useful
+        if (rateHz == 0 || subCmd == MSP2_COMMON_MULTI || subCmd == MSP2_COMMON_SUBSCRIBE || msp->subscriptionCount >= MSP_MAX_SUBSCRIPTIONS) {
+            continue;
+        }
+
+        if (mspSerialProcessOutCommand(subCmd, checkBuf, mspProcessCommandFn) < 0) {
+            continue;
+        }
+
+        mspSubscription_t *subscription = &msp->subscriptions[msp->subscriptionCount++];
+        subscription->cmd = subCmd;
+        subscription->intervalMs = 1000 / rateHz;
+        subscription->nextPushMs = currentTimeMs;
+    }
+
+    if (!(msp->cmdFlags & MSP_FLAG_DONT_REPLY)) {
+        mspPacket_t reply = {
+            .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
+            .cmd = MSP2_COMMON_SUBSCRIBE,
+            .flags = 0,
+            .result = MSP_RESULT_ACK,
+        };
+        sbufWriteU8(&reply.buf, msp->subscriptionCount);
+        sbufSwitchToReader(&reply.buf, outBuf);
+        mspSerialEncode(msp, &reply, msp->mspVersion);
+    }
+
+    msp->c_state = MSP_IDLE;
+}
+
+// Kept out of line, so its reply buffer doesn't add up with the ones used
+// for MSP2_COMMON_MULTI and MSP2_COMMON_SUBSCRIBE
+static __attribute__((noinline)) mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
 {
     uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
 
@@ -420,6 +568,69 @@ static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspPr
     return mspPostProcessFn;
 }
 
+/*
+ * Push the replies to the subscribed commands which are due. A reply is
+ * only sent when it fits in the free TX space, otherwise the round stops
+ * and resumes from that command on the next call, so the pushes never
+ * block the task or starve the request/response traffic. Replies too big
+ * for the TX buffer are dropped. Kept out of line so its reply buffer
+ * doesn't add up with the one used for the requests.
+ */
+static __attribute__((noinline)) void mspSerialProcessSubscriptions(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
+{
+    const timeMs_t currentTimeMs = millis();
+
+    for (unsigned ii = 0; ii < msp->subscriptionCount; ii++) {
+        const unsigned index = (msp->subscriptionIndex + ii) % msp->subscriptionCount;
+        mspSubscription_t *subscription = &msp->subscriptions[index];
+
+        if (cmp32(currentTimeMs, subscription->nextPushMs) < 0) {
+            continue;
+        }
+
+        uint8_t outBuf[MSP_PORT_OUTBUF_SIZE];
+
+        mspPacket_t reply = {
+            .buf = { .ptr = outBuf, .end = ARRAYEND(outBuf), },
+            .cmd = -1,
+            .flags = 0,
+            .result = 0,
+        };
+
+        mspPacket_t command = {
+            .buf = { .ptr = NULL, .end = NULL, },
+            .cmd = subscription->cmd,
+            .flags = MSP_FLAG_OUT_ONLY,
+            .result = 0,
+        };
+
+        // Reboots and such are only honoured when requested explicitly
+        mspPostProcessFnPtr mspPostProcessFn = NULL;
+        const mspResult_e status = mspProcessCommandFn(&command, &reply, &mspPostProcessFn);
+
+        if (status != MSP_RESULT_NO_REPLY) {
+            sbufSwitchToReader(&reply.buf, outBuf);
+
+            const uint32_t frameSize = MSP_MAX_HEADER_SIZE + sbufBytesRemaining(&reply.buf) + 2;
+            if (serialTxBytesFree(msp->port) >= frameSize) {
+                mspSerialEncode(msp, &reply, msp->subscriptionVersion);
+            } else if (!isSerialTransmitBufferEmpty(msp->port)) {
+                msp->subscriptionIndex = index;
+                return;
+            }
+            // else the reply can't fit in the TX buffer at all, drop it
+        }
+
+        subscription->nextPushMs += subscription->intervalMs;
+        if (cmp32(currentTimeMs, subscription->nextPushMs) >= 0) {
+            // Fell behind, skip the missed pushes instead of bursting them
+            subscription->nextPushMs = currentTimeMs + subscription->intervalMs;
+        }
+    }
+
+    msp->subscriptionIndex = 0;
+}
+
 static void mspEvaluateNonMspData(mspPort_t * mspPort, uint8_t receivedChar)
 {
     if (receivedChar == '#') {
@@ -477,7 +688,13 @@ void mspSerialProcessOnePort(mspPort_t * const mspPort, mspEvaluateNonMspData_e
             }
 
             if (mspPort->c_state == MSP_COMMAND_RECEIVED) {
-                mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
+                if (mspPort->cmdMSP == MSP2_COMMON_MULTI) {
+                    mspSerialProcessMultiCommand(mspPort, mspProcessCommandFn);
+                } else if (mspPort->cmdMSP == MSP2_COMMON_SUBSCRIBE) {
+                    mspSerialProcessSubscribeCommand(mspPort, mspProcessCommandFn);
+                } else {
+                    mspPostProcessFn = mspSerialProcessReceivedCommand(mspPort, mspProcessCommandFn);
+                }
                 break; // process one command at a time so as not to block.
             }
         }
@@ -490,6 +707,11 @@ void mspSerialProcessOnePort(mspPort_t * const mspPort, mspEvaluateNonMspData_e
     else {
         mspProcessPendingRequest(mspPort);
     }
+
+    // The port is gone if it has been taken over by the CLI
+    if (mspPort->port && mspPort->subscriptionCount) {
+        mspSerialProcessSubscriptions(mspPort, mspProcessCommandFn);
+    }
 }
 
 /*
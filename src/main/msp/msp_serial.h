@@ -64,6 +64,9 @@ typedef enum {
 #else
 #define MSP_PORT_OUTBUF_SIZE 512
 #endif
+// MSP2_COMMON_MULTI replies are built next to the buffer for a single reply,
+// so the frame is kept smaller
+#define MSP_MULTI_REPLY_SIZE 512
 
 typedef struct __attribute__((packed)) {
     uint8_t size;
@@ -82,6 +85,15 @@ typedef struct __attribute__((packed)) {
 
 #define MSP_MAX_HEADER_SIZE     9
 
+// Commands a client can have pushed on a port, see MSP2_COMMON_SUBSCRIBE
+#define MSP_MAX_SUBSCRIPTIONS   8
+
+typedef struct mspSubscription_s {
+    uint16_t cmd;
+    uint16_t intervalMs;
+    timeMs_t nextPushMs;
+} mspSubscription_t;
+
 struct serialPort_s;
 typedef struct mspPort_s {
     struct serialPort_s *port; // null when port unused.
@@ -96,6 +108,10 @@ typedef struct mspPort_s {
     uint16_t cmdMSP;
     uint8_t checksum1;
     uint8_t checksum2;
+    mspSubscription_t subscriptions[MSP_MAX_SUBSCRIPTIONS];
+    mspVersion_e subscriptionVersion;
+    uint8_t subscriptionCount;
+    uint8_t subscriptionIndex;  // Where the next push round starts, so a slow link doesn't starve the last ones
 } mspPort_t;
 
 
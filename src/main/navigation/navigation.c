@@ -53,6 +53,7 @@
 
 #include "navigation/navigation.h"
 #include "navigation/navigation_private.h"
+#include "navigation/navigation_wp_store.h"
 
 #include "rx/rx.h"
 
@@ -238,15 +239,19 @@ void resetGCSFlags(void);
 static void setupJumpCounters(void);
 static void resetJumpCounter(void);
 static void clearJumpCounters(void);
+#if !defined(USE_FLASH_WAYPOINT_STORAGE)
+static bool isWaypointWindowAtMissionEnd(void);
+static bool waitForWaypointWindow(void);
+#endif
 
-static void calculateAndSetActiveWaypoint(const navWaypoint_t * waypoint);
+static void calculateAndSetActiveWaypoint(int index);
 static void calculateAndSetActiveWaypointToLocalPosition(const fpVector3_t * pos);
 void calculateInitialHoldPosition(fpVector3_t * pos);
 void calculateFarAwayTarget(fpVector3_t * farAwayPos, int32_t yaw, int32_t distance);
 void calculateNewCruiseTarget(fpVector3_t * origin, int32_t yaw, int32_t distance);
 static bool isWaypointPositionReached(const fpVector3_t * pos, const bool isWaypointHome);
 bool isWaypointAltitudeReached(void);
-static void mapWaypointToLocalPosition(fpVector3_t * localPos, const navWaypoint_t * waypoint, geoAltitudeConversionMode_e altConv);
+STATIC_UNIT_TESTED void mapWaypointToLocalPosition(fpVector3_t * localPos, const navWaypoint_t * waypoint, geoAltitudeConversionMode_e altConv);
 static navigationFSMEvent_t nextForNonGeoStates(void);
 static bool isWaypointMissionValid(void);
 void missionPlannerSetWaypoint(void);
@@ -775,12 +780,13 @@ static const navigationFSMStateDescriptor_t navFSM[NAV_STATE_COUNT] = {
     [NAV_STATE_WAYPOINT_NEXT] = {
         .persistentId = NAV_PERSISTENT_ID_WAYPOINT_NEXT,
         .onEntry = navOnEnteringState_NAV_STATE_WAYPOINT_NEXT,
-        .timeoutMs = 0,
+        .timeoutMs = 10,
         .stateFlags = NAV_CTL_ALT | NAV_CTL_POS | NAV_CTL_YAW | NAV_REQUIRE_ANGLE | NAV_REQUIRE_MAGHOLD | NAV_REQUIRE_THRTILT | NAV_AUTO_WP,
         .mapToFlightModes = NAV_WP_MODE | NAV_ALTHOLD_MODE,
         .mwState = MW_NAV_STATE_PROCESS_NEXT,
         .mwError = MW_NAV_ERROR_NONE,
         .onEvent = {
+            [NAV_FSM_EVENT_TIMEOUT]                        = NAV_STATE_WAYPOINT_NEXT,   // waiting for the next waypoint to be read from flash
             [NAV_FSM_EVENT_SUCCESS]                        = NAV_STATE_WAYPOINT_PRE_ACTION,
             [NAV_FSM_EVENT_SWITCH_TO_WAYPOINT_FINISHED]    = NAV_STATE_WAYPOINT_FINISHED,
         }
@@ -1211,7 +1217,7 @@ static navigationFSMEvent_t navOnEnteringState_NAV_STATE_RTH_CLIMB_TO_SAFE_ALT(n
     }
 
     const uint8_t rthClimbMarginPercent = STATE(FIXED_WING_LEGACY) ? FW_RTH_CLIMB_MARGIN_PERCENT : MR_RTH_CLIMB_MARGIN_PERCENT;
-    const float rthAltitudeMargin = MAX(FW_RTH_CLIMB_MARGIN_MIN_CM, (rthClimbMarginPercent/100.0) * fabsf(posControl.rthState.rthInitialAltitude - posControl.rthState.homePosition.pos.z));
+    const float rthAltitudeMargin = MAX(FW_RTH_CLIMB_MARGIN_MIN_CM, (rthClimbMarginPercent/100.0f) * fabsf(posControl.rthState.rthInitialAltitude - posControl.rthState.homePosition.pos.z));
 
     // If we reached desired initial RTH altitude or we don't want to climb first
     if (((navGetCurrentActualPositionAndVelocity()->pos.z - posControl.rthState.rthInitialAltitude) > -rthAltitudeMargin) || (navConfig()->general.flags.rth_climb_first == OFF) || rthAltControlStickOverrideCheck(ROLL) || rthClimbStageActiveAndComplete()) {
@@ -1426,6 +1432,14 @@ static navigationFSMEvent_t navOnEnteringState_NAV_STATE_WAYPOINT_INITIALIZE(nav
 {
     UNUSED(previousState);
 
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    posControl.waypointWindow.readFailed = false;
+    posControl.waypointWindow.waiting = false;
+    if (posControl.wpMissionRestart) {
+        rewindWaypointWindow();
+    }
+#endif
+
     if (posControl.waypointCount == 0 || !posControl.waypointListValid) {
         return NAV_FSM_EVENT_ERROR;
     }
@@ -1459,11 +1473,19 @@ static navigationFSMEvent_t navOnEnteringState_NAV_STATE_WAYPOINT_INITIALIZE(nav
 static navigationFSMEvent_t nextForNonGeoStates(void)
 {
         /* simple helper for non-geographical states that just set other data */
-    const bool isLastWaypoint = (posControl.waypointList[posControl.activeWaypointIndex].flag == NAV_WP_FLAG_LAST) || (posControl.activeWaypointIndex >= (posControl.waypointCount - 1));
+    const bool isLastLoadedWaypoint = posControl.activeWaypointIndex >= (posControl.waypointCount - 1);
+    const bool isLastWaypoint = (posControl.waypointList[posControl.activeWaypointIndex].flag == NAV_WP_FLAG_LAST) || (isLastLoadedWaypoint && isWaypointWindowAtMissionEnd());
 
     if (isLastWaypoint) {
             // non-geo state is the last waypoint, switch to finish.
         return NAV_FSM_EVENT_SWITCH_TO_WAYPOINT_FINISHED;
+    } else if (isLastLoadedWaypoint) {
+        // Rest of the mission not read from flash yet, re-process the state until it is
+        if (waitForWaypointWindow()) {
+            return NAV_FSM_EVENT_NONE;
+        }
+        // The flash didn't deliver, end the mission here
+        return NAV_FSM_EVENT_SWITCH_TO_WAYPOINT_FINISHED;
     } else {
             // Finished non-geo,  move to next WP
         posControl.activeWaypointIndex++;
@@ -1480,7 +1502,7 @@ static navigationFSMEvent_t navOnEnteringState_NAV_STATE_WAYPOINT_PRE_ACTION(nav
         case NAV_WP_ACTION_HOLD_TIME:
         case NAV_WP_ACTION_WAYPOINT:
         case NAV_WP_ACTION_LAND:
-            calculateAndSetActiveWaypoint(&posControl.waypointList[posControl.activeWaypointIndex]);
+            calculateAndSetActiveWaypoint(posControl.activeWaypointIndex);
             posControl.wpInitialDistance = calculateDistanceToDestination(&posControl.activeWaypoint.pos);
             posControl.wpInitialAltitude = posControl.actualState.abs.pos.z;
             posControl.wpAltitudeReached = false;
@@ -1504,8 +1526,7 @@ static navigationFSMEvent_t navOnEnteringState_NAV_STATE_WAYPOINT_PRE_ACTION(nav
         case NAV_WP_ACTION_SET_POI:
             if (STATE(MULTIROTOR)) {
                 wpHeadingControl.mode = NAV_WP_HEAD_MODE_POI;
-                mapWaypointToLocalPosition(&wpHeadingControl.poi_pos,
-                                           &posControl.waypointList[posControl.activeWaypointIndex], GEO_ALT_RELATIVE);
+                wpHeadingControl.poi_pos = getWaypointCacheEntry(posControl.activeWaypointIndex)->pos;
             }
             return nextForNonGeoStates();
 
@@ -1674,6 +1695,14 @@ static navigationFSMEvent_t navOnEnteringState_NAV_STATE_WAYPOINT_NEXT(navigatio
     if (isLastMissionWaypoint()) {      // Last waypoint reached
         return NAV_FSM_EVENT_SWITCH_TO_WAYPOINT_FINISHED;
     }
+    else if (posControl.activeWaypointIndex >= (posControl.waypointCount - 1)) {
+        // Next waypoint not read from flash yet, hold here and retry on timeout
+        if (waitForWaypointWindow()) {
+            return NAV_FSM_EVENT_NONE;
+        }
+        // The flash didn't deliver, end the mission here
+        return NAV_FSM_EVENT_SWITCH_TO_WAYPOINT_FINISHED;
+    }
     else {
         // Waypoint reached, do something and move on to next waypoint
         posControl.activeWaypointIndex++;
@@ -2899,6 +2928,7 @@ void setWaypoint(uint8_t wpNumber, const navWaypoint_t * wpData)
 
                 posControl.waypointCount = wpNumber;
                 posControl.waypointListValid = (wpData->flag == NAV_WP_FLAG_LAST);
+                invalidateWaypointCache();
                 posControl.geoWaypointCount = posControl.waypointCount - nonGeoWaypointCount;
                 if (posControl.waypointListValid) {
                     nonGeoWaypointCount = 0;
@@ -2915,6 +2945,10 @@ void resetWaypointList(void)
         posControl.waypointCount = 0;
         posControl.waypointListValid = false;
         posControl.geoWaypointCount = 0;
+        invalidateWaypointCache();
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+        memset(&posControl.waypointWindow, 0, sizeof(posControl.waypointWindow));
+#endif
 #ifdef USE_MULTI_MISSION
         posControl.loadedMultiMissionIndex = 0;
         posControl.loadedMultiMissionStartWP = 0;
@@ -2932,6 +2966,28 @@ int getWaypointCount(void)
 {
     return posControl.waypointCount;
 }
+
+int getGeoWaypointCount(void)
+{
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    if (posControl.waypointWindow.missionCount) {
+        return posControl.waypointWindow.geoCount;
+    }
+#endif
+    return posControl.geoWaypointCount;
+}
+
+#if !defined(USE_FLASH_WAYPOINT_STORAGE)
+static bool isWaypointWindowAtMissionEnd(void)
+{
+    return true;
+}
+
+static bool waitForWaypointWindow(void)
+{
+    return false;
+}
+#endif
 #ifdef USE_MULTI_MISSION
 void selectMultiMissionIndex(int8_t increment)
 {
@@ -2954,6 +3010,7 @@ void setMultiMissionOnArm(void)
 
         posControl.loadedMultiMissionStartWP = 0;
         posControl.loadedMultiMissionWPCount = 0;
+        invalidateWaypointCache();
     }
 }
 
@@ -3047,6 +3104,16 @@ bool saveNonVolatileWaypointList(void)
     if (ARMING_FLAG(ARMED) || !posControl.waypointListValid)
         return false;
 
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    // Only the window of a paged mission is in RAM
+    if (posControl.waypointWindow.missionCount) {
+        return false;
+    }
+
+    // Otherwise the flash mission would replace this one on the next boot
+    navWpStoreInvalidate();
+#endif
+
     for (int i = 0; i < NAV_MAX_WAYPOINTS; i++) {
         getWaypoint(i + 1, nonVolatileWaypointListMutable(i));
     }
@@ -3067,7 +3134,7 @@ void resetSafeHomes(void)
 }
 #endif
 
-static void mapWaypointToLocalPosition(fpVector3_t * localPos, const navWaypoint_t * waypoint, geoAltitudeConversionMode_e altConv)
+STATIC_UNIT_TESTED void mapWaypointToLocalPosition(fpVector3_t * localPos, const navWaypoint_t * waypoint, geoAltitudeConversionMode_e altConv)
 {
     gpsLocation_t wpLLH;
 
@@ -3085,6 +3152,84 @@ static void mapWaypointToLocalPosition(fpVector3_t * localPos, const navWaypoint
     geoConvertGeodeticToLocal(localPos, &posControl.gpsOrigin, &wpLLH, altConv);
 }
 
+/*-----------------------------------------------------------
+ * Mission waypoints in local coordinates, converted once for
+ * the whole mission instead of on every query. Rebuilt when the
+ * mission or the GPS origin changes.
+ *-----------------------------------------------------------*/
+void invalidateWaypointCache(void)
+{
+    posControl.waypointCache.valid = false;
+}
+
+static bool isWaypointCacheCurrent(void)
+{
+    const navWaypointCache_t *cache = &posControl.waypointCache;
+
+    return cache->valid &&
+        cache->waypointCount == posControl.waypointCount &&
+        cache->origin.valid == posControl.gpsOrigin.valid &&
+        cache->origin.lat == posControl.gpsOrigin.lat &&
+        cache->origin.lon == posControl.gpsOrigin.lon &&
+        cache->origin.alt == posControl.gpsOrigin.alt;
+}
+
+static void updateWaypointCache(void)
+{
+    navWaypointCache_t *cache = &posControl.waypointCache;
+
+    if (isWaypointCacheCurrent()) {
+        return;
+    }
+
+    const fpVector3_t *prevGeoPos = NULL;
+
+    for (int i = 0; i < posControl.waypointCount; i++) {
+        const navWaypoint_t *waypoint = &posControl.waypointList[i];
+        navWaypointCacheEntry_t *entry = &cache->entries[i];
+
+        // Length of the leg to this waypoint, until it is summed below
+        entry->remainingDistance = 0.0f;
+
+        switch (waypoint->action) {
+            case NAV_WP_ACTION_SET_HEAD:
+            case NAV_WP_ACTION_JUMP:
+                entry->pos.x = entry->pos.y = entry->pos.z = 0.0f;
+                break;
+
+            case NAV_WP_ACTION_SET_POI:
+                mapWaypointToLocalPosition(&entry->pos, waypoint, GEO_ALT_RELATIVE);
+                break;
+
+            default:
+                mapWaypointToLocalPosition(&entry->pos, waypoint, waypointMissionAltConvMode(waypoint->p3));
+                if (prevGeoPos) {
+                    entry->remainingDistance = calculateDistanceFromDelta(entry->pos.x - prevGeoPos->x, entry->pos.y - prevGeoPos->y);
+                }
+                prevGeoPos = &entry->pos;
+                break;
+        }
+    }
+
+    // Jumps are not followed, the remaining distance is for a single pass of the mission
+    float remainingDistance = 0.0f;
+    for (int i = posControl.waypointCount - 1; i >= 0; i--) {
+        const float legLength = cache->entries[i].remainingDistance;
+        cache->entries[i].remainingDistance = remainingDistance;
+        remainingDistance += legLength;
+    }
+
+    cache->waypointCount = posControl.waypointCount;
+    cache->origin = posControl.gpsOrigin;
+    cache->valid = true;
+}
+
+const navWaypointCacheEntry_t * getWaypointCacheEntry(int index)
+{
+    updateWaypointCache();
+    return &posControl.waypointCache.entries[index];
+}
+
 static void calculateAndSetActiveWaypointToLocalPosition(const fpVector3_t * pos)
 {
     posControl.activeWaypoint.pos = *pos;
@@ -3101,17 +3246,15 @@ geoAltitudeConversionMode_e waypointMissionAltConvMode(geoAltitudeDatumFlag_e da
     return datumFlag == NAV_WP_MSL_DATUM ? GEO_ALT_ABSOLUTE : GEO_ALT_RELATIVE;
 }
 
-static void calculateAndSetActiveWaypoint(const navWaypoint_t * waypoint)
+static void calculateAndSetActiveWaypoint(int index)
 {
-    fpVector3_t localPos;
-    mapWaypointToLocalPosition(&localPos, waypoint, waypointMissionAltConvMode(waypoint->p3));
-    calculateAndSetActiveWaypointToLocalPosition(&localPos);
+    calculateAndSetActiveWaypointToLocalPosition(&getWaypointCacheEntry(index)->pos);
 }
 
 /* Checks if active waypoint is last in mission */
 bool isLastMissionWaypoint(void)
 {
-    return FLIGHT_MODE(NAV_WP_MODE) && (posControl.activeWaypointIndex >= (posControl.waypointCount - 1) ||
+    return FLIGHT_MODE(NAV_WP_MODE) && ((posControl.activeWaypointIndex >= (posControl.waypointCount - 1) && isWaypointWindowAtMissionEnd()) ||
             (posControl.waypointList[posControl.activeWaypointIndex].flag == NAV_WP_FLAG_LAST));
 }
 
@@ -3504,13 +3647,22 @@ bool navigationTerrainFollowingEnabled(void)
 
 uint32_t distanceToFirstWP(void)
 {
-    fpVector3_t startingWaypointPos;
 #ifdef USE_MULTI_MISSION
-    mapWaypointToLocalPosition(&startingWaypointPos, &posControl.waypointList[posControl.loadedMultiMissionStartWP], GEO_ALT_RELATIVE);
+    return calculateDistanceToDestination(&getWaypointCacheEntry(posControl.loadedMultiMissionStartWP)->pos);
 #else
-    mapWaypointToLocalPosition(&startingWaypointPos, &posControl.waypointList[0], GEO_ALT_RELATIVE);
+    return calculateDistanceToDestination(&getWaypointCacheEntry(0)->pos);
 #endif
-    return calculateDistanceToDestination(&startingWaypointPos);
+}
+
+// Reported in MSP_NAV_STATUS. A mission paged from flash is only covered
+// up to the last waypoint in waypointList.
+uint32_t distanceToMissionEnd(void)
+{
+    if (!(navGetCurrentStateFlags() & NAV_AUTO_WP) || posControl.activeWaypointIndex >= posControl.waypointCount) {
+        return 0;
+    }
+
+    return posControl.wpDistance + getWaypointCacheEntry(posControl.activeWaypointIndex)->remainingDistance;
 }
 
 navArmingBlocker_e navigationIsBlockingArming(bool *usedBypass)
@@ -3669,6 +3821,7 @@ void missionPlannerSetWaypoint(void)
 
     posControl.wpPlannerActiveWPIndex += 1;
     posControl.waypointCount = posControl.geoWaypointCount = posControl.wpPlannerActiveWPIndex;
+    invalidateWaypointCache();
     posControl.wpMissionPlannerStatus = posControl.waypointCount == NAV_MAX_WAYPOINTS ? WP_PLAN_FULL : WP_PLAN_OK;
     boxWPModeIsReset = false;
 }
@@ -487,12 +487,20 @@ void getEstimatedPositionAndVelocity(navPositionAndVelocity_t * pos);
 
 /* Waypoint list access functions */
 int getWaypointCount(void);
+int getGeoWaypointCount(void);
 bool isWaypointListValid(void);
 void getWaypoint(uint8_t wpNumber, navWaypoint_t * wpData);
 void setWaypoint(uint8_t wpNumber, const navWaypoint_t * wpData);
 void resetWaypointList(void);
 bool loadNonVolatileWaypointList(bool clearIfLoaded);
 bool saveNonVolatileWaypointList(void);
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+uint16_t getStoredWaypointCount(void);
+bool getStoredWaypoint(uint16_t index, navWaypoint_t * wpData);
+bool setStoredWaypoint(uint16_t index, const navWaypoint_t * wpData);
+bool loadStoredWaypointMission(void);
+void updateWaypointWindow(void);
+#endif
 #ifdef USE_MULTI_MISSION
 void selectMultiMissionIndex(int8_t increment);
 void setMultiMissionOnArm(void);
@@ -542,6 +550,7 @@ geoAltitudeConversionMode_e waypointMissionAltConvMode(geoAltitudeDatumFlag_e da
 /* Distance/bearing calculation */
 bool navCalculatePathToDestination(navDestinationPath_t *result, const fpVector3_t * destinationPos);
 uint32_t distanceToFirstWP(void);
+uint32_t distanceToMissionEnd(void);
 
 /* Failsafe-forced RTH mode */
 void activateForcedRTH(void);
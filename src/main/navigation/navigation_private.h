@@ -321,6 +321,30 @@ typedef struct {
     fpVector3_t             homeTmpWaypoint;        // Temporary storage for home target
 } rthState_t;
 
+typedef struct {
+    fpVector3_t     pos;                    // Local position, filled for geospatial and POI waypoints
+    float           remainingDistance;      // Along the mission legs from this waypoint to the last one [cm]
+} navWaypointCacheEntry_t;
+
+typedef struct {
+    navWaypointCacheEntry_t entries[NAV_MAX_WAYPOINTS];
+    bool                    valid;
+    int8_t                  waypointCount;  // Mission and origin the entries were calculated for
+    gpsOrigin_t             origin;
+} navWaypointCache_t;
+
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+typedef struct {
+    uint16_t                missionCount;   // Waypoints in the flash mission, 0 if waypointList holds the whole mission
+    uint16_t                start;          // Mission index of waypointList[0]
+    uint16_t                geoStart;       // Geospatial waypoints before waypointList[0]
+    uint16_t                geoCount;       // Geospatial waypoints in the whole mission
+    timeMs_t                waitStartMs;    // When the waypoint FSM started waiting for the next read
+    bool                    waiting;        // Waypoint FSM holds at the end of the window
+    bool                    readFailed;     // Mission ended early, the next waypoint couldn't be read
+} navWaypointWindow_t;
+#endif
+
 typedef enum {
     RTH_HOME_ENROUTE_INITIAL,       // Initial position for RTH approach
     RTH_HOME_ENROUTE_PROPORTIONAL,  // Prorpotional position for RTH approach
@@ -367,6 +391,10 @@ typedef struct {
     bool                        waypointListValid;
     int8_t                      waypointCount;
     int8_t                      geoWaypointCount;           // total geospatial WPs in mission
+    navWaypointCache_t          waypointCache;              // waypointList in local coordinates
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+    navWaypointWindow_t         waypointWindow;             // Part of a flash mission currently in waypointList
+#endif
     bool                        wpMissionRestart;           // mission restart from first waypoint
 
     /* WP Mission planner */
@@ -412,6 +440,13 @@ const navEstimatedPosVel_t * navGetCurrentActualPositionAndVelocity(void);
 bool isThrustFacingDownwards(void);
 uint32_t calculateDistanceToDestination(const fpVector3_t * destinationPos);
 int32_t calculateBearingToDestination(const fpVector3_t * destinationPos);
+const navWaypointCacheEntry_t * getWaypointCacheEntry(int index);
+void invalidateWaypointCache(void);
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+bool isWaypointWindowAtMissionEnd(void);
+bool waitForWaypointWindow(void);
+void rewindWaypointWindow(void);
+#endif
 void resetLandingDetector(void);
 bool isLandingDetected(void);
 
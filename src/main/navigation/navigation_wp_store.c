@@ -0,0 +1,187 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+
+#include "common/utils.h"
+
+#include "drivers/flash.h"
+
+#include "navigation/navigation_wp_store.h"
+
+#define NAV_WP_STORE_MAGIC      0x50574e49  // "INWP"
+
+typedef struct navWpStoreHeader_s {
+    uint32_t magic;
+    uint16_t count;
+    uint16_t waypointSize;  // sizeof(navWaypoint_t) when the mission was stored
+} navWpStoreHeader_t;
+
+STATIC_ASSERT(sizeof(navWpStoreHeader_t) <= NAV_WP_STORE_SLOT_SIZE, navWpStoreHeader_t_does_not_fit_in_a_slot);
+STATIC_ASSERT(sizeof(navWaypoint_t) <= NAV_WP_STORE_SLOT_SIZE, navWaypoint_t_does_not_fit_in_a_slot);
+
+static int32_t storedCount = -1;    // -1 until the header has been read
+static uint16_t nextWriteIndex;
+
+static flashPartition_t *navWpStorePartition(void)
+{
+    return flashPartitionFindByType(FLASH_PARTITION_TYPE_WAYPOINTS);
+}
+
+static uint32_t navWpStoreSlotAddress(const flashPartition_t *partition, uint16_t slot)
+{
+    return partition->startSector * flashGetGeometry()->sectorSize + slot * NAV_WP_STORE_SLOT_SIZE;
+}
+
+static bool navWpStoreProgram(uint32_t address, const void *data, int length)
+{
+    // Same address back means programming timed out
+    return flashPageProgram(address, data, length) != address;
+}
+
+static void navWpStoreEraseSectorOfSlot(const flashPartition_t *partition, uint16_t slot)
+{
+    const uint32_t address = navWpStoreSlotAddress(partition, slot);
+    const uint32_t sectorSize = flashGetGeometry()->sectorSize;
+
+    // Only starts the erase, the next program waits for it to finish
+    if (address % sectorSize == 0 && address / sectorSize <= partition->endSector) {
+        flashEraseSector(address);
+    }
+}
+
+bool navWpStoreIsAvailable(void)
+{
+    return navWpStorePartition() != NULL;
+}
+
+bool navWpStoreIsReady(void)
+{
+    return flashIsReady();
+}
+
+uint16_t navWpStoreGetCount(void)
+{
+    const flashPartition_t *partition = navWpStorePartition();
+
+    if (!partition) {
+        return 0;
+    }
+
+    if (storedCount < 0) {
+        navWpStoreHeader_t header;
+        storedCount = 0;
+        if (flashReadBytes(navWpStoreSlotAddress(partition, 0), (uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+            header.magic == NAV_WP_STORE_MAGIC && header.waypointSize == sizeof(navWaypoint_t) &&
+            header.count > 0 && header.count <= NAV_FLASH_MAX_WAYPOINTS) {
+            storedCount = header.count;
+        }
+    }
+
+    return storedCount;
+}
+
+bool navWpStoreWrite(uint16_t index, const navWaypoint_t *waypoint)
+{
+    flashPartition_t *partition = navWpStorePartition();
+
+    if (!partition || index >= NAV_FLASH_MAX_WAYPOINTS) {
+        return false;
+    }
+
+    if (index == 0) {
+        // Drops the header along with the previous mission
+        navWpStoreEraseSectorOfSlot(partition, 0);
+        storedCount = 0;
+    } else if (index != nextWriteIndex) {
+        return false;
+    }
+
+    if (!navWpStoreProgram(navWpStoreSlotAddress(partition, index + 1), waypoint, sizeof(*waypoint))) {
+        nextWriteIndex = 0;
+        return false;
+    }
+
+    nextWriteIndex = index + 1;
+
+    // Sectors are erased one at a time as the mission reaches them, so a
+    // write never waits for more than one. Starting the erase now lets it
+    // run while the next waypoints are on their way.
+    navWpStoreEraseSectorOfSlot(partition, index + 2);
+
+    if (waypoint->flag == NAV_WP_FLAG_LAST) {
+        const navWpStoreHeader_t header = {
+            .magic = NAV_WP_STORE_MAGIC,
+            .count = index + 1,
+            .waypointSize = sizeof(navWaypoint_t),
+        };
+        nextWriteIndex = 0;
+        if (!navWpStoreProgram(navWpStoreSlotAddress(partition, 0), &header, sizeof(header))) {
+            return false;
+        }
+        storedCount = header.count;
+    }
+
+    return true;
+}
+
+void navWpStoreInvalidate(void)
+{
+    const flashPartition_t *partition = navWpStorePartition();
+
+    nextWriteIndex = 0;
+
+    if (!partition) {
+        return;
+    }
+
+    // Programming can only clear bits, so zeroing the header needs no erase
+    const navWpStoreHeader_t header = { 0 };
+    navWpStoreProgram(navWpStoreSlotAddress(partition, 0), &header, sizeof(header));
+    storedCount = -1;
+}
+
+bool navWpStoreRead(uint16_t index, navWaypoint_t *waypoints, uint16_t count)
+{
+    const flashPartition_t *partition = navWpStorePartition();
+
+    if (!partition || index + count > navWpStoreGetCount()) {
+        return false;
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        if (flashReadBytes(navWpStoreSlotAddress(partition, index + i + 1), (uint8_t *)&waypoints[i], sizeof(navWaypoint_t)) != sizeof(navWaypoint_t)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "navigation/navigation.h"
+
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+
+/*
+ * Waypoint missions longer than NAV_MAX_WAYPOINTS, kept in their own
+ * partition of the external flash. Each waypoint takes a fixed size slot,
+ * so slots never cross a flash page. Slot 0 holds the header, which is
+ * only written once the last waypoint of the mission has been stored.
+ */
+#define NAV_WP_STORE_SLOT_SIZE  32
+#define NAV_WP_STORE_SIZE       ((NAV_FLASH_MAX_WAYPOINTS + 1) * NAV_WP_STORE_SLOT_SIZE)
+
+bool navWpStoreIsAvailable(void);
+bool navWpStoreIsReady(void);
+// Number of waypoints in the stored mission, 0 if there's no complete one
+uint16_t navWpStoreGetCount(void);
+// Waypoints must be written in order. Index 0 erases the previous mission
+// and NAV_WP_FLAG_LAST completes the new one.
+bool navWpStoreWrite(uint16_t index, const navWaypoint_t *waypoint);
+// Drops the stored mission and any upload in progress
+void navWpStoreInvalidate(void);
+bool navWpStoreRead(uint16_t index, navWaypoint_t *waypoints, uint16_t count);
+
+#endif
@@ -0,0 +1,240 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+
+#include "common/utils.h"
+
+#include "drivers/time.h"
+
+#include "fc/runtime_config.h"
+
+#include "navigation/navigation.h"
+#include "navigation/navigation_private.h"
+#include "navigation/navigation_wp_store.h"
+
+/*-----------------------------------------------------------
+ * Missions stored in flash
+ *
+ * Missions which fit in waypointList are loaded like any other.
+ * Longer ones are paged: waypointList holds a window of the mission,
+ * topped up from flash a few waypoints at a time by the AUX task and
+ * slid forward once the active waypoint is past its middle. The
+ * waypoint FSM only ever works on the window, so it never waits on
+ * flash I/O unless it catches up with the end of the window.
+ *-----------------------------------------------------------*/
+#define NAV_WP_WINDOW_READ_CHUNK    8   // Waypoints read from flash per call, ~200 bytes over SPI
+#define NAV_WP_WINDOW_WAIT_MS       2000    // The mission ends if the next waypoint isn't read by then
+
+static bool isGeoWaypoint(const navWaypoint_t * waypoint)
+{
+    return !(waypoint->action == NAV_WP_ACTION_SET_POI || waypoint->action == NAV_WP_ACTION_SET_HEAD || waypoint->action == NAV_WP_ACTION_JUMP);
+}
+
+bool isWaypointWindowAtMissionEnd(void)
+{
+    const navWaypointWindow_t *window = &posControl.waypointWindow;
+    return window->start + posControl.waypointCount >= window->missionCount;
+}
+
+static bool fillWaypointWindow(void)
+{
+    const navWaypointWindow_t *window = &posControl.waypointWindow;
+    const uint16_t loadedEnd = window->start + posControl.waypointCount;
+    const int count = MIN(MIN(NAV_WP_WINDOW_READ_CHUNK, NAV_MAX_WAYPOINTS - posControl.waypointCount), window->missionCount - loadedEnd);
+
+    if (count <= 0 || !navWpStoreRead(loadedEnd, &posControl.waypointList[posControl.waypointCount], count)) {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (isGeoWaypoint(&posControl.waypointList[posControl.waypointCount + i])) {
+            posControl.geoWaypointCount++;
+        }
+    }
+    posControl.waypointCount += count;
+    posControl.waypointWindow.waiting = false;
+    invalidateWaypointCache();
+
+    return true;
+}
+
+static void slideWaypointWindow(void)
+{
+    navWaypointWindow_t *window = &posControl.waypointWindow;
+    // Keep the previous waypoint, index 0 means the mission hasn't started yet
+    const int shift = posControl.activeWaypointIndex - 1;
+
+    for (int i = 0; i < shift; i++) {
+        if (isGeoWaypoint(&posControl.waypointList[i])) {
+            window->geoStart++;
+            posControl.geoWaypointCount--;
+        }
+    }
+
+    memmove(&posControl.waypointList[0], &posControl.waypointList[shift], (posControl.waypointCount - shift) * sizeof(navWaypoint_t));
+    posControl.waypointCount -= shift;
+    posControl.activeWaypointIndex -= shift;
+    window->start += shift;
+    invalidateWaypointCache();
+}
+
+// Called by the waypoint FSM on every pass it holds at the end of the
+// window, the wait ends when the next chunk is read. Returns false once it
+// has waited too long for the next waypoint, the flash is then taken as
+// failed and the mission ends early.
+bool waitForWaypointWindow(void)
+{
+    navWaypointWindow_t *window = &posControl.waypointWindow;
+    const timeMs_t currentTimeMs = millis();
+
+    if (!window->waiting) {
+        window->waiting = true;
+        window->waitStartMs = currentTimeMs;
+    }
+
+    if (currentTimeMs - window->waitStartMs < NAV_WP_WINDOW_WAIT_MS) {
+        return true;
+    }
+
+    window->waiting = false;
+    window->readFailed = true;
+    return false;
+}
+
+void rewindWaypointWindow(void)
+{
+    navWaypointWindow_t *window = &posControl.waypointWindow;
+
+    if (window->start == 0) {
+        return;
+    }
+
+    // Only the first chunk is read here, the AUX task reads the rest
+    window->start = 0;
+    window->geoStart = 0;
+    posControl.waypointCount = 0;
+    posControl.geoWaypointCount = 0;
+    posControl.activeWaypointIndex = 0;
+    fillWaypointWindow();
+}
+
+void updateWaypointWindow(void)
+{
+    if (isWaypointWindowAtMissionEnd()) {
+        return;
+    }
+
+    if (posControl.activeWaypointIndex > NAV_MAX_WAYPOINTS / 2) {
+        slideWaypointWindow();
+    }
+
+    if (posControl.waypointCount < NAV_MAX_WAYPOINTS && navWpStoreIsReady()) {
+        fillWaypointWindow();
+    }
+}
+
+uint16_t getStoredWaypointCount(void)
+{
+    return navWpStoreGetCount();
+}
+
+bool getStoredWaypoint(uint16_t index, navWaypoint_t * wpData)
+{
+    return navWpStoreRead(index, wpData, 1);
+}
+
+bool setStoredWaypoint(uint16_t index, const navWaypoint_t * wpData)
+{
+    if (ARMING_FLAG(ARMED)) {
+        return false;
+    }
+
+    if (index == 0) {
+        // The mission being replaced may be paged from the flash
+        resetWaypointList();
+    }
+
+    if (!navWpStoreWrite(index, wpData)) {
+        return false;
+    }
+
+    return wpData->flag != NAV_WP_FLAG_LAST || loadStoredWaypointMission();
+}
+
+bool loadStoredWaypointMission(void)
+{
+    if (ARMING_FLAG(ARMED) || posControl.wpPlannerActiveWPIndex) {
+        return false;
+    }
+
+    const uint16_t count = navWpStoreGetCount();
+    if (count == 0) {
+        return false;
+    }
+
+    resetWaypointList();
+
+    navWaypoint_t waypoint;
+    if (count <= NAV_MAX_WAYPOINTS) {
+        for (int i = 0; i < count; i++) {
+            if (!navWpStoreRead(i, &waypoint, 1)) {
+                break;
+            }
+            setWaypoint(i + 1, &waypoint);
+        }
+    } else {
+        // Jump counters and targets can't survive paging, so paged missions can't have jumps
+        uint16_t geoCount = 0;
+        for (int i = 0; i < count; i++) {
+            if (!navWpStoreRead(i, &waypoint, 1) || waypoint.action == NAV_WP_ACTION_JUMP) {
+                return false;
+            }
+            if (isGeoWaypoint(&waypoint)) {
+                geoCount++;
+            }
+        }
+
+        posControl.waypointWindow.missionCount = count;
+        posControl.waypointWindow.geoCount = geoCount;
+        posControl.waypointListValid = true;
+        // Not armed yet, so the whole window is read in one go
+        while (fillWaypointWindow());
+    }
+
+    if (!posControl.waypointListValid || posControl.waypointCount == 0) {
+        resetWaypointList();
+        return false;
+    }
+
+    return true;
+}
+
+#endif
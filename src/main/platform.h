@@ -76,6 +76,9 @@
 #define U_ID_1 (*(uint32_t*)0x1FFFF7B0)
 #define U_ID_2 (*(uint32_t*)0x1FFFF7B4)
 
+#elif defined(SITL_BUILD)
+#include "target/SITL/sitl_platform.h"
+
 #endif
 
 #include "target/common.h"
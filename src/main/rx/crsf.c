@@ -33,7 +33,6 @@ FILE_COMPILE_FOR_SPEED
 
 #include "drivers/time.h"
 #include "drivers/serial.h"
-#include "drivers/serial_uart.h"
 
 #include "io/serial.h"
 #include "io/osd.h"
@@ -50,13 +49,15 @@ FILE_COMPILE_FOR_SPEED
 #define CRSF_PAYLOAD_OFFSET offsetof(crsfFrameDef_t, type)
 #define CRSF_POWER_COUNT 9
 
-STATIC_UNIT_TESTED bool crsfFrameDone = false;
+STATIC_UNIT_TESTED bool crsfRcChannelsDone = false;
+STATIC_UNIT_TESTED bool crsfLinkStatisticsDone = false;
 STATIC_UNIT_TESTED crsfFrame_t crsfFrame;
 
 STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
 
 static serialPort_t *serialPort;
 static timeUs_t crsfFrameStartAt = 0;
+static timeUs_t crsfFrameEndAt = 0;
 static uint8_t telemetryBuf[CRSF_FRAME_SIZE_MAX];
 static uint8_t telemetryBufLen = 0;
 
@@ -126,6 +127,8 @@ typedef struct crsfPayloadLinkStatistics_s {
 
 typedef struct crsfPayloadLinkStatistics_s crsfPayloadLinkStatistics_t;
 
+static crsfPayloadLinkStatistics_t crsfLinkStatistics;
+
 STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
 {
     // CRC includes type and payload
@@ -136,6 +139,70 @@ STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
     return crc;
 }
 
+// The channels are unpacked as soon as the frame is complete, because the
+// frames which follow it in the same DMA burst are received into crsfFrame too
+static void crsfUnpackRcChannels(void)
+{
+    // CRC includes type and payload of each frame
+    const uint8_t crc = crsfFrameCRC();
+    if (crc != crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]) {
+        return;
+    }
+
+    const crsfPayloadRcChannelsPacked_t* rcChannels = (crsfPayloadRcChannelsPacked_t*)&crsfFrame.frame.payload;
+    crsfChannelData[0] = rcChannels->chan0;
+    crsfChannelData[1] = rcChannels->chan1;
+    crsfChannelData[2] = rcChannels->chan2;
+    crsfChannelData[3] = rcChannels->chan3;
+    crsfChannelData[4] = rcChannels->chan4;
+    crsfChannelData[5] = rcChannels->chan5;
+    crsfChannelData[6] = rcChannels->chan6;
+    crsfChannelData[7] = rcChannels->chan7;
+    crsfChannelData[8] = rcChannels->chan8;
+    crsfChannelData[9] = rcChannels->chan9;
+    crsfChannelData[10] = rcChannels->chan10;
+    crsfChannelData[11] = rcChannels->chan11;
+    crsfChannelData[12] = rcChannels->chan12;
+    crsfChannelData[13] = rcChannels->chan13;
+    crsfChannelData[14] = rcChannels->chan14;
+    crsfChannelData[15] = rcChannels->chan15;
+    crsfFrameEndAt = micros();
+    crsfRcChannelsDone = true;
+}
+
+static void crsfFrameComplete(int fullFrameLength)
+{
+    if (crsfFrame.frame.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
+        crsfUnpackRcChannels();
+    } else {
+        const uint8_t crc = crsfFrameCRC();
+        if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
+            switch (crsfFrame.frame.type)
+            {
+                case CRSF_FRAMETYPE_LINK_STATISTICS:
+                    // Copied aside for the same reason as the RC channels
+                    if (crsfFrame.frame.frameLength == CRSF_FRAME_LINK_STATISTICS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC) {
+                        memcpy(&crsfLinkStatistics, crsfFrame.frame.payload, sizeof(crsfLinkStatistics));
+                        crsfLinkStatisticsDone = true;
+                    }
+                    break;
+#if defined(USE_MSP_OVER_TELEMETRY)
+                case CRSF_FRAMETYPE_MSP_REQ:
+                case CRSF_FRAMETYPE_MSP_WRITE: {
+                    uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
+                    if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
+                        crsfScheduleMspResponse();
+                    }
+                    break;
+                }
+#endif
+                default:
+                    break;
+            }
+        }
+    }
+}
+
 // Receive ISR callback, called back from serial port
 STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *rxCallbackData)
 {
@@ -163,100 +230,76 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *rxCallbackData)
 
     if (crsfFramePosition < fullFrameLength) {
         crsfFrame.bytes[crsfFramePosition++] = (uint8_t)c;
-        crsfFrameDone = crsfFramePosition < fullFrameLength ? false : true;
-        if (crsfFrameDone) {
+        if (crsfFramePosition >= fullFrameLength) {
             crsfFramePosition = 0;
-            if (crsfFrame.frame.type != CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
-                const uint8_t crc = crsfFrameCRC();
-                if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
-                    switch (crsfFrame.frame.type)
-                    {
-#if defined(USE_MSP_OVER_TELEMETRY)
-                        case CRSF_FRAMETYPE_MSP_REQ:
-                        case CRSF_FRAMETYPE_MSP_WRITE: {
-                            uint8_t *frameStart = (uint8_t *)&crsfFrame.frame.payload + CRSF_FRAME_ORIGIN_DEST_SIZE;
-                            if (bufferCrsfMspFrame(frameStart, CRSF_FRAME_RX_MSP_FRAME_SIZE)) {
-                                crsfScheduleMspResponse();
-                            }
-                            break;
-                        }
-#endif
-                        default:
-                            break;
-                    }
-                }
-            }
+            crsfFrameComplete(fullFrameLength);
         }
     }
 }
 
+// Frame RX callback, the frames which arrived before the line went idle
+STATIC_UNIT_TESTED void crsfFrameReceive(const uint8_t *data, uint16_t len, void *rxCallbackData)
+{
+    UNUSED(rxCallbackData);
+
+    // The frames have just ended rather than started, which only moves the
+    // telemetry window in half duplex mode back by a frame time
+    crsfFrameStartAt = micros();
+
+    while (len >= CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH) {
+        const int fullFrameLength = data[1] + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH;
+
+        // Cut short or garbled, nothing after it can be trusted either
+        if (data[1] < CRSF_FRAME_LENGTH_TYPE_CRC || fullFrameLength > len || fullFrameLength > CRSF_FRAME_SIZE_MAX) {
+            break;
+        }
+
+        memcpy(crsfFrame.bytes, data, fullFrameLength);
+        crsfFrameComplete(fullFrameLength);
+
+        data += fullFrameLength;
+        len -= fullFrameLength;
+    }
+}
+
+static void crsfProcessLinkStatistics(rxRuntimeConfig_t *rxRuntimeConfig)
+{
+    const crsfPayloadLinkStatistics_t* linkStats = &crsfLinkStatistics;
+    const uint8_t crsftxpowerindex = (linkStats->uplinkTXPower < CRSF_POWER_COUNT) ? linkStats->uplinkTXPower : 0;
+
+    rxLinkStatistics.uplinkRSSI = -1* (linkStats->activeAntenna ? linkStats->uplinkRSSIAnt2 : linkStats->uplinkRSSIAnt1);
+    rxLinkStatistics.uplinkLQ = linkStats->uplinkLQ;
+    rxLinkStatistics.uplinkSNR = linkStats->uplinkSNR;
+    rxLinkStatistics.rfMode = linkStats->rfMode;
+    rxLinkStatistics.uplinkTXPower = crsfTxPowerStatesmW[crsftxpowerindex];
+    rxLinkStatistics.activeAntenna = linkStats->activeAntenna;
+
+    if (rxLinkStatistics.uplinkLQ > 0) {
+        int16_t uplinkStrength;   // RSSI dBm converted to %
+        uplinkStrength = constrain((100 * sq((osdConfig()->rssi_dbm_max - osdConfig()->rssi_dbm_min)) - (100 * sq((osdConfig()->rssi_dbm_max  - rxLinkStatistics.uplinkRSSI)))) / sq((osdConfig()->rssi_dbm_max - osdConfig()->rssi_dbm_min)),0,100);
+        if (rxLinkStatistics.uplinkRSSI >= osdConfig()->rssi_dbm_max )
+            uplinkStrength = 99;
+        else if (rxLinkStatistics.uplinkRSSI < osdConfig()->rssi_dbm_min)
+            uplinkStrength = 0;
+        lqTrackerSet(rxRuntimeConfig->lqTracker, scaleRange(uplinkStrength, 0, 99, 0, RSSI_MAX_VALUE));
+    }
+    else
+        lqTrackerSet(rxRuntimeConfig->lqTracker, 0);
+}
+
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     UNUSED(rxRuntimeConfig);
 
-    if (crsfFrameDone) {
-        crsfFrameDone = false;
-        if (crsfFrame.frame.type == CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
-            // CRC includes type and payload of each frame
-            const uint8_t crc = crsfFrameCRC();
-            if (crc != crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]) {
-                return RX_FRAME_PENDING;
-            }
-            crsfFrame.frame.frameLength = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;
-
-            // unpack the RC channels
-            const crsfPayloadRcChannelsPacked_t* rcChannels = (crsfPayloadRcChannelsPacked_t*)&crsfFrame.frame.payload;
-            crsfChannelData[0] = rcChannels->chan0;
-            crsfChannelData[1] = rcChannels->chan1;
-            crsfChannelData[2] = rcChannels->chan2;
-            crsfChannelData[3] = rcChannels->chan3;
-            crsfChannelData[4] = rcChannels->chan4;
-            crsfChannelData[5] = rcChannels->chan5;
-            crsfChannelData[6] = rcChannels->chan6;
-            crsfChannelData[7] = rcChannels->chan7;
-            crsfChannelData[8] = rcChannels->chan8;
-            crsfChannelData[9] = rcChannels->chan9;
-            crsfChannelData[10] = rcChannels->chan10;
-            crsfChannelData[11] = rcChannels->chan11;
-            crsfChannelData[12] = rcChannels->chan12;
-            crsfChannelData[13] = rcChannels->chan13;
-            crsfChannelData[14] = rcChannels->chan14;
-            crsfChannelData[15] = rcChannels->chan15;
-            return RX_FRAME_COMPLETE;
-        }
-        else if (crsfFrame.frame.type == CRSF_FRAMETYPE_LINK_STATISTICS) {
-            // CRC includes type and payload of each frame
-            const uint8_t crc = crsfFrameCRC();
-            if (crc != crsfFrame.frame.payload[CRSF_FRAME_LINK_STATISTICS_PAYLOAD_SIZE]) {
-                return RX_FRAME_PENDING;
-            }
-            crsfFrame.frame.frameLength = CRSF_FRAME_LINK_STATISTICS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;
-
-            const crsfPayloadLinkStatistics_t* linkStats = (crsfPayloadLinkStatistics_t*)&crsfFrame.frame.payload;
-            const uint8_t crsftxpowerindex = (linkStats->uplinkTXPower < CRSF_POWER_COUNT) ? linkStats->uplinkTXPower : 0;
-
-            rxLinkStatistics.uplinkRSSI = -1* (linkStats->activeAntenna ? linkStats->uplinkRSSIAnt2 : linkStats->uplinkRSSIAnt1);
-            rxLinkStatistics.uplinkLQ = linkStats->uplinkLQ;
-            rxLinkStatistics.uplinkSNR = linkStats->uplinkSNR;
-            rxLinkStatistics.rfMode = linkStats->rfMode;
-            rxLinkStatistics.uplinkTXPower = crsfTxPowerStatesmW[crsftxpowerindex];
-            rxLinkStatistics.activeAntenna = linkStats->activeAntenna;
-
-            if (rxLinkStatistics.uplinkLQ > 0) {
-                int16_t uplinkStrength;   // RSSI dBm converted to %
-                uplinkStrength = constrain((100 * sq((osdConfig()->rssi_dbm_max - osdConfig()->rssi_dbm_min)) - (100 * sq((osdConfig()->rssi_dbm_max  - rxLinkStatistics.uplinkRSSI)))) / sq((osdConfig()->rssi_dbm_max - osdConfig()->rssi_dbm_min)),0,100);
-                if (rxLinkStatistics.uplinkRSSI >= osdConfig()->rssi_dbm_max )
-                    uplinkStrength = 99;
-                else if (rxLinkStatistics.uplinkRSSI < osdConfig()->rssi_dbm_min)
-                    uplinkStrength = 0;
-                lqTrackerSet(rxRuntimeConfig->lqTracker, scaleRange(uplinkStrength, 0, 99, 0, RSSI_MAX_VALUE));
-            }
-            else
-                lqTrackerSet(rxRuntimeConfig->lqTracker, 0);
+    if (crsfLinkStatisticsDone) {
+        crsfLinkStatisticsDone = false;
+        crsfProcessLinkStatistics(rxRuntimeConfig);
+    }
 
-            // This is not RC channels frame, update channel value but don't indicate frame completion
-            return RX_FRAME_PENDING;
-        }
+    if (crsfRcChannelsDone) {
+        crsfRcChannelsDone = false;
+        rxRuntimeConfig->frameTimeUs = crsfFrameEndAt;
+        return RX_FRAME_COMPLETE;
     }
     return RX_FRAME_PENDING;
 }
@@ -326,6 +369,11 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
         CRSF_PORT_OPTIONS | (tristateWithDefaultOffIsActive(rxConfig->halfDuplex) ? SERIAL_BIDIR : 0)
         );
 
+    if (serialPort) {
+        // One interrupt per frame instead of one per byte, where the UART can do it
+        serialSetRxFrameCallback(serialPort, crsfFrameReceive);
+    }
+
     return serialPort != NULL;
 }
 
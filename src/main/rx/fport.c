@@ -131,6 +131,7 @@ static const smartPortPayload_t emptySmartPortFrame = { .frameId = 0, .valueId =
 typedef struct fportBuffer_s {
     uint8_t data[BUFFER_SIZE];
     uint8_t length;
+    timeUs_t receivedAtUs;
 } fportBuffer_t;
 
 static fportBuffer_t rxBuffer[NUM_RX_BUFFERS];
@@ -157,33 +158,19 @@ static void reportFrameError(uint8_t errorReason) {
     DEBUG_SET(DEBUG_FPORT, DEBUG_FPORT_FRAME_LAST_ERROR, errorReason);
 }
 
-// Receive ISR callback
-static void fportDataReceive(uint16_t c, void *data)
-{
-    UNUSED(data);
-
-    static timeUs_t frameStartAt = 0;
-    static bool escapedCharacter = false;
-    static timeUs_t lastFrameReceivedUs = 0;
-    static bool telemetryFrame = false;
-
-    const timeUs_t currentTimeUs = micros();
-
-    clearToSend = false;
-
-    if (framePosition > 1 && cmpTimeUs(currentTimeUs, frameStartAt) > FPORT_TIME_NEEDED_PER_FRAME_US + 500) {
-        reportFrameError(DEBUG_FPORT_ERROR_TIMEOUT);
-
-        framePosition = 0;
-     }
-
-    uint8_t val = (uint8_t)c;
+static timeUs_t frameStartAt = 0;
+static bool escapedCharacter = false;
+static timeUs_t lastFrameReceivedUs = 0;
+static bool telemetryFrame = false;
 
+static void fportProcessByte(uint8_t val, timeUs_t currentTimeUs)
+{
     if (val == FPORT_FRAME_MARKER) {
         if (framePosition > 1) {
             const uint8_t nextWriteIndex = (rxBufferWriteIndex + 1) % NUM_RX_BUFFERS;
             if (nextWriteIndex != rxBufferReadIndex) {
                 rxBuffer[rxBufferWriteIndex].length = framePosition - 1;
+                rxBuffer[rxBufferWriteIndex].receivedAtUs = currentTimeUs;
                 rxBufferWriteIndex = nextWriteIndex;
             }
 
@@ -226,6 +213,48 @@ static void fportDataReceive(uint16_t c, void *data)
     }
 }
 
+// Receive ISR callback
+static void fportDataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    const timeUs_t currentTimeUs = micros();
+
+    clearToSend = false;
+
+    if (framePosition > 1 && cmpTimeUs(currentTimeUs, frameStartAt) > FPORT_TIME_NEEDED_PER_FRAME_US + 500) {
+        reportFrameError(DEBUG_FPORT_ERROR_TIMEOUT);
+
+        framePosition = 0;
+     }
+
+    fportProcessByte(c, currentTimeUs);
+}
+
+// Frame RX callback. The bytes are unstuffed as they come, but all of them
+// arrived before the line went idle, so there's no timeout to check and the
+// telemetry response delay counts from the end of the frame.
+static void fportFrameReceive(const uint8_t *data, uint16_t len, void *rxCallbackData)
+{
+    UNUSED(rxCallbackData);
+
+    const timeUs_t currentTimeUs = micros();
+
+    clearToSend = false;
+
+    // Whatever was left over from the last burst didn't end with a marker
+    if (framePosition > 1) {
+        reportFrameError(DEBUG_FPORT_ERROR_TIMEOUT);
+    }
+    framePosition = 0;
+    escapedCharacter = false;
+    telemetryFrame = false;
+
+    for (unsigned i = 0; i < len; i++) {
+        fportProcessByte(data[i], currentTimeUs);
+    }
+}
+
 #if defined(USE_TELEMETRY_SMARTPORT)
 static void smartPortWriteFrameFport(const smartPortPayload_t *payload)
 {
@@ -266,6 +295,7 @@ static uint8_t fportFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
                         reportFrameError(DEBUG_FPORT_ERROR_TYPE_SIZE);
                     } else {
                         result = sbusChannelsDecode(rxRuntimeConfig, &frame->data.controlData.channels);
+                        rxRuntimeConfig->frameTimeUs = rxBuffer[rxBufferReadIndex].receivedAtUs;
                         lqTrackerSet(rxRuntimeConfig->lqTracker, scaleRange(frame->data.controlData.rssi, 0, 100, 0, RSSI_MAX_VALUE));
                         lastRcFrameReceivedMs = millis();
                     }
@@ -400,6 +430,9 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
     );
 
     if (fportPort) {
+        // One interrupt per frame instead of one per byte, where the UART can do it
+        serialSetRxFrameCallback(fportPort, fportFrameReceive);
+
 #if defined(USE_TELEMETRY_SMARTPORT)
         telemetryEnabled = initSmartPortTelemetryExternal(smartPortWriteFrameFport);
 #endif
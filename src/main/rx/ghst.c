@@ -35,7 +35,6 @@
 #include "common/utils.h"
 
 #include "drivers/serial.h"
-#include "drivers/serial_uart.h"
 #include "drivers/system.h"
 #include "drivers/time.h"
 
@@ -137,6 +136,25 @@ STATIC_UNIT_TESTED uint8_t ghstFrameCRC(ghstFrame_t *pGhstFrame)
     return crc;
 }
 
+// CRC is ok and the frame is for us
+static bool ghstFrameIsValid(ghstFrame_t *pGhstFrame)
+{
+    const uint8_t crc = ghstFrameCRC(pGhstFrame);
+    const int fullFrameLength = pGhstFrame->frame.len + GHST_FRAME_LENGTH_ADDRESS + GHST_FRAME_LENGTH_FRAMELENGTH;
+    return crc == pGhstFrame->bytes[fullFrameLength - 1] && pGhstFrame->frame.addr == GHST_ADDR_FC;
+}
+
+static void ghstFrameComplete(void)
+{
+    // NOTE: this data is not yet CRC checked, nor do we know whether we are the correct recipient, this is
+    // handled in ghstFrameStatus
+    memcpy(&ghstValidatedFrame, &ghstIncomingFrame, sizeof(ghstIncomingFrame));
+    ghstFrameAvailable = true;
+
+    // remember what time the incoming (Rx) packet ended, so that we can ensure a quite bus before sending telemetry
+    ghstRxFrameEndAtUs = microsISR();
+}
+
 // Receive ISR callback, called back from serial port
 STATIC_UNIT_TESTED void ghstDataReceive(uint16_t c, void *data)
 {
@@ -163,15 +181,35 @@ STATIC_UNIT_TESTED void ghstDataReceive(uint16_t c, void *data)
         ghstIncomingFrame.bytes[ghstFrameIdx++] = (uint8_t)c;
         if (ghstFrameIdx >= fullFrameLength) {
             ghstFrameIdx = 0;
+            ghstFrameComplete();
+        }
+    }
+}
+
+// Frame RX callback, the frames which arrived before the line went idle
+STATIC_UNIT_TESTED void ghstFrameReceive(const uint8_t *data, uint16_t len, void *rxCallbackData)
+{
+    UNUSED(rxCallbackData);
 
-            // NOTE: this data is not yet CRC checked, nor do we know whether we are the correct recipient, this is
-            // handled in ghstFrameStatus
-            memcpy(&ghstValidatedFrame, &ghstIncomingFrame, sizeof(ghstIncomingFrame));
-            ghstFrameAvailable = true;
+    while (len >= GHST_FRAME_LENGTH_ADDRESS + GHST_FRAME_LENGTH_FRAMELENGTH) {
+        const int fullFrameLength = data[1] + GHST_FRAME_LENGTH_ADDRESS + GHST_FRAME_LENGTH_FRAMELENGTH;
 
-            // remember what time the incoming (Rx) packet ended, so that we can ensure a quite bus before sending telemetry
-            ghstRxFrameEndAtUs = microsISR();
+        // Cut short or garbled, nothing after it can be trusted either
+        if (data[1] < GHST_FRAME_LENGTH_TYPE_CRC + 1 || fullFrameLength > len || fullFrameLength > (int)sizeof(ghstIncomingFrame)) {
+            break;
         }
+
+        memcpy(ghstIncomingFrame.bytes, data, fullFrameLength);
+        ghstFrameComplete();
+
+        // Only a single frame is decoded per ghstFrameStatus(), stop at the
+        // first one for us rather than have the rest of the burst overwrite it
+        if (ghstFrameIsValid(&ghstIncomingFrame)) {
+            break;
+        }
+
+        data += fullFrameLength;
+        len -= fullFrameLength;
     }
 }
 
@@ -250,10 +288,9 @@ uint8_t ghstFrameStatus(rxRuntimeConfig_t *rxRuntimeState)
     if (ghstFrameAvailable) {
         ghstFrameAvailable = false;
 
-        const uint8_t crc = ghstFrameCRC(&ghstValidatedFrame);
-        const int fullFrameLength = ghstValidatedFrame.frame.len + GHST_FRAME_LENGTH_ADDRESS + GHST_FRAME_LENGTH_FRAMELENGTH;
-        if (crc == ghstValidatedFrame.bytes[fullFrameLength - 1] && ghstValidatedFrame.frame.addr == GHST_ADDR_FC) {
+        if (ghstFrameIsValid(&ghstValidatedFrame)) {
             ghstValidatedFrameAvailable = true;
+            rxRuntimeState->frameTimeUs = ghstRxFrameEndAtUs;
             return ghstFailsafeFlag | RX_FRAME_COMPLETE | RX_FRAME_PROCESSING_REQUIRED;            // request callback through ghstProcessFrame to do the decoding  work
         }
 
@@ -367,6 +404,11 @@ bool ghstRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeState)
         GHST_PORT_OPTIONS | (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0)
     );
 
+    if (serialPort) {
+        // One interrupt per frame instead of one per byte, where the UART can do it
+        serialSetRxFrameCallback(serialPort, ghstFrameReceive);
+    }
+
     return serialPort != NULL;
 }
 
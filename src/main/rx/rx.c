@@ -96,11 +96,18 @@ static uint8_t rxChannelCount;
 
 static timeUs_t rxNextUpdateAtUs = 0;
 static timeUs_t needRxSignalBefore = 0;
+static timeUs_t rxLastFrameTimeUs = 0;
+static bool rxNewFrame = false;
 static timeUs_t suspendRxSignalUntil = 0;
 static uint8_t skipRxSamples = 0;
 
 static rcChannel_t rcChannels[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 
+static timeUs_t rxLatencyFrameTimeUs;                       // Frame the pending stages are measured from
+static uint8_t rxLatencyPendingStages;
+static timeDelta_t rxLatencyUs[RX_LATENCY_COUNT];
+static int32_t rxLatencyAverageQ4[RX_LATENCY_COUNT];       // 16x the average over ~16 frames
+
 #define SKIP_RC_ON_SUSPEND_PERIOD 1500000           // 1.5 second period in usec (call frequency independent)
 #define SKIP_RC_SAMPLES_ON_RESUME  2                // flush 2 samples to drop wrong measurements (timing independent)
 
@@ -422,6 +429,13 @@ void resumeRxSignal(void)
     failsafeOnRxResume();
 }
 
+static void rxLatencyUpdate(rxLatencyStage_e stage, timeDelta_t latencyUs)
+{
+    rxLatencyUs[stage] = latencyUs;
+    rxLatencyAverageQ4[stage] += latencyUs - (rxLatencyAverageQ4[stage] >> 4);
+    DEBUG_SET(DEBUG_RX_LATENCY, stage, latencyUs);
+}
+
 bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
 {
     UNUSED(currentDeltaTime);
@@ -432,6 +446,9 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
         }
     }
 
+    // Drivers which know better stamp the frame, the others get the time it was picked up
+    rxRuntimeConfig.frameTimeUs = 0;
+
     const uint8_t frameStatus = rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig);
 
     if (frameStatus & RX_FRAME_COMPLETE) {
@@ -439,6 +456,13 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
         rxSignalReceived = (frameStatus & RX_FRAME_FAILSAFE) == 0;
         needRxSignalBefore = currentTimeUs + rxRuntimeConfig.rxSignalTimeout;
         rxDataProcessingRequired = true;
+
+        const timeUs_t frameTimeUs = rxRuntimeConfig.frameTimeUs ? rxRuntimeConfig.frameTimeUs : currentTimeUs;
+        if (rxLastFrameTimeUs) {
+            rxLatencyUpdate(RX_LATENCY_FRAME_INTERVAL, cmpTimeUs(frameTimeUs, rxLastFrameTimeUs));
+        }
+        rxLastFrameTimeUs = frameTimeUs;
+        rxNewFrame = true;
     }
     else if ((frameStatus & RX_FRAME_FAILSAFE) && rxSignalReceived) {
         // All other receiver statuses are allowed to report failsafe, but not allowed to leave it
@@ -496,6 +520,14 @@ bool calculateRxChannelsAndUpdateFailsafe(timeUs_t currentTimeUs)
         return true;
     }
 
+    // The PID loop reports when the new channels reach rcCommand and the motors
+    if (rxNewFrame) {
+        rxNewFrame = false;
+        rxLatencyFrameTimeUs = rxLastFrameTimeUs;
+        rxLatencyPendingStages = BIT(RX_LATENCY_RC_COMMAND) | BIT(RX_LATENCY_MOTOR);
+        rxLatencyUpdate(RX_LATENCY_RX, cmpTimeUs(currentTimeUs, rxLatencyFrameTimeUs));
+    }
+
     rxFlightChannelsValid = true;
 
     // Read and process channel data
@@ -677,6 +709,25 @@ uint16_t rxGetRefreshRate(void)
     return rxRuntimeConfig.rxRefreshRate;
 }
 
+// Called on every PID loop, only the first one after a new frame counts
+void rxLatencyMark(rxLatencyStage_e stage)
+{
+    if (rxLatencyPendingStages & BIT(stage)) {
+        rxLatencyPendingStages &= ~BIT(stage);
+        rxLatencyUpdate(stage, cmpTimeUs(micros(), rxLatencyFrameTimeUs));
+    }
+}
+
+timeDelta_t rxGetLatencyUs(rxLatencyStage_e stage)
+{
+    return rxLatencyUs[stage];
+}
+
+timeDelta_t rxGetAverageLatencyUs(rxLatencyStage_e stage)
+{
+    return rxLatencyAverageQ4[stage] >> 4;
+}
+
 int16_t rxGetChannelValue(unsigned channelNumber)
 {
     if (LOGIC_CONDITION_GLOBAL_FLAG(LOGIC_CONDITION_GLOBAL_FLAG_OVERRIDE_RC_CHANNEL)) {
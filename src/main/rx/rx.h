@@ -168,6 +168,7 @@ typedef struct rxRuntimeConfig_s {
     rxLinkQualityTracker_e * lqTracker;     // Pointer to a
     uint16_t *channelData;
     void *frameData;
+    timeUs_t frameTimeUs;                   // When the frame was received, set by the driver along with RX_FRAME_COMPLETE
 } rxRuntimeConfig_t;
 
 typedef struct rcChannel_s {
@@ -185,6 +186,15 @@ typedef enum {
     RSSI_SOURCE_MSP,
 } rssiSource_e;
 
+// Time from the end of an RX frame to each point where its channels are used
+typedef enum {
+    RX_LATENCY_FRAME_INTERVAL = 0,  // Between the last two frames
+    RX_LATENCY_RX,                  // Channels processed by processRx()
+    RX_LATENCY_RC_COMMAND,          // rcCommand updated in the PID loop
+    RX_LATENCY_MOTOR,               // Motor outputs written
+    RX_LATENCY_COUNT
+} rxLatencyStage_e;
+
 typedef struct rxLinkStatistics_s {
     int16_t     uplinkRSSI;     // RSSI value in dBm
     uint8_t     uplinkLQ;       // A protocol specific measure of the link quality in [0..100]
@@ -225,6 +235,10 @@ void resumeRxSignal(void);
 
 uint16_t rxGetRefreshRate(void);
 
+void rxLatencyMark(rxLatencyStage_e stage);
+timeDelta_t rxGetLatencyUs(rxLatencyStage_e stage);
+timeDelta_t rxGetAverageLatencyUs(rxLatencyStage_e stage);
+
 // Processed RC channel value. These values might include
 // filtering and some extra processing like value holding
 // during failsafe.
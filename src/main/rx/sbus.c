@@ -72,13 +72,45 @@ typedef struct sbusFrameData_s {
     uint8_t buffer[SBUS_FRAME_SIZE];
     uint8_t position;
     timeUs_t lastActivityTimeUs;
+    timeUs_t frameTimeUs;
 } sbusFrameData_t;
 
+static uint16_t sbusDesyncCounter = 0;
+
+static void sbusFrameComplete(sbusFrameData_t *sbusFrameData, const uint8_t *buffer)
+{
+    const sbusFrame_t * frame = (const sbusFrame_t *)buffer;
+    bool frameValid = false;
+
+    // Do some sanity check
+    switch (frame->endByte) {
+        case 0x00:  // This is S.BUS 1
+        case 0x04:  // S.BUS 2 receiver voltage
+        case 0x14:  // S.BUS 2 GPS/baro
+        case 0x24:  // Unknown SBUS2 data
+        case 0x34:  // Unknown SBUS2 data
+            frameValid = true;
+            break;
+
+        default:    // Failed end marker
+            sbusDesyncCounter++;
+            DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_DESYNC_COUNTER, sbusDesyncCounter);
+            break;
+    }
+
+    // Frame seems sane, pass data to decoder
+    if (!sbusFrameData->frameDone && frameValid) {
+        DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_FLAGS, frame->channels.flags);
+
+        memcpy((void *)&sbusFrameData->frame, buffer, SBUS_FRAME_SIZE);
+        sbusFrameData->frameTimeUs = sbusFrameData->lastActivityTimeUs;
+        sbusFrameData->frameDone = true;
+    }
+}
+
 // Receive ISR callback
 static void sbusDataReceive(uint16_t c, void *data)
 {
-    static uint16_t sbusDesyncCounter = 0;
-
     sbusFrameData_t *sbusFrameData = data;
     const timeUs_t currentTimeUs = micros();
     const timeDelta_t timeSinceLastByteUs = cmpTimeUs(currentTimeUs, sbusFrameData->lastActivityTimeUs);
@@ -103,34 +135,8 @@ static void sbusDataReceive(uint16_t c, void *data)
             sbusFrameData->buffer[sbusFrameData->position++] = (uint8_t)c;
 
             if (sbusFrameData->position == SBUS_FRAME_SIZE) {
-                const sbusFrame_t * frame = (sbusFrame_t *)&sbusFrameData->buffer[0];
-                bool frameValid = false;
-
-                // Do some sanity check
-                switch (frame->endByte) {
-                    case 0x00:  // This is S.BUS 1
-                    case 0x04:  // S.BUS 2 receiver voltage
-                    case 0x14:  // S.BUS 2 GPS/baro
-                    case 0x24:  // Unknown SBUS2 data
-                    case 0x34:  // Unknown SBUS2 data
-                        frameValid = true;
-                        sbusFrameData->state = STATE_SBUS_WAIT_SYNC;
-                        break;
-
-                    default:    // Failed end marker
-                        sbusFrameData->state = STATE_SBUS_WAIT_SYNC;
-                        sbusDesyncCounter++;
-                        DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_DESYNC_COUNTER, sbusDesyncCounter);
-                        break;
-                }
-
-                // Frame seems sane, pass data to decoder
-                if (!sbusFrameData->frameDone && frameValid) {
-                    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_FLAGS, frame->channels.flags);
-
-                    memcpy((void *)&sbusFrameData->frame, (void *)&sbusFrameData->buffer[0], SBUS_FRAME_SIZE);
-                    sbusFrameData->frameDone = true;
-                }
+                sbusFrameComplete(sbusFrameData, sbusFrameData->buffer);
+                sbusFrameData->state = STATE_SBUS_WAIT_SYNC;
             }
             break;
 
@@ -141,6 +147,25 @@ static void sbusDataReceive(uint16_t c, void *data)
     }
 }
 
+// Frame RX callback. The receiver leaves a gap after each frame, the line
+// going idle takes the place of the sync interval.
+static void sbusFrameReceive(const uint8_t *data, uint16_t len, void *rxCallbackData)
+{
+    sbusFrameData_t *sbusFrameData = rxCallbackData;
+    const timeUs_t currentTimeUs = micros();
+
+    DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_INTERFRAME_TIME, cmpTimeUs(currentTimeUs, sbusFrameData->lastActivityTimeUs));
+    sbusFrameData->lastActivityTimeUs = currentTimeUs;
+
+    if (len != SBUS_FRAME_SIZE || data[0] != SBUS_FRAME_BEGIN_BYTE) {
+        sbusDesyncCounter++;
+        DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_DESYNC_COUNTER, sbusDesyncCounter);
+        return;
+    }
+
+    sbusFrameComplete(sbusFrameData, data);
+}
+
 static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     sbusFrameData_t *sbusFrameData = rxRuntimeConfig->frameData;
@@ -157,6 +182,7 @@ static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 
     // Calculate "virtual link quality based on packet loss metric"
     if (retValue & RX_FRAME_COMPLETE) {
+        rxRuntimeConfig->frameTimeUs = sbusFrameData->frameTimeUs;
         lqTrackerAccumulate(rxRuntimeConfig->lqTracker, ((retValue & RX_FRAME_DROPPED) || (retValue & RX_FRAME_FAILSAFE)) ? 0 : RSSI_MAX_VALUE);
     }
 
@@ -200,6 +226,11 @@ static bool sbusInitEx(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeC
             (tristateWithDefaultOffIsActive(rxConfig->halfDuplex) ? SERIAL_BIDIR : 0)
         );
 
+    if (sBusPort) {
+        // One interrupt per frame instead of one per byte, where the UART can do it
+        serialSetRxFrameCallback(sBusPort, sbusFrameReceive);
+    }
+
 #ifdef USE_TELEMETRY
     if (portShared) {
         telemetrySharedPort = sBusPort;
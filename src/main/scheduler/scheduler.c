@@ -119,6 +119,172 @@ STATIC_INLINE_UNIT_TESTED cfTask_t *queueNext(void)
     return taskQueueArray[++taskQueuePos]; // guaranteed to be NULL at end of queue
 }
 
+/*
+ * EDF mode. Time driven tasks are kept in min-heaps keyed by their next
+ * deadline (lastExecutedAt + desiredPeriod), so a scheduler pass only has to
+ * look at the top of each heap instead of every queued task. Realtime and idle
+ * tasks get their own heaps to keep the same precedence as the priority mode.
+ * Event driven tasks can't be ordered by deadline before their checkFunc
+ * fires, they are kept in a separate list and polled as before.
+ */
+typedef enum {
+    TASK_HEAP_REALTIME = 0,
+    TASK_HEAP_NORMAL,
+    TASK_HEAP_IDLE,
+    TASK_HEAP_COUNT
+} taskHeapId_e;
+
+typedef struct {
+    cfTask_t *tasks[TASK_COUNT];
+    int size;
+} taskHeap_t;
+
+STATIC_FASTRAM schedulerMode_e schedulerMode = SCHEDULER_MODE_PRIORITY;
+STATIC_FASTRAM taskHeap_t taskHeaps[TASK_HEAP_COUNT];
+STATIC_FASTRAM cfTask_t *eventTasks[TASK_COUNT];
+STATIC_FASTRAM int eventTaskCount;
+
+static inline timeUs_t taskDeadline(const cfTask_t *task)
+{
+    return task->lastExecutedAt + task->desiredPeriod;
+}
+
+static inline bool taskDeadlineBefore(const cfTask_t *a, const cfTask_t *b)
+{
+    return (timeDelta_t)(taskDeadline(a) - taskDeadline(b)) < 0;
+}
+
+static inline bool taskIsDue(const cfTask_t *task, timeUs_t currentTimeUs)
+{
+    return (timeDelta_t)(currentTimeUs - taskDeadline(task)) >= 0;
+}
+
+static taskHeap_t *taskHeapGet(const cfTask_t *task)
+{
+    if (task->staticPriority == TASK_PRIORITY_REALTIME) {
+        return &taskHeaps[TASK_HEAP_REALTIME];
+    } else if (task->staticPriority == TASK_PRIORITY_IDLE) {
+        return &taskHeaps[TASK_HEAP_IDLE];
+    }
+    return &taskHeaps[TASK_HEAP_NORMAL];
+}
+
+static inline void heapPlace(taskHeap_t *heap, int index, cfTask_t *task)
+{
+    heap->tasks[index] = task;
+    task->heapIndex = index;
+}
+
+static void heapSiftUp(taskHeap_t *heap, int index)
+{
+    cfTask_t *task = heap->tasks[index];
+
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        if (!taskDeadlineBefore(task, heap->tasks[parent])) {
+            break;
+        }
+        heapPlace(heap, index, heap->tasks[parent]);
+        index = parent;
+    }
+    heapPlace(heap, index, task);
+}
+
+static void heapSiftDown(taskHeap_t *heap, int index)
+{
+    cfTask_t *task = heap->tasks[index];
+
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && taskDeadlineBefore(heap->tasks[child + 1], heap->tasks[child])) {
+            child++;
+        }
+        if (!taskDeadlineBefore(heap->tasks[child], task)) {
+            break;
+        }
+        heapPlace(heap, index, heap->tasks[child]);
+        index = child;
+    }
+    heapPlace(heap, index, task);
+}
+
+// Number of due tasks in the subtree at index. Subtrees of a task which isn't
+// due can't hold due tasks, so this only visits the due ones.
+static int heapCountDue(const taskHeap_t *heap, int index, timeUs_t currentTimeUs)
+{
+    if (index >= heap->size || !taskIsDue(heap->tasks[index], currentTimeUs)) {
+        return 0;
+    }
+    return 1 + heapCountDue(heap, 2 * index + 1, currentTimeUs) + heapCountDue(heap, 2 * index + 2, currentTimeUs);
+}
+
+static void edfClear(void)
+{
+    for (int ii = 0; ii < TASK_COUNT; ii++) {
+        cfTasks[ii].heapIndex = -1;
+    }
+    memset(taskHeaps, 0, sizeof(taskHeaps));
+    eventTaskCount = 0;
+}
+
+static void edfAdd(cfTask_t *task)
+{
+    if (task->heapIndex >= 0) {
+        return;
+    }
+
+    if (task->checkFunc) {
+        task->heapIndex = eventTaskCount;
+        eventTasks[eventTaskCount++] = task;
+    } else {
+        taskHeap_t *heap = taskHeapGet(task);
+        heap->tasks[heap->size] = task;
+        heapSiftUp(heap, heap->size++);
+    }
+}
+
+static void edfRemove(cfTask_t *task)
+{
+    const int index = task->heapIndex;
+
+    if (index < 0) {
+        return;
+    }
+
+    task->heapIndex = -1;
+
+    if (task->checkFunc) {
+        if (index != --eventTaskCount) {
+            eventTasks[index] = eventTasks[eventTaskCount];
+            eventTasks[index]->heapIndex = index;
+        }
+    } else {
+        taskHeap_t *heap = taskHeapGet(task);
+        if (index == --heap->size) {
+            return;
+        }
+        cfTask_t *moved = heap->tasks[heap->size];
+        heapPlace(heap, index, moved);
+        heapSiftUp(heap, index);
+        heapSiftDown(heap, moved->heapIndex);
+    }
+}
+
+// Restore the heap order after the deadline of a queued task changed
+static void edfUpdate(cfTask_t *task)
+{
+    if (task->heapIndex < 0 || task->checkFunc) {
+        return;
+    }
+
+    taskHeap_t *heap = taskHeapGet(task);
+    heapSiftUp(heap, task->heapIndex);
+    heapSiftDown(heap, task->heapIndex);
+}
+
 void taskSystem(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
@@ -154,6 +320,56 @@ void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t * taskInfo)
     taskInfo->totalExecutionTime = cfTasks[taskId].totalExecutionTime;
     taskInfo->averageExecutionTime = cfTasks[taskId].movingSumExecutionTime / TASK_MOVING_SUM_COUNT;
     taskInfo->latestDeltaTime = cfTasks[taskId].taskLatestDeltaTime;
+    taskInfo->maxLateness = cfTasks[taskId].maxLateness;
+    taskInfo->averageLateness = cfTasks[taskId].movingSumLateness / TASK_MOVING_SUM_COUNT;
+}
+
+void getTaskHistogramInfo(cfTaskId_e taskId, cfTaskHistogramInfo_t *histogramInfo)
+{
+    histogramInfo->executionTime = cfTasks[taskId].executionTimeHistogram;
+    histogramInfo->periodJitter = cfTasks[taskId].periodJitterHistogram;
+}
+
+void FAST_CODE taskHistogramAdd(taskHistogram_t *histogram, timeUs_t value)
+{
+    const int bucket = value ? MIN(32 - __builtin_clz(value), TASK_HISTOGRAM_BUCKET_COUNT - 1) : 0;
+
+    if (++histogram->count[bucket] == UINT16_MAX) {
+        // Halve all buckets instead of saturating, keeps the shape of the distribution
+        for (int ii = 0; ii < TASK_HISTOGRAM_BUCKET_COUNT; ii++) {
+            histogram->count[ii] >>= 1;
+        }
+    }
+}
+
+// Largest value counted by the bucket, the last one is open ended and
+// returns its lower limit instead
+timeUs_t taskHistogramBucketLimit(int bucket)
+{
+    if (bucket <= 0) {
+        return 0;
+    } else if (bucket >= TASK_HISTOGRAM_BUCKET_COUNT - 1) {
+        return 1 << (TASK_HISTOGRAM_BUCKET_COUNT - 2);
+    }
+    return (1 << bucket) - 1;
+}
+
+timeUs_t taskHistogramPercentile(const taskHistogram_t *histogram, uint8_t percentile)
+{
+    uint32_t total = 0;
+    for (int ii = 0; ii < TASK_HISTOGRAM_BUCKET_COUNT; ii++) {
+        total += histogram->count[ii];
+    }
+
+    const uint32_t target = (total * percentile + 99) / 100;
+    uint32_t sum = 0;
+    for (int ii = 0; ii < TASK_HISTOGRAM_BUCKET_COUNT; ii++) {
+        sum += histogram->count[ii];
+        if (sum >= target && sum > 0) {
+            return taskHistogramBucketLimit(ii);
+        }
+    }
+    return 0;
 }
 #endif
 
@@ -162,9 +378,11 @@ void rescheduleTask(cfTaskId_e taskId, timeDelta_t newPeriodUs)
     if (taskId == TASK_SELF) {
         cfTask_t *task = currentTask;
         task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, newPeriodUs);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+        edfUpdate(task);
     } else if (taskId < TASK_COUNT) {
         cfTask_t *task = &cfTasks[taskId];
         task->desiredPeriod = MAX(SCHEDULER_DELAY_LIMIT, newPeriodUs);  // Limit delay to 100us (10 kHz) to prevent scheduler clogging
+        edfUpdate(task);
     }
 }
 
@@ -174,8 +392,12 @@ void setTaskEnabled(cfTaskId_e taskId, bool enabled)
         cfTask_t *task = taskId == TASK_SELF ? currentTask : &cfTasks[taskId];
         if (enabled && task->taskFunc) {
             queueAdd(task);
+            if (schedulerMode == SCHEDULER_MODE_EDF) {
+                edfAdd(task);
+            }
         } else {
             queueRemove(task);
+            edfRemove(task);
         }
     }
 }
@@ -196,14 +418,15 @@ void schedulerResetTaskStatistics(cfTaskId_e taskId)
 #ifdef SKIP_TASK_STATISTICS
     UNUSED(taskId);
 #else
-    if (taskId == TASK_SELF) {
-        currentTask->movingSumExecutionTime = 0;
-        currentTask->totalExecutionTime = 0;
-        currentTask->maxExecutionTime = 0;
-    } else if (taskId < TASK_COUNT) {
-        cfTasks[taskId].movingSumExecutionTime = 0;
-        cfTasks[taskId].totalExecutionTime = 0;
-        cfTasks[taskId].totalExecutionTime = 0;
+    cfTask_t *task = taskId == TASK_SELF ? currentTask : (taskId < TASK_COUNT ? &cfTasks[taskId] : NULL);
+    if (task) {
+        task->movingSumExecutionTime = 0;
+        task->totalExecutionTime = 0;
+        task->maxExecutionTime = 0;
+        task->movingSumLateness = 0;
+        task->maxLateness = 0;
+        memset(&task->executionTimeHistogram, 0, sizeof(task->executionTimeHistogram));
+        memset(&task->periodJitterHistogram, 0, sizeof(task->periodJitterHistogram));
     }
 #endif
 }
@@ -211,11 +434,192 @@ void schedulerResetTaskStatistics(cfTaskId_e taskId)
 void schedulerInit(void)
 {
     queueClear();
-    queueAdd(&cfTasks[TASK_SYSTEM]);
+    edfClear();
+    setTaskEnabled(TASK_SYSTEM, true);
+}
+
+void schedulerSetMode(schedulerMode_e mode)
+{
+    schedulerMode = mode;
+
+    // Rebuild the EDF structures from the task queue, they aren't
+    // maintained while running in priority mode
+    edfClear();
+    if (schedulerMode == SCHEDULER_MODE_EDF) {
+        for (int ii = 0; ii < taskQueueSize; ii++) {
+            edfAdd(taskQueueArray[ii]);
+        }
+    }
+}
+
+schedulerMode_e schedulerGetMode(void)
+{
+    return schedulerMode;
+}
+
+static void FAST_CODE taskExecute(cfTask_t *selectedTask, timeUs_t currentTimeUs)
+{
+#ifndef SKIP_TASK_STATISTICS
+    // The first invocation has no meaningful deadline or period and isn't accounted
+    if (selectedTask->lastExecutedAt != 0) {
+        // For event driven tasks the deadline is the moment checkFunc signaled the event
+        const timeDelta_t lateness = selectedTask->checkFunc ?
+            (timeDelta_t)(currentTimeUs - selectedTask->lastSignaledAt) :
+            (timeDelta_t)(currentTimeUs - taskDeadline(selectedTask));
+        if (lateness >= 0) {
+            selectedTask->movingSumLateness += lateness - selectedTask->movingSumLateness / TASK_MOVING_SUM_COUNT;
+            selectedTask->maxLateness = MAX(selectedTask->maxLateness, lateness);
+        }
+
+        // Period jitter is only meaningful for the periodic tasks
+        if (!selectedTask->checkFunc) {
+            const timeDelta_t period = (timeDelta_t)(currentTimeUs - selectedTask->lastExecutedAt);
+            taskHistogramAdd(&selectedTask->periodJitterHistogram, ABS(period - selectedTask->desiredPeriod));
+        }
+    }
+#endif
+
+    selectedTask->taskLatestDeltaTime = (timeDelta_t)(currentTimeUs - selectedTask->lastExecutedAt);
+    selectedTask->lastExecutedAt = currentTimeUs;
+    selectedTask->dynamicPriority = 0;
+
+    // Deadline moved by one period, put the task back in order before
+    // running it since taskFunc may reschedule or disable itself
+    if (schedulerMode == SCHEDULER_MODE_EDF && !selectedTask->checkFunc && selectedTask->heapIndex >= 0) {
+        heapSiftDown(taskHeapGet(selectedTask), selectedTask->heapIndex);
+    }
+
+    // Execute task
+    const timeUs_t currentTimeBeforeTaskCall = micros();
+    selectedTask->taskFunc(currentTimeBeforeTaskCall);
+
+#ifndef SKIP_TASK_STATISTICS
+    const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
+    selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / TASK_MOVING_SUM_COUNT;
+    selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
+    selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
+    taskHistogramAdd(&selectedTask->executionTimeHistogram, taskExecutionTime);
+#endif
+#if defined(SCHEDULER_DEBUG)
+    DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - currentTimeUs - taskExecutionTime); // time spent in scheduler
+#endif
+}
+
+static void FAST_CODE realtimeCallbacksExecute(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+
+    // Execute system real-time callbacks and account for them to SYSTEM account
+    const timeUs_t currentTimeBeforeTaskCall = micros();
+    taskRunRealtimeCallbacks(currentTimeBeforeTaskCall);
+
+#ifndef SKIP_TASK_STATISTICS
+    cfTask_t *selectedTask = &cfTasks[TASK_SYSTEM];
+    const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
+    selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / TASK_MOVING_SUM_COUNT;
+    selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
+    selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
+#endif
+#if defined(SCHEDULER_DEBUG)
+    DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - currentTimeUs);
+#endif
+}
+
+static bool FAST_CODE checkFuncExecute(cfTask_t *task)
+{
+    const timeUs_t currentTimeBeforeCheckFuncCallUs = micros();
+
+    if (!task->checkFunc(currentTimeBeforeCheckFuncCallUs, currentTimeBeforeCheckFuncCallUs - task->lastExecutedAt)) {
+        return false;
+    }
+
+#ifndef SKIP_TASK_STATISTICS
+    const timeUs_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCallUs;
+    checkFuncMovingSumExecutionTime -= checkFuncMovingSumExecutionTime / TASK_MOVING_SUM_COUNT;
+    checkFuncMovingSumExecutionTime += checkFuncExecutionTime;
+    checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
+    checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
+#endif
+    task->lastSignaledAt = currentTimeBeforeCheckFuncCallUs;
+    task->taskAgeCycles = 1;
+    task->dynamicPriority = 1 + task->staticPriority;
+    return true;
+}
+
+static void FAST_CODE schedulerEDF(void)
+{
+    const timeUs_t currentTimeUs = micros();
+
+    cfTask_t *selectedTask = NULL;
+    bool forcedRealTimeTask = false;
+    uint16_t waitingTasks = 0;
+
+    // Realtime tasks take absolute priority, run the most overdue one
+    const taskHeap_t *heap = &taskHeaps[TASK_HEAP_REALTIME];
+    if (heap->size > 0 && taskIsDue(heap->tasks[0], currentTimeUs)) {
+        selectedTask = heap->tasks[0];
+        forcedRealTimeTask = true;
+        waitingTasks += heapCountDue(heap, 0, currentTimeUs);
+    }
+
+    // Event driven tasks are due as soon as they are signaled
+    for (int ii = 0; ii < eventTaskCount; ii++) {
+        cfTask_t *task = eventTasks[ii];
+
+        if (task->dynamicPriority > 0) {
+            task->taskAgeCycles = 1 + ((timeDelta_t)(currentTimeUs - task->lastSignaledAt)) / task->desiredPeriod;
+        } else if (!checkFuncExecute(task)) {
+            task->taskAgeCycles = 0;
+            continue;
+        }
+
+        waitingTasks++;
+        if (!forcedRealTimeTask && (!selectedTask || (timeDelta_t)(task->lastSignaledAt - selectedTask->lastSignaledAt) < 0)) {
+            selectedTask = task;
+        }
+    }
+
+    // Time driven tasks, earliest deadline first. A signaled event task
+    // wins unless the time driven task was due before the event fired.
+    heap = &taskHeaps[TASK_HEAP_NORMAL];
+    if (heap->size > 0 && taskIsDue(heap->tasks[0], currentTimeUs)) {
+        cfTask_t *task = heap->tasks[0];
+        waitingTasks += heapCountDue(heap, 0, currentTimeUs);
+        if (!forcedRealTimeTask && (!selectedTask || (timeDelta_t)(taskDeadline(task) - selectedTask->lastSignaledAt) < 0)) {
+            selectedTask = task;
+        }
+    }
+
+    // Idle tasks only run when nothing else is waiting
+    heap = &taskHeaps[TASK_HEAP_IDLE];
+    if (heap->size > 0 && taskIsDue(heap->tasks[0], currentTimeUs)) {
+        waitingTasks += heapCountDue(heap, 0, currentTimeUs);
+        if (!selectedTask) {
+            selectedTask = heap->tasks[0];
+        }
+    }
+
+    totalWaitingTasksSamples++;
+    totalWaitingTasks += waitingTasks;
+
+    currentTask = selectedTask;
+
+    if (selectedTask) {
+        taskExecute(selectedTask, currentTimeUs);
+    }
+
+    if (!selectedTask || forcedRealTimeTask) {
+        realtimeCallbacksExecute(currentTimeUs);
+    }
 }
 
 void FAST_CODE NOINLINE scheduler(void)
 {
+    if (schedulerMode == SCHEDULER_MODE_EDF) {
+        schedulerEDF();
+        return;
+    }
+
     // Cache currentTime
     const timeUs_t currentTimeUs = micros();
 
@@ -229,24 +633,12 @@ void FAST_CODE NOINLINE scheduler(void)
     for (cfTask_t *task = queueFirst(); task != NULL; task = queueNext()) {
         // Task has checkFunc - event driven
         if (task->checkFunc) {
-            const timeUs_t currentTimeBeforeCheckFuncCallUs = micros();
-
             // Increase priority for event driven tasks
             if (task->dynamicPriority > 0) {
                 task->taskAgeCycles = 1 + ((timeDelta_t)(currentTimeUs - task->lastSignaledAt)) / task->desiredPeriod;
                 task->dynamicPriority = 1 + task->staticPriority * task->taskAgeCycles;
                 waitingTasks++;
-            } else if (task->checkFunc(currentTimeBeforeCheckFuncCallUs, currentTimeBeforeCheckFuncCallUs - task->lastExecutedAt)) {
-#ifndef SKIP_TASK_STATISTICS
-                const timeUs_t checkFuncExecutionTime = micros() - currentTimeBeforeCheckFuncCallUs;
-                checkFuncMovingSumExecutionTime -= checkFuncMovingSumExecutionTime / TASK_MOVING_SUM_COUNT;
-                checkFuncMovingSumExecutionTime += checkFuncExecutionTime;
-                checkFuncTotalExecutionTime += checkFuncExecutionTime;   // time consumed by scheduler + task
-                checkFuncMaxExecutionTime = MAX(checkFuncMaxExecutionTime, checkFuncExecutionTime);
-#endif
-                task->lastSignaledAt = currentTimeBeforeCheckFuncCallUs;
-                task->taskAgeCycles = 1;
-                task->dynamicPriority = 1 + task->staticPriority;
+            } else if (checkFuncExecute(task)) {
                 waitingTasks++;
             } else {
                 task->taskAgeCycles = 0;
@@ -282,39 +674,10 @@ void FAST_CODE NOINLINE scheduler(void)
 
     if (selectedTask) {
         // Found a task that should be run
-        selectedTask->taskLatestDeltaTime = (timeDelta_t)(currentTimeUs - selectedTask->lastExecutedAt);
-        selectedTask->lastExecutedAt = currentTimeUs;
-        selectedTask->dynamicPriority = 0;
-
-        // Execute task
-        const timeUs_t currentTimeBeforeTaskCall = micros();
-        selectedTask->taskFunc(currentTimeBeforeTaskCall);
+        taskExecute(selectedTask, currentTimeUs);
+    }
 
-#ifndef SKIP_TASK_STATISTICS
-        const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
-        selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / TASK_MOVING_SUM_COUNT;
-        selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
-        selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
-#endif
-#if defined(SCHEDULER_DEBUG)
-        DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - currentTimeUs - taskExecutionTime); // time spent in scheduler
-#endif
-    } 
-    
     if (!selectedTask || forcedRealTimeTask) {
-        // Execute system real-time callbacks and account for them to SYSTEM account
-        const timeUs_t currentTimeBeforeTaskCall = micros();
-        taskRunRealtimeCallbacks(currentTimeBeforeTaskCall);
-
-#ifndef SKIP_TASK_STATISTICS
-        selectedTask = &cfTasks[TASK_SYSTEM];
-        const timeUs_t taskExecutionTime = micros() - currentTimeBeforeTaskCall;
-        selectedTask->movingSumExecutionTime += taskExecutionTime - selectedTask->movingSumExecutionTime / TASK_MOVING_SUM_COUNT;
-        selectedTask->totalExecutionTime += taskExecutionTime;   // time consumed by scheduler + task
-        selectedTask->maxExecutionTime = MAX(selectedTask->maxExecutionTime, taskExecutionTime);
-#endif
-#if defined(SCHEDULER_DEBUG)
-        DEBUG_SET(DEBUG_SCHEDULER, 2, micros() - currentTimeUs);
-#endif
+        realtimeCallbacksExecute(currentTimeUs);
     }
 }
@@ -21,6 +21,11 @@
 
 //#define SCHEDULER_DEBUG
 
+typedef enum {
+    SCHEDULER_MODE_PRIORITY = 0,    // Linear scan of all tasks, highest dynamicPriority wins
+    SCHEDULER_MODE_EDF,             // Earliest deadline first, time driven tasks kept in min-heaps
+} schedulerMode_e;
+
 typedef enum {
     TASK_PRIORITY_IDLE = 0,     // Disables dynamic scheduling, task is executed only if no other task is active this cycle
     TASK_PRIORITY_LOW = 1,
@@ -37,6 +42,19 @@ typedef struct {
     timeUs_t     averageExecutionTime;
 } cfCheckFuncInfo_t;
 
+#define TASK_HISTOGRAM_BUCKET_COUNT     16
+
+// Log2 bucketed histogram. Bucket 0 counts zeroes, bucket n counts values
+// in [2^(n-1), 2^n) us and the last bucket everything from 2^14 us up.
+typedef struct {
+    uint16_t count[TASK_HISTOGRAM_BUCKET_COUNT];
+} taskHistogram_t;
+
+typedef struct {
+    taskHistogram_t executionTime;
+    taskHistogram_t periodJitter;   // |taskLatestDeltaTime - desiredPeriod|, time driven tasks only
+} cfTaskHistogramInfo_t;
+
 typedef struct {
     const char * taskName;
     bool         isEnabled;
@@ -46,6 +64,8 @@ typedef struct {
     timeUs_t     totalExecutionTime;
     timeUs_t     averageExecutionTime;
     timeDelta_t     latestDeltaTime;
+    timeDelta_t     maxLateness;
+    timeDelta_t     averageLateness;
 } cfTaskInfo_t;
 
 typedef enum {
@@ -123,6 +143,9 @@ typedef enum {
 #endif
 #ifdef USE_SECONDARY_IMU
     TASK_SECONDARY_IMU,
+#endif
+#ifdef USE_BLACKBOX
+    TASK_BLACKBOX,
 #endif
     /* Count of real tasks */
     TASK_COUNT,
@@ -146,12 +169,17 @@ typedef struct {
     timeUs_t lastExecutedAt;        // last time of invocation
     timeUs_t lastSignaledAt;        // time of invocation event for event-driven tasks
     timeDelta_t taskLatestDeltaTime;
+    int8_t heapIndex;               // position in the EDF heap or event list, -1 when not queued
 
     /* Statistics */
     timeUs_t movingSumExecutionTime;  // moving sum over 32 samples
 #ifndef SKIP_TASK_STATISTICS
     timeUs_t maxExecutionTime;
     timeUs_t totalExecutionTime;    // total time consumed by task since boot
+    timeUs_t movingSumLateness;     // moving sum over 32 samples of the delay between deadline and invocation
+    timeDelta_t maxLateness;
+    taskHistogram_t executionTimeHistogram;
+    taskHistogram_t periodJitterHistogram;
 #endif
 } cfTask_t;
 
@@ -160,12 +188,18 @@ extern uint16_t averageSystemLoadPercent;
 
 void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo);
 void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t *taskInfo);
+void getTaskHistogramInfo(cfTaskId_e taskId, cfTaskHistogramInfo_t *histogramInfo);
+void taskHistogramAdd(taskHistogram_t *histogram, timeUs_t value);
+timeUs_t taskHistogramBucketLimit(int bucket);
+timeUs_t taskHistogramPercentile(const taskHistogram_t *histogram, uint8_t percentile);
 void rescheduleTask(cfTaskId_e taskId, timeDelta_t newPeriodUs);
 void setTaskEnabled(cfTaskId_e taskId, bool newEnabledState);
 timeDelta_t getTaskDeltaTime(cfTaskId_e taskId);
 void schedulerResetTaskStatistics(cfTaskId_e taskId);
 
 void schedulerInit(void);
+void schedulerSetMode(schedulerMode_e mode);
+schedulerMode_e schedulerGetMode(void);
 void scheduler(void);
 void taskSystem(timeUs_t currentTimeUs);
 void taskRunRealtimeCallbacks(timeUs_t currentTimeUs);
@@ -87,8 +87,13 @@ STATIC_FASTRAM_UNIT_TESTED zeroCalibrationVector_t gyroCalibration[MAX_GYRO_COUN
 STATIC_FASTRAM filterApplyFnPtr gyroLpfApplyFn;
 STATIC_FASTRAM filter_t gyroLpfState[XYZ_AXIS_COUNT];
 
-STATIC_FASTRAM filterApplyFnPtr gyroLpf2ApplyFn;
-STATIC_FASTRAM filter_t gyroLpf2State[XYZ_AXIS_COUNT];
+STATIC_FASTRAM filterBank3ApplyFnPtr gyroLpf2ApplyFn;
+STATIC_FASTRAM filterBank3_t gyroLpf2State;
+
+#ifdef USE_GYRO_FIFO
+// Without the anti-aliasing LPF the FIFO samples are averaged instead
+STATIC_FASTRAM bool gyroFifoAverage;
+#endif
 
 #ifdef USE_DYNAMIC_FILTERS
 
@@ -97,7 +102,7 @@ EXTENDED_FASTRAM dynamicGyroNotchState_t dynamicGyroNotchState;
 
 #endif
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 3);
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 5);
 
 PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
     .gyro_lpf = SETTING_GYRO_HARDWARE_LPF_DEFAULT,
@@ -119,6 +124,8 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
     .dynamicGyroNotchQ = SETTING_DYNAMIC_GYRO_NOTCH_Q_DEFAULT,
     .dynamicGyroNotchMinHz = SETTING_DYNAMIC_GYRO_NOTCH_MIN_HZ_DEFAULT,
     .dynamicGyroNotchEnabled = SETTING_DYNAMIC_GYRO_NOTCH_ENABLED_DEFAULT,
+    .dynamicGyroNotchMode = SETTING_DYNAMIC_GYRO_NOTCH_MODE_DEFAULT,
+    .dynamicGyroNotchMaxHz = SETTING_DYNAMIC_GYRO_NOTCH_MAX_HZ_DEFAULT,
 #endif
 #ifdef USE_GYRO_KALMAN
     .kalman_q = SETTING_SETPOINT_KALMAN_Q_DEFAULT,
@@ -127,6 +134,9 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
     .init_gyro_cal_enabled = SETTING_INIT_GYRO_CAL_DEFAULT,
     .gyro_zero_cal = {SETTING_GYRO_ZERO_X_DEFAULT, SETTING_GYRO_ZERO_Y_DEFAULT, SETTING_GYRO_ZERO_Z_DEFAULT},
     .gravity_cmss_cal = SETTING_INS_GRAVITY_CMSS_DEFAULT,
+#ifdef USE_GYRO_FIFO
+    .useFifo = SETTING_GYRO_USE_FIFO_DEFAULT,
+#endif
 );
 
 STATIC_UNIT_TESTED gyroSensor_e gyroDetect(gyroDev_t *dev, gyroSensor_e gyroHardware)
@@ -257,13 +267,34 @@ static void initGyroFilter(filterApplyFnPtr *applyFn, filter_t state[], uint8_t
     }
 }
 
+static void initGyroFilterBank(filterBank3ApplyFnPtr *applyFn, filterBank3_t *state, uint8_t type, uint16_t cutoff, uint32_t looptime)
+{
+    *applyFn = nullFilterBank3Apply;
+    if (cutoff > 0) {
+        switch (type)
+        {
+            case FILTER_PT1:
+                *applyFn = (filterBank3ApplyFnPtr)pt1FilterBank3Apply;
+                pt1FilterBank3Init(&state->pt1, cutoff, looptime * 1e-6f);
+                break;
+            case FILTER_BIQUAD:
+                *applyFn = (filterBank3ApplyFnPtr)biquadFilterBank3Apply;
+                biquadFilterBank3Init(&state->biquad, cutoff, looptime, BIQUAD_Q, FILTER_LPF);
+                break;
+        }
+    }
+}
+
 static void gyroInitFilters(void)
 {
     //First gyro LPF running at full gyro frequency 8kHz
     initGyroFilter(&gyroLpfApplyFn, gyroLpfState, gyroConfig()->gyro_anti_aliasing_lpf_type, gyroConfig()->gyro_anti_aliasing_lpf_hz, getGyroLooptime());
-    
+#ifdef USE_GYRO_FIFO
+    gyroFifoAverage = (gyroConfig()->gyro_anti_aliasing_lpf_hz == 0);
+#endif
+
     //Second gyro LPF runnig and PID frequency - this filter is dynamic when gyro_use_dyn_lpf = ON
-    initGyroFilter(&gyroLpf2ApplyFn, gyroLpf2State, gyroConfig()->gyro_main_lpf_type, gyroConfig()->gyro_main_lpf_hz, getLooptime());
+    initGyroFilterBank(&gyroLpf2ApplyFn, &gyroLpf2State, gyroConfig()->gyro_main_lpf_type, gyroConfig()->gyro_main_lpf_hz, getLooptime());
 
 #ifdef USE_GYRO_KALMAN
     if (gyroConfig()->kalmanEnabled) {
@@ -297,6 +328,13 @@ bool gyroInit(void)
     sensorsSet(SENSOR_GYRO);
 
     // Driver initialisation
+#ifdef USE_GYRO_FIFO
+    // Drivers with FIFO support set readFifoFn on detection, the FIFO is
+    // enabled by initFn only if it's still set
+    if (!gyroConfig()->useFifo) {
+        gyroDev[0].readFifoFn = NULL;
+    }
+#endif
     gyroDev[0].lpf = gyroConfig()->gyro_lpf;
     gyroDev[0].requestedSampleIntervalUs = TASK_GYRO_LOOPTIME;
     gyroDev[0].sampleRateIntervalUs = TASK_GYRO_LOOPTIME;
@@ -318,7 +356,9 @@ bool gyroInit(void)
     dynamicGyroNotchFiltersInit(&dynamicGyroNotchState);
     gyroDataAnalyseStateInit(
         &gyroAnalyseState, 
+        gyroConfig()->dynamicGyroNotchMode,
         gyroConfig()->dynamicGyroNotchMinHz,
+        gyroConfig()->dynamicGyroNotchMaxHz,
         getLooptime()
     );
 #endif
@@ -396,12 +436,9 @@ void gyroGetMeasuredRotationRate(fpVector3_t *measuredRotationRate)
     }
 }
 
-static bool FAST_CODE NOINLINE gyroUpdateAndCalibrate(gyroDev_t * gyroDev, zeroCalibrationVector_t * gyroCal, float * gyroADCf)
+// Calibrate and convert the sample in gyroDev->gyroADCRaw
+static bool FAST_CODE gyroCalibrateAndConvert(gyroDev_t * gyroDev, zeroCalibrationVector_t * gyroCal, float * gyroADCf)
 {
-
-    // range: +/- 8192; +/- 2000 deg/sec
-    if (gyroDev->readFn(gyroDev)) {
-
 #ifndef USE_IMU_FAKE // fixes Test Unit compilation error
     if (!gyroConfig()->init_gyro_cal_enabled) {
         // marks that the gyro calibration has ended
@@ -413,56 +450,121 @@ static bool FAST_CODE NOINLINE gyroUpdateAndCalibrate(gyroDev_t * gyroDev, zeroC
     }
 #endif
 
-        if (zeroCalibrationIsCompleteV(gyroCal)) {
-            int32_t gyroADCtmp[XYZ_AXIS_COUNT];
+    if (zeroCalibrationIsCompleteV(gyroCal)) {
+        int32_t gyroADCtmp[XYZ_AXIS_COUNT];
 
-            // Copy gyro value into int32_t (to prevent overflow) and then apply calibration and alignment
-            gyroADCtmp[X] = (int32_t)gyroDev->gyroADCRaw[X] - (int32_t)gyroDev->gyroZero[X];
-            gyroADCtmp[Y] = (int32_t)gyroDev->gyroADCRaw[Y] - (int32_t)gyroDev->gyroZero[Y];
-            gyroADCtmp[Z] = (int32_t)gyroDev->gyroADCRaw[Z] - (int32_t)gyroDev->gyroZero[Z];
+        // Copy gyro value into int32_t (to prevent overflow) and then apply calibration and alignment
+        gyroADCtmp[X] = (int32_t)gyroDev->gyroADCRaw[X] - (int32_t)gyroDev->gyroZero[X];
+        gyroADCtmp[Y] = (int32_t)gyroDev->gyroADCRaw[Y] - (int32_t)gyroDev->gyroZero[Y];
+        gyroADCtmp[Z] = (int32_t)gyroDev->gyroADCRaw[Z] - (int32_t)gyroDev->gyroZero[Z];
 
-            // Apply sensor alignment
-            applySensorAlignment(gyroADCtmp, gyroADCtmp, gyroDev->gyroAlign);
-            applyBoardAlignment(gyroADCtmp);
+        // Apply sensor alignment
+        applySensorAlignment(gyroADCtmp, gyroADCtmp, gyroDev->gyroAlign);
+        applyBoardAlignment(gyroADCtmp);
 
-            // Convert to deg/s and store in unified data
-            gyroADCf[X] = (float)gyroADCtmp[X] * gyroDev->scale;
-            gyroADCf[Y] = (float)gyroADCtmp[Y] * gyroDev->scale;
-            gyroADCf[Z] = (float)gyroADCtmp[Z] * gyroDev->scale;
+        // Convert to deg/s and store in unified data
+        gyroADCf[X] = (float)gyroADCtmp[X] * gyroDev->scale;
+        gyroADCf[Y] = (float)gyroADCtmp[Y] * gyroDev->scale;
+        gyroADCf[Z] = (float)gyroADCtmp[Z] * gyroDev->scale;
 
-            return true;
-        } else {
-            performGyroCalibration(gyroDev, gyroCal);
+        return true;
+    } else {
+        performGyroCalibration(gyroDev, gyroCal);
 
-            // Reset gyro values to zero to prevent other code from using uncalibrated data
-            gyroADCf[X] = 0.0f;
-            gyroADCf[Y] = 0.0f;
-            gyroADCf[Z] = 0.0f;
+        // Reset gyro values to zero to prevent other code from using uncalibrated data
+        gyroADCf[X] = 0.0f;
+        gyroADCf[Y] = 0.0f;
+        gyroADCf[Z] = 0.0f;
 
-            return false;
-        }
+        return false;
+    }
+}
+
+static bool FAST_CODE NOINLINE gyroUpdateAndCalibrate(gyroDev_t * gyroDev, zeroCalibrationVector_t * gyroCal, float * gyroADCf)
+{
+    // range: +/- 8192; +/- 2000 deg/sec
+    if (gyroDev->readFn(gyroDev)) {
+        return gyroCalibrateAndConvert(gyroDev, gyroCal, gyroADCf);
     } else {
         // no gyro reading to process
         return false;
     }
 }
 
-void FAST_CODE NOINLINE gyroFilter()
+#ifdef USE_GYRO_FIFO
+/*
+ * Drain all the samples accumulated in the sensor FIFO since the last call
+ * in one burst. Each one goes through the anti-aliasing LPF at the sensor
+ * sampling rate, or the burst is averaged when that LPF is disabled. This
+ * allows running the gyro task at the PID rate without aliasing.
+ */
+static void FAST_CODE NOINLINE gyroUpdateFifo(gyroDev_t * gyroDev, zeroCalibrationVector_t * gyroCal)
 {
-    if (!gyro.initialized) {
+    const uint8_t sampleCount = gyroDev->readFifoFn(gyroDev);
+    float gyroADCSum[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+    // Stays zero for DEBUG_GYRO while calibrating
+    float gyroADCf[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+    uint8_t calibratedCount = 0;
+
+    if (sampleCount == 0) {
         return;
     }
 
+    for (int sample = 0; sample < sampleCount; sample++) {
+        gyroDev->gyroADCRaw[X] = gyroDev->gyroFifo[sample][X];
+        gyroDev->gyroADCRaw[Y] = gyroDev->gyroFifo[sample][Y];
+        gyroDev->gyroADCRaw[Z] = gyroDev->gyroFifo[sample][Z];
+
+        if (!gyroCalibrateAndConvert(gyroDev, gyroCal, gyroADCf)) {
+            continue;
+        }
+
+        calibratedCount++;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            if (gyroFifoAverage) {
+                gyroADCSum[axis] += gyroADCf[axis];
+            } else {
+                gyro.gyroADCf[axis] = gyroLpfApplyFn((filter_t *) &gyroLpfState[axis], gyroADCf[axis]);
+            }
+        }
+    }
+
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-        float gyroADCf = gyro.gyroADCf[axis];
+        if (calibratedCount == 0) {
+            // Still calibrating
+            gyro.gyroADCf[axis] = 0.0f;
+        } else if (gyroFifoAverage) {
+            gyro.gyroADCf[axis] = gyroADCSum[axis] / calibratedCount;
+        }
+        DEBUG_SET(DEBUG_GYRO, axis, lrintf(gyroADCf[axis]));
+    }
+}
+#endif
+
+void FAST_CODE NOINLINE gyroFilter()
+{
+    if (!gyro.initialized) {
+        return;
+    }
 
+    /*
+     * Filters shared by all the axes are applied as banks, one stage at a
+     * time for the three axes
+     */
 #ifdef USE_RPM_FILTER
-        DEBUG_SET(DEBUG_RPM_FILTER, axis, gyroADCf);
-        gyroADCf = rpmFilterGyroApply(axis, gyroADCf);
-        DEBUG_SET(DEBUG_RPM_FILTER, axis + 3, gyroADCf);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        DEBUG_SET(DEBUG_RPM_FILTER, axis, gyro.gyroADCf[axis]);
+    }
+    rpmFilterGyroApply(gyro.gyroADCf);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        DEBUG_SET(DEBUG_RPM_FILTER, axis + 3, gyro.gyroADCf[axis]);
+    }
 #endif
 
-        gyroADCf = gyroLpf2ApplyFn((filter_t *) &gyroLpf2State[axis], gyroADCf);
+    gyroLpf2ApplyFn(&gyroLpf2State, gyro.gyroADCf);
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float gyroADCf = gyro.gyroADCf[axis];
 
 #ifdef USE_DYNAMIC_FILTERS
         if (dynamicGyroNotchState.enabled) {
@@ -487,11 +589,15 @@ void FAST_CODE NOINLINE gyroFilter()
         gyroDataAnalyse(&gyroAnalyseState);
 
         if (gyroAnalyseState.filterUpdateExecute) {
-            dynamicGyroNotchFiltersUpdate(
-                &dynamicGyroNotchState, 
-                gyroAnalyseState.filterUpdateAxis,
-                gyroAnalyseState.centerFrequency[gyroAnalyseState.filterUpdateAxis]
-            );
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                if (gyroAnalyseState.filterUpdateAxisMask & BIT(axis)) {
+                    dynamicGyroNotchFiltersUpdate(
+                        &dynamicGyroNotchState, 
+                        axis,
+                        gyroAnalyseState.centerFrequency[axis]
+                    );
+                }
+            }
         }
     }
 #endif
@@ -504,6 +610,13 @@ void FAST_CODE NOINLINE gyroUpdate()
         return;
     }
 
+#ifdef USE_GYRO_FIFO
+    if (gyroDev[0].readFifoFn) {
+        gyroUpdateFifo(&gyroDev[0], &gyroCalibration[0]);
+        return;
+    }
+#endif
+
     if (!gyroUpdateAndCalibrate(&gyroDev[0], &gyroCalibration[0], gyro.gyroADCf)) {
         return;
     }
@@ -523,6 +636,20 @@ void FAST_CODE NOINLINE gyroUpdate()
     }
 }
 
+// Period of the gyro task, in us
+uint32_t gyroGetUpdateInterval(void)
+{
+#ifdef USE_GYRO_FIFO
+    if (gyro.initialized && gyroDev[0].readFifoFn) {
+        // The FIFO only needs to be drained once per PID loop, but often
+        // enough to never hold more samples than a single burst can take
+        return MIN(getLooptime(), getGyroLooptime() * GYRO_FIFO_SAMPLE_COUNT_MAX / 2);
+    }
+#endif
+
+    return getGyroLooptime();
+}
+
 bool gyroReadTemperature(void)
 {
     if (!gyro.initialized) {
@@ -557,12 +684,8 @@ int16_t gyroRateDps(int axis)
 
 void gyroUpdateDynamicLpf(float cutoffFreq) {
     if (gyroConfig()->gyro_main_lpf_type == FILTER_PT1) {
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            pt1FilterUpdateCutoff(&gyroLpf2State[axis].pt1, cutoffFreq);
-        }
+        pt1FilterBank3UpdateCutoff(&gyroLpf2State.pt1, cutoffFreq);
     } else if (gyroConfig()->gyro_main_lpf_type == FILTER_BIQUAD) {
-        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterUpdate(&gyroLpf2State[axis].biquad, cutoffFreq, getLooptime(), BIQUAD_Q, FILTER_LPF);
-        }
+        biquadFilterBank3Update(&gyroLpf2State.biquad, cutoffFreq, getLooptime(), BIQUAD_Q, FILTER_LPF);
     }
 }
\ No newline at end of file
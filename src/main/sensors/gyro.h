@@ -27,7 +27,9 @@
 /*
  * Number of peaks to detect with Dynamic Notch Filter aka Matrixc Filter. This is equal to the number of dynamic notch filters
  */
+#ifndef DYN_NOTCH_PEAK_COUNT
 #define DYN_NOTCH_PEAK_COUNT 3
+#endif
 
 typedef enum {
     GYRO_NONE = 0,
@@ -44,6 +46,11 @@ typedef enum {
     GYRO_FAKE
 } gyroSensor_e;
 
+typedef enum {
+    DYNAMIC_NOTCH_MODE_FFT = 0,
+    DYNAMIC_NOTCH_MODE_SDFT,
+} dynamicNotchMode_e;
+
 typedef struct gyro_s {
     bool initialized;
     uint32_t targetLooptime;
@@ -72,6 +79,8 @@ typedef struct gyroConfig_s {
     uint16_t dynamicGyroNotchQ;
     uint16_t dynamicGyroNotchMinHz;
     uint8_t dynamicGyroNotchEnabled;
+    uint8_t dynamicGyroNotchMode;
+    uint16_t dynamicGyroNotchMaxHz;
 #endif
 #ifdef USE_GYRO_KALMAN
     uint16_t kalman_q;
@@ -80,6 +89,9 @@ typedef struct gyroConfig_s {
     bool init_gyro_cal_enabled;
     int16_t gyro_zero_cal[XYZ_AXIS_COUNT];
     float gravity_cmss_cal;
+#ifdef USE_GYRO_FIFO
+    uint8_t useFifo;
+#endif
 } gyroConfig_t;
 
 PG_DECLARE(gyroConfig_t, gyroConfig);
@@ -87,6 +99,7 @@ PG_DECLARE(gyroConfig_t, gyroConfig);
 bool gyroInit(void);
 void gyroGetMeasuredRotationRate(fpVector3_t *imuMeasuredRotationBF);
 void gyroUpdate(void);
+uint32_t gyroGetUpdateInterval(void);
 void gyroFilter(void);
 void gyroStartCalibration(void);
 bool gyroIsCalibrationComplete(void);
@@ -163,7 +163,7 @@ void tempSensorAddressToString(uint64_t address, char *hex_address)
         tfp_sprintf(hex_address, "%d", (int)address);
     else {
         uint32_t *address32 = (uint32_t *)&address;
-        tfp_sprintf(hex_address, "%08lx%08lx", address32[1], address32[0]);
+        tfp_sprintf(hex_address, "%08lx%08lx", (unsigned long)address32[1], (unsigned long)address32[0]);
     }
 }
 
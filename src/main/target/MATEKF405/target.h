@@ -70,6 +70,9 @@
 #define M25P16_SPI_BUS          BUS_SPI3
 #define M25P16_CS_PIN           PC0
 
+// Blackbox logs go to the SD card by default, so the flash can hold long missions
+#define USE_FLASH_WAYPOINT_STORAGE
+
 // *************** OSD *****************************
 #define USE_SPI_DEVICE_2
 #define SPI2_SCK_PIN            PB13
@@ -88,6 +91,7 @@
 #define USE_UART1
 #define UART1_RX_PIN            PA10
 #define UART1_TX_PIN            PA9
+#define UART1_RX_DMA            DMA_TAG(2, 5, 4)    // Free, UART2 (DMA1_ST5) clashes with S5/LED strip
 
 #define USE_UART2
 #define UART2_RX_PIN            PA3
@@ -96,6 +100,7 @@
 #define USE_UART3
 #define UART3_RX_PIN            PC11
 #define UART3_TX_PIN            PC10
+#define UART3_RX_DMA            DMA_TAG(1, 1, 4)    // Free
 
 #define USE_UART4
 #define UART4_RX_PIN            PA1
@@ -103,6 +103,7 @@
 #define USE_UART1
 #define UART1_RX_PIN            PA10
 #define UART1_TX_PIN            PA9
+#define UART1_RX_DMA            DMA_TAG(2, 5, 4)    // Free, UART2 (DMA1_ST5) clashes with the LED strip
 
 #define USE_UART2
 #define UART2_RX_PIN            PA3
@@ -119,6 +120,7 @@
 #define USE_UART5
 #define UART5_RX_PIN            PD2
 #define UART5_TX_PIN            PC12
+#define UART5_RX_DMA            DMA_TAG(1, 0, 4)    // Free, UART4 (DMA1_ST2) clashes with S5
 
 #define SERIAL_PORT_COUNT       6
 
@@ -0,0 +1,197 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+// Host replacement for drivers/io.c. Pins only keep their state in memory.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/utils.h"
+
+#include "drivers/io.h"
+#include "drivers/io_impl.h"
+
+GPIO_TypeDef sitlGpio[4];
+
+static const uint16_t ioDefUsedMask[DEFIO_PORT_USED_COUNT] = { DEFIO_PORT_USED_LIST };
+static const uint8_t ioDefUsedOffset[DEFIO_PORT_USED_COUNT] = { DEFIO_PORT_OFFSET_LIST };
+ioRec_t ioRecs[DEFIO_IO_USED_COUNT];
+
+ioRec_t *IO_Rec(IO_t io)
+{
+    return io;
+}
+
+GPIO_TypeDef *IO_GPIO(IO_t io)
+{
+    return IO_Rec(io)->gpio;
+}
+
+uint16_t IO_Pin(IO_t io)
+{
+    return IO_Rec(io)->pin;
+}
+
+int IO_GPIOPortIdx(IO_t io)
+{
+    if (!io) {
+        return -1;
+    }
+    return IO_GPIO(io) - sitlGpio;
+}
+
+int IO_GPIOPinIdx(IO_t io)
+{
+    if (!io) {
+        return -1;
+    }
+    return 31 - __builtin_clz(IO_Pin(io));
+}
+
+int IO_GPIO_PinSource(IO_t io)
+{
+    return IO_GPIOPinIdx(io);
+}
+
+int IO_GPIO_PortSource(IO_t io)
+{
+    return IO_GPIOPortIdx(io);
+}
+
+uint32_t IO_EXTI_Line(IO_t io)
+{
+    return io ? 1 << IO_GPIOPinIdx(io) : 0;
+}
+
+bool IORead(IO_t io)
+{
+    if (!io) {
+        return false;
+    }
+    return !!(IO_GPIO(io)->IDR & IO_Pin(io));
+}
+
+void IOWrite(IO_t io, bool hi)
+{
+    if (!io) {
+        return;
+    }
+    if (hi) {
+        IO_GPIO(io)->ODR |= IO_Pin(io);
+    } else {
+        IO_GPIO(io)->ODR &= ~IO_Pin(io);
+    }
+}
+
+void IOHi(IO_t io)
+{
+    IOWrite(io, true);
+}
+
+void IOLo(IO_t io)
+{
+    IOWrite(io, false);
+}
+
+void IOToggle(IO_t io)
+{
+    if (io) {
+        IO_GPIO(io)->ODR ^= IO_Pin(io);
+    }
+}
+
+void IOInit(IO_t io, resourceOwner_e owner, resourceType_e resource, uint8_t index)
+{
+    if (!io) {
+        return;
+    }
+    ioRec_t *ioRec = IO_Rec(io);
+    ioRec->owner = owner;
+    ioRec->resource = resource;
+    ioRec->index = index;
+}
+
+void IORelease(IO_t io)
+{
+    if (io) {
+        IO_Rec(io)->owner = OWNER_FREE;
+    }
+}
+
+resourceOwner_e IOGetOwner(IO_t io)
+{
+    return io ? IO_Rec(io)->owner : OWNER_FREE;
+}
+
+resourceType_e IOGetResource(IO_t io)
+{
+    return IO_Rec(io)->resource;
+}
+
+void IOConfigGPIO(IO_t io, ioConfig_t cfg)
+{
+    UNUSED(io);
+    UNUSED(cfg);
+}
+
+void IOConfigGPIOAF(IO_t io, ioConfig_t cfg, uint8_t af)
+{
+    UNUSED(io);
+    UNUSED(cfg);
+    UNUSED(af);
+}
+
+void IOInitGlobal(void)
+{
+    ioRec_t *ioRec = ioRecs;
+
+    for (unsigned port = 0; port < ARRAYLEN(ioDefUsedMask); port++) {
+        for (unsigned pin = 0; pin < sizeof(ioDefUsedMask[0]) * 8; pin++) {
+            if (ioDefUsedMask[port] & (1 << pin)) {
+                ioRec->gpio = &sitlGpio[port];
+                ioRec->pin = 1 << pin;
+                ioRec++;
+            }
+        }
+    }
+}
+
+IO_t IOGetByTag(ioTag_t tag)
+{
+    const int portIdx = DEFIO_TAG_GPIOID(tag);
+    const int pinIdx = DEFIO_TAG_PIN(tag);
+
+    if (portIdx < 0 || portIdx >= DEFIO_PORT_USED_COUNT) {
+        return NULL;
+    }
+    if (!(ioDefUsedMask[portIdx] & (1 << pinIdx))) {
+        return NULL;
+    }
+    int offset = __builtin_popcount(((1 << pinIdx) - 1) & ioDefUsedMask[portIdx]);
+    offset += ioDefUsedOffset[portIdx];
+    return ioRecs + offset;
+}
@@ -0,0 +1,152 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+// Host replacement for drivers/pwm_output.c and drivers/pwm_mapping.c.
+// There are no timers on SITL, the last value written to each output is
+// kept so the simulation can read it back.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "common/utils.h"
+
+#include "drivers/pwm_mapping.h"
+#include "drivers/pwm_output.h"
+#include "drivers/timer.h"
+
+#include "sitl.h"
+
+static uint16_t motorOutput[MAX_MOTORS];
+static uint16_t servoOutput[MAX_SERVOS];
+static bool motorsEnabled = true;
+
+static const motorProtocolProperties_t motorProtocolProperties = {
+    .usesHwTimer = false,
+    .isDSHOT = false,
+};
+
+void timerInit(void)
+{
+}
+
+bool pwmMotorAndServoInit(void)
+{
+    return true;
+}
+
+const motorProtocolProperties_t * getMotorProtocolProperties(motorPwmProtocolTypes_e proto)
+{
+    UNUSED(proto);
+    return &motorProtocolProperties;
+}
+
+pwmInitError_e getPwmInitError(void)
+{
+    return PWM_INIT_ERROR_NONE;
+}
+
+const char * getPwmInitErrorMessage(void)
+{
+    return "No error";
+}
+
+void pwmWriteMotor(uint8_t index, uint16_t value)
+{
+    if (index < MAX_MOTORS && motorsEnabled) {
+        motorOutput[index] = value;
+    }
+}
+
+void pwmShutdownPulsesForAllMotors(uint8_t motorCount)
+{
+    for (int index = 0; index < motorCount && index < MAX_MOTORS; index++) {
+        motorOutput[index] = 0;
+    }
+}
+
+void pwmCompleteMotorUpdate(void)
+{
+}
+
+void pwmDisableMotors(void)
+{
+    motorsEnabled = false;
+}
+
+void pwmEnableMotors(void)
+{
+    motorsEnabled = true;
+}
+
+bool isMotorProtocolDigital(void)
+{
+    return false;
+}
+
+bool isMotorProtocolDshot(void)
+{
+    return false;
+}
+
+void pwmRequestMotorTelemetry(int motorIndex)
+{
+    UNUSED(motorIndex);
+}
+
+ioTag_t pwmGetMotorPinTag(int motorIndex)
+{
+    UNUSED(motorIndex);
+    return IOTAG_NONE;
+}
+
+void pwmWriteServo(uint8_t index, uint16_t value)
+{
+    if (index < MAX_SERVOS) {
+        servoOutput[index] = value;
+    }
+}
+
+void pwmWriteBeeper(bool onoffBeep)
+{
+    UNUSED(onoffBeep);
+}
+
+void beeperPwmInit(ioTag_t tag, uint16_t frequency)
+{
+    UNUSED(tag);
+    UNUSED(frequency);
+}
+
+uint16_t sitlGetMotorOutput(uint8_t index)
+{
+    return index < MAX_MOTORS ? motorOutput[index] : 0;
+}
+
+uint16_t sitlGetServoOutput(uint8_t index)
+{
+    return index < MAX_SERVOS ? servoOutput[index] : 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+// Host replacement for drivers/serial_uart*.c. Every UART listens on
+// TCP port SITL_TCP_BASE_PORT + index, so the configurator, a GCS or a
+// MSP RC source can be attached to any of them. Sockets are polled from
+// the main loop by serialTcpPoll().
+
+#define _GNU_SOURCE   // accept4()
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include "platform.h"
+
+#include "common/utils.h"
+
+#include "drivers/serial.h"
+#include "drivers/serial_uart.h"
+
+#include "sitl.h"
+
+#define SERIAL_TCP_PORT_COUNT   ARRAYLEN(sitlUart)
+#define SERIAL_TCP_BUFFER_SIZE  1024
+
+typedef struct {
+    uartPort_t uart;
+    int listenFd;
+    int clientFd;
+    uint8_t rxBuffer[SERIAL_TCP_BUFFER_SIZE];
+    uint8_t txBuffer[SERIAL_TCP_BUFFER_SIZE];
+} tcpPort_t;
+
+USART_TypeDef sitlUart[8];
+
+static tcpPort_t tcpPorts[SERIAL_TCP_PORT_COUNT];
+
+static const struct serialPortVTable tcpVTable[];
+
+static int tcpListen(uint16_t port)
+{
+    const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    const int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+        fprintf(stderr, "[SITL] Can't listen on TCP port %u: %s\n", port, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+static void tcpDisconnect(tcpPort_t *p)
+{
+    if (p->clientFd >= 0) {
+        close(p->clientFd);
+        p->clientFd = -1;
+    }
+}
+
+// Push the pending TX bytes to the client. Without a client the data is
+// dropped, like a UART with nothing attached to its TX pin.
+static void tcpFlush(tcpPort_t *p)
+{
+    ringBuffer_t *txBuffer = &p->uart.port.txBuffer;
+    const uint8_t *data;
+    uint32_t len;
+
+    while ((len = ringBufferGetReadSpan(txBuffer, &data)) > 0) {
+        if (p->clientFd < 0) {
+            ringBufferCommitRead(txBuffer, len);
+            continue;
+        }
+
+        const ssize_t written = send(p->clientFd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                tcpDisconnect(p);
+            }
+            return;
+        }
+        ringBufferCommitRead(txBuffer, written);
+    }
+}
+
+static void tcpReceive(tcpPort_t *p)
+{
+    serialPort_t *s = &p->uart.port;
+    uint8_t buf[256];
+
+    const ssize_t len = recv(p->clientFd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        tcpDisconnect(p);
+        return;
+    }
+
+    for (ssize_t ii = 0; ii < len; ii++) {
+        if (s->rxCallback) {
+            s->rxCallback(buf[ii], s->rxCallbackData);
+        } else if (!ringBufferPut(&s->rxBuffer, buf[ii])) {
+            // Overrun, drop the rest
+            break;
+        }
+    }
+}
+
+void serialTcpPoll(void)
+{
+    for (unsigned ii = 0; ii < SERIAL_TCP_PORT_COUNT; ii++) {
+        tcpPort_t *p = &tcpPorts[ii];
+
+        if (p->listenFd < 0) {
+            continue;
+        }
+
+        if (p->clientFd < 0) {
+            const int fd = accept4(p->listenFd, NULL, NULL, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                const int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+                p->clientFd = fd;
+            }
+        }
+
+        if (p->clientFd >= 0) {
+            tcpReceive(p);
+        }
+
+        tcpFlush(p);
+    }
+}
+
+serialPort_t *uartOpen(USART_TypeDef *USARTx, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baudRate, portMode_t mode, portOptions_t options)
+{
+    const int index = USARTx - sitlUart;
+
+    if (index < 0 || index >= (int)SERIAL_TCP_PORT_COUNT) {
+        return NULL;
+    }
+
+    tcpPort_t *p = &tcpPorts[index];
+    serialPort_t *s = &p->uart.port;
+
+    if (s->vTable == NULL) {
+        p->clientFd = -1;
+        p->listenFd = tcpListen(SITL_TCP_BASE_PORT + index);
+    }
+
+    p->uart.USARTx = USARTx;
+
+    s->vTable = tcpVTable;
+    ringBufferInit(&s->rxBuffer, p->rxBuffer, sizeof(p->rxBuffer));
+    ringBufferInit(&s->txBuffer, p->txBuffer, sizeof(p->txBuffer));
+    s->rxCallback = rxCallback;
+    s->rxCallbackData = rxCallbackData;
+    s->mode = mode;
+    s->baudRate = baudRate;
+    s->options = options;
+
+    return s;
+}
+
+void uartGetPortPins(UARTDevice_e device, serialPortPins_t * pins)
+{
+    UNUSED(device);
+    pins->rxPin = IOTAG_NONE;
+    pins->txPin = IOTAG_NONE;
+}
+
+void uartClearIdleFlag(uartPort_t *s)
+{
+    UNUSED(s);
+}
+
+void uartSetBaudRate(serialPort_t *instance, uint32_t baudRate)
+{
+    instance->baudRate = baudRate;
+}
+
+static void uartSetMode(serialPort_t *instance, portMode_t mode)
+{
+    instance->mode = mode;
+}
+
+uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
+{
+    return ringBufferCount(&instance->rxBuffer);
+}
+
+uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
+{
+    // serialWriteBuf() busy-waits on this when the buffer is full
+    if (ringBufferFree(&instance->txBuffer) == 0) {
+        tcpFlush((tcpPort_t *)instance);
+    }
+
+    return ringBufferFree(&instance->txBuffer);
+}
+
+bool isUartTransmitBufferEmpty(const serialPort_t *instance)
+{
+    // Callers may busy-wait on this while the main loop doesn't get to
+    // serialTcpPoll(), so push the data out from here too
+    tcpFlush((tcpPort_t *)instance);
+    return ringBufferIsEmpty(&instance->txBuffer);
+}
+
+uint8_t uartRead(serialPort_t *instance)
+{
+    uint8_t ch = 0;
+    ringBufferGet(&instance->rxBuffer, &ch);
+    return ch;
+}
+
+void uartWrite(serialPort_t *instance, uint8_t ch)
+{
+    tcpPort_t *p = (tcpPort_t *)instance;
+
+    if (uartTotalTxBytesFree(instance) == 0) {
+        tcpFlush(p);
+        if (uartTotalTxBytesFree(instance) == 0) {
+            return;
+        }
+    }
+
+    ringBufferPut(&instance->txBuffer, ch);
+}
+
+static bool uartIsConnected(const serialPort_t *instance)
+{
+    const tcpPort_t *p = (const tcpPort_t *)instance;
+    return p->clientFd >= 0;
+}
+
+static bool uartIsIdle(serialPort_t *instance)
+{
+    return uartTotalRxBytesWaiting(instance) == 0;
+}
+
+static void uartEndWrite(serialPort_t *instance)
+{
+    tcpFlush((tcpPort_t *)instance);
+}
+
+static const struct serialPortVTable tcpVTable[] = {
+    {
+        .serialWrite = uartWrite,
+        .serialTotalRxWaiting = uartTotalRxBytesWaiting,
+        .serialTotalTxFree = uartTotalTxBytesFree,
+        .serialRead = uartRead,
+        .serialSetBaudRate = uartSetBaudRate,
+        .isSerialTransmitBufferEmpty = isUartTransmitBufferEmpty,
+        .setMode = uartSetMode,
+        .isConnected = uartIsConnected,
+        .writeBuf = NULL,
+        .beginWrite = NULL,
+        .endWrite = uartEndWrite,
+        .isIdle = uartIsIdle,
+        .setRxFrameCallback = NULL,
+    }
+};
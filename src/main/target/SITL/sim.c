@@ -0,0 +1,94 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+// Sensor simulation for SITL. The airframe sits level and still on the
+// ground, the sensors report that state plus a small amount of noise so
+// the filters and estimators do real work. The noise sequence is
+// deterministic, so runs are comparable between builds.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "drivers/accgyro/accgyro_fake.h"
+#include "drivers/barometer/barometer_fake.h"
+#include "drivers/compass/compass_fake.h"
+
+#include "sitl.h"
+
+#define SIM_UPDATE_INTERVAL_US  125     // 8kHz, like a real gyro
+
+#define SIM_ACC_1G              256     // acc_1G used by the fake accelerometer
+#define SIM_GYRO_NOISE          4       // ~0.25 dps
+#define SIM_ACC_NOISE           2
+
+#define SIM_BARO_PRESSURE       101325  // Pa
+#define SIM_BARO_TEMPERATURE    2500    // 25 degC
+#define SIM_BARO_NOISE          3
+
+// Earth field for a level, north facing airframe in central Europe
+#define SIM_MAG_X               200
+#define SIM_MAG_Y               0
+#define SIM_MAG_Z               -400
+#define SIM_MAG_NOISE           2
+
+static uint32_t noiseState;
+static uint32_t lastUpdateUs;
+
+static int32_t simNoise(int32_t amplitude)
+{
+    // xorshift32
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+
+    return (int32_t)(noiseState % (2 * amplitude + 1)) - amplitude;
+}
+
+static void simUpdateSensors(void)
+{
+    fakeGyroSet(simNoise(SIM_GYRO_NOISE), simNoise(SIM_GYRO_NOISE), simNoise(SIM_GYRO_NOISE));
+    fakeAccSet(simNoise(SIM_ACC_NOISE), simNoise(SIM_ACC_NOISE), SIM_ACC_1G + simNoise(SIM_ACC_NOISE));
+    fakeBaroSet(SIM_BARO_PRESSURE + simNoise(SIM_BARO_NOISE), SIM_BARO_TEMPERATURE);
+    fakeMagSet(SIM_MAG_X + simNoise(SIM_MAG_NOISE), SIM_MAG_Y + simNoise(SIM_MAG_NOISE), SIM_MAG_Z + simNoise(SIM_MAG_NOISE));
+}
+
+void simInit(void)
+{
+    noiseState = 0x12345678;
+    lastUpdateUs = 0;
+    simUpdateSensors();
+}
+
+void simUpdate(uint32_t currentTimeUs)
+{
+    if (currentTimeUs - lastUpdateUs < SIM_UPDATE_INTERVAL_US) {
+        return;
+    }
+
+    lastUpdateUs = currentTimeUs;
+    simUpdateSensors();
+}
@@ -0,0 +1,296 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+// SITL entry point. Runs init() and the scheduler just like main.c does on
+// the real hardware, feeding the fake sensors from sim.c and servicing the
+// TCP serial ports between scheduler calls.
+//
+// Options:
+//   --eeprom=<file>    load/save the configuration from/to <file>
+//   --duration=<s>     exit after <s> seconds of run time
+//   --report=<file>    on exit, write loop time and task timing stats as JSON
+//                      ("-" for stdout), used by CI to catch regressions
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "drivers/time.h"
+
+#include "fc/fc_init.h"
+
+#include "scheduler/scheduler.h"
+
+#include "sitl.h"
+
+#define SITL_SERIAL_POLL_INTERVAL_US    1000
+#define SITL_SOFT_RESET_ARG             "--soft-reset"
+#define SITL_STATS_WARMUP_MS            1000    // skip sensor calibration at boot
+
+extern timeDelta_t cycleTime; // FIXME dependency on mw.c
+
+static char **sitlArgv;
+static bool softReset;
+static const char *eepromFileName;
+static const char *reportFileName;
+static timeMs_t durationMs;
+
+static struct {
+    uint32_t loopCount;
+    timeDelta_t minCycleTime;
+    timeDelta_t maxCycleTime;
+    uint64_t cycleTimeSum;
+    uint32_t cycleTimeCount;
+    timeUs_t startTimeUs;
+} stats;
+
+static void eepromLoad(void)
+{
+    if (!eepromFileName) {
+        return;
+    }
+
+    FILE *fp = fopen(eepromFileName, "rb");
+    if (!fp) {
+        return;
+    }
+
+    const size_t len = fread(eepromData, 1, sizeof(eepromData), fp);
+    fclose(fp);
+    fprintf(stderr, "[SITL] Loaded %u bytes of config from %s\n", (unsigned)len, eepromFileName);
+}
+
+static void eepromSave(void)
+{
+    if (!eepromFileName) {
+        return;
+    }
+
+    FILE *fp = fopen(eepromFileName, "wb");
+    if (!fp) {
+        fprintf(stderr, "[SITL] Can't write config to %s\n", eepromFileName);
+        return;
+    }
+
+    fwrite(eepromData, 1, sizeof(eepromData), fp);
+    fclose(fp);
+}
+
+static void statsUpdate(void)
+{
+    static timeDelta_t lastCycleTime;
+
+    stats.loopCount++;
+
+    // cycleTime changes once per PID loop, sample it only then
+    if (cycleTime == lastCycleTime || cycleTime <= 0) {
+        return;
+    }
+    lastCycleTime = cycleTime;
+
+    if (stats.cycleTimeCount == 0 || cycleTime < stats.minCycleTime) {
+        stats.minCycleTime = cycleTime;
+    }
+    if (cycleTime > stats.maxCycleTime) {
+        stats.maxCycleTime = cycleTime;
+    }
+    stats.cycleTimeSum += cycleTime;
+    stats.cycleTimeCount++;
+}
+
+// The host is much faster than any FC, so averageSystemLoadPercent (due
+// tasks per scheduler pass) stays at 0. Report how much of the run time
+// the tasks took and how late they ran instead.
+static void statsStart(void)
+{
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        schedulerResetTaskStatistics(taskId);
+    }
+    stats.startTimeUs = micros();
+}
+
+static void reportWrite(void)
+{
+    if (!reportFileName) {
+        return;
+    }
+
+    FILE *fp = strcmp(reportFileName, "-") == 0 ? stdout : fopen(reportFileName, "w");
+    if (!fp) {
+        fprintf(stderr, "[SITL] Can't write report to %s\n", reportFileName);
+        return;
+    }
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"runTimeMs\": %u,\n", (unsigned)millis());
+    fprintf(fp, "  \"schedulerMode\": \"%s\",\n", schedulerGetMode() == SCHEDULER_MODE_EDF ? "EDF" : "PRIORITY");
+    fprintf(fp, "  \"schedulerLoops\": %u,\n", (unsigned)stats.loopCount);
+    fprintf(fp, "  \"cycleTime\": { \"last\": %d, \"min\": %d, \"avg\": %d, \"max\": %d },\n",
+        (int)cycleTime, (int)stats.minCycleTime,
+        stats.cycleTimeCount ? (int)(stats.cycleTimeSum / stats.cycleTimeCount) : 0,
+        (int)stats.maxCycleTime);
+
+    uint64_t taskExecutionTime = 0;
+    timeDelta_t maxLateness = 0;
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (taskInfo.isEnabled) {
+            taskExecutionTime += taskInfo.totalExecutionTime;
+            maxLateness = MAX(maxLateness, taskInfo.maxLateness);
+        }
+    }
+    const timeUs_t statsTime = stats.startTimeUs ? micros() - stats.startTimeUs : 0;
+
+    fprintf(fp, "  \"taskExecutionTime\": %llu,\n", (unsigned long long)taskExecutionTime);
+    fprintf(fp, "  \"taskExecutionPercent\": %.2f,\n", statsTime ? 100.0 * taskExecutionTime / statsTime : 0.0);
+    fprintf(fp, "  \"maxLateness\": %d,\n", (int)maxLateness);
+    fprintf(fp, "  \"tasks\": [");
+
+    bool first = true;
+    for (cfTaskId_e taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTaskInfo_t taskInfo;
+        getTaskInfo(taskId, &taskInfo);
+        if (!taskInfo.isEnabled) {
+            continue;
+        }
+        fprintf(fp, "%s\n    { \"name\": \"%s\", \"desiredPeriod\": %d, \"latestDeltaTime\": %d, \"maxExecutionTime\": %u, \"averageExecutionTime\": %u, \"totalExecutionTime\": %u, \"maxLateness\": %d, \"averageLateness\": %d }",
+            first ? "" : ",", taskInfo.taskName, (int)taskInfo.desiredPeriod, (int)taskInfo.latestDeltaTime,
+            (unsigned)taskInfo.maxExecutionTime, (unsigned)taskInfo.averageExecutionTime, (unsigned)taskInfo.totalExecutionTime,
+            (int)taskInfo.maxLateness, (int)taskInfo.averageLateness);
+        first = false;
+    }
+
+    fprintf(fp, "\n  ]\n}\n");
+
+    if (fp != stdout) {
+        fclose(fp);
+    }
+}
+
+bool sitlIsSoftReset(void)
+{
+    return softReset;
+}
+
+void sitlExit(int status)
+{
+    eepromSave();
+    reportWrite();
+    exit(status);
+}
+
+void sitlRestart(void)
+{
+    eepromSave();
+
+    // Start over with the same arguments, flagged as a soft reset
+    int argc = 0;
+    while (sitlArgv[argc]) {
+        argc++;
+    }
+
+    char **argv = calloc(argc + 2, sizeof(char *));
+    int newArgc = 0;
+    for (int ii = 0; ii < argc; ii++) {
+        if (strcmp(sitlArgv[ii], SITL_SOFT_RESET_ARG) != 0) {
+            argv[newArgc++] = sitlArgv[ii];
+        }
+    }
+    argv[newArgc++] = SITL_SOFT_RESET_ARG;
+    argv[newArgc] = NULL;
+
+    fprintf(stderr, "[SITL] Reset\n");
+    fflush(NULL);
+    execv("/proc/self/exe", argv);
+
+    fprintf(stderr, "[SITL] Restart failed\n");
+    exit(EXIT_FAILURE);
+}
+
+static void parseArguments(int argc, char *argv[])
+{
+    for (int ii = 1; ii < argc; ii++) {
+        const char *arg = argv[ii];
+
+        if (strncmp(arg, "--eeprom=", 9) == 0) {
+            eepromFileName = arg + 9;
+        } else if (strncmp(arg, "--duration=", 11) == 0) {
+            durationMs = atoi(arg + 11) * 1000;
+        } else if (strncmp(arg, "--report=", 9) == 0) {
+            reportFileName = arg + 9;
+        } else if (strcmp(arg, SITL_SOFT_RESET_ARG) == 0) {
+            softReset = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--eeprom=<file>] [--duration=<seconds>] [--report=<file>|-]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    sitlArgv = argv;
+    parseArguments(argc, argv);
+
+    eepromLoad();
+    simInit();
+
+    init();
+
+    const timeMs_t statsStartMs = millis() + SITL_STATS_WARMUP_MS;
+    timeUs_t lastSerialPollUs = 0;
+
+    while (true) {
+        scheduler();
+
+        const timeUs_t currentTimeUs = micros();
+        simUpdate(currentTimeUs);
+
+        if (currentTimeUs - lastSerialPollUs >= SITL_SERIAL_POLL_INTERVAL_US) {
+            lastSerialPollUs = currentTimeUs;
+            serialTcpPoll();
+        }
+
+        if (millis() >= statsStartMs) {
+            if (!stats.startTimeUs) {
+                statsStart();
+            }
+            statsUpdate();
+        }
+
+        if (durationMs && millis() >= durationMs) {
+            sitlExit(EXIT_SUCCESS);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// time_sitl.c
+void sitlTimeInit(void);
+
+// sitl.c
+bool sitlIsSoftReset(void);
+void sitlRestart(void);
+void sitlExit(int status);
+
+// serial_tcp.c
+void serialTcpPoll(void);
+
+// pwm_output_sitl.c
+uint16_t sitlGetMotorOutput(uint8_t index);
+uint16_t sitlGetServoOutput(uint8_t index);
+
+// sim.c
+void simInit(void);
+void simUpdate(uint32_t currentTimeUs);
@@ -0,0 +1,91 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Minimal replacements for the CMSIS/StdPeriph definitions the portable
+// parts of the firmware refer to. Peripheral handles are opaque on SITL,
+// they only need to be distinct pointers.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct { uint32_t IDR; uint32_t ODR; } GPIO_TypeDef;
+typedef struct { uint32_t id; } TIM_TypeDef;
+typedef struct { uint32_t id; } USART_TypeDef;
+typedef struct { uint32_t id; } SPI_TypeDef;
+typedef struct { uint32_t id; } I2C_TypeDef;
+typedef struct { uint32_t id; } ADC_TypeDef;
+typedef struct { uint32_t id; } DMA_TypeDef;
+typedef struct { uint32_t id; } DMA_Channel_TypeDef;
+typedef struct { uint32_t id; } DMA_Stream_TypeDef;
+
+typedef int32_t IRQn_Type;
+
+typedef enum {
+    EXTI_Trigger_Rising = 0x08,
+    EXTI_Trigger_Falling = 0x0C,
+    EXTI_Trigger_Rising_Falling = 0x10
+} EXTITrigger_TypeDef;
+
+extern USART_TypeDef sitlUart[8];
+#define USART1  (&sitlUart[0])
+#define USART2  (&sitlUart[1])
+#define USART3  (&sitlUart[2])
+#define UART4   (&sitlUart[3])
+#define UART5   (&sitlUart[4])
+#define USART6  (&sitlUart[5])
+#define UART7   (&sitlUart[6])
+#define UART8   (&sitlUart[7])
+
+extern GPIO_TypeDef sitlGpio[4];
+#define GPIOA   (&sitlGpio[0])
+#define GPIOB   (&sitlGpio[1])
+#define GPIOC   (&sitlGpio[2])
+#define GPIOD   (&sitlGpio[3])
+
+// Core intrinsics
+#define __NVIC_PRIO_BITS    4
+
+static inline void __set_BASEPRI(uint32_t basePri) { (void)basePri; }
+static inline void __set_BASEPRI_MAX(uint32_t basePri) { (void)basePri; }
+static inline uint32_t __get_BASEPRI(void) { return 0; }
+static inline void __enable_irq(void) {}
+static inline void __disable_irq(void) {}
+#define __NOP()             __asm__ volatile ("nop")
+#define __DSB()             __sync_synchronize()
+#define __ISB()             __sync_synchronize()
+#define __DMB()             __sync_synchronize()
+
+extern uint32_t SystemCoreClock;
+
+// Chip Unique ID, derived from the host on startup
+extern uint32_t sitlUniqueId[3];
+#define U_ID_0 (sitlUniqueId[0])
+#define U_ID_1 (sitlUniqueId[1])
+#define U_ID_2 (sitlUniqueId[2])
+
+// Provided by newlib on the real targets, see system_sitl.c
+char *strnstr(const char *haystack, const char *needle, size_t len);
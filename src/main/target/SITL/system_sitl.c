@@ -0,0 +1,168 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+// Host replacement for drivers/system.c, drivers/persistent.c and
+// drivers/stack_check.c
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "platform.h"
+
+#include "common/time.h"
+#include "common/utils.h"
+
+#include "drivers/persistent.h"
+#include "drivers/stack_check.h"
+#include "drivers/system.h"
+
+#include "sitl.h"
+
+uint32_t SystemCoreClock = 1000000000;
+uint32_t hse_value = 0;
+uint32_t cachedRccCsrValue = 0;
+uint32_t sitlUniqueId[3];
+
+static uint32_t persistentObjects[PERSISTENT_OBJECT_COUNT];
+
+void systemInit(void)
+{
+    sitlTimeInit();
+
+    // Make the unique ID stable for a given host, so saved configs match
+    const long hostId = gethostid();
+    sitlUniqueId[0] = 0x4c544953; // "SITL"
+    sitlUniqueId[1] = (uint32_t)hostId;
+    sitlUniqueId[2] = (uint32_t)SITL_TCP_BASE_PORT;
+}
+
+void systemClockSetup(uint8_t cpuUnderclock)
+{
+    UNUSED(cpuUnderclock);
+}
+
+void cycleCounterInit(void)
+{
+}
+
+void checkForBootLoaderRequest(void)
+{
+}
+
+void initialiseMemorySections(void)
+{
+}
+
+void enableGPIOPowerUsageAndNoiseReductions(void)
+{
+}
+
+bool isMPUSoftReset(void)
+{
+    return sitlIsSoftReset();
+}
+
+uint32_t systemBootloaderAddress(void)
+{
+    return 0;
+}
+
+void systemReset(void)
+{
+    sitlRestart();
+}
+
+void systemResetRequest(uint32_t requestId)
+{
+    persistentObjectWrite(PERSISTENT_OBJECT_RESET_REASON, requestId);
+    systemReset();
+}
+
+void systemResetToBootloader(void)
+{
+    fprintf(stderr, "[SITL] Bootloader requested, exiting\n");
+    sitlExit(EXIT_SUCCESS);
+}
+
+void failureMode(failureMode_e mode)
+{
+    fprintf(stderr, "[SITL] Failure mode %d, exiting\n", mode);
+    sitlExit(EXIT_FAILURE);
+}
+
+void persistentObjectInit(void)
+{
+}
+
+uint32_t persistentObjectRead(persistentObjectId_e id)
+{
+    return persistentObjects[id];
+}
+
+void persistentObjectWrite(persistentObjectId_e id, uint32_t value)
+{
+    persistentObjects[id] = value;
+}
+
+uint32_t stackTotalSize(void)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_STACK, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) {
+        return 0;
+    }
+    return limit.rlim_cur;
+}
+
+uint32_t stackHighMem(void)
+{
+    return 0;
+}
+
+uint32_t stackUsedSize(void)
+{
+    return 0;
+}
+
+// newlib provides strnstr() on the real targets, glibc doesn't
+char *strnstr(const char *haystack, const char *needle, size_t len)
+{
+    const size_t needleLen = strlen(needle);
+
+    if (needleLen == 0) {
+        return (char *)haystack;
+    }
+
+    for (size_t ii = 0; ii + needleLen <= len && haystack[ii]; ii++) {
+        if (memcmp(&haystack[ii], needle, needleLen) == 0) {
+            return (char *)&haystack[ii];
+        }
+    }
+    return NULL;
+}
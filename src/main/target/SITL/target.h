@@ -0,0 +1,72 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#define TARGET_BOARD_IDENTIFIER "SITL"
+
+#define USBD_PRODUCT_STRING     "SITL"
+
+// *************** Sensors **************************
+// All sensors are simulated by the fake drivers, fed from target/SITL/sim.c
+#define USE_IMU_FAKE
+#define IMU_FAKE_ALIGN          CW0_DEG
+
+#define USE_BARO
+#define USE_FAKE_BARO
+
+#define USE_MAG
+#define USE_FAKE_MAG
+
+#define USE_FAKE_GPS
+
+// *************** Serial ports *********************
+// Every UART is exposed as a TCP socket on SITL_TCP_BASE_PORT + index
+#define USE_UART1
+#define USE_UART2
+#define USE_UART3
+#define USE_UART4
+#define USE_UART5
+#define USE_UART6
+#define USE_UART7
+#define USE_UART8
+
+#define SERIAL_PORT_COUNT       8
+
+#define SITL_TCP_BASE_PORT      5760
+
+#define DEFAULT_RX_TYPE         RX_TYPE_MSP
+
+#define DEFAULT_FEATURES        (FEATURE_GPS | FEATURE_TELEMETRY)
+
+// *************** Config storage *******************
+#define EEPROM_SIZE             32768
+
+// *************** IO *******************************
+#define TARGET_IO_PORTA         0xffff
+#define TARGET_IO_PORTB         0xffff
+#define TARGET_IO_PORTC         0xffff
+#define TARGET_IO_PORTD         0xffff
+
+#define MAX_PWM_OUTPUT_PORTS    8
@@ -0,0 +1,90 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+
+// Host replacement for drivers/time.c, backed by CLOCK_MONOTONIC
+
+#include <stdint.h>
+#include <time.h>
+
+#include "platform.h"
+
+#include "drivers/time.h"
+
+// Host "cycles" are nanoseconds
+uint32_t usTicks = 1000;
+
+static struct timespec sitlStartTime;
+
+void sitlTimeInit(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &sitlStartTime);
+}
+
+static uint64_t sitlNanosSinceStart(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)(now.tv_sec - sitlStartTime.tv_sec) * 1000000000ULL + (now.tv_nsec - sitlStartTime.tv_nsec);
+}
+
+timeMs_t millis(void)
+{
+    return sitlNanosSinceStart() / 1000000ULL;
+}
+
+timeUs_t micros(void)
+{
+    return sitlNanosSinceStart() / 1000ULL;
+}
+
+timeUs_t microsISR(void)
+{
+    return micros();
+}
+
+uint32_t ticks(void)
+{
+    return (uint32_t)sitlNanosSinceStart();
+}
+
+void delayNanos(timeDelta_t ns)
+{
+    const uint32_t startTicks = ticks();
+    while (ticks() - startTicks <= (uint32_t)ns);
+}
+
+void delayMicroseconds(timeUs_t us)
+{
+    const struct timespec ts = {
+        .tv_sec = us / 1000000,
+        .tv_nsec = (us % 1000000) * 1000,
+    };
+    nanosleep(&ts, NULL);
+}
+
+void delay(timeMs_t ms)
+{
+    delayMicroseconds((timeUs_t)ms * 1000);
+}
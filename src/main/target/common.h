@@ -58,6 +58,7 @@
 
 #if defined(STM32F4) || defined(STM32F7)
 #define USE_SERVO_SBUS
+#define USE_UART_RX_DMA         // On the UARTs the target gives a UARTx_RX_DMA stream
 #endif
 
 #define USE_ADC_AVERAGING
@@ -88,6 +89,7 @@
 
 #define USE_DYNAMIC_FILTERS
 #define USE_GYRO_KALMAN
+#define USE_GYRO_FIFO
 #define USE_SMITH_PREDICTOR
 #define USE_RATE_DYNAMICS
 #define USE_EXTENDED_CMS_MENUS
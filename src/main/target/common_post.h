@@ -64,11 +64,25 @@ extern uint8_t __config_end;
 #define BEEPER_PWM_FREQUENCY    2500
 #endif
 
+// Missions longer than NAV_MAX_WAYPOINTS can be stored on the blackbox flash
+// and paged into the waypoint list while flying. Targets opt in with
+// USE_FLASH_WAYPOINT_STORAGE in target.h, it takes 64KB from the blackbox.
+#if defined(USE_FLASH_WAYPOINT_STORAGE)
+#if !defined(USE_FLASHFS) || !defined(NAV_NON_VOLATILE_WAYPOINT_STORAGE) || (MCU_FLASH_SIZE <= 256)
+#undef USE_FLASH_WAYPOINT_STORAGE
+#elif !defined(NAV_FLASH_MAX_WAYPOINTS)
+#define NAV_FLASH_MAX_WAYPOINTS     2047    // 64KB with the header slot
+#endif
+#endif
+
 #define USE_ARM_MATH // try to use FPU functions
 
 #if defined(SIMULATOR_BUILD) || defined(UNIT_TEST)
-// This feature uses 'arm_math.h', which does not exist for x86.
+// This feature uses 'arm_math.h', which does not exist for x86, unless
+// CMSIS-DSP has been built for the host (see src/test/bench)
+#if !defined(ARM_MATH_CM4)
 #undef USE_DYNAMIC_FILTERS
+#endif
 #undef USE_ARM_MATH
 #endif
 
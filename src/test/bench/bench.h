@@ -0,0 +1,99 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Minimal timing harness for the host benchmarks. Every benchmark runs
+// its operation a fixed number of times, repeated a few times keeping the
+// best result to filter out scheduling noise from the host.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+#define BENCH_REPETITIONS   5
+
+struct Result {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+};
+
+inline std::vector<Result> &results(void)
+{
+    static std::vector<Result> benchResults;
+    return benchResults;
+}
+
+// Prevents the compiler from discarding a value computed by the benchmark
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename Op>
+double run(const std::string &name, uint64_t iterations, Op op)
+{
+    // Warm up caches and branch predictors
+    for (uint64_t ii = 0; ii < iterations / 10 + 1; ii++) {
+        op();
+    }
+
+    double best = 0;
+    for (int rep = 0; rep < BENCH_REPETITIONS; rep++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t ii = 0; ii < iterations; ii++) {
+            op();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double nsPerOp = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        if (rep == 0 || nsPerOp < best) {
+            best = nsPerOp;
+        }
+    }
+
+    results().push_back({ name, iterations, best });
+    fprintf(stderr, "%-48s %12.2f ns/op\n", name.c_str(), best);
+    return best;
+}
+
+// Writes all the results collected by run() as JSON to stdout
+inline int report(const char *suite)
+{
+    printf("{\n  \"suite\": \"%s\",\n  \"benchmarks\": [", suite);
+    for (size_t ii = 0; ii < results().size(); ii++) {
+        const Result &result = results()[ii];
+        printf("%s\n    { \"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f }",
+            ii ? "," : "", result.name.c_str(), (unsigned long long)result.iterations, result.nsPerOp);
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
+
+}
@@ -0,0 +1,250 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Cost of logging the main blackbox frames to the onboard flash with all
+// fields enabled. The PID loop only pays for the snapshot, TASK_BLACKBOX
+// encodes the frames and commits them to the device.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_io.h"
+
+    #include "build/debug.h"
+
+    #include "common/utils.h"
+
+    #include "config/feature.h"
+
+    #include "drivers/flash.h"
+    #include "drivers/serial.h"
+
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/servos.h"
+
+    #include "io/beeper.h"
+
+    #include "navigation/navigation.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/barometer.h"
+    #include "sensors/battery.h"
+    #include "sensors/compass.h"
+    #include "sensors/diagnostics.h"
+    #include "sensors/gyro.h"
+    #include "sensors/temperature.h"
+
+    extern uint8_t blackboxSnapshotHead;
+    extern uint8_t blackboxSnapshotTail;
+
+    void blackboxSnapshotIteration(timeUs_t currentTimeUs);
+    void blackboxAdvanceIterationTimers(void);
+    void blackboxLogSnapshots(void);
+}
+
+#include "bench.h"
+
+#define MOTOR_COUNT 4
+
+extern "C" {
+    // Flight state copied by blackboxSnapshotIteration()
+    int32_t axisPID_P[FLIGHT_DYNAMICS_INDEX_COUNT], axisPID_I[FLIGHT_DYNAMICS_INDEX_COUNT], axisPID_D[FLIGHT_DYNAMICS_INDEX_COUNT];
+    int32_t axisPID_F[FLIGHT_DYNAMICS_INDEX_COUNT], axisPID_Setpoint[FLIGHT_DYNAMICS_INDEX_COUNT];
+    gyro_t gyro;
+    acc_t acc;
+    mag_t mag;
+    baro_t baro;
+    attitudeEulerAngles_t attitude;
+    int16_t rcCommand[4];
+    int16_t motor[MAX_SUPPORTED_MOTORS];
+    int16_t servo[MAX_SUPPORTED_SERVOS];
+    int16_t navCurrentState;
+    int16_t navActualVelocity[3];
+    int16_t navDesiredVelocity[3];
+    int32_t navTargetPosition[3];
+    int32_t navLatestActualPosition[3];
+    int16_t navActualSurface;
+    uint16_t navFlags;
+    uint16_t navEPH;
+    uint16_t navEPV;
+    int16_t navAccNEU[3];
+    uint32_t stateFlags;
+    boxBitmask_t rcModeActivationMask;
+    batteryMetersConfig_t batteryMetersConfig_System;
+    gyroConfig_t gyroConfig_System;
+
+    static navigationPIDControllers_t navPids;
+    static pidBank_t benchPidBank;
+
+    const navigationPIDControllers_t *getNavigationPIDControllers(void) { return &navPids; }
+    const pidBank_t *pidBank(void) { return &benchPidBank; }
+    int16_t rxGetChannelValue(unsigned channelNumber) { return rcCommand[channelNumber & 3] + 1500; }
+    uint16_t getRSSI(void) { return 800; }
+    rssiSource_e getRSSISource(void) { return RSSI_SOURCE_RX_CHANNEL; }
+    timeDelta_t rxGetLatencyUs(rxLatencyStage_e stage) { UNUSED(stage); return 2500; }
+    uint16_t getBatteryRawVoltage(void) { return 1620; }
+    int16_t getAmperage(void) { return 1234; }
+    uint8_t getMotorCount(void) { return MOTOR_COUNT; }
+    int getThrottleIdleValue(void) { return 1150; }
+    bool isMixerUsingServos(void) { return false; }
+    bool feature(uint32_t mask) { UNUSED(mask); return true; }
+    bool sensors(uint32_t mask) { UNUSED(mask); return true; }
+    bool isModeActivationConditionPresent(boxId_e modeId) { UNUSED(modeId); return false; }
+    uint32_t getArmingBeepTimeMicros(void) { return 0; }
+
+    // Slow frame state
+    failsafePhase_e failsafePhase(void) { return FAILSAFE_IDLE; }
+    bool rxIsReceivingSignal(void) { return true; }
+    bool rxAreFlightChannelsValid(void) { return true; }
+    hardwareSensorStatus_e getHwGyroStatus(void) { return HW_SENSOR_OK; }
+    hardwareSensorStatus_e getHwAccelerometerStatus(void) { return HW_SENSOR_OK; }
+    hardwareSensorStatus_e getHwCompassStatus(void) { return HW_SENSOR_OK; }
+    hardwareSensorStatus_e getHwBarometerStatus(void) { return HW_SENSOR_OK; }
+    hardwareSensorStatus_e getHwGPSStatus(void) { return HW_SENSOR_NONE; }
+    hardwareSensorStatus_e getHwRangefinderStatus(void) { return HW_SENSOR_NONE; }
+    hardwareSensorStatus_e getHwPitotmeterStatus(void) { return HW_SENSOR_NONE; }
+    uint16_t getPowerSupplyImpedance(void) { return 0; }
+    uint16_t getBatterySagCompensatedVoltage(void) { return 1620; }
+    bool getIMUTemperature(int16_t *temperature) { *temperature = 350; return true; }
+    bool getBaroTemperature(int16_t *temperature) { *temperature = 300; return true; }
+
+    bool blackboxDeviceOpen(void) { return true; }
+
+    // Always ready flash, the data goes nowhere
+    static const flashGeometry_t flashGeometry = { .sectors = 1024, .pageSize = 256, .sectorSize = 65536, .totalSize = 64 * 1024 * 1024, .pagesPerSector = 256 };
+
+    const flashGeometry_t *flashGetGeometry(void) { return &flashGeometry; }
+    bool flashIsReady(void) { return true; }
+    uint32_t flashPartitionSize(flashPartition_t *partition) { UNUSED(partition); return UINT32_MAX; }
+    uint32_t flashPageProgram(uint32_t address, const uint8_t *data, int length)
+    {
+        bench::doNotOptimize(data[length - 1]);
+        return address + length;
+    }
+
+    void serialWrite(serialPort_t *instance, uint8_t ch) { UNUSED(instance); UNUSED(ch); }
+    void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count) { UNUSED(instance); UNUSED(data); UNUSED(count); }
+}
+
+// Noisy hover, so the deltas in the P-frames have a realistic size
+static void updateFlightState(uint32_t iteration)
+{
+    const float t = iteration * 0.0005f;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        const float phase = t * (40 + axis * 13);
+        const int32_t noise = (int32_t)((iteration * 1103515245u + axis * 12345u) >> 26) - 32;
+
+        gyro.gyroADCf[axis] = 20 * sinf(phase) + noise;
+        acc.accADCf[axis] = (axis == Z ? 1.0f : 0.0f) + 0.05f * cosf(phase);
+        mag.magADC[axis] = 300 + noise;
+        axisPID_Setpoint[axis] = 10 * sinf(t * 3);
+        axisPID_P[axis] = 4 * gyro.gyroADCf[axis];
+        axisPID_I[axis] = 50 + axis + (noise >> 3);
+        axisPID_D[axis] = 2 * noise;
+        axisPID_F[axis] = axisPID_Setpoint[axis] / 2;
+        navActualVelocity[axis] = 100 * sinf(t);
+        navLatestActualPosition[axis] = 50000 + 1000 * t;
+    }
+
+    acc.dev.acc_1G = 4096;
+    attitude.values.roll = 50 * sinf(t);
+    attitude.values.pitch = 30 * cosf(t);
+    attitude.values.yaw = 1800 + 10 * t;
+    baro.BaroAlt = 1000 + 100 * sinf(t);
+
+    for (int i = 0; i < 4; i++) {
+        rcCommand[i] = 20 * sinf(t * (i + 1));
+    }
+    rcCommand[THROTTLE] = 1500;
+
+    for (int i = 0; i < MOTOR_COUNT; i++) {
+        motor[i] = 1500 + axisPID_P[i % XYZ_AXIS_COUNT] / 8;
+    }
+}
+
+// Snapshot every iteration and encode it right away, advancing the
+// iteration timers gives the usual mix of I and P frames
+static void benchLogIteration(const char *name, bool advanceTimers)
+{
+    uint32_t iteration = 0;
+
+    bench::run(name, 1000000, [&] {
+        iteration++;
+        updateFlightState(iteration);
+        blackboxSnapshotIteration(iteration * 500);
+        blackboxReserveFrame();
+        blackboxLogSnapshots();
+        blackboxCommitFrame();
+        if (advanceTimers) {
+            blackboxAdvanceIterationTimers();
+        }
+    });
+}
+
+int main(void)
+{
+    blackboxConfigMutable()->device = BLACKBOX_DEVICE_FLASH;
+    blackboxConfigMutable()->rate_num = 1;
+    blackboxConfigMutable()->rate_denom = 1;
+    blackboxConfigMutable()->includeFlags = 0xffffffff;
+    gyroConfigMutable()->looptime = 500;
+    debugMode = DEBUG_GYRO;
+
+    for (int axis = 0; axis < PID_ITEM_COUNT; axis++) {
+        benchPidBank.pid[axis].D = 10;
+    }
+
+    blackboxInit();
+    blackboxStart();
+
+    // PID loop side only, the snapshot is discarded
+    uint32_t iteration = 0;
+    bench::run("blackboxSnapshotIteration", 1000000, [&] {
+        iteration++;
+        updateFlightState(iteration);
+        blackboxSnapshotIteration(iteration * 500);
+        blackboxSnapshotTail = blackboxSnapshotHead;
+    });
+
+    // updateFlightState() is included in all of them
+    benchLogIteration("snapshot+log/intraframe", false);
+    benchLogIteration("snapshot+log/i_p_mix", true);
+
+    return bench::report("blackbox");
+}
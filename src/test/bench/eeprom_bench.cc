@@ -0,0 +1,110 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Boot time spent loading the config: validating the config area and
+// loading every PG, with a registry about the size of a full featured
+// target. Saving an unchanged config is included, as done by the
+// configurator and the CMS on exit.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/parameter_group.h"
+
+    #include "drivers/system.h"
+
+    #include "fc/config.h"
+}
+
+#include "bench.h"
+
+// 64 system PGs of 8 to 92 bytes and a profile PG
+#define BENCH_PG(n) \
+    typedef struct { uint8_t data[8 + ((n) % 8) * 12]; } benchConfig ## n ## _t; \
+    PG_REGISTER(benchConfig ## n ## _t, benchConfig ## n, (100 + (n)), 0);
+
+#define BENCH_PG8(n) \
+    BENCH_PG(n ## 0) BENCH_PG(n ## 1) BENCH_PG(n ## 2) BENCH_PG(n ## 3) \
+    BENCH_PG(n ## 4) BENCH_PG(n ## 5) BENCH_PG(n ## 6) BENCH_PG(n ## 7)
+
+extern "C" {
+    BENCH_PG8(1) BENCH_PG8(2) BENCH_PG8(3) BENCH_PG8(4)
+    BENCH_PG8(5) BENCH_PG8(6) BENCH_PG8(7) BENCH_PG8(8)
+
+    typedef struct { uint8_t data[120]; } benchProfileConfig_t;
+    PG_REGISTER_PROFILE(benchProfileConfig_t, benchProfileConfig, 200, 0);
+
+    typedef struct { uint8_t data[40]; } benchDefaultsConfig_t;
+    PG_REGISTER_WITH_RESET_TEMPLATE(benchDefaultsConfig_t, benchDefaultsConfig, 201, 0);
+    PG_RESET_TEMPLATE(benchDefaultsConfig_t, benchDefaultsConfig, .data = { 1 });
+
+    void failureMode(failureMode_e mode)
+    {
+        UNUSED(mode);
+        abort();
+    }
+}
+
+static void benchLoad(const std::string &name)
+{
+    bench::run(name + "/isEEPROMContentValid", 20000, [] {
+        bench::doNotOptimize(isEEPROMContentValid());
+    });
+    bench::run(name + "/loadEEPROM", 20000, [] {
+        bench::doNotOptimize(loadEEPROM());
+    });
+}
+
+int main(void)
+{
+    for (const pgRegistry_t *reg = __pg_registry_start; reg < __pg_registry_end; reg++) {
+        memset(reg->address, pgN(reg), pgSize(reg) * (pgIsSystem(reg) ? 1 : MAX_PROFILE_COUNT));
+    }
+
+    writeConfigToEEPROM();
+    benchLoad("load/full_save");
+
+    bench::run("save/unchanged", 20000, [] {
+        writeConfigToEEPROM();
+    });
+
+    // A few tuning sessions saved from the OSD
+    for (int ii = 0; ii < 8; ii++) {
+        benchConfig10_System.data[0]++;
+        benchConfig87_System.data[ii]++;
+        writeConfigToEEPROM();
+    }
+    benchLoad("load/after_8_saves");
+
+    return bench::report("eeprom");
+}
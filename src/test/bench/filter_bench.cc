@@ -0,0 +1,280 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Cost per sample of the filters in the gyro hot path: the generic filters
+// in common/filter.c, the RPM filter, the dynamic notch with its FFT based
+// frequency analysis and the Kalman filter.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/filter.h"
+    #include "common/maths.h"
+    #include "common/utils.h"
+    #include "flight/dynamic_gyro_notch.h"
+    #include "flight/kalman.h"
+    #include "flight/rpm_filter.h"
+    #include "sensors/esc_sensor.h"
+    #include "sensors/gyro.h"
+
+    #include "filter_bench.h"
+}
+
+#include "bench.h"
+
+#define LOOPTIME_US         500
+#define MOTOR_COUNT         4
+#define SIGNAL_LENGTH       1024    // power of 2
+#define SAMPLE_ITERATIONS   10000000
+
+static float gyroSignal[XYZ_AXIS_COUNT][SIGNAL_LENGTH];
+static escSensorData_t escData[MOTOR_COUNT];
+
+extern "C" {
+    gyroConfig_t gyroConfig_System;
+
+    timeUs_t micros(void) { return 0; }
+    timeDelta_t getLooptime(void) { return LOOPTIME_US; }
+    uint8_t getMotorCount(void) { return MOTOR_COUNT; }
+    escSensorData_t *getEscTelemetry(uint8_t esc) { return &escData[esc]; }
+}
+
+// Motor noise with a couple of harmonics over a slow stick input
+static void generateGyroSignal(void)
+{
+    uint32_t seed = 1;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        for (int ii = 0; ii < SIGNAL_LENGTH; ii++) {
+            const float t = ii * LOOPTIME_US * 1e-6f;
+            seed = seed * 1103515245 + 12345;
+            const float noise = ((seed >> 16) & 0xff) / 25.6f - 5.0f;
+            gyroSignal[axis][ii] = 200.0f * sinf(2 * M_PIf * 2 * t) +
+                                   30.0f * sinf(2 * M_PIf * (180 + 10 * axis) * t) +
+                                   10.0f * sinf(2 * M_PIf * (360 + 20 * axis) * t) +
+                                   noise;
+        }
+    }
+}
+
+static void benchFilters(void)
+{
+    uint32_t idx = 0;
+    float output = 0;
+
+    pt1Filter_t pt1;
+    pt1FilterInit(&pt1, 90, LOOPTIME_US * 1e-6f);
+    bench::run("pt1FilterApply", SAMPLE_ITERATIONS, [&] {
+        output += pt1FilterApply(&pt1, gyroSignal[0][idx++ & (SIGNAL_LENGTH - 1)]);
+    });
+
+    pt2Filter_t pt2;
+    pt2FilterInit(&pt2, pt2FilterGain(90, LOOPTIME_US * 1e-6f));
+    bench::run("pt2FilterApply", SAMPLE_ITERATIONS, [&] {
+        output += pt2FilterApply(&pt2, gyroSignal[0][idx++ & (SIGNAL_LENGTH - 1)]);
+    });
+
+    pt3Filter_t pt3;
+    pt3FilterInit(&pt3, pt3FilterGain(90, LOOPTIME_US * 1e-6f));
+    bench::run("pt3FilterApply", SAMPLE_ITERATIONS, [&] {
+        output += pt3FilterApply(&pt3, gyroSignal[0][idx++ & (SIGNAL_LENGTH - 1)]);
+    });
+
+    biquadFilter_t biquad;
+    biquadFilterInitLPF(&biquad, 90, LOOPTIME_US);
+    bench::run("biquadFilterApply", SAMPLE_ITERATIONS, [&] {
+        output += biquadFilterApply(&biquad, gyroSignal[0][idx++ & (SIGNAL_LENGTH - 1)]);
+    });
+
+    biquadFilterInit(&biquad, 200, LOOPTIME_US, 5.0f, FILTER_NOTCH);
+    bench::run("biquadFilterApplyDF1", SAMPLE_ITERATIONS, [&] {
+        output += biquadFilterApplyDF1(&biquad, gyroSignal[0][idx++ & (SIGNAL_LENGTH - 1)]);
+    });
+
+    // Notch moving around, like the RPM filter and the dynamic notch do
+    bench::run("biquadFilterUpdate", SAMPLE_ITERATIONS / 10, [&] {
+        biquadFilterUpdate(&biquad, 150.0f + (idx++ & 0xff), LOOPTIME_US, 5.0f, FILTER_NOTCH);
+    });
+    bench::doNotOptimize(biquad);
+
+    // Three axes per call
+    float data[XYZ_AXIS_COUNT];
+
+    pt1FilterBank3_t pt1Bank;
+    pt1FilterBank3Init(&pt1Bank, 90, LOOPTIME_US * 1e-6f);
+    bench::run("pt1FilterBank3Apply/3_axes", SAMPLE_ITERATIONS, [&] {
+        const uint32_t i = idx++ & (SIGNAL_LENGTH - 1);
+        data[X] = gyroSignal[X][i];
+        data[Y] = gyroSignal[Y][i];
+        data[Z] = gyroSignal[Z][i];
+        pt1FilterBank3Apply(&pt1Bank, data);
+        output += data[X];
+    });
+
+    biquadFilterBank3_t biquadBank;
+    biquadFilterBank3Init(&biquadBank, 90, LOOPTIME_US, BIQUAD_Q, FILTER_LPF);
+    bench::run("biquadFilterBank3Apply/3_axes", SAMPLE_ITERATIONS, [&] {
+        const uint32_t i = idx++ & (SIGNAL_LENGTH - 1);
+        data[X] = gyroSignal[X][i];
+        data[Y] = gyroSignal[Y][i];
+        data[Z] = gyroSignal[Z][i];
+        biquadFilterBank3Apply(&biquadBank, data);
+        output += data[X];
+    });
+
+    biquadFilterBank3Init(&biquadBank, 200, LOOPTIME_US, 5.0f, FILTER_NOTCH);
+    bench::run("biquadFilterBank3ApplyDF1/3_axes", SAMPLE_ITERATIONS, [&] {
+        const uint32_t i = idx++ & (SIGNAL_LENGTH - 1);
+        data[X] = gyroSignal[X][i];
+        data[Y] = gyroSignal[Y][i];
+        data[Z] = gyroSignal[Z][i];
+        biquadFilterBank3ApplyDF1(&biquadBank, data);
+        output += data[X];
+    });
+
+    bench::doNotOptimize(output);
+}
+
+static void benchRpmFilter(void)
+{
+    uint32_t idx = 0;
+    float output = 0;
+    float data[XYZ_AXIS_COUNT];
+
+    rpmFilterConfigMutable()->gyro_filter_enabled = 1;
+    rpmFilterConfigMutable()->gyro_harmonics = 3;
+    rpmFilterConfigMutable()->gyro_min_hz = 100;
+    rpmFilterConfigMutable()->gyro_q = 500;
+    rpmFiltersInit();
+
+    for (int motor = 0; motor < MOTOR_COUNT; motor++) {
+        escData[motor].rpm = 12000 + motor * 500;
+    }
+    // Let the motor frequency LPF settle
+    for (int ii = 0; ii < 1000; ii++) {
+        rpmFilterUpdateTask(0);
+    }
+
+    bench::run("rpmFilterGyroApply/4_motors/3_harmonics/3_axes", SAMPLE_ITERATIONS / 10, [&] {
+        const uint32_t i = idx++ & (SIGNAL_LENGTH - 1);
+        data[X] = gyroSignal[X][i];
+        data[Y] = gyroSignal[Y][i];
+        data[Z] = gyroSignal[Z][i];
+        rpmFilterGyroApply(data);
+        output += data[X];
+    });
+
+    bench::run("rpmFilterUpdateTask/4_motors/3_harmonics", SAMPLE_ITERATIONS / 100, [&] {
+        escData[idx & (MOTOR_COUNT - 1)].rpm = 12000 + (idx & 0x3ff);
+        idx++;
+        rpmFilterUpdateTask(0);
+    });
+
+    bench::doNotOptimize(output);
+}
+
+static void benchDynamicNotch(void)
+{
+    static dynamicGyroNotchState_t notchState;
+    uint32_t idx = 0;
+    float output = 0;
+
+    gyroConfig_System.dynamicGyroNotchEnabled = 1;
+    gyroConfig_System.dynamicGyroNotchQ = 120;
+    gyroConfig_System.dynamicGyroNotchMinHz = 150;
+    dynamicGyroNotchFiltersInit(&notchState);
+
+    bench::run("dynamicGyroNotchFiltersApply", SAMPLE_ITERATIONS, [&] {
+        const uint32_t i = idx++;
+        output += dynamicGyroNotchFiltersApply(&notchState, i % XYZ_AXIS_COUNT, gyroSignal[i % XYZ_AXIS_COUNT][i & (SIGNAL_LENGTH - 1)]);
+    });
+
+    // One call per PID loop, the FFT runs a single step of the analysis
+    // on each call, the sliding DFT updates all the axes
+    const struct {
+        const char *name;
+        dynamicNotchMode_e mode;
+    } modes[] = {
+        { "gyroDataAnalyse/fft", DYNAMIC_NOTCH_MODE_FFT },
+        { "gyroDataAnalyse/sdft", DYNAMIC_NOTCH_MODE_SDFT },
+    };
+    for (const auto &mode : modes) {
+        benchGyroAnalyseInit(mode.mode, 150, 500, LOOPTIME_US);
+        bench::run(mode.name, SAMPLE_ITERATIONS / 10, [&] {
+            const uint32_t i = idx++ & (SIGNAL_LENGTH - 1);
+            const float sample[XYZ_AXIS_COUNT] = { gyroSignal[X][i], gyroSignal[Y][i], gyroSignal[Z][i] };
+            float *centerFrequency[XYZ_AXIS_COUNT];
+            const uint8_t axisMask = benchGyroAnalyse(sample, centerFrequency);
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                if (axisMask & BIT(axis)) {
+                    dynamicGyroNotchFiltersUpdate(&notchState, axis, centerFrequency[axis]);
+                }
+            }
+        });
+    }
+
+    // The worst step is what the PID loop has to leave room for
+    benchGyroAnalyseInit(DYNAMIC_NOTCH_MODE_FFT, 150, 500, LOOPTIME_US);
+    const uint8_t stepCount = benchGyroAnalyseStepCount();
+    for (uint8_t step = 0; step < stepCount; step++) {
+        char name[48];
+        snprintf(name, sizeof(name), "gyroDataAnalyse/fft/step_%02u", step);
+        bench::run(name, SAMPLE_ITERATIONS / 10, [&] {
+            benchGyroAnalyseStep(step);
+        });
+    }
+
+    bench::doNotOptimize(output);
+    bench::doNotOptimize(notchState);
+}
+
+static void benchKalman(void)
+{
+    uint32_t idx = 0;
+    float output = 0;
+
+    gyroKalmanInitialize(100);
+    bench::run("gyroKalmanUpdate", SAMPLE_ITERATIONS, [&] {
+        const uint32_t i = idx++;
+        output += gyroKalmanUpdate(i % XYZ_AXIS_COUNT, gyroSignal[i % XYZ_AXIS_COUNT][i & (SIGNAL_LENGTH - 1)]);
+    });
+
+    bench::doNotOptimize(output);
+}
+
+int main(void)
+{
+    generateGyroSignal();
+
+    benchFilters();
+    benchRpmFilter();
+    benchDynamicNotch();
+    benchKalman();
+
+    return bench::report("filter");
+}
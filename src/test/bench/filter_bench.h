@@ -0,0 +1,36 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+void benchGyroAnalyseInit(uint8_t mode, uint16_t minFrequency, uint16_t maxFrequency, uint32_t targetLooptimeUs);
+// Feeds one sample per axis and runs gyroDataAnalyse(). Returns the mask
+// of the axes with new notch frequencies, set in centerFrequency[axis].
+uint8_t benchGyroAnalyse(const float *sample, float **centerFrequency);
+// Number of steps of one analysis cycle of the FFT
+uint8_t benchGyroAnalyseStepCount(void);
+// Runs the given step of the FFT over and over, to time the steps one by one
+void benchGyroAnalyseStep(uint8_t step);
@@ -0,0 +1,85 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// arm_math.h can't be compiled as C++, so the gyro analysis state is
+// kept on the C side for filter_bench.cc
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "platform.h"
+
+#include "common/axis.h"
+#include "common/utils.h"
+
+#include "sensors/gyro.h"
+
+#include "flight/gyroanalyse.h"
+
+#include "filter_bench.h"
+
+static gyroAnalyseState_t gyroAnalyseState;
+
+void benchGyroAnalyseInit(uint8_t mode, uint16_t minFrequency, uint16_t maxFrequency, uint32_t targetLooptimeUs)
+{
+    gyroDataAnalyseStateInit(&gyroAnalyseState, mode, minFrequency, maxFrequency, targetLooptimeUs);
+}
+
+uint8_t benchGyroAnalyse(const float *sample, float **centerFrequency)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroDataAnalysePush(&gyroAnalyseState, axis, sample[axis]);
+    }
+
+    gyroDataAnalyse(&gyroAnalyseState);
+
+    if (!gyroAnalyseState.filterUpdateExecute) {
+        return 0;
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        centerFrequency[axis] = gyroAnalyseState.centerFrequency[axis];
+    }
+    return gyroAnalyseState.filterUpdateAxisMask;
+}
+
+uint8_t benchGyroAnalyseStepCount(void)
+{
+    while (gyroAnalyseState.updateStep != 0) {
+        gyroDataAnalyse(&gyroAnalyseState);
+    }
+
+    uint8_t count = 0;
+    do {
+        gyroDataAnalyse(&gyroAnalyseState);
+        count++;
+    } while (gyroAnalyseState.updateStep != 0);
+    return count;
+}
+
+void benchGyroAnalyseStep(uint8_t step)
+{
+    gyroAnalyseState.updateStep = step;
+    gyroDataAnalyse(&gyroAnalyseState);
+}
@@ -0,0 +1,139 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Cost of a scheduler() pass in both scheduler modes with a realistic task
+// set, and of the per-task histogram collection done on every execution.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+    #include "common/utils.h"
+    #include "scheduler/scheduler.h"
+}
+
+#include "bench.h"
+
+static timeUs_t benchTimeUs;
+static uint32_t taskRuns;
+static uint32_t rxChecks;
+
+extern "C" {
+    timeUs_t micros(void) { return benchTimeUs; }
+    void taskRunRealtimeCallbacks(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); }
+
+    static void benchTask(timeUs_t currentTimeUs)
+    {
+        UNUSED(currentTimeUs);
+        taskRuns++;
+    }
+
+    // RX data arrives every 20 checks
+    static bool benchRxCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+    {
+        UNUSED(currentTimeUs);
+        UNUSED(currentDeltaTimeUs);
+        return (++rxChecks % 20) == 0;
+    }
+
+    #define BENCH_TASK(name, period, priority) { name, NULL, benchTask, period, priority, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, {{0}}, {{0}} }
+
+    // Periods and priorities of the real tasks in fc_tasks.c, in cfTaskId_e order
+    cfTask_t cfTasks[TASK_COUNT] = {
+        BENCH_TASK("SYSTEM", TASK_PERIOD_HZ(10), TASK_PRIORITY_HIGH),
+        BENCH_TASK("PID", TASK_PERIOD_US(1000), TASK_PRIORITY_REALTIME),
+        BENCH_TASK("GYRO", TASK_PERIOD_US(250), TASK_PRIORITY_REALTIME),
+        { "RX", benchRxCheck, benchTask, TASK_PERIOD_HZ(10), TASK_PRIORITY_HIGH, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, {{0}}, {{0}} },
+        BENCH_TASK("SERIAL", TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+        BENCH_TASK("BATTERY", TASK_PERIOD_HZ(50), TASK_PRIORITY_MEDIUM),
+        BENCH_TASK("TEMPERATURE", TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+        BENCH_TASK("LIGHTS", TASK_PERIOD_HZ(100), TASK_PRIORITY_LOW),
+        BENCH_TASK("GPS", TASK_PERIOD_HZ(50), TASK_PRIORITY_MEDIUM),
+        BENCH_TASK("COMPASS", TASK_PERIOD_HZ(10), TASK_PRIORITY_LOW),
+        BENCH_TASK("BARO", TASK_PERIOD_HZ(20), TASK_PRIORITY_MEDIUM),
+        BENCH_TASK("PITOT", TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM),
+        BENCH_TASK("RANGEFINDER", TASK_PERIOD_MS(70), TASK_PRIORITY_MEDIUM),
+        BENCH_TASK("DASHBOARD", TASK_PERIOD_HZ(10), TASK_PRIORITY_IDLE),
+        BENCH_TASK("TELEMETRY", TASK_PERIOD_HZ(500), TASK_PRIORITY_IDLE),
+        BENCH_TASK("LEDSTRIP", TASK_PERIOD_HZ(100), TASK_PRIORITY_IDLE),
+        BENCH_TASK("OSD", TASK_PERIOD_HZ(250), TASK_PRIORITY_LOW),
+        BENCH_TASK("CMS", TASK_PERIOD_HZ(50), TASK_PRIORITY_LOW),
+        BENCH_TASK("OPFLOW", TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM),
+        BENCH_TASK("VTXCTRL", TASK_PERIOD_HZ(5), TASK_PRIORITY_IDLE),
+        BENCH_TASK("PROGRAMMING", TASK_PERIOD_HZ(10), TASK_PRIORITY_IDLE),
+        BENCH_TASK("RPM", TASK_PERIOD_HZ(1000), TASK_PRIORITY_LOW),
+        BENCH_TASK("AUX", TASK_PERIOD_HZ(100), TASK_PRIORITY_HIGH),
+        BENCH_TASK("IRLOCK", TASK_PERIOD_HZ(100), TASK_PRIORITY_MEDIUM),
+    };
+}
+
+static_assert(TASK_COUNT == 24, "Update the task list when changing the bench target");
+
+static void schedulerSetup(schedulerMode_e mode)
+{
+    schedulerSetMode(mode);
+    schedulerInit();
+    for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+        cfTasks[taskId].lastExecutedAt = 0;
+        setTaskEnabled((cfTaskId_e)taskId, true);
+    }
+    benchTimeUs = 0;
+}
+
+static void benchScheduler(const char *modeName, schedulerMode_e mode)
+{
+    // One pass per simulated microsecond, most passes find nothing to do
+    schedulerSetup(mode);
+    bench::run(std::string("scheduler/") + modeName + "/pass_1us", 2000000, [] {
+        benchTimeUs += 1;
+        scheduler();
+    });
+
+    // Sparse passes, almost every one executes a task
+    schedulerSetup(mode);
+    bench::run(std::string("scheduler/") + modeName + "/pass_50us", 200000, [] {
+        benchTimeUs += 50;
+        scheduler();
+    });
+}
+
+int main(void)
+{
+    benchScheduler("priority", SCHEDULER_MODE_PRIORITY);
+    benchScheduler("edf", SCHEDULER_MODE_EDF);
+
+    // Two histogram updates (execution time and period jitter) are done
+    // for every executed task
+    taskHistogram_t histogram = {};
+    uint32_t value = 0;
+    bench::run("histogram/add", 10000000, [&] {
+        value = value * 1103515245 + 12345;
+        taskHistogramAdd(&histogram, value >> 20);
+    });
+    bench::doNotOptimize(histogram);
+
+    bench::doNotOptimize(taskRuns);
+    return bench::report("scheduler");
+}
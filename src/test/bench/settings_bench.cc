@@ -0,0 +1,96 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Name lookups done by a 500 line "set" script, as pasted in the CLI or
+// sent by the configurator, using the generated name hash versus scanning
+// the settings table and decoding every name.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+    #include "fc/settings.h"
+}
+
+#include "bench.h"
+
+#define SCRIPT_LINES 500
+
+// settingFind() before the name hash was generated
+static const setting_t *settingFindLinear(const char *name)
+{
+    char buf[SETTING_MAX_NAME_LENGTH];
+    for (unsigned ii = 0; ii < SETTINGS_TABLE_COUNT; ii++) {
+        const setting_t *setting = settingGet(ii);
+        settingGetName(setting, buf);
+        if (strcmp(buf, name) == 0) {
+            return setting;
+        }
+    }
+    return NULL;
+}
+
+static void benchScript(const char *name, uint64_t iterations, const std::vector<std::string> &script, const setting_t *(*find)(const char *))
+{
+    bench::run(name, iterations, [&] {
+        for (const std::string &line : script) {
+            bench::doNotOptimize(find(line.c_str()));
+        }
+    });
+}
+
+int main(void)
+{
+    char buf[SETTING_MAX_NAME_LENGTH];
+
+    for (unsigned ii = 0; ii < SETTINGS_TABLE_COUNT; ii++) {
+        const setting_t *setting = settingGet(ii);
+        settingGetName(setting, buf);
+        if (settingFind(buf) != setting) {
+            fprintf(stderr, "settingFind(\"%s\") doesn't return setting %u\n", buf, ii);
+            return 1;
+        }
+    }
+    if (settingFind("not_a_setting") != NULL) {
+        fprintf(stderr, "settingFind() found a non existing setting\n");
+        return 1;
+    }
+
+    // Spread the lines over the whole table, like a diff does
+    std::vector<std::string> script;
+    for (unsigned ii = 0; ii < SCRIPT_LINES; ii++) {
+        settingGetName(settingGet((ii * 7) % SETTINGS_TABLE_COUNT), buf);
+        script.push_back(buf);
+    }
+
+    benchScript("set_script_500/linear_scan", 20, script, settingFindLinear);
+    benchScript("set_script_500/settingFind", 2000, script, settingFind);
+
+    return bench::report("settings");
+}
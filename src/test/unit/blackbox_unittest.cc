@@ -0,0 +1,431 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "blackbox/blackbox.h"
+    #include "blackbox/blackbox_fielddefs.h"
+    #include "blackbox/blackbox_io.h"
+
+    #include "build/debug.h"
+    #include "build/version.h"
+
+    #include "common/printf.h"
+    #include "common/time.h"
+
+    #include "config/feature.h"
+
+    #include "fc/config.h"
+    #include "fc/controlrate_profile.h"
+    #include "fc/fc_core.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/servos.h"
+
+    #include "io/beeper.h"
+    #include "io/gps.h"
+
+    #include "navigation/navigation.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/barometer.h"
+    #include "sensors/battery.h"
+    #include "sensors/compass.h"
+    #include "sensors/diagnostics.h"
+    #include "sensors/gyro.h"
+    #include "sensors/sensors.h"
+
+    extern uint8_t blackboxSnapshotHead;
+    extern uint8_t blackboxSnapshotTail;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Everything written to the blackbox device
+static std::vector<uint8_t> written;
+
+static bool blackboxModeActive;
+
+static timeUs_t currentTimeUs;
+
+#define SNAPSHOT_COUNT      4   // BLACKBOX_SNAPSHOT_COUNT
+#define I_FRAME_INTERVAL    32  // Every iteration is logged at the default rate
+
+// Run the PID loop and TASK_BLACKBOX for the given number of iterations
+static void runIterations(int count)
+{
+    for (int i = 0; i < count; i++) {
+        currentTimeUs += 1000;
+        blackboxCaptureIteration(currentTimeUs);
+        blackboxUpdate(currentTimeUs);
+    }
+}
+
+// Run the PID loop alone, TASK_BLACKBOX doesn't get to run
+static void runPidLoop(int count)
+{
+    for (int i = 0; i < count; i++) {
+        currentTimeUs += 1000;
+        blackboxCaptureIteration(currentTimeUs);
+    }
+}
+
+// Run TASK_BLACKBOX alone, without taking any snapshot
+static void runBlackboxTask(int count)
+{
+    for (int i = 0; i < count; i++) {
+        currentTimeUs += 1000;
+        blackboxUpdate(currentTimeUs);
+    }
+}
+
+static void appendUnsignedVB(std::vector<uint8_t> &out, uint32_t value)
+{
+    while (value > 127) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(value);
+}
+
+static std::vector<uint8_t> resumeEvent(uint32_t iteration, timeUs_t timeUs)
+{
+    std::vector<uint8_t> event = { 'E', FLIGHT_LOG_EVENT_LOGGING_RESUME };
+    appendUnsignedVB(event, iteration);
+    appendUnsignedVB(event, timeUs);
+    return event;
+}
+
+static bool writtenContains(const std::vector<uint8_t> &bytes)
+{
+    return std::search(written.begin(), written.end(), bytes.begin(), bytes.end()) != written.end();
+}
+
+static void startLogging(void)
+{
+    blackboxInit();
+    blackboxStart();
+
+    // Send the headers, nothing else is written once they are done
+    size_t headerSize = 0;
+    for (int idle = 0; idle < 50; idle++) {
+        runBlackboxTask(1);
+        if (written.size() != headerSize) {
+            headerSize = written.size();
+            idle = 0;
+        }
+    }
+    written.clear();
+}
+
+class BlackboxTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        written.clear();
+        blackboxModeActive = true;
+        gyroConfigMutable()->looptime = 1000;
+        currentTimeUs = 0;
+
+        memset(&GPS_home, 0, sizeof(GPS_home));
+        memset(&gpsSol, 0, sizeof(gpsSol));
+    }
+};
+
+TEST_F(BlackboxTest, NoGpsFramesWhilePaused)
+{
+    startLogging();
+
+    // GPS frames can only follow a main frame
+    runIterations(1);
+    EXPECT_FALSE(written.empty());
+
+    // TASK_BLACKBOX logs a new GPS position on its own while running
+    written.clear();
+    gpsSol.numSat = 10;
+    runBlackboxTask(1);
+    EXPECT_FALSE(written.empty());
+
+    // Pause, and let TASK_BLACKBOX drain the snapshots taken before the pause
+    blackboxModeActive = false;
+    runIterations(2);
+    written.clear();
+
+    // Neither a new home nor a new GPS position is logged while paused
+    GPS_home.lat = 300;
+    GPS_home.lon = 400;
+    gpsSol.numSat = 12;
+    gpsSol.llh.lat = 500;
+    gpsSol.llh.lon = 600;
+    runIterations(100);
+    runBlackboxTask(1);
+
+    EXPECT_TRUE(written.empty());
+}
+
+TEST_F(BlackboxTest, NothingDroppedWhileTheTaskKeepsUp)
+{
+    startLogging();
+
+    runIterations(I_FRAME_INTERVAL * 4);
+
+    EXPECT_EQ(0U, blackboxGetDroppedFrameCount());
+    EXPECT_EQ(blackboxSnapshotHead, blackboxSnapshotTail);
+    const std::vector<uint8_t> event = { 'E', FLIGHT_LOG_EVENT_LOGGING_RESUME };
+    EXPECT_FALSE(writtenContains(event));
+}
+
+TEST_F(BlackboxTest, SnapshotRingOverflowResyncsOnTheNextIFrame)
+{
+    startLogging();
+
+    // The I-frame of iteration 0
+    runIterations(1);
+    ASSERT_EQ(0U, blackboxGetDroppedFrameCount());
+
+    // TASK_BLACKBOX falls behind, the ring fills up and the rest is dropped
+    runPidLoop(10);
+    EXPECT_EQ(SNAPSHOT_COUNT, (uint8_t)(blackboxSnapshotHead - blackboxSnapshotTail));
+    EXPECT_EQ(10U - SNAPSHOT_COUNT, blackboxGetDroppedFrameCount());
+
+    // The frames queued before the overflow are still logged
+    written.clear();
+    runBlackboxTask(1);
+    EXPECT_EQ(blackboxSnapshotHead, blackboxSnapshotTail);
+    EXPECT_FALSE(written.empty());
+
+    // P-frames would be predicted across the gap, so they are dropped up to
+    // the next I-frame even though there is room again
+    runIterations(I_FRAME_INTERVAL - 11);
+    EXPECT_EQ(I_FRAME_INTERVAL - 1U - SNAPSHOT_COUNT, blackboxGetDroppedFrameCount());
+
+    // The I-frame is logged, right after an event telling the decoder
+    // that the gap is intended
+    written.clear();
+    runIterations(1);
+    const std::vector<uint8_t> event = resumeEvent(I_FRAME_INTERVAL, currentTimeUs);
+    ASSERT_GT(written.size(), event.size());
+    EXPECT_TRUE(std::equal(event.begin(), event.end(), written.begin()));
+    EXPECT_EQ('I', written[event.size()]);
+
+    // Back to normal
+    written.clear();
+    runIterations(1);
+    ASSERT_FALSE(written.empty());
+    EXPECT_EQ('P', written[0]);
+    EXPECT_EQ(I_FRAME_INTERVAL - 1U - SNAPSHOT_COUNT, blackboxGetDroppedFrameCount());
+    EXPECT_FALSE(writtenContains({ 'E', FLIGHT_LOG_EVENT_LOGGING_RESUME }));
+}
+
+TEST_F(BlackboxTest, DropCounterRestartsWithTheLog)
+{
+    startLogging();
+    runPidLoop(SNAPSHOT_COUNT + 3);
+    EXPECT_EQ(3U, blackboxGetDroppedFrameCount());
+
+    blackboxFinish();
+    runBlackboxTask(50);
+    startLogging();
+    EXPECT_EQ(0U, blackboxGetDroppedFrameCount());
+}
+
+// STUBS
+
+extern "C" {
+
+int32_t debug[DEBUG32_VALUE_COUNT];
+uint8_t debugMode;
+
+const char* const targetName = "TEST";
+const char* const shortGitRevision = "MASTER";
+const char* const buildDate = "Jan 01 2021";
+const char* const buildTime = "00:00:00";
+
+accelerometerConfig_t accelerometerConfig_System;
+barometerConfig_t barometerConfig_System;
+batteryMetersConfig_t batteryMetersConfig_System;
+compassConfig_t compassConfig_System;
+featureConfig_t featureConfig_System;
+gyroConfig_t gyroConfig_System;
+motorConfig_t motorConfig_System;
+rcControlsConfig_t rcControlsConfig_System;
+rxConfig_t rxConfig_System;
+systemConfig_t systemConfig_System;
+
+static pidProfile_t testPidProfile;
+pidProfile_t *pidProfile_ProfileCurrent = &testPidProfile;
+static controlRateConfig_t testControlRateProfile;
+const controlRateConfig_t *currentControlRateProfile = &testControlRateProfile;
+
+acc_t acc;
+attitudeEulerAngles_t attitude;
+baro_t baro;
+gyro_t gyro;
+mag_t mag;
+
+int32_t axisPID_P[FLIGHT_DYNAMICS_INDEX_COUNT];
+int32_t axisPID_I[FLIGHT_DYNAMICS_INDEX_COUNT];
+int32_t axisPID_D[FLIGHT_DYNAMICS_INDEX_COUNT];
+int32_t axisPID_F[FLIGHT_DYNAMICS_INDEX_COUNT];
+int32_t axisPID_Setpoint[FLIGHT_DYNAMICS_INDEX_COUNT];
+
+int16_t rcCommand[4];
+int16_t motor[MAX_SUPPORTED_MOTORS];
+int16_t servo[MAX_SUPPORTED_SERVOS];
+boxBitmask_t rcModeActivationMask;
+uint32_t stateFlags;
+
+gpsLocation_t GPS_home;
+gpsSolutionData_t gpsSol;
+
+int16_t navCurrentState;
+int16_t navActualVelocity[3];
+int16_t navDesiredVelocity[3];
+int32_t navTargetPosition[3];
+int32_t navLatestActualPosition[3];
+int16_t navActualSurface;
+uint16_t navFlags;
+uint16_t navEPH;
+uint16_t navEPV;
+int16_t navAccNEU[3];
+
+blackboxFrameBuffer_t blackboxFrameBuffer;
+int32_t blackboxHeaderBudget;
+
+// No frame is ever reserved, so every byte comes through here
+void blackboxWriteSlow(uint8_t value)
+{
+    written.push_back(value);
+}
+
+void blackboxReserveFrame(void) {}
+void blackboxCommitFrame(void) {}
+void blackboxDeviceFlush(void) {}
+bool blackboxDeviceFlushForce(void) { return true; }
+bool blackboxDeviceOpen(void) { return true; }
+void blackboxDeviceClose(void) {}
+bool blackboxDeviceBeginLog(void) { return true; }
+bool blackboxDeviceEndLog(bool retainLog) { UNUSED(retainLog); return true; }
+bool isBlackboxDeviceFull(void) { return false; }
+void blackboxReplenishHeaderBudget(void) { blackboxHeaderBudget = BLACKBOX_MAX_ACCUMULATED_HEADER_BUDGET; }
+blackboxBufferReserveStatus_e blackboxDeviceReserveBufferSpace(int32_t bytes)
+{
+    UNUSED(bytes);
+    return BLACKBOX_RESERVE_SUCCESS;
+}
+
+int blackboxPrint(const char *s)
+{
+    int length = 0;
+    while (*s) {
+        written.push_back(*s++);
+        length++;
+    }
+    return length;
+}
+
+static timeMs_t milliTime = 0;
+timeMs_t millis(void) { return milliTime += 10; }
+
+uint32_t getLooptime(void) { return 1000; }
+uint8_t getMotorCount(void) { return 4; }
+bool isMixerUsingServos(void) { return false; }
+int getThrottleIdleValue(void) { return 1150; }
+bool sensors(uint32_t mask) { UNUSED(mask); return true; }
+
+const pidBank_t *pidBank(void) { return &testPidProfile.bank_mc; }
+const navigationPIDControllers_t *getNavigationPIDControllers(void)
+{
+    static navigationPIDControllers_t controllers;
+    return &controllers;
+}
+int getWaypointCount(void) { return 0; }
+bool isWaypointListValid(void) { return false; }
+
+uint32_t getArmingBeepTimeMicros(void) { return 0; }
+disarmReason_t getDisarmReason(void) { return DISARM_NONE; }
+failsafePhase_e failsafePhase(void) { return FAILSAFE_IDLE; }
+
+int16_t getAmperage(void) { return 0; }
+uint16_t getBatteryRawVoltage(void) { return 1680; }
+uint16_t getBatterySagCompensatedVoltage(void) { return 1680; }
+uint16_t getPowerSupplyImpedance(void) { return 0; }
+bool getBaroTemperature(int16_t *temperature) { UNUSED(temperature); return false; }
+bool getIMUTemperature(int16_t *temperature) { UNUSED(temperature); return false; }
+
+hardwareSensorStatus_e getHwGyroStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwAccelerometerStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwCompassStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwBarometerStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwGPSStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwRangefinderStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwPitotmeterStatus(void) { return HW_SENSOR_NONE; }
+
+uint16_t getRSSI(void) { return 0; }
+rssiSource_e getRSSISource(void) { return RSSI_SOURCE_NONE; }
+bool rxIsReceivingSignal(void) { return true; }
+bool rxAreFlightChannelsValid(void) { return true; }
+int16_t rxGetChannelValue(unsigned channelNumber) { UNUSED(channelNumber); return 1500; }
+timeDelta_t rxGetLatencyUs(rxLatencyStage_e stage) { UNUSED(stage); return 0; }
+
+int tfp_format(void *putp, void (*putf) (void *, char), const char *fmt, va_list va)
+{
+    char buf[256];
+    const int length = vsnprintf(buf, sizeof(buf), fmt, va);
+    for (int i = 0; i < length && buf[i]; i++) {
+        putf(putp, buf[i]);
+    }
+    return length;
+}
+
+bool rtcGetDateTime(dateTime_t *dt) { UNUSED(dt); return false; }
+bool dateTimeFormatLocal(char *buf, dateTime_t *dt) { UNUSED(dt); buf[0] = '\0'; return false; }
+
+bool feature(uint32_t mask)
+{
+    return mask == FEATURE_BLACKBOX || mask == FEATURE_GPS;
+}
+
+bool isModeActivationConditionPresent(boxId_e modeId)
+{
+    return modeId == BOXBLACKBOX;
+}
+
+bool IS_RC_MODE_ACTIVE(boxId_e boxId)
+{
+    return boxId == BOXBLACKBOX && blackboxModeActive;
+}
+
+}
@@ -0,0 +1,352 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "build/version.h"
+
+    #include "common/memory.h"
+    #include "common/time.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/feature.h"
+    #include "config/parameter_group.h"
+    #include "config/parameter_group_ids.h"
+
+    #include "drivers/io.h"
+    #include "drivers/io_impl.h"
+    #include "drivers/pwm_mapping.h"
+    #include "drivers/serial.h"
+    #include "drivers/stack_check.h"
+    #include "drivers/time.h"
+
+    #include "fc/cli.h"
+    #include "fc/config.h"
+    #include "fc/fc_msp_box.h"
+    #include "fc/rc_adjustments.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+    #include "fc/settings.h"
+
+    #include "flight/mixer.h"
+    #include "flight/servos.h"
+
+    #include "io/gps.h"
+    #include "io/ledstrip.h"
+    #include "io/serial.h"
+
+    #include "navigation/navigation.h"
+
+    #include "programming/global_variables.h"
+    #include "programming/logic_condition.h"
+    #include "programming/pid.h"
+
+    #include "rx/rx.h"
+
+    #include "scheduler/scheduler.h"
+
+    #include "sensors/battery.h"
+    #include "sensors/diagnostics.h"
+    #include "sensors/sensors.h"
+
+    STATIC_UNIT_TESTED bool cliDumpInProgress(void);
+
+    PG_REGISTER_ARRAY(adjustmentRange_t, MAX_ADJUSTMENT_RANGE_COUNT, adjustmentRanges, PG_ADJUSTMENT_RANGE_CONFIG, 0);
+    PG_REGISTER_ARRAY(servoMixer_t, MAX_SERVO_RULES, customServoMixers, PG_SERVO_MIXER, 0);
+    PG_REGISTER(featureConfig_t, featureConfig, PG_FEATURE_CONFIG, 0);
+    PG_REGISTER_ARRAY(globalVariableConfig_t, MAX_GLOBAL_VARIABLES, globalVariableConfigs, PG_GLOBAL_VARIABLE_CONFIG, 0);
+    PG_REGISTER(ledStripConfig_t, ledStripConfig, PG_LED_STRIP_CONFIG, 0);
+    PG_REGISTER_ARRAY(logicCondition_t, MAX_LOGIC_CONDITIONS, logicConditions, PG_LOGIC_CONDITIONS, 0);
+    PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions, PG_MODE_ACTIVATION_PROFILE, 0);
+    PG_REGISTER_ARRAY(motorMixer_t, MAX_SUPPORTED_MOTORS, primaryMotorMixer, PG_MOTOR_MIXER, 0);
+    PG_REGISTER_ARRAY(programmingPid_t, MAX_PROGRAMMING_PID_COUNT, programmingPids, PG_PROGRAMMING_PID, 0);
+    PG_REGISTER_ARRAY(rxChannelRangeConfig_t, NON_AUX_CHANNEL_COUNT, rxChannelRangeConfigs, PG_RX_CHANNEL_RANGE_CONFIG, 0);
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+    PG_REGISTER_ARRAY(navSafeHome_t, MAX_SAFE_HOMES, safeHomeConfig, PG_SAFE_HOME_CONFIG, 0);
+    PG_REGISTER_WITH_RESET_TEMPLATE(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 0);
+    PG_REGISTER_ARRAY(servoParam_t, MAX_SUPPORTED_SERVOS, servoParams, PG_SERVO_PARAMS, 0);
+
+    PG_RESET_TEMPLATE(serialConfig_t, serialConfig,
+        .reboot_character = 'R',
+    );
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Output budget of a dump step, CLI_DUMP_CHUNK_SIZE in cli.c
+#define TEST_DUMP_CHUNK_SIZE 256
+
+static serialPort_t testPort;
+static std::string rxData;
+static size_t rxPos;
+static std::string txData;
+static uint32_t txFree;
+
+// Types the command into the CLI and runs it until the dump it started
+// is complete. Returns the size of the output of each cliProcess() call.
+static std::vector<size_t> runDump(const char *command, uint32_t txBytesFree)
+{
+    std::vector<size_t> chunks;
+
+    cliEnter(&testPort);
+    rxData = std::string(command) + "\r";
+    rxPos = 0;
+    txFree = txBytesFree;
+    cliProcess();
+    txData.clear();
+
+    for (int ii = 0; ii < 100000 && cliDumpInProgress(); ii++) {
+        const size_t before = txData.size();
+        cliProcess();
+        chunks.push_back(txData.size() - before);
+    }
+    EXPECT_FALSE(cliDumpInProgress());
+
+    return chunks;
+}
+
+// Sets up tables that print more than a chunk each
+static void fillTables(void)
+{
+    for (int ii = 0; ii < MAX_SUPPORTED_MOTORS; ii++) {
+        primaryMotorMixerMutable(ii)->throttle = 1.0f;
+        primaryMotorMixerMutable(ii)->roll = -1.0f;
+        primaryMotorMixerMutable(ii)->pitch = 0.5f;
+        primaryMotorMixerMutable(ii)->yaw = -0.25f;
+    }
+    for (int ii = 0; ii < MAX_SERVO_RULES; ii++) {
+        customServoMixersMutable(ii)->targetChannel = ii % MAX_SUPPORTED_SERVOS;
+        customServoMixersMutable(ii)->rate = 100;
+    }
+    for (int ii = 0; ii < MAX_LOGIC_CONDITIONS; ii++) {
+        logicConditionsMutable(ii)->enabled = 1;
+        logicConditionsMutable(ii)->operandA.value = 1000;
+    }
+    for (int ii = 0; ii < LED_MAX_STRIP_LENGTH; ii++) {
+        ledStripConfigMutable()->ledConfigs[ii] = ii;
+    }
+    for (int ii = 0; ii < MAX_MODE_ACTIVATION_CONDITION_COUNT; ii++) {
+        modeActivationConditionsMutable(ii)->range.endStep = 48;
+    }
+}
+
+TEST(CliTest, DumpStepsFitInAChunk)
+{
+    fillTables();
+
+    // With a single byte of room every call runs a single step of the
+    // dump, so each call shows what one step writes
+    const std::vector<size_t> chunks = runDump("dump all showdefaults", 1);
+
+    EXPECT_GT(txData.size(), 20U * TEST_DUMP_CHUNK_SIZE);
+    EXPECT_NE(std::string::npos, txData.find("mmix 11 "));
+    EXPECT_NE(std::string::npos, txData.find("logic 31 "));
+    EXPECT_NE(std::string::npos, txData.find("mode_color 6 10 "));
+    for (size_t ii = 0; ii < chunks.size(); ii++) {
+        EXPECT_LE(chunks[ii], (size_t)TEST_DUMP_CHUNK_SIZE) << "call " << ii;
+    }
+}
+
+TEST(CliTest, ResumedDumpMatchesLargeChunks)
+{
+    fillTables();
+
+    runDump("dump all", 1);
+    const std::string bytewise = txData;
+
+    const std::vector<size_t> chunks = runDump("dump all", 4096);
+    EXPECT_LT(chunks.size(), bytewise.size() / 64);
+
+    // Resuming the tables entry by entry neither repeats nor skips any output
+    EXPECT_EQ(bytewise, txData);
+}
+
+// STUBS
+
+extern "C" {
+
+int32_t debug[DEBUG32_VALUE_COUNT];
+uint8_t debugMode;
+
+const char* const targetName = "TEST";
+const char* const shortGitRevision = "MASTER";
+const char* const buildDate = "Jan 01 2021";
+const char* const buildTime = "00:00:00";
+const char* const compilerVersion = "GCC";
+
+uint32_t SystemCoreClock;
+uint8_t eepromData[EEPROM_SIZE];
+ioRec_t ioRecs[DEFIO_IO_USED_COUNT];
+uint8_t detectedSensors[SENSOR_INDEX_COUNT];
+uint32_t armingFlags;
+timeDelta_t cycleTime;
+uint16_t averageSystemLoadPercent;
+int16_t motor_disarmed[MAX_SUPPORTED_MOTORS];
+
+const char *armingDisableFlagNames[] = { NULL };
+const char * const ownerNames[OWNER_TOTAL_COUNT] = { NULL };
+const char * const resourceNames[RESOURCE_TOTAL_COUNT] = { NULL };
+const uint32_t baudRates[] = { 0, 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 250000,
+        460800, 921600, 1000000, 1500000, 2000000, 2470000 };
+const char rcChannelLetters[] = "AERT";
+
+timeMs_t millis(void) { return 0; }
+
+uint32_t serialRxBytesWaiting(const serialPort_t *instance) { UNUSED(instance); return rxData.size() - rxPos; }
+uint8_t serialRead(serialPort_t *instance) { UNUSED(instance); return rxData[rxPos++]; }
+uint32_t serialTxBytesFree(const serialPort_t *instance) { UNUSED(instance); return txFree; }
+void serialWrite(serialPort_t *instance, uint8_t ch) { UNUSED(instance); txData += (char)ch; }
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    UNUSED(instance);
+    txData.append((const char *)data, count);
+}
+bool isSerialTransmitBufferEmpty(const serialPort_t *instance) { UNUSED(instance); return true; }
+void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort) { UNUSED(serialPort); }
+baudRate_e lookupBaudRateIndex(uint32_t baudRate) { UNUSED(baudRate); return BAUD_AUTO; }
+serialPortConfig_t *serialFindPortConfiguration(serialPortIdentifier_e identifier) { UNUSED(identifier); return NULL; }
+bool serialIsPortAvailable(serialPortIdentifier_e identifier) { UNUSED(identifier); return true; }
+void gpsEnablePassthrough(struct serialPort_s *gpsPassthroughPort) { UNUSED(gpsPassthroughPort); }
+
+// The defaults are all zero
+void resetConfigs(void) { pgResetAll(MAX_PROFILE_COUNT); }
+void resetEEPROM(void) {}
+void writeEEPROM(void) {}
+uint16_t getEEPROMConfigSize(void) { return 0; }
+uint8_t getConfigProfile(void) { return 0; }
+bool setConfigProfile(uint8_t profileIndex) { UNUSED(profileIndex); return true; }
+void setConfigProfileAndWriteEEPROM(uint8_t profileIndex) { UNUSED(profileIndex); }
+uint8_t getConfigBatteryProfile(void) { return 0; }
+bool setConfigBatteryProfile(uint8_t profileIndex) { UNUSED(profileIndex); return true; }
+void setConfigBatteryProfileAndWriteEEPROM(uint8_t profileIndex) { UNUSED(profileIndex); }
+void fcReboot(bool bootLoader) { UNUSED(bootLoader); }
+
+uint32_t featureMask(void) { return featureConfig()->enabledFeatures; }
+void featureSet(uint32_t mask) { UNUSED(mask); }
+void featureClear(uint32_t mask) { UNUSED(mask); }
+uint32_t sensorsMask(void) { return 0; }
+
+static const box_t testBox = { 0, "TEST", 0 };
+const box_t *findBoxByActiveBoxId(uint8_t activeBoxId) { UNUSED(activeBoxId); return &testBox; }
+const box_t *findBoxByPermanentId(uint8_t permanentId) { UNUSED(permanentId); return &testBox; }
+
+void generateLedConfig(ledConfig_t *ledConfig, char *ledConfigBuffer, size_t bufferSize)
+{
+    snprintf(ledConfigBuffer, bufferSize, "%u,%u::C:%u", (unsigned)(*ledConfig % 16), (unsigned)(*ledConfig / 16), (unsigned)(*ledConfig % 8));
+}
+bool parseLedStripConfig(int ledIndex, const char *config) { UNUSED(ledIndex); UNUSED(config); return false; }
+bool parseColor(int index, const char *colorConfig) { UNUSED(index); UNUSED(colorConfig); return false; }
+bool setModeColor(ledModeIndex_e modeIndex, int modeColorIndex, int colorIndex)
+{
+    UNUSED(modeIndex);
+    UNUSED(modeColorIndex);
+    UNUSED(colorIndex);
+    return false;
+}
+
+void parseRcChannels(const char *input) { UNUSED(input); }
+void resetAllRxChannelRangeConfigurations(void) {}
+void resetSafeHomes(void) {}
+void mixerResetDisarmedMotors(void) {}
+
+batteryState_e getBatteryState(void) { return BATTERY_NOT_PRESENT; }
+uint16_t getBatteryVoltage(void) { return 0; }
+uint8_t getBatteryCellCount(void) { return 0; }
+
+hardwareSensorStatus_e getHwGyroStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwAccelerometerStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwCompassStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwBarometerStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwGPSStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwRangefinderStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwOpticalFlowStatus(void) { return HW_SENSOR_NONE; }
+
+pwmInitError_e getPwmInitError(void) { return PWM_INIT_ERROR_NONE; }
+const char *getPwmInitErrorMessage(void) { return ""; }
+
+int IO_GPIOPortIdx(IO_t io) { UNUSED(io); return 0; }
+int IO_GPIOPinIdx(IO_t io) { UNUSED(io); return 0; }
+uint32_t stackTotalSize(void) { return 0; }
+uint32_t stackHighMem(void) { return 0; }
+size_t memGetAvailableBytes(void) { return 0; }
+size_t memGetUsedBytesByOwner(resourceOwner_e owner) { UNUSED(owner); return 0; }
+bool rtcGetDateTime(dateTime_t *dt) { UNUSED(dt); return false; }
+bool dateTimeFormatLocal(char *buf, dateTime_t *dt) { UNUSED(dt); buf[0] = '\0'; return false; }
+
+void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t *taskInfo) { UNUSED(taskId); memset(taskInfo, 0, sizeof(*taskInfo)); }
+void getTaskHistogramInfo(cfTaskId_e taskId, cfTaskHistogramInfo_t *histogramInfo)
+{
+    UNUSED(taskId);
+    memset(histogramInfo, 0, sizeof(*histogramInfo));
+}
+void getCheckFuncInfo(cfCheckFuncInfo_t *checkFuncInfo) { memset(checkFuncInfo, 0, sizeof(*checkFuncInfo)); }
+timeDelta_t getTaskDeltaTime(cfTaskId_e taskId) { UNUSED(taskId); return 0; }
+void schedulerResetTaskStatistics(cfTaskId_e taskId) { UNUSED(taskId); }
+schedulerMode_e schedulerGetMode(void) { return (schedulerMode_e)0; }
+timeUs_t taskHistogramBucketLimit(int bucket) { UNUSED(bucket); return 0; }
+timeUs_t taskHistogramPercentile(const taskHistogram_t *histogram, uint8_t percentile)
+{
+    UNUSED(histogram);
+    UNUSED(percentile);
+    return 0;
+}
+
+// Every setting is the same master setting, a byte of the feature config
+static const setting_t testSetting = {};
+const setting_t *settingGet(unsigned index) { UNUSED(index); return &testSetting; }
+const setting_t *settingFind(const char *name) { UNUSED(name); return NULL; }
+void settingGetName(const setting_t *val, char *buf) { UNUSED(val); strcpy(buf, "test_setting"); }
+bool settingNameContains(const setting_t *val, char *buf, const char *cmdline)
+{
+    UNUSED(val);
+    UNUSED(cmdline);
+    buf[0] = '\0';
+    return false;
+}
+pgn_t settingGetPgn(const setting_t *val) { UNUSED(val); return PG_FEATURE_CONFIG; }
+uint16_t settingGetValueOffset(const setting_t *val, uint8_t profileIndex) { UNUSED(val); UNUSED(profileIndex); return 0; }
+void *settingGetValuePointer(const setting_t *val) { UNUSED(val); return featureConfigMutable(); }
+setting_min_t settingGetMin(const setting_t *val) { UNUSED(val); return 0; }
+setting_max_t settingGetMax(const setting_t *val) { UNUSED(val); return 255; }
+setting_max_t settingGetStringMaxLength(const setting_t *val) { UNUSED(val); return 0; }
+const lookupTableEntry_t *settingLookupTable(const setting_t *val) { UNUSED(val); return NULL; }
+const char *settingLookupValueName(const setting_t *val, unsigned v) { UNUSED(val); UNUSED(v); return NULL; }
+void settingSetString(const setting_t *val, const char *s, size_t size) { UNUSED(val); UNUSED(s); UNUSED(size); }
+bool settingsValidate(unsigned *invalidIndex) { UNUSED(invalidIndex); return true; }
+bool settingsGetParameterGroupIndexes(pgn_t pg, uint16_t *start, uint16_t *end)
+{
+    UNUSED(pg);
+    if (start) {
+        *start = 0;
+    }
+    if (end) {
+        *end = SETTINGS_TABLE_COUNT - 1;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,334 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/utils.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+    #include "config/parameter_group.h"
+
+    #include "drivers/system.h"
+
+    #include "fc/config.h"
+
+    typedef struct testSmallConfig_s {
+        uint8_t data[200];
+    } testSmallConfig_t;
+
+    typedef struct testLargeConfig_s {
+        uint32_t data[100];
+    } testLargeConfig_t;
+
+    typedef struct testProfileConfig_s {
+        uint16_t data[40];
+    } testProfileConfig_t;
+
+    PG_DECLARE(testSmallConfig_t, testSmallConfig);
+    PG_DECLARE(testLargeConfig_t, testLargeConfig);
+    PG_DECLARE_PROFILE(testProfileConfig_t, testProfileConfig);
+
+    PG_REGISTER_WITH_RESET_TEMPLATE(testSmallConfig_t, testSmallConfig, 500, 0);
+    PG_REGISTER(testLargeConfig_t, testLargeConfig, 501, 0);
+    PG_REGISTER_PROFILE(testProfileConfig_t, testProfileConfig, 502, 0);
+
+    PG_RESET_TEMPLATE(testSmallConfig_t, testSmallConfig,
+        .data = { 7 },
+    );
+
+    extern testProfileConfig_t testProfileConfig_Storage[MAX_PROFILE_COUNT];
+
+    static int failureModeCount;
+
+    void failureMode(failureMode_e mode)
+    {
+        UNUSED(mode);
+        failureModeCount++;
+    }
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define IMAGE_OVERHEAD      (1 + 2 + 2)     // header, footer and checksum
+#define RECORD_OVERHEAD     6
+// The first record of the base image is testSmallConfig
+#define SMALL_RECORD_PGN_OFFSET     (1 + 2)
+#define SMALL_RECORD_VERSION_OFFSET (1 + 4)
+
+#define BASE_IMAGE_SIZE     (IMAGE_OVERHEAD + RECORD_OVERHEAD + sizeof(testSmallConfig_t) + \
+                             RECORD_OVERHEAD + sizeof(testLargeConfig_t) + \
+                             MAX_PROFILE_COUNT * (RECORD_OVERHEAD + sizeof(testProfileConfig_t)))
+
+static unsigned alignToWriteUnit(unsigned size)
+{
+    return (size + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE;
+}
+
+static void fillConfigs(uint8_t seed)
+{
+    for (unsigned ii = 0; ii < ARRAYLEN(testSmallConfig_System.data); ii++) {
+        testSmallConfig_System.data[ii] = seed + ii;
+    }
+    for (unsigned ii = 0; ii < ARRAYLEN(testLargeConfig_System.data); ii++) {
+        testLargeConfig_System.data[ii] = seed * 1000 + ii;
+    }
+    for (unsigned profile = 0; profile < MAX_PROFILE_COUNT; profile++) {
+        for (unsigned ii = 0; ii < ARRAYLEN(testProfileConfig_Storage[profile].data); ii++) {
+            testProfileConfig_Storage[profile].data[ii] = seed * 100 + profile * 10 + ii;
+        }
+    }
+}
+
+// Like a reboot: forget the RAM copies and load them from the config area
+static void reload(void)
+{
+    memset(&testSmallConfig_System, 0, sizeof(testSmallConfig_System));
+    memset(&testLargeConfig_System, 0, sizeof(testLargeConfig_System));
+    memset(testProfileConfig_Storage, 0, sizeof(testProfileConfig_Storage));
+
+    ASSERT_TRUE(isEEPROMContentValid());
+    ASSERT_TRUE(loadEEPROM());
+}
+
+static void expectConfigs(uint8_t seed)
+{
+    testSmallConfig_t small;
+    testLargeConfig_t large;
+    testProfileConfig_t profiles[MAX_PROFILE_COUNT];
+
+    memcpy(&small, &testSmallConfig_System, sizeof(small));
+    memcpy(&large, &testLargeConfig_System, sizeof(large));
+    memcpy(profiles, testProfileConfig_Storage, sizeof(profiles));
+
+    fillConfigs(seed);
+
+    EXPECT_EQ(0, memcmp(&small, &testSmallConfig_System, sizeof(small)));
+    EXPECT_EQ(0, memcmp(&large, &testLargeConfig_System, sizeof(large)));
+    EXPECT_EQ(0, memcmp(profiles, testProfileConfig_Storage, sizeof(profiles)));
+}
+
+// Change a byte of the base image, keeping its checksum valid
+static void patchBaseImage(unsigned offset, uint8_t value)
+{
+    eepromData[offset] = value;
+    const uint16_t crc = crc16_ccitt_update(0, eepromData, BASE_IMAGE_SIZE - sizeof(crc));
+    memcpy(&eepromData[BASE_IMAGE_SIZE - sizeof(crc)], &crc, sizeof(crc));
+}
+
+class ConfigEepromTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        memset(eepromData, 0, sizeof(eepromData));
+        failureModeCount = 0;
+        EXPECT_FALSE(isEEPROMContentValid());
+
+        // First save writes all the PGs
+        fillConfigs(1);
+        writeConfigToEEPROM();
+        EXPECT_EQ(0, failureModeCount);
+        EXPECT_EQ(BASE_IMAGE_SIZE, getEEPROMConfigSize());
+    }
+};
+
+TEST_F(ConfigEepromTest, FullSaveLoads)
+{
+    reload();
+    expectConfigs(1);
+}
+
+TEST_F(ConfigEepromTest, SaveWithoutChangesWritesNothing)
+{
+    const uint8_t before = eepromData[alignToWriteUnit(BASE_IMAGE_SIZE)];
+
+    writeConfigToEEPROM();
+
+    EXPECT_EQ(0, failureModeCount);
+    EXPECT_EQ(BASE_IMAGE_SIZE, getEEPROMConfigSize());
+    EXPECT_EQ(before, eepromData[alignToWriteUnit(BASE_IMAGE_SIZE)]);
+}
+
+TEST_F(ConfigEepromTest, SaveAppendsChangedInstancesOnly)
+{
+    const testLargeConfig_t large = testLargeConfig_System;
+
+    fillConfigs(2);
+    // Unchanged PG and profile
+    testLargeConfig_System = large;
+    for (unsigned ii = 0; ii < ARRAYLEN(testProfileConfig_Storage[1].data); ii++) {
+        testProfileConfig_Storage[1].data[ii] = 1 * 100 + 1 * 10 + ii;
+    }
+    writeConfigToEEPROM();
+
+    EXPECT_EQ(0, failureModeCount);
+    const unsigned appended = IMAGE_OVERHEAD + RECORD_OVERHEAD + sizeof(testSmallConfig_t) +
+        2 * (RECORD_OVERHEAD + sizeof(testProfileConfig_t));
+    EXPECT_EQ(alignToWriteUnit(BASE_IMAGE_SIZE) + appended, getEEPROMConfigSize());
+
+    reload();
+    EXPECT_EQ(1 * 1000u, testLargeConfig_System.data[0]);
+    EXPECT_EQ(2, testSmallConfig_System.data[0]);
+    EXPECT_EQ(1 * 100 + 1 * 10, testProfileConfig_Storage[1].data[0]);
+    EXPECT_EQ(2 * 100 + 2 * 10, testProfileConfig_Storage[2].data[0]);
+}
+
+TEST_F(ConfigEepromTest, NewestRecordWins)
+{
+    for (int seed = 2; seed < 6; seed++) {
+        testSmallConfig_System.data[0] = seed;
+        writeConfigToEEPROM();
+    }
+    EXPECT_EQ(0, failureModeCount);
+
+    reload();
+    EXPECT_EQ(5, testSmallConfig_System.data[0]);
+    EXPECT_EQ(1u * 1000, testLargeConfig_System.data[0]);
+}
+
+TEST_F(ConfigEepromTest, FullLogIsCompacted)
+{
+    unsigned lastSize = getEEPROMConfigSize();
+    bool compacted = false;
+
+    for (int seed = 2; seed < 100 && !compacted; seed++) {
+        fillConfigs(seed);
+        writeConfigToEEPROM();
+        ASSERT_EQ(0, failureModeCount);
+
+        const unsigned size = getEEPROMConfigSize();
+        ASSERT_LE(size, (unsigned)EEPROM_SIZE);
+        if (size < lastSize) {
+            EXPECT_EQ(BASE_IMAGE_SIZE, size);
+            compacted = true;
+        }
+        lastSize = size;
+
+        reload();
+        expectConfigs(seed);
+    }
+    EXPECT_TRUE(compacted);
+}
+
+TEST_F(ConfigEepromTest, AppendStaysInTheEraseUnit)
+{
+    const unsigned eraseSize = config_streamer_erase_size((uintptr_t)eepromData);
+    ASSERT_LT(eraseSize, (unsigned)EEPROM_SIZE);
+
+    // Every PG changes, so each save appends a whole image
+    unsigned lastSize = getEEPROMConfigSize();
+    for (int seed = 2; seed < 20; seed++) {
+        fillConfigs(seed);
+        writeConfigToEEPROM();
+        ASSERT_EQ(0, failureModeCount);
+
+        // Entering the next unit would erase it, the log is compacted instead
+        const unsigned size = getEEPROMConfigSize();
+        ASSERT_LE(size, eraseSize);
+        if (size < lastSize) {
+            EXPECT_GT(alignToWriteUnit(lastSize) + BASE_IMAGE_SIZE, eraseSize);
+        }
+        lastSize = size;
+
+        reload();
+        expectConfigs(seed);
+    }
+}
+
+TEST_F(ConfigEepromTest, InterruptedAppendIsIgnored)
+{
+    testSmallConfig_System.data[0] = 42;
+    writeConfigToEEPROM();
+
+    // Break the checksum of the appended image
+    eepromData[getEEPROMConfigSize() - 1] ^= 0xff;
+
+    reload();
+    EXPECT_EQ(1, testSmallConfig_System.data[0]);
+    EXPECT_EQ(BASE_IMAGE_SIZE, getEEPROMConfigSize());
+
+    // Can't append over it, so the next save compacts
+    testSmallConfig_System.data[0] = 43;
+    writeConfigToEEPROM();
+    EXPECT_EQ(0, failureModeCount);
+    EXPECT_EQ(BASE_IMAGE_SIZE, getEEPROMConfigSize());
+
+    reload();
+    EXPECT_EQ(43, testSmallConfig_System.data[0]);
+}
+
+TEST_F(ConfigEepromTest, StaleImageAfterLogIsIgnored)
+{
+    // A complete image which isn't chained to the log, like the leftovers of an older, longer log
+    const unsigned staleOffset = alignToWriteUnit(BASE_IMAGE_SIZE);
+    memcpy(&eepromData[staleOffset], eepromData, BASE_IMAGE_SIZE);
+    eepromData[staleOffset + 1 + RECORD_OVERHEAD] = 99;
+
+    reload();
+    EXPECT_EQ(BASE_IMAGE_SIZE, getEEPROMConfigSize());
+    expectConfigs(1);
+}
+
+TEST_F(ConfigEepromTest, RecordOfUnknownPgIsSkipped)
+{
+    patchBaseImage(SMALL_RECORD_PGN_OFFSET, 0xee);
+
+    reload();
+    // Reset from the template
+    EXPECT_EQ(7, testSmallConfig_System.data[0]);
+    EXPECT_EQ(0, testSmallConfig_System.data[1]);
+    EXPECT_EQ(1u * 1000, testLargeConfig_System.data[0]);
+    EXPECT_EQ(1 * 100 + 2 * 10, testProfileConfig_Storage[2].data[0]);
+
+    // It's missing from the log, so it's saved even if unchanged
+    writeConfigToEEPROM();
+    EXPECT_EQ(alignToWriteUnit(BASE_IMAGE_SIZE) + IMAGE_OVERHEAD + RECORD_OVERHEAD + sizeof(testSmallConfig_t), getEEPROMConfigSize());
+}
+
+TEST_F(ConfigEepromTest, RecordWithOtherVersionKeepsDefaults)
+{
+    patchBaseImage(SMALL_RECORD_VERSION_OFFSET, 1);
+
+    reload();
+    EXPECT_EQ(7, testSmallConfig_System.data[0]);
+    EXPECT_EQ(1u * 1000, testLargeConfig_System.data[0]);
+}
+
+TEST_F(ConfigEepromTest, RecordsOutOfRegistryOrderLoad)
+{
+    // Appended in registry order, so the index has to wrap around to find testSmallConfig again
+    testProfileConfig_Storage[0].data[0] = 1234;
+    writeConfigToEEPROM();
+    testSmallConfig_System.data[0] = 77;
+    writeConfigToEEPROM();
+    testLargeConfig_System.data[0] = 4321;
+    writeConfigToEEPROM();
+    EXPECT_EQ(0, failureModeCount);
+
+    reload();
+    EXPECT_EQ(77, testSmallConfig_System.data[0]);
+    EXPECT_EQ(4321u, testLargeConfig_System.data[0]);
+    EXPECT_EQ(1234, testProfileConfig_Storage[0].data[0]);
+    EXPECT_EQ(1 * 100 + 1 * 10, testProfileConfig_Storage[1].data[0]);
+}
@@ -0,0 +1,292 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Checks the MSP displayport only sends what changed since the last
+// drawScreen(), by replaying the frames it pushes on a remote screen.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/display.h"
+    #include "drivers/time.h"
+
+    #include "io/displayport_msp.h"
+
+    #include "msp/msp_protocol.h"
+    #include "msp/msp_serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define ROWS            13
+#define COLS            30
+#define FRAME_OVERHEAD  6
+
+static std::vector<std::vector<uint8_t>> frames;
+static char remoteScreen[ROWS][COLS];
+static unsigned remoteDraws;
+static uint32_t txBytesFree;
+static bool pushFails;
+
+// Applies a MSP_DISPLAYPORT frame the way the goggles would
+static void remoteReceive(const uint8_t *data, int len)
+{
+    switch (data[0]) {
+    case 2:
+        memset(remoteScreen, ' ', sizeof(remoteScreen));
+        break;
+    case 3:
+        ASSERT_LT(data[1], ROWS);
+        ASSERT_LE(data[2] + len - 4, COLS);
+        memcpy(&remoteScreen[data[1]][data[2]], &data[4], len - 4);
+        break;
+    case 4:
+        remoteDraws++;
+        break;
+    }
+}
+
+extern "C" {
+    int32_t debug[DEBUG32_VALUE_COUNT];
+    uint8_t debugMode;
+    uint8_t cliMode;
+
+    static timeMs_t testTimeMs;
+    timeMs_t millis(void) { return testTimeMs; }
+
+    void displayInit(displayPort_t *instance, const displayPortVTable_t *vTable)
+    {
+        instance->vTable = vTable;
+        instance->vTable->clearScreen(instance);
+    }
+
+    int mspSerialPush(uint8_t cmd, const uint8_t *data, int datalen)
+    {
+        EXPECT_EQ(MSP_DISPLAYPORT, cmd);
+        if (pushFails) {
+            return 0;
+        }
+        frames.push_back(std::vector<uint8_t>(data, data + datalen));
+        remoteReceive(data, datalen);
+        return datalen + FRAME_OVERHEAD;
+    }
+
+    uint32_t mspSerialTxBytesFree(void) { return txBytesFree; }
+}
+
+class DisplayportMspTest : public ::testing::Test
+{
+protected:
+    displayPort_t *displayPort;
+
+    virtual void SetUp()
+    {
+        txBytesFree = UINT32_MAX;
+        pushFails = false;
+        memset(remoteScreen, 0, sizeof(remoteScreen));
+
+        displayPort = displayPortMspInit();
+        frames.clear();
+        remoteDraws = 0;
+    }
+
+    void write(uint8_t col, uint8_t row, const char *s)
+    {
+        displayPort->vTable->writeString(displayPort, col, row, s, TEXT_ATTRIBUTES_NONE);
+    }
+
+    int draw(void)
+    {
+        return displayPort->vTable->drawScreen(displayPort);
+    }
+
+    std::vector<uint8_t> writeFrame(uint8_t row, uint8_t col, const char *s)
+    {
+        std::vector<uint8_t> frame = { 3, row, col, 0 };
+        frame.insert(frame.end(), s, s + strlen(s));
+        return frame;
+    }
+
+    void expectRemoteShows(uint8_t col, uint8_t row, const char *s)
+    {
+        EXPECT_EQ(std::string(s), std::string(&remoteScreen[row][col], strlen(s)));
+    }
+};
+
+TEST_F(DisplayportMspTest, InitClearsTheRemoteScreen)
+{
+    for (int row = 0; row < ROWS; row++) {
+        expectRemoteShows(0, row, "                              ");
+    }
+}
+
+TEST_F(DisplayportMspTest, WritesAreSentOnDraw)
+{
+    write(1, 2, "ALT");
+    write(10, 5, "SPD");
+    EXPECT_TRUE(frames.empty());
+
+    const int sent = draw();
+    ASSERT_EQ(3u, frames.size());
+    EXPECT_EQ(writeFrame(2, 1, "ALT"), frames[0]);
+    EXPECT_EQ(writeFrame(5, 10, "SPD"), frames[1]);
+    EXPECT_EQ(std::vector<uint8_t>({ 4 }), frames[2]);
+    EXPECT_EQ(3 * FRAME_OVERHEAD + 2 * (4 + 3) + 1, sent);
+    EXPECT_EQ(1u, remoteDraws);
+}
+
+TEST_F(DisplayportMspTest, UnchangedWritesSendNothing)
+{
+    write(1, 2, "ALT 100");
+    draw();
+    frames.clear();
+
+    write(1, 2, "ALT 100");
+    EXPECT_EQ(0, draw());
+    EXPECT_TRUE(frames.empty());
+
+    // Only the changed chars go out
+    write(1, 2, "ALT 101");
+    draw();
+    ASSERT_EQ(2u, frames.size());
+    EXPECT_EQ(writeFrame(2, 7, "1"), frames[0]);
+    expectRemoteShows(1, 2, "ALT 101");
+}
+
+TEST_F(DisplayportMspTest, CloseChangesShareAFrame)
+{
+    write(0, 4, "A");
+    write(5, 4, "B");
+    // Too far away to be worth resending the gap
+    write(25, 4, "C");
+    // Runs don't span rows
+    write(29, 3, "D");
+    write(0, 4, "E");
+    draw();
+
+    ASSERT_EQ(4u, frames.size());
+    EXPECT_EQ(writeFrame(3, 29, "D"), frames[0]);
+    EXPECT_EQ(writeFrame(4, 0, "E    B"), frames[1]);
+    EXPECT_EQ(writeFrame(4, 25, "C"), frames[2]);
+}
+
+TEST_F(DisplayportMspTest, LimitedByTxBytesFree)
+{
+    for (int row = 0; row < ROWS; row++) {
+        write(0, row, "0123456789012345678901234567890");
+    }
+
+    // Room for 2 rows and the draw command
+    txBytesFree = 2 * (FRAME_OVERHEAD + 4 + COLS) + FRAME_OVERHEAD + 1;
+    for (int ii = 0; ii < 7; ii++) {
+        frames.clear();
+        draw();
+        EXPECT_EQ(ii < 6 ? 3u : 2u, frames.size());
+    }
+
+    for (int row = 0; row < ROWS; row++) {
+        expectRemoteShows(0, row, "012345678901234567890123456789");
+    }
+    frames.clear();
+    EXPECT_EQ(0, draw());
+}
+
+TEST_F(DisplayportMspTest, ClearIsRetriedWhenItCantBeSent)
+{
+    write(0, 0, "STALE");
+    draw();
+
+    pushFails = true;
+    displayPort->vTable->clearScreen(displayPort);
+    write(3, 1, "NEW");
+    EXPECT_EQ(0, draw());
+    expectRemoteShows(0, 0, "STALE");
+
+    pushFails = false;
+    frames.clear();
+    draw();
+    ASSERT_EQ(3u, frames.size());
+    EXPECT_EQ(std::vector<uint8_t>({ 2 }), frames[0]);
+    expectRemoteShows(0, 0, "     ");
+    expectRemoteShows(3, 1, "NEW");
+}
+
+TEST_F(DisplayportMspTest, HeartbeatResendsTheWholeScreenEverySecond)
+{
+    write(1, 2, "ALT");
+    draw();
+
+    // A write which got lost on the way
+    remoteScreen[2][1] = 'X';
+
+    testTimeMs += 500;
+    displayPort->vTable->heartbeat(displayPort);
+    frames.clear();
+    EXPECT_EQ(0, draw());
+
+    testTimeMs += 500;
+    displayPort->vTable->heartbeat(displayPort);
+    frames.clear();
+    draw();
+    // A row per frame and the draw command
+    EXPECT_EQ((size_t)ROWS + 1, frames.size());
+    expectRemoteShows(0, 2, " ALT");
+
+    // Not again until the next second
+    testTimeMs += 100;
+    displayPort->vTable->heartbeat(displayPort);
+    frames.clear();
+    EXPECT_EQ(0, draw());
+}
+
+TEST_F(DisplayportMspTest, Stats)
+{
+    mspDisplayportStats_t stats;
+    ASSERT_TRUE(displayPortMspGetStats(&stats));
+
+    testTimeMs += 1000;
+    draw();
+    for (int ii = 0; ii < 10; ii++) {
+        testTimeMs += 100;
+        write(0, 0, ii % 2 ? "ODD " : "EVEN");
+        draw();
+    }
+
+    ASSERT_TRUE(displayPortMspGetStats(&stats));
+    // A 4 char write and the draw command every 100ms
+    EXPECT_EQ(20, stats.framesPerSecond);
+    EXPECT_EQ(10u * (2 * FRAME_OVERHEAD + 4 + 4 + 1), stats.bytesPerSecond);
+}
@@ -0,0 +1,149 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "common/filter.h"
+    #include "common/maths.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define LOOPTIME_US     500
+#define SAMPLE_COUNT    1000
+
+// Different signal on each axis, so mixing up the axes state shows up
+static float testSignal(int axis, int sample)
+{
+    const float t = sample * LOOPTIME_US * 1e-6f;
+    return 100.0f * sinf(2.0f * M_PIf * (40.0f + 100.0f * axis) * t) + 20.0f * (axis - 1);
+}
+
+TEST(FilterUnittest, Pt1BankMatchesPt1)
+{
+    pt1Filter_t filters[FILTER_BANK3_SIZE];
+    pt1FilterBank3_t bank;
+
+    for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+        pt1FilterInit(&filters[axis], 90, LOOPTIME_US * 1e-6f);
+    }
+    pt1FilterBank3Init(&bank, 90, LOOPTIME_US * 1e-6f);
+
+    for (int sample = 0; sample < SAMPLE_COUNT; sample++) {
+        if (sample == SAMPLE_COUNT / 2) {
+            for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+                pt1FilterUpdateCutoff(&filters[axis], 150);
+            }
+            pt1FilterBank3UpdateCutoff(&bank, 150);
+        }
+
+        float data[FILTER_BANK3_SIZE];
+        for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+            data[axis] = testSignal(axis, sample);
+        }
+        pt1FilterBank3Apply(&bank, data);
+
+        for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+            EXPECT_FLOAT_EQ(pt1FilterApply(&filters[axis], testSignal(axis, sample)), data[axis]);
+        }
+    }
+}
+
+TEST(FilterUnittest, BiquadBankMatchesBiquad)
+{
+    biquadFilter_t filters[FILTER_BANK3_SIZE];
+    biquadFilterBank3_t bank;
+
+    for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+        biquadFilterInitLPF(&filters[axis], 110, LOOPTIME_US);
+    }
+    biquadFilterBank3Init(&bank, 110, LOOPTIME_US, BIQUAD_Q, FILTER_LPF);
+
+    for (int sample = 0; sample < SAMPLE_COUNT; sample++) {
+        if (sample == SAMPLE_COUNT / 2) {
+            for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+                biquadFilterUpdate(&filters[axis], 80, LOOPTIME_US, BIQUAD_Q, FILTER_LPF);
+            }
+            biquadFilterBank3Update(&bank, 80, LOOPTIME_US, BIQUAD_Q, FILTER_LPF);
+        }
+
+        float data[FILTER_BANK3_SIZE];
+        for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+            data[axis] = testSignal(axis, sample);
+        }
+        biquadFilterBank3Apply(&bank, data);
+
+        for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+            EXPECT_FLOAT_EQ(biquadFilterApply(&filters[axis], testSignal(axis, sample)), data[axis]);
+        }
+    }
+}
+
+TEST(FilterUnittest, BiquadBankDF1MatchesBiquadDF1)
+{
+    biquadFilter_t filters[FILTER_BANK3_SIZE];
+    biquadFilterBank3_t bank;
+
+    for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+        biquadFilterInit(&filters[axis], 140, LOOPTIME_US, 5.0f, FILTER_NOTCH);
+    }
+    biquadFilterBank3Init(&bank, 140, LOOPTIME_US, 5.0f, FILTER_NOTCH);
+
+    for (int sample = 0; sample < SAMPLE_COUNT; sample++) {
+        // Notch tracking a moving frequency, like the RPM filter does
+        if (sample % 10 == 0) {
+            const float frequency = 140.0f + sample * 0.1f;
+            for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+                biquadFilterUpdate(&filters[axis], frequency, LOOPTIME_US, 5.0f, FILTER_NOTCH);
+            }
+            biquadFilterBank3Update(&bank, frequency, LOOPTIME_US, 5.0f, FILTER_NOTCH);
+        }
+
+        float data[FILTER_BANK3_SIZE];
+        for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+            data[axis] = testSignal(axis, sample);
+        }
+        biquadFilterBank3ApplyDF1(&bank, data);
+
+        for (int axis = 0; axis < FILTER_BANK3_SIZE; axis++) {
+            EXPECT_FLOAT_EQ(biquadFilterApplyDF1(&filters[axis], testSignal(axis, sample)), data[axis]);
+        }
+    }
+}
+
+TEST(FilterUnittest, NullBankLeavesDataUntouched)
+{
+    float data[FILTER_BANK3_SIZE] = { 1.0f, -2.0f, 3.0f };
+
+    nullFilterBank3Apply(NULL, data);
+
+    EXPECT_FLOAT_EQ(1.0f, data[0]);
+    EXPECT_FLOAT_EQ(-2.0f, data[1]);
+    EXPECT_FLOAT_EQ(3.0f, data[2]);
+}
@@ -0,0 +1,359 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Runs the MAX7456 driver against a register level stand-in of the chip,
+// which decodes the SPI stream into display memory and counts the bytes
+// sent to it.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/bus.h"
+    #include "drivers/max7456.h"
+    #include "drivers/osd.h"
+    #include "drivers/time.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define REG_VM0     0x00
+#define REG_DMM     0x04
+#define REG_DMAH    0x05
+#define REG_DMAL    0x06
+#define REG_DMDI    0x07
+#define REG_STAT    0x20 // 0xA0 without the read bit
+#define REG_READ    0x80
+
+#define DMM_AUTOINCREMENT   0x01
+#define DMM_CLEAR_DISPLAY   0x04
+#define DMM_ATTR_MASK       0x38
+#define DMM_8BIT_MODE       0x40
+
+#define DMAH_ATTR           0x02
+#define END_STRING          0xFF
+
+#define SCREEN_CHARS        (MAX7456_LINES_PAL * MAX7456_CHARS_PER_LINE)
+
+typedef struct max7456Model_s {
+    uint8_t vm0;
+    uint8_t dmm;
+    uint8_t dmah;
+    uint8_t dmal;
+    bool autoIncrement;
+    uint16_t autoIncrementAddress;
+    // Character and attribute bytes, the latter in the DMDI format
+    uint8_t chars[512];
+    uint8_t attrs[512];
+
+    unsigned transfers;
+    size_t transferBytes;
+    size_t maxTransferBytes;
+    unsigned autoIncrementRuns;
+} max7456Model_t;
+
+static max7456Model_t model;
+
+static void modelClear(void)
+{
+    memset(model.chars, 0x20, sizeof(model.chars));
+    memset(model.attrs, 0, sizeof(model.attrs));
+}
+
+static uint16_t modelAddress(void)
+{
+    return ((model.dmah & 0x01) << 8) | model.dmal;
+}
+
+static void modelWriteRegister(uint8_t reg, uint8_t value)
+{
+    switch (reg) {
+    case REG_VM0:
+        model.vm0 = value & ~0x02; // Reset completes immediately
+        break;
+    case REG_DMM:
+        if (value & DMM_CLEAR_DISPLAY) {
+            modelClear();
+        }
+        model.dmm = value & ~DMM_CLEAR_DISPLAY;
+        if (value & DMM_AUTOINCREMENT) {
+            model.autoIncrement = true;
+            model.autoIncrementAddress = modelAddress();
+            model.autoIncrementRuns++;
+        }
+        break;
+    case REG_DMAH:
+        model.dmah = value;
+        break;
+    case REG_DMAL:
+        model.dmal = value;
+        break;
+    case REG_DMDI:
+        if (model.dmah & DMAH_ATTR) {
+            model.attrs[modelAddress()] = value;
+        } else {
+            model.chars[modelAddress()] = value;
+            if (!(model.dmm & DMM_8BIT_MODE)) {
+                model.attrs[modelAddress()] = (model.dmm & DMM_ATTR_MASK) << 2;
+            }
+        }
+        break;
+    }
+}
+
+static void modelReceive(const uint8_t *data, int length)
+{
+    for (int ii = 0; ii < length;) {
+        if (model.autoIncrement) {
+            const uint8_t c = data[ii++];
+            if (c == END_STRING) {
+                model.autoIncrement = false;
+                model.dmm &= ~DMM_AUTOINCREMENT;
+            } else {
+                // Auto-increment always writes chars with the DMM attributes
+                model.chars[model.autoIncrementAddress] = c;
+                model.attrs[model.autoIncrementAddress] = (model.dmm & DMM_ATTR_MASK) << 2;
+                model.autoIncrementAddress++;
+            }
+            continue;
+        }
+        ASSERT_LT(ii + 1, length) << "register write without a value";
+        modelWriteRegister(data[ii], data[ii + 1]);
+        ii += 2;
+    }
+}
+
+extern "C" {
+    uint16_t osdCharacterGridBuffer[OSD_CHARACTER_GRID_BUFFER_SIZE] ALIGNED(4);
+
+    static busDevice_t testBusDevice;
+    static timeMs_t testTimeMs;
+
+    // Advance on every call, the driver busy waits on the chip in a few places
+    timeMs_t millis(void) { return ++testTimeMs; }
+
+    busDevice_t * busDeviceInit(busType_e bus, devHardwareType_e hw, uint8_t tag, resourceOwner_e owner)
+    {
+        UNUSED(bus); UNUSED(hw); UNUSED(tag); UNUSED(owner);
+        return &testBusDevice;
+    }
+
+    void busSetSpeed(const busDevice_t * dev, busSpeed_e speed) { UNUSED(dev); UNUSED(speed); }
+
+    bool busWrite(const busDevice_t * busdev, uint8_t reg, uint8_t data)
+    {
+        UNUSED(busdev);
+        modelWriteRegister(reg, data);
+        return true;
+    }
+
+    bool busRead(const busDevice_t * busdev, uint8_t reg, uint8_t * data)
+    {
+        UNUSED(busdev);
+        switch (reg & ~REG_READ) {
+        case REG_VM0:
+            *data = model.vm0;
+            break;
+        case REG_DMM:
+            *data = model.dmm;
+            break;
+        case REG_STAT:
+            *data = 0x01; // PAL
+            break;
+        default:
+            *data = 0;
+            break;
+        }
+        return true;
+    }
+
+    bool busTransfer(const busDevice_t * dev, uint8_t * rxBuf, const uint8_t * txBuf, int length)
+    {
+        UNUSED(dev);
+        UNUSED(rxBuf);
+        model.transfers++;
+        model.transferBytes += length;
+        if ((size_t)length > model.maxTransferBytes) {
+            model.maxTransferBytes = length;
+        }
+        modelReceive(txBuf, length);
+        return true;
+    }
+}
+
+class Max7456Test : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        // The driver state can't be reset, so it's initialized once
+        // and each test starts from a cleared screen.
+        static bool initialized = false;
+        if (!initialized) {
+            memset(&model, 0, sizeof(model));
+            // Start from garbage, so the initial redraw is checked too
+            memset(model.chars, 0xA5, sizeof(model.chars));
+            max7456Init(VIDEO_SYSTEM_PAL);
+            initialized = true;
+        }
+
+        max7456ClearScreen();
+        flush();
+        expectScreenMatches();
+        resetCounters();
+    }
+
+    void resetCounters(void)
+    {
+        model.transfers = 0;
+        model.transferBytes = 0;
+        model.maxTransferBytes = 0;
+        model.autoIncrementRuns = 0;
+    }
+
+    // Calls max7456Update() until there's nothing left to send
+    void flush(void)
+    {
+        for (int ii = 0; ii < 1000; ii++) {
+            const unsigned transfers = model.transfers;
+            max7456Update();
+            if (model.transfers == transfers) {
+                return;
+            }
+        }
+        FAIL() << "screen never settled";
+    }
+
+    void expectScreenMatches(void)
+    {
+        ASSERT_FALSE(model.autoIncrement) << "auto-increment mode left enabled";
+        for (unsigned ii = 0; ii < SCREEN_CHARS; ii++) {
+            const uint16_t val = osdCharacterGridBuffer[ii];
+            ASSERT_EQ(val >> 8, model.chars[ii]) << "char at " << ii;
+            // Mode bits go 2 bits up in DMDI, taking the ext bit to bit 4
+            ASSERT_EQ((uint8_t)((val & 0xFF) << 2), model.attrs[ii]) << "attributes at " << ii;
+        }
+    }
+};
+
+TEST_F(Max7456Test, FullScreenIsStreamedInRuns)
+{
+    char line[MAX7456_CHARS_PER_LINE + 1];
+    for (int y = 0; y < MAX7456_LINES_PAL; y++) {
+        for (int x = 0; x < MAX7456_CHARS_PER_LINE; x++) {
+            line[x] = 'A' + (x + y) % 26;
+        }
+        line[MAX7456_CHARS_PER_LINE] = '\0';
+        max7456Write(0, y, line, 0);
+    }
+
+    flush();
+    expectScreenMatches();
+
+    // DMAH, DMAL and DMDI for every char would take 6 bytes each
+    EXPECT_LT(model.transferBytes, (size_t)SCREEN_CHARS * 6 / 4);
+    EXPECT_LE(model.maxTransferBytes, (size_t)140);
+    EXPECT_GT(model.autoIncrementRuns, 0u);
+
+    resetCounters();
+    max7456ClearScreen();
+    flush();
+    expectScreenMatches();
+    EXPECT_LT(model.transferBytes, (size_t)SCREEN_CHARS * 6 / 4);
+}
+
+TEST_F(Max7456Test, RefreshAll)
+{
+    max7456Write(3, 4, "REFRESH ALL", 0);
+    max7456Write(3, 5, "BLINKING", MAX7456_MODE_BLINK);
+    max7456RefreshAll();
+    expectScreenMatches();
+    // Blanks aren't redrawn after clearing the chip, so the space
+    // splits the first line in 2 runs
+    EXPECT_EQ(3u, model.autoIncrementRuns);
+}
+
+TEST_F(Max7456Test, RunsSplitOnAttributeChanges)
+{
+    max7456Write(0, 2, "NORMAL", 0);
+    max7456Write(6, 2, "INVERT", MAX7456_MODE_INVERT);
+    max7456Write(12, 2, "BLINK", MAX7456_MODE_BLINK);
+    max7456Write(17, 2, "NORMAL", 0);
+
+    flush();
+    expectScreenMatches();
+    EXPECT_EQ(4u, model.autoIncrementRuns);
+}
+
+TEST_F(Max7456Test, RunsContinueAcrossLines)
+{
+    max7456Write(25, 7, "ABCDE", 0);
+    max7456Write(0, 8, "FGHIJ", 0);
+
+    flush();
+    expectScreenMatches();
+    EXPECT_EQ(1u, model.autoIncrementRuns);
+}
+
+TEST_F(Max7456Test, ExtendedCharsAndEndStringAreSentOnTheirOwn)
+{
+    // 0xFF would terminate auto-increment mode, so it can't be part of a run
+    max7456Write(2, 10, "AB\xff" "CD", 0);
+    max7456WriteChar(7, 10, 0x1A0, 0);
+    max7456WriteChar(8, 10, 0x1A1, MAX7456_MODE_BLINK);
+    max7456Write(9, 10, "EF", 0);
+
+    flush();
+    expectScreenMatches();
+    EXPECT_EQ(3u, model.autoIncrementRuns);
+}
+
+TEST_F(Max7456Test, IsolatedCharsUseRegisterWrites)
+{
+    for (int x = 0; x < MAX7456_CHARS_PER_LINE; x += 2) {
+        max7456WriteChar(x, 12, 'X', 0);
+    }
+
+    flush();
+    expectScreenMatches();
+    EXPECT_EQ(0u, model.autoIncrementRuns);
+    EXPECT_EQ((size_t)15 * 6, model.transferBytes);
+}
+
+TEST_F(Max7456Test, UnchangedScreenSendsNothing)
+{
+    max7456Write(1, 1, "STATIC", 0);
+    flush();
+    resetCounters();
+
+    max7456Write(1, 1, "STATIC", 0);
+    flush();
+    EXPECT_EQ(0u, model.transfers);
+}
@@ -0,0 +1,425 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "build/version.h"
+
+    #include "common/streambuf.h"
+    #include "common/time.h"
+
+    #include "config/feature.h"
+
+    #include "drivers/time.h"
+    #include "drivers/timer.h"
+    #include "drivers/vtx_common.h"
+
+    #include "fc/config.h"
+    #include "fc/controlrate_profile.h"
+    #include "fc/fc_core.h"
+    #include "fc/fc_msp.h"
+    #include "fc/fc_msp_box.h"
+    #include "fc/rc_adjustments.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+    #include "fc/settings.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/servos.h"
+
+    #include "io/gps.h"
+    #include "io/ledstrip.h"
+    #include "io/serial.h"
+    #include "io/vtx.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_protocol.h"
+
+    #include "navigation/navigation.h"
+
+    #include "rx/rx.h"
+
+    #include "scheduler/scheduler.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/barometer.h"
+    #include "sensors/battery.h"
+    #include "sensors/boardalignment.h"
+    #include "sensors/compass.h"
+    #include "sensors/diagnostics.h"
+    #include "sensors/gyro.h"
+    #include "sensors/sensors.h"
+
+    STATIC_UNIT_TESTED bool mspFcProcessOutCommand(uint16_t cmdMSP, sbuf_t *dst, mspPostProcessFnPtr *mspPostProcessFn);
+    STATIC_UNIT_TESTED mspResult_e mspFcProcessInCommand(uint16_t cmdMSP, sbuf_t *src);
+    bool mspFCProcessInOutCommand(uint16_t cmdMSP, sbuf_t *dst, sbuf_t *src, mspResult_e *ret);
+    STATIC_UNIT_TESTED mspHandler_e mspFcFindHandler(uint16_t cmdMSP);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Big enough for any reply, the payload is all zeroes
+static uint8_t replyBuffer[4096];
+static uint8_t payloadBuffer[1024];
+
+static sbuf_t *resetReply(sbuf_t *dst)
+{
+    dst->ptr = replyBuffer;
+    dst->end = replyBuffer + sizeof(replyBuffer);
+    return dst;
+}
+
+static sbuf_t *resetPayload(sbuf_t *src)
+{
+    memset(payloadBuffer, 0, sizeof(payloadBuffer));
+    src->ptr = payloadBuffer;
+    src->end = payloadBuffer + sizeof(payloadBuffer);
+    return src;
+}
+
+// Which of the switches in fc_msp.c handles the command
+static mspHandler_e mspFcHandlerFromSwitches(uint16_t cmd, int *handlerCount)
+{
+    mspHandler_e handler = MSP_HANDLER_NONE;
+    mspPostProcessFnPtr postProcessFn = NULL;
+    mspResult_e ret;
+    sbuf_t dst;
+    sbuf_t src;
+
+    *handlerCount = 0;
+
+    if (mspFcProcessOutCommand(cmd, resetReply(&dst), &postProcessFn)) {
+        handler = MSP_HANDLER_OUT;
+        (*handlerCount)++;
+    }
+    if (mspFcProcessInCommand(cmd, resetPayload(&src)) != MSP_RESULT_CMD_UNKNOWN) {
+        handler = MSP_HANDLER_IN;
+        (*handlerCount)++;
+    }
+    if (mspFCProcessInOutCommand(cmd, resetReply(&dst), resetPayload(&src), &ret)) {
+        handler = MSP_HANDLER_IN_OUT;
+        (*handlerCount)++;
+    }
+    if (cmd == MSP_SET_PASSTHROUGH) {
+        handler = MSP_HANDLER_PASSTHROUGH;
+        (*handlerCount)++;
+    }
+    if (cmd == MSP2_COMMON_MULTI || cmd == MSP2_COMMON_SUBSCRIBE) {
+        handler = MSP_HANDLER_SERIAL;
+        (*handlerCount)++;
+    }
+
+    return handler;
+}
+
+TEST(MspFcTest, HandlerTablesMatchSwitches)
+{
+    static const uint16_t pages[] = { 0x0000, 0x1000, 0x2000 };
+
+    for (unsigned ii = 0; ii < ARRAYLEN(pages); ii++) {
+        for (uint16_t cmd = pages[ii]; cmd <= pages[ii] + 0xFF; cmd++) {
+            int handlerCount;
+            const mspHandler_e expected = mspFcHandlerFromSwitches(cmd, &handlerCount);
+
+            EXPECT_LE(handlerCount, 1) << "command 0x" << std::hex << cmd << " is in several switches";
+            EXPECT_EQ(expected, mspFcFindHandler(cmd)) << "command 0x" << std::hex << cmd;
+        }
+    }
+}
+
+TEST(MspFcTest, UnknownCommandIsAnError)
+{
+    mspPacket_t cmd;
+    mspPacket_t reply;
+    mspPostProcessFnPtr postProcessFn = NULL;
+
+    memset(&cmd, 0, sizeof(cmd));
+    memset(&reply, 0, sizeof(reply));
+    cmd.cmd = 0x20FF;
+    resetPayload(&cmd.buf);
+    resetReply(&reply.buf);
+
+    EXPECT_EQ(MSP_HANDLER_NONE, mspFcFindHandler(0x20FF));
+    EXPECT_EQ(MSP_RESULT_ERROR, mspFcProcessCommand(&cmd, &reply, &postProcessFn));
+    EXPECT_EQ(MSP_RESULT_ERROR, reply.result);
+}
+
+TEST(MspFcTest, CommandListIncludesSerialCommands)
+{
+    mspPacket_t cmd;
+    mspPacket_t reply;
+    mspPostProcessFnPtr postProcessFn = NULL;
+
+    memset(&cmd, 0, sizeof(cmd));
+    memset(&reply, 0, sizeof(reply));
+    cmd.cmd = MSP2_INAV_COMMAND_LIST;
+    // Start at the MSPv2 common page
+    payloadBuffer[0] = 0x00;
+    payloadBuffer[1] = 0x10;
+    cmd.buf.ptr = payloadBuffer;
+    cmd.buf.end = payloadBuffer + 2;
+    resetReply(&reply.buf);
+
+    EXPECT_EQ(MSP_RESULT_ACK, mspFcProcessCommand(&cmd, &reply, &postProcessFn));
+
+    bool foundMulti = false;
+    bool foundSubscribe = false;
+    for (const uint8_t *p = replyBuffer; p < reply.buf.ptr; p += 2) {
+        const uint16_t listed = p[0] | (p[1] << 8);
+        EXPECT_GE(listed, 0x1000);
+        foundMulti |= listed == MSP2_COMMON_MULTI;
+        foundSubscribe |= listed == MSP2_COMMON_SUBSCRIBE;
+    }
+    EXPECT_TRUE(foundMulti);
+    EXPECT_TRUE(foundSubscribe);
+
+    // Not on their own, only when received from a serial port
+    EXPECT_EQ(MSP_HANDLER_SERIAL, mspFcFindHandler(MSP2_COMMON_MULTI));
+    EXPECT_EQ(MSP_HANDLER_SERIAL, mspFcFindHandler(MSP2_COMMON_SUBSCRIBE));
+}
+
+// STUBS
+
+extern "C" {
+
+int32_t debug[DEBUG32_VALUE_COUNT];
+uint8_t debugMode;
+
+const char* const targetName = "TEST";
+const char* const shortGitRevision = "MASTER";
+const char* const buildDate = "Jan 01 2021";
+const char* const buildTime = "00:00:00";
+
+accelerometerConfig_t accelerometerConfig_System;
+adjustmentRange_t adjustmentRanges_SystemArray[MAX_ADJUSTMENT_RANGE_COUNT];
+armingConfig_t armingConfig_System;
+barometerConfig_t barometerConfig_System;
+batteryMetersConfig_t batteryMetersConfig_System;
+boardAlignment_t boardAlignment_System;
+compassConfig_t compassConfig_System;
+servoMixer_t customServoMixers_SystemArray[MAX_SERVO_RULES];
+failsafeConfig_t failsafeConfig_System;
+gpsConfig_t gpsConfig_System;
+gyroConfig_t gyroConfig_System;
+ledStripConfig_t ledStripConfig_System;
+mixerConfig_t mixerConfig_System;
+modeActivationCondition_t modeActivationConditions_SystemArray[MAX_MODE_ACTIVATION_CONDITION_COUNT];
+motorConfig_t motorConfig_System;
+navConfig_t navConfig_System;
+positionEstimationConfig_t positionEstimationConfig_System;
+motorMixer_t primaryMotorMixer_SystemArray[MAX_SUPPORTED_MOTORS];
+rcControlsConfig_t rcControlsConfig_System;
+reversibleMotorsConfig_t reversibleMotorsConfig_System;
+rxConfig_t rxConfig_System;
+navSafeHome_t safeHomeConfig_SystemArray[MAX_SAFE_HOMES];
+serialConfig_t serialConfig_System;
+servoConfig_t servoConfig_System;
+servoParam_t servoParams_SystemArray[MAX_SUPPORTED_SERVOS];
+systemConfig_t systemConfig_System;
+timeConfig_t timeConfig_System;
+vtxSettingsConfig_t vtxSettingsConfig_System;
+
+static pidProfile_t testPidProfile;
+pidProfile_t *pidProfile_ProfileCurrent = &testPidProfile;
+extern const pgRegistry_t pidProfile_Registry = {};
+void pgResetCurrent(const pgRegistry_t *reg) { UNUSED(reg); }
+
+static controlRateConfig_t testControlRateProfile;
+const controlRateConfig_t *currentControlRateProfile = &testControlRateProfile;
+static batteryProfile_t testBatteryProfile;
+const batteryProfile_t *currentBatteryProfile = &testBatteryProfile;
+
+acc_t acc;
+attitudeEulerAngles_t attitude;
+mag_t mag;
+int16_t motor[MAX_SUPPORTED_MOTORS];
+int16_t motor_disarmed[MAX_SUPPORTED_MOTORS];
+int16_t servo[MAX_SUPPORTED_SERVOS];
+uint32_t armingFlags;
+uint32_t stateFlags;
+timeDelta_t cycleTime;
+uint16_t averageSystemLoadPercent;
+
+gpsSolutionData_t gpsSol;
+gpsStatistics_t gpsStats;
+int16_t GPS_directionToHome;
+uint32_t GPS_distanceToHome;
+navSystemStatus_t NAV_Status;
+radar_pois_t radar_pois[RADAR_MAX_POIS];
+rxRuntimeConfig_t rxRuntimeConfig;
+
+const timerHardware_t timerHardware[1] = {};
+const int timerHardwareCount = 0;
+
+timeUs_t micros(void) { return 0; }
+void fcReboot(bool bootLoader) { UNUSED(bootLoader); }
+
+uint32_t featureMask(void) { return 0; }
+void featureSet(uint32_t mask) { UNUSED(mask); }
+void featureClearAll(void) {}
+void sensorsSet(uint32_t mask) { UNUSED(mask); }
+uint16_t packSensorStatus(void) { return 0; }
+bool isHardwareHealthy(void) { return true; }
+
+void readEEPROM(void) {}
+void writeEEPROM(void) {}
+void resetEEPROM(void) {}
+uint8_t getConfigProfile(void) { return 0; }
+void setConfigProfileAndWriteEEPROM(uint8_t profileIndex) { UNUSED(profileIndex); }
+uint8_t getConfigBatteryProfile(void) { return 0; }
+void setConfigBatteryProfileAndWriteEEPROM(uint8_t profileIndex) { UNUSED(profileIndex); }
+
+void initActiveBoxIds(void) {}
+const box_t *findBoxByActiveBoxId(uint8_t activeBoxId) { UNUSED(activeBoxId); return NULL; }
+const box_t *findBoxByPermanentId(uint8_t permanentId) { UNUSED(permanentId); return NULL; }
+void packBoxModeFlags(boxBitmask_t *mspBoxModeFlags) { UNUSED(mspBoxModeFlags); }
+bool serializeBoxNamesReply(sbuf_t *dst) { UNUSED(dst); return true; }
+void serializeBoxReply(sbuf_t *dst) { UNUSED(dst); }
+void updateUsedModeActivationConditionFlags(void) {}
+
+uint8_t accGetCalibrationAxisFlags(void) { return 0; }
+void accStartCalibration(void) {}
+int16_t gyroRateDps(int axis) { UNUSED(axis); return 0; }
+int32_t baroGetLatestAltitude(void) { return 0; }
+
+hardwareSensorStatus_e getHwGyroStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwAccelerometerStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwCompassStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwBarometerStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwGPSStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwRangefinderStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwPitotmeterStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwOpticalFlowStatus(void) { return HW_SENSOR_NONE; }
+
+int16_t getAmperage(void) { return 0; }
+uint16_t getBatteryVoltage(void) { return 0; }
+uint8_t getBatteryCellCount(void) { return 0; }
+uint32_t getBatteryRemainingCapacity(void) { return 0; }
+batteryState_e getBatteryState(void) { return BATTERY_NOT_PRESENT; }
+bool batteryWasFullWhenPluggedIn(void) { return false; }
+bool batteryUsesCapacityThresholds(void) { return false; }
+uint8_t calculateBatteryPercentage(void) { return 0; }
+int32_t getMAhDrawn(void) { return 0; }
+int32_t getMWhDrawn(void) { return 0; }
+int32_t getPower(void) { return 0; }
+
+float getFlightTime(void) { return 0; }
+int16_t getThrottlePercent(void) { return 0; }
+void mixerUpdateStateFlags(void) {}
+void loadCustomServoMixer(void) {}
+void servoComputeScalingFactors(uint8_t servoIndex) { UNUSED(servoIndex); }
+
+const pidBank_t *pidBank(void) { return &testPidProfile.bank_mc; }
+pidBank_t *pidBankMutable(void) { return &testPidProfile.bank_mc; }
+bool pidInitFilters(void) { return true; }
+void schedulePidGainsUpdate(void) {}
+int16_t getHeadingHoldTarget(void) { return 0; }
+uint32_t distanceToMissionEnd(void) { return 0; }
+void updateHeadingHoldTarget(int16_t heading) { UNUSED(heading); }
+
+float getEstimatedActualPosition(int axis) { UNUSED(axis); return 0; }
+float getEstimatedActualVelocity(int axis) { UNUSED(axis); return 0; }
+bool navigationIsControllingThrottle(void) { return false; }
+void navigationUsePIDs(void) {}
+int getWaypointCount(void) { return 0; }
+bool isWaypointListValid(void) { return false; }
+void getWaypoint(uint8_t wpNumber, navWaypoint_t *wpData) { UNUSED(wpNumber); memset(wpData, 0, sizeof(*wpData)); }
+void setWaypoint(uint8_t wpNumber, const navWaypoint_t *wpData) { UNUSED(wpNumber); UNUSED(wpData); }
+void onNewGPSData(void) {}
+
+uint16_t getRSSI(void) { return 0; }
+rssiSource_e getRSSISource(void) { return RSSI_SOURCE_NONE; }
+void setRSSIFromMSP(uint8_t newMspRssi) { UNUSED(newMspRssi); }
+void rxUpdateRSSISource(void) {}
+int16_t rxGetChannelValue(unsigned channelNumber) { UNUSED(channelNumber); return 1500; }
+timeDelta_t rxGetLatencyUs(rxLatencyStage_e stage) { UNUSED(stage); return 0; }
+timeDelta_t rxGetAverageLatencyUs(rxLatencyStage_e stage) { UNUSED(stage); return 0; }
+
+void getTaskInfo(cfTaskId_e taskId, cfTaskInfo_t *taskInfo) { UNUSED(taskId); memset(taskInfo, 0, sizeof(*taskInfo)); }
+void getTaskHistogramInfo(cfTaskId_e taskId, cfTaskHistogramInfo_t *histogramInfo)
+{
+    UNUSED(taskId);
+    memset(histogramInfo, 0, sizeof(*histogramInfo));
+}
+void schedulerResetTaskStatistics(cfTaskId_e taskId) { UNUSED(taskId); }
+
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function) { UNUSED(function); return NULL; }
+serialPortConfig_t *serialFindPortConfiguration(serialPortIdentifier_e identifier) { UNUSED(identifier); return NULL; }
+serialPortUsage_t *findSerialPortUsageByIdentifier(serialPortIdentifier_e identifier) { UNUSED(identifier); return NULL; }
+bool serialIsPortAvailable(serialPortIdentifier_e identifier) { UNUSED(identifier); return false; }
+void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *leftC, serialConsumer *rightC)
+{
+    UNUSED(left);
+    UNUSED(right);
+    UNUSED(leftC);
+    UNUSED(rightC);
+}
+
+bool setModeColor(ledModeIndex_e modeIndex, int modeColorIndex, int colorIndex)
+{
+    UNUSED(modeIndex);
+    UNUSED(modeColorIndex);
+    UNUSED(colorIndex);
+    return false;
+}
+void reevaluateLedConfig(void) {}
+
+vtxDevice_t *vtxCommonDevice(void) { return NULL; }
+bool vtxCommonDeviceIsReady(vtxDevice_t *vtxDevice) { UNUSED(vtxDevice); return false; }
+vtxDevType_e vtxCommonGetDeviceType(vtxDevice_t *vtxDevice) { UNUSED(vtxDevice); return VTXDEV_UNKNOWN; }
+bool vtxCommonGetPitMode(vtxDevice_t *vtxDevice, uint8_t *pOnOff) { UNUSED(vtxDevice); *pOnOff = 0; return false; }
+void vtxCommonSetPitMode(vtxDevice_t *vtxDevice, uint8_t onoff) { UNUSED(vtxDevice); UNUSED(onoff); }
+
+bool rtcGet(rtcTime_t *t) { UNUSED(t); return false; }
+bool rtcSet(rtcTime_t *t) { UNUSED(t); return false; }
+bool rtcGetDateTime(dateTime_t *dt) { UNUSED(dt); return false; }
+rtcTime_t rtcTimeMake(int32_t secs, uint16_t millis) { return ((rtcTime_t)secs) * 1000 + millis; }
+int32_t rtcTimeGetSeconds(rtcTime_t *t) { return *t / 1000; }
+uint16_t rtcTimeGetMillis(rtcTime_t *t) { return *t % 1000; }
+
+// No settings, the setting commands fail to find them
+const setting_t *settingFind(const char *name) { UNUSED(name); return NULL; }
+const setting_t *settingGet(unsigned index) { UNUSED(index); return NULL; }
+unsigned settingGetIndex(const setting_t *val) { UNUSED(val); return 0; }
+void settingGetName(const setting_t *val, char *buf) { UNUSED(val); buf[0] = '\0'; }
+size_t settingGetValueSize(const setting_t *val) { UNUSED(val); return 0; }
+pgn_t settingGetPgn(const setting_t *val) { UNUSED(val); return 0; }
+void *settingGetValuePointer(const setting_t *val) { UNUSED(val); return NULL; }
+setting_min_t settingGetMin(const setting_t *val) { UNUSED(val); return 0; }
+setting_max_t settingGetMax(const setting_t *val) { UNUSED(val); return 0; }
+const char *settingLookupValueName(const setting_t *val, unsigned v) { UNUSED(val); UNUSED(v); return NULL; }
+void settingSetString(const setting_t *val, const char *s, size_t size) { UNUSED(val); UNUSED(s); UNUSED(size); }
+bool settingsGetParameterGroupIndexes(pgn_t pg, uint16_t *start, uint16_t *end)
+{
+    UNUSED(pg);
+    UNUSED(start);
+    UNUSED(end);
+    return false;
+}
+
+}
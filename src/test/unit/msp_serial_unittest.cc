@@ -0,0 +1,585 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <utility>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/crc.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+    #include "drivers/system.h"
+    #include "drivers/time.h"
+
+    #include "fc/cli.h"
+
+    #include "io/serial.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_protocol.h"
+    #include "msp/msp_serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_CMD_SMALL      0x3000  // 6 bytes of data
+#define TEST_CMD_EMPTY      0x3001  // ACK without data
+#define TEST_CMD_ERROR      0x3002  // Always fails
+#define TEST_CMD_SILENT     0x3003  // Never replies
+#define TEST_CMD_LARGE      0x3004  // 100 bytes of data
+#define TEST_CMD_SET        0x3005  // Takes data, like MSP_HANDLER_IN
+#define TEST_CMD_REBOOT     0x3006  // Asks for a post process function
+#define TEST_CMD_HUGE       0x3007  // A whole reply buffer of data
+
+extern "C" {
+    int32_t debug[DEBUG32_VALUE_COUNT];
+    uint8_t debugMode;
+    bool cliMode = false;
+    serialConfig_t serialConfig_System;
+
+    void cliEnter(serialPort_t *serialPort) { UNUSED(serialPort); }
+    void systemResetToBootloader(void) {}
+    static timeMs_t testTimeMs;
+    timeMs_t millis(void) { return testTimeMs; }
+    const uint32_t baudRates[] = { 0 };
+
+    // The ports are handed to mspSerialProcessOnePort() directly
+    serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function) { UNUSED(function); return NULL; }
+    serialPortConfig_t *findNextSerialPortConfig(serialPortFunction_e function) { UNUSED(function); return NULL; }
+    serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function, serialReceiveCallbackPtr rxCallback,
+        void *rxCallbackData, uint32_t baudRate, portMode_t mode, portOptions_t options)
+    {
+        UNUSED(identifier); UNUSED(function); UNUSED(rxCallback); UNUSED(rxCallbackData); UNUSED(baudRate); UNUSED(mode); UNUSED(options);
+        return NULL;
+    }
+    void closeSerialPort(serialPort_t *serialPort) { UNUSED(serialPort); }
+    void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort) { UNUSED(serialPort); }
+}
+
+// Loopback stand-in for a UART: the test queues the request bytes on the
+// RX side and collects everything msp_serial.c writes on the TX side.
+static std::vector<uint8_t> loopbackRx;
+static size_t loopbackRxPos;
+static std::vector<uint8_t> loopbackTx;
+static uint32_t loopbackTxFree;
+static bool loopbackTxEmpty;
+
+static void loopbackWrite(serialPort_t *instance, uint8_t ch)
+{
+    UNUSED(instance);
+    loopbackTx.push_back(ch);
+}
+
+static uint32_t loopbackTotalRxWaiting(const serialPort_t *instance)
+{
+    UNUSED(instance);
+    return loopbackRx.size() - loopbackRxPos;
+}
+
+static uint32_t loopbackTotalTxFree(const serialPort_t *instance)
+{
+    UNUSED(instance);
+    return loopbackTxFree;
+}
+
+static uint8_t loopbackRead(serialPort_t *instance)
+{
+    UNUSED(instance);
+    return loopbackRx[loopbackRxPos++];
+}
+
+static bool loopbackIsTransmitBufferEmpty(const serialPort_t *instance)
+{
+    UNUSED(instance);
+    return loopbackTxEmpty;
+}
+
+static const struct serialPortVTable loopbackVTable = {
+    .serialWrite = loopbackWrite,
+    .serialTotalRxWaiting = loopbackTotalRxWaiting,
+    .serialTotalTxFree = loopbackTotalTxFree,
+    .serialRead = loopbackRead,
+    .serialSetBaudRate = NULL,
+    .isSerialTransmitBufferEmpty = loopbackIsTransmitBufferEmpty,
+    .setMode = NULL,
+    .writeBuf = NULL,
+    .isConnected = NULL,
+    .isIdle = NULL,
+    .beginWrite = NULL,
+    .endWrite = NULL,
+    .setRxFrameCallback = NULL,
+};
+
+static std::vector<uint16_t> processedCommands;
+static int postProcessCalls;
+
+static void testPostProcess(serialPort_t *port)
+{
+    UNUSED(port);
+    postProcessCalls++;
+}
+
+static mspResult_e testProcessCommand(mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    const uint16_t cmdMSP = cmd->cmd;
+    processedCommands.push_back(cmdMSP);
+    reply->cmd = cmd->cmd;
+
+    // Like mspFcProcessCommand(), the echo stands for a MSP_HANDLER_IN_OUT
+    // command
+    const bool isOut = cmdMSP >= TEST_CMD_SMALL && cmdMSP != TEST_CMD_SET && cmdMSP <= TEST_CMD_HUGE;
+    if ((cmd->flags & MSP_FLAG_OUT_ONLY) && !isOut) {
+        reply->result = MSP_RESULT_ERROR;
+        return MSP_RESULT_ERROR;
+    }
+
+    mspResult_e ret = MSP_RESULT_ACK;
+    switch (cmdMSP) {
+    case TEST_CMD_SMALL:
+        for (int i = 0; i < 6; i++) {
+            sbufWriteU8(&reply->buf, 0x10 + i);
+        }
+        break;
+    case TEST_CMD_EMPTY:
+        break;
+    case TEST_CMD_ERROR:
+        // Partial output must not leak into a MSP2_COMMON_MULTI reply
+        sbufWriteU32(&reply->buf, 0xdeadbeef);
+        ret = MSP_RESULT_ERROR;
+        break;
+    case TEST_CMD_SILENT:
+        ret = MSP_RESULT_NO_REPLY;
+        break;
+    case TEST_CMD_LARGE:
+        for (int i = 0; i < 100; i++) {
+            sbufWriteU8(&reply->buf, i);
+        }
+        break;
+    case TEST_CMD_SET:
+        break;
+    case TEST_CMD_REBOOT:
+        *mspPostProcessFn = testPostProcess;
+        break;
+    case TEST_CMD_HUGE:
+        EXPECT_GE(sbufBytesRemaining(&reply->buf), MSP_PORT_OUTBUF_SIZE);
+        sbufFill(&reply->buf, 0x55, MSP_PORT_OUTBUF_SIZE);
+        break;
+    default:
+        // Echo the payload
+        sbufWriteData(&reply->buf, sbufPtr(&cmd->buf), sbufBytesRemaining(&cmd->buf));
+        break;
+    }
+
+    reply->result = ret;
+    return ret;
+}
+
+typedef struct {
+    char direction;
+    uint16_t cmd;
+    std::vector<uint8_t> payload;
+} testFrame_t;
+
+class MspSerialTest : public ::testing::Test {
+protected:
+    serialPort_t serialPort;
+    mspPort_t mspPort;
+
+    void SetUp() override
+    {
+        memset(&serialPort, 0, sizeof(serialPort));
+        serialPort.vTable = &loopbackVTable;
+        resetMspPort(&mspPort, &serialPort);
+
+        loopbackRx.clear();
+        loopbackRxPos = 0;
+        loopbackTx.clear();
+        loopbackTxFree = 256;
+        loopbackTxEmpty = true;
+        processedCommands.clear();
+        postProcessCalls = 0;
+        testTimeMs = 0;
+    }
+
+    void request(uint16_t cmd, const std::vector<uint8_t> &payload)
+    {
+        const uint8_t hdr[] = { '$', 'X', '<', 0, (uint8_t)(cmd & 0xff), (uint8_t)(cmd >> 8),
+            (uint8_t)(payload.size() & 0xff), (uint8_t)(payload.size() >> 8) };
+
+        uint8_t crc = crc8_dvb_s2_update(0, &hdr[3], sizeof(hdr) - 3);
+        crc = crc8_dvb_s2_update(crc, payload.data(), payload.size());
+
+        loopbackRx.insert(loopbackRx.end(), hdr, hdr + sizeof(hdr));
+        loopbackRx.insert(loopbackRx.end(), payload.begin(), payload.end());
+        loopbackRx.push_back(crc);
+
+        mspSerialProcessOnePort(&mspPort, MSP_SKIP_NON_MSP_DATA, testProcessCommand);
+    }
+
+    void requestMulti(const std::vector<uint16_t> &cmds)
+    {
+        std::vector<uint8_t> payload;
+        for (uint16_t cmd : cmds) {
+            payload.push_back(cmd & 0xff);
+            payload.push_back(cmd >> 8);
+        }
+        request(MSP2_COMMON_MULTI, payload);
+    }
+
+    void subscribe(const std::vector<std::pair<uint16_t, uint8_t>> &subscriptions)
+    {
+        std::vector<uint8_t> payload;
+        for (const auto &subscription : subscriptions) {
+            payload.push_back(subscription.first & 0xff);
+            payload.push_back(subscription.first >> 8);
+            payload.push_back(subscription.second);
+        }
+        request(MSP2_COMMON_SUBSCRIBE, payload);
+    }
+
+    // Parse the MSPv2 frames sent back by msp_serial.c
+    std::vector<testFrame_t> responses(void)
+    {
+        std::vector<testFrame_t> frames;
+        size_t pos = 0;
+
+        while (pos + 9 <= loopbackTx.size()) {
+            testFrame_t frame;
+            const uint8_t *hdr = &loopbackTx[pos];
+
+            EXPECT_EQ('$', hdr[0]);
+            EXPECT_EQ('X', hdr[1]);
+            frame.direction = hdr[2];
+            frame.cmd = hdr[4] | (hdr[5] << 8);
+            const size_t size = hdr[6] | (hdr[7] << 8);
+            if (pos + 9 + size > loopbackTx.size()) {
+                break;
+            }
+            frame.payload.assign(hdr + 8, hdr + 8 + size);
+
+            const uint8_t crc = crc8_dvb_s2_update(0, &hdr[3], 5 + size);
+            EXPECT_EQ(crc, hdr[8 + size]);
+
+            frames.push_back(frame);
+            pos += 9 + size;
+        }
+        EXPECT_EQ(loopbackTx.size(), pos);
+
+        loopbackTx.clear();
+        return frames;
+    }
+
+    testFrame_t response(void)
+    {
+        std::vector<testFrame_t> frames = responses();
+        EXPECT_EQ(1U, frames.size());
+        return frames.empty() ? testFrame_t() : frames[0];
+    }
+
+    // A TASK_SERIAL run without incoming data
+    void idle(timeMs_t currentTimeMs)
+    {
+        testTimeMs = currentTimeMs;
+        mspSerialProcessOnePort(&mspPort, MSP_SKIP_NON_MSP_DATA, testProcessCommand);
+    }
+};
+
+typedef struct {
+    uint16_t cmd;
+    std::vector<uint8_t> data;
+} testMultiEntry_t;
+
+static std::vector<testMultiEntry_t> parseMultiEntries(const std::vector<uint8_t> &payload)
+{
+    std::vector<testMultiEntry_t> entries;
+    size_t pos = 0;
+
+    while (pos + 4 <= payload.size()) {
+        testMultiEntry_t entry;
+        entry.cmd = payload[pos] | (payload[pos + 1] << 8);
+        const size_t size = payload[pos + 2] | (payload[pos + 3] << 8);
+        pos += 4;
+        EXPECT_LE(pos + size, payload.size());
+        entry.data.assign(payload.begin() + pos, payload.begin() + pos + size);
+        pos += size;
+        entries.push_back(entry);
+    }
+    EXPECT_EQ(payload.size(), pos);
+
+    return entries;
+}
+
+TEST_F(MspSerialTest, SingleCommandIsNotAffected)
+{
+    request(0x3010, { 1, 2, 3 });
+
+    const testFrame_t frame = response();
+    EXPECT_EQ('>', frame.direction);
+    EXPECT_EQ(0x3010, frame.cmd);
+    EXPECT_EQ(std::vector<uint8_t>({ 1, 2, 3 }), frame.payload);
+    EXPECT_EQ(MSP_IDLE, mspPort.c_state);
+}
+
+TEST_F(MspSerialTest, MultiConcatenatesReplies)
+{
+    requestMulti({ TEST_CMD_SMALL, TEST_CMD_EMPTY, TEST_CMD_LARGE });
+
+    const testFrame_t frame = response();
+    EXPECT_EQ('>', frame.direction);
+    EXPECT_EQ(MSP2_COMMON_MULTI, frame.cmd);
+
+    const std::vector<testMultiEntry_t> entries = parseMultiEntries(frame.payload);
+    ASSERT_EQ(3U, entries.size());
+
+    EXPECT_EQ(TEST_CMD_SMALL, entries[0].cmd);
+    EXPECT_EQ(std::vector<uint8_t>({ 0x10, 0x11, 0x12, 0x13, 0x14, 0x15 }), entries[0].data);
+
+    EXPECT_EQ(TEST_CMD_EMPTY, entries[1].cmd);
+    EXPECT_TRUE(entries[1].data.empty());
+
+    EXPECT_EQ(TEST_CMD_LARGE, entries[2].cmd);
+    ASSERT_EQ(100U, entries[2].data.size());
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(i, entries[2].data[i]);
+    }
+
+    EXPECT_EQ(std::vector<uint16_t>({ TEST_CMD_SMALL, TEST_CMD_EMPTY, TEST_CMD_LARGE }), processedCommands);
+}
+
+TEST_F(MspSerialTest, MultiRunsOnlyOutCommands)
+{
+    // Commands taking data and the ones asking for a reboot and such must
+    // be requested on their own
+    requestMulti({ TEST_CMD_SET, 0x3010, TEST_CMD_SMALL, TEST_CMD_REBOOT, TEST_CMD_EMPTY });
+
+    const std::vector<testMultiEntry_t> entries = parseMultiEntries(response().payload);
+    ASSERT_EQ(2U, entries.size());
+    EXPECT_EQ(TEST_CMD_SMALL, entries[0].cmd);
+    EXPECT_EQ(TEST_CMD_EMPTY, entries[1].cmd);
+    EXPECT_EQ(0, postProcessCalls);
+
+    request(TEST_CMD_REBOOT, {});
+    EXPECT_EQ(TEST_CMD_REBOOT, response().cmd);
+    EXPECT_EQ(1, postProcessCalls);
+}
+
+TEST_F(MspSerialTest, MultiSkipsFailedCommands)
+{
+    requestMulti({ TEST_CMD_ERROR, TEST_CMD_SMALL, TEST_CMD_SILENT, TEST_CMD_SMALL });
+
+    const testFrame_t frame = response();
+    EXPECT_EQ('>', frame.direction);
+
+    const std::vector<testMultiEntry_t> entries = parseMultiEntries(frame.payload);
+    ASSERT_EQ(2U, entries.size());
+    EXPECT_EQ(TEST_CMD_SMALL, entries[0].cmd);
+    EXPECT_EQ(6U, entries[0].data.size());
+    EXPECT_EQ(TEST_CMD_SMALL, entries[1].cmd);
+    EXPECT_EQ(6U, entries[1].data.size());
+}
+
+TEST_F(MspSerialTest, MultiIsNotNested)
+{
+    requestMulti({ MSP2_COMMON_MULTI, TEST_CMD_EMPTY });
+
+    const std::vector<testMultiEntry_t> entries = parseMultiEntries(response().payload);
+    ASSERT_EQ(1U, entries.size());
+    EXPECT_EQ(TEST_CMD_EMPTY, entries[0].cmd);
+    EXPECT_EQ(std::vector<uint16_t>({ TEST_CMD_EMPTY }), processedCommands);
+}
+
+TEST_F(MspSerialTest, MultiEmptyRequest)
+{
+    requestMulti({});
+
+    const testFrame_t frame = response();
+    EXPECT_EQ('>', frame.direction);
+    EXPECT_EQ(MSP2_COMMON_MULTI, frame.cmd);
+    EXPECT_TRUE(frame.payload.empty());
+}
+
+TEST_F(MspSerialTest, MultiStopsWhenReplyIsFull)
+{
+    // Far more than a single reply frame can carry
+    const int requested = MSP_MULTI_REPLY_SIZE / 100 + 8;
+    requestMulti(std::vector<uint16_t>(requested, TEST_CMD_LARGE));
+
+    const testFrame_t frame = response();
+    EXPECT_EQ('>', frame.direction);
+    EXPECT_LE(frame.payload.size(), (size_t)MSP_MULTI_REPLY_SIZE);
+
+    // The reply holds a prefix of the request, the client asks for the
+    // rest again. The command which didn't fit was run for nothing.
+    const std::vector<testMultiEntry_t> entries = parseMultiEntries(frame.payload);
+    EXPECT_EQ((size_t)MSP_MULTI_REPLY_SIZE / 104, entries.size());
+    EXPECT_EQ(entries.size() + 1, processedCommands.size());
+    for (const testMultiEntry_t &entry : entries) {
+        EXPECT_EQ(TEST_CMD_LARGE, entry.cmd);
+        EXPECT_EQ(100U, entry.data.size());
+    }
+}
+
+TEST_F(MspSerialTest, MultiDropsRepliesLargerThanTheFrame)
+{
+    // A reply which can't fit in a frame on its own doesn't stop the
+    // batch, or asking for the rest would never go past it
+    requestMulti({ TEST_CMD_SMALL, TEST_CMD_HUGE, TEST_CMD_SMALL });
+
+    const std::vector<testMultiEntry_t> entries = parseMultiEntries(response().payload);
+    ASSERT_EQ(2U, entries.size());
+    EXPECT_EQ(TEST_CMD_SMALL, entries[0].cmd);
+    EXPECT_EQ(TEST_CMD_SMALL, entries[1].cmd);
+    EXPECT_EQ(std::vector<uint16_t>({ TEST_CMD_SMALL, TEST_CMD_HUGE, TEST_CMD_SMALL }), processedCommands);
+}
+
+TEST_F(MspSerialTest, SubscribeReturnsAcceptedCount)
+{
+    // Zero rates, nested batch/subscription commands and commands which
+    // don't just return data are ignored
+    subscribe({ { TEST_CMD_SMALL, 10 }, { TEST_CMD_EMPTY, 0 }, { MSP2_COMMON_MULTI, 10 }, { TEST_CMD_SET, 10 },
+        { 0x3010, 10 }, { TEST_CMD_REBOOT, 10 }, { TEST_CMD_SILENT, 10 }, { TEST_CMD_LARGE, 50 } });
+
+    // The reply comes first, followed by the first round of pushes
+    std::vector<testFrame_t> frames = responses();
+    ASSERT_EQ(3U, frames.size());
+    EXPECT_EQ('>', frames[0].direction);
+    EXPECT_EQ(MSP2_COMMON_SUBSCRIBE, frames[0].cmd);
+    EXPECT_EQ(std::vector<uint8_t>({ 2 }), frames[0].payload);
+    EXPECT_EQ(TEST_CMD_SMALL, frames[1].cmd);
+    EXPECT_EQ(TEST_CMD_LARGE, frames[2].cmd);
+    EXPECT_EQ(0, postProcessCalls);
+
+    std::vector<std::pair<uint16_t, uint8_t>> tooMany(MSP_MAX_SUBSCRIPTIONS + 3, std::make_pair(TEST_CMD_SMALL, 1));
+    subscribe(tooMany);
+    frames = responses();
+    ASSERT_EQ(1U + MSP_MAX_SUBSCRIPTIONS, frames.size());
+    EXPECT_EQ(std::vector<uint8_t>({ MSP_MAX_SUBSCRIPTIONS }), frames[0].payload);
+}
+
+TEST_F(MspSerialTest, SubscriptionsArePushedAtTheirRate)
+{
+    int small = 0;
+    int large = 0;
+
+    subscribe({ { TEST_CMD_SMALL, 10 }, { TEST_CMD_LARGE, 50 }, { TEST_CMD_SILENT, 100 } });
+
+    // TASK_SERIAL runs at 100Hz
+    for (timeMs_t t = 0; t < 1000; t += 10) {
+        if (t > 0) {
+            idle(t);
+        }
+        for (const testFrame_t &frame : responses()) {
+            EXPECT_EQ('>', frame.direction);
+            if (frame.cmd == TEST_CMD_SMALL) {
+                EXPECT_EQ(6U, frame.payload.size());
+                small++;
+            } else if (frame.cmd == TEST_CMD_LARGE) {
+                EXPECT_EQ(100U, frame.payload.size());
+                large++;
+            } else if (frame.cmd != MSP2_COMMON_SUBSCRIBE) {
+                ADD_FAILURE() << "Unexpected push of command " << frame.cmd;
+            }
+        }
+    }
+
+    EXPECT_EQ(10, small);
+    EXPECT_EQ(50, large);
+}
+
+TEST_F(MspSerialTest, SubscriptionsDoNotBurstAfterAStall)
+{
+    subscribe({ { TEST_CMD_SMALL, 50 } });
+    EXPECT_EQ(2U, responses().size());
+
+    // The task didn't run for a while, only the latest push is sent
+    idle(500);
+    EXPECT_EQ(1U, responses().size());
+    idle(510);
+    EXPECT_EQ(0U, responses().size());
+    idle(520);
+    EXPECT_EQ(1U, responses().size());
+}
+
+TEST_F(MspSerialTest, SubscriptionsWaitForTxSpace)
+{
+    // Room for the reply and the small push only, the large one waits for
+    // the TX buffer to drain
+    loopbackTxFree = 40;
+    loopbackTxEmpty = false;
+    subscribe({ { TEST_CMD_SMALL, 10 }, { TEST_CMD_LARGE, 10 } });
+    std::vector<testFrame_t> frames = responses();
+    ASSERT_EQ(2U, frames.size());
+    EXPECT_EQ(MSP2_COMMON_SUBSCRIBE, frames[0].cmd);
+    EXPECT_EQ(TEST_CMD_SMALL, frames[1].cmd);
+
+    loopbackTxFree = 0;
+    idle(10);
+    EXPECT_EQ(0U, responses().size());
+
+    // Resumes with the one left behind
+    loopbackTxFree = 256;
+    idle(20);
+    frames = responses();
+    ASSERT_EQ(1U, frames.size());
+    EXPECT_EQ(TEST_CMD_LARGE, frames[0].cmd);
+
+    // The late one stays on its original schedule
+    idle(100);
+    EXPECT_EQ(2U, responses().size());
+}
+
+TEST_F(MspSerialTest, OversizedSubscriptionIsDropped)
+{
+    // Even an empty TX buffer can't take the large reply
+    loopbackTxFree = 40;
+    subscribe({ { TEST_CMD_LARGE, 10 }, { TEST_CMD_SMALL, 10 } });
+    std::vector<testFrame_t> frames = responses();
+    ASSERT_EQ(2U, frames.size());
+    EXPECT_EQ(MSP2_COMMON_SUBSCRIBE, frames[0].cmd);
+    EXPECT_EQ(TEST_CMD_SMALL, frames[1].cmd);
+}
+
+TEST_F(MspSerialTest, EmptySubscribeStopsPushes)
+{
+    subscribe({ { TEST_CMD_SMALL, 100 } });
+    EXPECT_EQ(2U, responses().size());
+
+    testTimeMs = 10;
+    subscribe({});
+    EXPECT_EQ(std::vector<uint8_t>({ 0 }), response().payload);
+
+    idle(100);
+    EXPECT_EQ(0U, responses().size());
+}
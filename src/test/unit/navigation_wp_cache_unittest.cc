@@ -0,0 +1,395 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Checks the mission waypoints cached in local coordinates against a fresh
+// conversion of waypointList, after the edits that have to rebuild them.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/fp_pid.h"
+    #include "common/utils.h"
+
+    #include "fc/config.h"
+    #include "fc/fc_core.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+
+    #include "io/beeper.h"
+    #include "io/gps.h"
+
+    #include "navigation/navigation.h"
+    // C11 only, used by navigation_private.h
+    #define _Static_assert static_assert
+    #include "navigation/navigation_private.h"
+
+    #include "rx/rx.h"
+
+    void mapWaypointToLocalPosition(fpVector3_t * localPos, const navWaypoint_t * waypoint, geoAltitudeConversionMode_e altConv);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static navWaypoint_t makeWaypoint(uint8_t action, int32_t lat, int32_t lon, int32_t alt)
+{
+    navWaypoint_t wp;
+    memset(&wp, 0, sizeof(wp));
+    wp.action = action;
+    wp.lat = lat;
+    wp.lon = lon;
+    wp.alt = alt;
+    return wp;
+}
+
+static void setOrigin(int32_t lat, int32_t lon, int32_t alt)
+{
+    gpsOrigin_t *origin = &posControl.gpsOrigin;
+    origin->valid = true;
+    origin->lat = lat;
+    origin->lon = lon;
+    origin->alt = alt;
+    origin->scale = cosf((lat / 10000000.0f) * 0.0174532925f);
+}
+
+class NavWpCacheTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        memset(&posControl, 0, sizeof(posControl));
+        memset(&GPS_home, 0, sizeof(GPS_home));
+        armingFlags = 0;
+        flightModeFlags = 0;
+        setOrigin(473000000, 85000000, 40000);
+        GPS_home.lat = 473000100;
+        GPS_home.lon = 85000200;
+    }
+
+    // Uploaded like MSP_SET_WP does it, one waypoint at a time
+    void upload(const std::initializer_list<navWaypoint_t> &mission)
+    {
+        uint8_t wpNumber = 1;
+        for (navWaypoint_t wp : mission) {
+            wp.flag = wpNumber == mission.size() ? NAV_WP_FLAG_LAST : 0;
+            setWaypoint(wpNumber++, &wp);
+        }
+        ASSERT_TRUE(isWaypointListValid());
+    }
+
+    // Same conversion as the waypoint FSM used before the cache
+    void expectEntries(void)
+    {
+        for (int ii = 0; ii < posControl.waypointCount; ii++) {
+            const navWaypoint_t *wp = &posControl.waypointList[ii];
+            fpVector3_t expected = { .v = { 0.0f, 0.0f, 0.0f } };
+
+            if (wp->action == NAV_WP_ACTION_SET_POI) {
+                mapWaypointToLocalPosition(&expected, wp, GEO_ALT_RELATIVE);
+            } else if (wp->action != NAV_WP_ACTION_SET_HEAD && wp->action != NAV_WP_ACTION_JUMP) {
+                mapWaypointToLocalPosition(&expected, wp, waypointMissionAltConvMode((geoAltitudeDatumFlag_e)wp->p3));
+            }
+
+            const fpVector3_t *pos = &getWaypointCacheEntry(ii)->pos;
+            EXPECT_FLOAT_EQ(expected.x, pos->x) << "waypoint " << ii;
+            EXPECT_FLOAT_EQ(expected.y, pos->y) << "waypoint " << ii;
+            EXPECT_FLOAT_EQ(expected.z, pos->z) << "waypoint " << ii;
+        }
+    }
+
+    // In whole cm, like the firmware sums them
+    float legLength(int from, int to)
+    {
+        fpVector3_t a, b;
+        mapWaypointToLocalPosition(&a, &posControl.waypointList[from], GEO_ALT_RELATIVE);
+        mapWaypointToLocalPosition(&b, &posControl.waypointList[to], GEO_ALT_RELATIVE);
+        return floorf(sqrtf(sq(b.x - a.x) + sq(b.y - a.y)));
+    }
+};
+
+TEST_F(NavWpCacheTest, EntriesMatchTheWaypointList)
+{
+    navWaypoint_t msl = makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473001000, 85001000, 12000);
+    msl.p3 = NAV_WP_MSL_DATUM;
+
+    upload({
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 0, 0, 5000),       // at home
+        makeWaypoint(NAV_WP_ACTION_SET_POI, 473002000, 84999000, 3000),
+        msl,
+        makeWaypoint(NAV_WP_ACTION_SET_HEAD, 0, 0, 0),
+        makeWaypoint(NAV_WP_ACTION_HOLD_TIME, 472999000, 85002000, 7000),
+        makeWaypoint(NAV_WP_ACTION_LAND, 472998000, 85000000, 0),
+    });
+
+    expectEntries();
+    EXPECT_FLOAT_EQ(12000.0f - 40000.0f, getWaypointCacheEntry(2)->pos.z);
+}
+
+TEST_F(NavWpCacheTest, MissionEditRebuildsTheEntries)
+{
+    upload({
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473001000, 85001000, 5000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473002000, 85002000, 5000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473003000, 85003000, 5000),
+    });
+    expectEntries();
+    const fpVector3_t before = getWaypointCacheEntry(1)->pos;
+
+    // Same size, so only the invalidation tells the cache about it
+    upload({
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473001000, 85001000, 5000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 472990000, 84990000, 8000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473003000, 85003000, 5000),
+    });
+    expectEntries();
+    EXPECT_NE(before.x, getWaypointCacheEntry(1)->pos.x);
+
+    resetWaypointList();
+    upload({
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473005000, 85005000, 5000),
+    });
+    expectEntries();
+    EXPECT_FLOAT_EQ(0.0f, getWaypointCacheEntry(0)->remainingDistance);
+}
+
+TEST_F(NavWpCacheTest, OriginChangeRebuildsTheEntries)
+{
+    upload({
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473001000, 85001000, 5000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473002000, 85002000, 5000),
+    });
+    expectEntries();
+    const fpVector3_t before = getWaypointCacheEntry(0)->pos;
+
+    setOrigin(473000500, 85000500, 41000);
+    expectEntries();
+    EXPECT_NE(before.x, getWaypointCacheEntry(0)->pos.x);
+    EXPECT_NE(before.y, getWaypointCacheEntry(0)->pos.y);
+
+    // Origin lost, then set again at the old place
+    posControl.gpsOrigin.valid = false;
+    expectEntries();
+    EXPECT_FLOAT_EQ(0.0f, getWaypointCacheEntry(0)->pos.x);
+
+    setOrigin(473000000, 85000000, 40000);
+    expectEntries();
+    EXPECT_FLOAT_EQ(before.x, getWaypointCacheEntry(0)->pos.x);
+}
+
+TEST_F(NavWpCacheTest, MultiMissionSwitchRebuildsTheEntries)
+{
+    const navWaypoint_t file[] = {
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473001000, 85001000, 5000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473002000, 85002000, 5000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 472990000, 84990000, 6000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 472980000, 84980000, 6000),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 472970000, 84970000, 6000),
+        makeWaypoint(NAV_WP_ACTION_RTH, 0, 0, 0),
+    };
+    for (unsigned ii = 0; ii < ARRAYLEN(file); ii++) {
+        *nonVolatileWaypointListMutable(ii) = file[ii];
+    }
+    // Two missions, 2 and 3 waypoints, then the end of file marker
+    nonVolatileWaypointListMutable(1)->flag = NAV_WP_FLAG_LAST;
+    nonVolatileWaypointListMutable(4)->flag = NAV_WP_FLAG_LAST;
+    nonVolatileWaypointListMutable(5)->flag = NAV_WP_FLAG_LAST;
+
+    navConfigMutable()->general.waypoint_multi_mission_index = 1;
+    ASSERT_TRUE(loadNonVolatileWaypointList(false));
+    ASSERT_EQ(2, posControl.multiMissionCount);
+    expectEntries();
+    EXPECT_NEAR(calculateDistanceToDestination(&getWaypointCacheEntry(0)->pos), distanceToFirstWP(), 1);
+
+    // Stick selection, then the load stick command
+    selectMultiMissionIndex(1);
+    ASSERT_TRUE(loadNonVolatileWaypointList(false));
+    ASSERT_EQ(2, posControl.loadedMultiMissionStartWP);
+    expectEntries();
+    EXPECT_NEAR(calculateDistanceToDestination(&getWaypointCacheEntry(2)->pos), distanceToFirstWP(), 1);
+
+    // The selected mission is moved to the start of waypointList on arming
+    setMultiMissionOnArm();
+    ASSERT_EQ(3, posControl.waypointCount);
+    expectEntries();
+    EXPECT_NEAR(legLength(0, 1) + legLength(1, 2), getWaypointCacheEntry(0)->remainingDistance, 2.0f);
+    EXPECT_FLOAT_EQ(0.0f, getWaypointCacheEntry(2)->remainingDistance);
+}
+
+TEST_F(NavWpCacheTest, RemainingDistanceSkipsNonGeoWaypoints)
+{
+    navWaypoint_t jump = makeWaypoint(NAV_WP_ACTION_JUMP, 0, 0, 0);
+    jump.p1 = 1;    // WP #1, stored as index 0
+    jump.p2 = 2;
+
+    upload({
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473001000, 85001000, 5000),
+        makeWaypoint(NAV_WP_ACTION_SET_POI, 473100000, 85100000, 0),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473004000, 85002000, 5000),
+        makeWaypoint(NAV_WP_ACTION_SET_HEAD, 0, 0, 0),
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473006000, 84998000, 5000),
+        jump,
+        makeWaypoint(NAV_WP_ACTION_WAYPOINT, 473003000, 84995000, 5000),
+    });
+    expectEntries();
+
+    // The POI isn't flown to, and the jump isn't followed
+    const float leg2 = legLength(0, 2);
+    const float leg4 = legLength(2, 4);
+    const float leg6 = legLength(4, 6);
+    const float expected[] = {
+        leg2 + leg4 + leg6,
+        leg2 + leg4 + leg6,
+        leg4 + leg6,
+        leg4 + leg6,
+        leg6,
+        leg6,
+        0.0f,
+    };
+    for (unsigned ii = 0; ii < ARRAYLEN(expected); ii++) {
+        EXPECT_NEAR(expected[ii], getWaypointCacheEntry(ii)->remainingDistance, 3.0f) << "waypoint " << ii;
+    }
+
+    // Reported to the GCS while flying the mission
+    posControl.navState = NAV_STATE_WAYPOINT_IN_PROGRESS;
+    posControl.activeWaypointIndex = 2;
+    posControl.wpDistance = 500;
+    EXPECT_NEAR(500 + leg4 + leg6, distanceToMissionEnd(), 3);
+
+    posControl.navState = NAV_STATE_IDLE;
+    EXPECT_EQ(0u, distanceToMissionEnd());
+}
+
+// STUBS
+
+extern "C" {
+    int32_t debug[DEBUG32_VALUE_COUNT];
+    uint8_t debugMode;
+
+    uint32_t armingFlags;
+    uint32_t flightModeFlags;
+    uint32_t stateFlags;
+
+    gpsSolutionData_t gpsSol;
+    int16_t rcCommand[4];
+
+    mixerConfig_t mixerConfig_System;
+    pidProfile_t *pidProfile_ProfileCurrent;
+    positionEstimationConfig_t positionEstimationConfig_System;
+    rcControlsConfig_t rcControlsConfig_System;
+    rxConfig_t rxConfig_System;
+
+    timeMs_t millis(void) { return 0; }
+    timeUs_t micros(void) { return 0; }
+
+    uint32_t enableFlightMode(flightModeFlags_e mask) { flightModeFlags |= mask; return flightModeFlags; }
+    uint32_t disableFlightMode(flightModeFlags_e mask) { flightModeFlags &= ~mask; return flightModeFlags; }
+
+    bool feature(uint32_t mask) { UNUSED(mask); return false; }
+    bool IS_RC_MODE_ACTIVE(boxId_e boxId) { UNUSED(boxId); return false; }
+    bool isUsingNavigationModes(void) { return false; }
+    bool checkStickPosition(stickPositions_e stickPos) { UNUSED(stickPos); return false; }
+    bool isRollPitchStickDeflected(void) { return false; }
+    throttleStatus_e calculateThrottleStatus(throttleStatusType_e type) { UNUSED(type); return THROTTLE_LOW; }
+    int16_t rxGetChannelValue(unsigned channelNumber) { UNUSED(channelNumber); return 1500; }
+    float getFlightTime(void) { return 0; }
+    void disarm(disarmReason_t disarmReason) { UNUSED(disarmReason); }
+    void beeper(beeperMode_e mode) { UNUSED(mode); }
+    void saveConfigAndNotify(void) {}
+    bool failsafeBypassNavigation(void) { return false; }
+    bool failsafeMayRequireNavigationMode(void) { return false; }
+    motorStatus_e getMotorStatus(void) { return MOTOR_STOPPED_USER; }
+    float calculateCosTiltAngle(void) { return 1.0f; }
+    void pidResetErrorAccumulators(void) {}
+
+    void navPidInit(pidController_t *pid, float _kP, float _kI, float _kD, float _kFF, float _dTermLpfHz, float _errorLpfHz)
+    {
+        UNUSED(pid);
+        UNUSED(_kP);
+        UNUSED(_kI);
+        UNUSED(_kD);
+        UNUSED(_kFF);
+        UNUSED(_dTermLpfHz);
+        UNUSED(_errorLpfHz);
+    }
+
+    void setupMulticopterAltitudeController(void) {}
+    void resetMulticopterAltitudeController(void) {}
+    void resetMulticopterPositionController(void) {}
+    void resetMulticopterHeadingController(void) {}
+    void resetMulticopterBrakingMode(void) {}
+    void resetMulticopterLandingDetector(void) {}
+    bool adjustMulticopterAltitudeFromRCInput(void) { return false; }
+    bool adjustMulticopterHeadingFromRCInput(void) { return false; }
+    bool adjustMulticopterPositionFromRCInput(int16_t rcPitchAdjustment, int16_t rcRollAdjustment)
+    {
+        UNUSED(rcPitchAdjustment);
+        UNUSED(rcRollAdjustment);
+        return false;
+    }
+    bool isMulticopterLandingDetected(void) { return false; }
+    void calculateMulticopterInitialHoldPosition(fpVector3_t * pos) { UNUSED(pos); }
+    void applyMulticopterNavigationController(navigationFSMStateFlags_t navStateFlags, timeUs_t currentTimeUs)
+    {
+        UNUSED(navStateFlags);
+        UNUSED(currentTimeUs);
+    }
+
+    void setupFixedWingAltitudeController(void) {}
+    void resetFixedWingAltitudeController(void) {}
+    void resetFixedWingPositionController(void) {}
+    void resetFixedWingHeadingController(void) {}
+    void resetFixedWingLandingDetector(void) {}
+    bool adjustFixedWingAltitudeFromRCInput(void) { return false; }
+    bool adjustFixedWingHeadingFromRCInput(void) { return false; }
+    bool adjustFixedWingPositionFromRCInput(void) { return false; }
+    bool isFixedWingLandingDetected(void) { return false; }
+    void calculateFixedWingInitialHoldPosition(fpVector3_t * pos) { UNUSED(pos); }
+    void applyFixedWingNavigationController(navigationFSMStateFlags_t navStateFlags, timeUs_t currentTimeUs)
+    {
+        UNUSED(navStateFlags);
+        UNUSED(currentTimeUs);
+    }
+    void resetFixedWingLaunchController(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); }
+    void enableFixedWingLaunchController(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); }
+    void abortFixedWingLaunch(void) {}
+    uint8_t fixedWingLaunchStatus(void) { return 0; }
+
+    void applyRoverBoatNavigationController(navigationFSMStateFlags_t navStateFlags, timeUs_t currentTimeUs)
+    {
+        UNUSED(navStateFlags);
+        UNUSED(currentTimeUs);
+    }
+}
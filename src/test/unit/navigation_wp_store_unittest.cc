@@ -0,0 +1,269 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Stores missions through the waypoint store into a NOR flash stand-in,
+// which only lets programming clear bits and never crosses a page.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/flash.h"
+
+    #include "navigation/navigation.h"
+    #include "navigation/navigation_wp_store.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define PAGE_SIZE           256
+#define PAGES_PER_SECTOR    16
+#define SECTOR_SIZE         (PAGE_SIZE * PAGES_PER_SECTOR)
+#define SECTORS             ((NAV_WP_STORE_SIZE + SECTOR_SIZE - 1) / SECTOR_SIZE + 1)
+
+static uint8_t flashMemory[SECTORS * SECTOR_SIZE];
+static bool flashPresent;
+static bool flashProgramFails;
+static unsigned flashErases;
+
+static const flashGeometry_t flashGeometry = {
+    .sectors = SECTORS,
+    .pageSize = PAGE_SIZE,
+    .sectorSize = SECTOR_SIZE,
+    .totalSize = SECTORS * SECTOR_SIZE,
+    .pagesPerSector = PAGES_PER_SECTOR,
+};
+
+// Like drivers/flash.c, the partition goes at the end of the flash
+static flashPartition_t waypointPartition = {
+    .type = FLASH_PARTITION_TYPE_WAYPOINTS,
+    .startSector = 1,
+    .endSector = SECTORS - 1,
+};
+
+extern "C" {
+    flashPartition_t *flashPartitionFindByType(flashPartitionType_e type)
+    {
+        return flashPresent && type == FLASH_PARTITION_TYPE_WAYPOINTS ? &waypointPartition : NULL;
+    }
+
+    const flashGeometry_t *flashGetGeometry(void) { return &flashGeometry; }
+    bool flashIsReady(void) { return flashPresent; }
+
+    void flashEraseSector(uint32_t address)
+    {
+        EXPECT_EQ(0u, address % SECTOR_SIZE);
+        EXPECT_GE(address / SECTOR_SIZE, waypointPartition.startSector) << "erase outside the partition";
+        EXPECT_LE(address / SECTOR_SIZE, waypointPartition.endSector) << "erase outside the partition";
+        memset(&flashMemory[address], 0xFF, SECTOR_SIZE);
+        flashErases++;
+    }
+
+    uint32_t flashPageProgram(uint32_t address, const uint8_t *data, int length)
+    {
+        EXPECT_EQ(address / PAGE_SIZE, (address + length - 1) / PAGE_SIZE) << "program crosses a page at " << address;
+        if (flashProgramFails) {
+            return address;
+        }
+        for (int ii = 0; ii < length; ii++) {
+            flashMemory[address + ii] &= data[ii];
+        }
+        return address + length;
+    }
+
+    int flashReadBytes(uint32_t address, uint8_t *buffer, int length)
+    {
+        memcpy(buffer, &flashMemory[address], length);
+        return length;
+    }
+}
+
+static navWaypoint_t makeWaypoint(int index, bool last)
+{
+    navWaypoint_t wp;
+    memset(&wp, 0, sizeof(wp));
+    wp.action = NAV_WP_ACTION_WAYPOINT;
+    wp.lat = 450000000 + index;
+    wp.lon = 90000000 - index;
+    wp.alt = 1000 + index;
+    wp.p1 = index;
+    wp.flag = last ? NAV_WP_FLAG_LAST : 0;
+    return wp;
+}
+
+class NavWpStoreTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        memset(flashMemory, 0xFF, sizeof(flashMemory));
+        flashPresent = true;
+        flashProgramFails = false;
+
+        // The store caches the count, starting an upload drops the
+        // mission left behind by the previous test
+        const navWaypoint_t wp = makeWaypoint(0, false);
+        navWpStoreWrite(0, &wp);
+        flashErases = 0;
+    }
+
+    void writeMission(int count)
+    {
+        for (int ii = 0; ii < count; ii++) {
+            const navWaypoint_t wp = makeWaypoint(ii, ii == count - 1);
+            ASSERT_TRUE(navWpStoreWrite(ii, &wp)) << "waypoint " << ii;
+        }
+    }
+
+    void expectWaypoint(int index, const navWaypoint_t &wp)
+    {
+        const navWaypoint_t expected = makeWaypoint(index, wp.flag == NAV_WP_FLAG_LAST);
+        EXPECT_EQ(0, memcmp(&expected, &wp, sizeof(wp))) << "waypoint " << index;
+    }
+};
+
+TEST_F(NavWpStoreTest, NoFlash)
+{
+    flashPresent = false;
+    EXPECT_FALSE(navWpStoreIsAvailable());
+    EXPECT_FALSE(navWpStoreIsReady());
+    EXPECT_EQ(0, navWpStoreGetCount());
+
+    const navWaypoint_t wp = makeWaypoint(0, true);
+    EXPECT_FALSE(navWpStoreWrite(0, &wp));
+}
+
+TEST_F(NavWpStoreTest, IncompleteMissionIsNotStored)
+{
+    writeMission(1);
+    EXPECT_EQ(1, navWpStoreGetCount());
+
+    // Starting a new mission drops the previous one
+    const navWaypoint_t wp = makeWaypoint(0, false);
+    ASSERT_TRUE(navWpStoreWrite(0, &wp));
+    EXPECT_EQ(0, navWpStoreGetCount());
+    EXPECT_EQ(2u, flashErases);
+
+    navWaypoint_t read;
+    EXPECT_FALSE(navWpStoreRead(0, &read, 1));
+}
+
+TEST_F(NavWpStoreTest, LongMission)
+{
+    // Leftovers of an older mission, every sector has to be erased before
+    // it's programmed
+    memset(flashMemory, 0, sizeof(flashMemory));
+
+    const int count = NAV_FLASH_MAX_WAYPOINTS;
+    writeMission(count);
+    EXPECT_EQ(count, navWpStoreGetCount());
+    const flashPartition_t *partition = &waypointPartition;
+    EXPECT_EQ((unsigned)FLASH_PARTITION_SECTOR_COUNT(partition), flashErases);
+
+    navWaypoint_t wps[8];
+    for (int ii = 0; ii < count; ii += ARRAYLEN(wps)) {
+        const int chunk = MIN((int)ARRAYLEN(wps), count - ii);
+        ASSERT_TRUE(navWpStoreRead(ii, wps, chunk));
+        for (int jj = 0; jj < chunk; jj++) {
+            expectWaypoint(ii + jj, wps[jj]);
+        }
+    }
+    EXPECT_EQ(NAV_WP_FLAG_LAST, wps[(count - 1) % ARRAYLEN(wps)].flag);
+
+    // Past the end of the mission
+    EXPECT_FALSE(navWpStoreRead(count - 1, wps, 2));
+    EXPECT_FALSE(navWpStoreRead(count, wps, 1));
+
+    // No room for one more
+    const navWaypoint_t wp = makeWaypoint(count, true);
+    EXPECT_FALSE(navWpStoreWrite(count, &wp));
+}
+
+TEST_F(NavWpStoreTest, WritesMustBeInOrder)
+{
+    navWaypoint_t wp = makeWaypoint(0, false);
+    ASSERT_TRUE(navWpStoreWrite(0, &wp));
+    wp = makeWaypoint(2, true);
+    EXPECT_FALSE(navWpStoreWrite(2, &wp));
+    EXPECT_EQ(0, navWpStoreGetCount());
+
+    // Repeating a waypoint would program over it
+    wp = makeWaypoint(1, false);
+    ASSERT_TRUE(navWpStoreWrite(1, &wp));
+    EXPECT_FALSE(navWpStoreWrite(1, &wp));
+
+    wp = makeWaypoint(2, true);
+    EXPECT_TRUE(navWpStoreWrite(2, &wp));
+    EXPECT_EQ(3, navWpStoreGetCount());
+}
+
+TEST_F(NavWpStoreTest, ProgramFailureRestartsTheUpload)
+{
+    navWaypoint_t wp = makeWaypoint(0, false);
+    ASSERT_TRUE(navWpStoreWrite(0, &wp));
+
+    flashProgramFails = true;
+    wp = makeWaypoint(1, true);
+    EXPECT_FALSE(navWpStoreWrite(1, &wp));
+    EXPECT_EQ(0, navWpStoreGetCount());
+
+    flashProgramFails = false;
+    EXPECT_FALSE(navWpStoreWrite(1, &wp));
+    writeMission(2);
+    EXPECT_EQ(2, navWpStoreGetCount());
+}
+
+TEST_F(NavWpStoreTest, ShortMissionErasesOneSector)
+{
+    writeMission(NAV_MAX_WAYPOINTS);
+    EXPECT_EQ(NAV_MAX_WAYPOINTS, navWpStoreGetCount());
+    EXPECT_EQ(1u, flashErases);
+}
+
+TEST_F(NavWpStoreTest, InvalidateDropsTheMission)
+{
+    writeMission(3);
+    EXPECT_EQ(3, navWpStoreGetCount());
+
+    navWpStoreInvalidate();
+    EXPECT_EQ(0, navWpStoreGetCount());
+    EXPECT_EQ(1u, flashErases);
+
+    // Also stops an upload in progress
+    navWaypoint_t wp = makeWaypoint(0, false);
+    ASSERT_TRUE(navWpStoreWrite(0, &wp));
+    navWpStoreInvalidate();
+    wp = makeWaypoint(1, true);
+    EXPECT_FALSE(navWpStoreWrite(1, &wp));
+    EXPECT_EQ(0, navWpStoreGetCount());
+
+    writeMission(2);
+    EXPECT_EQ(2, navWpStoreGetCount());
+}
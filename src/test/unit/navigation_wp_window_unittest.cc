@@ -0,0 +1,392 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Flies paged flash missions through the waypoint window. The store is
+// replaced by a plain array, so the checks are on which part of the mission
+// is in waypointList and how much is read from flash at a time.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "navigation/navigation.h"
+    // C11 only, used by navigation_private.h
+    #define _Static_assert static_assert
+    #include "navigation/navigation_private.h"
+    #include "navigation/navigation_wp_store.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define READ_CHUNK      8   // NAV_WP_WINDOW_READ_CHUNK
+#define FILL_UPDATES    (NAV_MAX_WAYPOINTS / READ_CHUNK + 1)
+#define MISSION_SIZE    (NAV_MAX_WAYPOINTS * 5)
+
+static std::vector<navWaypoint_t> storedMission;
+static std::vector<int> reads;
+static bool storeReady;
+static bool storeFails;
+static int cacheInvalidations;
+static timeMs_t testTimeMs;
+
+extern "C" {
+    navigationPosControl_t posControl;
+    uint32_t armingFlags;
+
+    timeMs_t millis(void) { return testTimeMs; }
+
+    bool navWpStoreIsAvailable(void) { return true; }
+    bool navWpStoreIsReady(void) { return storeReady; }
+    uint16_t navWpStoreGetCount(void) { return storedMission.size(); }
+
+    bool navWpStoreWrite(uint16_t index, const navWaypoint_t *waypoint)
+    {
+        UNUSED(index);
+        UNUSED(waypoint);
+        return false;
+    }
+
+    bool navWpStoreRead(uint16_t index, navWaypoint_t *waypoints, uint16_t count)
+    {
+        if (storeFails || index + count > storedMission.size()) {
+            return false;
+        }
+        memcpy(waypoints, &storedMission[index], count * sizeof(navWaypoint_t));
+        reads.push_back(count);
+        return true;
+    }
+
+    void invalidateWaypointCache(void) { cacheInvalidations++; }
+
+    void resetWaypointList(void)
+    {
+        posControl.waypointCount = 0;
+        posControl.waypointListValid = false;
+        posControl.geoWaypointCount = 0;
+        memset(&posControl.waypointWindow, 0, sizeof(posControl.waypointWindow));
+    }
+
+    void setWaypoint(uint8_t wpNumber, const navWaypoint_t * wpData)
+    {
+        posControl.waypointList[wpNumber - 1] = *wpData;
+        posControl.waypointCount = wpNumber;
+        posControl.waypointListValid = wpData->flag == NAV_WP_FLAG_LAST;
+    }
+}
+
+static bool isGeo(const navWaypoint_t &wp)
+{
+    return wp.action == NAV_WP_ACTION_WAYPOINT;
+}
+
+// Every 5th waypoint is a POI, which doesn't count as geospatial
+static void makeMission(int count)
+{
+    storedMission.clear();
+    for (int ii = 0; ii < count; ii++) {
+        navWaypoint_t wp;
+        memset(&wp, 0, sizeof(wp));
+        wp.action = ii % 5 == 4 ? NAV_WP_ACTION_SET_POI : NAV_WP_ACTION_WAYPOINT;
+        wp.lat = 450000000 + ii;
+        wp.lon = 90000000 - ii;
+        wp.p1 = ii;
+        wp.flag = ii == count - 1 ? NAV_WP_FLAG_LAST : 0;
+        storedMission.push_back(wp);
+    }
+}
+
+class NavWpWindowTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        memset(&posControl, 0, sizeof(posControl));
+        armingFlags = 0;
+        storeReady = true;
+        storeFails = false;
+        cacheInvalidations = 0;
+        reads.clear();
+        testTimeMs = 10000;
+    }
+
+    // waypointList has to be the part of the mission the window claims,
+    // with the geospatial counts matching it
+    void expectWindow(void)
+    {
+        const navWaypointWindow_t &window = posControl.waypointWindow;
+        ASSERT_LE(window.start + posControl.waypointCount, window.missionCount);
+
+        int geoBefore = 0;
+        for (int ii = 0; ii < window.start; ii++) {
+            geoBefore += isGeo(storedMission[ii]);
+        }
+        EXPECT_EQ(geoBefore, window.geoStart);
+
+        int geoInWindow = 0;
+        for (int ii = 0; ii < posControl.waypointCount; ii++) {
+            EXPECT_EQ(0, memcmp(&storedMission[window.start + ii], &posControl.waypointList[ii], sizeof(navWaypoint_t)))
+                << "waypoint " << ii << " of the window at " << window.start;
+            geoInWindow += isGeo(posControl.waypointList[ii]);
+        }
+        EXPECT_EQ(geoInWindow, posControl.geoWaypointCount);
+    }
+
+    // Like the AUX task, a few calls per waypoint reached
+    void update(int calls)
+    {
+        for (int ii = 0; ii < calls; ii++) {
+            updateWaypointWindow();
+        }
+    }
+};
+
+TEST_F(NavWpWindowTest, ShortMissionIsLoadedWhole)
+{
+    makeMission(NAV_MAX_WAYPOINTS);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    EXPECT_EQ(NAV_MAX_WAYPOINTS, posControl.waypointCount);
+    EXPECT_TRUE(posControl.waypointListValid);
+    EXPECT_EQ(0, posControl.waypointWindow.missionCount);
+    EXPECT_TRUE(isWaypointWindowAtMissionEnd());
+}
+
+TEST_F(NavWpWindowTest, LoadFillsTheWindow)
+{
+    makeMission(MISSION_SIZE);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    EXPECT_TRUE(posControl.waypointListValid);
+    EXPECT_EQ(NAV_MAX_WAYPOINTS, posControl.waypointCount);
+    EXPECT_EQ(MISSION_SIZE, posControl.waypointWindow.missionCount);
+    EXPECT_EQ(MISSION_SIZE * 4 / 5, posControl.waypointWindow.geoCount);
+    EXPECT_EQ(0, posControl.waypointWindow.start);
+    EXPECT_FALSE(isWaypointWindowAtMissionEnd());
+    expectWindow();
+}
+
+TEST_F(NavWpWindowTest, PagedMissionCantHaveJumps)
+{
+    makeMission(MISSION_SIZE);
+    storedMission[MISSION_SIZE - 10].action = NAV_WP_ACTION_JUMP;
+
+    EXPECT_FALSE(loadStoredWaypointMission());
+    EXPECT_EQ(0, posControl.waypointCount);
+    EXPECT_FALSE(posControl.waypointListValid);
+}
+
+TEST_F(NavWpWindowTest, LoadOnlyWhenDisarmed)
+{
+    makeMission(MISSION_SIZE);
+    ENABLE_ARMING_FLAG(ARMED);
+    EXPECT_FALSE(loadStoredWaypointMission());
+    EXPECT_EQ(0, posControl.waypointCount);
+}
+
+TEST_F(NavWpWindowTest, WindowFollowsTheActiveWaypoint)
+{
+    const int count = MISSION_SIZE;
+    makeMission(count);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    for (int reached = 0; reached < count - 1; reached++) {
+        const int missionIndex = posControl.waypointWindow.start + posControl.activeWaypointIndex;
+        ASSERT_EQ(reached, missionIndex);
+
+        reads.clear();
+        posControl.activeWaypointIndex++;
+        update(2);
+        expectWindow();
+
+        // The next waypoint is always loaded before the FSM looks for it
+        ASSERT_LT(posControl.activeWaypointIndex, posControl.waypointCount) << "at mission waypoint " << reached;
+        EXPECT_EQ(reached + 1, posControl.waypointWindow.start + posControl.activeWaypointIndex);
+        // Reads stay short, so the AUX task isn't held up
+        for (int chunk : reads) {
+            EXPECT_LE(chunk, READ_CHUNK);
+        }
+        // The previous waypoint is kept for the leg being flown
+        EXPECT_GE(posControl.activeWaypointIndex, 1);
+    }
+
+    EXPECT_TRUE(isWaypointWindowAtMissionEnd());
+    EXPECT_EQ(NAV_WP_FLAG_LAST, posControl.waypointList[posControl.activeWaypointIndex].flag);
+    EXPECT_EQ(posControl.waypointWindow.geoCount, posControl.waypointWindow.geoStart + posControl.geoWaypointCount);
+
+    // Nothing left to read at the end of the mission
+    reads.clear();
+    update(4);
+    EXPECT_TRUE(reads.empty());
+}
+
+TEST_F(NavWpWindowTest, SlideWaitsForThePreviousWaypointToBePassed)
+{
+    makeMission(MISSION_SIZE);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    posControl.activeWaypointIndex = NAV_MAX_WAYPOINTS / 2;
+    update(1);
+    EXPECT_EQ(0, posControl.waypointWindow.start);
+
+    posControl.activeWaypointIndex++;
+    update(1);
+    EXPECT_EQ(NAV_MAX_WAYPOINTS / 2, posControl.waypointWindow.start);
+    EXPECT_EQ(1, posControl.activeWaypointIndex);
+    expectWindow();
+}
+
+TEST_F(NavWpWindowTest, FillWaitsForTheFlash)
+{
+    makeMission(MISSION_SIZE);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    storeReady = false;
+    reads.clear();
+    posControl.activeWaypointIndex = NAV_MAX_WAYPOINTS - 1;
+    update(4);
+
+    // Slid, but nothing read while the flash is busy
+    EXPECT_TRUE(reads.empty());
+    EXPECT_EQ(1, posControl.activeWaypointIndex);
+    EXPECT_EQ(2, posControl.waypointCount);
+    expectWindow();
+
+    storeReady = true;
+    update(FILL_UPDATES);
+    EXPECT_EQ(NAV_MAX_WAYPOINTS, posControl.waypointCount);
+    expectWindow();
+}
+
+TEST_F(NavWpWindowTest, WaitForTheFlashIsBounded)
+{
+    makeMission(MISSION_SIZE);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    // The waypoint FSM caught up with the end of the window, and the flash
+    // stays busy
+    storeReady = false;
+    EXPECT_TRUE(waitForWaypointWindow());
+    testTimeMs += 1990;
+    update(4);
+    EXPECT_TRUE(waitForWaypointWindow());
+    EXPECT_FALSE(posControl.waypointWindow.readFailed);
+
+    testTimeMs += 10;
+    EXPECT_FALSE(waitForWaypointWindow());
+    EXPECT_TRUE(posControl.waypointWindow.readFailed);
+
+    // The next wait gets the full time again
+    EXPECT_TRUE(waitForWaypointWindow());
+}
+
+TEST_F(NavWpWindowTest, WaitEndsWhenTheWindowIsFilled)
+{
+    makeMission(MISSION_SIZE);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    posControl.activeWaypointIndex = NAV_MAX_WAYPOINTS - 1;
+    storeReady = false;
+    update(1);
+    EXPECT_TRUE(waitForWaypointWindow());
+    testTimeMs += 1500;
+    EXPECT_TRUE(waitForWaypointWindow());
+
+    // A read in time ends the wait, the next one is timed from its own start
+    storeReady = true;
+    update(1);
+    storeReady = false;
+    posControl.activeWaypointIndex = posControl.waypointCount - 1;
+    testTimeMs += 1500;
+    EXPECT_TRUE(waitForWaypointWindow());
+    testTimeMs += 1500;
+    EXPECT_TRUE(waitForWaypointWindow());
+    EXPECT_FALSE(posControl.waypointWindow.readFailed);
+}
+
+TEST_F(NavWpWindowTest, NonGeoWaypointAtTheWindowEndGivesUp)
+{
+    makeMission(MISSION_SIZE);
+    storedMission[NAV_MAX_WAYPOINTS - 1].action = NAV_WP_ACTION_SET_HEAD;
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    // The waypoint FSM is on a SET_HEAD, the last waypoint read so far, and
+    // the flash stopped answering
+    posControl.activeWaypointIndex = NAV_MAX_WAYPOINTS - 1;
+    storeFails = true;
+    ASSERT_FALSE(isWaypointWindowAtMissionEnd());
+
+    // PRE_ACTION re-processes the waypoint every loop until the wait runs out
+    int passes = 0;
+    while (waitForWaypointWindow()) {
+        ASSERT_LT(passes, 2000 / 10) << "the waypoint is retried forever";
+        testTimeMs += 10;
+        update(1);
+        passes++;
+    }
+
+    EXPECT_EQ(2000 / 10, passes);
+    EXPECT_TRUE(posControl.waypointWindow.readFailed);
+    EXPECT_EQ(posControl.waypointCount - 1, posControl.activeWaypointIndex);
+    expectWindow();
+}
+
+TEST_F(NavWpWindowTest, RewindRestartsTheMission)
+{
+    makeMission(MISSION_SIZE);
+    ASSERT_TRUE(loadStoredWaypointMission());
+
+    for (int ii = 0; ii < NAV_MAX_WAYPOINTS * 2; ii++) {
+        posControl.activeWaypointIndex++;
+        update(2);
+    }
+    ASSERT_GT(posControl.waypointWindow.start, 0);
+
+    // Only the first chunk is read right away
+    reads.clear();
+    rewindWaypointWindow();
+    EXPECT_EQ(std::vector<int>({ MIN(READ_CHUNK, NAV_MAX_WAYPOINTS) }), reads);
+    EXPECT_EQ(0, posControl.waypointWindow.start);
+    EXPECT_EQ(0, posControl.activeWaypointIndex);
+    expectWindow();
+
+    update(FILL_UPDATES);
+    EXPECT_EQ(NAV_MAX_WAYPOINTS, posControl.waypointCount);
+    expectWindow();
+
+    // Already at the start, nothing to do
+    reads.clear();
+    rewindWaypointWindow();
+    EXPECT_TRUE(reads.empty());
+    EXPECT_EQ(NAV_MAX_WAYPOINTS, posControl.waypointCount);
+}
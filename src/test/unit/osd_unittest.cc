@@ -0,0 +1,513 @@
+/*
+ * This file is part of INAV.
+ *
+ * INAV is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * INAV is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with INAV.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Checks the cache of what each OSD element last put on screen
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/olc.h"
+    #include "common/time.h"
+
+    #include "config/feature.h"
+
+    #include "drivers/display.h"
+    #include "drivers/display_canvas.h"
+    #include "drivers/osd_symbols.h"
+    #include "drivers/serial.h"
+    #include "drivers/vtx_common.h"
+
+    #include "fc/config.h"
+    #include "fc/controlrate_profile.h"
+    #include "fc/fc_core.h"
+    #include "fc/rc_adjustments.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+    #include "fc/settings.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+    #include "flight/servos.h"
+
+    #include "io/gps.h"
+    #include "io/osd.h"
+    #include "io/osd_common.h"
+    #include "io/osd_hud.h"
+
+    #include "navigation/navigation.h"
+    // C11 only, used by navigation_private.h
+    #define _Static_assert static_assert
+    #include "navigation/navigation_private.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/battery.h"
+    #include "sensors/boardalignment.h"
+    #include "sensors/diagnostics.h"
+    #include "sensors/pitotmeter.h"
+    #include "sensors/sensors.h"
+
+    STATIC_UNIT_TESTED bool osdDrawSingleElement(uint8_t item);
+    STATIC_UNIT_TESTED void osdUpdateElementCache(void);
+    STATIC_UNIT_TESTED void osdDisplayTelemetry(void);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static displayPort_t testDisplayPort;
+static int stringWrites;
+static textAttributes_t supportedAttributes;
+
+static uint16_t testRssi;
+static int16_t testAmperage;
+static timeMs_t testTimeMs;
+
+static int testWriteString(displayPort_t *displayPort, uint8_t x, uint8_t y, const char *text, textAttributes_t attr)
+{
+    UNUSED(displayPort);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(text);
+    UNUSED(attr);
+    stringWrites++;
+    return 0;
+}
+
+static int testNoop(displayPort_t *displayPort)
+{
+    UNUSED(displayPort);
+    return 0;
+}
+
+static textAttributes_t testSupportedTextAttributes(const displayPort_t *displayPort)
+{
+    UNUSED(displayPort);
+    return supportedAttributes;
+}
+
+// Not ready, so osdInit() leaves the screen alone
+static bool testIsReady(displayPort_t *displayPort)
+{
+    UNUSED(displayPort);
+    return false;
+}
+
+static const displayPortVTable_t testVTable = {
+    .grab = testNoop,
+    .release = testNoop,
+    .clearScreen = testNoop,
+    .drawScreen = testNoop,
+    .screenSize = NULL,
+    .writeString = testWriteString,
+    .writeChar = NULL,
+    .readChar = NULL,
+    .isTransferInProgress = NULL,
+    .heartbeat = NULL,
+    .resync = NULL,
+    .txBytesFree = NULL,
+    .supportedTextAttributes = testSupportedTextAttributes,
+    .getFontMetadata = NULL,
+    .writeFontCharacter = NULL,
+    .isReady = testIsReady,
+    .beginTransaction = NULL,
+    .commitTransaction = NULL,
+    .getCanvas = NULL,
+};
+
+class OsdElementCacheTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        testRssi = RSSI_MAX_VALUE / 2;
+        testAmperage = 1234;
+
+        memset(osdConfigMutable(), 0, sizeof(osdConfig_t));
+        memset(osdLayoutsConfigMutable(), 0, sizeof(osdLayoutsConfig_t));
+        osdLayoutsConfigMutable()->item_pos[0][OSD_RSSI_VALUE] = OSD_POS(1, 1) | OSD_VISIBLE_FLAG;
+        osdLayoutsConfigMutable()->item_pos[0][OSD_CURRENT_DRAW] = OSD_POS(1, 2) | OSD_VISIBLE_FLAG;
+
+        initDisplay(_TEXT_ATTRIBUTES_BLINK_BIT);
+    }
+
+    // Starts from an empty cache, the time keeps going up across the tests
+    void initDisplay(textAttributes_t supported)
+    {
+        supportedAttributes = supported;
+        displayInit(&testDisplayPort, &testVTable);
+        testDisplayPort.rows = 16;
+        testDisplayPort.cols = 30;
+        osdInit(&testDisplayPort);
+
+        testTimeMs += 1000;
+        osdUpdateElementCache();
+        stringWrites = 0;
+    }
+
+    // What one pass over the element takes, as osdDrawNextElement() does it
+    int draw(uint8_t item)
+    {
+        const int before = stringWrites;
+        osdUpdateElementCache();
+        osdDrawSingleElement(item);
+        return stringWrites - before;
+    }
+};
+
+TEST_F(OsdElementCacheTest, UnchangedElementIsNotWrittenAgain)
+{
+    // Hashed from its inputs
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(0, draw(OSD_RSSI_VALUE));
+
+    // Hashed from its formatted output
+    EXPECT_EQ(1, draw(OSD_CURRENT_DRAW));
+    EXPECT_EQ(0, draw(OSD_CURRENT_DRAW));
+}
+
+TEST_F(OsdElementCacheTest, ChangedElementIsRedrawn)
+{
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(1, draw(OSD_CURRENT_DRAW));
+
+    testRssi = RSSI_MAX_VALUE / 4;
+    testAmperage = 4321;
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(1, draw(OSD_CURRENT_DRAW));
+
+    // Same value, somewhere else on screen
+    osdLayoutsConfigMutable()->item_pos[0][OSD_RSSI_VALUE] = OSD_POS(5, 5) | OSD_VISIBLE_FLAG;
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(0, draw(OSD_RSSI_VALUE));
+}
+
+TEST_F(OsdElementCacheTest, ClearedScreenDropsTheCache)
+{
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(1, draw(OSD_CURRENT_DRAW));
+
+    displayClearScreen(&testDisplayPort);
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(1, draw(OSD_CURRENT_DRAW));
+    EXPECT_EQ(0, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(0, draw(OSD_CURRENT_DRAW));
+}
+
+TEST_F(OsdElementCacheTest, CacheIsDroppedEverySecond)
+{
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+
+    testTimeMs += 999;
+    EXPECT_EQ(0, draw(OSD_RSSI_VALUE));
+
+    // Writes lost on the way to a remote display get repaired
+    testTimeMs += 1;
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(0, draw(OSD_RSSI_VALUE));
+}
+
+TEST_F(OsdElementCacheTest, EmulatedBlinkIsNeverCached)
+{
+    // Below the alarm, the value blinks
+    osdConfigMutable()->rssi_alarm = 99;
+    osdConfigMutable()->current_alarm = 1;
+
+    // Blinking done by the display, the element is cached as usual
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(0, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(1, draw(OSD_CURRENT_DRAW));
+    EXPECT_EQ(0, draw(OSD_CURRENT_DRAW));
+
+    // Emulated by blanking the text, so the output changes on its own
+    initDisplay(0);
+    for (int ii = 0; ii < 3; ii++) {
+        EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+        EXPECT_EQ(1, draw(OSD_CURRENT_DRAW));
+    }
+
+    // Back above the alarm, cached again
+    osdConfigMutable()->rssi_alarm = 0;
+    EXPECT_EQ(1, draw(OSD_RSSI_VALUE));
+    EXPECT_EQ(0, draw(OSD_RSSI_VALUE));
+}
+
+TEST_F(OsdElementCacheTest, TelemetryModeChangeRewritesTheLine)
+{
+    osdConfigMutable()->telemetry = 1;
+    osdUpdateElementCache();
+    osdDisplayTelemetry();
+    EXPECT_EQ(1, stringWrites);
+    osdDisplayTelemetry();
+    EXPECT_EQ(1, stringWrites);
+
+    // The test mode writes a second line
+    osdConfigMutable()->telemetry = 2;
+    osdDisplayTelemetry();
+    EXPECT_EQ(3, stringWrites);
+    osdDisplayTelemetry();
+    EXPECT_EQ(3, stringWrites);
+}
+
+// STUBS
+
+extern "C" {
+
+int32_t debug[DEBUG32_VALUE_COUNT];
+uint8_t debugMode;
+
+uint32_t armingFlags;
+uint32_t flightModeFlags;
+uint32_t stateFlags;
+
+boardAlignment_t boardAlignment_System;
+navConfig_t navConfig_System;
+rxConfig_t rxConfig_System;
+systemConfig_t systemConfig_System;
+servoParam_t servoParams_SystemArray[MAX_SUPPORTED_SERVOS];
+
+static batteryProfile_t testBatteryProfile;
+const batteryProfile_t *currentBatteryProfile = &testBatteryProfile;
+static controlRateConfig_t testControlRateProfile;
+const controlRateConfig_t *currentControlRateProfile = &testControlRateProfile;
+
+attitudeEulerAngles_t attitude;
+fpVector3_t imuMeasuredAccelBF;
+gpsLocation_t GPS_home;
+gpsSolutionData_t gpsSol;
+int16_t GPS_directionToHome;
+uint32_t GPS_distanceToHome;
+navSystemStatus_t NAV_Status;
+navigationPosControl_t posControl;
+pitot_t pitot;
+radar_pois_t radar_pois[RADAR_MAX_POIS];
+rxLinkStatistics_t rxLinkStatistics;
+int16_t servo[MAX_SUPPORTED_SERVOS];
+
+timeMs_t millis(void) { return testTimeMs; }
+timeUs_t micros(void) { return testTimeMs * 1000; }
+
+bool feature(uint32_t mask) { UNUSED(mask); return false; }
+bool sensors(uint32_t mask) { UNUSED(mask); return false; }
+bool IS_RC_MODE_ACTIVE(boxId_e boxId) { UNUSED(boxId); return false; }
+bool checkStickPosition(stickPositions_e stickPos) { UNUSED(stickPos); return false; }
+armingFlag_e isArmingDisabledReason(void) { return (armingFlag_e)0; }
+bool isAdjustmentFunctionSelected(uint8_t adjustmentFunction) { UNUSED(adjustmentFunction); return false; }
+uint8_t getConfigProfile(void) { return 0; }
+disarmReason_t getDisarmReason(void) { return DISARM_NONE; }
+float getFlightTime(void) { return 0; }
+int16_t getThrottlePercent(void) { return 0; }
+
+uint16_t getRSSI(void) { return testRssi; }
+bool failsafeIsReceivingRxData(void) { return true; }
+failsafePhase_e failsafePhase(void) { return FAILSAFE_IDLE; }
+
+int16_t getAmperage(void) { return testAmperage; }
+int32_t getPower(void) { return 0; }
+int32_t getMAhDrawn(void) { return 0; }
+int32_t getMWhDrawn(void) { return 0; }
+uint16_t getBatteryVoltage(void) { return 1680; }
+uint16_t getBatteryRawVoltage(void) { return 1680; }
+uint16_t getBatterySagCompensatedVoltage(void) { return 1680; }
+uint16_t getBatteryRawAverageCellVoltage(void) { return 420; }
+uint16_t getBatterySagCompensatedAverageCellVoltage(void) { return 420; }
+uint16_t getBatteryWarningVoltage(void) { return 350; }
+uint8_t getBatteryCellCount(void) { return 4; }
+batteryState_e getBatteryState(void) { return BATTERY_OK; }
+uint32_t getBatteryRemainingCapacity(void) { return 0; }
+bool batteryUsesCapacityThresholds(void) { return false; }
+bool batteryWasFullWhenPluggedIn(void) { return true; }
+uint8_t calculateBatteryPercentage(void) { return 100; }
+uint16_t getPowerSupplyImpedance(void) { return 0; }
+bool isPowerSupplyImpedanceValid(void) { return false; }
+
+bool getBaroTemperature(int16_t *temperature) { UNUSED(temperature); return false; }
+bool getIMUTemperature(int16_t *temperature) { UNUSED(temperature); return false; }
+const acc_extremes_t *accGetMeasuredExtremes(void)
+{
+    static acc_extremes_t extremes[XYZ_AXIS_COUNT];
+    return extremes;
+}
+float accGetMeasuredMaxG(void) { return 0; }
+bool isImuHeadingValid(void) { return true; }
+float getFixedWingLevelTrim(void) { return 0; }
+int16_t osdGet3DSpeed(void) { return 0; }
+
+hardwareSensorStatus_e getHwGyroStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwAccelerometerStatus(void) { return HW_SENSOR_OK; }
+hardwareSensorStatus_e getHwCompassStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwBarometerStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwGPSStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwRangefinderStatus(void) { return HW_SENSOR_NONE; }
+hardwareSensorStatus_e getHwPitotmeterStatus(void) { return HW_SENSOR_NONE; }
+
+const pidBank_t *pidBank(void)
+{
+    static pidBank_t bank;
+    return &bank;
+}
+pidType_e pidIndexGetType(pidIndex_e pidIndex) { UNUSED(pidIndex); return PID_TYPE_NONE; }
+const navigationPIDControllers_t *getNavigationPIDControllers(void)
+{
+    static navigationPIDControllers_t controllers;
+    return &controllers;
+}
+
+navigationFSMStateFlags_t navGetCurrentStateFlags(void) { return (navigationFSMStateFlags_t)0; }
+bool navigationRequiresAngleMode(void) { return false; }
+bool navigationIsControllingThrottle(void) { return false; }
+bool navigationIsExecutingAnEmergencyLanding(void) { return false; }
+bool navigationPositionEstimateIsHealthy(void) { return false; }
+navArmingBlocker_e navigationIsBlockingArming(bool *usedBypass) { UNUSED(usedBypass); return NAV_ARMING_BLOCKER_NONE; }
+int32_t navigationGetHeadingError(void) { return 0; }
+int32_t navigationGetHomeHeading(void) { return 0; }
+bool isAdjustingHeading(void) { return false; }
+bool isAdjustingPosition(void) { return false; }
+int32_t getCruiseHeadingAdjustment(void) { return 0; }
+bool isFixedWingAutoThrottleManuallyIncreased(void) { return false; }
+const char *fixedWingLaunchStateMessage(void) { return NULL; }
+float getEstimatedActualPosition(int axis) { UNUSED(axis); return 0; }
+float getEstimatedActualVelocity(int axis) { UNUSED(axis); return 0; }
+uint32_t getTotalTravelDistance(void) { return 0; }
+uint32_t calculateDistanceToDestination(const fpVector3_t *destinationPos) { UNUSED(destinationPos); return 0; }
+int32_t calculateBearingToDestination(const fpVector3_t *destinationPos) { UNUSED(destinationPos); return 0; }
+bool geoConvertGeodeticToLocal(fpVector3_t *pos, const gpsOrigin_t *origin, const gpsLocation_t *llh, geoAltitudeConversionMode_e altConv)
+{
+    UNUSED(pos);
+    UNUSED(origin);
+    UNUSED(llh);
+    UNUSED(altConv);
+    return false;
+}
+bool isWaypointListValid(void) { return false; }
+bool isWaypointMissionRTHActive(void) { return false; }
+int getGeoWaypointCount(void) { return 0; }
+uint32_t distanceToFirstWP(void) { return 0; }
+const navWaypointCacheEntry_t *getWaypointCacheEntry(int index)
+{
+    UNUSED(index);
+    static navWaypointCacheEntry_t entry;
+    return &entry;
+}
+geoAltitudeConversionMode_e waypointMissionAltConvMode(geoAltitudeDatumFlag_e datumFlag)
+{
+    UNUSED(datumFlag);
+    return GEO_ALT_RELATIVE;
+}
+
+int olc_encode(olc_coord_t lat, olc_coord_t lon, size_t length, char *buf, size_t bufsize)
+{
+    UNUSED(lat);
+    UNUSED(lon);
+    UNUSED(length);
+    UNUSED(bufsize);
+    buf[0] = '\0';
+    return 0;
+}
+
+bool rtcGetDateTime(dateTime_t *dt) { UNUSED(dt); return false; }
+bool rtcGetDateTimeLocal(dateTime_t *dt) { UNUSED(dt); return false; }
+bool dateTimeFormatLocal(char *buf, dateTime_t *dt) { UNUSED(dt); buf[0] = '\0'; return false; }
+bool dateTimeSplitFormatted(char *formatted, char **date, char **time)
+{
+    UNUSED(formatted);
+    UNUSED(date);
+    UNUSED(time);
+    return false;
+}
+
+void pt1FilterInitRC(pt1Filter_t *filter, float tau, float dT) { UNUSED(filter); UNUSED(tau); UNUSED(dT); }
+void pt1FilterReset(pt1Filter_t *filter, float input) { UNUSED(filter); UNUSED(input); }
+float pt1FilterApply3(pt1Filter_t *filter, float input, float dT) { UNUSED(filter); UNUSED(dT); return input; }
+float pt1FilterApply4(pt1Filter_t *filter, float input, float f_cut, float dt)
+{
+    UNUSED(filter);
+    UNUSED(f_cut);
+    UNUSED(dt);
+    return input;
+}
+
+void osdDrawArtificialHorizon(displayPort_t *display, displayCanvas_t *canvas, const osdDrawPoint_t *p, float rollAngle, float pitchAngle)
+{
+    UNUSED(display);
+    UNUSED(canvas);
+    UNUSED(p);
+    UNUSED(rollAngle);
+    UNUSED(pitchAngle);
+}
+void osdDrawDirArrow(displayPort_t *display, displayCanvas_t *canvas, const osdDrawPoint_t *p, float degrees)
+{
+    UNUSED(display);
+    UNUSED(canvas);
+    UNUSED(p);
+    UNUSED(degrees);
+}
+void osdDrawHeadingGraph(displayPort_t *display, displayCanvas_t *canvas, const osdDrawPoint_t *p, int heading)
+{
+    UNUSED(display);
+    UNUSED(canvas);
+    UNUSED(p);
+    UNUSED(heading);
+}
+void osdDrawSidebars(displayPort_t *display, displayCanvas_t *canvas) { UNUSED(display); UNUSED(canvas); }
+void osdDrawVario(displayPort_t *display, displayCanvas_t *canvas, const osdDrawPoint_t *p, float zvel)
+{
+    UNUSED(display);
+    UNUSED(canvas);
+    UNUSED(p);
+    UNUSED(zvel);
+}
+void osdHudClear(void) {}
+void osdHudDrawCrosshair(displayCanvas_t *canvas, uint8_t px, uint8_t py) { UNUSED(canvas); UNUSED(px); UNUSED(py); }
+void osdHudDrawHoming(uint8_t px, uint8_t py) { UNUSED(px); UNUSED(py); }
+void osdHudDrawPoi(uint32_t poiDistance, int16_t poiDirection, int32_t poiAltitude, uint8_t poiType, uint16_t poiSymbol, int16_t poiP1, int16_t poiP2)
+{
+    UNUSED(poiDistance);
+    UNUSED(poiDirection);
+    UNUSED(poiAltitude);
+    UNUSED(poiType);
+    UNUSED(poiSymbol);
+    UNUSED(poiP1);
+    UNUSED(poiP2);
+}
+
+vtxDevice_t *vtxCommonDevice(void) { return NULL; }
+bool vtxCommonGetOsdInfo(vtxDevice_t *vtxDevice, vtxDeviceOsdInfo_t *pOsdInfo)
+{
+    UNUSED(vtxDevice);
+    memset(pOsdInfo, 0, sizeof(*pOsdInfo));
+    return false;
+}
+
+void serialWrite(serialPort_t *instance, uint8_t ch) { UNUSED(instance); UNUSED(ch); }
+bool isSerialTransmitBufferEmpty(const serialPort_t *instance) { UNUSED(instance); return true; }
+
+const setting_t *settingGet(unsigned index) { UNUSED(index); return NULL; }
+void settingGetName(const setting_t *val, char *buf) { UNUSED(val); buf[0] = '\0'; }
+bool settingsValidate(unsigned *invalidIndex) { UNUSED(invalidIndex); return true; }
+
+}
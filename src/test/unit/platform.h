@@ -74,6 +74,7 @@ typedef struct
 #define SysTick_CTRL_COUNTFLAG_Msk         (1UL << SysTick_CTRL_COUNTFLAG_Pos)            /*!< SysTick CTRL: COUNTFLAG Mask */
 
 extern SysTick_Type *SysTick;
+extern uint32_t SystemCoreClock;
 
 
 #define WS2811_DMA_TC_FLAG 1
@@ -90,3 +91,13 @@ extern SysTick_Type *SysTick;
 #define FILE_COMPILE_FOR_SIZE
 #define FILE_COMPILE_NORMAL
 #define FILE_COMPILE_FOR_SPEED
+
+// Config storage in RAM, see target/common_post.h
+#ifdef CONFIG_IN_RAM
+#ifndef EEPROM_SIZE
+#define EEPROM_SIZE     8192
+#endif
+extern uint8_t eepromData[EEPROM_SIZE];
+#define __config_start (*eepromData)
+#define __config_end (eepromData[EEPROM_SIZE])
+#endif
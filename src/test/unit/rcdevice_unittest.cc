@@ -725,12 +725,8 @@ extern "C" {
             s.vTable = NULL;
 
             // common serial initialisation code should move to serialPort::init()
-            s.rxBufferHead = s.rxBufferTail = 0;
-            s.txBufferHead = s.txBufferTail = 0;
-            s.rxBufferSize = 0;
-            s.txBufferSize = 0;
-            s.rxBuffer = s.rxBuffer;
-            s.txBuffer = s.txBuffer;
+            memset(&s.rxBuffer, 0, sizeof(s.rxBuffer));
+            memset(&s.txBuffer, 0, sizeof(s.txBuffer));
 
             // callback works for IRQ-based RX ONLY
             s.rxCallback = callback;
@@ -0,0 +1,352 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <thread>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/assert.h"
+
+    #include "common/ring_buffer.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+TEST(RingBufferTest, EmptyAfterInit)
+{
+    uint8_t storage[16];
+    ringBuffer_t rb;
+
+    ringBufferInit(&rb, storage, sizeof(storage));
+
+    EXPECT_EQ(16U, ringBufferSize(&rb));
+    EXPECT_EQ(0U, ringBufferCount(&rb));
+    EXPECT_EQ(16U, ringBufferFree(&rb));
+    EXPECT_TRUE(ringBufferIsEmpty(&rb));
+
+    uint8_t c;
+    EXPECT_FALSE(ringBufferGet(&rb, &c));
+}
+
+TEST(RingBufferTest, UninitialisedHasNoSize)
+{
+    ringBuffer_t rb;
+    memset(&rb, 0, sizeof(rb));
+
+    EXPECT_EQ(0U, ringBufferSize(&rb));
+    EXPECT_EQ(0U, ringBufferFree(&rb));
+}
+
+TEST(RingBufferTest, WholeBufferIsUsable)
+{
+    uint8_t storage[8];
+    ringBuffer_t rb;
+
+    ringBufferInit(&rb, storage, sizeof(storage));
+
+    for (int i = 0; i < 8; i++) {
+        EXPECT_TRUE(ringBufferPut(&rb, i));
+    }
+    EXPECT_FALSE(ringBufferPut(&rb, 8));
+    EXPECT_EQ(8U, ringBufferCount(&rb));
+    EXPECT_EQ(0U, ringBufferFree(&rb));
+
+    for (int i = 0; i < 8; i++) {
+        uint8_t c;
+        EXPECT_TRUE(ringBufferGet(&rb, &c));
+        EXPECT_EQ(i, c);
+    }
+    EXPECT_TRUE(ringBufferIsEmpty(&rb));
+}
+
+TEST(RingBufferTest, IndicesWrapAround)
+{
+    uint8_t storage[8];
+    ringBuffer_t rb;
+
+    ringBufferInit(&rb, storage, sizeof(storage));
+    // Free running indices overflow, the count must stay right
+    rb.head = rb.tail = UINT32_MAX - 3;
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(ringBufferPut(&rb, i));
+        EXPECT_TRUE(ringBufferPut(&rb, i + 1));
+        EXPECT_EQ(2U, ringBufferCount(&rb));
+
+        uint8_t c;
+        EXPECT_TRUE(ringBufferGet(&rb, &c));
+        EXPECT_EQ(i, c);
+        EXPECT_TRUE(ringBufferGet(&rb, &c));
+        EXPECT_EQ(i + 1, c);
+    }
+}
+
+TEST(RingBufferTest, BulkWriteAndReadAcrossTheEnd)
+{
+    uint8_t storage[16];
+    ringBuffer_t rb;
+    uint8_t data[32];
+    uint8_t out[32];
+
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = 100 + i;
+    }
+
+    ringBufferInit(&rb, storage, sizeof(storage));
+
+    EXPECT_EQ(10U, ringBufferWrite(&rb, data, 10));
+    EXPECT_EQ(10U, ringBufferRead(&rb, out, 10));
+
+    // Wraps at the end of the storage, only 16 fit
+    EXPECT_EQ(16U, ringBufferWrite(&rb, data, 20));
+    EXPECT_EQ(0U, ringBufferWrite(&rb, data, 1));
+
+    memset(out, 0, sizeof(out));
+    EXPECT_EQ(16U, ringBufferRead(&rb, out, sizeof(out)));
+    EXPECT_EQ(0, memcmp(data, out, 16));
+    EXPECT_EQ(0U, ringBufferRead(&rb, out, 1));
+}
+
+TEST(RingBufferTest, SpansStopAtTheEnd)
+{
+    uint8_t storage[16];
+    ringBuffer_t rb;
+
+    ringBufferInit(&rb, storage, sizeof(storage));
+
+    uint8_t *writePtr;
+    const uint8_t *readPtr;
+
+    EXPECT_EQ(16U, ringBufferGetWriteSpan(&rb, &writePtr));
+    EXPECT_EQ(storage, writePtr);
+    EXPECT_EQ(0U, ringBufferGetReadSpan(&rb, &readPtr));
+
+    memset(writePtr, 0xaa, 12);
+    ringBufferCommitWrite(&rb, 12);
+    EXPECT_EQ(12U, ringBufferCount(&rb));
+
+    // Only the 4 bytes up to the end, the free ones at the start come next
+    EXPECT_EQ(4U, ringBufferGetWriteSpan(&rb, &writePtr));
+    EXPECT_EQ(storage + 12, writePtr);
+
+    EXPECT_EQ(12U, ringBufferGetReadSpan(&rb, &readPtr));
+    EXPECT_EQ(storage, readPtr);
+    ringBufferCommitRead(&rb, 10);
+
+    memset(writePtr, 0xbb, 4);
+    ringBufferCommitWrite(&rb, 4);
+
+    EXPECT_EQ(10U, ringBufferGetWriteSpan(&rb, &writePtr));
+    EXPECT_EQ(storage, writePtr);
+
+    EXPECT_EQ(6U, ringBufferGetReadSpan(&rb, &readPtr));
+    EXPECT_EQ(storage + 10, readPtr);
+    ringBufferCommitRead(&rb, 6);
+    EXPECT_EQ(0U, ringBufferGetReadSpan(&rb, &readPtr));
+}
+
+TEST(RingBufferTest, Reset)
+{
+    uint8_t storage[8];
+    ringBuffer_t rb;
+
+    ringBufferInit(&rb, storage, sizeof(storage));
+    ringBufferPut(&rb, 1);
+    ringBufferPut(&rb, 2);
+
+    ringBufferReset(&rb);
+    EXPECT_TRUE(ringBufferIsEmpty(&rb));
+    EXPECT_EQ(8U, ringBufferFree(&rb));
+}
+
+TEST(RingBufferTest, SizeMustBeAPowerOfTwo)
+{
+    uint8_t storage[12];
+    ringBuffer_t rb;
+
+    assertFailureLine = 0;
+    ringBufferInit(&rb, storage, 16);
+    EXPECT_EQ(0, assertFailureLine);
+
+    ringBufferInit(&rb, storage, sizeof(storage));
+    EXPECT_NE(0, assertFailureLine);
+
+    // Only the first 8 bytes are used, the end of the storage is not overrun
+    EXPECT_EQ(8U, ringBufferSize(&rb));
+    for (int ii = 0; ii < 12; ii++) {
+        ringBufferPut(&rb, 0xAA);
+    }
+    EXPECT_EQ(8U, ringBufferCount(&rb));
+
+    assertFailureLine = 0;
+    ringBufferInit(&rb, storage, 0);
+    EXPECT_NE(0, assertFailureLine);
+}
+
+// The producer and the consumer run on their own threads, like an ISR and
+// the main loop, each mixing the byte, bulk and span APIs. The consumer
+// must see the exact sequence the producer wrote.
+static uint8_t streamByte(uint32_t n)
+{
+    return (n * 2654435761u) >> 24;
+}
+
+static void stressProducer(ringBuffer_t *rb, uint32_t total)
+{
+    uint32_t n = 0;
+    uint8_t chunk[37];
+
+    while (n < total) {
+        const uint32_t start = n;
+
+        switch (n % 3) {
+        case 0:
+            if (ringBufferPut(rb, streamByte(n))) {
+                n++;
+            }
+            break;
+        case 1: {
+            const uint32_t len = std::min<uint32_t>(sizeof(chunk), total - n);
+            for (uint32_t i = 0; i < len; i++) {
+                chunk[i] = streamByte(n + i);
+            }
+            n += ringBufferWrite(rb, chunk, len);
+            break;
+        }
+        default: {
+            uint8_t *ptr;
+            const uint32_t len = std::min<uint32_t>(ringBufferGetWriteSpan(rb, &ptr), total - n);
+            for (uint32_t i = 0; i < len; i++) {
+                ptr[i] = streamByte(n + i);
+            }
+            ringBufferCommitWrite(rb, len);
+            n += len;
+            break;
+        }
+        }
+
+        // Let the other side run when the host has a single core
+        if (n == start) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static uint32_t stressConsumer(ringBuffer_t *rb, uint32_t total)
+{
+    uint32_t n = 0;
+    uint32_t errors = 0;
+    uint8_t chunk[23];
+
+    while (n < total) {
+        const uint32_t start = n;
+
+        switch (n % 3) {
+        case 0: {
+            uint8_t c;
+            if (ringBufferGet(rb, &c)) {
+                errors += c != streamByte(n);
+                n++;
+            }
+            break;
+        }
+        case 1: {
+            const uint32_t len = ringBufferRead(rb, chunk, std::min<uint32_t>(sizeof(chunk), total - n));
+            for (uint32_t i = 0; i < len; i++) {
+                errors += chunk[i] != streamByte(n + i);
+            }
+            n += len;
+            break;
+        }
+        default: {
+            const uint8_t *ptr;
+            const uint32_t len = ringBufferGetReadSpan(rb, &ptr);
+            for (uint32_t i = 0; i < len; i++) {
+                errors += ptr[i] != streamByte(n + i);
+            }
+            ringBufferCommitRead(rb, len);
+            n += len;
+            break;
+        }
+        }
+
+        // Let the other side run when the host has a single core
+        if (n == start) {
+            std::this_thread::yield();
+        }
+    }
+
+    return errors;
+}
+
+static void stress(uint32_t size, uint32_t total)
+{
+    uint8_t *storage = new uint8_t[size];
+    ringBuffer_t rb;
+    uint32_t errors = 0;
+
+    ringBufferInit(&rb, storage, size);
+
+    std::thread consumer([&] { errors = stressConsumer(&rb, total); });
+    std::thread producer([&] { stressProducer(&rb, total); });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_EQ(0U, errors);
+    EXPECT_TRUE(ringBufferIsEmpty(&rb));
+    EXPECT_EQ(total, rb.head);
+    EXPECT_EQ(total, rb.tail);
+
+    delete[] storage;
+}
+
+TEST(RingBufferTest, TwoThreadStressSmall)
+{
+    stress(4, 2000000);
+}
+
+TEST(RingBufferTest, TwoThreadStressSerialSize)
+{
+    stress(256, 20000000);
+}
+
+// STUBS
+
+extern "C" {
+
+int assertFailureLine;
+
+void assertFailed1(int line)
+{
+    assertFailureLine = line;
+}
+
+}
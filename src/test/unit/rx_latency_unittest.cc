@@ -0,0 +1,236 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Runs frames from a fake receiver through rxUpdateCheck(), processRx() and
+// the PID loop marks, checking the latency of every stage.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/utils.h"
+
+    #include "config/parameter_group_ids.h"
+
+    #include "fc/config.h"
+    #include "fc/rc_modes.h"
+
+    #include "flight/failsafe.h"
+
+    #include "programming/logic_condition.h"
+
+    #include "rx/rx.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FRAME_INTERVAL_US   4000    // 250Hz, like CRSF
+#define SETTLE_FRAMES       200     // Enough for the averages to reach a constant latency
+
+static timeUs_t testTimeUs = 1000000;
+static bool framePending;
+static timeUs_t driverFrameTimeUs;
+
+extern "C" {
+    static uint8_t testFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
+    {
+        if (!framePending) {
+            return RX_FRAME_PENDING;
+        }
+        framePending = false;
+        rxRuntimeConfig->frameTimeUs = driverFrameTimeUs;
+        return RX_FRAME_COMPLETE;
+    }
+
+    static uint16_t testReadRaw(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t channel)
+    {
+        UNUSED(rxRuntimeConfig);
+        UNUSED(channel);
+        return 1500;
+    }
+}
+
+typedef struct {
+    timeDelta_t pickupUs;       // rxUpdateCheck() finds the frame
+    timeDelta_t rxUs;           // processRx()
+    timeDelta_t rcCommandUs;
+    timeDelta_t motorUs;
+} frameTiming_t;
+
+class RxLatencyTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        rxRuntimeConfig.rcFrameStatusFn = testFrameStatus;
+        rxRuntimeConfig.rcReadRawFn = testReadRaw;
+        rxRuntimeConfig.rxSignalTimeout = DELAY_10_HZ;
+        debugMode = DEBUG_RX_LATENCY;
+        memset(debug, 0, sizeof(debug));
+
+        // The latency state outlives a test, start well after the last one
+        frameTimeUs = testTimeUs + 1000000;
+    }
+
+    // Times are from when the frame was received
+    void runFrame(const frameTiming_t &timing, bool stamped)
+    {
+        framePending = true;
+        driverFrameTimeUs = stamped ? frameTimeUs : 0;
+        ASSERT_TRUE(rxUpdateCheck(frameTimeUs + timing.pickupUs, 0));
+        ASSERT_TRUE(calculateRxChannelsAndUpdateFailsafe(frameTimeUs + timing.rxUs));
+
+        testTimeUs = frameTimeUs + timing.rcCommandUs;
+        rxLatencyMark(RX_LATENCY_RC_COMMAND);
+        testTimeUs = frameTimeUs + timing.motorUs;
+        rxLatencyMark(RX_LATENCY_MOTOR);
+
+        frameTimeUs += FRAME_INTERVAL_US;
+    }
+
+    void settle(const frameTiming_t &timing, bool stamped)
+    {
+        for (int ii = 0; ii < SETTLE_FRAMES; ii++) {
+            runFrame(timing, stamped);
+        }
+    }
+
+    void expectLatency(rxLatencyStage_e stage, timeDelta_t latencyUs, timeDelta_t averageUs)
+    {
+        EXPECT_EQ(latencyUs, rxGetLatencyUs(stage)) << "stage " << stage;
+        EXPECT_EQ(averageUs, rxGetAverageLatencyUs(stage)) << "stage " << stage;
+        EXPECT_EQ(latencyUs, debug[stage]) << "stage " << stage;
+    }
+
+    timeUs_t frameTimeUs;
+};
+
+TEST_F(RxLatencyTest, StagesAreMeasuredFromTheFrameTime)
+{
+    const frameTiming_t timing = { 300, 500, 900, 1100 };
+    settle(timing, true);
+
+    // Not from when rxUpdateCheck() picked the frame up
+    expectLatency(RX_LATENCY_FRAME_INTERVAL, FRAME_INTERVAL_US, FRAME_INTERVAL_US);
+    expectLatency(RX_LATENCY_RX, 500, 500);
+    expectLatency(RX_LATENCY_RC_COMMAND, 900, 900);
+    expectLatency(RX_LATENCY_MOTOR, 1100, 1100);
+
+    // A single slow frame moves the average by 1/16 of the difference
+    runFrame({ 300, 500, 2500, 2700 }, true);
+    expectLatency(RX_LATENCY_RC_COMMAND, 2500, 900 + (2500 - 900) / 16);
+    expectLatency(RX_LATENCY_MOTOR, 2700, 1100 + (2700 - 1100) / 16);
+    expectLatency(RX_LATENCY_RX, 500, 500);
+}
+
+TEST_F(RxLatencyTest, EachStageIsCountedOncePerFrame)
+{
+    const frameTiming_t timing = { 200, 400, 700, 800 };
+    settle(timing, true);
+
+    // Later PID loops run with the same channels
+    for (int ii = 0; ii < 8; ii++) {
+        testTimeUs += 125;
+        rxLatencyMark(RX_LATENCY_RC_COMMAND);
+        rxLatencyMark(RX_LATENCY_MOTOR);
+    }
+    expectLatency(RX_LATENCY_RC_COMMAND, 700, 700);
+    expectLatency(RX_LATENCY_MOTOR, 800, 800);
+
+    // processRx() runs at 50Hz without a frame too
+    const timeUs_t staleUs = frameTimeUs + 30000;
+    ASSERT_TRUE(rxUpdateCheck(staleUs, 0));
+    ASSERT_TRUE(calculateRxChannelsAndUpdateFailsafe(staleUs));
+    testTimeUs = staleUs + 100;
+    rxLatencyMark(RX_LATENCY_RC_COMMAND);
+    rxLatencyMark(RX_LATENCY_MOTOR);
+    expectLatency(RX_LATENCY_RX, 400, 400);
+    expectLatency(RX_LATENCY_RC_COMMAND, 700, 700);
+    expectLatency(RX_LATENCY_MOTOR, 800, 800);
+
+    // A frame picked up, but not processed yet, isn't in rcCommand
+    frameTimeUs = staleUs + 1000;
+    framePending = true;
+    driverFrameTimeUs = frameTimeUs;
+    ASSERT_TRUE(rxUpdateCheck(frameTimeUs + 200, 0));
+    testTimeUs = frameTimeUs + 300;
+    rxLatencyMark(RX_LATENCY_RC_COMMAND);
+    expectLatency(RX_LATENCY_RC_COMMAND, 700, 700);
+
+    ASSERT_TRUE(calculateRxChannelsAndUpdateFailsafe(frameTimeUs + 400));
+    testTimeUs = frameTimeUs + 700;
+    rxLatencyMark(RX_LATENCY_RC_COMMAND);
+    expectLatency(RX_LATENCY_RC_COMMAND, 700, 700);
+}
+
+TEST_F(RxLatencyTest, UnstampedFrameUsesThePickupTime)
+{
+    const frameTiming_t timing = { 300, 500, 900, 1100 };
+    settle(timing, false);
+
+    expectLatency(RX_LATENCY_FRAME_INTERVAL, FRAME_INTERVAL_US, FRAME_INTERVAL_US);
+    expectLatency(RX_LATENCY_RX, 500 - 300, 500 - 300);
+    expectLatency(RX_LATENCY_RC_COMMAND, 900 - 300, 900 - 300);
+    expectLatency(RX_LATENCY_MOTOR, 1100 - 300, 1100 - 300);
+
+    // The stamp of the previous frame doesn't leak into the next one
+    runFrame(timing, true);
+    EXPECT_EQ(500, rxGetLatencyUs(RX_LATENCY_RX));
+    runFrame(timing, false);
+    EXPECT_EQ(200, rxGetLatencyUs(RX_LATENCY_RX));
+    EXPECT_EQ(800, rxGetLatencyUs(RX_LATENCY_MOTOR));
+}
+
+// STUBS
+
+extern "C" {
+    int32_t debug[DEBUG32_VALUE_COUNT];
+    uint8_t debugMode;
+
+    uint64_t logicConditionsGlobalFlags;
+
+    PG_REGISTER_ARRAY(modeActivationCondition_t, MAX_MODE_ACTIVATION_CONDITION_COUNT, modeActivationConditions, PG_MODE_ACTIVATION_PROFILE, 0);
+
+    timeUs_t micros(void) { return testTimeUs; }
+    timeMs_t millis(void) { return testTimeUs / 1000; }
+
+    bool feature(uint32_t mask) { UNUSED(mask); return false; }
+
+    void failsafeOnRxSuspend(void) {}
+    void failsafeOnRxResume(void) {}
+    void failsafeOnValidDataReceived(void) {}
+    void failsafeOnValidDataFailed(void) {}
+
+    int16_t getRcChannelOverride(uint8_t channel, int16_t originalValue)
+    {
+        UNUSED(channel);
+        return originalValue;
+    }
+}
@@ -0,0 +1,501 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Feeds recorded RX streams into the frame parsers of the serial RX
+// protocols, the way a UART receiving with DMA and the idle line interrupt
+// hands them over, and checks they decode like the byte parsers.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+    #include "drivers/time.h"
+
+    #include "io/osd.h"
+    #include "io/serial.h"
+
+    #include "rx/rx.h"
+    #include "rx/crsf.h"
+    #include "rx/fport.h"
+    #include "rx/ghst.h"
+    #include "rx/sbus.h"
+
+    #include "telemetry/telemetry.h"
+    #include "telemetry/smartport.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+extern "C" {
+    int32_t debug[DEBUG32_VALUE_COUNT];
+    uint8_t debugMode;
+
+    rxConfig_t rxConfig_System;
+    osdConfig_t osdConfig_System;
+    rxLinkStatistics_t rxLinkStatistics;
+    serialPort_t *telemetrySharedPort;
+
+    static timeUs_t testTimeUs;
+    timeUs_t micros(void) { return testTimeUs; }
+    timeUs_t microsISR(void) { return testTimeUs; }
+    timeMs_t millis(void) { return testTimeUs / 1000; }
+
+    void lqTrackerSet(rxLinkQualityTracker_e *lqTracker, uint16_t rawValue) { UNUSED(lqTracker); UNUSED(rawValue); }
+    void lqTrackerAccumulate(rxLinkQualityTracker_e *lqTracker, uint16_t rawValue) { UNUSED(lqTracker); UNUSED(rawValue); }
+
+    bool telemetryCheckRxPortShared(const serialPortConfig_t *portConfig) { UNUSED(portConfig); return false; }
+    bool initSmartPortTelemetryExternal(smartPortWriteFrameFn *smartPortWriteFrameExternal) { UNUSED(smartPortWriteFrameExternal); return false; }
+    void smartPortSendByte(uint8_t c, uint16_t *checksum, serialPort_t *port) { UNUSED(c); UNUSED(checksum); UNUSED(port); }
+    void smartPortWriteFrameSerial(const smartPortPayload_t *payload, serialPort_t *port, uint16_t checksum) { UNUSED(payload); UNUSED(port); UNUSED(checksum); }
+    void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *hasRequest, const uint32_t *requestTimeout) { UNUSED(payload); UNUSED(hasRequest); UNUSED(requestTimeout); }
+    bool smartPortPayloadContainsMSP(const smartPortPayload_t *payload) { UNUSED(payload); return false; }
+}
+
+// Stand-in for the RX UART. It records the callbacks the protocol passes
+// and only accepts the frame callback when the test runs in frame mode.
+static uint8_t testRxStorage[256];
+static serialPort_t testPort;
+static bool testPortFrameMode;
+static serialPortConfig_t testPortConfig;
+
+static bool testSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr callback)
+{
+    if (!testPortFrameMode) {
+        return false;
+    }
+    instance->rxFrameCallback = callback;
+    return true;
+}
+
+static uint32_t testTotalTxFree(const serialPort_t *instance)
+{
+    UNUSED(instance);
+    return 256;
+}
+
+static void testWrite(serialPort_t *instance, uint8_t ch)
+{
+    UNUSED(instance);
+    UNUSED(ch);
+}
+
+static const struct serialPortVTable testVTable = {
+    .serialWrite = testWrite,
+    .serialTotalRxWaiting = NULL,
+    .serialTotalTxFree = testTotalTxFree,
+    .serialRead = NULL,
+    .serialSetBaudRate = NULL,
+    .isSerialTransmitBufferEmpty = NULL,
+    .setMode = NULL,
+    .writeBuf = NULL,
+    .isConnected = NULL,
+    .isIdle = NULL,
+    .beginWrite = NULL,
+    .endWrite = NULL,
+    .setRxFrameCallback = testSetRxFrameCallback,
+};
+
+extern "C" {
+    serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function) { UNUSED(function); return &testPortConfig; }
+    serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function, serialReceiveCallbackPtr rxCallback,
+        void *rxCallbackData, uint32_t baudRate, portMode_t mode, portOptions_t options)
+    {
+        UNUSED(identifier); UNUSED(function); UNUSED(baudRate); UNUSED(mode); UNUSED(options);
+
+        memset(&testPort, 0, sizeof(testPort));
+        testPort.vTable = &testVTable;
+        testPort.rxCallback = rxCallback;
+        testPort.rxCallbackData = rxCallbackData;
+        ringBufferInit(&testPort.rxBuffer, testRxStorage, sizeof(testRxStorage));
+        return &testPort;
+    }
+}
+
+// Captured from receivers, channels 992/172/1811/992/191/1792, 992 up to
+// 1500 on channel 16
+static const uint8_t crsfRcFrame[] = {
+    0xC8, 0x18, 0x16, 0xE0, 0x63, 0xC5, 0xC4, 0xC1, 0xF7, 0x0B, 0x80, 0x83, 0x0F, 0x7C, 0xE0, 0x03,
+    0x1F, 0xF8, 0xC0, 0x07, 0x3E, 0xF0, 0x81, 0x8F, 0xBB, 0x32,
+};
+
+static const uint8_t crsfLinkStatisticsFrame[] = {
+    0xC8, 0x0C, 0x14, 0x46, 0x48, 0x64, 0x0A, 0x00, 0x02, 0x03, 0x50, 0x64, 0x08, 0x5B,
+};
+
+static const uint8_t sbusFrame[] = {
+    0x0F, 0xE0, 0x63, 0xC5, 0xC4, 0xC1, 0xF7, 0x0B, 0x80, 0x83, 0x0F, 0x7C, 0xE0, 0x03, 0x1F, 0xF8,
+    0xC0, 0x07, 0x3E, 0xF0, 0x81, 0x8F, 0xBB, 0x00, 0x00,
+};
+
+// Channel 1 is 126 here, which puts a stuffed 0x7E right after the type
+static const uint8_t fportControlFrame[] = {
+    0x7E, 0x19, 0x00, 0x7D, 0x5E, 0x60, 0xC5, 0xC4, 0xC1, 0xF7, 0x0B, 0x80, 0x83, 0x0F, 0x7C, 0xE0,
+    0x03, 0x1F, 0xF8, 0xC0, 0x07, 0x3E, 0xF0, 0x81, 0x8F, 0xBB, 0x00, 0x46, 0x23, 0x7E,
+};
+
+// Channels 1-4 as 12 bit 1500/1000/3000/2000, 5-8 as 8 bit 0x7C/0x10/0xF0/0x40
+static const uint8_t ghstRc5to8Frame[] = {
+    0x82, 0x0C, 0x10, 0xDC, 0x85, 0x3E, 0xB8, 0x0B, 0x7D, 0x7C, 0x10, 0xF0, 0x40, 0x3A,
+};
+
+static const uint16_t expectedChannels[] = { 992, 172, 1811, 992, 191, 1792, 992, 992, 992, 992, 992, 992, 992, 992, 992, 1500 };
+
+static std::vector<uint8_t> concat(std::initializer_list<std::pair<const uint8_t *, size_t>> parts)
+{
+    std::vector<uint8_t> out;
+    for (const auto &part : parts) {
+        out.insert(out.end(), part.first, part.first + part.second);
+    }
+    return out;
+}
+
+#define PART(x) std::make_pair((const uint8_t *)(x), sizeof(x))
+
+class RxSerialFrameTest : public ::testing::Test {
+protected:
+    rxRuntimeConfig_t rxRuntimeConfig;
+    rxLinkQualityTracker_e lqTracker;
+    uint32_t dmaPos;
+    uint32_t lastPos;
+    timeUs_t frameEndUs;
+
+    void SetUp() override
+    {
+        memset(&rxRuntimeConfig, 0, sizeof(rxRuntimeConfig));
+        rxRuntimeConfig.lqTracker = &lqTracker;
+        memset(&rxConfig_System, 0, sizeof(rxConfig_System));
+        rxConfig_System.sbusSyncInterval = 3000;
+        osdConfig_System.rssi_dbm_max = -30;
+        osdConfig_System.rssi_dbm_min = -120;
+        testPortFrameMode = true;
+        testTimeUs = 1000000;
+        dmaPos = 0;
+        lastPos = 0;
+    }
+
+    // What the UART does: the DMA writes the burst into the circular part
+    // of the RX storage, the idle line interrupt flushes it
+    void receiveBurst(const uint8_t *data, size_t len)
+    {
+        const uint32_t dmaSize = serialRxFrameDmaSize(&testPort);
+        for (size_t i = 0; i < len; i++) {
+            testRxStorage[dmaPos] = data[i];
+            dmaPos = (dmaPos + 1) % dmaSize;
+            testTimeUs += 20;
+        }
+        frameEndUs = testTimeUs;
+        lastPos = serialRxFrameDmaFlush(&testPort, lastPos, dmaPos);
+        testTimeUs += 4000;
+    }
+
+    void receiveBurst(const std::vector<uint8_t> &data)
+    {
+        receiveBurst(data.data(), data.size());
+    }
+
+    // One byte per interrupt, with the usual gap after the burst
+    void receiveBytes(const uint8_t *data, size_t len)
+    {
+        for (size_t i = 0; i < len; i++) {
+            frameEndUs = testTimeUs;
+            testPort.rxCallback(data[i], testPort.rxCallbackData);
+            testTimeUs += 20;
+        }
+        testTimeUs += 4000;
+    }
+};
+
+TEST_F(RxSerialFrameTest, ByteModeWithoutDriverSupport)
+{
+    testPortFrameMode = false;
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+    EXPECT_EQ(NULL, testPort.rxFrameCallback);
+    EXPECT_NE((void *)NULL, (void *)testPort.rxCallback);
+
+    receiveBytes(crsfRcFrame, sizeof(crsfRcFrame));
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    // Stamped with the last byte, not when the status was polled
+    EXPECT_EQ(frameEndUs, rxRuntimeConfig.frameTimeUs);
+}
+
+TEST_F(RxSerialFrameTest, FrameFlushWrapsAroundTheDmaArea)
+{
+    std::vector<std::vector<uint8_t>> bursts;
+    testPort.rxFrameCallback = [](const uint8_t *data, uint16_t len, void *rxCallbackData) {
+        static_cast<std::vector<std::vector<uint8_t>> *>(rxCallbackData)->emplace_back(data, data + len);
+    };
+    testPort.rxCallbackData = &bursts;
+    ringBufferInit(&testPort.rxBuffer, testRxStorage, sizeof(testRxStorage));
+
+    const uint32_t dmaSize = serialRxFrameDmaSize(&testPort);
+    EXPECT_EQ(sizeof(testRxStorage) - SERIAL_RX_FRAME_SIZE_MAX, dmaSize);
+
+    // Nothing new, no callback
+    receiveBurst(NULL, 0);
+    EXPECT_EQ(0U, bursts.size());
+
+    // Ends right at the end of the DMA area
+    std::vector<uint8_t> burst(dmaSize);
+    for (size_t i = 0; i < burst.size(); i++) {
+        burst[i] = i;
+    }
+    receiveBurst(burst.data(), dmaSize - 10);
+    receiveBurst(burst.data(), 10);
+    ASSERT_EQ(2U, bursts.size());
+    EXPECT_EQ(std::vector<uint8_t>(burst.begin(), burst.begin() + 10), bursts[1]);
+    EXPECT_EQ(0U, lastPos);
+
+    // Across the end, handed over in one piece
+    receiveBurst(burst.data(), dmaSize - 5);
+    receiveBurst(burst.data(), 30);
+    ASSERT_EQ(4U, bursts.size());
+    EXPECT_EQ(std::vector<uint8_t>(burst.begin(), burst.begin() + 30), bursts[3]);
+    EXPECT_EQ(25U, lastPos);
+    EXPECT_EQ(0, debug[0]);
+
+    // Wraps further than the room after the DMA area, the rest is dropped
+    // and counted
+    debugMode = DEBUG_SERIAL_RX_DMA;
+    receiveBurst(burst.data(), dmaSize - 25 - 5);
+    receiveBurst(burst.data(), 5 + SERIAL_RX_FRAME_SIZE_MAX + 20);
+    ASSERT_EQ(6U, bursts.size());
+    EXPECT_EQ(std::vector<uint8_t>(burst.begin(), burst.begin() + 5 + SERIAL_RX_FRAME_SIZE_MAX), bursts[5]);
+    EXPECT_EQ(20, debug[0]);
+    EXPECT_EQ(1, debug[1]);
+    debugMode = DEBUG_NONE;
+}
+
+TEST_F(RxSerialFrameTest, CrsfFramesAcrossTheEndOfTheDmaArea)
+{
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+    ASSERT_NE((void *)NULL, (void *)testPort.rxFrameCallback);
+
+    // Park the DMA just before the end, so the frames wrap around
+    dmaPos = lastPos = serialRxFrameDmaSize(&testPort) - 7;
+
+    for (int i = 0; i < 20; i++) {
+        receiveBurst(crsfRcFrame, sizeof(crsfRcFrame));
+        ASSERT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig)) << "frame " << i;
+        EXPECT_EQ(frameEndUs, rxRuntimeConfig.frameTimeUs);
+
+        for (unsigned ch = 0; ch < ARRAYLEN(expectedChannels); ch++) {
+            EXPECT_EQ(rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, ch), (expectedChannels[ch] * 1024 / 1639) + 881);
+        }
+
+        receiveBurst(crsfLinkStatisticsFrame, sizeof(crsfLinkStatisticsFrame));
+        EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+        EXPECT_EQ(100, rxLinkStatistics.uplinkLQ);
+    }
+}
+
+TEST_F(RxSerialFrameTest, CrsfBackToBackFramesInOneBurst)
+{
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+    rxLinkStatistics.uplinkLQ = 0;
+
+    receiveBurst(concat({ PART(crsfRcFrame), PART(crsfLinkStatisticsFrame) }));
+    // The RC frame isn't lost to the frame after it
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    EXPECT_EQ(frameEndUs, rxRuntimeConfig.frameTimeUs);
+    for (unsigned ch = 0; ch < ARRAYLEN(expectedChannels); ch++) {
+        EXPECT_EQ(rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, ch), (expectedChannels[ch] * 1024 / 1639) + 881);
+    }
+    EXPECT_EQ(100, rxLinkStatistics.uplinkLQ);
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+}
+
+TEST_F(RxSerialFrameTest, CrsfLinkStatisticsBeforeRcInOneBurst)
+{
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+    memset(&rxLinkStatistics, 0, sizeof(rxLinkStatistics));
+
+    receiveBurst(concat({ PART(crsfLinkStatisticsFrame), PART(crsfRcFrame) }));
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    for (unsigned ch = 0; ch < ARRAYLEN(expectedChannels); ch++) {
+        EXPECT_EQ(rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, ch), (expectedChannels[ch] * 1024 / 1639) + 881);
+    }
+
+    // The link statistics aren't lost to the RC frame after them
+    EXPECT_EQ(-70, rxLinkStatistics.uplinkRSSI);
+    EXPECT_EQ(100, rxLinkStatistics.uplinkLQ);
+    EXPECT_EQ(10, rxLinkStatistics.uplinkSNR);
+    EXPECT_EQ(2, rxLinkStatistics.rfMode);
+    EXPECT_EQ(100, rxLinkStatistics.uplinkTXPower);
+
+    // Processed once
+    rxLinkStatistics.uplinkLQ = 0;
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    EXPECT_EQ(0, rxLinkStatistics.uplinkLQ);
+}
+
+TEST_F(RxSerialFrameTest, CrsfTruncatedAndCorruptFrames)
+{
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+
+    // Line went idle in the middle of the frame
+    receiveBurst(crsfRcFrame, sizeof(crsfRcFrame) - 3);
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+
+    // Bad CRC
+    std::vector<uint8_t> corrupt(crsfRcFrame, crsfRcFrame + sizeof(crsfRcFrame));
+    corrupt[10] ^= 0x01;
+    receiveBurst(corrupt);
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+
+    // Length which doesn't fit the frame buffer
+    static const uint8_t oversize[] = { 0xC8, 0xF0, 0x16, 0x00 };
+    receiveBurst(oversize, sizeof(oversize));
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+
+    // And it recovers on the next good one
+    receiveBurst(crsfRcFrame, sizeof(crsfRcFrame));
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+}
+
+TEST_F(RxSerialFrameTest, CrsfFrameAndByteModeAgree)
+{
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+    receiveBurst(crsfRcFrame, sizeof(crsfRcFrame));
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    std::vector<uint16_t> frameMode;
+    for (unsigned ch = 0; ch < CRSF_MAX_CHANNEL; ch++) {
+        frameMode.push_back(rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, ch));
+    }
+
+    testPortFrameMode = false;
+    EXPECT_TRUE(crsfRxInit(rxConfig(), &rxRuntimeConfig));
+    receiveBytes(crsfRcFrame, sizeof(crsfRcFrame));
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    for (unsigned ch = 0; ch < CRSF_MAX_CHANNEL; ch++) {
+        EXPECT_EQ(frameMode[ch], rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, ch));
+    }
+}
+
+TEST_F(RxSerialFrameTest, Sbus)
+{
+    EXPECT_TRUE(sbusInit(rxConfig(), &rxRuntimeConfig));
+    ASSERT_NE((void *)NULL, (void *)testPort.rxFrameCallback);
+
+    dmaPos = lastPos = serialRxFrameDmaSize(&testPort) - 11;
+
+    for (int i = 0; i < 20; i++) {
+        receiveBurst(sbusFrame, sizeof(sbusFrame));
+        ASSERT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig)) << "frame " << i;
+        EXPECT_EQ(frameEndUs, rxRuntimeConfig.frameTimeUs);
+        for (unsigned ch = 0; ch < ARRAYLEN(expectedChannels); ch++) {
+            EXPECT_EQ(expectedChannels[ch], rxRuntimeConfig.channelData[ch]);
+        }
+    }
+
+    // Cut short, and a bad end byte
+    receiveBurst(sbusFrame, sizeof(sbusFrame) - 1);
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    std::vector<uint8_t> badEnd(sbusFrame, sbusFrame + sizeof(sbusFrame));
+    badEnd.back() = 0x55;
+    receiveBurst(badEnd);
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+
+    receiveBurst(sbusFrame, sizeof(sbusFrame));
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+}
+
+TEST_F(RxSerialFrameTest, FportStuffedFrame)
+{
+    EXPECT_TRUE(fportRxInit(rxConfig(), &rxRuntimeConfig));
+    ASSERT_NE((void *)NULL, (void *)testPort.rxFrameCallback);
+
+    dmaPos = lastPos = serialRxFrameDmaSize(&testPort) - 3;
+
+    for (int i = 0; i < 20; i++) {
+        receiveBurst(fportControlFrame, sizeof(fportControlFrame));
+        ASSERT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig)) << "frame " << i;
+        EXPECT_EQ(frameEndUs, rxRuntimeConfig.frameTimeUs);
+        EXPECT_EQ(126, rxRuntimeConfig.channelData[0]);
+        for (unsigned ch = 1; ch < ARRAYLEN(expectedChannels); ch++) {
+            EXPECT_EQ(expectedChannels[ch], rxRuntimeConfig.channelData[ch]);
+        }
+    }
+
+    // Truncated frame followed by a good one in the next burst
+    receiveBurst(fportControlFrame, sizeof(fportControlFrame) - 4);
+    receiveBurst(fportControlFrame, sizeof(fportControlFrame));
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+}
+
+TEST_F(RxSerialFrameTest, Ghst)
+{
+    EXPECT_TRUE(ghstRxInit(rxConfig(), &rxRuntimeConfig));
+    ASSERT_NE((void *)NULL, (void *)testPort.rxFrameCallback);
+
+    dmaPos = lastPos = serialRxFrameDmaSize(&testPort) - 5;
+
+    for (int i = 0; i < 20; i++) {
+        receiveBurst(ghstRc5to8Frame, sizeof(ghstRc5to8Frame));
+        const uint8_t status = rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig);
+        ASSERT_TRUE(status & RX_FRAME_COMPLETE) << "frame " << i;
+        ASSERT_TRUE(status & RX_FRAME_PROCESSING_REQUIRED);
+        EXPECT_EQ(frameEndUs, rxRuntimeConfig.frameTimeUs);
+        EXPECT_TRUE(rxRuntimeConfig.rcProcessFrameFn(&rxRuntimeConfig));
+
+        // 12 bit channels are halved, 8 bit ones scaled up to 11 bits
+        EXPECT_EQ((5 * (750 + 1) / 8) + 880, rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, 0));
+        EXPECT_EQ((5 * (1500 + 1) / 8) + 880, rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, 2));
+        EXPECT_EQ((5 * ((0x7C << 3) + 1) / 8) + 880, rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, 4));
+        EXPECT_EQ((5 * ((0x40 << 3) + 1) / 8) + 880, rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, 7));
+    }
+
+    // Bad CRC
+    std::vector<uint8_t> corrupt(ghstRc5to8Frame, ghstRc5to8Frame + sizeof(ghstRc5to8Frame));
+    corrupt[4] ^= 0x80;
+    receiveBurst(corrupt);
+    EXPECT_TRUE(rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig) & RX_FRAME_DROPPED);
+}
+
+TEST_F(RxSerialFrameTest, GhstBackToBackFramesInOneBurst)
+{
+    EXPECT_TRUE(ghstRxInit(rxConfig(), &rxRuntimeConfig));
+
+    // Followed by a frame for the goggles
+    std::vector<uint8_t> burst = concat({ PART(ghstRc5to8Frame), PART(ghstRc5to8Frame) });
+    burst[sizeof(ghstRc5to8Frame)] = 0x83;
+    receiveBurst(burst);
+
+    const uint8_t status = rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig);
+    EXPECT_TRUE(status & RX_FRAME_COMPLETE);
+    EXPECT_FALSE(status & RX_FRAME_DROPPED);
+    EXPECT_TRUE(rxRuntimeConfig.rcProcessFrameFn(&rxRuntimeConfig));
+    EXPECT_EQ((5 * ((0x7C << 3) + 1) / 8) + 880, rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, 4));
+}
@@ -0,0 +1,303 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+// Checks the task selection of the scheduler. The EDF mode is compared
+// against a linear search for the earliest deadline while tasks are added,
+// removed and rescheduled, which catches the heap getting out of order.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <new>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "scheduler/scheduler.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static timeUs_t testTimeUs;
+static std::vector<int> executed;
+static bool eventSignaled;
+
+extern "C" {
+    cfTask_t cfTasks[TASK_COUNT] = {};
+
+    timeUs_t micros(void) { return testTimeUs; }
+    void taskRunRealtimeCallbacks(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); }
+
+    static bool testCheckFunc(timeUs_t currentTimeUs, timeDelta_t currentDeltaTimeUs)
+    {
+        UNUSED(currentTimeUs);
+        UNUSED(currentDeltaTimeUs);
+        return eventSignaled;
+    }
+}
+
+// One function per task, so the executed task can be told apart
+template <int N> static void testTask(timeUs_t currentTimeUs)
+{
+    UNUSED(currentTimeUs);
+    executed.push_back(N);
+}
+
+typedef void (*taskFunc_t)(timeUs_t);
+static taskFunc_t testTaskFuncs[TASK_COUNT];
+
+template <int N> struct testTaskFuncsFill {
+    static void fill(void)
+    {
+        testTaskFuncs[N - 1] = testTask<N - 1>;
+        testTaskFuncsFill<N - 1>::fill();
+    }
+};
+
+template <> struct testTaskFuncsFill<0> {
+    static void fill(void) {}
+};
+
+static void taskSetup(int taskId, timeDelta_t period, cfTaskPriority_e priority, timeUs_t lastExecutedAt)
+{
+    // staticPriority is const, the task can't be assigned
+    new (&cfTasks[taskId]) cfTask_t{ "TEST", NULL, testTaskFuncs[taskId], period, (uint8_t)priority,
+        0, 0, lastExecutedAt, 0, 0, -1, 0, 0, 0, 0, 0, {{0}}, {{0}} };
+}
+
+static timeUs_t taskDeadline(int taskId)
+{
+    return cfTasks[taskId].lastExecutedAt + cfTasks[taskId].desiredPeriod;
+}
+
+class SchedulerTest : public ::testing::Test
+{
+protected:
+    bool enabled[TASK_COUNT];
+
+    virtual void SetUp()
+    {
+        testTaskFuncsFill<TASK_COUNT>::fill();
+        testTimeUs = 1000000;
+        executed.clear();
+        eventSignaled = false;
+
+        schedulerSetMode(SCHEDULER_MODE_PRIORITY);
+        schedulerInit();
+        for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+            taskSetup(taskId, 0, TASK_PRIORITY_MEDIUM, 0);
+            setTaskEnabled((cfTaskId_e)taskId, false);
+            enabled[taskId] = false;
+        }
+    }
+
+    void enable(int taskId, bool enable)
+    {
+        setTaskEnabled((cfTaskId_e)taskId, enable);
+        enabled[taskId] = enable;
+    }
+
+    bool isDue(int taskId)
+    {
+        return enabled[taskId] && (timeDelta_t)(testTimeUs - taskDeadline(taskId)) >= 0;
+    }
+
+    // What EDF should pick, by walking all the tasks. Realtime tasks come
+    // first, idle ones only when nothing else is due.
+    timeUs_t expectedDeadline(bool *found)
+    {
+        static const uint8_t classes[] = { TASK_PRIORITY_REALTIME, TASK_PRIORITY_MEDIUM, TASK_PRIORITY_IDLE };
+        for (unsigned ii = 0; ii < ARRAYLEN(classes); ii++) {
+            *found = false;
+            timeUs_t deadline = 0;
+            for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+                if (cfTasks[taskId].staticPriority == classes[ii] && isDue(taskId) &&
+                    (!*found || (timeDelta_t)(taskDeadline(taskId) - deadline) < 0)) {
+                    deadline = taskDeadline(taskId);
+                    *found = true;
+                }
+            }
+            if (*found) {
+                return deadline;
+            }
+        }
+        return 0;
+    }
+};
+
+TEST_F(SchedulerTest, PriorityQueueOrder)
+{
+    taskSetup(TASK_SYSTEM, 1000, TASK_PRIORITY_HIGH, 0);
+    taskSetup(TASK_PID, 1000, TASK_PRIORITY_REALTIME, 0);
+    taskSetup(TASK_SERIAL, 1000, TASK_PRIORITY_LOW, 0);
+    taskSetup(TASK_BATTERY, 1000, TASK_PRIORITY_MEDIUM, 0);
+    enable(TASK_SERIAL, true);
+    enable(TASK_SYSTEM, true);
+    enable(TASK_BATTERY, true);
+    enable(TASK_PID, true);
+
+    // Everything overdue by the same time, priority mode runs the realtime
+    // task and then by static priority
+    scheduler();
+    scheduler();
+    scheduler();
+    scheduler();
+    EXPECT_EQ(std::vector<int>({ TASK_PID, TASK_SYSTEM, TASK_BATTERY, TASK_SERIAL }), executed);
+}
+
+TEST_F(SchedulerTest, EdfRunsTheEarliestDeadlineFirst)
+{
+    schedulerSetMode(SCHEDULER_MODE_EDF);
+
+    // Deadlines in reverse task order
+    for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+        taskSetup(taskId, 1000 + (TASK_COUNT - taskId) * 10, TASK_PRIORITY_MEDIUM, testTimeUs - 2000);
+        enable(taskId, true);
+    }
+
+    for (int ii = 0; ii < TASK_COUNT; ii++) {
+        scheduler();
+    }
+    ASSERT_EQ((size_t)TASK_COUNT, executed.size());
+    for (int ii = 0; ii < TASK_COUNT; ii++) {
+        EXPECT_EQ(TASK_COUNT - 1 - ii, executed[ii]);
+    }
+
+    // All of them ran at this time, none is due
+    scheduler();
+    EXPECT_EQ((size_t)TASK_COUNT, executed.size());
+}
+
+TEST_F(SchedulerTest, EdfRealtimeAndIdleTasks)
+{
+    schedulerSetMode(SCHEDULER_MODE_EDF);
+
+    taskSetup(TASK_SYSTEM, 1000, TASK_PRIORITY_IDLE, testTimeUs - 5000);
+    taskSetup(TASK_BATTERY, 1000, TASK_PRIORITY_MEDIUM, testTimeUs - 3000);
+    taskSetup(TASK_PID, 1000, TASK_PRIORITY_REALTIME, testTimeUs - 1000);
+    enable(TASK_SYSTEM, true);
+    enable(TASK_BATTERY, true);
+    enable(TASK_PID, true);
+
+    // The realtime task wins even though it's the least overdue, the idle
+    // task goes last
+    scheduler();
+    scheduler();
+    scheduler();
+    EXPECT_EQ(std::vector<int>({ TASK_PID, TASK_BATTERY, TASK_SYSTEM }), executed);
+}
+
+TEST_F(SchedulerTest, EdfEventTaskAgainstTimeDrivenTask)
+{
+    schedulerSetMode(SCHEDULER_MODE_EDF);
+
+    new (&cfTasks[TASK_RX]) cfTask_t{ "RX", testCheckFunc, testTaskFuncs[TASK_RX], 1000, TASK_PRIORITY_HIGH,
+        0, 0, testTimeUs - 100, 0, 0, -1, 0, 0, 0, 0, 0, {{0}}, {{0}} };
+    taskSetup(TASK_BATTERY, 1000, TASK_PRIORITY_MEDIUM, testTimeUs - 1500);
+    enable(TASK_RX, true);
+    enable(TASK_BATTERY, true);
+
+    // Not signaled, only the time driven task is due
+    scheduler();
+    EXPECT_EQ(std::vector<int>({ TASK_BATTERY }), executed);
+
+    // Signaled right when the time driven task becomes due, the event goes first
+    eventSignaled = true;
+    testTimeUs += 1000;
+    scheduler();
+    eventSignaled = false;
+    scheduler();
+    EXPECT_EQ(std::vector<int>({ TASK_BATTERY, TASK_RX, TASK_BATTERY }), executed);
+
+    // The time driven task was due before the event fired
+    testTimeUs += 1200;
+    eventSignaled = true;
+    scheduler();
+    eventSignaled = false;
+    scheduler();
+    EXPECT_EQ(std::vector<int>({ TASK_BATTERY, TASK_RX, TASK_BATTERY, TASK_BATTERY, TASK_RX }), executed);
+}
+
+TEST_F(SchedulerTest, EdfHeapOrderWithRandomChanges)
+{
+    static const cfTaskPriority_e priorities[] = { TASK_PRIORITY_REALTIME, TASK_PRIORITY_MEDIUM, TASK_PRIORITY_IDLE };
+
+    srand(1234);
+    for (int taskId = 0; taskId < TASK_COUNT; taskId++) {
+        taskSetup(taskId, 100 + rand() % 5000, priorities[rand() % ARRAYLEN(priorities)], testTimeUs - rand() % 5000);
+        enable(taskId, rand() % 4 != 0);
+    }
+    schedulerSetMode(SCHEDULER_MODE_EDF);
+
+    for (int step = 0; step < 20000; step++) {
+        switch (rand() % 8) {
+        case 0: {
+            const int taskId = rand() % TASK_COUNT;
+            enable(taskId, !enabled[taskId]);
+            break;
+        }
+        case 1:
+            rescheduleTask((cfTaskId_e)(rand() % TASK_COUNT), 100 + rand() % 5000);
+            break;
+        default:
+            testTimeUs += rand() % 300;
+            break;
+        }
+
+        bool found;
+        const timeUs_t deadline = expectedDeadline(&found);
+        const size_t count = executed.size();
+        scheduler();
+
+        if (!found) {
+            ASSERT_EQ(count, executed.size()) << "step " << step;
+        } else {
+            ASSERT_EQ(count + 1, executed.size()) << "step " << step;
+            // Ties can go either way, so only the deadline is checked
+            const int taskId = executed.back();
+            ASSERT_EQ(deadline, cfTasks[taskId].lastExecutedAt - cfTasks[taskId].taskLatestDeltaTime + cfTasks[taskId].desiredPeriod)
+                << "step " << step << " task " << taskId;
+        }
+    }
+
+    // Switching modes rebuilds the heaps from the task queue
+    schedulerSetMode(SCHEDULER_MODE_PRIORITY);
+    schedulerSetMode(SCHEDULER_MODE_EDF);
+    testTimeUs += 10000;
+    while (true) {
+        bool found;
+        const timeUs_t deadline = expectedDeadline(&found);
+        if (!found) {
+            break;
+        }
+        scheduler();
+        const int taskId = executed.back();
+        ASSERT_EQ(deadline, cfTasks[taskId].lastExecutedAt - cfTasks[taskId].taskLatestDeltaTime + cfTasks[taskId].desiredPeriod);
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ * This file is part of INAV Project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Alternatively, the contents of this file may be used under the terms
+ * of the GNU General Public License Version 3, as described below:
+ *
+ * This file is free software: you may copy, redistribute and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "common/maths.h"
+    #include "common/sdft.h"
+    #include "common/utils.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SAMPLE_RATE_HZ  1000.0f
+#define RESOLUTION_HZ   (SAMPLE_RATE_HZ / SDFT_SAMPLE_SIZE)
+#define START_BIN       30      // ~117Hz, up to ~363Hz
+#define END_BIN         (START_BIN + SDFT_MAX_BINS - 1)
+#define PEAK_COUNT      3
+
+static sdft_t sdft;
+static float magnitudeSq[SDFT_MAX_BINS];
+static sdftPeak_t peaks[PEAK_COUNT];
+
+static uint32_t seed;
+
+// Uniform noise in [-1, 1]
+static float noise(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return ((seed >> 8) & 0xffff) / 32768.0f - 1.0f;
+}
+
+typedef struct {
+    float frequency;
+    float amplitude;
+} tone_t;
+
+static void pushTones(const tone_t *tones, int toneCount, float noiseAmplitude, int sampleCount)
+{
+    static uint32_t n = 0;
+
+    for (int ii = 0; ii < sampleCount; ii++, n++) {
+        const float t = n / SAMPLE_RATE_HZ;
+        float sample = noiseAmplitude * noise();
+        for (int tt = 0; tt < toneCount; tt++) {
+            sample += tones[tt].amplitude * sinf(2 * M_PIf * tones[tt].frequency * t + tt);
+        }
+        sdftPush(&sdft, sample);
+    }
+}
+
+static uint8_t findPeaks(void)
+{
+    sdftWindowedMagnitudeSq(&sdft, magnitudeSq);
+    return sdftFindPeaks(&sdft, magnitudeSq, peaks, PEAK_COUNT);
+}
+
+static float biggestPeakFrequency(void)
+{
+    float biggest = 0;
+    float frequency = 0;
+
+    findPeaks();
+    for (int p = 0; p < PEAK_COUNT; p++) {
+        if (peaks[p].value > biggest) {
+            biggest = peaks[p].value;
+            frequency = peaks[p].bin * RESOLUTION_HZ;
+        }
+    }
+
+    return frequency;
+}
+
+class SdftTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        seed = 1;
+        sdftInit(&sdft, START_BIN, END_BIN);
+    }
+};
+
+TEST_F(SdftTest, BinRangeIsLimited)
+{
+    sdftInit(&sdft, 0, SDFT_BIN_COUNT);
+    EXPECT_EQ(1, sdft.startBin);
+    EXPECT_EQ(SDFT_MAX_BINS, sdft.endBin);
+
+    sdftInit(&sdft, 100, 200);
+    EXPECT_EQ(100, sdft.startBin);
+    EXPECT_EQ(SDFT_BIN_COUNT - 2, sdft.endBin);
+}
+
+TEST_F(SdftTest, NoPeaksWithoutSignal)
+{
+    pushTones(NULL, 0, 0, SDFT_SAMPLE_SIZE);
+    EXPECT_EQ(0, findPeaks());
+    for (int p = 0; p < PEAK_COUNT; p++) {
+        EXPECT_EQ(0, peaks[p].value);
+    }
+}
+
+TEST_F(SdftTest, SubBinAccuracy)
+{
+    // Sweep a single tone across a few bins, the interpolated peak has to
+    // be much better than the bin width
+    for (float frequency = 150.0f; frequency < 170.0f; frequency += 0.7f) {
+        sdftInit(&sdft, START_BIN, END_BIN);
+        const tone_t tone = { frequency, 50.0f };
+        pushTones(&tone, 1, 0, SDFT_SAMPLE_SIZE);
+
+        EXPECT_NEAR(frequency, biggestPeakFrequency(), 0.05f * RESOLUTION_HZ) << "at " << frequency << "Hz";
+    }
+}
+
+TEST_F(SdftTest, MotorNoise)
+{
+    // Motor fundamentals plus their harmonics, white noise and a big low
+    // frequency stick input below the bin range
+    const tone_t tones[] = {
+        { 15.0f, 300.0f },
+        { 173.3f, 30.0f },
+        { 2 * 173.3f, 4.0f },
+        { 231.9f, 20.0f },
+        { 301.7f, 12.0f },
+    };
+    pushTones(tones, ARRAYLEN(tones), 5.0f, 4 * SDFT_SAMPLE_SIZE);
+
+    ASSERT_EQ(PEAK_COUNT, findPeaks());
+
+    // Biggest 3 peaks, sorted by frequency
+    EXPECT_NEAR(173.3f, peaks[0].bin * RESOLUTION_HZ, 0.5f);
+    EXPECT_NEAR(231.9f, peaks[1].bin * RESOLUTION_HZ, 0.5f);
+    EXPECT_NEAR(301.7f, peaks[2].bin * RESOLUTION_HZ, 0.5f);
+}
+
+TEST_F(SdftTest, TracksFrequencyChange)
+{
+    const tone_t before = { 200.0f, 30.0f };
+    pushTones(&before, 1, 1.0f, SDFT_SAMPLE_SIZE);
+    EXPECT_NEAR(200.0f, biggestPeakFrequency(), 0.5f);
+
+    // One window later only the new frequency is left
+    const tone_t after = { 300.0f, 30.0f };
+    pushTones(&after, 1, 1.0f, SDFT_SAMPLE_SIZE);
+    EXPECT_NEAR(300.0f, biggestPeakFrequency(), 0.5f);
+}
+
+TEST_F(SdftTest, StableOverTime)
+{
+    // Rounding errors must not accumulate, after a long time with signal a
+    // window of silence has to give an empty spectrum again
+    const tone_t tone = { 250.0f, 100.0f };
+    pushTones(&tone, 1, 20.0f, 500000);
+    pushTones(NULL, 0, 0, SDFT_SAMPLE_SIZE);
+
+    sdftWindowedMagnitudeSq(&sdft, magnitudeSq);
+    for (int bin = 0; bin <= END_BIN - START_BIN; bin++) {
+        EXPECT_LT(magnitudeSq[bin], 1e-2f);
+    }
+}
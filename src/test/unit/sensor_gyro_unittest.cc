@@ -29,6 +29,7 @@ extern "C" {
     #include "common/axis.h"
     #include "common/maths.h"
     #include "common/calibration.h"
+    #include "common/filter.h"
     #include "common/utils.h"
     #include "drivers/accgyro/accgyro_fake.h"
     #include "drivers/logging_codes.h"
@@ -132,6 +133,101 @@ TEST(SensorGyro, Update)
     EXPECT_FLOAT_EQ(90 * gyroDev[0].scale, gyro.gyroADCf[Z]);
 }
 
+static void gyroInitFifo(uint16_t antiAliasingLpfHz)
+{
+    gyroConfigMutable()->useFifo = true;
+    gyroConfigMutable()->gyro_anti_aliasing_lpf_hz = antiAliasingLpfHz;
+    gyroConfigMutable()->gyro_anti_aliasing_lpf_type = FILTER_PT1;
+    gyroInit();
+    gyroStartCalibration();
+    while (!gyroIsCalibrationComplete()) {
+        fakeGyroSet(5, 6, 7);
+        gyroUpdate();
+    }
+}
+
+static void gyroResetFifoConfig(void)
+{
+    gyroConfigMutable()->useFifo = false;
+    gyroConfigMutable()->gyro_anti_aliasing_lpf_hz = 0;
+}
+
+TEST(SensorGyro, FifoDisabled)
+{
+    gyroResetFifoConfig();
+    gyroInit();
+    EXPECT_TRUE(gyroDev[0].readFifoFn == NULL);
+}
+
+TEST(SensorGyro, FifoAverage)
+{
+    gyroInitFifo(0);
+    EXPECT_TRUE(gyroDev[0].readFifoFn != NULL);
+    EXPECT_EQ(5, gyroDev[0].gyroZero[X]);
+
+    // Burst of 4 samples, averaged since there is no anti-aliasing LPF
+    fakeGyroSet(15, 26, 97);
+    fakeGyroSet(25, 16, 87);
+    fakeGyroSet(5, 6, 7);
+    fakeGyroSet(-5, -4, 9);
+    gyroUpdate();
+    EXPECT_FLOAT_EQ(5 * gyroDev[0].scale, gyro.gyroADCf[X]);
+    EXPECT_FLOAT_EQ(5 * gyroDev[0].scale, gyro.gyroADCf[Y]);
+    EXPECT_FLOAT_EQ(43 * gyroDev[0].scale, gyro.gyroADCf[Z]);
+
+    // Nothing in the FIFO, the previous value is kept
+    gyroUpdate();
+    EXPECT_FLOAT_EQ(5 * gyroDev[0].scale, gyro.gyroADCf[X]);
+
+    gyroResetFifoConfig();
+}
+
+TEST(SensorGyro, FifoLpf)
+{
+    gyroInitFifo(100);
+
+    // Every sample goes through the LPF running at the sensor rate
+    pt1Filter_t expected;
+    pt1FilterInit(&expected, 100, gyro.targetLooptime * 1e-6f);
+    const int16_t samples[] = { 105, 205, -95, 305, 5, 55 };
+    float expectedOutput = 0;
+    for (unsigned i = 0; i < ARRAYLEN(samples); i++) {
+        fakeGyroSet(samples[i], 6, 7);
+        expectedOutput = pt1FilterApply(&expected, (samples[i] - 5) * gyroDev[0].scale);
+    }
+    gyroUpdate();
+    EXPECT_FLOAT_EQ(expectedOutput, gyro.gyroADCf[X]);
+    EXPECT_FLOAT_EQ(0, gyro.gyroADCf[Y]);
+    EXPECT_FLOAT_EQ(0, gyro.gyroADCf[Z]);
+
+    gyroResetFifoConfig();
+}
+
+TEST(SensorGyro, FifoOverflow)
+{
+    gyroInitFifo(0);
+
+    // More samples than a single burst can take, the FIFO is flushed and
+    // only the current sample is used
+    for (int i = 0; i < GYRO_FIFO_SAMPLE_COUNT_MAX; i++) {
+        fakeGyroSet(1005, 6, 7);
+    }
+    fakeGyroSet(105, 206, 307);
+    gyroUpdate();
+    EXPECT_FLOAT_EQ(100 * gyroDev[0].scale, gyro.gyroADCf[X]);
+    EXPECT_FLOAT_EQ(200 * gyroDev[0].scale, gyro.gyroADCf[Y]);
+    EXPECT_FLOAT_EQ(300 * gyroDev[0].scale, gyro.gyroADCf[Z]);
+
+    // Back to normal operation
+    fakeGyroSet(15, 16, 17);
+    fakeGyroSet(25, 26, 27);
+    gyroUpdate();
+    EXPECT_FLOAT_EQ(15 * gyroDev[0].scale, gyro.gyroADCf[X]);
+    EXPECT_FLOAT_EQ(15 * gyroDev[0].scale, gyro.gyroADCf[Y]);
+    EXPECT_FLOAT_EQ(15 * gyroDev[0].scale, gyro.gyroADCf[Z]);
+
+    gyroResetFifoConfig();
+}
 
 // STUBS
 
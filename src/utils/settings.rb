@@ -184,6 +184,81 @@ class NameEncoder
     end
 end
 
+# Builds a perfect hash of the setting names (hash and displace), so
+# settingFind() only needs to decode the name of a single setting. A few
+# spare slots keep the displacements small enough to fit in a byte.
+# name_hash() and slot() must match settingNameHash() and
+# settingNameHashSlot() in fc/settings.c
+class NameHasher
+    attr_reader :bucket_count
+    attr_reader :slot_count
+    attr_reader :displacements
+    attr_reader :slots
+
+    MAX_DISPLACEMENT = 255
+
+    def initialize(names)
+        @count = names.length
+        @slot_count = @count + @count / 8 + 1
+        # Start with 4 names per bucket on average, use more buckets
+        # if some of them can't be placed with a byte sized displacement
+        @bucket_count = [(@count + 3) / 4, 1].max
+        while !build(names)
+            @bucket_count += @bucket_count / 8 + 1
+        end
+    end
+
+    def self.name_hash(name)
+        # FNV-1a
+        h = 2166136261
+        name.each_byte do |b|
+            h = ((h ^ b) * 16777619) & 0xffffffff
+        end
+        return h
+    end
+
+    private
+    def slot(h, displacement)
+        # murmur3 finalizer
+        h = (h ^ (displacement * 0x9e3779b9)) & 0xffffffff
+        h ^= h >> 16
+        h = (h * 0x85ebca6b) & 0xffffffff
+        h ^= h >> 13
+        h = (h * 0xc2b2ae35) & 0xffffffff
+        h ^= h >> 16
+        return h % @slot_count
+    end
+
+    def build(names)
+        buckets = Array.new(@bucket_count) { [] }
+        names.each_with_index do |name, ii|
+            h = NameHasher.name_hash(name)
+            buckets[h % @bucket_count] << [ii, h]
+        end
+        @displacements = Array.new(@bucket_count, 0)
+        @slots = Array.new(@slot_count)
+        # Place the biggest buckets first, while most slots are still free
+        order = (0...@bucket_count).sort_by { |b| [-buckets[b].length, b] }
+        order.each do |b|
+            entries = buckets[b]
+            next if entries.empty?
+            displacement = (0..MAX_DISPLACEMENT).find do |d|
+                s = entries.map { |_, h| slot(h, d) }
+                s.uniq.length == s.length && s.all? { |x| @slots[x].nil? }
+            end
+            if displacement == nil
+                dputs "Can't place bucket #{b} with #{@bucket_count} buckets"
+                return false
+            end
+            @displacements[b] = displacement
+            entries.each { |ii, h| @slots[slot(h, displacement)] = ii }
+        end
+        # Unused slots point to any setting, its name won't match
+        @slots.map! { |ii| ii || 0 }
+        return true
+    end
+end
+
 class ValueEncoder
     attr_reader :values
 
@@ -303,6 +378,7 @@ class Generator
         sanitize_fields
         resolv_min_max_and_default_values_if_possible
         initialize_name_encoder
+        initialize_name_hasher
         initialize_value_encoder
         validate_default_values
 
@@ -340,6 +416,8 @@ class Generator
         puts "name encoder uses #{word_idx} word indexing"
         puts "each setting name uses #{@name_encoder.max_length} bytes"
         puts "#{@name_encoder.estimated_size(@count)} bytes estimated for setting name storage"
+        hash_size = @name_hasher.bucket_count + @name_hasher.slot_count * (@count > 256 ? 2 : 1)
+        puts "name hash uses #{@name_hasher.bucket_count} buckets, #{hash_size} bytes"
         values_size = @value_encoder.values.length * 4
         puts "min/max value storage uses #{values_size} bytes"
         value_idx_size = @value_encoder.index_bytes * 2
@@ -390,6 +468,8 @@ class Generator
         end
         buf << "#define SETTINGS_WORDS_BITS_PER_CHAR #{SETTINGS_WORDS_BITS_PER_CHAR}\n"
         buf << "#define SETTINGS_TABLE_COUNT #{@count}\n"
+        buf << "#define SETTINGS_NAME_HASH_BUCKET_COUNT #{@name_hasher.bucket_count}\n"
+        buf << "#define SETTINGS_NAME_HASH_SLOT_COUNT #{@name_hasher.slot_count}\n"
         offset_type = "uint16_t"
         if can_use_byte_offsetof
             offset_type = "uint8_t"
@@ -631,6 +711,19 @@ class Generator
         end
         buf << "};\n"
 
+        # Write the name hash tables used by settingFind()
+        buf << "static const uint8_t settingNameHashDisplacements[] = {\n"
+        @name_hasher.displacements.each_slice(16) do |s|
+            buf << "\t#{s.join(", ")},\n"
+        end
+        buf << "};\n"
+        slot_type = @count > 256 ? "uint16_t" : "uint8_t"
+        buf << "static const #{slot_type} settingNameHashSlots[] = {\n"
+        @name_hasher.slots.each_slice(16) do |s|
+            buf << "\t#{s.join(", ")},\n"
+        end
+        buf << "};\n"
+
         File.open(file, 'w') {|file| file.write(buf.string)}
     end
 
@@ -1030,6 +1123,15 @@ class Generator
         @name_encoder = best
     end
 
+    def initialize_name_hasher
+        names = []
+        foreach_enabled_member do |group, member|
+            names << member["name"]
+        end
+        @name_hasher = NameHasher.new(names)
+        dputs "Using name hash with #{@name_hasher.bucket_count} buckets"
+    end
+
     def initialize_value_encoder
         values = []
         constants = []